@@ -21,10 +21,17 @@ void signalHandler(int signal) {
     exit(0);
 }
 
+void traceDumpHandler(int) {
+    if (g_server) {
+        g_server->requestTraceDump();
+    }
+}
+
 int main(int argc, char* argv[]) {
     // Set up signal handlers
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    signal(SIGUSR2, traceDumpHandler);  // Dump recent trace spans as a Chrome trace file
     
     // Parse command line arguments
     std::string host = "0.0.0.0";
@@ -0,0 +1,72 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "application/alert_rule_engine.hpp"
+
+using namespace trading::application;
+using namespace trading::domain;
+
+namespace {
+
+constexpr int kRules = 100'000;
+
+// The string-matching loop the engine replaced, kept as the baseline
+std::vector<AlertEvent> linearEvaluate(const std::unordered_map<std::string, AlertRule>& rules, const Metrics& metrics) {
+    std::vector<AlertEvent> events;
+    for (const auto& [ruleId, rule] : rules) {
+        if (!rule.enabled) continue;
+        double value = 0.0;
+        if (rule.metricKey == "latencyMs") value = metrics.latencyMs;
+        else if (rule.metricKey == "throughput") value = metrics.throughput;
+        else if (rule.metricKey == "errorRate") value = metrics.errorRate;
+        else if (rule.metricKey == "connCount") value = static_cast<double>(metrics.connCount);
+        else continue;
+
+        bool triggered = false;
+        if (rule.operator_ == ">") triggered = value > rule.threshold;
+        else if (rule.operator_ == ">=") triggered = value >= rule.threshold;
+        else if (rule.operator_ == "<") triggered = value < rule.threshold;
+        else if (rule.operator_ == "<=") triggered = value <= rule.threshold;
+        else if (rule.operator_ == "==") triggered = value == rule.threshold;
+
+        if (triggered) {
+            events.emplace_back(ruleId + "_" + std::to_string(metrics.ts), ruleId, metrics.ts, value,
+                                rule.metricKey + " " + rule.operator_ + " " + std::to_string(rule.threshold));
+        }
+    }
+    return events;
+}
+
+} // namespace
+
+TEST_CASE("AlertRuleEngine 100k rules vs linear scan", "[bench][alerts]") {
+    const std::vector<std::string> keys = {"latencyMs", "throughput", "errorRate", "connCount"};
+    const std::vector<std::string> ops = {">", ">=", "<", "<="};
+
+    // Thresholds well above typical values so only a handful of rules fire per sample
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> thresholdDist(1'000.0, 1'000'000.0);
+    AlertRuleEngine engine;
+    std::unordered_map<std::string, AlertRule> rules;
+    for (int i = 0; i < kRules; ++i) {
+        const auto& op = ops[i % 2];
+        AlertRule rule("rule-" + std::to_string(i), keys[i % keys.size()], op, thresholdDist(rng), true);
+        engine.registerRule(rule);
+        rules[rule.ruleId] = rule;
+    }
+
+    Metrics metrics(1, 1'500.0, 1'200.0, 0.01, 1'100);
+    auto indexed = engine.evaluate(metrics);  // Builds the index outside the timed loop
+    REQUIRE(indexed.size() == linearEvaluate(rules, metrics).size());
+
+    BENCHMARK("indexed evaluate") {
+        return engine.evaluate(metrics);
+    };
+
+    BENCHMARK("linear scan") {
+        return linearEvaluate(rules, metrics);
+    };
+}
@@ -0,0 +1,68 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <string>
+#include "infrastructure/database/clickhouse_repository.hpp"
+
+using trading::domain::Interval;
+using trading::infrastructure::database::ClickHouseHistoryRepository;
+
+namespace {
+
+// A FORMAT JSON response body; ClickHouse quotes 64-bit integers by default
+std::string candleResponse(size_t rows, bool quotePrices) {
+    nlohmann::json data = nlohmann::json::array();
+    int64_t openTime = 1718000000000;
+    double price = 3400.0;
+    for (size_t i = 0; i < rows; ++i) {
+        double open = price;
+        price += (i % 7 < 4 ? 1.25 : -1.0);
+        auto number = [quotePrices](double value) -> nlohmann::json {
+            return quotePrices ? nlohmann::json(std::to_string(value)) : nlohmann::json(value);
+        };
+        data.push_back({
+            {"open_time", std::to_string(openTime)},
+            {"open", number(open)},
+            {"high", number(std::max(open, price) + 0.5)},
+            {"low", number(std::min(open, price) - 0.5)},
+            {"close", number(price)},
+            {"volume", std::to_string(10000 + i % 500)}
+        });
+        openTime += 60000;
+    }
+
+    nlohmann::json response = {
+        {"meta", {
+            {{"name", "open_time"}, {"type", "Int64"}},
+            {{"name", "open"}, {"type", "Float64"}},
+            {{"name", "high"}, {"type", "Float64"}},
+            {{"name", "low"}, {"type", "Float64"}},
+            {{"name", "close"}, {"type", "Float64"}},
+            {{"name", "volume"}, {"type", "UInt64"}}
+        }},
+        {"data", data},
+        {"rows", rows},
+        {"statistics", {{"elapsed", 0.0021}, {"rows_read", rows}, {"bytes_read", rows * 48}}}
+    };
+    return response.dump();
+}
+
+} // namespace
+
+TEST_CASE("ClickHouse candle parsing", "[bench][clickhouse]") {
+    // history.query pages and the chart's initial load
+    for (size_t rows : {size_t{100}, size_t{1000}, size_t{10000}}) {
+        auto body = candleResponse(rows, false);
+        REQUIRE(ClickHouseHistoryRepository::parseCandlesJson(body, Interval::M1).size() == rows);
+
+        BENCHMARK(std::to_string(rows) + " rows") {
+            return ClickHouseHistoryRepository::parseCandlesJson(body, Interval::M1);
+        };
+    }
+
+    auto quoted = candleResponse(1000, true);
+    BENCHMARK("1000 rows, quoted prices") {
+        return ClickHouseHistoryRepository::parseCandlesJson(quoted, Interval::M1);
+    };
+}
@@ -0,0 +1,145 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef CLICKHOUSE_AVAILABLE
+
+#include <chrono>
+#include <cpr/cpr.h>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "infrastructure/database/clickhouse_native_repository.hpp"
+
+using trading::domain::HistoryQuery;
+using trading::domain::Interval;
+using trading::domain::Symbol;
+using trading::infrastructure::database::ClickHouseHistoryRepository;
+using trading::infrastructure::database::ClickHouseNativeRepository;
+using trading::infrastructure::database::OrderEvent;
+
+namespace {
+
+// Needs a real server, as the fake speaks HTTP only:
+//   CLICKHOUSE_HOST, CLICKHOUSE_HTTP_PORT (8123), CLICKHOUSE_PORT (9000)
+constexpr const char* kDatabase = "bench_native_db";
+constexpr int64_t kStart = 1718000000 / 86400 * 86400;
+constexpr int kCandles = 100'000;
+constexpr int kOrders = 10'000;
+
+std::string envOr(const char* name, const char* fallback) {
+    const char* value = std::getenv(name);
+    return value ? value : fallback;
+}
+
+// Runs `sql` over HTTP; false when the server is not there
+bool run(const std::string& endpoint, const std::string& sql) {
+    auto response = cpr::Post(cpr::Url{endpoint}, cpr::Body{sql});
+    if (response.status_code != 200) {
+        std::cerr << "[Bench] " << sql.substr(0, 60) << " failed (" << response.status_code << "): " << response.text << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Candles and orders generated on the server, so seeding costs no transfer
+bool seed(const std::string& endpoint) {
+    return run(endpoint, std::string("TRUNCATE TABLE ") + kDatabase + ".candles_1m") &&
+           run(endpoint, std::string("TRUNCATE TABLE ") + kDatabase + ".order_events") &&
+           run(endpoint, std::string("TRUNCATE TABLE ") + kDatabase + ".orders_latest") &&
+           run(endpoint, std::string("INSERT INTO ") + kDatabase + ".candles_1m SELECT 'ETH-USD', toDateTime(" +
+                             std::to_string(kStart) + " + number * 60), 3400 + number % 97, 3401 + number % 97, "
+                             "3399 + number % 97, 3400.5 + number % 97, 10000 + number % 500 FROM numbers(" +
+                             std::to_string(kCandles) + ")") &&
+           run(endpoint, std::string("INSERT INTO ") + kDatabase + ".order_events SELECT concat('ORD_', toString(number)), "
+                             "toDateTime64(" + std::to_string(kStart) + " + number, 3), toDateTime64(" + std::to_string(kStart) +
+                             " + number, 3), 'PLACE', 'ACK', concat('key-', toString(number)), 'ETH-USD', "
+                             "if(number % 2, 'SELL', 'BUY'), 'LIMIT', 1, 3400.5, 'ACC-1', 'session-1' FROM numbers(" +
+                             std::to_string(kOrders) + ")");
+}
+
+OrderEvent orderAt(int i) {
+    OrderEvent event;
+    event.orderId = "BENCH_" + std::to_string(i);
+    event.idempKey = "bench-" + std::to_string(i);
+    event.status = "ACK";
+    event.symbol = "ETH-USD";
+    event.side = i % 2 ? "SELL" : "BUY";
+    event.type = "LIMIT";
+    event.quantity = 1.0;
+    event.price = 3400.5;
+    event.tsMs = kStart * 1000 + i;
+    return event;
+}
+
+// Wall time for `orders` events through logOrder until the writer has sent them
+double logOrders(ClickHouseHistoryRepository& repository, int orders) {
+    uint64_t done = repository.writesOk() + repository.writesFailed() + repository.writesSkipped();
+    auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < orders; ++i) {
+        repository.logOrder(orderAt(i));
+    }
+    while (repository.writesOk() + repository.writesFailed() + repository.writesSkipped() < done + orders) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+}
+
+} // namespace
+
+TEST_CASE("ClickHouse HTTP versus native protocol", "[bench][clickhouse][native]") {
+    std::string host = envOr("CLICKHOUSE_HOST", "localhost");
+    int httpPort = std::stoi(envOr("CLICKHOUSE_HTTP_PORT", "8123"));
+    int nativePort = std::stoi(envOr("CLICKHOUSE_PORT", "9000"));
+    std::string endpoint = "http://" + host + ":" + std::to_string(httpPort);
+
+    ClickHouseHistoryRepository http(host, httpPort, kDatabase);
+    if (!http.isConnected()) {
+        WARN("No ClickHouse server at " << endpoint << ", skipping the native protocol comparison");
+        return;
+    }
+    ClickHouseNativeRepository native(host, httpPort, nativePort, kDatabase);
+    http.start();
+    native.start();
+    REQUIRE(native.isConnected());
+    REQUIRE(native.createTables());
+    // Applied already; lets the HTTP repository's writer start
+    REQUIRE(http.createTables());
+    REQUIRE(seed(endpoint));
+
+    Symbol symbol("ETH-USD");
+    HistoryQuery page(kStart, kStart + 86400, Interval::M1, 1000);
+    HistoryQuery all(kStart, kStart + kCandles * 60, Interval::M1, kCandles);
+    REQUIRE(http.fetch(symbol, all).size() == kCandles);
+    REQUIRE(native.fetch(symbol, all).size() == kCandles);
+    REQUIRE(http.getOrderHistory("", "", 100).size() == 100);
+    REQUIRE(native.getOrderHistory("", "", 100) == http.getOrderHistory("", "", 100));
+
+    BENCHMARK("fetch 1000 candles, HTTP") {
+        return http.fetch(symbol, page);
+    };
+    BENCHMARK("fetch 1000 candles, native") {
+        return native.fetch(symbol, page);
+    };
+    BENCHMARK("fetch 100k candles, HTTP") {
+        return http.fetch(symbol, all);
+    };
+    BENCHMARK("fetch 100k candles, native") {
+        return native.fetch(symbol, all);
+    };
+    BENCHMARK("order history, 100 of 10k orders, HTTP") {
+        return http.getOrderHistory("", "", 100);
+    };
+    BENCHMARK("order history, 100 of 10k orders, native") {
+        return native.getOrderHistory("", "", 100);
+    };
+
+    // The writer sends whatever queued during the previous insert as one batch
+    std::cout << "[Bench] log " << kOrders << " orders, HTTP JSONEachRow: " << logOrders(http, kOrders) << " ms" << std::endl;
+    std::cout << "[Bench] log " << kOrders << " orders, native blocks: " << logOrders(native, kOrders) << " ms" << std::endl;
+
+    run(endpoint, std::string("DROP DATABASE IF EXISTS ") + kDatabase);
+}
+
+#endif // CLICKHOUSE_AVAILABLE
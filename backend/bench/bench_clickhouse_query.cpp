@@ -0,0 +1,88 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "infrastructure/database/clickhouse_query.hpp"
+
+using trading::infrastructure::database::ClickHouseQuery;
+
+namespace {
+
+constexpr int64_t kFrom = 1718000000;
+constexpr int64_t kTo = kFrom + 86400;
+
+// The candle query as the repository used to build it on every call:
+// strftime for both bounds and the values spliced into the SQL text
+std::string formattedCandlesSql(const std::string& symbol, int64_t fromTs, int64_t toTs, int32_t limit) {
+    std::time_t fromTime = fromTs;
+    std::time_t toTime = toTs;
+    char fromBuffer[32], toBuffer[32];
+    struct tm fromTm = *std::gmtime(&fromTime);
+    struct tm toTm = *std::gmtime(&toTime);
+    std::strftime(fromBuffer, sizeof(fromBuffer), "%Y-%m-%d %H:%M:%S", &fromTm);
+    std::strftime(toBuffer, sizeof(toBuffer), "%Y-%m-%d %H:%M:%S", &toTm);
+
+    std::stringstream sql;
+    sql << "SELECT open_time, open, high, low, close, volume FROM trading_db.candles_1m "
+        << "WHERE symbol = '" << symbol << "' "
+        << "AND open_time >= '" << fromBuffer << "' "
+        << "AND open_time <= '" << toBuffer << "' "
+        << "ORDER BY open_time DESC "
+        << "LIMIT " << limit
+        << " FORMAT JSON";
+    return sql.str();
+}
+
+std::string formattedLatestSql(const std::vector<std::string>& symbols, int32_t limit) {
+    std::stringstream symbolList;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (i > 0) symbolList << ",";
+        symbolList << "'" << symbols[i] << "'";
+    }
+    std::stringstream sql;
+    sql << "SELECT symbol, open_time, open, high, low, close, volume FROM trading_db.candles_1m "
+        << "WHERE symbol IN (" << symbolList.str() << ") "
+        << "ORDER BY open_time DESC "
+        << "LIMIT " << limit
+        << " FORMAT JSON";
+    return sql.str();
+}
+
+} // namespace
+
+TEST_CASE("ClickHouse query construction, formatted SQL versus bound templates", "[bench][clickhouse]") {
+    ClickHouseQuery<std::string, std::chrono::sys_seconds, std::chrono::sys_seconds, uint32_t> candles(
+        "SELECT open_time, open, high, low, close, volume FROM trading_db.candles_1m "
+        "WHERE symbol = {symbol:String} AND open_time >= {from:DateTime} AND open_time <= {to:DateTime} "
+        "ORDER BY open_time DESC LIMIT {limit:UInt32} FORMAT JSON",
+        {"symbol", "from", "to", "limit"});
+    ClickHouseQuery<std::vector<std::string>, uint32_t> latest(
+        "SELECT symbol, open_time, open, high, low, close, volume FROM trading_db.candles_1m "
+        "WHERE symbol IN {symbols:Array(String)} ORDER BY open_time DESC LIMIT {limit:UInt32} FORMAT JSON",
+        {"symbols", "limit"});
+    std::vector<std::string> symbols{"BTC-USD", "ETH-USD", "SOL-USD", "ADA-USD", "DOT-USD"};
+    std::chrono::sys_seconds from{std::chrono::seconds(kFrom)};
+    std::chrono::sys_seconds to{std::chrono::seconds(kTo)};
+
+    REQUIRE(formattedCandlesSql("ETH-USD", kFrom, kTo, 500).find("'2024-06-10 06:13:20'") != std::string::npos);
+    REQUIRE_THROWS_AS((ClickHouseQuery<uint32_t>("SELECT 1 LIMIT {limit:Int64}", {"limit"})), std::invalid_argument);
+
+    BENCHMARK("candles, stringstream + strftime") {
+        return formattedCandlesSql("ETH-USD", kFrom, kTo, 500);
+    };
+
+    BENCHMARK("candles, template bind") {
+        return candles.bind("ETH-USD", from, to, 500);
+    };
+
+    BENCHMARK("latest 5 symbols, stringstream") {
+        return formattedLatestSql(symbols, 50);
+    };
+
+    BENCHMARK("latest 5 symbols, template bind") {
+        return latest.bind(symbols, 50);
+    };
+}
@@ -0,0 +1,423 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "application/candle_downsampler.hpp"
+#include "application/history_warmup.hpp"
+#include "fake_clickhouse/fake_clickhouse_server.hpp"
+#include "infrastructure/database/clickhouse_repository.hpp"
+
+using trading::domain::HistoryQuery;
+using trading::domain::Interval;
+using trading::domain::Symbol;
+using trading::fake_clickhouse::FakeClickHouseServer;
+using trading::infrastructure::database::circuitStateName;
+using trading::infrastructure::database::CircuitBreaker;
+using trading::infrastructure::database::ClickHouseHealthConfig;
+using trading::infrastructure::database::ClickHouseHistoryRepository;
+using trading::infrastructure::database::HttpCompression;
+using trading::infrastructure::database::kDefaultMaxReaders;
+
+namespace {
+
+constexpr int64_t kDayStart = 1718000000 / 86400 * 86400;
+
+// One day of 1m candles per symbol, loaded straight into the fake's store
+void seedCandles(FakeClickHouseServer& server, const std::string& symbol) {
+    std::string rows;
+    double price = 3400.0;
+    for (int minute = 0; minute < 1440; ++minute) {
+        double open = price;
+        price += minute % 7 < 4 ? 1.25 : -1.0;
+        rows += symbol + "\t" + std::to_string(kDayStart + minute * 60) + "\t" + std::to_string(open) + "\t" +
+                std::to_string(std::max(open, price) + 0.5) + "\t" + std::to_string(std::min(open, price) - 0.5) + "\t" +
+                std::to_string(price) + "\t" + std::to_string(10000 + minute % 500) + "\n";
+    }
+    server.store().execute("INSERT INTO trading_db.candles_1m FORMAT TabSeparated", rows);
+}
+
+// DateTime64(3) text for a second offset from kDayStart
+std::string timeAt(int64_t seconds) {
+    std::time_t t = static_cast<std::time_t>(kDayStart + seconds);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S.000", std::gmtime(&t));
+    return buffer;
+}
+
+// A placement per order, a second ago each, and a cancellation 30 s later for
+// every third order; the view keeps orders_latest in step
+void seedOrders(FakeClickHouseServer& server, int orders) {
+    std::string rows;
+    for (int i = 0; i < orders; ++i) {
+        std::string orderId = "ORD_" + std::to_string(i);
+        std::string tail = "\tkey-" + std::to_string(i) + "\tETH-USD\t" + (i % 2 ? "SELL" : "BUY") + "\tLIMIT\t1\t3400.5\tACC-1\tsession-1\n";
+        rows += orderId + "\t" + timeAt(i) + "\t" + timeAt(i) + "\tPLACE\tACK" + tail;
+        if (i % 3 == 0) {
+            rows += orderId + "\t" + timeAt(i + 30) + "\t" + timeAt(i) + "\tCANCEL\tCANCELLED" + tail;
+        }
+    }
+    server.store().execute("INSERT INTO trading_db.order_events FORMAT TabSeparated", rows);
+}
+
+// The same orders in the JSON-per-row orders_log the typed tables replaced
+void seedLegacyOrders(FakeClickHouseServer& server, int orders) {
+    std::string rows;
+    for (int i = 0; i < orders; ++i) {
+        std::string orderId = "ORD_" + std::to_string(i);
+        std::string result = std::string("{\"symbol\":\"ETH-USD\",\"side\":\"") + (i % 2 ? "SELL" : "BUY") +
+                             "\",\"type\":\"LIMIT\",\"quantity\":1,\"price\":3400.5,\"sessionId\":\"session-1\"}";
+        rows += "key-" + std::to_string(i) + "\t" + std::to_string(kDayStart + i) + "\tACK\t" + orderId + "\t" + result + "\n";
+        if (i % 3 == 0) {
+            rows += "key-" + std::to_string(i) + "\t" + std::to_string(kDayStart + i + 30) + "\tCANCELLED\t" + orderId + "\t" + result + "\n";
+        }
+    }
+    server.store().execute("INSERT INTO trading_db.orders_log FORMAT TabSeparated", rows);
+}
+
+// Days of 1m candles ending at kDayStart, inserted a day per block as a loader would
+void seedHistory(FakeClickHouseServer& server, const std::string& symbol, int days) {
+    double price = 3400.0;
+    for (int day = days; day > 0; --day) {
+        std::string rows;
+        int64_t dayStart = kDayStart - static_cast<int64_t>(day) * 86400;
+        for (int minute = 0; minute < 1440; ++minute) {
+            double open = price;
+            price += minute % 7 < 4 ? 0.25 : -0.2;
+            rows += symbol + "\t" + std::to_string(dayStart + minute * 60) + "\t" + std::to_string(open) + "\t" +
+                    std::to_string(std::max(open, price) + 0.5) + "\t" + std::to_string(std::min(open, price) - 0.5) + "\t" +
+                    std::to_string(price) + "\t" + std::to_string(10000 + minute % 500) + "\n";
+        }
+        server.store().execute("INSERT INTO trading_db.candles_1m FORMAT TabSeparated", rows);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Candle rollups versus aggregating 1m candles", "[bench][clickhouse]") {
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db");
+    REQUIRE(repository.createTables());
+    seedHistory(server, "ETH-USD", 180);  // The candles_1m TTL
+    REQUIRE(server.store().rowCount("trading_db.candles_1h") == 180 * 24);
+
+    // 30 days of hourly candles, from each table
+    std::string range = "open_time >= '" + std::to_string(kDayStart - 30 * 86400) + "' AND open_time < '" + std::to_string(kDayStart) + "'";
+    std::string fromMinutes =
+        "SELECT toStartOfHour(open_time) AS bucket, argMin(open, open_time) AS o, max(high) AS h, min(low) AS l, "
+        "argMax(close, open_time) AS c, sum(volume) AS v FROM trading_db.candles_1m "
+        "WHERE symbol = 'ETH-USD' AND " + range + " GROUP BY bucket ORDER BY bucket DESC LIMIT 720 FORMAT JSON";
+    std::string fromRollup =
+        "SELECT r.open_time AS open_time, argMinMerge(r.open) AS open, max(r.high) AS high, min(r.low) AS low, "
+        "argMaxMerge(r.close) AS close, sum(r.volume) AS volume FROM trading_db.candles_1h AS r "
+        "WHERE r.symbol = 'ETH-USD' AND r." + range + " GROUP BY r.open_time ORDER BY open_time DESC LIMIT 720 FORMAT JSON";
+    auto minutes = server.store().execute(fromMinutes);
+    auto rollup = server.store().execute(fromRollup);
+    REQUIRE(minutes.resultRows == 720);
+    REQUIRE(rollup.resultRows == 720);
+    auto newestMinutes = nlohmann::json::parse(minutes.body)["data"][0];
+    auto newestRollup = nlohmann::json::parse(rollup.body)["data"][0];
+    REQUIRE(newestRollup["open"] == newestMinutes["o"]);
+    REQUIRE(newestRollup["close"] == newestMinutes["c"]);
+    REQUIRE(newestRollup["volume"] == newestMinutes["v"]);
+    std::cout << "[Rollup] 30 days of H1 candles: candles_1m read " << minutes.readRows << " rows / " << minutes.readBytes
+              << " bytes, candles_1h read " << rollup.readRows << " rows / " << rollup.readBytes << " bytes" << std::endl;
+
+    Symbol symbol("ETH-USD");
+    HistoryQuery hourly(kDayStart - 30 * 86400, kDayStart - 1, Interval::H1, 720);
+    auto candles = repository.fetch(symbol, hourly);
+    REQUIRE(candles.size() == 720);
+    REQUIRE(candles.front().openTime == kDayStart - 3600);
+
+    // Six months at M1 within a 1000 point budget: 6h buckets merged from candles_1h
+    HistoryQuery wide(kDayStart - 180 * 86400, kDayStart - 1, Interval::M1, 1000);
+    wide.bucketSeconds = trading::application::downsampleBucketSeconds(wide.fromTs, wide.toTs, wide.interval, 1000);
+    REQUIRE(wide.bucketSeconds == 6 * 3600);
+    auto downsampled = repository.fetch(symbol, wide);
+    REQUIRE(downsampled.size() == 180 * 4);
+    REQUIRE(downsampled.back().openTime == wide.fromTs);
+
+    BENCHMARK("30 days of H1 candles, aggregated from candles_1m") {
+        return server.store().execute(fromMinutes).resultRows;
+    };
+
+    BENCHMARK("30 days of H1 candles, merged from candles_1h") {
+        return server.store().execute(fromRollup).resultRows;
+    };
+
+    BENCHMARK("fetch 720 H1 candles through the repository") {
+        return repository.fetch(symbol, hourly);
+    };
+
+    BENCHMARK("fetch 6 months of M1 downsampled to 720 candles") {
+        return repository.fetch(symbol, wide);
+    };
+
+    BENCHMARK("fetch 180 D1 candles through the repository") {
+        return repository.fetch(symbol, HistoryQuery(kDayStart - 180 * 86400, kDayStart - 1, Interval::D1, 180));
+    };
+
+    server.stop();
+}
+
+TEST_CASE("Order history from typed order tables versus the JSON log", "[bench][clickhouse]") {
+    // 150k events over 100k orders; the fake holds every row in memory, so the
+    // production scale (100M events) is out of reach here, but the read shapes are the same
+    constexpr int kOrders = 100000;
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db");
+    REQUIRE(repository.createTables());
+    REQUIRE(repository.schemaVersion() == 3);
+    seedOrders(server, kOrders);
+    seedLegacyOrders(server, kOrders);
+    REQUIRE(server.store().rowCount("trading_db.orders_latest") == server.store().rowCount("trading_db.order_events"));
+
+    std::string legacy =
+        "SELECT ol1.order_id, ol1.idemp_key, ol1.ts, ol1.status, ol1.result FROM trading_db.orders_log ol1 "
+        "INNER JOIN ( SELECT order_id, MAX(ts) as max_ts FROM trading_db.orders_log GROUP BY order_id ) ol2 "
+        "ON ol1.order_id = ol2.order_id AND ol1.ts = ol2.max_ts ORDER BY ol1.ts DESC LIMIT 100 FORMAT JSON";
+    std::string typed =
+        "SELECT order_id, idemp_key, placed_at, updated_at, status, symbol, side, type, quantity, price, account_id, session_id "
+        "FROM trading_db.orders_latest FINAL ORDER BY placed_at DESC, order_id DESC LIMIT 100 FORMAT JSON";
+    auto legacyResult = server.store().execute(legacy);
+    auto typedResult = server.store().execute(typed);
+    REQUIRE(legacyResult.resultRows == 100);
+    REQUIRE(typedResult.resultRows == 100);
+    std::cout << "[Orders] 100 latest orders: orders_log join read " << legacyResult.readRows << " rows / " << legacyResult.readBytes
+              << " bytes, orders_latest FINAL read " << typedResult.readRows << " rows / " << typedResult.readBytes << " bytes" << std::endl;
+
+    auto history = repository.getOrderHistory(timeAt(kOrders - 1000), timeAt(kOrders), 100);
+    REQUIRE(history.size() == 100);
+    REQUIRE(history.front()["side"] == "SELL");
+    REQUIRE(history.front()["price"] == 3400.5);
+
+    BENCHMARK("100 latest orders, JSON log with a self-join") {
+        return server.store().execute(legacy).resultRows;
+    };
+
+    BENCHMARK("100 latest orders, orders_latest FINAL") {
+        return server.store().execute(typed).resultRows;
+    };
+
+    BENCHMARK("order history through the repository") {
+        return repository.getOrderHistory("", "", 100);
+    };
+
+    BENCHMARK("order details point read") {
+        return repository.getOrderDetails("ORD_51234");
+    };
+
+    server.stop();
+}
+
+TEST_CASE("ClickHouse repository round trips", "[bench][clickhouse]") {
+    // The whole I/O path (SQL building, HTTP, JSON parsing) against an in-process server
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db");
+    repository.start();
+    REQUIRE(repository.isConnected());
+    REQUIRE(repository.createTables());
+    seedCandles(server, "ETH-USD");
+    seedCandles(server, "BTC-USD");
+    seedOrders(server, 1000);
+
+    Symbol symbol("ETH-USD");
+    HistoryQuery page(kDayStart, kDayStart + 86400, Interval::M1, 500);
+    auto candles = repository.fetch(symbol, page);
+    REQUIRE(candles.size() == 500);
+    REQUIRE(candles.front().openTime == kDayStart + 1439 * 60);
+    auto history = repository.getOrderHistory("", "", 100);
+    REQUIRE(history.size() == 100);
+    REQUIRE(history.front()["order_id"] == "ORD_999");
+    REQUIRE(history.front()["status"] == "CANCELLED");  // Replaced by its cancellation
+    REQUIRE(history[1]["status"] == "ACK");
+
+    BENCHMARK("fetch 500 candles") {
+        return repository.fetch(symbol, page);
+    };
+
+    BENCHMARK("latest 100 candles, 2 symbols") {
+        return repository.latest({Symbol("ETH-USD"), Symbol("BTC-USD")}, 100);
+    };
+
+    BENCHMARK("order history, 100 of 1000 orders") {
+        return repository.getOrderHistory("", "", 100);
+    };
+
+    // A nearby server: per-request cost is dominated by the round trip
+    server.setLatency(std::chrono::microseconds(500));
+    BENCHMARK("fetch 500 candles, 0.5 ms server latency") {
+        return repository.fetch(symbol, page);
+    };
+
+    server.stop();
+}
+
+TEST_CASE("Concurrent history reads", "[bench][clickhouse]") {
+    // 64 history.query callers at once against a server 2 ms away. One read
+    // slot is the old single client lock; more slots overlap the round trips.
+    constexpr int kCallers = 64;
+    constexpr int kReadsPerCaller = 10;
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    REQUIRE(ClickHouseHistoryRepository("127.0.0.1", server.port(), "trading_db").createTables());
+    seedCandles(server, "ETH-USD");
+    server.setLatency(std::chrono::milliseconds(2));
+
+    Symbol symbol("ETH-USD");
+    HistoryQuery page(kDayStart, kDayStart + 86400, Interval::M1, 100);
+    auto readAll = [&](ClickHouseHistoryRepository& repository) {
+        std::vector<std::thread> callers;
+        std::atomic<size_t> candles{0};
+        for (int caller = 0; caller < kCallers; ++caller) {
+            callers.emplace_back([&] {
+                for (int i = 0; i < kReadsPerCaller; ++i) {
+                    candles.fetch_add(repository.fetch(symbol, page).size(), std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& caller : callers) {
+            caller.join();
+        }
+        return candles.load();
+    };
+
+    for (size_t maxReaders : {1, 8, 64}) {
+        ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db", HttpCompression::NONE, maxReaders);
+        REQUIRE(repository.isConnected());
+
+        auto started = std::chrono::steady_clock::now();
+        REQUIRE(readAll(repository) == size_t{kCallers} * kReadsPerCaller * 100);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        REQUIRE(repository.readsInFlight() == 0);
+        std::cout << "[Concurrency] " << kCallers << " callers, " << maxReaders << " read slots: "
+                  << static_cast<int>(kCallers * kReadsPerCaller / seconds) << " reads/s, "
+                  << repository.readWaits() << " waits for a slot" << std::endl;
+
+        BENCHMARK("64 callers x 10 fetches, " + std::to_string(maxReaders) + " read slots") {
+            return readAll(repository);
+        };
+    }
+
+    server.stop();
+}
+
+TEST_CASE("History reads during a ClickHouse stall", "[bench][clickhouse]") {
+    // ClickHouse stops answering for longer than any caller will wait: each
+    // request takes 1.5 s. 400 ms into the stall, 8 callers start asking for
+    // a page they read before it.
+    constexpr int kCallers = 8;
+    constexpr int kReadsPerCaller = 10;
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    REQUIRE(ClickHouseHistoryRepository("127.0.0.1", server.port(), "trading_db").createTables());
+    seedCandles(server, "ETH-USD");
+
+    Symbol symbol("ETH-USD");
+    HistoryQuery page(kDayStart, kDayStart + 86400, Interval::M1, 100);
+    auto readAll = [&](ClickHouseHistoryRepository& repository) {
+        std::vector<std::thread> callers;
+        std::mutex mutex;
+        std::vector<double> millis;
+        std::atomic<size_t> candles{0};
+        for (int caller = 0; caller < kCallers; ++caller) {
+            callers.emplace_back([&] {
+                for (int i = 0; i < kReadsPerCaller; ++i) {
+                    auto started = std::chrono::steady_clock::now();
+                    candles.fetch_add(repository.fetch(symbol, page).size(), std::memory_order_relaxed);
+                    std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - started;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    millis.push_back(took.count());
+                }
+            });
+        }
+        for (auto& caller : callers) {
+            caller.join();
+        }
+        std::sort(millis.begin(), millis.end());
+        return std::tuple{candles.load(), millis[millis.size() / 2], millis[millis.size() * 99 / 100], millis.back()};
+    };
+
+    // No deadline, a deadline alone, and a deadline with the breaker and prober
+    ClickHouseHealthConfig unbounded{std::chrono::milliseconds(0), std::chrono::milliseconds(0), std::chrono::milliseconds(500),
+                                     std::chrono::milliseconds(0), {1000000, std::chrono::milliseconds(5000)}};
+    ClickHouseHealthConfig deadline = unbounded;
+    deadline.queryTimeout = std::chrono::milliseconds(250);
+    ClickHouseHealthConfig breaker{std::chrono::milliseconds(250), std::chrono::milliseconds(0), std::chrono::milliseconds(100),
+                                   std::chrono::milliseconds(200), {3, std::chrono::milliseconds(5000)}};
+
+    for (auto [name, health] : {std::pair{"no deadline", unbounded}, std::pair{"250 ms deadline", deadline},
+                                std::pair{"deadline + breaker", breaker}}) {
+        server.setLatency(std::chrono::microseconds(0));
+        ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db", HttpCompression::NONE, kDefaultMaxReaders,
+                                               health);
+        repository.start();
+        REQUIRE(repository.fetch(symbol, page).size() == 100);
+
+        server.setLatency(std::chrono::milliseconds(1500));
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        auto [candles, p50, p99, slowest] = readAll(repository);
+        // Every read answers with the page, fresh or from before the stall
+        REQUIRE(candles == size_t{kCallers} * kReadsPerCaller * 100);
+        std::cout << "[Stall] " << name << ": p50 " << p50 << " ms, p99 " << p99 << " ms, max " << slowest << " ms, "
+                  << repository.readsFailed() << " timed out, " << repository.readsRejected() << " failed fast, circuit "
+                  << circuitStateName(repository.circuitState()) << std::endl;
+
+        if (health.breaker.failureThreshold < 10) {
+            REQUIRE(repository.circuitState() == CircuitBreaker::State::OPEN);
+            BENCHMARK("fetch during a stall, deadline + breaker") {
+                return repository.fetch(symbol, page);
+            };
+        }
+    }
+
+    server.stop();
+}
+
+TEST_CASE("Startup against a cold ClickHouse", "[bench][clickhouse]") {
+    // What the listener used to wait for, and the warm-up that now runs
+    // behind it, against a server 2 ms away
+    const std::vector<std::string> symbols = {"ETH-USD", "BTC-USD", "ADA-USD", "SOL-USD", "DOGE-USD", "AVAX-USD", "MATIC-USD", "LINK-USD"};
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    server.setLatency(std::chrono::milliseconds(2));
+    ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db");
+    repository.start();
+    REQUIRE(repository.isConnected());
+
+    auto started = std::chrono::steady_clock::now();
+    REQUIRE(repository.createTables());
+    auto schemaReady = std::chrono::steady_clock::now();
+    REQUIRE(repository.generateMockData());
+    auto backfilled = std::chrono::steady_clock::now();
+    auto millis = [](auto duration) { return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+    std::cout << "[Startup] Schema " << millis(schemaReady - started) << " ms, mock data " << millis(backfilled - schemaReady)
+              << " ms: the listener no longer waits for either" << std::endl;
+
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    for (size_t parallelism : {1, 8}) {
+        auto warmup = trading::application::warmHistory(repository, symbols, now, parallelism);
+        REQUIRE(warmup.symbolsWarmed == symbols.size());
+        REQUIRE(warmup.candles > 0);
+        std::cout << "[Startup] Warm-up of " << symbols.size() << " symbols, " << parallelism << " at a time: " << warmup.took.count()
+                  << " ms, " << warmup.candles << " candles" << std::endl;
+
+        BENCHMARK("warm 8 symbols, " + std::to_string(parallelism) + " at a time") {
+            return trading::application::warmHistory(repository, symbols, now, parallelism).candles;
+        };
+    }
+
+    server.stop();
+}
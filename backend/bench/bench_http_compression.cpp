@@ -0,0 +1,130 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "fake_clickhouse/fake_clickhouse_server.hpp"
+#include "infrastructure/database/clickhouse_repository.hpp"
+
+using trading::domain::HistoryQuery;
+using trading::domain::Interval;
+using trading::domain::Symbol;
+using trading::fake_clickhouse::FakeClickHouseServer;
+using trading::infrastructure::database::ClickHouseHistoryRepository;
+using trading::infrastructure::database::HttpCompression;
+using trading::infrastructure::database::httpCompressionName;
+using trading::infrastructure::database::OrderEvent;
+
+namespace {
+
+constexpr int64_t kStart = 1600000000 / 86400 * 86400;
+constexpr int kReadRows = 1'000'000;
+constexpr int kInsertRows = 100'000;
+constexpr HttpCompression kCodecs[] = {HttpCompression::NONE, HttpCompression::LZ4, HttpCompression::ZSTD};
+
+// candles_1m alone, without the rollup views, so a million rows fit in the fake
+void seedMinutes(FakeClickHouseServer& server, int rows) {
+    server.store().execute("CREATE DATABASE IF NOT EXISTS trading_db");
+    server.store().execute(
+        "CREATE TABLE trading_db.candles_1m (symbol String, open_time DateTime, open Float64, high Float64, "
+        "low Float64, close Float64, volume UInt64) ENGINE = MergeTree() ORDER BY (symbol, open_time)");
+    double price = 3400.0;
+    for (int start = 0; start < rows; start += 10000) {
+        std::string block;
+        for (int i = start; i < std::min(rows, start + 10000); ++i) {
+            double open = price;
+            price += i % 7 < 4 ? 0.25 : -0.2;
+            block += "ETH-USD\t" + std::to_string(kStart + static_cast<int64_t>(i) * 60) + "\t" + std::to_string(open) + "\t" +
+                     std::to_string(std::max(open, price) + 0.5) + "\t" + std::to_string(std::min(open, price) - 0.5) + "\t" +
+                     std::to_string(price) + "\t" + std::to_string(10000 + i % 500) + "\n";
+        }
+        server.store().execute("INSERT INTO trading_db.candles_1m FORMAT TabSeparated", block);
+    }
+}
+
+OrderEvent orderAt(int i) {
+    OrderEvent event;
+    event.orderId = "ORD_" + std::to_string(i);
+    event.idempKey = "key-" + std::to_string(i);
+    event.status = "ACK";
+    event.symbol = i % 2 ? "ETH-USD" : "BTC-USD";
+    event.side = i % 2 ? "SELL" : "BUY";
+    event.type = "LIMIT";
+    event.quantity = 1.0 + i % 10;
+    event.price = 3400.5 + i % 100;
+    event.accountId = "ACC-" + std::to_string(i % 50);
+    event.sessionId = "session-" + std::to_string(i % 500);
+    event.tsMs = kStart * 1000 + i;
+    return event;
+}
+
+void report(const char* operation, HttpCompression codec, double seconds, uint64_t sent, uint64_t received) {
+    char line[200];
+    std::snprintf(line, sizeof(line), "[Compression] %-22s %-5s %8.0f ms  sent %11llu B  received %11llu B", operation,
+                  std::string(httpCompressionName(codec)).c_str(), seconds * 1000.0,
+                  static_cast<unsigned long long>(sent), static_cast<unsigned long long>(received));
+    std::cout << line << std::endl;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+} // namespace
+
+TEST_CASE("ClickHouse HTTP transport by compression codec", "[bench][clickhouse][compression]") {
+    // Loopback has no bandwidth limit, so times here show the CPU cost of each
+    // codec; the byte counts are what a real link would carry
+    SECTION("1M-row history read") {
+        FakeClickHouseServer server;
+        REQUIRE(server.start());
+        seedMinutes(server, kReadRows);
+        HistoryQuery all(kStart, kStart + static_cast<int64_t>(kReadRows) * 60, Interval::M1, kReadRows);
+
+        for (HttpCompression codec : kCodecs) {
+            ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db", codec);
+            auto started = std::chrono::steady_clock::now();
+            size_t rows = repository.fetch(Symbol("ETH-USD"), all).size();
+            double seconds = secondsSince(started);
+            REQUIRE(rows == kReadRows);
+            report("1M-row read", codec, seconds, repository.bytesSent(), repository.bytesReceived());
+        }
+
+        HistoryQuery day(kStart, kStart + 86400 - 1, Interval::M1, 1440);
+        for (HttpCompression codec : kCodecs) {
+            ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db", codec);
+            BENCHMARK("fetch 1440 M1 candles, " + std::string(httpCompressionName(codec))) {
+                return repository.fetch(Symbol("ETH-USD"), day);
+            };
+        }
+        server.stop();
+    }
+
+    SECTION("100k-row order insert") {
+        for (HttpCompression codec : kCodecs) {
+            FakeClickHouseServer server;
+            REQUIRE(server.start());
+            ClickHouseHistoryRepository repository("127.0.0.1", server.port(), "trading_db", codec);
+            repository.start();
+            REQUIRE(repository.createTables());
+            uint64_t sentBefore = repository.bytesSent();
+            uint64_t receivedBefore = repository.bytesReceived();
+
+            auto started = std::chrono::steady_clock::now();
+            for (int i = 0; i < kInsertRows; ++i) {
+                repository.logOrder(orderAt(i));
+            }
+            while (repository.writesOk() + repository.writesFailed() + repository.writesSkipped() < kInsertRows) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            double seconds = secondsSince(started);
+            REQUIRE(repository.writesOk() == kInsertRows);
+            REQUIRE(server.store().rowCount("order_events", "trading_db") == kInsertRows);
+            report("100k-row insert", codec, seconds, repository.bytesSent() - sentBefore,
+                   repository.bytesReceived() - receivedBefore);
+            server.stop();
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "infrastructure/cache/idempotency_cache.hpp"
+
+using namespace trading::domain;
+using trading::infrastructure::cache::IdempotencyCache;
+
+namespace {
+
+constexpr size_t kKeys = 10000;
+
+std::vector<std::string> makeKeys() {
+    std::vector<std::string> keys;
+    keys.reserve(kKeys);
+    for (size_t i = 0; i < kKeys; ++i) {
+        keys.push_back("idem-" + std::to_string(i) + "-0123456789abcdef");
+    }
+    return keys;
+}
+
+// One contending thread per remaining core
+unsigned contendingThreads() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+// Keeps other threads hitting the cache mutex for as long as it is alive
+class Contention {
+public:
+    Contention(IdempotencyCache& cache, const std::vector<std::string>& keys) {
+        for (unsigned t = 0; t < contendingThreads(); ++t) {
+            threads_.emplace_back([this, &cache, &keys, t] {
+                OrderResult result(OrderStatus::ACK, "order", "");
+                size_t i = static_cast<size_t>(t);
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    const auto& key = keys[i++ % keys.size()];
+                    if (i % 4 == 0) {
+                        cache.put(key, result);
+                    } else {
+                        cache.get(key);
+                    }
+                }
+            });
+        }
+    }
+
+    ~Contention() {
+        stop_ = true;
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+} // namespace
+
+TEST_CASE("IdempotencyCache get/put", "[bench][cache]") {
+    auto keys = makeKeys();
+    IdempotencyCache cache;
+    OrderResult result(OrderStatus::ACK, "order-1", "idem-1");
+    for (const auto& key : keys) {
+        cache.put(key, result);
+    }
+    size_t next = 0;
+
+    BENCHMARK("get hit") {
+        return cache.get(keys[next++ % kKeys]);
+    };
+
+    BENCHMARK("get miss") {
+        return cache.get("missing-key");
+    };
+
+    BENCHMARK("put existing key") {
+        cache.put(keys[next++ % kKeys], result);
+    };
+
+    BENCHMARK_ADVANCED("get hit, contended")(Catch::Benchmark::Chronometer meter) {
+        Contention contention(cache, keys);
+        meter.measure([&](int i) { return cache.get(keys[static_cast<size_t>(i) % kKeys]); });
+    };
+
+    BENCHMARK_ADVANCED("put, contended")(Catch::Benchmark::Chronometer meter) {
+        Contention contention(cache, keys);
+        meter.measure([&](int i) { cache.put(keys[static_cast<size_t>(i) % kKeys], result); });
+    };
+
+    REQUIRE(cache.size() == kKeys);
+}
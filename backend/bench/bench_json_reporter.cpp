@@ -0,0 +1,88 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_case_info.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <ctime>
+#include <string>
+
+#ifndef BULL_BENCH_VERSION
+#define BULL_BENCH_VERSION "dev"
+#endif
+
+namespace {
+
+std::string utcTimestamp() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+std::string compilerId() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+} // namespace
+
+// Writes every benchmark's statistics as one JSON document at the end of the run,
+// so results can be stored per release and diffed. Catch2's own JSON reporter
+// leaves benchmark statistics out. Combine with the console reporter:
+//   bull-trading-bench --reporter console --reporter benchjson::out=bench-results.json
+class BenchJsonReporter final : public Catch::StreamingReporterBase {
+public:
+    explicit BenchJsonReporter(Catch::ReporterConfig&& config) : StreamingReporterBase(std::move(config)) {
+        m_preferences.shouldReportAllAssertions = false;
+    }
+
+    static std::string getDescription() {
+        return "Benchmark statistics as JSON for tracking regressions between releases";
+    }
+
+    void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override {
+        results_.push_back({
+            {"testCase", currentTestCaseInfo ? currentTestCaseInfo->name : ""},
+            {"name", stats.info.name},
+            {"meanNs", stats.mean.point.count()},
+            {"meanLowerNs", stats.mean.lower_bound.count()},
+            {"meanUpperNs", stats.mean.upper_bound.count()},
+            {"stdDevNs", stats.standardDeviation.point.count()},
+            {"samples", stats.info.samples},
+            {"iterations", stats.info.iterations},
+            {"outlierVariance", stats.outlierVariance}
+        });
+    }
+
+    void testRunEnded(Catch::TestRunStats const& stats) override {
+        nlohmann::json document = {
+            {"suite", "bull-trading-bench"},
+            {"version", BULL_BENCH_VERSION},
+            {"timestamp", utcTimestamp()},
+            {"compiler", compilerId()},
+#ifdef NDEBUG
+            {"optimized", true},
+#else
+            {"optimized", false},
+#endif
+            {"results", results_}
+        };
+        m_stream << document.dump(2) << '\n';
+        StreamingReporterBase::testRunEnded(stats);
+    }
+
+private:
+    nlohmann::json results_ = nlohmann::json::array();
+};
+
+CATCH_REGISTER_REPORTER("benchjson", BenchJsonReporter)
@@ -0,0 +1,53 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "infrastructure/metrics/metrics_registry.hpp"
+
+using namespace trading::infrastructure::metrics;
+
+namespace {
+
+constexpr int kContentionThreads = 16;
+constexpr int64_t kIterationsPerThread = 100'000;
+
+// Releases all threads at once and returns when every increment has landed
+template <typename Increment>
+int64_t runContended(Increment increment) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kContentionThreads; ++t) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {
+            }
+            for (int64_t i = 0; i < kIterationsPerThread; ++i) {
+                increment();
+            }
+        });
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return kIterationsPerThread * kContentionThreads;
+}
+
+} // namespace
+
+TEST_CASE("ShardedCounter 16 thread contention vs std::atomic", "[bench][metrics]") {
+    std::atomic<int64_t> atomicCounter{0};
+    ShardedCounter shardedCounter;
+
+    BENCHMARK("std::atomic fetch_add, 16 threads x 100k") {
+        return runContended([&atomicCounter] { atomicCounter.fetch_add(1, std::memory_order_relaxed); });
+    };
+
+    BENCHMARK("ShardedCounter increment, 16 threads x 100k") {
+        return runContended([&shardedCounter] { shardedCounter.increment(); });
+    };
+
+    REQUIRE(atomicCounter.load() % (kIterationsPerThread * kContentionThreads) == 0);
+    REQUIRE(shardedCounter.value() % (kIterationsPerThread * kContentionThreads) == 0);
+}
@@ -0,0 +1,39 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+#include "infrastructure/metrics/openmetrics_writer.hpp"
+
+using namespace trading::infrastructure::metrics;
+
+TEST_CASE("OpenMetricsWriter scrape", "[bench][metrics]") {
+    // 40 labeled counters and three histogram families of 20 series each
+    MetricsRegistry registry;
+    std::vector<LatencyHistogram> histograms(20);
+    for (int i = 0; i < 40; ++i) {
+        registry.counter("orders_placed_total", {{"symbol", "S" + std::to_string(i)}}).add(i);
+    }
+    for (auto& histogram : histograms) {
+        for (uint64_t ns = 1000; ns < 100'000'000; ns *= 3) {
+            histogram.record(ns);
+        }
+    }
+
+    OpenMetricsWriter out("bull_");
+    BENCHMARK("full scrape") {
+        out.clear();
+        out.family("orders_placed", "counter", "");
+        registry.visit([&](const std::string& name, const Labels& labels, int64_t value) {
+            out.sample(name, labels, value);
+        });
+        for (int h = 0; h < 3; ++h) {
+            out.family("rpc_service_seconds", "histogram", "");
+            for (const auto& histogram : histograms) {
+                out.latencyHistogram("rpc_service_seconds", {{"method", "orders.place"}}, histogram);
+            }
+        }
+        return out.finish().size();
+    };
+
+    REQUIRE(out.text().size() > 0);
+}
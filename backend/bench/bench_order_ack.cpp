@@ -0,0 +1,137 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "application/alert_rule_engine.hpp"
+#include "infrastructure/metrics/metrics_collector.hpp"
+#include "infrastructure/metrics/metrics_registry.hpp"
+#include "infrastructure/metrics/windowed_metrics.hpp"
+
+using namespace trading::infrastructure::metrics;
+using trading::application::AlertRuleEngine;
+using trading::domain::AlertRule;
+using trading::domain::Metrics;
+
+namespace {
+
+// Same tables the server registers
+const std::vector<std::string> kMethods = {"orders.place", "orders.cancel", "history.query", "market.subscribe", "metrics.get"};
+const std::vector<std::string> kEventSeries = {"orders", "orders.rejected", "errors"};
+const std::vector<std::string> kSymbols = {"ETH-USD", "BTC-USD", "ADA-USD", "SOL-USD"};
+const std::vector<AlertRule> kRules = {
+    {"high_latency", "latencyMs", ">", 100.0, true},
+    {"error_rate", "errorRate", ">", 0.01, true},
+    {"connection_count", "connCount", ">", 1000.0, true},
+    {"high_throughput", "throughput", ">", 2.0, true},
+    {"place_p99", "orders.place.p99_10s", ">", 50.0, true},
+    {"reject_rate", "orders.rejected.rate_10s", ">", 5.0, true}
+};
+
+constexpr int kWarmRequests = 100'000;
+
+// The orders.place ack tail with the server's metrics state behind it: the
+// handler's counter updates and reply, with or without the alert pass that
+// used to run before the reply went out
+struct OrderAckPath {
+    MetricsRegistry registry;
+    CounterFamily ordersPlaced{registry, "orders_placed_total", "symbol", kSymbols};
+    ShardedCounter& ordersCancelled = registry.counter("orders_cancelled_total");
+    CounterFamily rpcErrors{registry, "rpc_errors_total", "method", kMethods};
+    WindowedMetrics windowed{kMethods, kEventSeries};
+    MetricsCollector collector{kMethods};
+    AlertRuleEngine engine{kMethods, kEventSeries};
+    uint64_t orderSeq = 0;
+
+    OrderAckPath() {
+        for (const auto& rule : kRules) {
+            engine.registerRule(rule);
+        }
+        // Histograms filled as after a while of traffic
+        for (int i = 0; i < kWarmRequests; ++i) {
+            const auto& method = kMethods[i % kMethods.size()];
+            double serviceMs = 0.05 + (i % 997) * 0.01;
+            collector.recordRequest(method, serviceMs, 0.01, 0.005);
+            windowed.record(method, static_cast<uint64_t>(serviceMs * 1'000'000));
+            windowed.mark("orders");
+        }
+    }
+
+    // Mirrors AdvancedTradingServer::snapshotMetrics
+    Metrics snapshot() {
+        int64_t totalOrders = registry.total("orders_placed_total");
+        int64_t totalErrs = registry.total("rpc_errors_total");
+        auto windows = windowed.snapshot();
+        int64_t totalOperations = totalOrders + ordersCancelled.value();
+        double errorRate = totalOperations > 0 ? static_cast<double>(totalErrs) / totalOperations : 0.0;
+        auto latency = collector.collect().latency;
+        Metrics metrics(std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch()).count(),
+                        latency.meanMs, windows["orders.rate_10s"], errorRate, 0);
+        metrics.latency = latency;
+        metrics.windowed = std::move(windows);
+        return metrics;
+    }
+
+    size_t evaluateAlerts() {
+        return engine.evaluateTransitions(snapshot()).events.size();
+    }
+
+    std::string ack(bool alertsInline) {
+        const std::string& symbol = kSymbols[orderSeq % kSymbols.size()];
+        ordersPlaced[symbol].increment();
+        windowed.mark("orders");
+        if (alertsInline) {
+            evaluateAlerts();
+        }
+        nlohmann::json response = {
+            {"status", 0},
+            {"orderId", "ORD_" + std::to_string(++orderSeq)},
+            {"reason", ""},
+            {"qos", "AtLeastOnce"},
+            {"symbol", symbol},
+            {"side", "BUY"},
+            {"type", "LIMIT"},
+            {"price", 45000.0},
+            {"quantity", 0.5}
+        };
+        return response.dump();
+    }
+};
+
+} // namespace
+
+TEST_CASE("orders.place ack with the alert pass inline vs on the evaluator thread", "[bench][alerts][order_ack]") {
+    OrderAckPath path;
+    REQUIRE(path.ack(true) != path.ack(false));
+
+    BENCHMARK("ack, alert pass inline (before)") {
+        return path.ack(true);
+    };
+
+    BENCHMARK("ack, counters only (after)") {
+        return path.ack(false);
+    };
+
+    // The evaluator thread sharing the counters and histograms with the order path
+    std::atomic<bool> running{true};
+    std::thread evaluator([&] {
+        while (running.load()) {
+            path.evaluateAlerts();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    });
+    BENCHMARK("ack, counters only, evaluator thread at 100ms (after)") {
+        return path.ack(false);
+    };
+    running = false;
+    evaluator.join();
+
+    BENCHMARK("alert pass alone") {
+        return path.evaluateAlerts();
+    };
+}
@@ -0,0 +1,72 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "application/price_alert_index.hpp"
+
+using namespace trading::application;
+using namespace trading::domain;
+
+namespace {
+
+constexpr int kAlerts = 1'000'000;
+constexpr int kTicks = 1'000'000;
+
+const std::vector<std::string> kSymbols = {"ETH-USD", "BTC-USD", "ADA-USD", "SOL-USD",
+                                           "DOGE-USD", "AVAX-USD", "MATIC-USD", "LINK-USD"};
+const std::vector<double> kBasePrices = {2500.0, 45000.0, 0.45, 95.0, 0.08, 25.0, 0.75, 12.5};
+
+// Levels 1-30% away from the base price, with a tenth of the alerts on moves
+void addAlerts(PriceAlertIndex& index, std::mt19937& rng) {
+    std::uniform_real_distribution<double> distance(0.01, 0.30);
+    std::uniform_real_distribution<double> movePercent(1.0, 10.0);
+    for (int i = 0; i < kAlerts; ++i) {
+        size_t s = static_cast<size_t>(i) % kSymbols.size();
+        std::string id = "alert-" + std::to_string(i);
+        std::string owner = "session-" + std::to_string(i % 10'000);
+        if (i % 10 == 0) {
+            PriceAlert alert(id, owner, kSymbols[s], PriceAlertKind::MOVE, 0.0);
+            alert.movePercent = movePercent(rng);
+            alert.windowMs = (i % 20 == 0) ? 60'000 : 300'000;
+            index.add(alert);
+        } else if (i % 2 == 0) {
+            index.add(PriceAlert(id, owner, kSymbols[s], PriceAlertKind::ABOVE, kBasePrices[s] * (1.0 + distance(rng))));
+        } else {
+            index.add(PriceAlert(id, owner, kSymbols[s], PriceAlertKind::BELOW, kBasePrices[s] * (1.0 - distance(rng))));
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("PriceAlertIndex 1M ticks vs 1M alerts", "[bench][alerts][price]") {
+    std::mt19937 rng(42);
+    PriceAlertIndex index(kAlerts);
+    addAlerts(index, rng);
+    REQUIRE(index.size() == kAlerts);
+
+    // Random walk per symbol at 1000 ticks per simulated second
+    std::vector<double> prices = kBasePrices;
+    std::normal_distribution<double> step(0.0, 0.00005);
+    std::vector<std::pair<size_t, double>> ticks;
+    ticks.reserve(kTicks);
+    for (int i = 0; i < kTicks; ++i) {
+        size_t s = static_cast<size_t>(i) % kSymbols.size();
+        prices[s] *= 1.0 + step(rng);
+        ticks.emplace_back(s, prices[s]);
+    }
+
+    // Fired alerts leave the index, so later samples run against what is left
+    size_t next = 0;
+    size_t fired = 0;
+    BENCHMARK("onTick") {
+        const auto& [s, price] = ticks[next % kTicks];
+        fired += index.onTick(kSymbols[s], static_cast<int64_t>(next), price).size();
+        ++next;
+        return fired;
+    };
+
+    REQUIRE(index.size() == kAlerts - fired);
+}
@@ -0,0 +1,34 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+#include "application/risk_validator.hpp"
+#include "domain/types.hpp"
+
+using namespace trading::application;
+using namespace trading::domain;
+
+TEST_CASE("RiskValidator::validate", "[bench][risk]") {
+    RiskValidator validator;
+    Account account("acc-1", "user-1", "USD", 100000.0);
+
+    // The symbols the server trades, so the position lookup scans a realistic book
+    std::vector<Position> positions;
+    for (const char* symbol : {"ETH-USD", "BTC-USD", "SOL-USD", "ADA-USD", "DOGE-USD", "AVAX-USD", "MATIC-USD", "LINK-USD"}) {
+        positions.emplace_back(symbol, 10.0, 100.0);
+    }
+
+    Order accepted("LINK-USD", "idem-1", OrderType::LIMIT, Side::BUY, 5.0, 15.0);
+    Order rejected("LINK-USD", "idem-2", OrderType::LIMIT, Side::BUY, 5000.0, 15.0);
+    REQUIRE(validator.validate(account, positions, accepted));
+    REQUIRE_FALSE(validator.validate(account, positions, rejected));
+
+    BENCHMARK("accepted order") {
+        return validator.validate(account, positions, accepted);
+    };
+
+    // Rejections also format the error message
+    BENCHMARK("rejected order") {
+        return validator.validate(account, positions, rejected);
+    };
+}
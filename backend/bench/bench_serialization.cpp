@@ -0,0 +1,101 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <binaryrpc/core/protocol/msgpack_protocol.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils/parser.hpp"
+
+namespace {
+
+void packString(msgpack::packer<msgpack::sbuffer>& packer, const std::string& value) {
+    packer.pack_str(static_cast<uint32_t>(value.size()));
+    packer.pack_str_body(value.data(), static_cast<uint32_t>(value.size()));
+}
+
+// orders.place parameters as the frontend sends them
+std::vector<uint8_t> packedOrderRequest() {
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack_map(6);
+    packString(packer, "idempotencyKey");
+    packString(packer, "idem-1718000000000-4f2a9c");
+    packString(packer, "symbol");
+    packString(packer, "ETH-USD");
+    packString(packer, "side");
+    packString(packer, "BUY");
+    packString(packer, "type");
+    packString(packer, "LIMIT");
+    packString(packer, "qty");
+    packer.pack_double(1.5);
+    packString(packer, "price");
+    packer.pack_double(3412.25);
+    return std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size());
+}
+
+// Response body built by handleOrderPlace
+nlohmann::json orderResponse() {
+    return {
+        {"status", 1},
+        {"orderId", "ord_1718000000000_42"},
+        {"echoKey", "idem-1718000000000-4f2a9c"},
+        {"reason", ""},
+        {"qos", "AtLeastOnce - reliable delivery"},
+        {"sessionId", "sess-6b1f0d2e"},
+        {"symbol", "ETH-USD"},
+        {"side", "BUY"},
+        {"type", "LIMIT"},
+        {"price", 3412.25},
+        {"quantity", 1.5},
+        {"idempotencyKey", "idem-1718000000000-4f2a9c"}
+    };
+}
+
+} // namespace
+
+TEST_CASE("parseMsgPackPayload", "[bench][serialization]") {
+    auto request = packedOrderRequest();
+    REQUIRE(parseMsgPackPayload(request)["symbol"] == "ETH-USD");
+
+    BENCHMARK("orders.place request") {
+        return parseMsgPackPayload(request);
+    };
+}
+
+TEST_CASE("RPC response serialization", "[bench][serialization]") {
+    binaryrpc::MsgPackProtocol protocol;
+    auto response = orderResponse();
+
+    // Same steps as the handlers: dump, copy into bytes, frame with the protocol
+    BENCHMARK("orders.place response") {
+        std::string jsonStr = response.dump();
+        std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
+        return protocol.serialize("orders.place", responseData);
+    };
+
+    BENCHMARK("orders.place response, json built per call") {
+        std::string jsonStr = orderResponse().dump();
+        std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
+        return protocol.serialize("orders.place", responseData);
+    };
+}
+
+TEST_CASE("broadcastMarketData encoding", "[bench][serialization]") {
+    binaryrpc::MsgPackProtocol protocol;
+    uint64_t sequence = 0;
+
+    // Tick built by the market data loop, then encoded as broadcastMarketData does
+    BENCHMARK("market_data tick") {
+        nlohmann::json tickData = nlohmann::json::object();
+        tickData["symbol"] = "ETH-USD";
+        tickData["price"] = 3412.25;
+        tickData["change"] = 0.1375;
+        tickData["volume"] = 14211;
+        tickData["seq"] = ++sequence;
+        tickData["timestamp"] = int64_t{1718000000000};
+
+        std::string jsonStr = tickData.dump();
+        std::vector<uint8_t> dataBytes(jsonStr.begin(), jsonStr.end());
+        return protocol.serialize("market_data", dataBytes);
+    };
+}
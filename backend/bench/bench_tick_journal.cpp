@@ -0,0 +1,60 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#include "infrastructure/marketdata/tick_journal.hpp"
+
+using trading::domain::Tick;
+using trading::infrastructure::marketdata::TickJournal;
+
+namespace {
+
+constexpr int64_t kDayStart = 1'718'000'000'000 / 86'400'000 * 86'400'000;
+constexpr int kTicksPerDay = 864'000;  // 10 ticks per second
+
+size_t tickCount(const std::vector<std::span<const Tick>>& spans) {
+    size_t count = 0;
+    for (auto span : spans) {
+        count += span.size();
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Tick journal append and range reads", "[bench][journal]") {
+    auto dir = std::filesystem::temp_directory_path() / ("bull_bench_journal_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    TickJournal journal(dir.string());
+    REQUIRE(journal.open());
+
+    // One day at 10 ticks/s; later appends continue the same clock
+    for (int i = 0; i < kTicksPerDay; ++i) {
+        REQUIRE(journal.append("ETH-USD", Tick(kDayStart + i * 100, 2499.5, 2500.5, 2500.0, 100)));
+    }
+    int64_t nextTs = kDayStart + static_cast<int64_t>(kTicksPerDay) * 100;
+
+    BENCHMARK("append 1000 ticks") {
+        for (int i = 0; i < 1000; ++i) {
+            journal.append("BTC-USD", Tick(nextTs, 44999.0, 45001.0, 45000.0, 10));
+            nextTs += 1;
+        }
+        return nextTs;
+    };
+
+    BENCHMARK("range read, 1 minute of a day (600 ticks)") {
+        return tickCount(journal.range("ETH-USD", kDayStart + 43'200'000, kDayStart + 43'260'000));
+    };
+
+    BENCHMARK("range read, 1 hour of a day (36000 ticks)") {
+        return tickCount(journal.range("ETH-USD", kDayStart + 43'200'000, kDayStart + 46'800'000));
+    };
+
+    BENCHMARK("recent 1000 ticks") {
+        return tickCount(journal.recent("ETH-USD", 1000));
+    };
+
+    journal.close();
+    std::filesystem::remove_all(dir);
+}
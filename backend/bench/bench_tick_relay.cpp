@@ -0,0 +1,164 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "infrastructure/marketdata/tick_ring.hpp"
+
+using trading::domain::Tick;
+using namespace trading::infrastructure::marketdata;
+
+namespace {
+
+constexpr uint64_t kTicks = 20000;
+constexpr size_t kClientsPerEdge = 1000;
+
+struct EdgeReport {
+    uint64_t ticks;
+    uint64_t deliveries;
+    uint64_t digest;  // Order of the ticks seen, to compare across edges
+};
+
+// One edge process: follows the ring and copies every tick's frame into each
+// client's outbound buffer, the CPU side of a room broadcast. Writes one byte
+// to readyFd once the ring is mapped, 1 if it is.
+EdgeReport runEdge(const std::string& path, int readyFd) {
+    EdgeReport report{0, 0, 1469598103934665603ull};
+    TickRingReader reader;
+    char ready = reader.open(path) ? 1 : 0;
+    if (::write(readyFd, &ready, 1) != 1 || !ready) {
+        return report;
+    }
+    std::vector<std::string> outbound(kClientsPerEdge);
+    for (auto& buffer : outbound) {
+        buffer.reserve(64 * 1024);
+    }
+
+    std::vector<RelayTick> batch;
+    char frame[160];
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (report.ticks < kTicks && std::chrono::steady_clock::now() < deadline) {
+        batch.clear();
+        reader.poll(batch, std::chrono::milliseconds(10));
+        for (const RelayTick& tick : batch) {
+            int size = std::snprintf(frame + 2, sizeof(frame) - 2,
+                                     "{\"symbol\":\"%s\",\"price\":%.8g,\"change\":%.4f,\"volume\":%llu,\"seq\":%llu,\"timestamp\":%lld}",
+                                     tick.symbol, tick.tick.last, tick.changePercent, static_cast<unsigned long long>(tick.tick.volume),
+                                     static_cast<unsigned long long>(tick.seq), static_cast<long long>(tick.tick.ts));
+            frame[0] = static_cast<char>(0x82);
+            frame[1] = static_cast<char>(size);
+            for (auto& buffer : outbound) {
+                if (buffer.size() > 60 * 1024) {
+                    buffer.clear();  // Flushed to the socket
+                }
+                buffer.append(frame, static_cast<size_t>(size) + 2);
+            }
+            report.deliveries += outbound.size();
+            report.digest = (report.digest ^ tick.seq) * 1099511628211ull;
+            ++report.ticks;
+        }
+    }
+    return report;
+}
+
+} // namespace
+
+TEST_CASE("Relay fan-out across edge processes", "[bench][relay]") {
+    std::string path = (std::filesystem::temp_directory_path() / ("bull_bench_ring_" + std::to_string(::getpid()))).string();
+    std::cout << "[Relay] " << std::thread::hardware_concurrency() << " cores, " << kClientsPerEdge << " clients per edge, "
+              << kTicks << " ticks" << std::endl;
+
+    double singleEdgeRate = 0.0;
+    for (int edges : {1, 2, 4}) {
+        TickRingWriter writer(1 << 16);  // Holds every tick, so no edge is lapped
+        REQUIRE(writer.open(path));
+
+        int results[2];
+        int ready[2];
+        REQUIRE(::pipe(results) == 0);
+        REQUIRE(::pipe(ready) == 0);
+        std::vector<pid_t> pids;
+        for (int edge = 0; edge < edges; ++edge) {
+            pid_t pid = ::fork();
+            REQUIRE(pid >= 0);
+            if (pid == 0) {
+                ::close(results[0]);
+                ::close(ready[0]);
+                EdgeReport report = runEdge(path, ready[1]);
+                ssize_t written = ::write(results[1], &report, sizeof(report));
+                ::_exit(written == sizeof(report) ? 0 : 1);
+            }
+            pids.push_back(pid);
+        }
+        ::close(results[1]);
+        ::close(ready[1]);
+        // Every edge has mapped the ring before the first tick
+        for (int edge = 0; edge < edges; ++edge) {
+            char mapped = 0;
+            REQUIRE(::read(ready[0], &mapped, 1) == 1);
+            REQUIRE(mapped == 1);
+        }
+        ::close(ready[0]);
+
+        auto started = std::chrono::steady_clock::now();
+        for (uint64_t seq = 1; seq <= kTicks; ++seq) {
+            double price = 2500.0 + static_cast<double>(seq % 100);
+            writer.publish(RelayTick::make(seq, "ETH-USD", Tick(1'718'000'000'000 + static_cast<int64_t>(seq), price, price, price, 100), 0.1));
+        }
+
+        uint64_t deliveries = 0;
+        uint64_t digest = 0;
+        for (int edge = 0; edge < edges; ++edge) {
+            EdgeReport report{};
+            REQUIRE(::read(results[0], &report, sizeof(report)) == sizeof(report));
+            REQUIRE(report.ticks == kTicks);
+            if (edge > 0) {
+                REQUIRE(report.digest == digest);  // Same ticks in the same order on every edge
+            }
+            digest = report.digest;
+            deliveries += report.deliveries;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        ::close(results[0]);
+        for (pid_t pid : pids) {
+            ::waitpid(pid, nullptr, 0);
+        }
+
+        double rate = static_cast<double>(deliveries) / seconds;
+        if (edges == 1) {
+            singleEdgeRate = rate;
+        }
+        std::cout << "[Relay] " << edges << " edge(s): " << static_cast<uint64_t>(rate / 1e6) << "M deliveries/s, "
+                  << rate / singleEdgeRate << "x one edge; clients served at 1000 ticks/s: " << static_cast<uint64_t>(rate / 1000)
+                  << std::endl;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Tick ring publish and drain", "[bench][relay]") {
+    std::string path = (std::filesystem::temp_directory_path() / ("bull_bench_ring_io_" + std::to_string(::getpid()))).string();
+    TickRingWriter writer(1 << 16);
+    REQUIRE(writer.open(path));
+    TickRingReader reader;
+    REQUIRE(reader.open(path));
+    RelayTick tick = RelayTick::make(0, "ETH-USD", Tick(1'718'000'000'000, 2499.5, 2500.5, 2500.0, 100), 0.1);
+    std::vector<RelayTick> batch;
+    batch.reserve(1000);
+
+    BENCHMARK("publish and drain 1000 ticks") {
+        for (int i = 0; i < 1000; ++i) {
+            ++tick.seq;
+            writer.publish(tick);
+        }
+        batch.clear();
+        return reader.poll(batch, std::chrono::milliseconds(0));
+    };
+    REQUIRE(reader.stats().lost == 0);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,41 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include "infrastructure/metrics/trace_recorder.hpp"
+
+using namespace trading::infrastructure::metrics;
+
+TEST_CASE("Trace span overhead", "[bench][tracing]") {
+    auto& recorder = TraceRecorder::instance();
+
+    // Clock reads dominate; under virtualization rdtsc can cost several times its bare-metal price
+    uint64_t sink = 0;
+    BENCHMARK("clock read") {
+        return sink += TraceRecorder::now();
+    };
+
+    recorder.setEnabled(true);
+    BENCHMARK("ring record, no clock reads") {
+        recorder.record("bench.record", sink, sink + 1);
+    };
+
+    BENCHMARK("TraceSpan enabled, 2 clock reads") {
+        TraceSpan span("bench.span");
+    };
+
+    {
+        TraceSpan stage("bench.stage");
+        BENCHMARK("TraceSpan::next per stage, 1 clock read") {
+            stage.next("bench.stage");
+        };
+    }
+
+    recorder.setEnabled(false);
+    BENCHMARK("TraceSpan disabled at runtime") {
+        TraceSpan span("bench.span");
+    };
+
+    recorder.setEnabled(true);
+    recorder.clear();
+    REQUIRE(sink != 0);
+}
@@ -0,0 +1,390 @@
+#include "alert_rule_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <stdexcept>
+
+namespace trading::application {
+
+namespace {
+
+struct MetricInfo {
+    const char* key;
+    const char* label;
+};
+
+constexpr MetricInfo kMetrics[] = {
+    {"latencyMs", "latency"},
+    {"throughput", "throughput"},
+    {"errorRate", "error rate"},
+    {"connCount", "connection count"},
+};
+
+constexpr const char* kComparatorSymbols[] = {">", ">=", "<", "<=", "=="};
+
+constexpr uint32_t kUnassignedMetricId = UINT32_MAX;
+
+// Position of the "<stat>" suffix in kWindowedStats, if the key has a series and a known stat
+std::optional<size_t> windowedStatIndex(const std::string& metricKey) {
+    auto dot = metricKey.rfind('.');
+    if (dot == std::string::npos || dot == 0) {
+        return std::nullopt;
+    }
+    auto stat = std::string_view(metricKey).substr(dot + 1);
+    const auto& stats = trading::domain::kWindowedStats;
+    auto it = std::find(stats.begin(), stats.end(), stat);
+    if (it == stats.end()) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(std::distance(stats.begin(), it));
+}
+
+} // namespace
+
+AlertRuleEngine::AlertRuleEngine(double defaultHysteresisRatio, std::chrono::milliseconds defaultCooldown)
+    : index_(kMetricCount), defaultHysteresisRatio_(defaultHysteresisRatio), defaultCooldownMs_(defaultCooldown.count()) {
+    for (size_t i = 0; i < kMetricCount; ++i) {
+        metricKeys_.emplace_back(kMetrics[i].key);
+        metricIds_.emplace(kMetrics[i].key, static_cast<uint32_t>(i));
+    }
+}
+
+AlertRuleEngine::AlertRuleEngine(const std::vector<std::string>& valueSeries, const std::vector<std::string>& eventSeries,
+                                 double defaultHysteresisRatio, std::chrono::milliseconds defaultCooldown)
+    : AlertRuleEngine(defaultHysteresisRatio, defaultCooldown) {
+    for (const auto& name : valueSeries) {
+        windowedSeries_.emplace(name, true);
+    }
+    for (const auto& name : eventSeries) {
+        windowedSeries_.emplace(name, false);
+    }
+}
+
+bool AlertRuleEngine::isWindowedMetricKey(const std::string& metricKey) const {
+    auto stat = windowedStatIndex(metricKey);
+    if (!stat) {
+        return false;
+    }
+    auto series = windowedSeries_.find(metricKey.substr(0, metricKey.rfind('.')));
+    if (series == windowedSeries_.end()) {
+        return false;
+    }
+    return series->second || *stat < trading::domain::kWindowedRateStatCount;
+}
+
+bool AlertRuleEngine::isLatencyMetricKey(const std::string& metricKey) {
+    if (metricKey == kMetrics[static_cast<size_t>(AlertMetric::LATENCY_MS)].key) {
+        return true;
+    }
+    auto stat = windowedStatIndex(metricKey);
+    return stat && *stat >= trading::domain::kWindowedRateStatCount;
+}
+
+// Current value of every interned metric; NaN where a windowed value is missing
+std::vector<double> AlertRuleEngine::metricValues(const trading::domain::Metrics& metrics) const {
+    std::vector<double> values(metricKeys_.size(), std::numeric_limits<double>::quiet_NaN());
+    values[static_cast<size_t>(AlertMetric::LATENCY_MS)] = metrics.latencyMs;
+    values[static_cast<size_t>(AlertMetric::THROUGHPUT)] = metrics.throughput;
+    values[static_cast<size_t>(AlertMetric::ERROR_RATE)] = metrics.errorRate;
+    values[static_cast<size_t>(AlertMetric::CONN_COUNT)] = static_cast<double>(metrics.connCount);
+    for (size_t id = kMetricCount; id < metricKeys_.size(); ++id) {
+        auto it = metrics.windowed.find(metricKeys_[id]);
+        if (it != metrics.windowed.end()) {
+            values[id] = it->second;
+        }
+    }
+    return values;
+}
+
+std::optional<AlertMetric> AlertRuleEngine::parseMetric(const std::string& metricKey) {
+    for (size_t i = 0; i < kMetricCount; ++i) {
+        if (metricKey == kMetrics[i].key) {
+            return static_cast<AlertMetric>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<AlertComparator> AlertRuleEngine::parseComparator(const std::string& op) {
+    for (size_t i = 0; i < kComparatorCount; ++i) {
+        if (op == kComparatorSymbols[i]) {
+            return static_cast<AlertComparator>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+const char* AlertRuleEngine::metricName(AlertMetric metric) {
+    return kMetrics[static_cast<size_t>(metric)].key;
+}
+
+const char* AlertRuleEngine::comparatorSymbol(AlertComparator comparator) {
+    return kComparatorSymbols[static_cast<size_t>(comparator)];
+}
+
+AlertRuleEngine::CompiledRule AlertRuleEngine::compile(const trading::domain::AlertRule& rule,
+                                                       double defaultHysteresisRatio, int64_t defaultCooldownMs) const {
+    auto metric = parseMetric(rule.metricKey);
+    if (!metric && !isWindowedMetricKey(rule.metricKey)) {
+        throw std::invalid_argument("Unknown metric key: " + rule.metricKey);
+    }
+    auto comparator = parseComparator(rule.operator_);
+    if (!comparator) {
+        throw std::invalid_argument("Unknown operator: " + rule.operator_);
+    }
+
+    double hysteresis = rule.hysteresis.value_or(std::abs(rule.threshold) * defaultHysteresisRatio);
+    int64_t cooldownMs = rule.cooldownMs.value_or(defaultCooldownMs);
+    if (hysteresis < 0.0 || cooldownMs < 0) {
+        throw std::invalid_argument("Hysteresis and cooldown must not be negative");
+    }
+
+    std::string label = metric ? kMetrics[static_cast<size_t>(*metric)].label : rule.metricKey;
+    std::string description = label + " " + comparatorSymbol(*comparator) + " " + std::to_string(rule.threshold);
+    uint32_t metricId = metric ? static_cast<uint32_t>(*metric) : kUnassignedMetricId;
+    return CompiledRule{rule.ruleId, rule.metricKey, metricId, *comparator, rule.threshold, rule.enabled,
+                        hysteresis, cooldownMs, std::move(description)};
+}
+
+void AlertRuleEngine::registerRule(const trading::domain::AlertRule& rule) {
+    auto compiled = compile(rule, defaultHysteresisRatio_, defaultCooldownMs_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (compiled.metricId == kUnassignedMetricId) {
+        auto [it, inserted] = metricIds_.emplace(compiled.metricKey, static_cast<uint32_t>(metricKeys_.size()));
+        if (inserted) {
+            metricKeys_.push_back(compiled.metricKey);
+            index_.emplace_back();
+        }
+        compiled.metricId = it->second;
+    }
+    auto it = slots_.find(compiled.ruleId);
+    if (it != slots_.end()) {
+        resetState(it->second);
+        rules_[it->second] = std::move(compiled);
+    } else {
+        slots_.emplace(compiled.ruleId, static_cast<uint32_t>(rules_.size()));
+        rules_.push_back(std::move(compiled));
+        states_.emplace_back();
+    }
+    indexDirty_ = true;
+}
+
+void AlertRuleEngine::disableRule(const std::string& ruleId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(ruleId);
+    if (it != slots_.end() && rules_[it->second].enabled) {
+        rules_[it->second].enabled = false;
+        resetState(it->second);
+        indexDirty_ = true;
+    }
+}
+
+size_t AlertRuleEngine::ruleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rules_.size();
+}
+
+size_t AlertRuleEngine::firingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return firingSlots_.size();
+}
+
+void AlertRuleEngine::resetState(uint32_t slot) {
+    const auto& state = states_[slot];
+    if (state.firing) {
+        firingSlots_.erase(std::find(firingSlots_.begin(), firingSlots_.end(), slot));
+        if (!state.silent) {
+            // Subscribers saw it fire; the rule as they knew it resolves
+            int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            pendingResolves_.push_back(makeEvent(rules_[slot], state.lastValue, nowMs, trading::domain::AlertState::RESOLVED));
+        }
+    }
+    states_[slot] = RuleState{};
+}
+
+void AlertRuleEngine::rebuildIndex() {
+    for (auto& byComparator : index_) {
+        for (auto& entries : byComparator) {
+            entries.clear();
+        }
+    }
+
+    for (uint32_t slot = 0; slot < rules_.size(); ++slot) {
+        const auto& rule = rules_[slot];
+        if (rule.enabled) {
+            index_[rule.metricId][static_cast<size_t>(rule.comparator)]
+                .push_back({rule.threshold, slot});
+        }
+    }
+
+    for (auto& byComparator : index_) {
+        for (auto& entries : byComparator) {
+            std::sort(entries.begin(), entries.end(),
+                [](const IndexEntry& a, const IndexEntry& b) { return a.threshold < b.threshold; });
+        }
+    }
+    indexDirty_ = false;
+}
+
+template <typename Visit>
+void AlertRuleEngine::forEachTriggered(uint32_t metricId, double value, Visit&& visit) const {
+    if (std::isnan(value)) {
+        return;
+    }
+    const auto& byComparator = index_[metricId];
+    auto thresholdLess = [](const IndexEntry& entry, double v) { return entry.threshold < v; };
+    auto valueLess = [](double v, const IndexEntry& entry) { return v < entry.threshold; };
+
+    auto visitRange = [&](auto first, auto last) {
+        for (auto it = first; it != last; ++it) {
+            visit(it->slot);
+        }
+    };
+
+    // Thresholds are ascending, so each comparator selects a prefix, suffix or equal range
+    const auto& gt = byComparator[static_cast<size_t>(AlertComparator::GREATER)];
+    visitRange(gt.begin(), std::lower_bound(gt.begin(), gt.end(), value, thresholdLess));
+
+    const auto& ge = byComparator[static_cast<size_t>(AlertComparator::GREATER_EQUAL)];
+    visitRange(ge.begin(), std::upper_bound(ge.begin(), ge.end(), value, valueLess));
+
+    const auto& lt = byComparator[static_cast<size_t>(AlertComparator::LESS)];
+    visitRange(std::upper_bound(lt.begin(), lt.end(), value, valueLess), lt.end());
+
+    const auto& le = byComparator[static_cast<size_t>(AlertComparator::LESS_EQUAL)];
+    visitRange(std::lower_bound(le.begin(), le.end(), value, thresholdLess), le.end());
+
+    const auto& eq = byComparator[static_cast<size_t>(AlertComparator::EQUAL)];
+    visitRange(std::lower_bound(eq.begin(), eq.end(), value, thresholdLess),
+               std::upper_bound(eq.begin(), eq.end(), value, valueLess));
+}
+
+bool AlertRuleEngine::withinHysteresis(const CompiledRule& rule, double value) {
+    switch (rule.comparator) {
+        case AlertComparator::GREATER:       return value > rule.threshold - rule.hysteresis;
+        case AlertComparator::GREATER_EQUAL: return value >= rule.threshold - rule.hysteresis;
+        case AlertComparator::LESS:          return value < rule.threshold + rule.hysteresis;
+        case AlertComparator::LESS_EQUAL:    return value <= rule.threshold + rule.hysteresis;
+        case AlertComparator::EQUAL:         return std::abs(value - rule.threshold) <= rule.hysteresis;
+        default:                             return false;
+    }
+}
+
+trading::domain::AlertEvent AlertRuleEngine::makeEvent(const CompiledRule& rule, double value, int64_t ts,
+                                                       trading::domain::AlertState state) {
+    bool resolved = state == trading::domain::AlertState::RESOLVED;
+    trading::domain::AlertEvent event(
+        rule.ruleId + "_" + std::to_string(ts) + (resolved ? "_resolved" : ""), rule.ruleId, ts, value,
+        (resolved ? "resolved: " : "") + rule.description + " (current: " + std::to_string(value) + ")");
+    event.state = state;
+    return event;
+}
+
+std::vector<trading::domain::AlertEvent> AlertRuleEngine::evaluateMetric(AlertMetric metric, double value, int64_t ts) {
+    std::vector<trading::domain::AlertEvent> events;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (indexDirty_) {
+        rebuildIndex();
+    }
+    forEachTriggered(static_cast<uint32_t>(metric), value, [&](uint32_t slot) {
+        events.push_back(makeEvent(rules_[slot], value, ts, trading::domain::AlertState::FIRING));
+    });
+    return events;
+}
+
+std::vector<trading::domain::AlertEvent> AlertRuleEngine::evaluate(const trading::domain::Metrics& metrics) {
+    std::vector<trading::domain::AlertEvent> events;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (indexDirty_) {
+        rebuildIndex();
+    }
+    auto values = metricValues(metrics);
+    for (uint32_t m = 0; m < values.size(); ++m) {
+        forEachTriggered(m, values[m], [&](uint32_t slot) {
+            events.push_back(makeEvent(rules_[slot], values[m], metrics.ts, trading::domain::AlertState::FIRING));
+        });
+    }
+    return events;
+}
+
+trading::domain::AlertTransitions AlertRuleEngine::evaluateTransitions(const trading::domain::Metrics& metrics) {
+    trading::domain::AlertTransitions result;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (indexDirty_) {
+        rebuildIndex();
+    }
+    auto values = metricValues(metrics);
+    ++pass_;
+    result.events = std::move(pendingResolves_);
+    pendingResolves_.clear();
+
+    // Rising edges: triggered rules that were not firing yet. suppressed counts
+    // only transitions held back, not rules that simply stay firing.
+    for (uint32_t m = 0; m < values.size(); ++m) {
+        forEachTriggered(m, values[m], [&](uint32_t slot) {
+            auto& state = states_[slot];
+            const auto& rule = rules_[slot];
+            state.seenPass = pass_;
+            state.lastValue = values[m];
+            if (state.firing) {
+                state.inBand = false;
+                return;
+            }
+
+            state.firing = true;
+            firingSlots_.push_back(slot);
+            if (state.notified && metrics.ts - state.lastNotifiedMs < rule.cooldownMs) {
+                state.silent = true;
+                ++result.suppressed;
+                return;
+            }
+            state.silent = false;
+            state.notified = true;
+            state.lastNotifiedMs = metrics.ts;
+            result.events.push_back(makeEvent(rule, values[m], metrics.ts, trading::domain::AlertState::FIRING));
+        });
+    }
+
+    // Falling edges: firing rules no longer triggered and outside their hysteresis band
+    for (size_t i = 0; i < firingSlots_.size();) {
+        uint32_t slot = firingSlots_[i];
+        auto& state = states_[slot];
+        const auto& rule = rules_[slot];
+        double value = values[rule.metricId];
+
+        // Triggered this pass, or no value to judge by
+        if (state.seenPass == pass_ || std::isnan(value)) {
+            ++i;
+            continue;
+        }
+        state.lastValue = value;
+        if (withinHysteresis(rule, value)) {
+            if (!state.inBand) {
+                state.inBand = true;
+                ++result.suppressed;
+            }
+            ++i;
+            continue;
+        }
+
+        state.firing = false;
+        state.inBand = false;
+        if (state.silent) {
+            ++result.suppressed;
+        } else {
+            result.events.push_back(makeEvent(rule, value, metrics.ts, trading::domain::AlertState::RESOLVED));
+        }
+        firingSlots_[i] = firingSlots_.back();
+        firingSlots_.pop_back();
+    }
+    return result;
+}
+
+} // namespace trading::application
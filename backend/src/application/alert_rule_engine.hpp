@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../domain/interfaces.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::application {
+
+// Built-in metrics read from trading::domain::Metrics fields. Rules may also name
+// windowed series as "<series>.<stat>" (see trading::domain::kWindowedStats); only
+// series the engine was constructed with are accepted.
+enum class AlertMetric : uint8_t {
+    LATENCY_MS,
+    THROUGHPUT,
+    ERROR_RATE,
+    CONN_COUNT,
+    COUNT
+};
+
+enum class AlertComparator : uint8_t {
+    GREATER,
+    GREATER_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    EQUAL,
+    COUNT
+};
+
+// Alert rules compiled at registration into a typed form and indexed per metric
+// and comparator by threshold. A metric update finds every triggered rule with a
+// single binary search per comparator, so evaluation costs O(log n + triggered)
+// instead of a string-matching pass over every rule.
+//
+// evaluateTransitions() additionally keeps fire/resolve state per rule: a firing
+// rule only resolves once the value leaves its hysteresis band, and a rule that
+// fires again within its cooldown is tracked but not notified. A missing (NaN)
+// value changes nothing. A firing rule that is disabled or re-registered
+// resolves with the next evaluateTransitions().
+class AlertRuleEngine : public trading::domain::IAlertingService {
+public:
+    struct CompiledRule {
+        std::string ruleId;
+        std::string metricKey;
+        uint32_t metricId;   // AlertMetric value for built-ins, assigned at registration otherwise
+        AlertComparator comparator;
+        double threshold;
+        bool enabled;
+        double hysteresis;   // Absolute band past the threshold
+        int64_t cooldownMs;
+        std::string description;  // e.g. "latency > 100.000000", built once at registration
+    };
+
+private:
+    struct IndexEntry {
+        double threshold;
+        uint32_t slot;
+    };
+
+    struct RuleState {
+        bool firing = false;
+        bool silent = false;     // Fired during cooldown, so its resolve is not notified either
+        bool inBand = false;     // Resolve held back by the hysteresis band, counted once
+        bool notified = false;
+        double lastValue = 0.0;
+        int64_t lastNotifiedMs = 0;
+        uint64_t seenPass = 0;
+    };
+
+    static constexpr size_t kMetricCount = static_cast<size_t>(AlertMetric::COUNT);
+    static constexpr size_t kComparatorCount = static_cast<size_t>(AlertComparator::COUNT);
+    using ComparatorIndex = std::array<std::vector<IndexEntry>, kComparatorCount>;
+
+    // Rule slots are reused on re-registration; the index is rebuilt lazily after changes
+    std::vector<CompiledRule> rules_;
+    std::vector<RuleState> states_;
+    std::unordered_map<std::string, uint32_t> slots_;
+    // Metric ids: built-ins first, then windowed keys in order of first use
+    std::vector<std::string> metricKeys_;
+    std::unordered_map<std::string, uint32_t> metricIds_;
+    std::vector<ComparatorIndex> index_;
+    bool indexDirty_ = false;
+    std::vector<uint32_t> firingSlots_;
+    // Resolves of firing rules that were disabled or replaced, for the next pass
+    std::vector<trading::domain::AlertEvent> pendingResolves_;
+    uint64_t pass_ = 0;
+    double defaultHysteresisRatio_;
+    int64_t defaultCooldownMs_;
+    // Windowed series rules may reference; true for series that also report latency stats
+    std::unordered_map<std::string, bool> windowedSeries_;
+    mutable std::mutex mutex_;
+
+    void rebuildIndex();
+    void resetState(uint32_t slot);
+    template <typename Visit>
+    void forEachTriggered(uint32_t metricId, double value, Visit&& visit) const;
+    std::vector<double> metricValues(const trading::domain::Metrics& metrics) const;
+    static bool withinHysteresis(const CompiledRule& rule, double value);
+    static trading::domain::AlertEvent makeEvent(const CompiledRule& rule, double value, int64_t ts,
+                                                 trading::domain::AlertState state);
+
+public:
+    // Defaults apply to rules that do not set their own hysteresis or cooldown.
+    // The hysteresis ratio is relative to the rule's threshold.
+    explicit AlertRuleEngine(double defaultHysteresisRatio = 0.05,
+                             std::chrono::milliseconds defaultCooldown = std::chrono::seconds(30));
+    // Value series report every windowed stat, event series only the rates
+    // (the same split as WindowedMetrics)
+    AlertRuleEngine(const std::vector<std::string>& valueSeries, const std::vector<std::string>& eventSeries,
+                    double defaultHysteresisRatio = 0.05,
+                    std::chrono::milliseconds defaultCooldown = std::chrono::seconds(30));
+    ~AlertRuleEngine() = default;
+
+    static std::optional<AlertMetric> parseMetric(const std::string& metricKey);
+    static std::optional<AlertComparator> parseComparator(const std::string& op);
+    static const char* metricName(AlertMetric metric);
+    static const char* comparatorSymbol(AlertComparator comparator);
+    // Metrics measured in milliseconds, whose thresholds may carry a duration unit
+    static bool isLatencyMetricKey(const std::string& metricKey);
+
+    // "<series>.<stat>" on a registered series that reports that stat
+    bool isWindowedMetricKey(const std::string& metricKey) const;
+
+    // Throws std::invalid_argument for unknown metric keys or operators
+    CompiledRule compile(const trading::domain::AlertRule& rule,
+                         double defaultHysteresisRatio = 0.0, int64_t defaultCooldownMs = 0) const;
+
+    std::vector<trading::domain::AlertEvent> evaluate(const trading::domain::Metrics& metrics) override;
+    trading::domain::AlertTransitions evaluateTransitions(const trading::domain::Metrics& metrics) override;
+    void registerRule(const trading::domain::AlertRule& rule) override;
+    void disableRule(const std::string& ruleId) override;
+
+    // Rules triggered by a single metric update
+    std::vector<trading::domain::AlertEvent> evaluateMetric(AlertMetric metric, double value, int64_t ts);
+
+    size_t ruleCount() const;
+    size_t firingCount() const;
+};
+
+} // namespace trading::application
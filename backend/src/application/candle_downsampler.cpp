@@ -0,0 +1,119 @@
+#include "candle_downsampler.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+
+namespace trading::application {
+
+using trading::domain::Candle;
+using trading::domain::Interval;
+using trading::domain::Tick;
+
+namespace {
+
+constexpr int64_t kWeek = 7 * 86400;
+constexpr int64_t kBucketLadder[] = {1, 5, 15, 30, 60, 300, 900, 1800, 3600, 7200, 14400, 21600, 43200, 86400, 2 * 86400, kWeek};
+
+int64_t floorTo(int64_t ts, int64_t bucket) {
+    return ts - ((ts % bucket) + bucket) % bucket;
+}
+
+int64_t bucketCount(int64_t fromTs, int64_t toTs, int64_t bucket) {
+    return (floorTo(toTs, bucket) - floorTo(fromTs, bucket)) / bucket + 1;
+}
+
+} // namespace
+
+int64_t intervalSeconds(Interval interval) {
+    switch (interval) {
+        case Interval::S1: return 1;
+        case Interval::S5: return 5;
+        case Interval::S15: return 15;
+        case Interval::M1: return 60;
+        case Interval::M5: return 300;
+        case Interval::M15: return 900;
+        case Interval::H1: return 3600;
+        case Interval::D1: return 86400;
+    }
+    return 60;
+}
+
+int64_t downsampleBucketSeconds(int64_t fromTs, int64_t toTs, Interval interval, int32_t maxPoints) {
+    int64_t base = intervalSeconds(interval);
+    if (maxPoints <= 0 || toTs < fromTs || bucketCount(fromTs, toTs, base) <= maxPoints) {
+        return base;
+    }
+    for (int64_t bucket : kBucketLadder) {
+        if (bucket > base && bucket % base == 0 && bucketCount(fromTs, toTs, bucket) <= maxPoints) {
+            return bucket;
+        }
+    }
+    // Whole weeks; one extra covers a range that straddles week boundaries
+    int64_t weeks = (toTs - fromTs) / (kWeek * maxPoints) + 1;
+    while (bucketCount(fromTs, toTs, weeks * kWeek) > maxPoints) {
+        ++weeks;
+    }
+    return weeks * kWeek;
+}
+
+std::vector<Candle> downsampleCandles(const std::vector<Candle>& candles, int64_t bucketSeconds) {
+    if (bucketSeconds <= 0) {
+        return candles;
+    }
+
+    struct Bucket {
+        Candle candle;
+        int64_t firstTime;
+        int64_t lastTime;
+    };
+    std::map<int64_t, Bucket, std::greater<>> buckets;
+    for (const Candle& candle : candles) {
+        int64_t start = floorTo(candle.openTime, bucketSeconds);
+        auto [it, inserted] = buckets.try_emplace(start, Bucket{candle, candle.openTime, candle.openTime});
+        Bucket& bucket = it->second;
+        if (inserted) {
+            bucket.candle.openTime = start;
+            continue;
+        }
+        if (candle.openTime < bucket.firstTime) {
+            bucket.firstTime = candle.openTime;
+            bucket.candle.open = candle.open;
+        }
+        if (candle.openTime >= bucket.lastTime) {
+            bucket.lastTime = candle.openTime;
+            bucket.candle.close = candle.close;
+        }
+        bucket.candle.high = std::max(bucket.candle.high, candle.high);
+        bucket.candle.low = std::min(bucket.candle.low, candle.low);
+        bucket.candle.volume += candle.volume;
+    }
+
+    std::vector<Candle> merged;
+    merged.reserve(buckets.size());
+    std::transform(buckets.begin(), buckets.end(), std::back_inserter(merged), [](const auto& entry) { return entry.second.candle; });
+    return merged;
+}
+
+std::vector<Candle> candlesFromTicks(const std::vector<std::span<const Tick>>& ticks, Interval interval) {
+    int64_t bucketSeconds = intervalSeconds(interval);
+    std::vector<Candle> candles;
+    for (auto span : ticks) {
+        for (const Tick& tick : span) {
+            int64_t start = floorTo(floorTo(tick.ts, 1000) / 1000, bucketSeconds);
+            if (candles.empty() || candles.back().openTime != start) {
+                candles.emplace_back(start, tick.last, tick.last, tick.last, tick.last, tick.volume, interval);
+                continue;
+            }
+            Candle& candle = candles.back();
+            candle.high = std::max(candle.high, tick.last);
+            candle.low = std::min(candle.low, tick.last);
+            candle.close = tick.last;
+            candle.volume += tick.volume;
+        }
+    }
+    std::reverse(candles.begin(), candles.end());
+    return candles;
+}
+
+} // namespace trading::application
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../domain/types.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace trading::application {
+
+// Fits candle history for a time range into a point budget. Candles are merged
+// into wider, epoch-aligned buckets as OHLCV (first open, last close, extreme
+// high and low, summed volume), so every spike in the range survives, which a
+// point-picking scheme such as LTTB cannot promise for candlesticks.
+
+int64_t intervalSeconds(trading::domain::Interval interval);
+
+// Smallest bucket on a ladder of chart-friendly widths (1m, 5m, 15m, 30m, 1h,
+// ... 1d, 1w and whole weeks beyond) that is a multiple of the interval and
+// puts [fromTs, toTs] into at most maxPoints buckets. The interval's own width
+// when that already fits, or when maxPoints is not positive.
+int64_t downsampleBucketSeconds(int64_t fromTs, int64_t toTs, trading::domain::Interval interval, int32_t maxPoints);
+
+// Merges candles in any order into buckets of bucketSeconds, newest first like
+// the repository. Candles already aligned to the bucket come back unchanged.
+std::vector<trading::domain::Candle> downsampleCandles(const std::vector<trading::domain::Candle>& candles, int64_t bucketSeconds);
+
+// Candles of the interval built from ticks in ts order (milliseconds), newest
+// first like the repository: the first and last trade price open and close
+// each bucket, and tick volumes add up
+std::vector<trading::domain::Candle> candlesFromTicks(const std::vector<std::span<const trading::domain::Tick>>& ticks,
+                                                      trading::domain::Interval interval);
+
+} // namespace trading::application
@@ -0,0 +1,54 @@
+#include "history_warmup.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <thread>
+
+namespace trading::application {
+
+HistoryWarmupResult warmHistory(trading::domain::IHistoryRepository& repository, const std::vector<std::string>& symbols,
+                                int64_t nowSeconds, size_t parallelism) {
+    auto started = std::chrono::steady_clock::now();
+    HistoryWarmupResult result;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> warmed{0};
+    std::atomic<size_t> candles{0};
+    trading::domain::HistoryQuery page(nowSeconds - kWarmupWindowSeconds, nowSeconds, trading::domain::Interval::M1, kWarmupCandles);
+
+    auto warmSymbols = [&] {
+        for (size_t i = next.fetch_add(1); i < symbols.size(); i = next.fetch_add(1)) {
+            try {
+                candles.fetch_add(repository.fetch(trading::domain::Symbol(symbols[i]), page).size(), std::memory_order_relaxed);
+                warmed.fetch_add(1, std::memory_order_relaxed);
+            } catch (const std::exception& e) {
+                std::cerr << "[Warmup] History page for " << symbols[i] << " failed: " << e.what() << std::endl;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    size_t threads = std::min(std::max<size_t>(parallelism, 1), symbols.size());
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(warmSymbols);
+    }
+    warmSymbols();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    result.symbolsWarmed = warmed.load();
+    result.candles = candles.load();
+
+    if (!symbols.empty()) {
+        std::vector<trading::domain::Symbol> all(symbols.begin(), symbols.end());
+        try {
+            result.latestCandles = repository.latest(all, static_cast<int32_t>(all.size())).size();
+        } catch (const std::exception& e) {
+            std::cerr << "[Warmup] Latest candles failed: " << e.what() << std::endl;
+        }
+    }
+
+    result.took = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    return result;
+}
+
+} // namespace trading::application
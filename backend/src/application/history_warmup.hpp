@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../domain/interfaces.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace trading::application {
+
+// The page warmed per symbol: the last day of 1m candles, as the home page
+// asks for it
+inline constexpr int64_t kWarmupWindowSeconds = 86400;
+inline constexpr int32_t kWarmupCandles = 1440;
+
+struct HistoryWarmupResult {
+    size_t symbolsWarmed = 0;  // Symbols whose page read succeeded
+    size_t candles = 0;
+    size_t latestCandles = 0;
+    std::chrono::milliseconds took{0};
+};
+
+// Reads every symbol's most recent page, up to `parallelism` symbols at once,
+// then the latest candles of all of them in one call, as history.latest asks
+// for them. The reads open the repository's read connections before the first
+// client needs them. Their results go into the repository's result caches
+// under the keys a client's "past day" and history.latest reads use, so those
+// have something to fall back on if ClickHouse fails before the client's own
+// read succeeds. A failed read is logged and skipped.
+HistoryWarmupResult warmHistory(trading::domain::IHistoryRepository& repository, const std::vector<std::string>& symbols,
+                                int64_t nowSeconds, size_t parallelism);
+
+} // namespace trading::application
@@ -0,0 +1,275 @@
+#include "price_alert_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+namespace trading::application {
+
+using trading::domain::PriceAlert;
+using trading::domain::PriceAlertEvent;
+using trading::domain::PriceAlertKind;
+
+namespace {
+
+constexpr const char* kKindNames[] = {"above", "below", "cross", "move_up", "move_down", "move"};
+
+bool isMoveKind(PriceAlertKind kind) {
+    return kind == PriceAlertKind::MOVE_UP || kind == PriceAlertKind::MOVE_DOWN || kind == PriceAlertKind::MOVE;
+}
+
+} // namespace
+
+std::optional<PriceAlertKind> PriceAlertIndex::parseKind(const std::string& kind) {
+    for (size_t i = 0; i < std::size(kKindNames); ++i) {
+        if (kind == kKindNames[i]) {
+            return static_cast<PriceAlertKind>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+const char* PriceAlertIndex::kindName(PriceAlertKind kind) {
+    return kKindNames[static_cast<size_t>(kind)];
+}
+
+PriceAlertIndex::PriceAlertIndex(size_t maxAlertsPerOwner)
+    : maxAlertsPerOwner_(maxAlertsPerOwner) {
+}
+
+PriceAlertKind PriceAlertIndex::add(const PriceAlert& alert) {
+    if (alert.alertId.empty() || alert.ownerId.empty() || alert.symbol.empty()) {
+        throw std::invalid_argument("alertId, ownerId and symbol are required");
+    }
+    if (isMoveKind(alert.kind)) {
+        if (!std::isfinite(alert.movePercent) || alert.movePercent <= 0.0) {
+            throw std::invalid_argument("Move alerts need a positive movePercent");
+        }
+        if (std::find(kMoveWindowsMs.begin(), kMoveWindowsMs.end(), alert.windowMs) == kMoveWindowsMs.end()) {
+            throw std::invalid_argument("windowMs must be one of 10000, 60000, 300000, 900000, 3600000");
+        }
+    } else if (!std::isfinite(alert.level) || alert.level <= 0.0) {
+        throw std::invalid_argument("Level alerts need a positive level");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slots_.count(alert.alertId) > 0) {
+        throw std::invalid_argument("Duplicate alert id: " + alert.alertId);
+    }
+    auto owner = ownerSlots_.find(alert.ownerId);
+    if (owner != ownerSlots_.end() && owner->second.size() >= maxAlertsPerOwner_) {
+        throw std::length_error("At most " + std::to_string(maxAlertsPerOwner_) + " price alerts per session");
+    }
+
+    auto& bookPtr = books_[alert.symbol];
+    if (!bookPtr) {
+        bookPtr = std::make_unique<SymbolBook>();
+    }
+    auto& book = *bookPtr;
+
+    PriceAlertKind kind = alert.kind;
+    if (kind == PriceAlertKind::CROSS) {
+        if (!book.lastPrice) {
+            throw std::invalid_argument("No price yet for " + alert.symbol + "; use above or below");
+        }
+        kind = alert.level >= *book.lastPrice ? PriceAlertKind::ABOVE : PriceAlertKind::BELOW;
+    }
+
+    uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+
+    auto& entry = entries_[slot];
+    entry.alert = alert;
+    entry.alert.kind = kind;
+    entry.active = true;
+
+    switch (kind) {
+        case PriceAlertKind::ABOVE:
+            entry.firstBook = &book.upper;
+            entry.first = book.upper.emplace(alert.level, slot);
+            break;
+        case PriceAlertKind::BELOW:
+            entry.firstBook = &book.lower;
+            entry.first = book.lower.emplace(alert.level, slot);
+            break;
+        default: {
+            auto& window = windowFor(book, alert.windowMs);
+            if (kind != PriceAlertKind::MOVE_DOWN) {
+                entry.firstBook = &window.up;
+                entry.first = window.up.emplace(alert.movePercent, slot);
+            }
+            if (kind != PriceAlertKind::MOVE_UP) {
+                entry.secondBook = &window.down;
+                entry.second = window.down.emplace(alert.movePercent, slot);
+            }
+            break;
+        }
+    }
+
+    slots_.emplace(alert.alertId, slot);
+    ownerSlots_[alert.ownerId].insert(slot);
+    return kind;
+}
+
+PriceAlertIndex::MoveWindow& PriceAlertIndex::windowFor(SymbolBook& book, int64_t windowMs) {
+    for (auto& window : book.windows) {
+        if (window->windowMs == windowMs) {
+            return *window;
+        }
+    }
+    book.windows.push_back(std::make_unique<MoveWindow>());
+    book.windows.back()->windowMs = windowMs;
+    return *book.windows.back();
+}
+
+void PriceAlertIndex::remove(uint32_t slot) {
+    auto& entry = entries_[slot];
+    if (!entry.active) {
+        return;
+    }
+    if (entry.firstBook) {
+        entry.firstBook->erase(entry.first);
+    }
+    if (entry.secondBook) {
+        entry.secondBook->erase(entry.second);
+    }
+
+    slots_.erase(entry.alert.alertId);
+    auto owner = ownerSlots_.find(entry.alert.ownerId);
+    if (owner != ownerSlots_.end()) {
+        owner->second.erase(slot);
+        if (owner->second.empty()) {
+            ownerSlots_.erase(owner);
+        }
+    }
+
+    entry = Entry{};
+    freeSlots_.push_back(slot);
+}
+
+bool PriceAlertIndex::cancel(const std::string& alertId, const std::string& ownerId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(alertId);
+    if (it == slots_.end() || entries_[it->second].alert.ownerId != ownerId) {
+        return false;
+    }
+    remove(it->second);
+    return true;
+}
+
+size_t PriceAlertIndex::cancelOwner(const std::string& ownerId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ownerSlots_.find(ownerId);
+    if (it == ownerSlots_.end()) {
+        return 0;
+    }
+    std::vector<uint32_t> owned(it->second.begin(), it->second.end());
+    for (uint32_t slot : owned) {
+        remove(slot);
+    }
+    return owned.size();
+}
+
+void PriceAlertIndex::fire(uint32_t slot, PriceAlertKind edge, double price, double movePercent, int64_t ts,
+                           std::vector<PriceAlertEvent>& events) {
+    const auto& alert = entries_[slot].alert;
+    bool isMove = edge == PriceAlertKind::MOVE_UP || edge == PriceAlertKind::MOVE_DOWN;
+    events.push_back(PriceAlertEvent{alert.alertId, alert.ownerId, alert.symbol, edge,
+                                     isMove ? alert.movePercent : alert.level, price, movePercent, ts});
+    remove(slot);
+}
+
+std::vector<PriceAlertEvent> PriceAlertIndex::onTick(const std::string& symbol, int64_t ts, double price) {
+    std::vector<PriceAlertEvent> events;
+    if (!std::isfinite(price) || price <= 0.0) {
+        return events;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& bookPtr = books_[symbol];
+    if (!bookPtr) {
+        bookPtr = std::make_unique<SymbolBook>();
+    }
+    auto& book = *bookPtr;
+    book.lastPrice = price;
+
+    // Nearest upper level is the lowest, nearest lower level the highest
+    while (!book.upper.empty() && book.upper.begin()->first <= price) {
+        fire(book.upper.begin()->second, PriceAlertKind::ABOVE, price, 0.0, ts, events);
+    }
+    while (!book.lower.empty() && std::prev(book.lower.end())->first >= price) {
+        fire(std::prev(book.lower.end())->second, PriceAlertKind::BELOW, price, 0.0, ts, events);
+    }
+
+    for (auto& windowPtr : book.windows) {
+        auto& window = *windowPtr;
+        while (!window.minQueue.empty() && window.minQueue.back().price >= price) {
+            window.minQueue.pop_back();
+        }
+        window.minQueue.push_back({ts, price});
+        while (!window.maxQueue.empty() && window.maxQueue.back().price <= price) {
+            window.maxQueue.pop_back();
+        }
+        window.maxQueue.push_back({ts, price});
+
+        // The current tick is always at the back, so neither queue empties here
+        int64_t cutoff = ts - window.windowMs;
+        while (window.minQueue.front().ts < cutoff) {
+            window.minQueue.pop_front();
+        }
+        while (window.maxQueue.front().ts < cutoff) {
+            window.maxQueue.pop_front();
+        }
+
+        double low = window.minQueue.front().price;
+        double high = window.maxQueue.front().price;
+        double rise = (price - low) / low * 100.0;
+        double drop = (high - price) / high * 100.0;
+
+        while (!window.up.empty() && window.up.begin()->first <= rise) {
+            fire(window.up.begin()->second, PriceAlertKind::MOVE_UP, price, rise, ts, events);
+        }
+        while (!window.down.empty() && window.down.begin()->first <= drop) {
+            fire(window.down.begin()->second, PriceAlertKind::MOVE_DOWN, price, drop, ts, events);
+        }
+    }
+
+    // Windows without alerts stop tracking history
+    book.windows.erase(
+        std::remove_if(book.windows.begin(), book.windows.end(),
+            [](const std::unique_ptr<MoveWindow>& window) { return window->up.empty() && window->down.empty(); }),
+        book.windows.end());
+
+    return events;
+}
+
+std::optional<double> PriceAlertIndex::lastPrice(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = books_.find(symbol);
+    return it != books_.end() ? it->second->lastPrice : std::nullopt;
+}
+
+std::vector<PriceAlert> PriceAlertIndex::alertsFor(const std::string& ownerId) const {
+    std::vector<PriceAlert> alerts;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ownerSlots_.find(ownerId);
+    if (it != ownerSlots_.end()) {
+        for (uint32_t slot : it->second) {
+            alerts.push_back(entries_[slot].alert);
+        }
+    }
+    return alerts;
+}
+
+size_t PriceAlertIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slots_.size();
+}
+
+} // namespace trading::application
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../domain/types.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace trading::application {
+
+// Per-symbol index of one-shot price alerts, evaluated inline on every tick.
+// Level alerts sit in two ordered books per symbol: ascending upper levels fire
+// from the front, lower levels from the back. A tick therefore compares the price
+// against the nearest level on each side and only walks alerts that actually fire.
+// Move alerts are ordered by percent per (symbol, window) and compared against the
+// window's running min/max, kept in monotonic queues.
+class PriceAlertIndex {
+public:
+    // Move windows a client may pick; each distinct window is walked on every tick
+    static constexpr std::array<int64_t, 5> kMoveWindowsMs = {10'000, 60'000, 300'000, 900'000, 3'600'000};
+    static constexpr size_t kDefaultMaxAlertsPerOwner = 100;
+
+private:
+    using Levels = std::multimap<double, uint32_t>;
+
+    struct PricePoint {
+        int64_t ts;
+        double price;
+    };
+
+    // Move window history starts when its first alert is registered
+    struct MoveWindow {
+        int64_t windowMs;
+        std::deque<PricePoint> minQueue;  // Ascending prices: front is the window low
+        std::deque<PricePoint> maxQueue;  // Descending prices: front is the window high
+        Levels up;
+        Levels down;
+    };
+
+    struct SymbolBook {
+        std::optional<double> lastPrice;
+        Levels upper;
+        Levels lower;
+        std::vector<std::unique_ptr<MoveWindow>> windows;
+    };
+
+    struct Entry {
+        trading::domain::PriceAlert alert;
+        bool active = false;
+        // Book positions for O(1) removal; MOVE alerts sit in both directions
+        Levels* firstBook = nullptr;
+        Levels::iterator first;
+        Levels* secondBook = nullptr;
+        Levels::iterator second;
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<SymbolBook>> books_;
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> freeSlots_;
+    std::unordered_map<std::string, uint32_t> slots_;
+    std::unordered_map<std::string, std::unordered_set<uint32_t>> ownerSlots_;
+    size_t maxAlertsPerOwner_;
+    mutable std::mutex mutex_;
+
+    // Require the lock
+    void remove(uint32_t slot);
+    MoveWindow& windowFor(SymbolBook& book, int64_t windowMs);
+    void fire(uint32_t slot, trading::domain::PriceAlertKind edge, double price, double movePercent, int64_t ts,
+              std::vector<trading::domain::PriceAlertEvent>& events);
+
+public:
+    explicit PriceAlertIndex(size_t maxAlertsPerOwner = kDefaultMaxAlertsPerOwner);
+    PriceAlertIndex(const PriceAlertIndex&) = delete;
+    PriceAlertIndex& operator=(const PriceAlertIndex&) = delete;
+
+    // Returns the stored kind, with CROSS resolved against the last price.
+    // Throws std::invalid_argument for duplicate ids, invalid parameters, a move window
+    // outside kMoveWindowsMs or a CROSS alert on a symbol that has not ticked yet, and
+    // std::length_error once the owner holds maxAlertsPerOwner alerts.
+    trading::domain::PriceAlertKind add(const trading::domain::PriceAlert& alert);
+    // Only the owner may cancel an alert
+    bool cancel(const std::string& alertId, const std::string& ownerId);
+    size_t cancelOwner(const std::string& ownerId);
+
+    // Feeds one tick and returns the alerts it fired; fired alerts are removed
+    std::vector<trading::domain::PriceAlertEvent> onTick(const std::string& symbol, int64_t ts, double price);
+
+    std::optional<double> lastPrice(const std::string& symbol) const;
+    std::vector<trading::domain::PriceAlert> alertsFor(const std::string& ownerId) const;
+    size_t size() const;
+
+    static std::optional<trading::domain::PriceAlertKind> parseKind(const std::string& kind);
+    static const char* kindName(trading::domain::PriceAlertKind kind);
+};
+
+} // namespace trading::application
@@ -42,7 +42,10 @@ public:
 class IAlertingService {
 public:
     virtual ~IAlertingService() = default;
+    // Rules currently triggered by the metrics, without state
     virtual std::vector<AlertEvent> evaluate(const Metrics& metrics) = 0;
+    // Stateful pass: only rules that start firing or resolve produce events
+    virtual AlertTransitions evaluateTransitions(const Metrics& metrics) = 0;
     virtual void registerRule(const AlertRule& rule) = 0;
     virtual void disableRule(const std::string& ruleId) = 0;
 };
@@ -59,6 +62,8 @@ public:
     virtual ~IMetricsCollector() = default;
     virtual Metrics collect() = 0;
     virtual void recordLatency(double latencyMs) = 0;
+    virtual void recordRequest(const std::string& method, double serviceMs, double queueMs, double serializeMs) = 0;
+    virtual std::vector<MethodMetrics> collectMethods() = 0;
     virtual void recordError() = 0;
     virtual void recordConnection() = 0;
     virtual void recordDisconnection() = 0;
@@ -74,7 +79,10 @@ struct Principal {
         : subject(std::move(sub)), roles(std::move(r)) {}
     
     bool hasRole(const std::string& role) const {
-        return std::find(roles.begin(), roles.end(), role) != roles.end();
+        for (const auto& r : roles) {
+            if (r == role) return true;
+        }
+        return false;
     }
 };
 
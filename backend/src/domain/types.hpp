@@ -4,6 +4,9 @@
 #include <vector>
 #include <chrono>
 #include <cstdint>
+#include <optional>
+#include <array>
+#include <unordered_map>
 
 namespace trading::domain {
 
@@ -27,6 +30,11 @@ enum class OrderStatus {
     CANCELED
 };
 
+enum class AlertState {
+    FIRING,
+    RESOLVED
+};
+
 enum class Interval {
     S1, S5, S15,
     M1, M5, M15,
@@ -87,6 +95,7 @@ struct HistoryQuery {
     int64_t toTs;
     Interval interval;
     int32_t limit;
+    int64_t bucketSeconds = 0;  // Wider candles to aggregate into; 0 keeps the interval's width
     
     HistoryQuery() = default;
     HistoryQuery(int64_t from, int64_t to, Interval i, int32_t l = 1000)
@@ -165,12 +174,45 @@ struct RiskPolicy {
 };
 
 // Metrics and Alerting
+struct LatencyStats {
+    uint64_t count = 0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double p999Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+struct MethodMetrics {
+    std::string method;
+    double throughput = 0.0; // requests/sec since collector start
+    LatencyStats service;    // handler time excluding serialization
+    LatencyStats queue;      // middleware entry -> handler dispatch
+    LatencyStats serialize;  // protocol serialization of the reply
+    
+    MethodMetrics() = default;
+    explicit MethodMetrics(std::string m) : method(std::move(m)) {}
+};
+
+// Stats every windowed metric series reports, addressed as "<series>.<stat>".
+// Rates are per second; mean and percentiles are in milliseconds.
+inline constexpr std::array<const char*, 8> kWindowedStats = {
+    "rate_1s", "rate_10s", "rate_60s", "rate_ewma",
+    "mean_10s", "p50_10s", "p99_10s", "p99_60s"
+};
+// The leading stats are rates; event series report only these
+inline constexpr size_t kWindowedRateStatCount = 4;
+
 struct Metrics {
     int64_t ts;
     double latencyMs;
     double throughput;
     double errorRate;
     int32_t connCount;
+    LatencyStats latency;
+    // Windowed aggregations keyed "<series>.<stat>", e.g. "orders.place.p99_10s"
+    std::unordered_map<std::string, double> windowed;
     
     Metrics() = default;
     Metrics(int64_t timestamp, double latency, double tput, double error, int32_t conn)
@@ -183,6 +225,8 @@ struct AlertRule {
     std::string operator_;
     double threshold;
     bool enabled;
+    std::optional<double> hysteresis;   // Band past the threshold before a firing alert resolves
+    std::optional<int64_t> cooldownMs;  // Minimum gap between two firing notifications of the rule
     
     AlertRule() = default;
     AlertRule(std::string id, std::string key, std::string op, double thresh, bool en)
@@ -196,12 +240,54 @@ struct AlertEvent {
     int64_t ts;
     double value;
     std::string message;
+    AlertState state = AlertState::FIRING;
     
     AlertEvent() = default;
     AlertEvent(std::string id, std::string rule, int64_t timestamp, double val, std::string msg)
         : eventId(std::move(id)), ruleId(std::move(rule)), ts(timestamp), value(val), message(std::move(msg)) {}
 };
 
+// Outcome of one edge-triggered evaluation pass
+struct AlertTransitions {
+    std::vector<AlertEvent> events;  // Fire/resolve transitions to notify
+    uint64_t suppressed = 0;         // Transitions withheld by cooldown or hysteresis
+};
+
+enum class PriceAlertKind {
+    ABOVE,      // Last price at or above level
+    BELOW,      // Last price at or below level
+    CROSS,      // ABOVE or BELOW, whichever side of the last price the level is on at registration
+    MOVE_UP,    // Rise of movePercent from the lowest price within windowMs
+    MOVE_DOWN,  // Drop of movePercent from the highest price within windowMs
+    MOVE        // MOVE_UP or MOVE_DOWN, whichever happens first
+};
+
+// One-shot alert on a symbol's tick stream, delivered to the owning session
+struct PriceAlert {
+    std::string alertId;
+    std::string ownerId;   // Session the alert is delivered to
+    std::string symbol;
+    PriceAlertKind kind;
+    double level = 0.0;
+    double movePercent = 0.0;
+    int64_t windowMs = 0;
+    
+    PriceAlert() = default;
+    PriceAlert(std::string id, std::string owner, std::string sym, PriceAlertKind k, double lvl)
+        : alertId(std::move(id)), ownerId(std::move(owner)), symbol(std::move(sym)), kind(k), level(lvl) {}
+};
+
+struct PriceAlertEvent {
+    std::string alertId;
+    std::string ownerId;
+    std::string symbol;
+    PriceAlertKind kind;   // ABOVE, BELOW, MOVE_UP or MOVE_DOWN: the edge that fired
+    double trigger;        // Level, or move percent for move alerts
+    double price;
+    double movePercent;    // Observed move within the window; 0 for level alerts
+    int64_t ts;
+};
+
 struct Subscription {
     std::string channel;
     int64_t createdAt;
@@ -8,15 +8,18 @@ std::optional<trading::domain::OrderResult> IdempotencyCache::get(const std::str
     
     auto it = cache_.find(key);
     if (it == cache_.end()) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
         return std::nullopt;
     }
     
     // Check if expired
     if (it->second.isExpired()) {
         cache_.erase(it);
+        misses_.fetch_add(1, std::memory_order_relaxed);
         return std::nullopt;
     }
     
+    hits_.fetch_add(1, std::memory_order_relaxed);
     return it->second.result;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../domain/interfaces.hpp"
+#include <atomic>
 #include <unordered_map>
 #include <mutex>
 #include <chrono>
@@ -25,6 +26,8 @@ private:
     
     std::unordered_map<std::string, CacheEntry> cache_;
     mutable std::mutex mutex_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};  // Includes lookups of expired entries
     
 public:
     IdempotencyCache() = default;
@@ -39,6 +42,8 @@ public:
     // Get cache statistics
     size_t size() const;
     size_t expiredCount() const;
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
 };
 
 } // namespace trading::infrastructure::cache
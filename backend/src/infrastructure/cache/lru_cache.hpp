@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace trading::infrastructure::cache {
+
+// A thread-safe map of the `capacity` most recently stored or read keys;
+// storing into a full cache evicts the least recently used entry
+template <typename Value>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    void put(const std::string& key, Value value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = index_.find(key);
+        if (found != index_.end()) {
+            found->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, found->second);
+            return;
+        }
+        if (entries_.size() == capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_.emplace(key, entries_.begin());
+    }
+
+    std::optional<Value> get(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        entries_.splice(entries_.begin(), entries_, found->second);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return found->second->second;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+    size_t capacity() const { return capacity_; }
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    using Entry = std::pair<std::string, Value>;
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> index_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace trading::infrastructure::cache
@@ -0,0 +1,84 @@
+#include "circuit_breaker.hpp"
+
+namespace trading::infrastructure::database {
+
+CircuitBreaker::CircuitBreaker(CircuitBreakerConfig config) : config_(config) {
+    if (config_.failureThreshold == 0) {
+        config_.failureThreshold = 1;
+    }
+}
+
+bool CircuitBreaker::allow(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::OPEN && now >= openUntil_) {
+        state_ = State::HALF_OPEN;
+        trialInFlight_ = false;
+    }
+    if (state_ == State::CLOSED) {
+        return true;
+    }
+    if (state_ == State::HALF_OPEN && !trialInFlight_) {
+        trialInFlight_ = true;
+        return true;
+    }
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void CircuitBreaker::recordSuccess() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = State::CLOSED;
+    failures_ = 0;
+    trialInFlight_ = false;
+}
+
+void CircuitBreaker::recordFailure(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++failures_;
+    if (state_ == State::HALF_OPEN || (state_ == State::CLOSED && failures_ >= config_.failureThreshold)) {
+        open(now);
+    }
+}
+
+void CircuitBreaker::recordIgnored() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    trialInFlight_ = false;
+}
+
+void CircuitBreaker::trip(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::OPEN) {
+        open(now);
+    }
+}
+
+void CircuitBreaker::probeSucceeded() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::OPEN) {
+        state_ = State::HALF_OPEN;
+        trialInFlight_ = false;
+    }
+}
+
+CircuitBreaker::State CircuitBreaker::state() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+void CircuitBreaker::open(Clock::time_point now) {
+    state_ = State::OPEN;
+    trialInFlight_ = false;
+    openUntil_ = now + config_.openFor;
+    opened_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string_view circuitStateName(CircuitBreaker::State state) {
+    switch (state) {
+        case CircuitBreaker::State::CLOSED: return "closed";
+        case CircuitBreaker::State::OPEN: return "open";
+        case CircuitBreaker::State::HALF_OPEN: return "half_open";
+    }
+    return "closed";
+}
+
+} // namespace trading::infrastructure::database
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace trading::infrastructure::database {
+
+struct CircuitBreakerConfig {
+    uint32_t failureThreshold = 3;                 // Consecutive failures that open the breaker
+    std::chrono::milliseconds openFor{5000};       // Before a trial request is let through
+};
+
+// Fails requests fast while a dependency is unhealthy. CLOSED lets everything
+// through; failureThreshold consecutive failures open it. OPEN rejects until
+// openFor has passed (or a health probe succeeds), then HALF_OPEN lets one
+// trial request through: its success closes the breaker, its failure opens
+// it again.
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+    enum class State { CLOSED, OPEN, HALF_OPEN };
+
+    explicit CircuitBreaker(CircuitBreakerConfig config = {});
+
+    // Whether a request may go out; every true must be followed by
+    // recordSuccess, recordFailure or recordIgnored
+    bool allow(Clock::time_point now = Clock::now());
+    void recordSuccess();
+    void recordFailure(Clock::time_point now = Clock::now());
+    // An outcome that says nothing about the dependency's health, such as a
+    // rejected query: leaves the failure count and state as they were and
+    // lets the next trial through
+    void recordIgnored();
+
+    // From a health prober: a failed probe opens the breaker at once, and a
+    // successful one ends the OPEN wait early
+    void trip(Clock::time_point now = Clock::now());
+    void probeSucceeded();
+
+    State state() const;
+    // Requests refused while OPEN or HALF_OPEN
+    uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+    // Transitions into OPEN
+    uint64_t opened() const { return opened_.load(std::memory_order_relaxed); }
+
+private:
+    void open(Clock::time_point now);
+
+    CircuitBreakerConfig config_;
+    mutable std::mutex mutex_;
+    State state_ = State::CLOSED;
+    uint32_t failures_ = 0;
+    bool trialInFlight_ = false;
+    Clock::time_point openUntil_{};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> opened_{0};
+};
+
+// "closed", "open" or "half_open"
+std::string_view circuitStateName(CircuitBreaker::State state);
+
+} // namespace trading::infrastructure::database
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <utility>
+#include <vector>
+
+namespace trading::infrastructure::database {
+
+// Clients for concurrent reads, at most `capacity` leased at once. acquire()
+// waits for a free slot, then hands out an idle client or makes one with the
+// factory. The pool's mutex only guards the idle list, so no lock is held
+// across a caller's network I/O.
+template <typename Client>
+class ClickHouseClientPool {
+public:
+    using Factory = std::function<std::unique_ptr<Client>()>;
+
+    // A client and its slot, both returned when the lease goes
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept : pool_(std::exchange(other.pool_, nullptr)), client_(std::move(other.client_)) {}
+        Lease& operator=(Lease&&) = delete;
+        ~Lease() {
+            if (pool_) {
+                pool_->release(std::move(client_));
+            }
+        }
+
+        Client& operator*() const { return *client_; }
+        Client* operator->() const { return client_.get(); }
+
+        // Drops the client instead of returning it, after an error that may
+        // have left its connection in an unknown state
+        void discard() { client_.reset(); }
+
+    private:
+        friend class ClickHouseClientPool;
+        Lease(ClickHouseClientPool* pool, std::unique_ptr<Client> client) : pool_(pool), client_(std::move(client)) {}
+
+        ClickHouseClientPool* pool_;
+        std::unique_ptr<Client> client_;
+    };
+
+    ClickHouseClientPool(size_t capacity, Factory factory)
+        : capacity_(capacity > 0 ? capacity : 1),
+          slots_(static_cast<std::ptrdiff_t>(capacity_)),
+          factory_(std::move(factory)) {}
+
+    ClickHouseClientPool(const ClickHouseClientPool&) = delete;
+    ClickHouseClientPool& operator=(const ClickHouseClientPool&) = delete;
+
+    // Blocks while `capacity` leases are out. Exceptions from the factory
+    // propagate with the slot given back.
+    Lease acquire() {
+        if (!slots_.try_acquire()) {
+            waits_.fetch_add(1, std::memory_order_relaxed);
+            slots_.acquire();
+        }
+        in_use_.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_ptr<Client> client;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                client = std::move(idle_.back());
+                idle_.pop_back();
+            }
+        }
+        if (!client) {
+            try {
+                client = factory_();
+            } catch (...) {
+                release(nullptr);
+                throw;
+            }
+        }
+        return Lease(this, std::move(client));
+    }
+
+    // Drops the idle clients; leased ones return to the pool as usual
+    void clear() {
+        std::vector<std::unique_ptr<Client>> dropped;
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropped.swap(idle_);
+    }
+
+    size_t capacity() const { return capacity_; }
+    // Leases currently out
+    size_t inUse() const { return in_use_.load(std::memory_order_relaxed); }
+    // Clients kept for the next lease
+    size_t idle() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return idle_.size();
+    }
+    // acquire() calls that found every slot taken
+    uint64_t waits() const { return waits_.load(std::memory_order_relaxed); }
+
+private:
+    void release(std::unique_ptr<Client> client) {
+        if (client) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.push_back(std::move(client));
+        }
+        in_use_.fetch_sub(1, std::memory_order_relaxed);
+        slots_.release();
+    }
+
+    size_t capacity_;
+    std::counting_semaphore<> slots_;
+    Factory factory_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Client>> idle_;
+    std::atomic<size_t> in_use_{0};
+    std::atomic<uint64_t> waits_{0};
+};
+
+} // namespace trading::infrastructure::database
@@ -0,0 +1,450 @@
+#ifdef CLICKHOUSE_AVAILABLE
+
+#include "clickhouse_native_repository.hpp"
+#include <clickhouse/client.h>
+#include <iostream>
+#include <stdexcept>
+
+namespace trading::infrastructure::database {
+
+namespace {
+
+constexpr int kDefaultNativePort = 9000;
+
+// Column `name` of a result block; throws when the query did not select it
+clickhouse::ColumnRef column(const clickhouse::Block& block, std::string_view name) {
+    for (size_t i = 0; i < block.GetColumnCount(); ++i) {
+        if (block.GetColumnName(i) == name) {
+            return block[i];
+        }
+    }
+    throw std::runtime_error("ClickHouse result has no column " + std::string(name));
+}
+
+// Server error codes the HTTP interface answers with a 4xx: the query or one
+// of its parameters was rejected, the server itself is fine
+bool isQueryError(int code) {
+    switch (code) {
+        case 6:   // CANNOT_PARSE_TEXT
+        case 27:  // CANNOT_PARSE_INPUT_ASSERTION_FAILED
+        case 36:  // BAD_ARGUMENTS
+        case 41:  // CANNOT_PARSE_DATETIME
+        case 43:  // ILLEGAL_TYPE_OF_ARGUMENT
+        case 53:  // TYPE_MISMATCH
+        case 60:  // UNKNOWN_TABLE
+        case 62:  // SYNTAX_ERROR
+        case 69:  // ARGUMENT_OUT_OF_BOUND
+        case 70:  // CANNOT_CONVERT_TYPE
+        case 72:  // CANNOT_PARSE_NUMBER
+        case 81:  // UNKNOWN_DATABASE
+        case 456: // UNKNOWN_QUERY_PARAMETER
+        case 457: // BAD_QUERY_PARAMETER
+            return true;
+        default:
+            return false;
+    }
+}
+
+// String, LowCardinality(String) and Enum8 columns all read as their text
+std::string textAt(const clickhouse::ColumnRef& values, size_t row) {
+    if (auto text = values->As<clickhouse::ColumnString>()) {
+        return std::string(text->At(row));
+    }
+    if (auto text = values->As<clickhouse::ColumnLowCardinalityT<clickhouse::ColumnString>>()) {
+        return std::string(text->At(row));
+    }
+    if (auto labels = values->As<clickhouse::ColumnEnum8>()) {
+        return std::string(labels->NameAt(row));
+    }
+    throw std::runtime_error("ClickHouse column does not hold text");
+}
+
+// DateTime64 ticks at the column's precision, or DateTime seconds, as milliseconds
+int64_t millisAt(const clickhouse::ColumnRef& values, size_t row) {
+    if (auto times = values->As<clickhouse::ColumnDateTime64>()) {
+        int64_t ticks = times->At(row);
+        size_t precision = times->GetPrecision();
+        for (; precision > 3; --precision) {
+            ticks /= 10;
+        }
+        for (; precision < 3; ++precision) {
+            ticks *= 10;
+        }
+        return ticks;
+    }
+    return static_cast<int64_t>(values->AsStrict<clickhouse::ColumnDateTime>()->At(row)) * 1000;
+}
+
+clickhouse::TypeRef enumType(const char* const* labels, size_t count, int16_t first = 0) {
+    std::vector<clickhouse::Type::EnumItem> items;
+    for (size_t i = 0; i < count; ++i) {
+        items.push_back({labels[i], static_cast<int16_t>(first + i)});
+    }
+    return clickhouse::Type::CreateEnum8(items);
+}
+
+template <size_t N>
+clickhouse::TypeRef enumType(const char* const (&labels)[N]) {
+    return enumType(labels, N);
+}
+
+clickhouse::CompressionMethod nativeCompression(HttpCompression compression) {
+    switch (compression) {
+        case HttpCompression::LZ4: return clickhouse::CompressionMethod::LZ4;
+        case HttpCompression::ZSTD: return clickhouse::CompressionMethod::ZSTD;
+        default: return clickhouse::CompressionMethod::None;
+    }
+}
+
+} // namespace
+
+ClickHouseNativeRepository::ClickHouseNativeRepository(const std::string& host, int httpPort, int nativePort,
+                                                       const std::string& database, HttpCompression compression,
+                                                       size_t maxReaders, ClickHouseHealthConfig health)
+    : ClickHouseHistoryRepository(host, httpPort, database, compression, maxReaders, health),
+      native_port_(nativePort > 0 ? nativePort : kDefaultNativePort),
+      native_statements_(database_, ""),
+      read_clients_(max_readers_, [this] { return createClient(health_.queryTimeout); }) {
+
+    std::cout << "[ClickHouse] Using native protocol on port " << native_port_ << " for reads and inserts" << std::endl;
+    if (connected_) {
+        try {
+            // Opens the first read client, which stays idle in the pool
+            read_clients_.acquire();
+            std::cout << "[ClickHouse] Native connection established" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[ClickHouse] Native connection failed, will retry later: " << e.what() << std::endl;
+            connected_ = false;
+        }
+    }
+}
+
+ClickHouseNativeRepository::~ClickHouseNativeRepository() {
+    // The writer thread calls insertOrderEvents, which uses writer_client_
+    stopWriterThread();
+}
+
+std::unique_ptr<clickhouse::Client> ClickHouseNativeRepository::createClient(std::chrono::milliseconds timeout) const {
+    auto options = clickhouse::ClientOptions()
+        .SetHost(host_)
+        .SetPort(static_cast<uint16_t>(native_port_))
+        .SetDefaultDatabase(database_)
+        .SetUser(user_)
+        .SetPassword(password_)
+        .SetCompressionMethod(nativeCompression(compression_));
+    if (timeout.count() > 0) {
+        options.SetConnectionConnectTimeout(timeout)
+            .SetConnectionRecvTimeout(timeout)
+            .SetConnectionSendTimeout(timeout);
+    }
+    return std::make_unique<clickhouse::Client>(options);
+}
+
+bool ClickHouseNativeRepository::connect() {
+    if (!ClickHouseHistoryRepository::connect()) {
+        return false;
+    }
+    try {
+        read_clients_.clear();
+        read_clients_.acquire();
+        std::cout << "[ClickHouse] Native connection to " << host_ << ":" << native_port_ << " successful" << std::endl;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "[ClickHouse] Native connection failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void ClickHouseNativeRepository::disconnect() {
+    ClickHouseHistoryRepository::disconnect();
+    read_clients_.clear();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    write_client_.reset();
+}
+
+void ClickHouseNativeRepository::select(const std::string& sql, const std::vector<std::pair<std::string, std::string>>& values,
+                                        const std::function<void(const clickhouse::Block&)>& onBlock) {
+    auto client = read_clients_.acquire();
+    clickhouse::Query query(sql);
+    for (const auto& [name, value] : values) {
+        query.SetParam(name, value);
+    }
+    query.OnData(onBlock);
+    try {
+        client->Select(query);
+    } catch (const clickhouse::ServerException& e) {
+        // The server answered, so the connection stays usable
+        if (isQueryError(e.GetCode())) {
+            throw ClickHouseQueryError(e.what());
+        }
+        client.discard();
+        throw;
+    } catch (...) {
+        // The connection may be mid-stream; a later lease opens a new one
+        client.discard();
+        throw;
+    }
+}
+
+void ClickHouseNativeRepository::parseCandlesFromBlock(const clickhouse::Block& block, trading::domain::Interval interval,
+                                                       std::vector<trading::domain::Candle>& candles) {
+    size_t rows = block.GetRowCount();
+    if (rows == 0) {
+        return;
+    }
+    auto openTime = column(block, "open_time")->AsStrict<clickhouse::ColumnDateTime>();
+    auto open = column(block, "open")->AsStrict<clickhouse::ColumnFloat64>();
+    auto high = column(block, "high")->AsStrict<clickhouse::ColumnFloat64>();
+    auto low = column(block, "low")->AsStrict<clickhouse::ColumnFloat64>();
+    auto close = column(block, "close")->AsStrict<clickhouse::ColumnFloat64>();
+    auto volume = column(block, "volume")->AsStrict<clickhouse::ColumnUInt64>();
+
+    candles.reserve(candles.size() + rows);
+    for (size_t i = 0; i < rows; ++i) {
+        candles.emplace_back(static_cast<int64_t>(openTime->At(i)), open->At(i), high->At(i), low->At(i), close->At(i),
+                             volume->At(i), interval);
+    }
+}
+
+std::vector<trading::domain::Candle> ClickHouseNativeRepository::readCandles(
+    const trading::domain::Symbol& symbol,
+    const trading::domain::HistoryQuery& query) {
+
+    std::vector<trading::domain::Candle> candles;
+    native_statements_.candles(symbol, query, [&](const auto& selected, const auto&... values) {
+        std::cout << "[ClickHouse] Executing native query for " << symbol.code << " [" << query.fromTs << ", " << query.toTs
+                  << "]: " << selected.sql() << std::endl;
+        select(selected.sql(), selected.values(values...), [&](const clickhouse::Block& block) {
+            parseCandlesFromBlock(block, query.interval, candles);
+        });
+    });
+    std::cout << "[ClickHouse] Read " << candles.size() << " candles from native blocks" << std::endl;
+    return candles;
+}
+
+std::vector<trading::domain::Candle> ClickHouseNativeRepository::readLatest(const std::vector<std::string>& codes, uint32_t limit) {
+    std::vector<trading::domain::Candle> candles;
+    const auto& latestQuery = native_statements_.latest;
+    select(latestQuery.sql(), latestQuery.values(codes, limit), [&](const clickhouse::Block& block) {
+        parseCandlesFromBlock(block, trading::domain::Interval::M1, candles);
+    });
+    std::cout << "[ClickHouse] Read " << candles.size() << " latest candles from native blocks" << std::endl;
+    return candles;
+}
+
+std::vector<nlohmann::json> ClickHouseNativeRepository::readOrderHistory(std::chrono::sys_seconds from, std::chrono::sys_seconds to,
+                                                                         uint32_t limit) {
+    std::vector<nlohmann::json> orderHistory;
+    const auto& historyQuery = native_statements_.orderHistory;
+    select(historyQuery.sql(), historyQuery.values(from, to, limit),
+           [&](const clickhouse::Block& block) {
+               size_t rows = block.GetRowCount();
+               if (rows == 0) {
+                   return;
+               }
+               auto idempKey = column(block, "idemp_key");
+               auto updatedAt = column(block, "updated_at");
+               auto placedAt = column(block, "placed_at");
+               auto status = column(block, "status");
+               auto orderId = column(block, "order_id");
+               auto symbol = column(block, "symbol");
+               auto side = column(block, "side");
+               auto type = column(block, "type");
+               auto price = column(block, "price")->AsStrict<clickhouse::ColumnFloat64>();
+               auto quantity = column(block, "quantity")->AsStrict<clickhouse::ColumnFloat64>();
+               auto accountId = column(block, "account_id");
+               auto sessionId = column(block, "session_id");
+               for (size_t i = 0; i < rows; ++i) {
+                   nlohmann::json orderRecord;
+                   orderRecord["idemp_key"] = textAt(idempKey, i);
+                   orderRecord["timestamp"] = formatMillis(millisAt(updatedAt, i));
+                   orderRecord["placed_at"] = formatMillis(millisAt(placedAt, i));
+                   orderRecord["status"] = textAt(status, i);
+                   orderRecord["order_id"] = textAt(orderId, i);
+                   orderRecord["symbol"] = textAt(symbol, i);
+                   orderRecord["side"] = textAt(side, i);
+                   orderRecord["type"] = textAt(type, i);
+                   orderRecord["price"] = price->At(i);
+                   orderRecord["quantity"] = quantity->At(i);
+                   orderRecord["account_id"] = textAt(accountId, i);
+                   orderRecord["session_id"] = textAt(sessionId, i);
+                   orderHistory.push_back(std::move(orderRecord));
+               }
+           });
+    std::cout << "[OrderHistory] Read " << orderHistory.size() << " order records from native blocks" << std::endl;
+    return orderHistory;
+}
+
+std::optional<OrderEvent> ClickHouseNativeRepository::readOrderDetails(const std::string& orderId) {
+    std::optional<OrderEvent> found;
+    const auto& detailsQuery = native_statements_.orderDetails;
+    select(detailsQuery.sql(), detailsQuery.values(orderId), [&](const clickhouse::Block& block) {
+        if (found || block.GetRowCount() == 0) {
+            return;
+        }
+        OrderEvent event;
+        event.orderId = textAt(column(block, "order_id"), 0);
+        event.tsMs = millisAt(column(block, "ts"), 0);
+        event.placedAtMs = millisAt(column(block, "placed_at"), 0);
+        event.eventType = textAt(column(block, "event_type"), 0);
+        event.status = textAt(column(block, "status"), 0);
+        event.idempKey = textAt(column(block, "idemp_key"), 0);
+        event.symbol = textAt(column(block, "symbol"), 0);
+        event.side = textAt(column(block, "side"), 0);
+        event.type = textAt(column(block, "type"), 0);
+        event.quantity = column(block, "quantity")->AsStrict<clickhouse::ColumnFloat64>()->At(0);
+        event.price = column(block, "price")->AsStrict<clickhouse::ColumnFloat64>()->At(0);
+        event.accountId = textAt(column(block, "account_id"), 0);
+        event.sessionId = textAt(column(block, "session_id"), 0);
+        found = std::move(event);
+    });
+    if (found) {
+        std::cout << "[OrderDetails] Found order details for: " << orderId << std::endl;
+    }
+    return found;
+}
+
+bool ClickHouseNativeRepository::insertTicks(const std::vector<TickRow>& rows) {
+    if (rows.empty()) {
+        return true;
+    }
+    auto symbol = std::make_shared<clickhouse::ColumnString>();
+    auto ts = std::make_shared<clickhouse::ColumnDateTime64>(6);
+    auto bid = std::make_shared<clickhouse::ColumnFloat64>();
+    auto ask = std::make_shared<clickhouse::ColumnFloat64>();
+    auto last = std::make_shared<clickhouse::ColumnFloat64>();
+    auto volume = std::make_shared<clickhouse::ColumnUInt64>();
+    for (const auto& row : rows) {
+        symbol->Append(row.symbol);
+        ts->Append(row.tick.ts * 1000);
+        bid->Append(row.tick.bid);
+        ask->Append(row.tick.ask);
+        last->Append(row.tick.last);
+        volume->Append(row.tick.volume);
+    }
+
+    clickhouse::Block block;
+    block.AppendColumn("symbol", symbol);
+    block.AppendColumn("ts", ts);
+    block.AppendColumn("bid", bid);
+    block.AppendColumn("ask", ask);
+    block.AppendColumn("last", last);
+    block.AppendColumn("volume", volume);
+    try {
+        if (!write_client_) {
+            write_client_ = createClient(health_.writeTimeout);
+        }
+        write_client_->Insert(database_ + ".ticks", block);
+        return true;
+    } catch (const std::exception& e) {
+        write_client_.reset();
+        logError("Native tick insert", e);
+        return false;
+    }
+}
+
+bool ClickHouseNativeRepository::insertCandles(const std::vector<CandleRow>& rows) {
+    if (rows.empty()) {
+        return true;
+    }
+    auto symbol = std::make_shared<clickhouse::ColumnString>();
+    auto openTime = std::make_shared<clickhouse::ColumnDateTime>();
+    auto open = std::make_shared<clickhouse::ColumnFloat64>();
+    auto high = std::make_shared<clickhouse::ColumnFloat64>();
+    auto low = std::make_shared<clickhouse::ColumnFloat64>();
+    auto close = std::make_shared<clickhouse::ColumnFloat64>();
+    auto volume = std::make_shared<clickhouse::ColumnUInt64>();
+    for (const auto& row : rows) {
+        symbol->Append(row.symbol);
+        openTime->Append(static_cast<std::time_t>(row.candle.openTime));
+        open->Append(row.candle.open);
+        high->Append(row.candle.high);
+        low->Append(row.candle.low);
+        close->Append(row.candle.close);
+        volume->Append(row.candle.volume);
+    }
+
+    clickhouse::Block block;
+    block.AppendColumn("symbol", symbol);
+    block.AppendColumn("open_time", openTime);
+    block.AppendColumn("open", open);
+    block.AppendColumn("high", high);
+    block.AppendColumn("low", low);
+    block.AppendColumn("close", close);
+    block.AppendColumn("volume", volume);
+    try {
+        if (!write_client_) {
+            write_client_ = createClient(health_.writeTimeout);
+        }
+        write_client_->Insert(database_ + ".candles_1m", block);
+        return true;
+    } catch (const std::exception& e) {
+        write_client_.reset();
+        logError("Native candle insert", e);
+        return false;
+    }
+}
+
+bool ClickHouseNativeRepository::insertOrderEvents(const std::vector<OrderEvent>& batch) {
+    // Column types match order_events; logOrder already mapped the enum
+    // fields to their labels
+    static const char* const kEventTypes[] = {"PLACE", "CANCEL"};
+    auto orderId = std::make_shared<clickhouse::ColumnString>();
+    auto ts = std::make_shared<clickhouse::ColumnDateTime64>(3);
+    auto placedAt = std::make_shared<clickhouse::ColumnDateTime64>(3);
+    auto eventType = std::make_shared<clickhouse::ColumnEnum8>(enumType(kEventTypes, 2, 1));
+    auto status = std::make_shared<clickhouse::ColumnEnum8>(enumType(kOrderStatuses));
+    auto idempKey = std::make_shared<clickhouse::ColumnString>();
+    auto symbol = std::make_shared<clickhouse::ColumnLowCardinalityT<clickhouse::ColumnString>>();
+    auto side = std::make_shared<clickhouse::ColumnEnum8>(enumType(kOrderSides));
+    auto type = std::make_shared<clickhouse::ColumnEnum8>(enumType(kOrderTypes));
+    auto quantity = std::make_shared<clickhouse::ColumnFloat64>();
+    auto price = std::make_shared<clickhouse::ColumnFloat64>();
+    auto accountId = std::make_shared<clickhouse::ColumnString>();
+    auto sessionId = std::make_shared<clickhouse::ColumnString>();
+    for (const auto& event : batch) {
+        orderId->Append(event.orderId);
+        ts->Append(event.tsMs);
+        placedAt->Append(event.placedAtMs);
+        eventType->Append(event.eventType);
+        status->Append(event.status);
+        idempKey->Append(event.idempKey);
+        symbol->Append(event.symbol);
+        side->Append(event.side);
+        type->Append(event.type);
+        quantity->Append(event.quantity);
+        price->Append(event.price);
+        accountId->Append(event.accountId);
+        sessionId->Append(event.sessionId);
+    }
+
+    clickhouse::Block block;
+    block.AppendColumn("order_id", orderId);
+    block.AppendColumn("ts", ts);
+    block.AppendColumn("placed_at", placedAt);
+    block.AppendColumn("event_type", eventType);
+    block.AppendColumn("status", status);
+    block.AppendColumn("idemp_key", idempKey);
+    block.AppendColumn("symbol", symbol);
+    block.AppendColumn("side", side);
+    block.AppendColumn("type", type);
+    block.AppendColumn("quantity", quantity);
+    block.AppendColumn("price", price);
+    block.AppendColumn("account_id", accountId);
+    block.AppendColumn("session_id", sessionId);
+    try {
+        if (!writer_client_) {
+            writer_client_ = createClient(health_.writeTimeout);
+        }
+        writer_client_->Insert(database_ + ".order_events", block);
+        return true;
+    } catch (const std::exception& e) {
+        writer_client_.reset();
+        std::cerr << "[DBWriter] ❌ Native insert of " << batch.size() << " order events failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+} // namespace trading::infrastructure::database
+
+#endif // CLICKHOUSE_AVAILABLE
@@ -0,0 +1,84 @@
+#pragma once
+
+#ifdef CLICKHOUSE_AVAILABLE
+
+#include "clickhouse_repository.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace clickhouse {
+class Block;
+class Client;
+}
+
+namespace trading::infrastructure::database {
+
+// ClickHouseHistoryRepository over the native TCP protocol (clickhouse-cpp).
+// Reads decode columnar blocks straight into candles and orders, with no JSON
+// in between, and order events, ticks and candles go out as block inserts.
+// Schema migrations and the connection check stay on the HTTP port: they read
+// text results such as EXISTS TABLE. Blocks travel compressed with the codec
+// of `compression`.
+class ClickHouseNativeRepository : public ClickHouseHistoryRepository {
+public:
+    ClickHouseNativeRepository(const std::string& host = "",
+                               int httpPort = 0,
+                               int nativePort = 0,
+                               const std::string& database = "",
+                               HttpCompression compression = HttpCompression::NONE,
+                               size_t maxReaders = kDefaultMaxReaders,
+                               ClickHouseHealthConfig health = {});
+    ~ClickHouseNativeRepository() override;
+
+    // The HTTP check, then a native client for the reads
+    bool connect() override;
+    void disconnect() override;
+
+    ClickHouseProtocol protocol() const override { return ClickHouseProtocol::NATIVE; }
+    int nativePort() const { return native_port_; }
+    size_t readsInFlight() const override { return read_clients_.inUse(); }
+    uint64_t readWaits() const override { return read_clients_.waits(); }
+
+    // Candle rows of a block with open_time, open, high, low, close and
+    // volume columns, in any order among other columns
+    static void parseCandlesFromBlock(const clickhouse::Block& block, trading::domain::Interval interval,
+                                      std::vector<trading::domain::Candle>& candles);
+
+protected:
+    std::vector<trading::domain::Candle> readCandles(const trading::domain::Symbol& symbol,
+                                                     const trading::domain::HistoryQuery& query) override;
+    std::vector<trading::domain::Candle> readLatest(const std::vector<std::string>& codes, uint32_t limit) override;
+    std::vector<nlohmann::json> readOrderHistory(std::chrono::sys_seconds from, std::chrono::sys_seconds to,
+                                                 uint32_t limit) override;
+    std::optional<OrderEvent> readOrderDetails(const std::string& orderId) override;
+
+    bool insertTicks(const std::vector<TickRow>& rows) override;
+    bool insertCandles(const std::vector<CandleRow>& rows) override;
+    bool insertOrderEvents(const std::vector<OrderEvent>& batch) override;
+
+private:
+    // A client whose connect, send and receive give up after `timeout`; 0
+    // keeps the clickhouse-cpp defaults
+    std::unique_ptr<clickhouse::Client> createClient(std::chrono::milliseconds timeout) const;
+    // Runs `sql` with its parameter values on a leased read client, handing
+    // each result block to onBlock
+    void select(const std::string& sql, const std::vector<std::pair<std::string, std::string>>& values,
+                const std::function<void(const clickhouse::Block&)>& onBlock);
+
+    int native_port_;
+    ClickHouseStatements native_statements_;      // No FORMAT clause
+    // Clients are not thread-safe: one per concurrent reader, one for mock
+    // data under write_mutex_, and the writer thread's own, each created on
+    // first use
+    ClickHouseClientPool<clickhouse::Client> read_clients_;
+    std::unique_ptr<clickhouse::Client> write_client_;
+    std::unique_ptr<clickhouse::Client> writer_client_;
+};
+
+} // namespace trading::infrastructure::database
+
+#endif // CLICKHOUSE_AVAILABLE
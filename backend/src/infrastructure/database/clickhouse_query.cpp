@@ -0,0 +1,61 @@
+#include "clickhouse_query.hpp"
+#include <charconv>
+
+namespace trading::infrastructure::database {
+
+namespace {
+
+template <typename Integer>
+void appendInteger(std::string& out, Integer value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Escaped text format: backslash escapes for the characters that end a field
+void appendEscaped(std::string& out, std::string_view value, char quote) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\0': out += "\\0"; break;
+            default:
+                if (c == quote) {
+                    out += '\\';
+                }
+                out += c;
+        }
+    }
+}
+
+} // namespace
+
+void ClickHouseParam<std::string>::append(std::string& out, const std::string& value) {
+    appendEscaped(out, value, '\0');
+}
+
+void ClickHouseParam<int64_t>::append(std::string& out, int64_t value) {
+    appendInteger(out, value);
+}
+
+void ClickHouseParam<uint32_t>::append(std::string& out, uint32_t value) {
+    appendInteger(out, value);
+}
+
+void ClickHouseParam<std::chrono::sys_seconds>::append(std::string& out, std::chrono::sys_seconds value) {
+    appendInteger(out, static_cast<int64_t>(value.time_since_epoch().count()));
+}
+
+void ClickHouseParam<std::vector<std::string>>::append(std::string& out, const std::vector<std::string>& values) {
+    out += '[';
+    for (size_t i = 0; i < values.size(); ++i) {
+        out += i ? ",'" : "'";
+        appendEscaped(out, values[i], '\'');
+        out += '\'';
+    }
+    out += ']';
+}
+
+} // namespace trading::infrastructure::database
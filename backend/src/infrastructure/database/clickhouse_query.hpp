@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cpr/cpr.h>
+
+namespace trading::infrastructure::database {
+
+// How a C++ value is bound to a ClickHouse query parameter: the type its
+// {name:Type} placeholder must declare, and its value in the escaped text
+// format ClickHouse parses parameters from
+template <typename T>
+struct ClickHouseParam;
+
+template <>
+struct ClickHouseParam<std::string> {
+    static constexpr std::string_view type = "String";
+    static void append(std::string& out, const std::string& value);
+};
+
+template <>
+struct ClickHouseParam<int64_t> {
+    static constexpr std::string_view type = "Int64";
+    static void append(std::string& out, int64_t value);
+};
+
+template <>
+struct ClickHouseParam<uint32_t> {
+    static constexpr std::string_view type = "UInt32";
+    static void append(std::string& out, uint32_t value);
+};
+
+// Sent as epoch seconds, which ClickHouse accepts for DateTime
+template <>
+struct ClickHouseParam<std::chrono::sys_seconds> {
+    static constexpr std::string_view type = "DateTime";
+    static void append(std::string& out, std::chrono::sys_seconds value);
+};
+
+template <>
+struct ClickHouseParam<std::vector<std::string>> {
+    static constexpr std::string_view type = "Array(String)";
+    static void append(std::string& out, const std::vector<std::string>& values);
+};
+
+// A query whose SQL is built once, with a {name:Type} placeholder for each
+// value. bind() sends the values as param_<name> URL parameters of the HTTP
+// interface, so they are never spliced into SQL and need no quoting, and a
+// call only formats the values themselves. The placeholder types follow from
+// Params, so binding a value of the wrong type does not compile.
+template <typename... Params>
+class ClickHouseQuery {
+public:
+    // Throws std::invalid_argument when the SQL lacks {name:Type} for a name
+    // and the ClickHouse type of its parameter
+    ClickHouseQuery(std::string sql, const std::array<std::string_view, sizeof...(Params)>& names)
+        : sql_(std::move(sql)) {
+        size_t i = 0;
+        ((keys_[i] = placeholderKey(names[i], ClickHouseParam<Params>::type), names_[i] = names[i], ++i), ...);
+    }
+
+    const std::string& sql() const { return sql_; }
+
+    cpr::Parameters bind(const Params&... values) const {
+        cpr::Parameters parameters;
+        size_t i = 0;
+        std::string text;
+        ((text.clear(), ClickHouseParam<Params>::append(text, values), parameters.Add({keys_[i++], text})), ...);
+        return parameters;
+    }
+
+    // The same values as (name, text) pairs, for a client that sends
+    // parameters itself, such as the native protocol
+    std::vector<std::pair<std::string, std::string>> values(const Params&... args) const {
+        std::vector<std::pair<std::string, std::string>> bound;
+        bound.reserve(sizeof...(Params));
+        size_t i = 0;
+        ((bound.emplace_back(names_[i++], std::string()), ClickHouseParam<Params>::append(bound.back().second, args)), ...);
+        return bound;
+    }
+
+private:
+    std::string placeholderKey(std::string_view name, std::string_view type) const {
+        std::string placeholder = "{" + std::string(name) + ":" + std::string(type) + "}";
+        if (sql_.find(placeholder) == std::string::npos) {
+            throw std::invalid_argument("ClickHouse query has no placeholder " + placeholder + ": " + sql_);
+        }
+        return "param_" + std::string(name);
+    }
+
+    std::string sql_;
+    std::array<std::string, sizeof...(Params)> keys_;   // param_<name>
+    std::array<std::string, sizeof...(Params)> names_;
+};
+
+} // namespace trading::infrastructure::database
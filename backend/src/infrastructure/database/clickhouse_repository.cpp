@@ -1,4 +1,6 @@
 #include "clickhouse_repository.hpp"
+#include "clickhouse_native_repository.hpp"
+#include "../metrics/trace_recorder.hpp"
 #include <iostream>
 #include <sstream>
 #include <chrono>
@@ -13,24 +15,112 @@
 #include <thread>
 #include <algorithm>
 #include <mutex>
+#include <limits>
 #include <optional>
 #include <cpr/cpr.h>
 
-// Using HTTP API for ClickHouse - no native client needed
-
 namespace trading::infrastructure::database {
 
-ClickHouseHistoryRepository::ClickHouseHistoryRepository(const std::string& host, int port, const std::string& database)
-    : host_("localhost"), // HARDCODED
-      port_(8123), // HARDCODED: HTTP port for ClickHouse
-      database_("trading_db"), // HARDCODED
+namespace {
+
+constexpr const char* kOrderStatusEnum = "Enum8('UNKNOWN' = 0, 'ACK' = 1, 'FILLED' = 2, 'REJECTED' = 3, 'CANCELLED' = 4)";
+constexpr const char* kOrderSideEnum = "Enum8('UNKNOWN' = 0, 'BUY' = 1, 'SELL' = 2)";
+constexpr const char* kOrderTypeEnum = "Enum8('UNKNOWN' = 0, 'MARKET' = 1, 'LIMIT' = 2)";
+
+// Events the writer thread sends in one INSERT
+constexpr size_t kOrderEventBatch = 1000;
+// Inserts of one batch before the writer drops it, and the wait between them
+constexpr uint32_t kOrderEventAttempts = 3;
+constexpr auto kOrderEventRetryDelay = std::chrono::seconds(1);
+
+template <size_t N>
+std::string enumLabel(std::string value, const char* const (&labels)[N]) {
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    for (const char* label : labels) {
+        if (value == label) {
+            return value;
+        }
+    }
+    return labels[0];
+}
+
+// SQL for an enum column of the legacy orders_log: the upper-cased value if it
+// is a label, else UNKNOWN
+template <size_t N>
+std::string enumFromSql(const std::string& expr, const char* const (&labels)[N]) {
+    std::string list;
+    for (size_t i = 1; i < N; ++i) {
+        list += std::string(i > 1 ? ", '" : "'") + labels[i] + "'";
+    }
+    return "if(upper(" + expr + ") IN (" + list + "), upper(" + expr + "), 'UNKNOWN')";
+}
+
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// DateTime64 text, or its ISO 8601 form with a 'T' separator
+int64_t parseMillis(const std::string& text) {
+    std::tm tm = {};
+    std::istringstream stream(text);
+    stream >> std::get_time(&tm, text.find('T') != std::string::npos ? "%Y-%m-%dT%H:%M:%S" : "%Y-%m-%d %H:%M:%S");
+    if (stream.fail()) {
+        return 0;
+    }
+    int64_t ms = static_cast<int64_t>(timegm(&tm)) * 1000;
+    size_t dot = text.find('.');
+    if (dot != std::string::npos) {
+        std::string fraction = (text.substr(dot + 1) + "000").substr(0, 3);
+        ms += std::atoi(fraction.c_str());
+    }
+    return ms;
+}
+
+// Request bodies below this go out uncompressed
+constexpr size_t kMinCompressedBody = 1024;
+
+} // namespace
+
+std::string ClickHouseHistoryRepository::formatMillis(int64_t ms) {
+    std::time_t seconds = static_cast<std::time_t>(ms / 1000);
+    struct tm tm {};
+    gmtime_r(&seconds, &tm);
+    char buffer[40];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", static_cast<int>(ms % 1000));
+    return buffer;
+}
+
+ClickHouseHistoryRepository::ClickHouseHistoryRepository(const std::string& host, int port, const std::string& database,
+                                                         HttpCompression compression, size_t maxReaders,
+                                                         ClickHouseHealthConfig health)
+    : host_(host.empty() ? "localhost" : host),
+      port_(port > 0 ? port : 8123), // HTTP port for ClickHouse
+      database_(database.empty() ? "trading_db" : database),
       user_("default"), // HARDCODED
       password_(""), // HARDCODED
-      connected_(false) {
+      connected_(false),
+      compression_(compression),
+      max_readers_(maxReaders > 0 ? maxReaders : kDefaultMaxReaders),
+      health_(health),
+      order_queue_(kRecentOrders, true),
+      endpoint_("http://" + host_ + ":" + std::to_string(port_)),
+      statements_(database_, " FORMAT JSON"),
+      read_sessions_(max_readers_, [this] { return createSession(); }),
+      breaker_(health_.breaker),
+      candle_cache_(kReadCacheEntries),
+      order_history_cache_(kReadCacheEntries),
+      order_details_cache_(kReadCacheEntries) {
+
+    for (cpr::Session* session : {&write_session_, &writer_session_}) {
+        session->SetUrl(cpr::Url{endpoint_});
+        session->SetTimeout(cpr::Timeout{health_.writeTimeout});
+    }
 
     std::cout << "[ClickHouse] Initializing repository - host: " << host_
               << ", port: " << port_ << ", database: " << database_
-              << ", user: " << user_ << std::endl;
+              << ", user: " << user_ << ", compression: " << httpCompressionName(compression_)
+              << ", max readers: " << max_readers_ << ", query timeout: " << health_.queryTimeout.count() << " ms" << std::endl;
 
     try {
         // Use HTTP mode for stability (native client has connection issues)
@@ -47,20 +137,28 @@ ClickHouseHistoryRepository::ClickHouseHistoryRepository(const std::string& host
         std::cerr << "[ClickHouse] Exception during initialization: " << e.what() << std::endl;
         connected_ = false;
     }
+}
 
+void ClickHouseHistoryRepository::start() {
+    if (writer_thread_.joinable()) {
+        return;
+    }
     startWriterThread();
+    if (health_.probeInterval.count() > 0) {
+        prober_thread_ = std::thread(&ClickHouseHistoryRepository::proberLoop, this);
+    }
 }
 
 ClickHouseHistoryRepository::~ClickHouseHistoryRepository() {
+    stopProber();
     stopWriterThread();
 }
 
 bool ClickHouseHistoryRepository::connect() {
-    std::lock_guard<std::mutex> lock(client_mutex_);
     try {
         // Use HTTP API for connection testing (more reliable)
         std::cout << "[ClickHouse] Attempting HTTP connection to " << host_ << ":" << port_ << std::endl;
-        auto response = cpr::Get(cpr::Url{"http://" + host_ + ":" + std::to_string(port_)});
+        auto response = cpr::Get(cpr::Url{endpoint_}, cpr::Timeout{health_.probeTimeout});
         if (response.status_code == 200) {
             std::cout << "[ClickHouse] HTTP connection successful (status: " << response.status_code << ")" << std::endl;
             return true;
@@ -75,10 +173,12 @@ bool ClickHouseHistoryRepository::connect() {
 }
 
 void ClickHouseHistoryRepository::disconnect() {
-    std::lock_guard<std::mutex> lock(client_mutex_);
-    // HTTP mode doesn't need explicit disconnect
-    std::cout << "[ClickHouse] HTTP connection doesn't need explicit disconnect." << std::endl;
+    // Idle sessions close their connections; leased ones return afterwards.
+    // The health prober marks the repository connected once the server
+    // answers again.
     connected_ = false;
+    read_sessions_.clear();
+    std::cout << "[ClickHouse] HTTP read sessions released." << std::endl;
 }
 
 bool ClickHouseHistoryRepository::reconnect() {
@@ -102,7 +202,7 @@ bool ClickHouseHistoryRepository::reconnect() {
 }
 
 bool ClickHouseHistoryRepository::initializeDatabase() {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    // createTables and generateMockData each take write_mutex_
     if (!connected_) {
         return false;
     }
@@ -128,13 +228,12 @@ bool ClickHouseHistoryRepository::initializeDatabase() {
 }
 
 bool ClickHouseHistoryRepository::createTables() {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<std::mutex> lock(write_mutex_);
     try {
         // Use HTTP API for ClickHouse table creation
         // Create database if it doesn't exist
         std::string createDbSql = "CREATE DATABASE IF NOT EXISTS " + database_;
-        auto response = cpr::Post(cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                                  cpr::Body{createDbSql});
+        auto response = post(createDbSql);
         if (response.status_code == 200) {
             std::cout << "[ClickHouse] Database created/checked successfully" << std::endl;
         } else {
@@ -142,274 +241,540 @@ bool ClickHouseHistoryRepository::createTables() {
             return false;
         }
 
-        // Create candles_1m table
-        std::string createCandlesTable = R"(
-            CREATE TABLE IF NOT EXISTS )" + database_ + R"(.candles_1m (
+        if (!migrate()) {
+            return false;
+        }
+        // Order events queued so far can go to their tables now
+        order_queue_.release();
+
+        std::cout << "[ClickHouse] Database tables created successfully (schema version " << schemaVersion() << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        logError("Table creation", e);
+        return false;
+    }
+}
+
+std::unique_ptr<cpr::Session> ClickHouseHistoryRepository::createSession() const {
+    auto session = std::make_unique<cpr::Session>();
+    session->SetUrl(cpr::Url{endpoint_});
+    session->SetTimeout(cpr::Timeout{health_.queryTimeout});
+    return session;
+}
+
+cpr::Response ClickHouseHistoryRepository::post(const std::string& body, cpr::Parameters parameters) {
+    return send(write_session_, body, std::move(parameters));
+}
+
+std::string ClickHouseHistoryRepository::read(const std::string& sql, cpr::Parameters parameters) {
+    auto session = read_sessions_.acquire();
+    auto response = send(*session, sql, std::move(parameters));
+    if (response.error) {
+        // A timed out transfer may leave the connection mid-response
+        session.discard();
+        throw std::runtime_error("HTTP request failed: " + response.error.message);
+    }
+    std::string message = "HTTP " + std::to_string(response.status_code) + ": " + response.text;
+    if (response.status_code >= 400 && response.status_code < 500) {
+        throw ClickHouseQueryError(message);
+    }
+    if (response.status_code != 200) {
+        throw std::runtime_error(message);
+    }
+    return std::move(response.text);
+}
+
+bool ClickHouseHistoryRepository::ping() {
+    auto response = cpr::Get(cpr::Url{endpoint_ + "/ping"}, cpr::Timeout{health_.probeTimeout});
+    return response.status_code == 200;
+}
+
+void ClickHouseHistoryRepository::proberLoop() {
+    trading::infrastructure::metrics::TraceRecorder::instance().nameThread("clickhouse-prober");
+    std::unique_lock<std::mutex> lock(prober_mutex_);
+    while (!prober_cond_.wait_for(lock, health_.probeInterval, [this] { return stop_prober_; })) {
+        lock.unlock();
+        if (ping()) {
+            breaker_.probeSucceeded();
+            if (!connected_.exchange(true)) {
+                std::cout << "[ClickHouse] Health probe succeeded, connected again" << std::endl;
+            }
+        } else if (breaker_.state() != CircuitBreaker::State::OPEN) {
+            std::cerr << "[ClickHouse] Health probe failed, failing reads fast for " << health_.breaker.openFor.count()
+                      << " ms" << std::endl;
+            breaker_.trip();
+        }
+        lock.lock();
+    }
+}
+
+void ClickHouseHistoryRepository::stopProber() {
+    {
+        std::lock_guard<std::mutex> lock(prober_mutex_);
+        stop_prober_ = true;
+    }
+    prober_cond_.notify_all();
+    if (prober_thread_.joinable()) {
+        prober_thread_.join();
+    }
+}
+
+cpr::Response ClickHouseHistoryRepository::send(cpr::Session& session, const std::string& body, cpr::Parameters parameters) {
+    cpr::Header header;
+    std::string compressed;
+    const std::string* payload = &body;
+    if (compression_ != HttpCompression::NONE) {
+        std::string codec(httpCompressionName(compression_));
+        parameters.Add({"enable_http_compression", "1"});
+        header["Accept-Encoding"] = codec;
+        // Short queries would only grow by the frame header
+        if (body.size() >= kMinCompressedBody) {
+            compressed = compressHttpBody(body, compression_);
+            header["Content-Encoding"] = codec;
+            payload = &compressed;
+        }
+    }
+
+    // Sessions keep their settings between requests, so each one is set in
+    // full. Decoding stays here: curl would reject an encoding it was not
+    // built with.
+    session.SetParameters(parameters);
+    session.SetHeader(header);
+    session.SetBody(cpr::Body{*payload});
+    session.SetAcceptEncoding(cpr::AcceptEncoding{{cpr::AcceptEncodingMethods::disabled}});
+    auto response = session.Post();
+    bytes_sent_.fetch_add(payload->size(), std::memory_order_relaxed);
+    bytes_received_.fetch_add(response.text.size(), std::memory_order_relaxed);
+
+    auto encoding = response.header.find("Content-Encoding");
+    if (encoding != response.header.end() && encoding->second == httpCompressionName(compression_) &&
+        isCompressedHttpBody(response.text, compression_)) {
+        response.text = decompressHttpBody(response.text, compression_);
+    }
+    return response;
+}
+
+std::optional<std::string> ClickHouseHistoryRepository::execute(const std::string& sql, const std::string& operation) {
+    auto response = post(sql);
+    if (response.status_code != 200) {
+        std::cerr << "[ClickHouse] " << operation << " failed (status " << response.status_code << "): " << response.text << std::endl;
+        return std::nullopt;
+    }
+    return response.text;
+}
+
+bool ClickHouseHistoryRepository::migrate() {
+    struct Migration {
+        uint32_t version;
+        const char* name;
+        bool (ClickHouseHistoryRepository::*apply)();
+    };
+    // Append only: a released version never changes. Databases created before
+    // schema_migrations existed re-run 1 and 2, which only create what is
+    // missing. 2 used to backfill the rollups it created; 4 does it now, for
+    // every database, and rebuilds rollups that 2 had already filled.
+    static const Migration kMigrations[] = {
+        {1, "base tables", &ClickHouseHistoryRepository::createBaseTables},
+        {2, "candle rollups", &ClickHouseHistoryRepository::createCandleRollups},
+        {3, "typed order events", &ClickHouseHistoryRepository::createOrderEvents},
+        {4, "candle rollup backfill", &ClickHouseHistoryRepository::backfillCandleRollups},
+    };
+
+    std::string migrations = database_ + ".schema_migrations";
+    if (!execute("CREATE TABLE IF NOT EXISTS " + migrations + " (version UInt32, name String, applied_at DateTime) "
+                 "ENGINE = MergeTree() ORDER BY version", "Create schema_migrations")) {
+        return false;
+    }
+    auto body = execute("SELECT version FROM " + migrations + " FORMAT JSON", "Read schema_migrations");
+    if (!body) {
+        return false;
+    }
+    std::vector<uint32_t> applied;
+    auto rows = nlohmann::json::parse(*body)["data"];
+    for (const auto& row : rows) {
+        const auto& version = row["version"];
+        applied.push_back(version.is_string() ? static_cast<uint32_t>(std::stoul(version.get<std::string>())) : version.get<uint32_t>());
+    }
+
+    uint32_t version = applied.empty() ? 0 : *std::max_element(applied.begin(), applied.end());
+    schema_version_.store(version, std::memory_order_relaxed);
+    for (const auto& migration : kMigrations) {
+        if (std::find(applied.begin(), applied.end(), migration.version) != applied.end()) {
+            continue;
+        }
+        std::cout << "[ClickHouse] Applying schema migration " << migration.version << " (" << migration.name << ")" << std::endl;
+        if (!(this->*migration.apply)()) {
+            std::cerr << "[ClickHouse] Schema migration " << migration.version << " failed" << std::endl;
+            return false;
+        }
+        if (!execute("INSERT INTO " + migrations + " VALUES (" + std::to_string(migration.version) + ", '" +
+                     migration.name + "', now())", "Record schema migration")) {
+            return false;
+        }
+        version = std::max(version, migration.version);
+        schema_version_.store(version, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool ClickHouseHistoryRepository::createBaseTables() {
+    // Create candles_1m table
+    std::string createCandlesTable = R"(
+        CREATE TABLE IF NOT EXISTS )" + database_ + R"(.candles_1m (
+            symbol String,
+            open_time DateTime,
+            open Float64,
+            high Float64,
+            low Float64,
+            close Float64,
+            volume UInt64
+        ) ENGINE = MergeTree()
+        ORDER BY (symbol, open_time)
+        PARTITION BY toYYYYMMDD(open_time)
+        TTL open_time + INTERVAL 180 DAY
+    )";
+
+    auto response3 = post(createCandlesTable);
+    if (response3.status_code == 200) {
+        std::cout << "[ClickHouse] Candles table created/checked successfully" << std::endl;
+    } else {
+        std::cerr << "[ClickHouse] Failed to create candles table: " << response3.text << std::endl;
+        return false;
+    }
+
+    // Create ticks table
+    std::string createTicksTable = R"(
+        CREATE TABLE IF NOT EXISTS )" + database_ + R"(.ticks (
+            symbol String,
+            ts DateTime64(6),
+            bid Float64,
+            ask Float64,
+            last Float64,
+            volume UInt64
+        ) ENGINE = MergeTree()
+        ORDER BY (symbol, ts)
+        PARTITION BY toYYYYMMDD(ts)
+        TTL ts + INTERVAL 30 DAY
+    )";
+
+    auto response4 = post(createTicksTable);
+    if (response4.status_code == 200) {
+        std::cout << "[ClickHouse] Ticks table created/checked successfully" << std::endl;
+    } else {
+        std::cerr << "[ClickHouse] Failed to create ticks table: " << response4.text << std::endl;
+        return false;
+    }
+
+    // Create orders_log table; superseded by order_events (migration 3)
+    // and kept for the rows written before it
+    std::string createOrdersLogTable = R"(
+        CREATE TABLE IF NOT EXISTS )" + database_ + R"(.orders_log (
+            idemp_key String,
+            ts DateTime,
+            status String,
+            order_id String,
+            result String
+        ) ENGINE = MergeTree()
+        ORDER BY (idemp_key, ts)
+        PARTITION BY toYYYYMMDD(ts)
+    )";
+
+    auto response5 = post(createOrdersLogTable);
+    if (response5.status_code == 200) {
+        std::cout << "[ClickHouse] Orders log table created/checked successfully" << std::endl;
+    } else {
+        std::cerr << "[ClickHouse] Failed to create orders log table: " << response5.text << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ClickHouseHistoryRepository::createCandleRollups() {
+    for (const auto& rollup : kCandleRollups) {
+        std::string table = database_ + "." + rollup.table;
+        std::string createRollup = R"(
+            CREATE TABLE IF NOT EXISTS )" + table + R"( (
                 symbol String,
                 open_time DateTime,
-                open Float64,
-                high Float64,
-                low Float64,
-                close Float64,
-                volume UInt64
-            ) ENGINE = MergeTree()
+                open AggregateFunction(argMin, Float64, DateTime),
+                high SimpleAggregateFunction(max, Float64),
+                low SimpleAggregateFunction(min, Float64),
+                close AggregateFunction(argMax, Float64, DateTime),
+                volume SimpleAggregateFunction(sum, UInt64)
+            ) ENGINE = AggregatingMergeTree()
             ORDER BY (symbol, open_time)
-            PARTITION BY toYYYYMMDD(open_time)
-            TTL open_time + INTERVAL 180 DAY
-        )";
-
-        auto response3 = cpr::Post(cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                                   cpr::Body{createCandlesTable});
-        if (response3.status_code == 200) {
-            std::cout << "[ClickHouse] Candles table created/checked successfully" << std::endl;
-        } else {
-            std::cerr << "[ClickHouse] Failed to create candles table: " << response3.text << std::endl;
+            PARTITION BY toYYYYMM(open_time)
+        )" + (*rollup.ttl ? std::string("TTL open_time + ") + rollup.ttl : std::string());
+        auto response = post(createRollup);
+        if (response.status_code != 200) {
+            std::cerr << "[ClickHouse] Failed to create rollup " << rollup.table << ": " << response.text << std::endl;
             return false;
         }
 
-        // Create ticks table
-        std::string createTicksTable = R"(
-            CREATE TABLE IF NOT EXISTS )" + database_ + R"(.ticks (
-                symbol String,
-                ts DateTime64(6),
-                bid Float64,
-                ask Float64,
-                last Float64,
-                volume UInt64
-            ) ENGINE = MergeTree()
-            ORDER BY (symbol, ts)
-            PARTITION BY toYYYYMMDD(ts)
-            TTL ts + INTERVAL 30 DAY
-        )";
-
-        auto response4 = cpr::Post(cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                                   cpr::Body{createTicksTable});
-        if (response4.status_code == 200) {
-            std::cout << "[ClickHouse] Ticks table created/checked successfully" << std::endl;
-        } else {
-            std::cerr << "[ClickHouse] Failed to create ticks table: " << response4.text << std::endl;
+        auto view = post("CREATE MATERIALIZED VIEW IF NOT EXISTS " + table + "_mv TO " + table + " AS " + rollupSelect(rollup));
+        if (view.status_code != 200) {
+            std::cerr << "[ClickHouse] Failed to create view for rollup " << rollup.table << ": " << view.text << std::endl;
             return false;
         }
+        std::cout << "[ClickHouse] Rollup " << rollup.table << " created/checked successfully" << std::endl;
+    }
+    return true;
+}
 
-        // Create orders_log table
-        std::string createOrdersLogTable = R"(
-            CREATE TABLE IF NOT EXISTS )" + database_ + R"(.orders_log (
-                idemp_key String,
-                ts DateTime,
-                status String,
-                order_id String,
-                result String
-            ) ENGINE = MergeTree()
-            ORDER BY (idemp_key, ts)
-            PARTITION BY toYYYYMMDD(ts)
-        )";
-
-        auto response5 = cpr::Post(cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                                   cpr::Body{createOrdersLogTable});
-        if (response5.status_code == 200) {
-            std::cout << "[ClickHouse] Orders log table created/checked successfully" << std::endl;
-        } else {
-            std::cerr << "[ClickHouse] Failed to create orders log table: " << response5.text << std::endl;
+bool ClickHouseHistoryRepository::backfillCandleRollups() {
+    // Each rollup is rebuilt from candles_1m, so a run cut short by a failure
+    // or a crash is simply redone: the migration is recorded only after every
+    // rollup has been filled. The views exist already (migration 2) and
+    // candles go in only through insertCandles with write_mutex_ held, as it
+    // is here, so no candle is missed or counted twice.
+    for (const auto& rollup : kCandleRollups) {
+        std::string table = database_ + "." + rollup.table;
+        if (!execute("TRUNCATE TABLE " + table, std::string("Clear rollup ") + rollup.table) ||
+            !execute("INSERT INTO " + table + " " + rollupSelect(rollup), std::string("Backfill rollup ") + rollup.table)) {
             return false;
         }
+        std::cout << "[ClickHouse] Rollup " << rollup.table << " backfilled" << std::endl;
+    }
+    return true;
+}
 
-        std::cout << "[ClickHouse] Database tables created successfully" << std::endl;
-        return true;
+std::string ClickHouseHistoryRepository::rollupSelect(const CandleRollup& rollup) const {
+    // Columns are qualified so the output aliases do not shadow the 1m columns
+    std::string bucket = std::string(rollup.bucket) + "(src.open_time)";
+    return "SELECT src.symbol AS symbol, " + bucket + " AS open_time, "
+           "argMinState(src.open, src.open_time) AS open, max(src.high) AS high, min(src.low) AS low, "
+           "argMaxState(src.close, src.open_time) AS close, sum(src.volume) AS volume "
+           "FROM " + database_ + ".candles_1m AS src GROUP BY src.symbol, " + bucket;
+}
 
-    } catch (const std::exception& e) {
-        logError("Table creation", e);
+bool ClickHouseHistoryRepository::createOrderEvents() {
+    std::string events = database_ + ".order_events";
+    std::string latest = database_ + ".orders_latest";
+    auto exists = execute("EXISTS TABLE " + events, "Check order_events");
+    if (!exists) {
+        return false;
+    }
+    bool created = exists->rfind("0", 0) == 0;
+
+    // Every event, in order_id order so one order's events are adjacent
+    std::string createEvents = R"(
+        CREATE TABLE IF NOT EXISTS )" + events + R"( (
+            order_id String,
+            ts DateTime64(3),
+            placed_at DateTime64(3),
+            event_type Enum8('PLACE' = 1, 'CANCEL' = 2),
+            status )" + kOrderStatusEnum + R"(,
+            idemp_key String,
+            symbol LowCardinality(String),
+            side )" + kOrderSideEnum + R"(,
+            type )" + kOrderTypeEnum + R"(,
+            quantity Float64,
+            price Float64,
+            account_id String,
+            session_id String
+        ) ENGINE = MergeTree()
+        ORDER BY (order_id, ts)
+        PARTITION BY toYYYYMM(ts)
+    )";
+    // One row per order once merged, sorted by placement time so history is a
+    // key-ordered read. placed_at never changes for an order, so all of its
+    // versions share a partition and the engine can collapse them.
+    std::string createLatest = R"(
+        CREATE TABLE IF NOT EXISTS )" + latest + R"( (
+            order_id String,
+            placed_at DateTime64(3),
+            updated_at DateTime64(3),
+            status )" + kOrderStatusEnum + R"(,
+            idemp_key String,
+            symbol LowCardinality(String),
+            side )" + kOrderSideEnum + R"(,
+            type )" + kOrderTypeEnum + R"(,
+            quantity Float64,
+            price Float64,
+            account_id String,
+            session_id String
+        ) ENGINE = ReplacingMergeTree(updated_at)
+        ORDER BY (placed_at, order_id)
+        PARTITION BY toYYYYMM(placed_at)
+    )";
+    if (!execute(createEvents, "Create order_events") || !execute(createLatest, "Create orders_latest")) {
         return false;
     }
-}
 
-std::vector<trading::domain::Candle> ClickHouseHistoryRepository::fetch(
-    const trading::domain::Symbol& symbol,
-    const trading::domain::HistoryQuery& query) {
+    // Feeds orders_latest: each event becomes a version of its order
+    std::string toLatest =
+        "SELECT e.order_id AS order_id, e.placed_at AS placed_at, e.ts AS updated_at, e.status AS status, "
+        "e.idemp_key AS idemp_key, e.symbol AS symbol, e.side AS side, e.type AS type, e.quantity AS quantity, "
+        "e.price AS price, e.account_id AS account_id, e.session_id AS session_id FROM " + events + " AS e";
 
-    std::lock_guard<std::mutex> lock(client_mutex_);
-    if (!connected_) {
-        std::cout << "[ClickHouse] Not connected, returning empty result" << std::endl;
-        return {};
+    // The view comes first, so the backfilled events reach orders_latest
+    // through it like live ones. The writer holds live events until
+    // createTables has finished; a version seen twice would collapse anyway.
+    if (!execute("CREATE MATERIALIZED VIEW IF NOT EXISTS " + latest + "_mv TO " + latest + " AS " + toLatest, "Create orders_latest_mv")) {
+        return false;
     }
 
-    try {
-        // HTTP mode - Real ClickHouse query via HTTP API
-        // Convert Unix timestamp to ClickHouse DateTime format
-        std::time_t fromTime = query.fromTs;
-        std::time_t toTime = query.toTs;
-        
-        char fromBuffer[32], toBuffer[32];
-        
-        // Create local copies since gmtime modifies a static buffer
-        struct tm fromTm, toTm;
-        fromTm = *std::gmtime(&fromTime);
-        toTm = *std::gmtime(&toTime);
-        
-        std::strftime(fromBuffer, sizeof(fromBuffer), "%Y-%m-%d %H:%M:%S", &fromTm);
-        std::strftime(toBuffer, sizeof(toBuffer), "%Y-%m-%d %H:%M:%S", &toTm);
-
-        std::stringstream sql;
-        sql << "SELECT open_time, open, high, low, close, volume FROM " << database_ << ".candles_1m "
-            << "WHERE symbol = '" << symbol.code << "' "
-            << "AND open_time >= '" << fromBuffer << "' "
-            << "AND open_time <= '" << toBuffer << "' "
-            << "ORDER BY open_time DESC "
-            << "LIMIT " << query.limit 
-            << " FORMAT JSON";
+    // orders_log rows, the first per order dating the placement
+    if (created) {
+        std::string backfill =
+            "INSERT INTO " + events + " SELECT l.order_id AS order_id, toDateTime64(l.ts, 3) AS ts, "
+            "toDateTime64(p.placed_at, 3) AS placed_at, if(upper(l.status) = 'CANCELLED', 'CANCEL', 'PLACE') AS event_type, " +
+            enumFromSql("l.status", kOrderStatuses) + " AS status, l.idemp_key AS idemp_key, "
+            "JSONExtractString(l.result, 'symbol') AS symbol, " +
+            enumFromSql("JSONExtractString(l.result, 'side')", kOrderSides) + " AS side, " +
+            enumFromSql("JSONExtractString(l.result, 'type')", kOrderTypes) + " AS type, "
+            "JSONExtractFloat(l.result, 'quantity') AS quantity, JSONExtractFloat(l.result, 'price') AS price, "
+            "'' AS account_id, JSONExtractString(l.result, 'sessionId') AS session_id "
+            "FROM " + database_ + ".orders_log AS l INNER JOIN (SELECT order_id, min(ts) AS placed_at FROM " +
+            database_ + ".orders_log GROUP BY order_id) AS p ON l.order_id = p.order_id";
+        if (!execute(backfill, "Backfill order_events")) {
+            return false;
+        }
+    }
 
-        std::cout << "[ClickHouse] Executing HTTP query: " << sql.str() << std::endl;
+    std::cout << "[ClickHouse] Order events tables created/checked successfully" << (created ? " (backfilled)" : "") << std::endl;
+    return true;
+}
 
-        std::vector<trading::domain::Candle> candles;
-        
+template <typename Value, typename Read>
+Value ClickHouseHistoryRepository::guardedRead(const char* operation, trading::infrastructure::cache::LruCache<Value>& cache,
+                                               const std::string& key, Read&& read) {
+    if (!connected_) {
+        std::cout << "[ClickHouse] Not connected, " << operation << " served from cache" << std::endl;
+    } else if (!breaker_.allow()) {
+        // Fails fast: no request goes out while ClickHouse is unhealthy
+    } else {
         try {
-            auto response = cpr::Post(
-                cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                cpr::Body{sql.str()}
-            );
-            
-            if (response.status_code == 200) {
-                std::cout << "[ClickHouse] HTTP query successful, parsing JSON..." << std::endl;
-                
-                // Parse JSON response from ClickHouse
-                auto jsonResponse = nlohmann::json::parse(response.text);
-                auto data = jsonResponse["data"];
-                
-                for (const auto& row : data) {
-                    // ClickHouse returns timestamps as strings, convert to int64_t
-                    int64_t openTime;
-                    try {
-                        if (row["open_time"].is_string()) {
-                            openTime = std::stoll(row["open_time"].get<std::string>());
-                        } else {
-                            openTime = row["open_time"].get<int64_t>();
-                        }
-                    } catch (...) {
-                        openTime = 0;
-                    }
-                    
-                    double open = row["open"].is_string() ? std::stod(row["open"].get<std::string>()) : row["open"].get<double>();
-                    double high = row["high"].is_string() ? std::stod(row["high"].get<std::string>()) : row["high"].get<double>();
-                    double low = row["low"].is_string() ? std::stod(row["low"].get<std::string>()) : row["low"].get<double>();
-                    double close = row["close"].is_string() ? std::stod(row["close"].get<std::string>()) : row["close"].get<double>();
-                    uint64_t volume = row["volume"].is_string() ? std::stoull(row["volume"].get<std::string>()) : row["volume"].get<uint64_t>();
-                    
-                    candles.emplace_back(
-                        openTime,
-                        open,
-                        high,
-                        low,
-                        close,
-                        volume,
-                        query.interval
-                    );
-                }
-                
-                std::cout << "[ClickHouse] Parsed " << candles.size() << " candles from HTTP response" << std::endl;
-            } else {
-                std::cerr << "[ClickHouse] HTTP query failed (status " << response.status_code << "): " << response.text << std::endl;
-            }
+            Value value = read();
+            breaker_.recordSuccess();
+            cache.put(key, value);
+            return value;
+        } catch (const ClickHouseQueryError& e) {
+            breaker_.recordIgnored();
+            reads_failed_.fetch_add(1, std::memory_order_relaxed);
+            logError(operation, e);
+            throw;
         } catch (const std::exception& e) {
-            std::cerr << "[ClickHouse] HTTP query exception: " << e.what() << std::endl;
+            breaker_.recordFailure();
+            reads_failed_.fetch_add(1, std::memory_order_relaxed);
+            logError(operation, e);
         }
+    }
 
-        return candles;
-
-    } catch (const std::exception& e) {
-        logError("History fetch", e);
-        return {};
+    auto cached = cache.get(key);
+    if (!cached) {
+        return Value{};
     }
+    stale_reads_.fetch_add(1, std::memory_order_relaxed);
+    return std::move(*cached);
+}
+
+std::vector<trading::domain::Candle> ClickHouseHistoryRepository::fetch(
+    const trading::domain::Symbol& symbol,
+    const trading::domain::HistoryQuery& query) {
+
+    std::string key = historyCacheKey(symbol, query, nowMillis() / 1000);
+    return guardedRead("History fetch", candle_cache_, key, [&] { return readCandles(symbol, query); });
+}
+
+std::vector<trading::domain::Candle> ClickHouseHistoryRepository::readCandles(
+    const trading::domain::Symbol& symbol,
+    const trading::domain::HistoryQuery& query) {
+
+    const std::string* sql;
+    cpr::Parameters parameters;
+    statements_.candles(symbol, query, [&](const auto& selected, const auto&... values) {
+        sql = &selected.sql();
+        parameters = selected.bind(values...);
+    });
+
+    std::cout << "[ClickHouse] Executing HTTP query for " << symbol.code << " [" << query.fromTs << ", " << query.toTs
+              << "]: " << *sql << std::endl;
+
+    auto body = read(*sql, std::move(parameters));
+    std::cout << "[ClickHouse] HTTP query successful, parsing JSON..." << std::endl;
+
+    // Parse JSON response from ClickHouse
+    auto candles = parseCandlesJson(body, query.interval);
+    std::cout << "[ClickHouse] Parsed " << candles.size() << " candles from HTTP response" << std::endl;
+    return candles;
 }
 
 std::vector<trading::domain::Candle> ClickHouseHistoryRepository::latest(
     const std::vector<trading::domain::Symbol>& symbols,
     int32_t limit) {
 
-    std::lock_guard<std::mutex> lock(client_mutex_);
-    if (!connected_ || symbols.empty()) {
+    if (symbols.empty()) {
         return {};
     }
 
-    try {
-        // HTTP mode - Real ClickHouse query via HTTP API
-        std::stringstream symbolList;
-        for (size_t i = 0; i < symbols.size(); ++i) {
-            if (i > 0) symbolList << ",";
-            symbolList << "'" << symbols[i].code << "'";
-        }
+    std::vector<std::string> codes;
+    codes.reserve(symbols.size());
+    std::string key = "latest|" + std::to_string(limit);
+    for (const auto& symbol : symbols) {
+        codes.push_back(symbol.code);
+        key += '|' + symbol.code;
+    }
+    return guardedRead("Latest fetch", candle_cache_, key,
+                       [&] { return readLatest(codes, static_cast<uint32_t>(std::max(limit, 0))); });
+}
 
-        std::stringstream sql;
-        sql << "SELECT symbol, open_time, open, high, low, close, volume FROM " << database_ << ".candles_1m "
-            << "WHERE symbol IN (" << symbolList.str() << ") "
-            << "ORDER BY open_time DESC "
-            << "LIMIT " << limit
-            << " FORMAT JSON";
+std::vector<trading::domain::Candle> ClickHouseHistoryRepository::readLatest(const std::vector<std::string>& codes, uint32_t limit) {
+    std::cout << "[ClickHouse] Executing HTTP latest query for " << codes.size() << " symbols: " << statements_.latest.sql() << std::endl;
 
-        std::cout << "[ClickHouse] Executing HTTP latest query: " << sql.str() << std::endl;
+    auto body = read(statements_.latest.sql(), statements_.latest.bind(codes, limit));
+    std::cout << "[ClickHouse] HTTP query successful, parsing JSON..." << std::endl;
 
-        std::vector<trading::domain::Candle> candles;
-        
+    // Parse JSON response from ClickHouse
+    auto candles = parseCandlesJson(body, trading::domain::Interval::M1);
+    std::cout << "[ClickHouse] Parsed " << candles.size() << " latest candles from HTTP response" << std::endl;
+    return candles;
+}
+
+std::vector<trading::domain::Candle> ClickHouseHistoryRepository::parseCandlesJson(
+    const std::string& body,
+    trading::domain::Interval interval) {
+
+    auto jsonResponse = nlohmann::json::parse(body);
+    const auto& data = jsonResponse["data"];
+
+    std::vector<trading::domain::Candle> candles;
+    candles.reserve(data.size());
+    for (const auto& row : data) {
+        // ClickHouse returns timestamps as strings, convert to int64_t
+        int64_t openTime;
         try {
-            auto response = cpr::Post(
-                cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                cpr::Body{sql.str()}
-            );
-            
-            if (response.status_code == 200) {
-                std::cout << "[ClickHouse] HTTP query successful, parsing JSON..." << std::endl;
-                
-                // Parse JSON response from ClickHouse
-                auto jsonResponse = nlohmann::json::parse(response.text);
-                auto data = jsonResponse["data"];
-                
-                for (const auto& row : data) {
-                    std::string symbol = row["symbol"].get<std::string>();
-                    // ClickHouse returns timestamps as strings, convert to int64_t
-                    int64_t openTime;
-                    try {
-                        if (row["open_time"].is_string()) {
-                            openTime = std::stoll(row["open_time"].get<std::string>());
-                        } else {
-                            openTime = row["open_time"].get<int64_t>();
-                        }
-                    } catch (...) {
-                        openTime = 0;
-                    }
-                    
-                    double open = row["open"].is_string() ? std::stod(row["open"].get<std::string>()) : row["open"].get<double>();
-                    double high = row["high"].is_string() ? std::stod(row["high"].get<std::string>()) : row["high"].get<double>();
-                    double low = row["low"].is_string() ? std::stod(row["low"].get<std::string>()) : row["low"].get<double>();
-                    double close = row["close"].is_string() ? std::stod(row["close"].get<std::string>()) : row["close"].get<double>();
-                    uint64_t volume = row["volume"].is_string() ? std::stoull(row["volume"].get<std::string>()) : row["volume"].get<uint64_t>();
-                    
-                    candles.emplace_back(
-                        openTime,
-                        open,
-                        high,
-                        low,
-                        close,
-                        volume,
-                        trading::domain::Interval::M1
-                    );
+            if (row["open_time"].is_string()) {
+                const auto& text = row["open_time"].get_ref<const std::string&>();
+                if (text.find('-', 1) != std::string::npos) {
+                    // DateTime columns arrive as 'YYYY-MM-DD hh:mm:ss' in UTC
+                    std::tm tm{};
+                    std::istringstream stream(text);
+                    stream >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+                    openTime = stream.fail() ? 0 : static_cast<int64_t>(timegm(&tm));
+                } else {
+                    openTime = std::stoll(text);
                 }
-                
-                std::cout << "[ClickHouse] Parsed " << candles.size() << " latest candles from HTTP response" << std::endl;
             } else {
-                std::cerr << "[ClickHouse] HTTP latest query failed (status " << response.status_code << "): " << response.text << std::endl;
+                openTime = row["open_time"].get<int64_t>();
             }
-        } catch (const std::exception& e) {
-            std::cerr << "[ClickHouse] HTTP latest query exception: " << e.what() << std::endl;
+        } catch (...) {
+            openTime = 0;
         }
 
-        return candles;
+        double open = row["open"].is_string() ? std::stod(row["open"].get<std::string>()) : row["open"].get<double>();
+        double high = row["high"].is_string() ? std::stod(row["high"].get<std::string>()) : row["high"].get<double>();
+        double low = row["low"].is_string() ? std::stod(row["low"].get<std::string>()) : row["low"].get<double>();
+        double close = row["close"].is_string() ? std::stod(row["close"].get<std::string>()) : row["close"].get<double>();
+        uint64_t volume = row["volume"].is_string() ? std::stoull(row["volume"].get<std::string>()) : row["volume"].get<uint64_t>();
 
-    } catch (const std::exception& e) {
-        logError("Latest fetch", e);
-        return {};
+        candles.emplace_back(openTime, open, high, low, close, volume, interval);
     }
+    return candles;
 }
 
-// parseCandlesFromBlock method removed - using HTTP API instead of native client
-
 trading::domain::Interval ClickHouseHistoryRepository::stringToInterval(const std::string& interval) const {
     if (interval == "S1") return trading::domain::Interval::S1;
     if (interval == "S5") return trading::domain::Interval::S5;
@@ -440,6 +805,13 @@ void ClickHouseHistoryRepository::logError(const std::string& operation, const s
     std::cerr << "[ClickHouse] Error in " << operation << ": " << e.what() << std::endl;
 }
 
+std::pair<std::chrono::sys_seconds, std::chrono::sys_seconds> ClickHouseHistoryRepository::orderHistoryRange(
+    const std::string& fromTime, const std::string& toTime) {
+    int64_t fromSeconds = fromTime.empty() ? 0 : parseMillis(fromTime) / 1000;
+    int64_t toSeconds = toTime.empty() ? std::numeric_limits<uint32_t>::max() : (parseMillis(toTime) + 999) / 1000;
+    return {std::chrono::sys_seconds{std::chrono::seconds(fromSeconds)}, std::chrono::sys_seconds{std::chrono::seconds(toSeconds)}};
+}
+
 std::string ClickHouseHistoryRepository::getEnvVar(const std::string& name, const std::string& defaultValue) {
     const char* envValue = std::getenv(name.c_str());
     if (envValue == nullptr) {
@@ -504,17 +876,68 @@ std::unique_ptr<ClickHouseHistoryRepository> ClickHouseHistoryRepository::create
         }
     }
 
+    std::string compressionName = getEnvVar("CLICKHOUSE_HTTP_COMPRESSION", "none");
+    auto compression = parseHttpCompression(compressionName);
+    if (!compression) {
+        std::cerr << "[ClickHouse] Unknown CLICKHOUSE_HTTP_COMPRESSION '" << compressionName
+                  << "' (expected none, lz4 or zstd), sending uncompressed" << std::endl;
+    }
+
+    std::string protocol = getEnvVar("CLICKHOUSE_PROTOCOL", "http");
+    if (protocol != "http" && protocol != "native") {
+        std::cerr << "[ClickHouse] Unknown CLICKHOUSE_PROTOCOL '" << protocol << "' (expected http or native), using http" << std::endl;
+        protocol = "http";
+    }
+
+    int maxReadersEnv = getEnvVarInt("CLICKHOUSE_MAX_READERS", static_cast<int>(kDefaultMaxReaders));
+    size_t maxReaders = maxReadersEnv > 0 ? static_cast<size_t>(maxReadersEnv) : kDefaultMaxReaders;
+
+    ClickHouseHealthConfig health;
+    auto millisEnv = [](const char* name, std::chrono::milliseconds fallback) {
+        int value = getEnvVarInt(name, static_cast<int>(fallback.count()));
+        return value >= 0 ? std::chrono::milliseconds(value) : fallback;
+    };
+    health.queryTimeout = millisEnv("CLICKHOUSE_QUERY_TIMEOUT_MS", health.queryTimeout);
+    health.writeTimeout = millisEnv("CLICKHOUSE_WRITE_TIMEOUT_MS", health.writeTimeout);
+    if (health.queryTimeout.count() > 0) {
+        health.probeTimeout = std::min(health.probeTimeout, health.queryTimeout);
+    }
+    health.probeInterval = millisEnv("CLICKHOUSE_PROBE_INTERVAL_MS", health.probeInterval);
+    health.breaker.failureThreshold = static_cast<uint32_t>(
+        std::max(1, getEnvVarInt("CLICKHOUSE_BREAKER_FAILURES", static_cast<int>(health.breaker.failureThreshold))));
+    health.breaker.openFor = millisEnv("CLICKHOUSE_BREAKER_OPEN_MS", health.breaker.openFor);
+
     std::cout << "[ClickHouse] Environment config - host: " << host
               << ", http_port: " << httpPort
               << ", native_port: " << nativePort
               << ", database: " << database
-              << ", user: " << user << std::endl;
-
-    return std::make_unique<ClickHouseHistoryRepository>(host, httpPort, database);
+              << ", user: " << user
+              << ", protocol: " << protocol
+              << ", max_readers: " << maxReaders
+              << ", query_timeout_ms: " << health.queryTimeout.count()
+              << ", compression: " << httpCompressionName(compression.value_or(HttpCompression::NONE)) << std::endl;
+
+    std::unique_ptr<ClickHouseHistoryRepository> repository;
+    if (protocol == "native") {
+#ifdef CLICKHOUSE_AVAILABLE
+        repository = std::make_unique<ClickHouseNativeRepository>(host, httpPort, nativePort, database,
+                                                                  compression.value_or(HttpCompression::NONE), maxReaders, health);
+#else
+        std::cerr << "[ClickHouse] CLICKHOUSE_PROTOCOL=native needs a build with clickhouse-cpp, using http" << std::endl;
+#endif
+    }
+    if (!repository) {
+        repository = std::make_unique<ClickHouseHistoryRepository>(host, httpPort, database, compression.value_or(HttpCompression::NONE),
+                                                                   maxReaders, health);
+    }
+    // Threads start only once the repository, subclass included, is complete
+    repository->start();
+    return repository;
 }
 
 bool ClickHouseHistoryRepository::generateMockData() {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    // Readers carry on while the load runs
+    std::lock_guard<std::mutex> lock(write_mutex_);
     if (!connected_) {
         std::cout << "[MockData] Not connected to ClickHouse, skipping mock data generation" << std::endl;
         return false;
@@ -559,16 +982,10 @@ bool ClickHouseHistoryRepository::generateMockData() {
         std::cout << "[MockData] Checking if data already exists..." << std::endl;
         
         // Check ticks table
-        auto ticksCheckResponse = cpr::Post(
-            cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-            cpr::Body{"SELECT COUNT(*) FROM " + database_ + ".ticks"}
-        );
+        auto ticksCheckResponse = post("SELECT COUNT(*) FROM " + database_ + ".ticks");
         
         // Check candles_1m table (frontend uses this)
-        auto candlesCheckResponse = cpr::Post(
-            cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-            cpr::Body{"SELECT COUNT(*) FROM " + database_ + ".candles_1m"}
-        );
+        auto candlesCheckResponse = post("SELECT COUNT(*) FROM " + database_ + ".candles_1m");
         
         std::cout << "[MockData] Ticks check response status: " << ticksCheckResponse.status_code << ", text: '" << ticksCheckResponse.text << "'" << std::endl;
         std::cout << "[MockData] Candles check response status: " << candlesCheckResponse.status_code << ", text: '" << candlesCheckResponse.text << "'" << std::endl;
@@ -594,8 +1011,9 @@ bool ClickHouseHistoryRepository::generateMockData() {
         
         std::cout << "[MockData] No existing data found, proceeding with generation..." << std::endl;
 
-        // Generate mock ticks data for each symbol
+        // Generate mock ticks data for each symbol, inserted in one statement
         std::cout << "[MockData] Generating mock ticks data..." << std::endl;
+        std::vector<TickRow> ticks;
         for (const auto& symbol : symbols) {
             double basePrice = basePrices[symbol];
             auto currentTime = startTime;
@@ -615,85 +1033,45 @@ bool ClickHouseHistoryRepository::generateMockData() {
                     double last = basePrice;
                     int volume = tickVolumeDist(gen);
                     
-                    // Insert tick data - convert timestamp to proper ClickHouse DateTime format
-                    auto time_t_val = std::chrono::system_clock::to_time_t(currentTime);
-                    struct tm* tm_info = std::gmtime(&time_t_val);
-                    char timestamp_str[32];
-                    std::strftime(timestamp_str, sizeof(timestamp_str), "%Y-%m-%d %H:%M:%S", tm_info);
-                    
-                    std::stringstream insertSql;
-                    insertSql << "INSERT INTO " << database_ << ".ticks VALUES ('" 
-                              << symbol << "', '" << timestamp_str << "', " 
-                              << bid << ", " << ask << ", " << last << ", " << volume << ")";
-                    
-                    auto insertResponse = cpr::Post(
-                        cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                        cpr::Body{insertSql.str()}
-                    );
-                    
-                    if (insertResponse.status_code != 200) {
-                        std::cout << "[MockData] Failed to insert tick for " << symbol 
-                                  << " (status: " << insertResponse.status_code 
-                                  << ", response: " << insertResponse.text << ")" << std::endl;
-                        std::cout << "[MockData] Failed SQL: " << insertSql.str() << std::endl;
-                    }
+                    int64_t tsMs = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime.time_since_epoch()).count();
+                    ticks.push_back({symbol, trading::domain::Tick(tsMs, bid, ask, last, static_cast<uint64_t>(volume))});
                     
                     // Advance time by random interval (30-300 seconds)
                     currentTime += std::chrono::seconds(30 + (tick % 270));
                 }
             }
         }
+        if (!insertTicks(ticks)) {
+            std::cout << "[MockData] Failed to insert " << ticks.size() << " ticks" << std::endl;
+        }
         
-        // Generate mock orders_log data
-        std::cout << "[MockData] Generating mock orders_log data..." << std::endl;
-        std::vector<std::string> orderStatuses = {"FILLED", "PENDING", "CANCELLED"};
+        // Generate mock order events, written by the writer thread like live orders
+        std::cout << "[MockData] Generating mock order events..." << std::endl;
+        std::vector<std::string> orderStatuses = {"FILLED", "ACK", "CANCELLED"};
         
         for (int i = 0; i < 10; i++) { // 10 sample orders (much shorter)
-            std::string orderId = "ORD_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() + i);
-            std::string idempKey = "idemp_" + std::to_string(i);
-            std::string status = orderStatuses[i % 3];
+            OrderEvent event;
+            event.orderId = "ORD_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() + i);
+            event.idempKey = "idemp_" + std::to_string(i);
+            event.status = orderStatuses[i % 3];
+            event.eventType = event.status == "CANCELLED" ? "CANCEL" : "PLACE";
             
             int symbolIndex = i % symbols.size();
-            std::string symbol = symbols[symbolIndex];
-            double price = basePrices[symbol] * (1.0 + (priceDist(gen) - 0.5) * 0.1);
-            
-            nlohmann::json result = {
-                {"symbol", symbol},
-                {"side", i % 2 ? "SELL" : "BUY"},
-                {"price", price},
-                {"quantity", 1.0 + (i % 10)},
-                {"type", "LIMIT"}
-            };
+            event.symbol = symbols[symbolIndex];
+            event.price = basePrices[event.symbol] * (1.0 + (priceDist(gen) - 0.5) * 0.1);
+            event.side = i % 2 ? "SELL" : "BUY";
+            event.quantity = 1.0 + (i % 10);
+            event.type = "LIMIT";
+            event.tsMs = std::chrono::duration_cast<std::chrono::milliseconds>((now - std::chrono::hours(i)).time_since_epoch()).count();
             
-            // Convert timestamp to proper ClickHouse DateTime format
-            auto order_time = now - std::chrono::hours(i);
-            auto time_t_val = std::chrono::system_clock::to_time_t(order_time);
-            struct tm* tm_info = std::gmtime(&time_t_val);
-            char timestamp_str[32];
-            std::strftime(timestamp_str, sizeof(timestamp_str), "%Y-%m-%d %H:%M:%S", tm_info);
-            
-            std::stringstream insertSql;
-            insertSql << "INSERT INTO " << database_ << ".orders_log VALUES ('"
-                      << idempKey << "', '" << timestamp_str << "', '"
-                      << status << "', '" << orderId << "', '" << result.dump() << "')";
-            
-            auto insertResponse = cpr::Post(
-                cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                cpr::Body{insertSql.str()}
-            );
-            
-            if (insertResponse.status_code == 200) {
-                std::cout << "[MockData] Inserted order " << orderId << " for " << symbol << std::endl;
-            } else {
-                std::cout << "[MockData] Failed to insert order " << orderId 
-                          << " (status: " << insertResponse.status_code 
-                          << ", response: " << insertResponse.text << ")" << std::endl;
-                std::cout << "[MockData] Failed SQL: " << insertSql.str() << std::endl;
+            if (logOrder(event)) {
+                std::cout << "[MockData] Queued order " << event.orderId << " for " << event.symbol << std::endl;
             }
         }
 
-        // Generate mock candles_1m data for frontend chart
+        // Generate mock candles_1m data for frontend chart, inserted in one statement
         std::cout << "[MockData] Generating mock candles_1m data..." << std::endl;
+        std::vector<CandleRow> candles;
         for (const auto& symbol : symbols) {
             double basePrice = basePrices[symbol];
             auto currentTime = startTime;
@@ -716,27 +1094,9 @@ bool ClickHouseHistoryRepository::generateMockData() {
                         double low = (open < close ? open : close) * (1.0 - priceDist(gen) * 0.005);
                         int volume = volumeDist(gen);
                         
-                        // Convert timestamp to proper ClickHouse DateTime format
-                        auto time_t_val = std::chrono::system_clock::to_time_t(currentTime);
-                        struct tm* tm_info = std::gmtime(&time_t_val);
-                        char timestamp_str[32];
-                        std::strftime(timestamp_str, sizeof(timestamp_str), "%Y-%m-%d %H:%M:%S", tm_info);
-                        
-                        std::stringstream insertSql;
-                        insertSql << "INSERT INTO " << database_ << ".candles_1m VALUES ('"
-                                  << symbol << "', '" << timestamp_str << "', "
-                                  << open << ", " << high << ", " << low << ", " << close << ", " << volume << ")";
-                        
-                        auto insertResponse = cpr::Post(
-                            cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                            cpr::Body{insertSql.str()}
-                        );
-                        
-                        if (insertResponse.status_code != 200) {
-                            std::cout << "[MockData] Failed to insert candle for " << symbol 
-                                      << " (status: " << insertResponse.status_code 
-                                      << ", response: " << insertResponse.text << ")" << std::endl;
-                        }
+                        int64_t openTime = std::chrono::system_clock::to_time_t(currentTime);
+                        candles.push_back({symbol, trading::domain::Candle(openTime, open, high, low, close, static_cast<uint64_t>(volume),
+                                                                           trading::domain::Interval::M1)});
                         
                         // Advance by 15 minutes
                         currentTime += std::chrono::minutes(15);
@@ -744,6 +1104,9 @@ bool ClickHouseHistoryRepository::generateMockData() {
                 }
             }
         }
+        if (!insertCandles(candles)) {
+            std::cout << "[MockData] Failed to insert " << candles.size() << " candles" << std::endl;
+        }
 
         std::cout << "[MockData] Mock data generation completed successfully!" << std::endl;
         return true;
@@ -754,14 +1117,59 @@ bool ClickHouseHistoryRepository::generateMockData() {
     }
 }
 
-bool ClickHouseHistoryRepository::logOrder(const std::string& idempKey, const std::string& status, const std::string& orderId, const std::string& resultJson) {
-    std::cout << "[OrderLog] Queuing order for background logging. Key: " << idempKey << std::endl;
+bool ClickHouseHistoryRepository::insertTicks(const std::vector<TickRow>& rows) {
+    if (rows.empty()) {
+        return true;
+    }
+    // DateTime columns take integer epoch timestamps scaled to their precision,
+    // so no row is formatted as date text
+    std::string insertSql = "INSERT INTO " + database_ + ".ticks FORMAT JSONEachRow\n";
+    for (const auto& row : rows) {
+        insertSql += nlohmann::json{
+            {"symbol", row.symbol},
+            {"ts", row.tick.ts * 1000},  // DateTime64(6): microseconds
+            {"bid", row.tick.bid},
+            {"ask", row.tick.ask},
+            {"last", row.tick.last},
+            {"volume", row.tick.volume}
+        }.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+        insertSql += '\n';
+    }
+    return execute(insertSql, "Insert ticks").has_value();
+}
+
+bool ClickHouseHistoryRepository::insertCandles(const std::vector<CandleRow>& rows) {
+    if (rows.empty()) {
+        return true;
+    }
+    std::string insertSql = "INSERT INTO " + database_ + ".candles_1m FORMAT JSONEachRow\n";
+    for (const auto& row : rows) {
+        insertSql += nlohmann::json{
+            {"symbol", row.symbol},
+            {"open_time", row.candle.openTime},  // DateTime: seconds
+            {"open", row.candle.open},
+            {"high", row.candle.high},
+            {"low", row.candle.low},
+            {"close", row.candle.close},
+            {"volume", row.candle.volume}
+        }.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+        insertSql += '\n';
+    }
+    return execute(insertSql, "Insert candles").has_value();
+}
+
+bool ClickHouseHistoryRepository::logOrder(const OrderEvent& event) {
+    TRACE_SPAN("clickhouse.enqueue");
+    std::cout << "[OrderLog] Queuing order event for background logging. Key: " << event.idempKey << std::endl;
     try {
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            log_queue_.push({idempKey, status, orderId, resultJson});
-        }
-        queue_cond_.notify_one();
+        OrderEvent queued = event;
+        queued.eventType = queued.eventType == "CANCEL" ? "CANCEL" : "PLACE";
+        queued.status = enumLabel(queued.status, kOrderStatuses);
+        queued.side = enumLabel(queued.side, kOrderSides);
+        queued.type = enumLabel(queued.type, kOrderTypes);
+        queued.tsMs = queued.tsMs ? queued.tsMs : nowMillis();
+        queued.placedAtMs = queued.placedAtMs ? queued.placedAtMs : queued.tsMs;
+        order_queue_.push(std::move(queued));
         return true;
     } catch (const std::exception& e) {
         std::cerr << "[OrderLog] Failed to queue order log: " << e.what() << std::endl;
@@ -769,6 +1177,10 @@ bool ClickHouseHistoryRepository::logOrder(const std::string& idempKey, const st
     }
 }
 
+size_t ClickHouseHistoryRepository::pendingWrites() const {
+    return order_queue_.size();
+}
+
 void ClickHouseHistoryRepository::startWriterThread() {
     stop_writer_ = false;
     writer_thread_ = std::thread(&ClickHouseHistoryRepository::writerLoop, this);
@@ -778,7 +1190,7 @@ void ClickHouseHistoryRepository::startWriterThread() {
 void ClickHouseHistoryRepository::stopWriterThread() {
     std::cout << "[ClickHouse] Stopping writer thread..." << std::endl;
     stop_writer_ = true;
-    queue_cond_.notify_one();
+    order_queue_.close();
     if (writer_thread_.joinable()) {
         writer_thread_.join();
         std::cout << "[ClickHouse] Writer thread stopped." << std::endl;
@@ -787,208 +1199,152 @@ void ClickHouseHistoryRepository::stopWriterThread() {
 
 void ClickHouseHistoryRepository::writerLoop() {
     std::cout << "[DBWriter] Writer thread started." << std::endl;
+    trading::infrastructure::metrics::TraceRecorder::instance().nameThread("clickhouse-writer");
 
-    while (!stop_writer_) {
-        OrderLogData data;
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cond_.wait(lock, [this] { return !log_queue_.empty() || stop_writer_; });
+    // Whatever queued up during the previous insert goes out in one batch
+    std::vector<OrderEvent> batch;
+    uint32_t attempts = 0;
+    while (order_queue_.waitBatch(batch, kOrderEventBatch)) {
+        bool written = false;
+        try {
+            TRACE_SPAN("clickhouse.insert");
 
-            if (stop_writer_ && log_queue_.empty()) {
-                return;
+            if (!connected_) {
+                writes_skipped_.fetch_add(batch.size(), std::memory_order_relaxed);
+                std::cout << "[DBWriter] ⚠️  Not connected, skipping " << batch.size() << " order events" << std::endl;
+                batch.clear();
+                continue;
             }
-
-            data = log_queue_.front();
-            log_queue_.pop();
+            std::cout << "[DBWriter] Attempting insert of " << batch.size() << " order events" << std::endl;
+            written = insertOrderEvents(batch);
+        } catch (const std::exception& e) {
+            std::cerr << "[DBWriter] Failed to write " << batch.size() << " order events to ClickHouse: " << e.what() << std::endl;
         }
 
-        try {
-            auto now = std::chrono::system_clock::now();
-            auto timestamp = std::chrono::system_clock::to_time_t(now);
-
-            // Use HTTP API for background logging
-            if (connected_) {
-                std::string insertSql = "INSERT INTO " + database_ + ".orders_log VALUES ('" + 
-                    data.idempKey + "', " + std::to_string(timestamp) + ", '" + 
-                    data.status + "', '" + data.orderId + "', '" + data.resultJson + "')";
-
-                std::cout << "[DBWriter] Attempting HTTP insert for: " << data.idempKey << std::endl;
-
-                try {
-                    auto response = cpr::Post(
-                        cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-                        cpr::Body{insertSql}
-                    );
-
-                    if (response.status_code == 200) {
-                        std::cout << "[DBWriter] ✅ Successfully inserted: " << data.idempKey << std::endl;
-                    } else {
-                        std::cerr << "[DBWriter] ❌ HTTP " << response.status_code << " for " 
-                                  << data.idempKey << ": " << response.text << std::endl;
-                    }
-                } catch (const std::exception& http_e) {
-                    std::cerr << "[DBWriter] ❌ HTTP exception for " << data.idempKey 
-                              << ": " << http_e.what() << std::endl;
-                }
-            } else {
-                std::cout << "[DBWriter] ⚠️  Not connected, skipping: " << data.idempKey << std::endl;
-            }
-
-        } catch (const std::exception& e) {
-            std::cerr << "[DBWriter] Failed to write order log " << data.idempKey << " to ClickHouse: " << e.what() << std::endl;
+        if (written) {
+            writes_ok_.fetch_add(batch.size(), std::memory_order_relaxed);
+            std::cout << "[DBWriter] ✅ Successfully inserted " << batch.size() << " order events" << std::endl;
+            attempts = 0;
+        } else if (++attempts < kOrderEventAttempts && !stop_writer_) {
+            // Back at the head of the queue, so the retry keeps the events in order
+            writes_retried_.fetch_add(batch.size(), std::memory_order_relaxed);
+            order_queue_.requeue(std::move(batch), OrderEventQueue::Clock::now() + kOrderEventRetryDelay);
+        } else {
+            writes_failed_.fetch_add(batch.size(), std::memory_order_relaxed);
+            std::cerr << "[DBWriter] Dropping " << batch.size() << " order events after " << attempts << " attempts" << std::endl;
+            attempts = 0;
         }
+        batch.clear();
     }
 
     std::cout << "[DBWriter] Writer thread exiting." << std::endl;
 }
 
-std::vector<nlohmann::json> ClickHouseHistoryRepository::getOrderHistory(const std::string& fromTime, const std::string& toTime, int32_t limit) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
-    std::vector<nlohmann::json> orderHistory;
-    
-    if (!connected_) {
-        std::cout << "[OrderHistory] Not connected, returning empty result" << std::endl;
-        return orderHistory;
+bool ClickHouseHistoryRepository::insertOrderEvents(const std::vector<OrderEvent>& batch) {
+    // JSONEachRow keeps client-supplied strings out of the SQL text
+    std::string insertSql = "INSERT INTO " + database_ + ".order_events FORMAT JSONEachRow\n";
+    for (const auto& event : batch) {
+        insertSql += nlohmann::json{
+            {"order_id", event.orderId},
+            {"ts", event.tsMs},  // DateTime64(3): epoch milliseconds
+            {"placed_at", event.placedAtMs},
+            {"event_type", event.eventType},
+            {"status", event.status},
+            {"idemp_key", event.idempKey},
+            {"symbol", event.symbol},
+            {"side", event.side},
+            {"type", event.type},
+            {"quantity", event.quantity},
+            {"price", event.price},
+            {"account_id", event.accountId},
+            {"session_id", event.sessionId}
+        }.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+        insertSql += '\n';
     }
 
-    try {
-        std::stringstream sql;
-        
-        // Get latest status for each order (important for canceled orders)
-        sql << "SELECT "
-            << "  ol1.order_id, "
-            << "  ol1.idemp_key, "
-            << "  ol1.ts, "
-            << "  ol1.status, "
-            << "  ol1.result "
-            << "FROM " << database_ << ".orders_log ol1 "
-            << "INNER JOIN ( "
-            << "  SELECT order_id, MAX(ts) as max_ts "
-            << "  FROM " << database_ << ".orders_log ";
-        
-        if (!fromTime.empty() && !toTime.empty()) {
-            sql << "  WHERE ts >= '" << fromTime << "' AND ts <= '" << toTime << "' ";
-        } else if (!fromTime.empty()) {
-            sql << "  WHERE ts >= '" << fromTime << "' ";
-        } else if (!toTime.empty()) {
-            sql << "  WHERE ts <= '" << toTime << "' ";
-        }
-        
-        sql << "  GROUP BY order_id "
-            << ") ol2 ON ol1.order_id = ol2.order_id AND ol1.ts = ol2.max_ts "
-            << "ORDER BY ol1.ts DESC LIMIT " << limit << " FORMAT JSON";
+    auto response = send(writer_session_, insertSql, {});
+    if (response.status_code != 200) {
+        std::cerr << "[DBWriter] ❌ HTTP " << response.status_code << " for "
+                  << batch.size() << " order events: " << response.text << std::endl;
+        return false;
+    }
+    return true;
+}
 
-        std::cout << "[OrderHistory] Executing HTTP query: " << sql.str() << std::endl;
+std::vector<nlohmann::json> ClickHouseHistoryRepository::getOrderHistory(const std::string& fromTime, const std::string& toTime, int32_t limit) {
+    auto [from, to] = orderHistoryRange(fromTime, toTime);
+    uint32_t rows = static_cast<uint32_t>(std::max(limit, 0));
+    std::string key = std::to_string(from.time_since_epoch().count()) + '|' + std::to_string(to.time_since_epoch().count()) + '|' +
+                      std::to_string(rows);
+    return guardedRead("Order history fetch", order_history_cache_, key, [&] { return readOrderHistory(from, to, rows); });
+}
 
-        auto response = cpr::Post(
-            cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-            cpr::Body{sql.str()}
-        );
+std::vector<nlohmann::json> ClickHouseHistoryRepository::readOrderHistory(std::chrono::sys_seconds from, std::chrono::sys_seconds to,
+                                                                          uint32_t limit) {
+    std::cout << "[OrderHistory] Executing HTTP query: " << statements_.orderHistory.sql() << std::endl;
 
-        if (response.status_code == 200) {
-            std::cout << "[OrderHistory] HTTP query successful, parsing JSON..." << std::endl;
-            
-            // Parse JSON response from ClickHouse
-            auto jsonResponse = nlohmann::json::parse(response.text);
-            auto data = jsonResponse["data"];
-            
-            for (const auto& row : data) {
-                nlohmann::json orderRecord;
-                orderRecord["idemp_key"] = row.value("idemp_key", "");
-                orderRecord["timestamp"] = row.value("ts", "");
-                orderRecord["status"] = row.value("status", "");
-                orderRecord["order_id"] = row.value("order_id", "");
-                
-                // Parse result JSON if available
-                try {
-                    auto resultJson = nlohmann::json::parse(row.value("result", "{}"));
-                    orderRecord["result"] = resultJson;
-                    
-                    // Extract order details for display (especially important for cancelled orders)
-                    if (resultJson.is_object()) {
-                        orderRecord["symbol"] = resultJson.value("symbol", "");
-                        orderRecord["side"] = resultJson.value("side", "");
-                        orderRecord["price"] = resultJson.value("price", 0.0);
-                        orderRecord["quantity"] = resultJson.value("quantity", 0.0);
-                        orderRecord["type"] = resultJson.value("type", "");
-                    }
-                } catch (...) {
-                    orderRecord["result"] = nlohmann::json::object();
-                    orderRecord["symbol"] = "";
-                    orderRecord["side"] = "";
-                    orderRecord["price"] = 0.0;
-                    orderRecord["quantity"] = 0.0;
-                    orderRecord["type"] = "";
-                }
-                
-                orderHistory.push_back(orderRecord);
-            }
-            
-            std::cout << "[OrderHistory] Parsed " << orderHistory.size() << " order records from HTTP response" << std::endl;
-        } else {
-            std::cerr << "[OrderHistory] HTTP query failed (status " << response.status_code << "): " << response.text << std::endl;
-        }
+    auto body = read(statements_.orderHistory.sql(), statements_.orderHistory.bind(from, to, limit));
+    std::cout << "[OrderHistory] HTTP query successful, parsing JSON..." << std::endl;
 
-    } catch (const std::exception& e) {
-        logError("Order history fetch", e);
+    std::vector<nlohmann::json> orderHistory;
+    auto jsonResponse = nlohmann::json::parse(body);
+    for (const auto& row : jsonResponse["data"]) {
+        nlohmann::json orderRecord;
+        orderRecord["idemp_key"] = row.value("idemp_key", "");
+        orderRecord["timestamp"] = row.value("updated_at", "");
+        orderRecord["placed_at"] = row.value("placed_at", "");
+        orderRecord["status"] = row.value("status", "");
+        orderRecord["order_id"] = row.value("order_id", "");
+        orderRecord["symbol"] = row.value("symbol", "");
+        orderRecord["side"] = row.value("side", "");
+        orderRecord["type"] = row.value("type", "");
+        orderRecord["price"] = row.value("price", 0.0);
+        orderRecord["quantity"] = row.value("quantity", 0.0);
+        orderRecord["account_id"] = row.value("account_id", "");
+        orderRecord["session_id"] = row.value("session_id", "");
+        orderHistory.push_back(std::move(orderRecord));
     }
 
+    std::cout << "[OrderHistory] Parsed " << orderHistory.size() << " order records from HTTP response" << std::endl;
     return orderHistory;
 }
 
-std::optional<nlohmann::json> ClickHouseHistoryRepository::getOrderDetails(const std::string& orderId) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
-    
-    if (!connected_) {
-        std::cout << "[OrderDetails] Not connected, returning empty result" << std::endl;
-        return std::nullopt;
+std::optional<OrderEvent> ClickHouseHistoryRepository::getOrderDetails(const std::string& orderId) {
+    // order_events has an order only once the writer has flushed it
+    if (auto recent = order_queue_.recent(orderId)) {
+        return recent;
     }
+    return guardedRead("Order details fetch", order_details_cache_, orderId, [&] { return readOrderDetails(orderId); });
+}
 
-    try {
-        std::stringstream sql;
-        sql << "SELECT idemp_key, ts, status, order_id, result FROM " << database_ << ".orders_log "
-            << "WHERE order_id = '" << orderId << "' "
-            << "ORDER BY ts DESC LIMIT 1 FORMAT JSON";
-
-        std::cout << "[OrderDetails] Executing HTTP query: " << sql.str() << std::endl;
-
-        auto response = cpr::Post(
-            cpr::Url{"http://" + host_ + ":" + std::to_string(port_)},
-            cpr::Body{sql.str()}
-        );
-
-        if (response.status_code == 200) {
-            auto jsonResponse = nlohmann::json::parse(response.text);
-            auto data = jsonResponse["data"];
-            
-            if (!data.empty()) {
-                auto row = data[0];
-                nlohmann::json orderDetails;
-                orderDetails["idemp_key"] = row.value("idemp_key", "");
-                orderDetails["timestamp"] = row.value("ts", "");
-                orderDetails["status"] = row.value("status", "");
-                orderDetails["order_id"] = row.value("order_id", "");
-                
-                // Parse result JSON if available
-                try {
-                    auto resultJson = nlohmann::json::parse(row.value("result", "{}"));
-                    orderDetails["result"] = resultJson;
-                } catch (...) {
-                    orderDetails["result"] = nlohmann::json::object();
-                }
-                
-                std::cout << "[OrderDetails] Found order details for: " << orderId << std::endl;
-                return orderDetails;
-            }
-        } else {
-            std::cerr << "[OrderDetails] HTTP query failed (status " << response.status_code << "): " << response.text << std::endl;
-        }
+std::optional<OrderEvent> ClickHouseHistoryRepository::readOrderDetails(const std::string& orderId) {
+    std::cout << "[OrderDetails] Executing HTTP query for " << orderId << ": " << statements_.orderDetails.sql() << std::endl;
 
-    } catch (const std::exception& e) {
-        logError("Order details fetch", e);
+    auto body = read(statements_.orderDetails.sql(), statements_.orderDetails.bind(orderId));
+    auto jsonResponse = nlohmann::json::parse(body);
+    const auto& data = jsonResponse["data"];
+    if (data.empty()) {
+        return std::nullopt;
     }
 
-    return std::nullopt;
+    const auto& row = data[0];
+    OrderEvent event;
+    event.orderId = row.value("order_id", "");
+    event.tsMs = parseMillis(row.value("ts", ""));
+    event.placedAtMs = parseMillis(row.value("placed_at", ""));
+    event.eventType = row.value("event_type", "PLACE");
+    event.status = row.value("status", "UNKNOWN");
+    event.idempKey = row.value("idemp_key", "");
+    event.symbol = row.value("symbol", "");
+    event.side = row.value("side", "UNKNOWN");
+    event.type = row.value("type", "UNKNOWN");
+    event.quantity = row.value("quantity", 0.0);
+    event.price = row.value("price", 0.0);
+    event.accountId = row.value("account_id", "");
+    event.sessionId = row.value("session_id", "");
+
+    std::cout << "[OrderDetails] Found order details for: " << orderId << std::endl;
+    return event;
 }
 
 } // namespace trading::infrastructure::database
@@ -1,59 +1,195 @@
 #pragma once
 
 #include "../../domain/interfaces.hpp"
+#include "../cache/lru_cache.hpp"
+#include "circuit_breaker.hpp"
+#include "clickhouse_client_pool.hpp"
+#include "clickhouse_statements.hpp"
+#include "history_cache_key.hpp"
+#include "http_compression.hpp"
+#include "order_event_queue.hpp"
+#include <chrono>
+#include <cpr/cpr.h>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <atomic>
 #include <condition_variable>
 #include <optional>
 #include <nlohmann/json.hpp>
 
-// Using HTTP API for ClickHouse - no native client needed
+// HTTP API for ClickHouse; ClickHouseNativeRepository (clickhouse_native_repository.hpp)
+// moves the reads and inserts to the native protocol when clickhouse-cpp is available
 
 namespace trading::infrastructure::database {
 
-// Data to be passed to the writer thread
-struct OrderLogData {
-    std::string idempKey;
-    std::string status;
-    std::string orderId;
-    std::string resultJson;
+// One row of ticks; tick.ts is in milliseconds
+struct TickRow {
+    std::string symbol;
+    trading::domain::Tick tick;
 };
 
+// One row of candles_1m; candle.openTime is in seconds
+struct CandleRow {
+    std::string symbol;
+    trading::domain::Candle candle;
+};
+
+// Which client a repository created from the environment speaks
+enum class ClickHouseProtocol { HTTP, NATIVE };
+
+// Concurrent reads allowed when CLICKHOUSE_MAX_READERS is not set
+inline constexpr size_t kDefaultMaxReaders = 16;
+
+// Deadlines and failure handling. A read that fails in transport, times out
+// or gets a 5xx counts against the circuit breaker. While the breaker is open,
+// reads fail fast and return the last result cached for the same request, if
+// there is one. A zero timeout waits indefinitely.
+struct ClickHouseHealthConfig {
+    std::chrono::milliseconds queryTimeout{2000};   // Per read, connecting included
+    std::chrono::milliseconds writeTimeout{30000};  // Per migration step, mock data or order event insert
+    std::chrono::milliseconds probeTimeout{500};    // Per health probe
+    std::chrono::milliseconds probeInterval{1000};  // Between health probes; 0 runs no prober
+    CircuitBreakerConfig breaker;
+};
+
+// ClickHouse refused the query itself (HTTP 4xx), e.g. a parameter out of
+// range for its column. Says nothing about the server's health, so it goes
+// back to the caller and leaves the breaker alone.
+class ClickHouseQueryError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Results kept per read kind for serving while ClickHouse is unhealthy
+inline constexpr size_t kReadCacheEntries = 256;
+
 class ClickHouseHistoryRepository : public trading::domain::IHistoryRepository {
-private:
-    // Using HTTP API - no native client needed
-    mutable std::mutex client_mutex_; // For synchronization
-    
-    // For background writer thread
-    std::queue<OrderLogData> log_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable queue_cond_;
-    std::thread writer_thread_;
-    std::atomic<bool> stop_writer_;
+protected:
+    // Serializes the write path: schema migrations and mock data loads.
+    // Reads never take it, and the writer thread has its own client.
+    mutable std::mutex write_mutex_;
 
     std::string host_;
     int port_;
     std::string database_;
     std::string user_;
     std::string password_;
-    bool connected_;
+    std::atomic<bool> connected_;
+    HttpCompression compression_;
+    size_t max_readers_;
+    ClickHouseHealthConfig health_;
+
+    // Bulk inserts, one statement each, called with write_mutex_ held;
+    // ticks and candles come from generateMockData
+    virtual bool insertTicks(const std::vector<TickRow>& rows);
+    virtual bool insertCandles(const std::vector<CandleRow>& rows);
+    // One batch of the writer thread; called on that thread only
+    virtual bool insertOrderEvents(const std::vector<OrderEvent>& batch);
+
+    // A subclass overriding insertOrderEvents stops the writer in its own
+    // destructor, before its members go
+    void stopWriterThread();
+
+    // One round trip each; they throw on any failure, including a timeout.
+    // The public read methods wrap them with the breaker and the caches.
+    virtual std::vector<trading::domain::Candle> readCandles(const trading::domain::Symbol& symbol,
+                                                             const trading::domain::HistoryQuery& query);
+    virtual std::vector<trading::domain::Candle> readLatest(const std::vector<std::string>& codes, uint32_t limit);
+    virtual std::vector<nlohmann::json> readOrderHistory(std::chrono::sys_seconds from, std::chrono::sys_seconds to,
+                                                         uint32_t limit);
+    virtual std::optional<OrderEvent> readOrderDetails(const std::string& orderId);
+
+private:
+    // For background writer thread
+    OrderEventQueue order_queue_;
+    std::thread writer_thread_;
+    std::atomic<bool> stop_writer_;
+    std::atomic<uint64_t> writes_ok_{0};
+    std::atomic<uint64_t> writes_failed_{0};   // Dropped after their last attempt
+    std::atomic<uint64_t> writes_retried_{0};  // Requeued after a failed attempt
+    std::atomic<uint64_t> writes_skipped_{0};  // Dropped while disconnected
+
+    std::atomic<uint32_t> schema_version_{0};  // Set by the warm-up thread, read by RPC threads
+    std::atomic<uint64_t> bytes_sent_{0};      // HTTP bodies as sent, after compression
+    std::atomic<uint64_t> bytes_received_{0};  // HTTP bodies as received, before decoding
+
+    // Read queries, built once for database_; values are bound per call
+    std::string endpoint_;                             // http://host:port
+    ClickHouseStatements statements_;
+
+    // One HTTP session per concurrent reader, plus one for the write path
+    // (under write_mutex_) and one for the writer thread; sessions keep
+    // their connections alive between requests
+    ClickHouseClientPool<cpr::Session> read_sessions_;
+    cpr::Session write_session_;
+    cpr::Session writer_session_;
+
+    // Read health: the breaker, the last good result per request and the
+    // prober thread that pings the server in the background
+    CircuitBreaker breaker_;
+    trading::infrastructure::cache::LruCache<std::vector<trading::domain::Candle>> candle_cache_;  // fetch and latest
+    trading::infrastructure::cache::LruCache<std::vector<nlohmann::json>> order_history_cache_;
+    trading::infrastructure::cache::LruCache<std::optional<OrderEvent>> order_details_cache_;
+    std::atomic<uint64_t> reads_failed_{0};
+    std::atomic<uint64_t> stale_reads_{0};  // Served from a cache after a failure or while open
+    std::thread prober_thread_;
+    std::mutex prober_mutex_;
+    std::condition_variable prober_cond_;
+    bool stop_prober_ = false;
 
     // Helper methods
     trading::domain::Interval stringToInterval(const std::string& interval) const;
     std::string intervalToString(trading::domain::Interval interval) const;
 
-    // parseCandlesFromBlock method removed - using HTTP API instead of native client
-    
+    // Schema migrations, applied in version order by createTables with the lock
+    // held and recorded in schema_migrations so each runs once per database
+    bool migrate();
+    // 1: candles_1m, ticks and the legacy orders_log
+    bool createBaseTables();
+    // 2: 5m/15m/1h/1d candle tables fed from candles_1m by materialized views
+    bool createCandleRollups();
+    // 3: order_events plus orders_latest, the latest state per order, backfilled
+    // from orders_log
+    bool createOrderEvents();
+    // 4: the rollups rebuilt from the candles written before their views
+    bool backfillCandleRollups();
+    // The aggregating SELECT of a rollup's view and backfill
+    std::string rollupSelect(const CandleRollup& rollup) const;
+    std::unique_ptr<cpr::Session> createSession() const;
+    // POSTs `body` on `session` with compression_ applied; the response text
+    // comes back decoded
+    cpr::Response send(cpr::Session& session, const std::string& body, cpr::Parameters parameters);
+    // A write path statement on write_session_, with write_mutex_ held
+    cpr::Response post(const std::string& body, cpr::Parameters parameters = {});
+    // The body of a read on a leased session, within queryTimeout; waits
+    // while max_readers_ reads are running. Throws on a failed request.
+    std::string read(const std::string& sql, cpr::Parameters parameters);
+    // Response body, or nullopt after logging the failure of `operation`
+    std::optional<std::string> execute(const std::string& sql, const std::string& operation);
+
     // Writer thread methods
     void startWriterThread();
-    void stopWriterThread();
     void writerLoop();
 
+    // Runs `read` unless the breaker refuses it. A success is cached under
+    // `key`; a failure, or a refusal, returns the cached value or Value{}.
+    // A ClickHouseQueryError is rethrown.
+    template <typename Value, typename Read>
+    Value guardedRead(const char* operation, trading::infrastructure::cache::LruCache<Value>& cache,
+                      const std::string& key, Read&& read);
+    // GET /ping within probeTimeout
+    bool ping();
+    // Pings every probeInterval: a failure opens the breaker, a success ends
+    // its wait and marks a repository that lost or never had its connection
+    // as connected again
+    void proberLoop();
+    void stopProber();
+
+protected:
     // Configuration helpers
     static std::string getEnvVar(const std::string& name, const std::string& defaultValue);
     static int getEnvVarInt(const std::string& name, int defaultValue);
@@ -62,21 +198,44 @@ public:
     // Constructor with environment variable support
     ClickHouseHistoryRepository(const std::string& host = "", 
                                int port = 0, 
-                               const std::string& database = "");
+                               const std::string& database = "",
+                               HttpCompression compression = HttpCompression::NONE,
+                               size_t maxReaders = kDefaultMaxReaders,
+                               ClickHouseHealthConfig health = {});
     
-    // Static factory method for environment-based configuration
+    // Starts the order writer and, with a probe interval, the health prober.
+    // They use members a subclass sets up, and the writer calls its
+    // insertOrderEvents, so call this once construction has finished;
+    // createFromEnvironment does. Later calls do nothing.
+    void start();
+
+    // Static factory method for environment-based configuration.
+    // CLICKHOUSE_PROTOCOL=native returns a ClickHouseNativeRepository when
+    // built with clickhouse-cpp, and this HTTP repository otherwise.
+    // CLICKHOUSE_MAX_READERS bounds the reads running at once;
+    // CLICKHOUSE_QUERY_TIMEOUT_MS, CLICKHOUSE_WRITE_TIMEOUT_MS,
+    // CLICKHOUSE_PROBE_INTERVAL_MS, CLICKHOUSE_BREAKER_FAILURES and
+    // CLICKHOUSE_BREAKER_OPEN_MS set the ClickHouseHealthConfig. The
+    // repository comes back started.
     static std::unique_ptr<ClickHouseHistoryRepository> createFromEnvironment();
+
+    // Candle rows of a FORMAT JSON response; numeric columns may arrive as strings
+    static std::vector<trading::domain::Candle> parseCandlesJson(const std::string& body, trading::domain::Interval interval);
     
     ~ClickHouseHistoryRepository() override;
 
-    // IHistoryRepository interface implementation
+    // IHistoryRepository interface implementation. Reads never throw: while
+    // ClickHouse is unhealthy they return the last result cached for the
+    // same request, or nothing.
     std::vector<trading::domain::Candle> fetch(const trading::domain::Symbol& symbol, const trading::domain::HistoryQuery& query) override;
     std::vector<trading::domain::Candle> latest(const std::vector<trading::domain::Symbol>& symbols, int32_t limit) override;
 
     // Connection management
-    bool connect();
-    void disconnect();
+    virtual bool connect();
+    virtual void disconnect();
     bool isConnected() const { return connected_; }
+    // Whether reads are let through: the breaker is not open
+    bool isHealthy() const { return breaker_.state() != CircuitBreaker::State::OPEN; }
     bool reconnect();
 
     // Database schema management
@@ -86,17 +245,58 @@ public:
     // Mock data generation for testing/demo
     bool generateMockData();
     
-    // Order logging
-    bool logOrder(const std::string& idempKey, const std::string& status, const std::string& orderId, const std::string& resultJson);
+    // Highest schema migration applied by createTables
+    uint32_t schemaVersion() const { return schema_version_.load(std::memory_order_relaxed); }
+    
+    // Order logging; the writer thread inserts queued events in batches,
+    // starting once createTables has applied the schema
+    bool logOrder(const OrderEvent& event);
+    
+    // Writer backlog and outcomes, for metrics
+    size_t pendingWrites() const;
+    uint64_t writesOk() const { return writes_ok_.load(std::memory_order_relaxed); }
+    uint64_t writesFailed() const { return writes_failed_.load(std::memory_order_relaxed); }
+    uint64_t writesSkipped() const { return writes_skipped_.load(std::memory_order_relaxed); }
+    uint64_t writesRetried() const { return writes_retried_.load(std::memory_order_relaxed); }
+    // Dropped from a full queue, oldest first
+    uint64_t writesDropped() const { return order_queue_.dropped(); }
+
+    // HTTP body bytes on the wire, for metrics
+    HttpCompression compression() const { return compression_; }
+    uint64_t bytesSent() const { return bytes_sent_.load(std::memory_order_relaxed); }
+    uint64_t bytesReceived() const { return bytes_received_.load(std::memory_order_relaxed); }
+
+    // Read concurrency, for metrics
+    size_t maxReaders() const { return max_readers_; }
+    virtual size_t readsInFlight() const { return read_sessions_.inUse(); }
+    // Reads that waited for one of the maxReaders() slots
+    virtual uint64_t readWaits() const { return read_sessions_.waits(); }
+
+    // Read health, for metrics
+    CircuitBreaker::State circuitState() const { return breaker_.state(); }
+    uint64_t circuitOpened() const { return breaker_.opened(); }
+    uint64_t readsRejected() const { return breaker_.rejected(); }
+    uint64_t readsFailed() const { return reads_failed_.load(std::memory_order_relaxed); }
+    uint64_t staleReads() const { return stale_reads_.load(std::memory_order_relaxed); }
+    const ClickHouseHealthConfig& healthConfig() const { return health_; }
     
-    // Order history
+    // Latest state of the orders placed in [fromTime, toTime], newest first
     std::vector<nlohmann::json> getOrderHistory(const std::string& fromTime = "", const std::string& toTime = "", int32_t limit = 100);
     
-    // Get specific order details for cancellation
-    std::optional<nlohmann::json> getOrderDetails(const std::string& orderId);
+    // Latest event of an order, for cancellation: the one logged most recently
+    // by this process, queued or written, else the one in order_events
+    std::optional<OrderEvent> getOrderDetails(const std::string& orderId);
 
-private:
+    virtual ClickHouseProtocol protocol() const { return ClickHouseProtocol::HTTP; }
+
+protected:
     void logError(const std::string& operation, const std::exception& e) const;
+    // DateTime64(3) text, UTC, for replies; inserts send epoch numbers instead
+    static std::string formatMillis(int64_t ms);
+    // Bounds of an order history read, whole seconds widened to keep every
+    // order inside the requested range; empty bounds span every DateTime
+    static std::pair<std::chrono::sys_seconds, std::chrono::sys_seconds> orderHistoryRange(const std::string& fromTime,
+                                                                                          const std::string& toTime);
 };
 
 } // namespace trading::infrastructure::database
@@ -0,0 +1,94 @@
+#include "clickhouse_statements.hpp"
+
+namespace trading::infrastructure::database {
+
+namespace {
+
+const CandleRollup* rollupFor(trading::domain::Interval interval) {
+    for (const auto& rollup : kCandleRollups) {
+        if (rollup.interval == interval) {
+            return &rollup;
+        }
+    }
+    return nullptr;
+}
+
+// The coarsest rollup whose candles tile a bucket; null when only candles_1m does
+const CandleRollup* rollupForBucket(int64_t bucketSeconds) {
+    const CandleRollup* best = nullptr;
+    for (const auto& rollup : kCandleRollups) {
+        if (bucketSeconds % rollup.seconds == 0) {
+            best = &rollup;
+        }
+    }
+    return best;
+}
+
+// Column list shared by the order history and details reads
+constexpr const char* kOrderColumns =
+    "order_id, idemp_key, placed_at, status, symbol, side, type, quantity, price, account_id, session_id";
+
+std::string candlesSql(const std::string& database, std::string_view format) {
+    return "SELECT open_time, open, high, low, close, volume FROM " + database + ".candles_1m "
+           "WHERE symbol = {symbol:String} AND open_time >= {from:DateTime} AND open_time <= {to:DateTime} "
+           "ORDER BY open_time DESC LIMIT {limit:UInt32}" + std::string(format);
+}
+
+// Candles aggregated from `table` (candles_1m without a rollup) into buckets
+// of {bucket:Int64} seconds, or into the table's own rows. Rollups finish the
+// aggregation of parts the engine has not merged yet.
+std::string aggregatedCandlesSql(const std::string& database, const CandleRollup* rollup, bool bucketed, std::string_view format) {
+    std::string bucket = bucketed
+        ? "toDateTime(toUnixTimestamp(r.open_time) - toUnixTimestamp(r.open_time) % {bucket:Int64})"
+        : "r.open_time";
+    return "SELECT " + bucket + " AS open_time, " +
+           (rollup ? "argMinMerge(r.open)" : "argMin(r.open, r.open_time)") + " AS open, "
+           "max(r.high) AS high, min(r.low) AS low, " +
+           (rollup ? "argMaxMerge(r.close)" : "argMax(r.close, r.open_time)") + " AS close, "
+           "sum(r.volume) AS volume FROM " + database + "." + (rollup ? rollup->table : "candles_1m") + " AS r "
+           "WHERE r.symbol = {symbol:String} AND r.open_time >= {from:DateTime} AND r.open_time <= {to:DateTime} "
+           "GROUP BY " + bucket + " ORDER BY open_time DESC LIMIT {limit:UInt32}" + std::string(format);
+}
+
+} // namespace
+
+ClickHouseStatements::ClickHouseStatements(const std::string& database, std::string_view format)
+    : latest("SELECT symbol, open_time, open, high, low, close, volume FROM " + database + ".candles_1m "
+             "WHERE symbol IN {symbols:Array(String)} ORDER BY open_time DESC LIMIT {limit:UInt32}" + std::string(format),
+             {"symbols", "limit"}),
+      // FINAL collapses the versions of an order not merged yet; the read
+      // follows the (placed_at, order_id) key, newest first
+      orderHistory(std::string("SELECT ") + kOrderColumns + ", updated_at FROM " + database + ".orders_latest FINAL "
+                   "WHERE placed_at >= {from:DateTime} AND placed_at <= {to:DateTime} "
+                   "ORDER BY placed_at DESC, order_id DESC LIMIT {limit:UInt32}" + std::string(format),
+                   {"from", "to", "limit"}),
+      // A point read on the (order_id, ts) key of order_events
+      orderDetails(std::string("SELECT ") + kOrderColumns + ", ts, event_type FROM " + database + ".order_events "
+                   "WHERE order_id = {order_id:String} ORDER BY ts DESC LIMIT 1" + std::string(format),
+                   {"order_id"}),
+      candles_(candlesSql(database, format), {"symbol", "from", "to", "limit"}) {
+
+    buckets_.emplace_back(aggregatedCandlesSql(database, nullptr, true, format),
+                          std::array<std::string_view, 5>{"symbol", "from", "to", "bucket", "limit"});
+    for (const auto& rollup : kCandleRollups) {
+        rollups_.emplace_back(aggregatedCandlesSql(database, &rollup, false, format),
+                              std::array<std::string_view, 4>{"symbol", "from", "to", "limit"});
+        buckets_.emplace_back(aggregatedCandlesSql(database, &rollup, true, format),
+                              std::array<std::string_view, 5>{"symbol", "from", "to", "bucket", "limit"});
+    }
+}
+
+ClickHouseStatements::Selection ClickHouseStatements::select(const trading::domain::HistoryQuery& query) const {
+    // Downsampled queries aggregate from the coarsest table that tiles the
+    // bucket; buckets below a minute are left to the caller
+    int64_t bucket = query.bucketSeconds > 60 && query.bucketSeconds % 60 == 0 ? query.bucketSeconds : 0;
+    const CandleRollup* rollup = bucket ? rollupForBucket(bucket) : rollupFor(query.interval);
+    size_t rollupIndex = rollup ? static_cast<size_t>(rollup - kCandleRollups) : 0;
+
+    if (bucket && bucket != (rollup ? rollup->seconds : 60)) {
+        return {nullptr, &buckets_[rollup ? rollupIndex + 1 : 0], bucket};
+    }
+    return {rollup ? &rollups_[rollupIndex] : &candles_, nullptr, 0};
+}
+
+} // namespace trading::infrastructure::database
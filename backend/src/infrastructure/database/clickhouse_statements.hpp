@@ -0,0 +1,85 @@
+#pragma once
+
+#include "../../domain/types.hpp"
+#include "clickhouse_query.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace trading::infrastructure::database {
+
+// Coarser candle tables rolled up from candles_1m by materialized views. Rows
+// hold partial aggregates (open/close as argMin/argMax states keyed by
+// open_time), so a read merges whatever parts have not been merged yet.
+struct CandleRollup {
+    trading::domain::Interval interval;
+    int64_t seconds;
+    const char* table;
+    const char* bucket;   // ClickHouse function truncating open_time to the interval
+    const char* ttl;      // Empty keeps rows forever
+};
+
+inline constexpr CandleRollup kCandleRollups[] = {
+    {trading::domain::Interval::M5, 300, "candles_5m", "toStartOfFiveMinutes", "INTERVAL 1 YEAR"},
+    {trading::domain::Interval::M15, 900, "candles_15m", "toStartOfFifteenMinutes", "INTERVAL 2 YEAR"},
+    {trading::domain::Interval::H1, 3600, "candles_1h", "toStartOfHour", "INTERVAL 5 YEAR"},
+    {trading::domain::Interval::D1, 86400, "candles_1d", "toStartOfDay", ""},
+};
+
+// Labels of the order_events Enum8 columns, indexed by value; UNKNOWN (0) is the fallback
+inline constexpr const char* kOrderStatuses[] = {"UNKNOWN", "ACK", "FILLED", "REJECTED", "CANCELLED"};
+inline constexpr const char* kOrderSides[] = {"UNKNOWN", "BUY", "SELL"};
+inline constexpr const char* kOrderTypes[] = {"UNKNOWN", "MARKET", "LIMIT"};
+
+// symbol, from, to, limit
+using CandlesQuery = ClickHouseQuery<std::string, std::chrono::sys_seconds, std::chrono::sys_seconds, uint32_t>;
+// symbol, from, to, bucket seconds, limit
+using BucketedCandlesQuery = ClickHouseQuery<std::string, std::chrono::sys_seconds, std::chrono::sys_seconds, int64_t, uint32_t>;
+
+// The read queries of one database, built once and shared by the HTTP and
+// native repositories. `format` ends every SELECT: " FORMAT JSON" over HTTP,
+// empty over the native protocol, whose results are always blocks.
+class ClickHouseStatements {
+public:
+    ClickHouseStatements(const std::string& database, std::string_view format);
+
+    // Calls run(query, values...) with the query serving `query` and the
+    // values to bind to it: candles_1m rows, a rollup at its own interval, or
+    // either aggregated into wider buckets. Returns what run returns.
+    template <typename Run>
+    decltype(auto) candles(const trading::domain::Symbol& symbol, const trading::domain::HistoryQuery& query, Run&& run) const {
+        std::chrono::sys_seconds from{std::chrono::seconds(query.fromTs)};
+        std::chrono::sys_seconds to{std::chrono::seconds(query.toTs)};
+        uint32_t limit = static_cast<uint32_t>(std::max(query.limit, 0));
+        auto [candles, bucketed, bucket] = select(query);
+        if (bucketed) {
+            return run(*bucketed, symbol.code, from, to, bucket, limit);
+        }
+        return run(*candles, symbol.code, from, to, limit);
+    }
+
+    // Latest candles_1m rows of some symbols: symbols, limit
+    ClickHouseQuery<std::vector<std::string>, uint32_t> latest;
+    // Latest state of the orders placed in a range, newest first: from, to, limit
+    ClickHouseQuery<std::chrono::sys_seconds, std::chrono::sys_seconds, uint32_t> orderHistory;
+    // Latest event of an order: order_id
+    ClickHouseQuery<std::string> orderDetails;
+
+private:
+    struct Selection {
+        const CandlesQuery* candles;          // Set unless the read is bucketed
+        const BucketedCandlesQuery* bucketed;
+        int64_t bucket;
+    };
+    Selection select(const trading::domain::HistoryQuery& query) const;
+
+    CandlesQuery candles_;                       // Plain candles_1m rows
+    std::vector<CandlesQuery> rollups_;          // Each rollup at its own interval
+    std::vector<BucketedCandlesQuery> buckets_;  // candles_1m, then each rollup
+};
+
+} // namespace trading::infrastructure::database
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../../domain/types.hpp"
+#include <cstdint>
+#include <string>
+
+namespace trading::infrastructure::database {
+
+// How far before now a history read may end and still count as "up to now"
+inline constexpr int64_t kLiveWindowSlackSeconds = 60;
+
+// Key a fetch result is cached under for serving while ClickHouse is
+// unhealthy. A window ending within kLiveWindowSlackSeconds of nowSeconds is
+// keyed by its length in whole minutes instead of its bounds, so "the past
+// day" asked a few minutes later, or by the startup warm-up, finds the same
+// entry. Older windows are keyed by their exact bounds.
+inline std::string historyCacheKey(const trading::domain::Symbol& symbol, const trading::domain::HistoryQuery& query,
+                                   int64_t nowSeconds) {
+    std::string key = "fetch|" + symbol.code + '|';
+    if (query.toTs >= nowSeconds - kLiveWindowSlackSeconds) {
+        key += "last" + std::to_string((query.toTs - query.fromTs + 30) / 60) + 'm';
+    } else {
+        key += std::to_string(query.fromTs) + '|' + std::to_string(query.toTs);
+    }
+    key += '|' + std::to_string(static_cast<int>(query.interval)) + '|' + std::to_string(query.limit) + '|' +
+           std::to_string(query.bucketSeconds);
+    return key;
+}
+
+} // namespace trading::infrastructure::database
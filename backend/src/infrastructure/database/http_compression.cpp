@@ -0,0 +1,159 @@
+#include "http_compression.hpp"
+#include <lz4frame.h>
+#include <zstd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace trading::infrastructure::database {
+
+namespace {
+
+// Favors throughput: bodies are compressed on the request path
+constexpr int kZstdLevel = 1;
+constexpr size_t kDecodeChunk = 256 * 1024;
+
+constexpr unsigned char kLz4Magic[] = {0x04, 0x22, 0x4D, 0x18};
+constexpr unsigned char kZstdMagic[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+bool startsWith(std::string_view body, const unsigned char (&magic)[4]) {
+    return body.size() >= sizeof(magic) && std::memcmp(body.data(), magic, sizeof(magic)) == 0;
+}
+
+std::string compressLz4(std::string_view body) {
+    LZ4F_preferences_t preferences;
+    std::memset(&preferences, 0, sizeof(preferences));
+    preferences.frameInfo.contentSize = body.size();  // Lets the reader size its buffer once
+    std::string out(LZ4F_compressFrameBound(body.size(), &preferences), '\0');
+    size_t written = LZ4F_compressFrame(out.data(), out.size(), body.data(), body.size(), &preferences);
+    if (LZ4F_isError(written)) {
+        throw std::runtime_error(std::string("LZ4 compression failed: ") + LZ4F_getErrorName(written));
+    }
+    out.resize(written);
+    return out;
+}
+
+std::string decompressLz4(std::string_view body) {
+    LZ4F_dctx* raw = nullptr;
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&raw, LZ4F_VERSION))) {
+        throw std::runtime_error("LZ4 decompression context could not be created");
+    }
+    std::unique_ptr<LZ4F_dctx, decltype(&LZ4F_freeDecompressionContext)> context(raw, &LZ4F_freeDecompressionContext);
+
+    std::string out;
+    LZ4F_frameInfo_t info;
+    std::memset(&info, 0, sizeof(info));
+    size_t headerSize = body.size();
+    size_t hint = LZ4F_getFrameInfo(context.get(), &info, body.data(), &headerSize);
+    if (LZ4F_isError(hint)) {
+        throw std::runtime_error(std::string("LZ4 frame header is invalid: ") + LZ4F_getErrorName(hint));
+    }
+    out.reserve(info.contentSize ? info.contentSize : body.size() * 4);
+
+    // Loops until every frame is complete and all input is read
+    size_t consumed = headerSize;
+    while (consumed < body.size() || hint != 0) {
+        size_t used = out.size();
+        out.resize(std::max(out.capacity(), used + kDecodeChunk));
+        size_t produced = out.size() - used;
+        size_t read = body.size() - consumed;
+        hint = LZ4F_decompress(context.get(), out.data() + used, &produced, body.data() + consumed, &read, nullptr);
+        if (LZ4F_isError(hint)) {
+            throw std::runtime_error(std::string("LZ4 body is corrupt: ") + LZ4F_getErrorName(hint));
+        }
+        out.resize(used + produced);
+        consumed += read;
+        if (hint != 0 && read == 0 && produced == 0) {
+            throw std::runtime_error("LZ4 body ends before its frame does");
+        }
+    }
+    return out;
+}
+
+std::string compressZstd(std::string_view body) {
+    std::string out(ZSTD_compressBound(body.size()), '\0');
+    size_t written = ZSTD_compress(out.data(), out.size(), body.data(), body.size(), kZstdLevel);
+    if (ZSTD_isError(written)) {
+        throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(written));
+    }
+    out.resize(written);
+    return out;
+}
+
+std::string decompressZstd(std::string_view body) {
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    if (!context) {
+        throw std::runtime_error("zstd decompression context could not be created");
+    }
+
+    // Streamed responses leave the content size out of the frame header
+    std::string out;
+    unsigned long long contentSize = ZSTD_getFrameContentSize(body.data(), body.size());
+    out.reserve(contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR
+                    ? static_cast<size_t>(contentSize) : body.size() * 4);
+
+    ZSTD_inBuffer input{body.data(), body.size(), 0};
+    size_t hint = 1;
+    while (input.pos < input.size || hint != 0) {
+        size_t used = out.size();
+        out.resize(std::max(out.capacity(), used + kDecodeChunk));
+        ZSTD_outBuffer output{out.data() + used, out.size() - used, 0};
+        size_t before = input.pos;
+        hint = ZSTD_decompressStream(context.get(), &output, &input);
+        if (ZSTD_isError(hint)) {
+            throw std::runtime_error(std::string("zstd body is corrupt: ") + ZSTD_getErrorName(hint));
+        }
+        out.resize(used + output.pos);
+        if (hint != 0 && input.pos == before && output.pos == 0) {
+            throw std::runtime_error("zstd body ends before its frame does");
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+std::optional<HttpCompression> parseHttpCompression(std::string_view name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "none") return HttpCompression::NONE;
+    if (lower == "lz4") return HttpCompression::LZ4;
+    if (lower == "zstd") return HttpCompression::ZSTD;
+    return std::nullopt;
+}
+
+std::string_view httpCompressionName(HttpCompression compression) {
+    switch (compression) {
+        case HttpCompression::LZ4: return "lz4";
+        case HttpCompression::ZSTD: return "zstd";
+        default: return "none";
+    }
+}
+
+std::string compressHttpBody(std::string_view body, HttpCompression compression) {
+    switch (compression) {
+        case HttpCompression::LZ4: return compressLz4(body);
+        case HttpCompression::ZSTD: return compressZstd(body);
+        default: return std::string(body);
+    }
+}
+
+std::string decompressHttpBody(std::string_view body, HttpCompression compression) {
+    switch (compression) {
+        case HttpCompression::LZ4: return decompressLz4(body);
+        case HttpCompression::ZSTD: return decompressZstd(body);
+        default: return std::string(body);
+    }
+}
+
+bool isCompressedHttpBody(std::string_view body, HttpCompression compression) {
+    switch (compression) {
+        case HttpCompression::LZ4: return startsWith(body, kLz4Magic);
+        case HttpCompression::ZSTD: return startsWith(body, kZstdMagic);
+        default: return false;
+    }
+}
+
+} // namespace trading::infrastructure::database
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace trading::infrastructure::database {
+
+// Content-Encoding of ClickHouse HTTP bodies. Requests are decoded by the
+// server as sent; responses are encoded when a query carries
+// enable_http_compression=1 and Accept-Encoding names the codec.
+enum class HttpCompression {
+    NONE,
+    LZ4,   // LZ4 frame format: cheapest on CPU
+    ZSTD   // Smaller on the wire for a few times the CPU of LZ4
+};
+
+// "none", "lz4" or "zstd", case-insensitive; nullopt for anything else
+std::optional<HttpCompression> parseHttpCompression(std::string_view name);
+// The Content-Encoding token, "none" for NONE
+std::string_view httpCompressionName(HttpCompression compression);
+
+std::string compressHttpBody(std::string_view body, HttpCompression compression);
+// Throws std::runtime_error when `body` is not a complete frame of the codec
+std::string decompressHttpBody(std::string_view body, HttpCompression compression);
+// Whether `body` starts with the frame magic of the codec. Clients that decode
+// some encodings themselves may hand back a body that is already plain text.
+bool isCompressedHttpBody(std::string_view body, HttpCompression compression);
+
+} // namespace trading::infrastructure::database
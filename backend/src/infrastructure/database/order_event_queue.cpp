@@ -0,0 +1,80 @@
+#include "order_event_queue.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace trading::infrastructure::database {
+
+OrderEventQueue::OrderEventQueue(size_t recentOrders, bool held, size_t maxQueued)
+    : held_(held), maxQueued_(maxQueued), recent_(recentOrders) {}
+
+void OrderEventQueue::push(OrderEvent event) {
+    recent_.put(event.orderId, event);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (events_.size() >= maxQueued_) {
+            events_.pop_front();
+            ++dropped_;
+        }
+        events_.push_back(std::move(event));
+    }
+    ready_.notify_one();
+}
+
+bool OrderEventQueue::waitBatch(std::vector<OrderEvent>& batch, size_t maxEvents) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!closed_) {
+        if (events_.empty() || held_) {
+            ready_.wait(lock);
+        } else if (Clock::now() < retryAt_) {
+            ready_.wait_until(lock, retryAt_);
+        } else {
+            break;
+        }
+    }
+    if (events_.empty()) {
+        return false;
+    }
+    size_t count = std::min(maxEvents, events_.size());
+    batch.insert(batch.end(), std::make_move_iterator(events_.begin()), std::make_move_iterator(events_.begin() + count));
+    events_.erase(events_.begin(), events_.begin() + count);
+    return true;
+}
+
+void OrderEventQueue::requeue(std::vector<OrderEvent> batch, Clock::time_point retryAt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.insert(events_.begin(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    retryAt_ = retryAt;
+}
+
+void OrderEventQueue::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = false;
+    }
+    ready_.notify_all();
+}
+
+bool OrderEventQueue::held() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return held_;
+}
+
+void OrderEventQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    ready_.notify_all();
+}
+
+size_t OrderEventQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+}
+
+uint64_t OrderEventQueue::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+} // namespace trading::infrastructure::database
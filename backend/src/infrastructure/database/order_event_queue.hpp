@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../cache/lru_cache.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace trading::infrastructure::database {
+
+// One row of order_events: a placement or cancellation with the order's own
+// fields, so history reads need no JSON. Enum fields hold the column's labels;
+// logOrder maps anything else to UNKNOWN.
+struct OrderEvent {
+    std::string orderId;
+    std::string idempKey;
+    std::string eventType = "PLACE";  // PLACE, CANCEL
+    std::string status = "UNKNOWN";   // ACK, FILLED, REJECTED, CANCELLED
+    std::string symbol;
+    std::string side = "UNKNOWN";     // BUY, SELL
+    std::string type = "UNKNOWN";     // MARKET, LIMIT
+    double quantity = 0.0;
+    double price = 0.0;
+    std::string accountId;
+    std::string sessionId;
+    int64_t placedAtMs = 0;           // When the order was placed; 0 means tsMs
+    int64_t tsMs = 0;                 // When this event happened; 0 means when queued
+};
+
+// Orders whose latest event stays in memory after the writer took it
+inline constexpr size_t kRecentOrders = 10'000;
+
+// Events held for the writer at most, e.g. while ClickHouse is down at startup
+inline constexpr size_t kMaxQueuedOrderEvents = 100'000;
+
+// Order events waiting for the writer thread, and the latest event of each
+// recent order. order_events only has an order once the writer has flushed
+// it, so a cancellation right after the placement finds it here instead.
+class OrderEventQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // A held queue keeps its events from waitBatch until release
+    explicit OrderEventQueue(size_t recentOrders = kRecentOrders, bool held = false,
+                             size_t maxQueued = kMaxQueuedOrderEvents);
+
+    // Past maxQueued the oldest queued event is dropped and counted
+    void push(OrderEvent event);
+
+    // Waits for queued events, then moves up to maxEvents into batch, oldest
+    // first. After close it returns what is left without waiting for a retry
+    // or a release; false once closed and empty.
+    bool waitBatch(std::vector<OrderEvent>& batch, size_t maxEvents);
+
+    // A batch the writer failed to insert goes back ahead of anything queued
+    // since, and waitBatch holds it until retryAt
+    void requeue(std::vector<OrderEvent> batch, Clock::time_point retryAt);
+
+    // Lets waitBatch take events, once the tables they go to exist
+    void release();
+    bool held() const;
+
+    // Wakes waitBatch to drain the queue and return
+    void close();
+
+    // Latest event pushed for orderId, whether or not it was written yet
+    std::optional<OrderEvent> recent(const std::string& orderId) { return recent_.get(orderId); }
+
+    size_t size() const;
+    uint64_t dropped() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<OrderEvent> events_;
+    Clock::time_point retryAt_{};
+    bool held_;
+    bool closed_ = false;
+    size_t maxQueued_;
+    uint64_t dropped_ = 0;
+    trading::infrastructure::cache::LruCache<OrderEvent> recent_;
+};
+
+} // namespace trading::infrastructure::database
@@ -0,0 +1,255 @@
+#include "tick_capture.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trading::infrastructure::marketdata {
+
+static_assert(std::endian::native == std::endian::little, "tick captures are written in host byte order");
+
+namespace {
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t symbolCount;
+    uint32_t headerSize;
+    uint64_t recordCount;
+    int64_t createdAtMs;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(FileHeader) == 64, "symbol table starts at offset 64");
+
+} // namespace
+
+TickCaptureWriter::~TickCaptureWriter() {
+    close();
+}
+
+bool TickCaptureWriter::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        std::fclose(file_);
+    }
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "[Tick Capture] Cannot open " << path << " for writing: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    path_ = path;
+    symbols_.clear();
+    symbolIds_.clear();
+    buffer_.clear();
+    buffer_.reserve(kBufferedRecords);
+    recordCount_ = 0;
+    createdAtMs_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (!writeHeaderLocked()) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool TickCaptureWriter::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_ != nullptr;
+}
+
+bool TickCaptureWriter::append(const std::string& symbol, const trading::domain::Tick& tick) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        return false;
+    }
+
+    uint16_t symbolId;
+    auto it = symbolIds_.find(symbol);
+    if (it != symbolIds_.end()) {
+        symbolId = it->second;
+    } else {
+        if (symbols_.size() >= kTickCaptureMaxSymbols || symbol.empty() || symbol.size() > kTickCaptureSymbolSize) {
+            return false;
+        }
+        symbolId = static_cast<uint16_t>(symbols_.size());
+        symbols_.push_back(symbol);
+        symbolIds_.emplace(symbol, symbolId);
+        headerDirty_ = true;
+    }
+
+    TickRecord record{};
+    record.ts = tick.ts;
+    record.bid = tick.bid;
+    record.ask = tick.ask;
+    record.last = tick.last;
+    record.volume = tick.volume;
+    record.symbolId = symbolId;
+    buffer_.push_back(record);
+    ++recordCount_;
+
+    if (buffer_.size() >= kBufferedRecords) {
+        return flushLocked();
+    }
+    return true;
+}
+
+bool TickCaptureWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_ && flushLocked();
+}
+
+void TickCaptureWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        return;
+    }
+    flushLocked();
+    writeHeaderLocked();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+uint64_t TickCaptureWriter::recordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recordCount_;
+}
+
+bool TickCaptureWriter::writeHeaderLocked() {
+    std::vector<char> block(kTickCaptureHeaderSize, 0);
+    FileHeader header{};
+    std::memcpy(header.magic, kTickCaptureMagic, sizeof(header.magic));
+    header.version = kTickCaptureVersion;
+    header.recordSize = sizeof(TickRecord);
+    header.symbolCount = static_cast<uint32_t>(symbols_.size());
+    header.headerSize = kTickCaptureHeaderSize;
+    header.recordCount = recordCount_;
+    header.createdAtMs = createdAtMs_;
+    std::memcpy(block.data(), &header, sizeof(header));
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        std::memcpy(block.data() + sizeof(header) + i * kTickCaptureSymbolSize, symbols_[i].data(), symbols_[i].size());
+    }
+
+    long end = std::ftell(file_);
+    bool ok = std::fseek(file_, 0, SEEK_SET) == 0 &&
+              std::fwrite(block.data(), 1, block.size(), file_) == block.size();
+    if (end > static_cast<long>(kTickCaptureHeaderSize)) {
+        ok = std::fseek(file_, end, SEEK_SET) == 0 && ok;
+    }
+    if (!ok) {
+        std::cerr << "[Tick Capture] Failed to write header of " << path_ << std::endl;
+    }
+    headerDirty_ = false;
+    return ok;
+}
+
+bool TickCaptureWriter::flushLocked() {
+    // Header first: a record never reaches the disk ahead of its symbol
+    bool ok = true;
+    if (headerDirty_ || !buffer_.empty()) {
+        ok = writeHeaderLocked();
+    }
+    if (!buffer_.empty()) {
+        size_t written = std::fwrite(buffer_.data(), sizeof(TickRecord), buffer_.size(), file_);
+        if (written != buffer_.size()) {
+            std::cerr << "[Tick Capture] Short write to " << path_ << ": " << std::strerror(errno) << std::endl;
+            ok = false;
+        }
+        buffer_.clear();
+    }
+    return std::fflush(file_) == 0 && ok;
+}
+
+TickCaptureReader::~TickCaptureReader() {
+    close();
+}
+
+bool TickCaptureReader::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return fail("cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kTickCaptureHeaderSize) {
+        ::close(fd);
+        return fail(path + " is too short to be a tick capture");
+    }
+    mappedSize_ = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mappedSize_ = 0;
+        return fail("mmap of " + path + " failed: " + std::strerror(errno));
+    }
+    ::madvise(mapping, mappedSize_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(mapping);
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, kTickCaptureMagic, sizeof(header.magic)) != 0) {
+        return fail(path + " is not a tick capture");
+    }
+    if (header.version != kTickCaptureVersion || header.recordSize != sizeof(TickRecord) ||
+        header.headerSize != kTickCaptureHeaderSize || header.symbolCount > kTickCaptureMaxSymbols) {
+        return fail(path + " has an unsupported capture layout (version " + std::to_string(header.version) + ")");
+    }
+
+    const char* table = reinterpret_cast<const char*>(data_) + sizeof(FileHeader);
+    for (uint32_t i = 0; i < header.symbolCount; ++i) {
+        const char* name = table + i * kTickCaptureSymbolSize;
+        symbols_.emplace_back(name, strnlen(name, kTickCaptureSymbolSize));
+    }
+
+    // A trailing partial record (interrupted write) is ignored
+    records_ = reinterpret_cast<const TickRecord*>(data_ + kTickCaptureHeaderSize);
+    recordCount_ = (mappedSize_ - kTickCaptureHeaderSize) / sizeof(TickRecord);
+    return true;
+}
+
+void TickCaptureReader::close() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), mappedSize_);
+    }
+    data_ = nullptr;
+    mappedSize_ = 0;
+    records_ = nullptr;
+    recordCount_ = 0;
+    symbols_.clear();
+}
+
+bool TickCaptureReader::fail(const std::string& message) {
+    close();
+    error_ = message;
+    return false;
+}
+
+RecordingMarketDataFeed::RecordingMarketDataFeed(std::shared_ptr<TickCaptureWriter> writer,
+                                                 std::unique_ptr<trading::domain::IMarketDataFeed> inner)
+    : writer_(std::move(writer)), inner_(std::move(inner)) {}
+
+void RecordingMarketDataFeed::subscribe(const std::vector<trading::domain::Symbol>& symbols) {
+    if (inner_) inner_->subscribe(symbols);
+}
+
+void RecordingMarketDataFeed::unsubscribe(const std::vector<trading::domain::Symbol>& symbols) {
+    if (inner_) inner_->unsubscribe(symbols);
+}
+
+void RecordingMarketDataFeed::publishTick(const trading::domain::Symbol& symbol, const trading::domain::Tick& tick) {
+    writer_->append(symbol.code, tick);
+    if (inner_) inner_->publishTick(symbol, tick);
+}
+
+void RecordingMarketDataFeed::publishTickDelta(const trading::domain::Symbol& symbol, const trading::domain::TickDelta& delta) {
+    if (inner_) inner_->publishTickDelta(symbol, delta);
+}
+
+} // namespace trading::infrastructure::marketdata
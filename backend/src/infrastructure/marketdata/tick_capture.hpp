@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../../domain/interfaces.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::infrastructure::marketdata {
+
+// On-disk tick capture: a 4 KiB header followed by fixed-width records, so a
+// capture can be mmapped and indexed directly. All fields are little-endian.
+//
+//   offset 0     magic "BULLTICK", version, record size, symbol count, record count
+//   offset 64    symbol table, kTickCaptureMaxSymbols NUL-padded 16-byte names
+//   offset 4096  TickRecord[recordCount]
+//
+// The record count in the header is refreshed on every flush; readers derive it
+// from the file size instead, so a capture cut short by a crash stays readable.
+struct TickRecord {
+    int64_t ts;          // Milliseconds since epoch, as Tick::ts
+    double bid;
+    double ask;
+    double last;
+    uint64_t volume;
+    uint16_t symbolId;   // Index into the symbol table
+    uint16_t flags;
+    uint32_t reserved;
+};
+static_assert(sizeof(TickRecord) == 48, "TickRecord is a fixed-width on-disk record");
+
+constexpr char kTickCaptureMagic[8] = {'B', 'U', 'L', 'L', 'T', 'I', 'C', 'K'};
+constexpr uint32_t kTickCaptureVersion = 1;
+constexpr size_t kTickCaptureHeaderSize = 4096;
+constexpr size_t kTickCaptureSymbolSize = 16;
+constexpr size_t kTickCaptureMaxSymbols = (kTickCaptureHeaderSize - 64) / kTickCaptureSymbolSize;
+
+// Appends ticks to a capture file. Records are buffered and written in blocks;
+// flush() also rewrites the header so the symbol table is always on disk
+// before any record that refers to it.
+class TickCaptureWriter {
+public:
+    TickCaptureWriter() = default;
+    ~TickCaptureWriter();
+
+    TickCaptureWriter(const TickCaptureWriter&) = delete;
+    TickCaptureWriter& operator=(const TickCaptureWriter&) = delete;
+
+    // Truncates any existing file at path
+    bool open(const std::string& path);
+    bool isOpen() const;
+
+    // False once the symbol table is full or the file is not open
+    bool append(const std::string& symbol, const trading::domain::Tick& tick);
+    bool flush();
+    void close();
+
+    uint64_t recordCount() const;
+
+private:
+    bool writeHeaderLocked();
+    bool flushLocked();
+
+    static constexpr size_t kBufferedRecords = 1024;
+
+    mutable std::mutex mutex_;
+    std::FILE* file_ = nullptr;
+    std::string path_;
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, uint16_t> symbolIds_;
+    std::vector<TickRecord> buffer_;
+    uint64_t recordCount_ = 0;
+    int64_t createdAtMs_ = 0;
+    bool headerDirty_ = false;
+};
+
+// Read-only view of a capture file through mmap. Records are served straight
+// from the mapping; the reader must outlive any reference it hands out.
+class TickCaptureReader {
+public:
+    TickCaptureReader() = default;
+    ~TickCaptureReader();
+
+    TickCaptureReader(const TickCaptureReader&) = delete;
+    TickCaptureReader& operator=(const TickCaptureReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+    const std::string& error() const { return error_; }
+
+    size_t size() const { return recordCount_; }
+    bool empty() const { return recordCount_ == 0; }
+    const TickRecord& operator[](size_t index) const { return records_[index]; }
+    const TickRecord* begin() const { return records_; }
+    const TickRecord* end() const { return records_ + recordCount_; }
+
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    const std::string& symbol(const TickRecord& record) const { return symbols_[record.symbolId]; }
+
+private:
+    bool fail(const std::string& message);
+
+    const uint8_t* data_ = nullptr;
+    size_t mappedSize_ = 0;
+    const TickRecord* records_ = nullptr;
+    size_t recordCount_ = 0;
+    std::vector<std::string> symbols_;
+    std::string error_;
+};
+
+// IMarketDataFeed decorator that records every published tick before handing
+// it on to the wrapped feed (if any). Deltas are forwarded but not captured:
+// a replay rebuilds them from full ticks.
+class RecordingMarketDataFeed : public trading::domain::IMarketDataFeed {
+public:
+    RecordingMarketDataFeed(std::shared_ptr<TickCaptureWriter> writer,
+                            std::unique_ptr<trading::domain::IMarketDataFeed> inner = nullptr);
+
+    void subscribe(const std::vector<trading::domain::Symbol>& symbols) override;
+    void unsubscribe(const std::vector<trading::domain::Symbol>& symbols) override;
+    void publishTick(const trading::domain::Symbol& symbol, const trading::domain::Tick& tick) override;
+    void publishTickDelta(const trading::domain::Symbol& symbol, const trading::domain::TickDelta& delta) override;
+
+    const TickCaptureWriter& writer() const { return *writer_; }
+
+private:
+    std::shared_ptr<TickCaptureWriter> writer_;
+    std::unique_ptr<trading::domain::IMarketDataFeed> inner_;
+};
+
+} // namespace trading::infrastructure::marketdata
@@ -0,0 +1,481 @@
+#include "tick_journal.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trading::infrastructure::marketdata {
+
+using trading::domain::Tick;
+
+static_assert(std::is_trivially_copyable_v<Tick> && std::is_standard_layout_v<Tick>,
+              "journal segments store domain::Tick as raw records");
+
+namespace {
+
+constexpr char kJournalMagic[8] = {'B', 'U', 'L', 'L', 'J', 'R', 'N', 'L'};
+constexpr uint32_t kJournalVersion = 1;
+constexpr size_t kSegmentHeaderSize = 4096;
+constexpr int64_t kMsPerDay = 86'400'000;
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;
+    uint64_t count;          // Committed records; written with release, read with acquire
+    int64_t firstTs;
+    char symbol[32];
+};
+static_assert(sizeof(SegmentHeader) <= kSegmentHeaderSize);
+
+int64_t utcDay(int64_t ts) {
+    return ts >= 0 ? ts / kMsPerDay : (ts - kMsPerDay + 1) / kMsPerDay;
+}
+
+// Symbols become directory names; anything outside [A-Za-z0-9._-] is replaced
+std::string directoryName(const std::string& symbol) {
+    std::string name = symbol;
+    for (char& c : name) {
+        bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-';
+        if (!safe) c = '_';
+    }
+    return name == "." || name == ".." ? "_" + name : name;
+}
+
+// First tick ts, then journal position: unique, and sorts in append order
+std::string segmentFileName(int64_t firstTs, uint64_t start) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%020lld-%012llu.seg", static_cast<long long>(firstTs),
+                  static_cast<unsigned long long>(start));
+    return name;
+}
+
+// The journal position in a segment file name
+std::optional<uint64_t> segmentStart(const std::string& fileName) {
+    long long firstTs = 0;
+    unsigned long long start = 0;
+    if (std::sscanf(fileName.c_str(), "%lld-%llu.seg", &firstTs, &start) != 2) {
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(start);
+}
+
+} // namespace
+
+class TickJournal::Segment {
+public:
+    static std::unique_ptr<Segment> create(const std::string& path, const std::string& symbol, int64_t firstTs,
+                                           size_t capacity, size_t stride) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::cerr << "[Tick Journal] Cannot create " << path << ": " << std::strerror(errno) << std::endl;
+            return nullptr;
+        }
+        size_t size = kSegmentHeaderSize + capacity * sizeof(Tick);
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            std::cerr << "[Tick Journal] Cannot size " << path << ": " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            return nullptr;
+        }
+        auto segment = map(fd, path, size, stride);
+        if (!segment) {
+            return nullptr;
+        }
+        SegmentHeader* header = segment->header_;
+        std::memcpy(header->magic, kJournalMagic, sizeof(header->magic));
+        header->version = kJournalVersion;
+        header->recordSize = sizeof(Tick);
+        header->capacity = capacity;
+        header->count = 0;
+        header->firstTs = firstTs;
+        std::strncpy(header->symbol, symbol.c_str(), sizeof(header->symbol) - 1);
+        segment->capacity_ = capacity;
+        return segment;
+    }
+
+    static std::unique_ptr<Segment> load(const std::string& path, size_t stride) {
+        int fd = ::open(path.c_str(), O_RDWR);
+        struct stat st {};
+        if (fd < 0 || ::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kSegmentHeaderSize) {
+            std::cerr << "[Tick Journal] Skipping unreadable segment " << path << std::endl;
+            if (fd >= 0) ::close(fd);
+            return nullptr;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        auto segment = map(fd, path, size, stride);
+        if (!segment) {
+            return nullptr;
+        }
+        const SegmentHeader* header = segment->header_;
+        if (std::memcmp(header->magic, kJournalMagic, sizeof(header->magic)) != 0 || header->version != kJournalVersion ||
+            header->recordSize != sizeof(Tick) || kSegmentHeaderSize + header->capacity * sizeof(Tick) > size) {
+            std::cerr << "[Tick Journal] Skipping segment with unknown layout " << path << std::endl;
+            return nullptr;
+        }
+        segment->capacity_ = header->capacity;
+        if (segment->count() > segment->capacity_) {
+            segment->header_->count = segment->capacity_;
+        }
+        size_t count = segment->count();
+        for (size_t position = 0; position < count; position += stride) {
+            segment->index_[position / stride] = segment->ticks_[position].ts;
+        }
+        return segment;
+    }
+
+    ~Segment() {
+        ::munmap(header_, mappedSize_);
+    }
+
+    const std::string& path() const { return path_; }
+
+    std::string symbol() const { return std::string(header_->symbol, strnlen(header_->symbol, sizeof(header_->symbol))); }
+    int64_t firstTs() const { return header_->firstTs; }
+    size_t capacity() const { return capacity_; }
+
+    size_t count() const {
+        return static_cast<size_t>(std::atomic_ref<uint64_t>(header_->count).load(std::memory_order_acquire));
+    }
+
+    // Writer thread only
+    void append(const Tick& tick) {
+        size_t position = static_cast<size_t>(std::atomic_ref<uint64_t>(header_->count).load(std::memory_order_relaxed));
+        ticks_[position] = tick;
+        if (position % stride_ == 0) {
+            index_[position / stride_] = tick.ts;
+        }
+        std::atomic_ref<uint64_t>(header_->count).store(position + 1, std::memory_order_release);
+    }
+
+    int64_t lastTs(size_t count) const { return ticks_[count - 1].ts; }
+
+    std::span<const Tick> view(size_t from, size_t to) const {
+        return std::span<const Tick>(ticks_ + from, to - from);
+    }
+
+    // First position in [0, count) with ts >= target: a search over the sparse
+    // index, then over the one stride of records it points at
+    size_t lowerBound(int64_t target, size_t count) const {
+        size_t entries = (count + stride_ - 1) / stride_;
+        size_t k = static_cast<size_t>(std::lower_bound(index_.get(), index_.get() + entries, target) - index_.get());
+        if (k == 0) {
+            return 0;
+        }
+        size_t lo = (k - 1) * stride_;
+        size_t hi = std::min(k * stride_, count);
+        auto it = std::lower_bound(ticks_ + lo, ticks_ + hi, target,
+                                   [](const Tick& tick, int64_t ts) { return tick.ts < ts; });
+        return static_cast<size_t>(it - ticks_);
+    }
+
+    void flush() const {
+        ::msync(header_, mappedSize_, MS_ASYNC);
+    }
+
+private:
+    static std::unique_ptr<Segment> map(int fd, const std::string& path, size_t size, size_t stride) {
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "[Tick Journal] mmap of " << path << " failed: " << std::strerror(errno) << std::endl;
+            return nullptr;
+        }
+        auto segment = std::unique_ptr<Segment>(new Segment());
+        segment->header_ = static_cast<SegmentHeader*>(mapping);
+        segment->ticks_ = reinterpret_cast<Tick*>(static_cast<uint8_t*>(mapping) + kSegmentHeaderSize);
+        segment->path_ = path;
+        segment->mappedSize_ = size;
+        segment->stride_ = stride;
+        size_t records = (size - kSegmentHeaderSize) / sizeof(Tick);
+        segment->index_ = std::make_unique<int64_t[]>(records / stride + 1);
+        return segment;
+    }
+
+    Segment() = default;
+
+    std::string path_;
+    SegmentHeader* header_ = nullptr;
+    Tick* ticks_ = nullptr;
+    size_t mappedSize_ = 0;
+    size_t capacity_ = 0;
+    size_t stride_ = 1;
+    std::unique_ptr<int64_t[]> index_;  // ts of every stride-th record, rebuilt on load
+};
+
+struct TickJournal::SymbolJournal {
+    std::string directory;
+    // Readers hold this shared; the writer takes it exclusively only to add a segment
+    mutable std::shared_mutex mutex;
+    std::vector<std::unique_ptr<Segment>> segments;
+    std::vector<uint64_t> starts;  // Journal position of each segment's first tick
+    int64_t lastTs = INT64_MIN;    // Writer thread only
+};
+
+TickJournal::TickJournal(std::string directory, TickJournalOptions options)
+    : directory_(std::move(directory)), options_(options) {
+    options_.segmentCapacity = std::max<size_t>(options_.segmentCapacity, 1);
+    options_.indexStride = std::max<size_t>(options_.indexStride, 1);
+}
+
+TickJournal::~TickJournal() {
+    close();
+}
+
+bool TickJournal::open() {
+    std::unique_lock<std::shared_mutex> lock(symbolsMutex_);
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        std::cerr << "[Tick Journal] Cannot create " << directory_ << ": " << ec.message() << std::endl;
+        return false;
+    }
+    symbols_.clear();
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+        if (entry.is_directory()) {
+            loadSymbol(entry.path().string());
+        }
+    }
+    open_ = true;
+    return true;
+}
+
+void TickJournal::close() {
+    std::unique_lock<std::shared_mutex> lock(symbolsMutex_);
+    symbols_.clear();
+    retired_.clear();
+    open_ = false;
+}
+
+bool TickJournal::loadSymbol(const std::string& path) {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".seg") {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    auto journal = std::make_unique<SymbolJournal>();
+    journal->directory = path;
+    std::string symbol;
+    uint64_t position = 0;
+    for (const auto& file : files) {
+        auto segment = Segment::load(file, options_.indexStride);
+        if (!segment) {
+            continue;
+        }
+        // Positions survive the segments prune dropped before this one
+        if (journal->segments.empty()) {
+            position = segmentStart(std::filesystem::path(file).filename().string()).value_or(0);
+        }
+        size_t count = segment->count();
+        if (count > 0) {
+            journal->lastTs = segment->lastTs(count);
+        }
+        symbol = segment->symbol();
+        journal->starts.push_back(position);
+        position += count;
+        journal->segments.push_back(std::move(segment));
+    }
+    if (symbol.empty()) {
+        return false;
+    }
+    symbols_[symbol] = std::move(journal);
+    return true;
+}
+
+TickJournal::SymbolJournal* TickJournal::findSymbol(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(symbolsMutex_);
+    auto it = symbols_.find(symbol);
+    return it == symbols_.end() ? nullptr : it->second.get();
+}
+
+TickJournal::SymbolJournal* TickJournal::symbolForAppend(const std::string& symbol) {
+    if (SymbolJournal* journal = findSymbol(symbol)) {
+        return journal;
+    }
+    std::unique_lock<std::shared_mutex> lock(symbolsMutex_);
+    auto& journal = symbols_[symbol];
+    if (!journal) {
+        journal = std::make_unique<SymbolJournal>();
+        journal->directory = (std::filesystem::path(directory_) / directoryName(symbol)).string();
+        std::error_code ec;
+        std::filesystem::create_directories(journal->directory, ec);
+    }
+    return journal.get();
+}
+
+bool TickJournal::append(const std::string& symbol, const Tick& tick) {
+    if (!open_ || symbol.empty()) {
+        return false;
+    }
+    SymbolJournal* journal = symbolForAppend(symbol);
+    if (tick.ts < journal->lastTs) {
+        return false;
+    }
+
+    Segment* segment = journal->segments.empty() ? nullptr : journal->segments.back().get();
+    if (!segment || segment->count() >= segment->capacity() || utcDay(segment->firstTs()) != utcDay(tick.ts)) {
+        uint64_t start = segment ? journal->starts.back() + segment->count() : 0;
+        std::string path = (std::filesystem::path(journal->directory) / segmentFileName(tick.ts, start)).string();
+        auto created = Segment::create(path, symbol, tick.ts, options_.segmentCapacity, options_.indexStride);
+        if (!created) {
+            return false;
+        }
+        segment = created.get();
+        std::unique_lock<std::shared_mutex> lock(journal->mutex);
+        journal->segments.push_back(std::move(created));
+        journal->starts.push_back(start);
+    }
+
+    segment->append(tick);
+    journal->lastTs = tick.ts;
+    return true;
+}
+
+template <typename Result, typename Fn>
+Result TickJournal::withSymbol(const std::string& symbol, Result fallback, Fn fn) const {
+    SymbolJournal* journal = findSymbol(symbol);
+    if (!journal) {
+        return fallback;
+    }
+    std::shared_lock<std::shared_mutex> lock(journal->mutex);
+    return fn(*journal);
+}
+
+std::vector<std::span<const Tick>> TickJournal::range(const std::string& symbol, int64_t fromTs, int64_t toTs) const {
+    using Spans = std::vector<std::span<const Tick>>;
+    return withSymbol(symbol, Spans{}, [&](const SymbolJournal& journal) {
+        Spans spans;
+        for (size_t i = 0; i < journal.segments.size(); ++i) {
+            const Segment& segment = *journal.segments[i];
+            // Segments are in time order and none extends past the next one's first tick
+            if (segment.firstTs() >= toTs) {
+                break;
+            }
+            if (i + 1 < journal.segments.size() && journal.segments[i + 1]->firstTs() < fromTs) {
+                continue;
+            }
+            size_t count = segment.count();
+            size_t begin = segment.lowerBound(fromTs, count);
+            size_t end = segment.lowerBound(toTs, count);
+            if (begin < end) {
+                spans.push_back(segment.view(begin, end));
+            }
+        }
+        return spans;
+    });
+}
+
+std::vector<std::span<const Tick>> TickJournal::since(const std::string& symbol, uint64_t position, uint64_t* start) const {
+    if (start) {
+        *start = position;
+    }
+    return withSymbol(symbol, std::vector<std::span<const Tick>>{}, [&](const SymbolJournal& journal) {
+        return spansFrom(journal, position, start);
+    });
+}
+
+std::vector<std::span<const Tick>> TickJournal::recent(const std::string& symbol, size_t count) const {
+    return withSymbol(symbol, std::vector<std::span<const Tick>>{}, [&](const SymbolJournal& journal) {
+        uint64_t total = journal.segments.empty() ? 0 : journal.starts.back() + journal.segments.back()->count();
+        return spansFrom(journal, total > count ? total - count : 0);
+    });
+}
+
+std::vector<std::span<const Tick>> TickJournal::spansFrom(const SymbolJournal& journal, uint64_t position, uint64_t* start) {
+    std::vector<std::span<const Tick>> spans;
+    for (size_t i = 0; i < journal.segments.size(); ++i) {
+        size_t count = journal.segments[i]->count();
+        uint64_t first = journal.starts[i];
+        if (first + count <= position) {
+            continue;
+        }
+        size_t begin = position > first ? static_cast<size_t>(position - first) : 0;
+        if (spans.empty() && start) {
+            *start = first + begin;
+        }
+        spans.push_back(journal.segments[i]->view(begin, count));
+    }
+    return spans;
+}
+
+uint64_t TickJournal::size(const std::string& symbol) const {
+    return withSymbol(symbol, uint64_t{0}, [](const SymbolJournal& journal) {
+        return journal.segments.empty() ? uint64_t{0} : journal.starts.back() + journal.segments.back()->count();
+    });
+}
+
+std::vector<std::string> TickJournal::symbols() const {
+    std::shared_lock<std::shared_mutex> lock(symbolsMutex_);
+    std::vector<std::string> names;
+    names.reserve(symbols_.size());
+    for (const auto& [symbol, journal] : symbols_) {
+        names.push_back(symbol);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void TickJournal::flush() {
+    std::shared_lock<std::shared_mutex> lock(symbolsMutex_);
+    for (const auto& [symbol, journal] : symbols_) {
+        std::shared_lock<std::shared_mutex> segmentsLock(journal->mutex);
+        for (const auto& segment : journal->segments) {
+            segment->flush();
+        }
+    }
+}
+
+size_t TickJournal::prune(int64_t nowTs) {
+    // Readers had a whole prune interval to finish with these
+    std::vector<std::unique_ptr<Segment>> unmapped = std::move(retired_);
+    retired_.clear();
+    if (options_.retainDays == 0) {
+        return 0;
+    }
+    int64_t cutoff = (utcDay(nowTs) - static_cast<int64_t>(options_.retainDays) + 1) * kMsPerDay;
+
+    std::shared_lock<std::shared_mutex> lock(symbolsMutex_);
+    size_t dropped = 0;
+    for (const auto& [symbol, journal] : symbols_) {
+        // Segments before the last one are complete and in time order
+        size_t expired = 0;
+        while (expired + 1 < journal->segments.size()) {
+            const Segment& segment = *journal->segments[expired];
+            size_t count = segment.count();
+            if (count > 0 && segment.lastTs(count) >= cutoff) {
+                break;
+            }
+            ++expired;
+        }
+        if (expired == 0) {
+            continue;
+        }
+        std::unique_lock<std::shared_mutex> segmentsLock(journal->mutex);
+        for (size_t i = 0; i < expired; ++i) {
+            std::error_code ec;
+            std::filesystem::remove(journal->segments[i]->path(), ec);
+            retired_.push_back(std::move(journal->segments[i]));
+        }
+        journal->segments.erase(journal->segments.begin(), journal->segments.begin() + static_cast<std::ptrdiff_t>(expired));
+        journal->starts.erase(journal->starts.begin(), journal->starts.begin() + static_cast<std::ptrdiff_t>(expired));
+        dropped += expired;
+    }
+    return dropped;
+}
+
+} // namespace trading::infrastructure::marketdata
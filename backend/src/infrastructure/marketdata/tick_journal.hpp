@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../../domain/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::infrastructure::marketdata {
+
+struct TickJournalOptions {
+    size_t segmentCapacity = 1 << 18;  // Ticks per segment file (10 MiB of records)
+    size_t indexStride = 256;          // One sparse index entry per this many ticks
+    uint32_t retainDays = 7;           // UTC days prune keeps, today included; 0 keeps everything
+};
+
+// Append-only local store of recent ticks, one directory per symbol:
+//
+//   <directory>/<symbol>/<first tick ts, zero padded>.seg
+//
+// A segment is a 4 KiB header followed by a preallocated array of packed
+// domain::Tick records, mapped shared and written in place. A segment holds
+// one UTC day at most, so a day's ticks can be dropped or shipped as whole
+// files. The committed record count lives in the header and is published
+// with a release store after the record, so a reader (or a reopened journal)
+// never sees a half-written tick.
+//
+// Ticks must arrive in non-decreasing ts order per symbol. Reads return spans
+// straight into the mappings. prune deletes the files of segments past the
+// retention but unmaps them only at the following prune, so a span stays
+// valid until then or until the journal is closed. One thread appends and
+// prunes, any number read.
+class TickJournal {
+public:
+    explicit TickJournal(std::string directory, TickJournalOptions options = {});
+    ~TickJournal();
+
+    TickJournal(const TickJournal&) = delete;
+    TickJournal& operator=(const TickJournal&) = delete;
+
+    // Creates the directory if needed and maps the segments already in it
+    bool open();
+    void close();
+    bool isOpen() const { return open_; }
+
+    // False for an out-of-order tick or when a new segment cannot be created
+    bool append(const std::string& symbol, const trading::domain::Tick& tick);
+
+    // Ticks with fromTs <= ts < toTs, one span per segment touched
+    std::vector<std::span<const trading::domain::Tick>> range(const std::string& symbol, int64_t fromTs, int64_t toTs) const;
+    // The newest count ticks, oldest first
+    std::vector<std::span<const trading::domain::Tick>> recent(const std::string& symbol, size_t count) const;
+    // Everything from position onwards, where position counts ticks since the
+    // journal was created; TickJournalLoader keeps its cursor as a position.
+    // A position already pruned starts at the oldest tick left, and start, if
+    // given, is set to the position of the first tick returned.
+    std::vector<std::span<const trading::domain::Tick>> since(const std::string& symbol, uint64_t position,
+                                                              uint64_t* start = nullptr) const;
+
+    // Position after the newest tick; pruned ticks still count
+    uint64_t size(const std::string& symbol) const;
+    std::vector<std::string> symbols() const;
+
+    // Schedules dirty pages for writeback; appends are visible to readers without it
+    void flush();
+
+    // Drops every segment whose ticks all fall before the first of the
+    // retainDays UTC days ending with nowTs's; the segment being appended to
+    // stays. Unmaps the segments the previous call dropped. Returns how many
+    // segments it dropped.
+    size_t prune(int64_t nowTs);
+
+private:
+    class Segment;
+    struct SymbolJournal;
+
+    SymbolJournal* findSymbol(const std::string& symbol) const;
+    SymbolJournal* symbolForAppend(const std::string& symbol);
+    bool loadSymbol(const std::string& path);
+    static std::vector<std::span<const trading::domain::Tick>> spansFrom(const SymbolJournal& journal, uint64_t position,
+                                                                          uint64_t* start = nullptr);
+    // Runs fn(journal) under the symbol's read lock; returns fallback for an unknown symbol
+    template <typename Result, typename Fn>
+    Result withSymbol(const std::string& symbol, Result fallback, Fn fn) const;
+
+    std::string directory_;
+    TickJournalOptions options_;
+    bool open_ = false;
+
+    mutable std::shared_mutex symbolsMutex_;
+    std::unordered_map<std::string, std::unique_ptr<SymbolJournal>> symbols_;
+    std::vector<std::unique_ptr<Segment>> retired_;  // Dropped by the last prune, still mapped for readers
+};
+
+} // namespace trading::infrastructure::marketdata
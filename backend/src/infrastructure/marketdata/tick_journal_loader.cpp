@@ -0,0 +1,77 @@
+#include "tick_journal_loader.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+namespace trading::infrastructure::marketdata {
+
+using trading::domain::Tick;
+
+TickJournalLoader::TickJournalLoader(const TickJournal& journal, std::string cursorPath, Sink sink, size_t batchTicks)
+    : journal_(journal), cursorPath_(std::move(cursorPath)), sink_(std::move(sink)), batchTicks_(std::max<size_t>(batchTicks, 1)) {}
+
+bool TickJournalLoader::open() {
+    cursors_.clear();
+    std::ifstream in(cursorPath_);
+    if (!in) {
+        return !std::filesystem::exists(cursorPath_);
+    }
+    std::string symbol;
+    uint64_t position = 0;
+    while (in >> symbol >> position) {
+        cursors_[symbol] = position;
+    }
+    return in.eof();
+}
+
+size_t TickJournalLoader::loadOnce() {
+    size_t loaded = 0;
+    for (const auto& symbol : journal_.symbols()) {
+        uint64_t& cursor = cursors_[symbol];
+        // Ticks pruned before they were loaded are skipped
+        auto spans = journal_.since(symbol, cursor, &cursor);
+        for (auto span : spans) {
+            while (!span.empty()) {
+                auto batch = span.first(std::min(span.size(), batchTicks_));
+                if (!sink_(symbol, batch)) {
+                    return loaded;
+                }
+                cursor += batch.size();
+                loaded += batch.size();
+                span = span.subspan(batch.size());
+                saveCursors();
+            }
+        }
+    }
+    return loaded;
+}
+
+uint64_t TickJournalLoader::cursor(const std::string& symbol) const {
+    auto it = cursors_.find(symbol);
+    return it != cursors_.end() ? it->second : 0;
+}
+
+bool TickJournalLoader::saveCursors() const {
+    std::string temporary = cursorPath_ + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        for (const auto& [symbol, position] : cursors_) {
+            out << symbol << ' ' << position << '\n';
+        }
+        if (!out.flush()) {
+            std::cerr << "[Journal Loader] Cannot write " << temporary << std::endl;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, cursorPath_, error);
+    if (error) {
+        std::cerr << "[Journal Loader] Cannot replace " << cursorPath_ << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace trading::infrastructure::marketdata
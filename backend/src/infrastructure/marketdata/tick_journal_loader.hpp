@@ -0,0 +1,49 @@
+#pragma once
+
+#include "tick_journal.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <span>
+#include <string>
+
+namespace trading::infrastructure::marketdata {
+
+// Ticks handed to the sink per call at most
+inline constexpr size_t kJournalLoadBatch = 10'000;
+
+// Loads journaled ticks into a store (the ClickHouse ticks table) in batches.
+// It keeps one cursor per symbol, a journal position, in a text file of
+// "<symbol> <position>" lines that is replaced atomically after every batch
+// that loads. A restart resumes where the last loaded batch ended, so a
+// batch may be loaded twice but none is skipped, except ticks pruned before
+// they were loaded. Not thread-safe: one thread runs loadOnce.
+class TickJournalLoader {
+public:
+    // True once the batch is stored; false leaves the cursor where it was
+    using Sink = std::function<bool(const std::string& symbol, std::span<const trading::domain::Tick> ticks)>;
+
+    TickJournalLoader(const TickJournal& journal, std::string cursorPath, Sink sink, size_t batchTicks = kJournalLoadBatch);
+
+    // Reads the cursor file; a missing file starts every symbol at 0
+    bool open();
+
+    // Hands every symbol's ticks past its cursor to the sink, batchTicks at a
+    // time, until it is caught up or the sink fails. Returns how many ticks
+    // were loaded.
+    size_t loadOnce();
+
+    uint64_t cursor(const std::string& symbol) const;
+
+private:
+    bool saveCursors() const;
+
+    const TickJournal& journal_;
+    std::string cursorPath_;
+    Sink sink_;
+    size_t batchTicks_;
+    std::map<std::string, uint64_t> cursors_;
+};
+
+} // namespace trading::infrastructure::marketdata
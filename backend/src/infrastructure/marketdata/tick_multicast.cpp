@@ -0,0 +1,251 @@
+#include "tick_multicast.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace trading::infrastructure::marketdata {
+
+namespace {
+
+constexpr char kDatagramMagic[4] = {'B', 'T', 'R', 'L'};
+// 2: fields in network byte order (1 sent the host's raw struct memory)
+constexpr uint32_t kDatagramVersion = 2;
+// Absorbs a burst of about 50k ticks while an edge is busy broadcasting; the
+// kernel caps it at net.core.rmem_max
+constexpr int kReceiveBufferBytes = 4 << 20;
+
+void putU32(uint8_t*& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        *out++ = static_cast<uint8_t>(value >> shift);
+    }
+}
+
+void putU64(uint8_t*& out, uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        *out++ = static_cast<uint8_t>(value >> shift);
+    }
+}
+
+uint32_t getU32(const uint8_t*& in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value = (value << 8) | *in++;
+    }
+    return value;
+}
+
+uint64_t getU64(const uint8_t*& in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | *in++;
+    }
+    return value;
+}
+
+bool parseAddress(const std::string& text, in_addr& address) {
+    return ::inet_pton(AF_INET, text.c_str(), &address) == 1;
+}
+
+} // namespace
+
+void encodeRelayDatagram(uint64_t epoch, const RelayTick& tick, uint8_t* out) {
+    std::memcpy(out, kDatagramMagic, sizeof(kDatagramMagic));
+    out += sizeof(kDatagramMagic);
+    putU32(out, kDatagramVersion);
+    putU64(out, epoch);
+    putU64(out, tick.seq);
+    putU64(out, static_cast<uint64_t>(tick.tick.ts));
+    putU64(out, std::bit_cast<uint64_t>(tick.tick.bid));
+    putU64(out, std::bit_cast<uint64_t>(tick.tick.ask));
+    putU64(out, std::bit_cast<uint64_t>(tick.tick.last));
+    putU64(out, tick.tick.volume);
+    putU64(out, std::bit_cast<uint64_t>(tick.changePercent));
+    std::memcpy(out, tick.symbol, sizeof(tick.symbol));
+}
+
+bool decodeRelayDatagram(const uint8_t* data, size_t size, uint64_t& epoch, RelayTick& tick) {
+    if (size != kRelayDatagramBytes || std::memcmp(data, kDatagramMagic, sizeof(kDatagramMagic)) != 0) {
+        return false;
+    }
+    const uint8_t* in = data + sizeof(kDatagramMagic);
+    if (getU32(in) != kDatagramVersion) {
+        return false;
+    }
+    epoch = getU64(in);
+    tick.seq = getU64(in);
+    tick.tick.ts = static_cast<int64_t>(getU64(in));
+    tick.tick.bid = std::bit_cast<double>(getU64(in));
+    tick.tick.ask = std::bit_cast<double>(getU64(in));
+    tick.tick.last = std::bit_cast<double>(getU64(in));
+    tick.tick.volume = getU64(in);
+    tick.changePercent = std::bit_cast<double>(getU64(in));
+    std::memcpy(tick.symbol, in, sizeof(tick.symbol));
+    tick.symbol[sizeof(tick.symbol) - 1] = '\0';
+    return true;
+}
+
+MulticastTickSender::~MulticastTickSender() {
+    close();
+}
+
+bool MulticastTickSender::open(const std::string& group, uint16_t port, const std::string& interfaceAddress, int ttl) {
+    close();
+    destination_ = {};
+    destination_.sin_family = AF_INET;
+    destination_.sin_port = htons(port);
+    in_addr local{};
+    if (!parseAddress(group, destination_.sin_addr) || (!interfaceAddress.empty() && !parseAddress(interfaceAddress, local))) {
+        std::cerr << "[Tick Relay] Invalid multicast address " << group << " / " << interfaceAddress << std::endl;
+        return false;
+    }
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) {
+        std::cerr << "[Tick Relay] Cannot create UDP socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    unsigned char hops = static_cast<unsigned char>(ttl);
+    unsigned char loop = 1;
+    bool configured = ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops)) == 0 &&
+                      ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0;
+    if (configured && !interfaceAddress.empty()) {
+        configured = ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) == 0;
+    }
+    if (!configured) {
+        std::cerr << "[Tick Relay] Cannot configure multicast socket: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    // Any value other than the previous sender's; 0 is kept for "no sender yet"
+    epoch_ = std::random_device{}() | (uint64_t{std::random_device{}()} << 32) | 1;
+    sent_ = 0;
+    return true;
+}
+
+void MulticastTickSender::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool MulticastTickSender::publish(const RelayTick& tick) {
+    if (fd_ < 0) {
+        return false;
+    }
+    uint8_t datagram[kRelayDatagramBytes];
+    encodeRelayDatagram(epoch_, tick, datagram);
+    ssize_t sent = ::sendto(fd_, datagram, sizeof(datagram), 0, reinterpret_cast<const sockaddr*>(&destination_),
+                            sizeof(destination_));
+    if (sent != static_cast<ssize_t>(sizeof(datagram))) {
+        return false;
+    }
+    ++sent_;
+    return true;
+}
+
+MulticastTickReceiver::~MulticastTickReceiver() {
+    close();
+}
+
+bool MulticastTickReceiver::open(const std::string& group, uint16_t port, const std::string& interfaceAddress) {
+    close();
+    ip_mreq membership{};
+    if (!parseAddress(group, membership.imr_multiaddr) ||
+        (!interfaceAddress.empty() && !parseAddress(interfaceAddress, membership.imr_interface))) {
+        std::cerr << "[Tick Relay] Invalid multicast address " << group << " / " << interfaceAddress << std::endl;
+        return false;
+    }
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) {
+        std::cerr << "[Tick Relay] Cannot create UDP socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    int receiveBuffer = kReceiveBufferBytes;
+    ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    // Bound to the group address, the socket only sees that group's traffic on this port
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr = membership.imr_multiaddr;
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0 ||
+        ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        std::cerr << "[Tick Relay] Cannot join " << group << ":" << port << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    started_ = false;
+    epoch_ = 0;
+    lastSeq_ = 0;
+    retiredEpochs_.fill(0);
+    nextRetired_ = 0;
+    return true;
+}
+
+void MulticastTickReceiver::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+size_t MulticastTickReceiver::poll(std::vector<RelayTick>& out, std::chrono::milliseconds wait) {
+    if (fd_ < 0) {
+        return 0;
+    }
+    pollfd readable{fd_, POLLIN, 0};
+    if (::poll(&readable, 1, static_cast<int>(wait.count())) <= 0) {
+        return 0;
+    }
+
+    size_t count = 0;
+    uint8_t datagram[kRelayDatagramBytes + 1];  // One spare byte so oversized datagrams show
+    ssize_t received;
+    while ((received = ::recv(fd_, datagram, sizeof(datagram), 0)) >= 0) {
+        uint64_t epoch = 0;
+        RelayTick tick;
+        if (!decodeRelayDatagram(datagram, static_cast<size_t>(received), epoch, tick)) {
+            continue;
+        }
+        if (!started_ || epoch != epoch_) {
+            // A late datagram from a sender already replaced must not switch back to it
+            if (epoch == 0 || std::find(retiredEpochs_.begin(), retiredEpochs_.end(), epoch) != retiredEpochs_.end()) {
+                continue;
+            }
+            if (started_) {
+                std::cout << "[Tick Relay] Multicast publisher restarted, following its new sequence" << std::endl;
+                retiredEpochs_[nextRetired_++ % kRetiredEpochs] = epoch_;
+            }
+            started_ = true;
+            epoch_ = epoch;
+            lastSeq_ = tick.seq - 1;
+        }
+        // Late or duplicated: the gap it fills was already counted as lost
+        if (tick.seq <= lastSeq_) {
+            continue;
+        }
+        lost_ += tick.seq - lastSeq_ - 1;
+        lastSeq_ = tick.seq;
+        out.push_back(tick);
+        ++count;
+    }
+    delivered_ += count;
+    return count;
+}
+
+} // namespace trading::infrastructure::marketdata
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "tick_relay.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <netinet/in.h>
+
+namespace trading::infrastructure::marketdata {
+
+// Wire form of one multicast tick: magic, version, the sender's epoch and the
+// RelayTick fields, each integer and double (as its IEEE-754 bits) in network
+// byte order, so hosts of any endianness or struct layout agree on it.
+inline constexpr size_t kRelayDatagramBytes = 88;
+
+void encodeRelayDatagram(uint64_t epoch, const RelayTick& tick, uint8_t* out);
+// False for anything but a well-formed datagram of the current version
+bool decodeRelayDatagram(const uint8_t* data, size_t size, uint64_t& epoch, RelayTick& tick);
+
+// UDP multicast leg of the relay, for edge servers on other hosts. Every tick
+// is one datagram carrying the RelayTick and the sender's epoch, a value
+// picked when the sender opens. UDP neither retransmits nor orders: a
+// receiver counts missing sequence numbers as lost and drops datagrams
+// behind the last delivered one. A new epoch means the publisher restarted,
+// and the receiver follows its new sequence; epochs it has already left
+// behind are ignored, so a late datagram cannot switch it back.
+class MulticastTickSender : public TickRelayPublisher {
+public:
+    MulticastTickSender() = default;
+    ~MulticastTickSender() override;
+
+    MulticastTickSender(const MulticastTickSender&) = delete;
+    MulticastTickSender& operator=(const MulticastTickSender&) = delete;
+
+    // ttl 1 keeps the ticks on the local network; loopback delivery stays on
+    // so edges on the publisher's host receive them too
+    bool open(const std::string& group, uint16_t port, const std::string& interfaceAddress = "", int ttl = 1);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    bool publish(const RelayTick& tick) override;
+    TickRelayStats stats() const override { return {sent_, 0}; }
+
+private:
+    int fd_ = -1;
+    sockaddr_in destination_{};
+    uint64_t epoch_ = 0;
+    uint64_t sent_ = 0;
+};
+
+class MulticastTickReceiver : public TickRelaySubscriber {
+public:
+    MulticastTickReceiver() = default;
+    ~MulticastTickReceiver() override;
+
+    MulticastTickReceiver(const MulticastTickReceiver&) = delete;
+    MulticastTickReceiver& operator=(const MulticastTickReceiver&) = delete;
+
+    // Several receivers on one host may join the same group and port
+    bool open(const std::string& group, uint16_t port, const std::string& interfaceAddress = "");
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    size_t poll(std::vector<RelayTick>& out, std::chrono::milliseconds wait) override;
+    TickRelayStats stats() const override { return {delivered_, lost_}; }
+
+private:
+    static constexpr size_t kRetiredEpochs = 8;
+
+    int fd_ = -1;
+    bool started_ = false;
+    uint64_t epoch_ = 0;
+    std::array<uint64_t, kRetiredEpochs> retiredEpochs_{};  // Most recent senders replaced, 0 when unused
+    size_t nextRetired_ = 0;
+    uint64_t lastSeq_ = 0;
+    uint64_t delivered_ = 0;
+    uint64_t lost_ = 0;
+};
+
+} // namespace trading::infrastructure::marketdata
@@ -0,0 +1,91 @@
+#include "tick_relay.hpp"
+#include "tick_multicast.hpp"
+#include "tick_ring.hpp"
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+
+namespace trading::infrastructure::marketdata {
+
+RelayTick RelayTick::make(uint64_t seq, const std::string& symbol, const trading::domain::Tick& tick, double changePercent) {
+    RelayTick relayTick{};
+    relayTick.seq = seq;
+    relayTick.tick = tick;
+    relayTick.changePercent = changePercent;
+    std::strncpy(relayTick.symbol, symbol.c_str(), sizeof(relayTick.symbol) - 1);
+    return relayTick;
+}
+
+std::string RelayTick::symbolName() const {
+    return std::string(symbol, strnlen(symbol, sizeof(symbol)));
+}
+
+std::optional<RelayEndpoint> RelayEndpoint::parse(const std::string& text) {
+    RelayEndpoint endpoint;
+    if (text.rfind("shm:", 0) == 0) {
+        endpoint.kind = Kind::SHARED_MEMORY;
+        endpoint.path = text.substr(4);
+        return endpoint.path.empty() ? std::nullopt : std::optional<RelayEndpoint>(endpoint);
+    }
+    if (text.rfind("udp:", 0) != 0) {
+        return std::nullopt;
+    }
+
+    // udp:<group>:<port>[@<interface address>]
+    std::string rest = text.substr(4);
+    if (size_t at = rest.find('@'); at != std::string::npos) {
+        endpoint.interfaceAddress = rest.substr(at + 1);
+        rest.resize(at);
+    }
+    size_t colon = rest.rfind(':');
+    if (colon == std::string::npos) {
+        return std::nullopt;
+    }
+    endpoint.kind = Kind::MULTICAST;
+    endpoint.group = rest.substr(0, colon);
+    try {
+        size_t consumed = 0;
+        int port = std::stoi(rest.substr(colon + 1), &consumed);
+        if (consumed != rest.size() - colon - 1 || port <= 0 || port > 65535) {
+            return std::nullopt;
+        }
+        endpoint.port = static_cast<uint16_t>(port);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+
+    in_addr group{};
+    in_addr local{};
+    if (::inet_pton(AF_INET, endpoint.group.c_str(), &group) != 1 || !IN_MULTICAST(ntohl(group.s_addr)) ||
+        (!endpoint.interfaceAddress.empty() && ::inet_pton(AF_INET, endpoint.interfaceAddress.c_str(), &local) != 1)) {
+        return std::nullopt;
+    }
+    return endpoint;
+}
+
+std::string RelayEndpoint::describe() const {
+    if (kind == Kind::SHARED_MEMORY) {
+        return "shm:" + path;
+    }
+    return "udp:" + group + ":" + std::to_string(port) + (interfaceAddress.empty() ? "" : "@" + interfaceAddress);
+}
+
+std::unique_ptr<TickRelayPublisher> openTickRelayPublisher(const RelayEndpoint& endpoint) {
+    if (endpoint.kind == RelayEndpoint::Kind::SHARED_MEMORY) {
+        auto writer = std::make_unique<TickRingWriter>();
+        return writer->open(endpoint.path) ? std::move(writer) : nullptr;
+    }
+    auto sender = std::make_unique<MulticastTickSender>();
+    return sender->open(endpoint.group, endpoint.port, endpoint.interfaceAddress) ? std::move(sender) : nullptr;
+}
+
+std::unique_ptr<TickRelaySubscriber> openTickRelaySubscriber(const RelayEndpoint& endpoint) {
+    if (endpoint.kind == RelayEndpoint::Kind::SHARED_MEMORY) {
+        auto reader = std::make_unique<TickRingReader>();
+        return reader->open(endpoint.path) ? std::move(reader) : nullptr;
+    }
+    auto receiver = std::make_unique<MulticastTickReceiver>();
+    return receiver->open(endpoint.group, endpoint.port, endpoint.interfaceAddress) ? std::move(receiver) : nullptr;
+}
+
+} // namespace trading::infrastructure::marketdata
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../../domain/types.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace trading::infrastructure::marketdata {
+
+// One tick as it travels from the publisher to the edge servers. seq is the
+// publisher's tick sequence; edges broadcast it unchanged, so every edge shows
+// the same ticks in the same order as the publisher.
+struct RelayTick {
+    uint64_t seq;
+    trading::domain::Tick tick;
+    double changePercent;
+    char symbol[16];  // NUL-padded
+
+    static RelayTick make(uint64_t seq, const std::string& symbol, const trading::domain::Tick& tick, double changePercent);
+    std::string symbolName() const;
+};
+static_assert(std::is_trivially_copyable_v<RelayTick> && sizeof(RelayTick) == 72, "RelayTick is copied as raw bytes");
+
+struct TickRelayStats {
+    uint64_t ticks = 0;  // Published, or delivered to the subscriber's caller
+    uint64_t lost = 0;   // Sequence numbers a subscriber never saw: overrun in the ring, dropped on the wire
+};
+
+// Publisher side of the relay. One thread publishes, in sequence order.
+class TickRelayPublisher {
+public:
+    virtual ~TickRelayPublisher() = default;
+    virtual bool publish(const RelayTick& tick) = 0;
+    virtual TickRelayStats stats() const = 0;
+};
+
+// Edge side of the relay. Ticks come out in strictly increasing seq order;
+// anything arriving behind the last delivered seq is dropped.
+class TickRelaySubscriber {
+public:
+    virtual ~TickRelaySubscriber() = default;
+    // Appends every tick available now, waiting up to wait for the first one
+    virtual size_t poll(std::vector<RelayTick>& out, std::chrono::milliseconds wait) = 0;
+    virtual TickRelayStats stats() const = 0;
+};
+
+// "shm:/dev/shm/bull-ticks" for edges on the publisher's host,
+// "udp:239.192.0.1:30001" (optionally "@<interface address>") across hosts
+struct RelayEndpoint {
+    enum class Kind { SHARED_MEMORY, MULTICAST };
+
+    Kind kind = Kind::SHARED_MEMORY;
+    std::string path;              // Ring file, SHARED_MEMORY
+    std::string group;             // Multicast group, MULTICAST
+    uint16_t port = 0;
+    std::string interfaceAddress;  // Local interface to send and join on; empty for the default route
+
+    static std::optional<RelayEndpoint> parse(const std::string& text);
+    std::string describe() const;
+};
+
+// nullptr (and a logged reason) when the endpoint cannot be opened
+std::unique_ptr<TickRelayPublisher> openTickRelayPublisher(const RelayEndpoint& endpoint);
+std::unique_ptr<TickRelaySubscriber> openTickRelaySubscriber(const RelayEndpoint& endpoint);
+
+} // namespace trading::infrastructure::marketdata
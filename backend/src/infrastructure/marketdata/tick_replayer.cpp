@@ -0,0 +1,92 @@
+#include "tick_replayer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace trading::infrastructure::marketdata {
+
+namespace {
+
+// Long gaps in a capture (a quiet market, an overnight break) are slept in
+// slices so a stop request is noticed promptly
+constexpr auto kMaxSleepSlice = std::chrono::milliseconds(100);
+
+} // namespace
+
+TickReplayer::TickReplayer(const TickCaptureReader& capture, ReplayOptions options)
+    : capture_(capture), options_(options) {}
+
+ReplayStats TickReplayer::run(const Sink& sink, const std::atomic<bool>& running) const {
+    using Clock = std::chrono::steady_clock;
+
+    ReplayStats stats;
+    if (capture_.empty()) {
+        return stats;
+    }
+
+    const int64_t firstTs = capture_[0].ts;
+    const int64_t span = std::max<int64_t>(capture_[capture_.size() - 1].ts - firstTs, 0);
+    const size_t symbolCount = capture_.symbols().size();
+    const bool paced = options_.speed > 0.0 && std::isfinite(options_.speed);
+    const auto started = Clock::now();
+
+    while (running.load(std::memory_order_relaxed)) {
+        const auto passStart = Clock::now();
+        const int64_t shift = static_cast<int64_t>(stats.passes) * (span + 1);
+
+        for (const TickRecord& record : capture_) {
+            if (!running.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if (record.symbolId >= symbolCount) {
+                ++stats.skipped;
+                continue;
+            }
+
+            if (paced) {
+                double offsetNs = static_cast<double>(std::max<int64_t>(record.ts - firstTs, 0)) * 1e6 / options_.speed;
+                auto due = passStart + std::chrono::nanoseconds(static_cast<int64_t>(offsetNs));
+                auto now = Clock::now();
+                while (now < due && running.load(std::memory_order_relaxed)) {
+                    std::this_thread::sleep_for(std::min<Clock::duration>(due - now, kMaxSleepSlice));
+                    now = Clock::now();
+                }
+                stats.maxLag = std::max(stats.maxLag, std::chrono::duration_cast<std::chrono::nanoseconds>(now - due));
+            }
+
+            trading::domain::Tick tick(record.ts + shift, record.bid, record.ask, record.last, record.volume);
+            sink(capture_.symbol(record), tick);
+            ++stats.ticks;
+        }
+
+        ++stats.passes;
+        if (!options_.loop) {
+            break;
+        }
+    }
+
+    stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started);
+    return stats;
+}
+
+std::optional<double> TickReplayer::parseSpeed(const std::string& text) {
+    if (text == "max" || text == "0") {
+        return 0.0;
+    }
+    std::string number = text;
+    if (!number.empty() && (number.back() == 'x' || number.back() == 'X')) {
+        number.pop_back();
+    }
+    try {
+        size_t consumed = 0;
+        double speed = std::stod(number, &consumed);
+        if (consumed != number.size() || !std::isfinite(speed) || speed < 0.0) {
+            return std::nullopt;
+        }
+        return speed;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+} // namespace trading::infrastructure::marketdata
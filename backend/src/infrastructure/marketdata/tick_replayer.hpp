@@ -0,0 +1,51 @@
+#pragma once
+
+#include "tick_capture.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace trading::infrastructure::marketdata {
+
+struct ReplayOptions {
+    double speed = 1.0;  // Multiple of recorded time; 0 replays as fast as the sink accepts
+    bool loop = false;   // Start over at the end; each pass shifts timestamps past the previous one
+};
+
+struct ReplayStats {
+    uint64_t ticks = 0;
+    uint64_t skipped = 0;    // Records naming a symbol outside the table
+    uint32_t passes = 0;
+    std::chrono::nanoseconds elapsed{0};
+    std::chrono::nanoseconds maxLag{0};  // Furthest a tick was delivered behind its schedule
+
+    double ticksPerSecond() const {
+        return elapsed.count() > 0 ? static_cast<double>(ticks) * 1e9 / static_cast<double>(elapsed.count()) : 0.0;
+    }
+};
+
+// Feeds a capture back through a sink in recorded order. Pacing follows the
+// recorded timestamps divided by the speed factor, measured from the start of
+// each pass, so a replay is the same tick sequence on every run and only the
+// delivery times depend on the machine.
+class TickReplayer {
+public:
+    using Sink = std::function<void(const std::string& symbol, const trading::domain::Tick& tick)>;
+
+    explicit TickReplayer(const TickCaptureReader& capture, ReplayOptions options = {});
+
+    // Runs until the capture (or, when looping, running) is exhausted
+    ReplayStats run(const Sink& sink, const std::atomic<bool>& running) const;
+
+    // "1", "10x", "0.5" or "max"
+    static std::optional<double> parseSpeed(const std::string& text);
+
+private:
+    const TickCaptureReader& capture_;
+    ReplayOptions options_;
+};
+
+} // namespace trading::infrastructure::marketdata
@@ -0,0 +1,265 @@
+#include "tick_ring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trading::infrastructure::marketdata {
+
+namespace {
+
+constexpr char kRingMagic[8] = {'B', 'U', 'L', 'L', 'R', 'I', 'N', 'G'};
+constexpr uint32_t kRingVersion = 1;
+constexpr size_t kRingHeaderSize = 4096;
+// How long an idle reader sleeps between looks at the head, and how often it
+// checks whether the publisher has replaced the ring file
+constexpr auto kIdleSleep = std::chrono::microseconds(50);
+constexpr auto kReopenCheckInterval = std::chrono::seconds(1);
+
+struct RingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;
+    alignas(64) uint64_t head;  // Ticks published; written with release, read with acquire
+};
+static_assert(sizeof(RingHeader) <= kRingHeaderSize);
+
+struct Slot {
+    uint64_t stamp;  // Position + 1 once the slot holds that position's tick, 0 while it is rewritten
+    RelayTick tick;
+};
+
+// Readers map the ring read-only; an atomic load never writes, so the cast is safe
+std::atomic_ref<uint64_t> atomicAt(const uint64_t& value) {
+    return std::atomic_ref<uint64_t>(const_cast<uint64_t&>(value));
+}
+
+RingHeader* headerOf(const uint8_t* data) {
+    return reinterpret_cast<RingHeader*>(const_cast<uint8_t*>(data));
+}
+
+Slot* slotsOf(const uint8_t* data) {
+    return reinterpret_cast<Slot*>(const_cast<uint8_t*>(data) + kRingHeaderSize);
+}
+
+size_t ringSize(size_t capacity) {
+    return kRingHeaderSize + capacity * sizeof(Slot);
+}
+
+} // namespace
+
+TickRingWriter::TickRingWriter(size_t capacity)
+    : capacity_(std::bit_ceil(std::max<size_t>(capacity, 2))) {}
+
+TickRingWriter::~TickRingWriter() {
+    close();
+}
+
+bool TickRingWriter::open(const std::string& path) {
+    close();
+    std::string temporary = path + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "[Tick Relay] Cannot create " << temporary << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    size_t size = ringSize(capacity_);
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "[Tick Relay] Cannot size " << temporary << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "[Tick Relay] Cannot map " << temporary << ": " << std::strerror(errno) << std::endl;
+        ::unlink(temporary.c_str());
+        return false;
+    }
+
+    data_ = static_cast<uint8_t*>(mapping);
+    mappedSize_ = size;
+    head_ = 0;
+    RingHeader* header = headerOf(data_);
+    std::memcpy(header->magic, kRingMagic, sizeof(header->magic));
+    header->version = kRingVersion;
+    header->recordSize = sizeof(RelayTick);
+    header->capacity = capacity_;
+    header->head = 0;
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "[Tick Relay] Cannot move ring into place at " << path << ": " << std::strerror(errno) << std::endl;
+        ::unlink(temporary.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TickRingWriter::close() {
+    if (data_) {
+        ::munmap(data_, mappedSize_);
+        data_ = nullptr;
+        mappedSize_ = 0;
+    }
+}
+
+bool TickRingWriter::publish(const RelayTick& tick) {
+    if (!data_) {
+        return false;
+    }
+    Slot& slot = slotsOf(data_)[head_ & (capacity_ - 1)];
+    std::atomic_ref<uint64_t> stamp(slot.stamp);
+    stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.tick, &tick, sizeof(RelayTick));
+    stamp.store(head_ + 1, std::memory_order_release);
+    ++head_;
+    std::atomic_ref<uint64_t>(headerOf(data_)->head).store(head_, std::memory_order_release);
+    return true;
+}
+
+TickRingReader::~TickRingReader() {
+    close();
+}
+
+bool TickRingReader::open(const std::string& path) {
+    close();
+    path_ = path;
+    if (!map(path)) {
+        return false;
+    }
+    cursor_ = atomicAt(headerOf(data_)->head).load(std::memory_order_acquire);
+    lastReopenCheck_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+void TickRingReader::close() {
+    unmap();
+}
+
+bool TickRingReader::map(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st {};
+    if (fd < 0 || ::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kRingHeaderSize) {
+        std::cerr << "[Tick Relay] Cannot open ring " << path << ": " << (fd < 0 ? std::strerror(errno) : "file too small")
+                  << std::endl;
+        if (fd >= 0) ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "[Tick Relay] Cannot map ring " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    const auto* header = static_cast<const RingHeader*>(mapping);
+    if (std::memcmp(header->magic, kRingMagic, sizeof(header->magic)) != 0 || header->version != kRingVersion ||
+        header->recordSize != sizeof(RelayTick) || !std::has_single_bit(header->capacity) ||
+        ringSize(header->capacity) > size) {
+        std::cerr << "[Tick Relay] Ring " << path << " has an unknown layout" << std::endl;
+        ::munmap(mapping, size);
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    mappedSize_ = size;
+    capacity_ = header->capacity;
+    device_ = st.st_dev;
+    inode_ = st.st_ino;
+    return true;
+}
+
+void TickRingReader::unmap() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), mappedSize_);
+        data_ = nullptr;
+        mappedSize_ = 0;
+    }
+}
+
+size_t TickRingReader::drain(std::vector<RelayTick>& out) {
+    const Slot* slots = slotsOf(data_);
+    uint64_t head = atomicAt(headerOf(data_)->head).load(std::memory_order_acquire);
+    size_t count = 0;
+
+    // Lapped: the ticks between the cursor and halfway behind the head are gone
+    auto skipAhead = [&] {
+        uint64_t resume = head - capacity_ / 2;
+        lost_ += resume - cursor_;
+        cursor_ = resume;
+    };
+
+    while (cursor_ < head) {
+        if (head - cursor_ > capacity_) {
+            skipAhead();
+        }
+        const Slot& slot = slots[cursor_ & (capacity_ - 1)];
+        uint64_t before = atomicAt(slot.stamp).load(std::memory_order_acquire);
+        if (before == cursor_ + 1) {
+            RelayTick tick;
+            std::memcpy(&tick, &slot.tick, sizeof(RelayTick));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (atomicAt(slot.stamp).load(std::memory_order_relaxed) == before) {
+                out.push_back(tick);
+                ++cursor_;
+                ++count;
+                continue;
+            }
+        }
+        // The slot was taken for a newer position while we read it, so the
+        // publisher is at least a full ring ahead by now
+        head = std::max(atomicAt(headerOf(data_)->head).load(std::memory_order_acquire), cursor_ + capacity_);
+        skipAhead();
+    }
+    delivered_ += count;
+    return count;
+}
+
+void TickRingReader::reopenIfReplaced() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastReopenCheck_ < kReopenCheckInterval) {
+        return;
+    }
+    lastReopenCheck_ = now;
+
+    struct stat st {};
+    if (::stat(path_.c_str(), &st) != 0 || (st.st_dev == device_ && st.st_ino == inode_)) {
+        return;
+    }
+    // Ticks left in the old ring are already drained; the new publisher starts its own sequence
+    unmap();
+    if (map(path_)) {
+        cursor_ = 0;
+        std::cout << "[Tick Relay] Ring at " << path_ << " was replaced, following the new publisher" << std::endl;
+    }
+}
+
+size_t TickRingReader::poll(std::vector<RelayTick>& out, std::chrono::milliseconds wait) {
+    auto deadline = std::chrono::steady_clock::now() + wait;
+    while (true) {
+        if (data_) {
+            if (size_t count = drain(out)) {
+                return count;
+            }
+        }
+        reopenIfReplaced();
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return 0;
+        }
+        std::this_thread::sleep_for(kIdleSleep);
+    }
+}
+
+} // namespace trading::infrastructure::marketdata
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "tick_relay.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+namespace trading::infrastructure::marketdata {
+
+// Single-producer broadcast ring of RelayTicks in a shared file mapping,
+// normally on /dev/shm, for edge servers on the publisher's host:
+//
+//   offset 0     magic "BULLRING", version, record size, capacity, head
+//   offset 4096  Slot[capacity], Slot = { stamp, RelayTick }
+//
+// Readers never write to the mapping, so any number of edge processes can
+// follow one ring without slowing the publisher. Each slot's stamp is cleared
+// while the slot is rewritten and set to its position + 1 afterwards. A reader
+// copies the slot and keeps it only if the stamp still matches; a reader the
+// publisher has lapped counts the skipped ticks as lost and resumes halfway
+// behind the head.
+class TickRingWriter : public TickRelayPublisher {
+public:
+    explicit TickRingWriter(size_t capacity = 1 << 16);  // Rounded up to a power of two
+    ~TickRingWriter() override;
+
+    TickRingWriter(const TickRingWriter&) = delete;
+    TickRingWriter& operator=(const TickRingWriter&) = delete;
+
+    // Builds the ring beside path and renames it into place, so readers of a
+    // previous ring at path notice the new file and switch to it
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    bool publish(const RelayTick& tick) override;
+    TickRelayStats stats() const override { return {head_, 0}; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    size_t capacity_;
+    uint8_t* data_ = nullptr;
+    size_t mappedSize_ = 0;
+    uint64_t head_ = 0;
+};
+
+class TickRingReader : public TickRelaySubscriber {
+public:
+    TickRingReader() = default;
+    ~TickRingReader() override;
+
+    TickRingReader(const TickRingReader&) = delete;
+    TickRingReader& operator=(const TickRingReader&) = delete;
+
+    // Starts at the ring's current head: a new edge sees ticks published from now on
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    size_t poll(std::vector<RelayTick>& out, std::chrono::milliseconds wait) override;
+    TickRelayStats stats() const override { return {delivered_, lost_}; }
+
+private:
+    bool map(const std::string& path);
+    void unmap();
+    size_t drain(std::vector<RelayTick>& out);
+    // Remaps when the publisher has replaced the ring file (a restart)
+    void reopenIfReplaced();
+
+    std::string path_;
+    const uint8_t* data_ = nullptr;
+    size_t mappedSize_ = 0;
+    size_t capacity_ = 0;
+    dev_t device_ = 0;
+    ino_t inode_ = 0;
+    uint64_t cursor_ = 0;
+    uint64_t delivered_ = 0;
+    uint64_t lost_ = 0;
+    std::chrono::steady_clock::time_point lastReopenCheck_{};
+};
+
+} // namespace trading::infrastructure::marketdata
@@ -0,0 +1,207 @@
+#include "connection_tracker.hpp"
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+namespace trading::infrastructure::metrics {
+
+ConnectionTracker::ConnectionTracker(std::chrono::milliseconds sessionTtl)
+    : sessionTtl_(sessionTtl) {
+}
+
+void ConnectionTracker::pruneExpired(std::chrono::steady_clock::time_point now) {
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        const auto& session = *it->second;
+        if (!session.connected.load(std::memory_order_relaxed) && now - session.detachedAt >= sessionTtl_) {
+            expiredIds_.push_back(it->first);
+            it = sessions_.erase(it);
+            ++expiredTotal_;
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool ConnectionTracker::onConnect(const std::string& sessionId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto& entry = sessions_[sessionId];
+    bool resumed = false;
+    if (entry && !entry->connected.load(std::memory_order_relaxed) &&
+        std::chrono::steady_clock::now() - entry->detachedAt >= sessionTtl_) {
+        // Expired but not pruned yet: it comes back as a new session
+        expiredIds_.push_back(sessionId);
+        ++expiredTotal_;
+        entry.reset();
+    }
+    if (!entry) {
+        entry = std::make_unique<Session>();
+    } else if (entry->connected.load(std::memory_order_relaxed)) {
+        // Duplicate event for a socket we already count
+        return false;
+    } else {
+        resumed = true;
+        ++entry->resumes;
+        ++resumesTotal_;
+        // Counts restart with the next detach
+        entry->detachedFrames.store(0, std::memory_order_relaxed);
+        entry->detachedBytes.store(0, std::memory_order_relaxed);
+        if (entry->authenticated) {
+            ++authenticatedSessions_;
+        }
+    }
+
+    entry->connected.store(true, std::memory_order_relaxed);
+    ++openSockets_;
+    ++connectsTotal_;
+    return resumed;
+}
+
+void ConnectionTracker::onDisconnect(const std::string& sessionId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = sessions_.find(sessionId);
+    if (it != sessions_.end() && it->second->connected.load(std::memory_order_relaxed)) {
+        auto& session = *it->second;
+        session.connected.store(false, std::memory_order_relaxed);
+        session.detachedAt = std::chrono::steady_clock::now();
+        --openSockets_;
+        if (session.authenticated) {
+            --authenticatedSessions_;
+        }
+        ++disconnectsTotal_;
+    }
+}
+
+void ConnectionTracker::onAuthenticated(const std::string& sessionId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& entry = sessions_[sessionId];
+    if (!entry) {
+        // A request arrived before (or without) the connect event, so the socket is open
+        entry = std::make_unique<Session>();
+        entry->connected.store(true, std::memory_order_relaxed);
+        ++openSockets_;
+        ++connectsTotal_;
+    }
+    if (!entry->authenticated) {
+        entry->authenticated = true;
+        if (entry->connected.load(std::memory_order_relaxed)) {
+            ++authenticatedSessions_;
+        }
+    }
+}
+
+void ConnectionTracker::onLoggedOut(const std::string& sessionId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end() || !it->second->authenticated) {
+        return;
+    }
+    it->second->authenticated = false;
+    if (it->second->connected.load(std::memory_order_relaxed)) {
+        --authenticatedSessions_;
+    }
+}
+
+void ConnectionTracker::onSent(const std::string& sessionId, size_t bytes) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end()) {
+        return;
+    }
+    auto& session = *it->second;
+    session.framesSent.fetch_add(1, std::memory_order_relaxed);
+    session.bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+    if (!session.connected.load(std::memory_order_relaxed)) {
+        session.detachedFrames.fetch_add(1, std::memory_order_relaxed);
+        session.detachedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+void ConnectionTracker::onSent(const std::vector<std::string>& sessionIds, size_t bytes) {
+    for (const auto& sessionId : sessionIds) {
+        onSent(sessionId, bytes);
+    }
+}
+
+std::vector<std::string> ConnectionTracker::expireSessions() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    pruneExpired(std::chrono::steady_clock::now());
+    return std::exchange(expiredIds_, {});
+}
+
+int64_t ConnectionTracker::openSockets() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return openSockets_;
+}
+
+ConnectionStats ConnectionTracker::snapshot(bool includeSessions) const {
+    auto now = std::chrono::steady_clock::now();
+    ConnectionStats stats;
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    stats.openSockets = openSockets_;
+    stats.authenticatedSessions = authenticatedSessions_;
+    stats.connectsTotal = connectsTotal_;
+    stats.disconnectsTotal = disconnectsTotal_;
+    stats.resumesTotal = resumesTotal_;
+    stats.expiredTotal = expiredTotal_;
+    if (includeSessions) {
+        stats.sessions.reserve(sessions_.size());
+    }
+
+    for (const auto& [sessionId, session] : sessions_) {
+        bool connected = session->connected.load(std::memory_order_relaxed);
+        if (!connected) {
+            // Expired sessions are only pruned by the next expireSessions()
+            if (now - session->detachedAt >= sessionTtl_) {
+                continue;
+            }
+            ++stats.detachedSessions;
+        }
+
+        uint64_t detachedFrames = session->detachedFrames.load(std::memory_order_relaxed);
+        uint64_t detachedBytes = session->detachedBytes.load(std::memory_order_relaxed);
+        stats.detachedFrames += detachedFrames;
+        stats.detachedBytes += detachedBytes;
+        if (detachedFrames > 0) {
+            ++stats.sessionsWithDetachedSends;
+        }
+        stats.maxSessionDetachedFrames = std::max(stats.maxSessionDetachedFrames, detachedFrames);
+        stats.maxSessionDetachedBytes = std::max(stats.maxSessionDetachedBytes, detachedBytes);
+
+        if (!includeSessions) {
+            continue;
+        }
+
+        SessionConnectionStats s;
+        s.sessionId = sessionId;
+        s.connected = connected;
+        s.authenticated = session->authenticated;
+        s.resumes = session->resumes;
+        s.framesSent = session->framesSent.load(std::memory_order_relaxed);
+        s.bytesSent = session->bytesSent.load(std::memory_order_relaxed);
+        s.detachedFrames = detachedFrames;
+        s.detachedBytes = detachedBytes;
+        stats.sessions.push_back(std::move(s));
+    }
+    lock.unlock();
+
+    std::sort(stats.sessions.begin(), stats.sessions.end(),
+        [](const auto& a, const auto& b) { return a.sessionId < b.sessionId; });
+    return stats;
+}
+
+void ConnectionTracker::reset() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    sessions_.clear();
+    expiredIds_.clear();
+    openSockets_ = 0;
+    authenticatedSessions_ = 0;
+    connectsTotal_ = 0;
+    disconnectsTotal_ = 0;
+    resumesTotal_ = 0;
+    expiredTotal_ = 0;
+}
+
+} // namespace trading::infrastructure::metrics
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::infrastructure::metrics {
+
+struct SessionConnectionStats {
+    std::string sessionId;
+    bool connected = false;
+    bool authenticated = false;
+    uint64_t resumes = 0;
+    uint64_t framesSent = 0;
+    uint64_t bytesSent = 0;
+    // Frames handed to the transport since the socket went down, reset on resume.
+    // Counted here, not read from the transport, so frames the transport already
+    // held when the socket dropped are not included.
+    uint64_t detachedFrames = 0;
+    uint64_t detachedBytes = 0;
+};
+
+struct ConnectionStats {
+    int64_t openSockets = 0;
+    int64_t authenticatedSessions = 0;
+    int64_t detachedSessions = 0;
+    uint64_t connectsTotal = 0;
+    uint64_t disconnectsTotal = 0;
+    uint64_t resumesTotal = 0;
+    uint64_t expiredTotal = 0;
+    uint64_t detachedFrames = 0;
+    uint64_t detachedBytes = 0;
+    // The same per session in aggregate: how many sessions were sent frames and the most
+    int64_t sessionsWithDetachedSends = 0;
+    uint64_t maxSessionDetachedFrames = 0;
+    uint64_t maxSessionDetachedBytes = 0;
+    std::vector<SessionConnectionStats> sessions;
+};
+
+// Connection and session accounting driven by transport lifecycle events.
+// A session that disconnects stays "detached" for the session TTL; reconnecting
+// within that window counts as a resume instead of a new session. Lifecycle events
+// take an exclusive lock, send accounting only a shared one plus relaxed atomics.
+// Only expireSessions() scans for expired sessions, so lifecycle events stay O(1).
+class ConnectionTracker {
+private:
+    struct Session {
+        std::atomic<bool> connected{false};
+        std::atomic<uint64_t> framesSent{0};
+        std::atomic<uint64_t> bytesSent{0};
+        std::atomic<uint64_t> detachedFrames{0};
+        std::atomic<uint64_t> detachedBytes{0};
+        bool authenticated = false;
+        uint64_t resumes = 0;
+        std::chrono::steady_clock::time_point detachedAt;
+    };
+
+    std::chrono::milliseconds sessionTtl_;
+    std::unordered_map<std::string, std::unique_ptr<Session>> sessions_;
+    mutable std::shared_mutex mutex_;
+
+    int64_t openSockets_ = 0;
+    int64_t authenticatedSessions_ = 0;
+    uint64_t connectsTotal_ = 0;
+    uint64_t disconnectsTotal_ = 0;
+    uint64_t resumesTotal_ = 0;
+    uint64_t expiredTotal_ = 0;
+    // Expired session ids not yet handed out by expireSessions()
+    std::vector<std::string> expiredIds_;
+
+    // Requires the exclusive lock
+    void pruneExpired(std::chrono::steady_clock::time_point now);
+
+public:
+    explicit ConnectionTracker(std::chrono::milliseconds sessionTtl);
+
+    // Returns true when the connect resumed a detached session
+    bool onConnect(const std::string& sessionId);
+    void onDisconnect(const std::string& sessionId);
+
+    void onAuthenticated(const std::string& sessionId);
+    void onLoggedOut(const std::string& sessionId);
+
+    // Accounts a frame handed to the transport for one or more sessions
+    void onSent(const std::string& sessionId, size_t bytes);
+    void onSent(const std::vector<std::string>& sessionIds, size_t bytes);
+
+    // Prunes sessions past their TTL and returns every session id that expired since
+    // the last call, so per-session state elsewhere can be released with it
+    std::vector<std::string> expireSessions();
+
+    int64_t openSockets() const;
+    // Totals only, without the per-session list, when includeSessions is false
+    ConnectionStats snapshot(bool includeSessions = true) const;
+
+    void reset();
+};
+
+} // namespace trading::infrastructure::metrics
@@ -0,0 +1,107 @@
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace trading::infrastructure::metrics {
+
+namespace {
+constexpr double kNsPerMs = 1'000'000.0;
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t valueNs) noexcept {
+    if (valueNs < kSubBucketCount) {
+        return static_cast<size_t>(valueNs);
+    }
+    int exponent = 63 - std::countl_zero(valueNs);
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    uint64_t subBucket = (valueNs >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+    return static_cast<size_t>((exponent - kSubBucketBits + 1) * kSubBucketCount + subBucket);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) noexcept {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    int exponent = static_cast<int>(index / kSubBucketCount) + kSubBucketBits - 1;
+    uint64_t subBucket = index % kSubBucketCount;
+    return (kSubBucketCount + subBucket) << (exponent - kSubBucketBits);
+}
+
+uint64_t LatencyHistogram::bucketMidpoint(size_t index) noexcept {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    int exponent = static_cast<int>(index / kSubBucketCount) + kSubBucketBits - 1;
+    uint64_t width = 1ULL << (exponent - kSubBucketBits);
+    return bucketLowerBound(index) + width / 2;
+}
+
+void LatencyHistogram::record(uint64_t valueNs) noexcept {
+    buckets_[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(valueNs, std::memory_order_relaxed);
+
+    uint64_t currentMax = maxNs_.load(std::memory_order_relaxed);
+    while (valueNs > currentMax &&
+           !maxNs_.compare_exchange_weak(currentMax, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+double LatencyHistogram::meanNs() const noexcept {
+    uint64_t n = count();
+    if (n == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(sumNs_.load(std::memory_order_relaxed)) / static_cast<double>(n);
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const noexcept {
+    // Sum the buckets rather than trusting count_ so the scan is self-consistent
+    // while writers are still recording
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketMidpoint(i), maxNs());
+        }
+    }
+    return maxNs();
+}
+
+trading::domain::LatencyStats LatencyHistogram::snapshot() const {
+    trading::domain::LatencyStats stats;
+    stats.count = count();
+    stats.meanMs = meanNs() / kNsPerMs;
+    stats.p50Ms = static_cast<double>(valueAtPercentile(50.0)) / kNsPerMs;
+    stats.p95Ms = static_cast<double>(valueAtPercentile(95.0)) / kNsPerMs;
+    stats.p99Ms = static_cast<double>(valueAtPercentile(99.0)) / kNsPerMs;
+    stats.p999Ms = static_cast<double>(valueAtPercentile(99.9)) / kNsPerMs;
+    stats.maxMs = static_cast<double>(maxNs()) / kNsPerMs;
+    return stats;
+}
+
+void LatencyHistogram::reset() noexcept {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sumNs_.store(0, std::memory_order_relaxed);
+    maxNs_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace trading::infrastructure::metrics
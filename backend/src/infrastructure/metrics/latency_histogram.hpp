@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../../domain/types.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace trading::infrastructure::metrics {
+
+// HDR-style log-linear histogram over nanosecond values.
+// Every power-of-two range is split into 16 linear sub-buckets, which bounds the
+// relative error of any reported percentile to ~6%. Recording is a handful of
+// relaxed atomic increments, so it is safe to call from any handler thread.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr uint64_t kSubBucketCount = 1ULL << kSubBucketBits;
+    static constexpr int kMaxExponent = 40; // ~18 minutes in ns, larger values are clamped
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount + kSubBucketCount;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t valueNs) noexcept;
+
+    uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    uint64_t maxNs() const noexcept { return maxNs_.load(std::memory_order_relaxed); }
+    uint64_t sumNs() const noexcept { return sumNs_.load(std::memory_order_relaxed); }
+    uint64_t bucketCount(size_t index) const noexcept { return buckets_[index].load(std::memory_order_relaxed); }
+    double meanNs() const noexcept;
+
+    // Value (ns) at the given percentile in [0, 100]
+    uint64_t valueAtPercentile(double percentile) const noexcept;
+
+    // Snapshot with p50/p95/p99/p999 converted to milliseconds
+    trading::domain::LatencyStats snapshot() const;
+
+    void reset() noexcept;
+
+    // Bucket math, exposed for tests
+    static size_t bucketIndex(uint64_t valueNs) noexcept;
+    static uint64_t bucketLowerBound(size_t index) noexcept;
+    static uint64_t bucketMidpoint(size_t index) noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sumNs_{0};
+    std::atomic<uint64_t> maxNs_{0};
+};
+
+} // namespace trading::infrastructure::metrics
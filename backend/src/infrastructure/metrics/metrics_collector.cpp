@@ -0,0 +1,99 @@
+#include "metrics_collector.hpp"
+#include <algorithm>
+
+namespace trading::infrastructure::metrics {
+
+namespace {
+uint64_t msToNs(double ms) {
+    return ms <= 0.0 ? 0 : static_cast<uint64_t>(ms * 1'000'000.0);
+}
+}
+
+MetricsCollector::MetricsCollector(const std::vector<std::string>& methods)
+    : other_("other"), startTime_(std::chrono::steady_clock::now()) {
+    for (const auto& method : methods) {
+        methods_.emplace(method, std::make_unique<MethodStats>(method));
+    }
+}
+
+MetricsCollector::MethodStats& MetricsCollector::statsFor(const std::string& method) {
+    auto it = methods_.find(method);
+    return it != methods_.end() ? *it->second : other_;
+}
+
+double MetricsCollector::uptimeSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+}
+
+trading::domain::Metrics MetricsCollector::collect() {
+    auto ts = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    uint64_t requests = requests_.load(std::memory_order_relaxed);
+    uint64_t errors = errors_.load(std::memory_order_relaxed);
+    double uptime = uptimeSeconds();
+
+    trading::domain::Metrics metrics(
+        ts,
+        overall_.meanNs() / 1'000'000.0,
+        uptime > 0 ? static_cast<double>(requests) / uptime : 0.0,
+        requests > 0 ? static_cast<double>(errors) / static_cast<double>(requests) : 0.0,
+        static_cast<int32_t>(std::max<int64_t>(connections_.load(std::memory_order_relaxed), 0))
+    );
+    metrics.latency = overall_.snapshot();
+    return metrics;
+}
+
+void MetricsCollector::recordLatency(double latencyMs) {
+    overall_.record(msToNs(latencyMs));
+    requests_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsCollector::recordRequest(const std::string& method, double serviceMs, double queueMs, double serializeMs) {
+    auto& stats = statsFor(method);
+    stats.service.record(msToNs(serviceMs));
+    stats.queue.record(msToNs(queueMs));
+    stats.serialize.record(msToNs(serializeMs));
+    recordLatency(serviceMs + queueMs + serializeMs);
+}
+
+std::vector<trading::domain::MethodMetrics> MetricsCollector::collectMethods() {
+    std::vector<trading::domain::MethodMetrics> result;
+    result.reserve(methods_.size() + 1);
+
+    double uptime = uptimeSeconds();
+    auto append = [&](const MethodStats& stats) {
+        if (stats.service.count() == 0) {
+            return;
+        }
+        trading::domain::MethodMetrics m(stats.method);
+        m.service = stats.service.snapshot();
+        m.queue = stats.queue.snapshot();
+        m.serialize = stats.serialize.snapshot();
+        m.throughput = uptime > 0 ? static_cast<double>(m.service.count) / uptime : 0.0;
+        result.push_back(std::move(m));
+    };
+
+    for (const auto& [name, stats] : methods_) {
+        append(*stats);
+    }
+    append(other_);
+
+    std::sort(result.begin(), result.end(),
+        [](const auto& a, const auto& b) { return a.method < b.method; });
+    return result;
+}
+
+void MetricsCollector::recordError() {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsCollector::recordConnection() {
+    connections_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsCollector::recordDisconnection() {
+    connections_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace trading::infrastructure::metrics
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../../domain/interfaces.hpp"
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::infrastructure::metrics {
+
+// IMetricsCollector backed by per-RPC-method latency histograms.
+// The method table is fixed at construction so the hot path never takes a lock;
+// methods that were not registered are accounted under "other".
+class MetricsCollector : public trading::domain::IMetricsCollector {
+private:
+    struct MethodStats {
+        std::string method;
+        LatencyHistogram service;
+        LatencyHistogram queue;
+        LatencyHistogram serialize;
+
+        explicit MethodStats(std::string m) : method(std::move(m)) {}
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<MethodStats>> methods_;
+    MethodStats other_;
+    LatencyHistogram overall_;
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<int64_t> connections_{0};
+    std::chrono::steady_clock::time_point startTime_;
+
+    MethodStats& statsFor(const std::string& method);
+    double uptimeSeconds() const;
+
+public:
+    explicit MetricsCollector(const std::vector<std::string>& methods = {});
+    ~MetricsCollector() override = default;
+
+    // IMetricsCollector interface implementation
+    trading::domain::Metrics collect() override;
+    void recordLatency(double latencyMs) override;
+    void recordRequest(const std::string& method, double serviceMs, double queueMs, double serializeMs) override;
+    std::vector<trading::domain::MethodMetrics> collectMethods() override;
+
+    // Raw histograms for exposition, registered methods first and "other" last.
+    // visit(const std::string& method, service, queue, serialize)
+    template <typename Visit>
+    void visitHistograms(Visit&& visit) const {
+        for (const auto& [method, stats] : methods_) {
+            visit(stats->method, stats->service, stats->queue, stats->serialize);
+        }
+        visit(other_.method, other_.service, other_.queue, other_.serialize);
+    }
+    void recordError() override;
+    void recordConnection() override;
+    void recordDisconnection() override;
+};
+
+} // namespace trading::infrastructure::metrics
@@ -0,0 +1,93 @@
+#include "metrics_registry.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace trading::infrastructure::metrics {
+
+int64_t ShardedCounter::value() const noexcept {
+    int64_t sum = 0;
+    for (const auto& cell : cells_) {
+        sum += cell.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void ShardedCounter::reset() noexcept {
+    for (auto& cell : cells_) {
+        cell.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string MetricsRegistry::seriesKey(const std::string& name, const Labels& labels) {
+    std::string key = name;
+    for (const auto& [label, value] : labels) {
+        key += '\x1f';
+        key += label;
+        key += '=';
+        key += value;
+    }
+    return key;
+}
+
+ShardedCounter& MetricsRegistry::counter(const std::string& name, const Labels& labels) {
+    std::string key = seriesKey(name, labels);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = series_.find(key);
+        if (it != series_.end()) {
+            return it->second->counter;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& series = series_[key];
+    if (!series) {
+        series = std::make_unique<Series>(name, labels);
+        families_[name].push_back(series.get());
+    }
+    return series->counter;
+}
+
+int64_t MetricsRegistry::total(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    int64_t sum = 0;
+    for (const auto& [key, series] : series_) {
+        if (series->name == name) {
+            sum += series->counter.value();
+        }
+    }
+    return sum;
+}
+
+std::vector<CounterSample> MetricsRegistry::snapshot() const {
+    std::vector<CounterSample> samples;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        samples.reserve(series_.size());
+        for (const auto& [key, series] : series_) {
+            samples.push_back({series->name, series->labels, series->counter.value()});
+        }
+    }
+
+    std::sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) {
+        return a.name != b.name ? a.name < b.name : a.labels < b.labels;
+    });
+    return samples;
+}
+
+void MetricsRegistry::reset() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (auto& [key, series] : series_) {
+        series->counter.reset();
+    }
+}
+
+CounterFamily::CounterFamily(MetricsRegistry& registry, const std::string& name,
+                             const std::string& labelKey, const std::vector<std::string>& labelValues)
+    : other_(&registry.counter(name, {{labelKey, "other"}})) {
+    for (const auto& value : labelValues) {
+        counters_.emplace(value, &registry.counter(name, {{labelKey, value}}));
+    }
+}
+
+} // namespace trading::infrastructure::metrics
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::infrastructure::metrics {
+
+// Metric labels, kept sorted so the same label set always maps to the same series
+using Labels = std::map<std::string, std::string>;
+
+// 64-bit counter split into cache-line padded cells. Each thread is pinned to one
+// cell on first use, so concurrent increments from handler threads never share a
+// cache line. Reads aggregate all cells and are only needed on the metrics path.
+// Signed so the same type also serves as an up/down gauge.
+class ShardedCounter {
+public:
+    static constexpr size_t kShardCount = 64;
+    static constexpr size_t kCacheLineSize = 64;
+
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(int64_t delta) noexcept {
+        cells_[shardIndex()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+    void increment() noexcept { add(1); }
+    void decrement() noexcept { add(-1); }
+
+    int64_t value() const noexcept;
+    void reset() noexcept;
+
+    // Shard of the calling thread, assigned round-robin on first use
+    static size_t shardIndex() noexcept {
+        static std::atomic<size_t> nextShard{0};
+        thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+        return shard;
+    }
+
+private:
+    struct alignas(kCacheLineSize) Cell {
+        std::atomic<int64_t> value{0};
+    };
+
+    std::array<Cell, kShardCount> cells_{};
+};
+
+struct CounterSample {
+    std::string name;
+    Labels labels;
+    int64_t value;
+};
+
+// Named, labeled counter series. Lookup takes a shared lock, so hot paths should
+// resolve their unlabeled series once and keep the returned reference, which stays
+// valid for the lifetime of the registry.
+class MetricsRegistry {
+private:
+    struct Series {
+        std::string name;
+        Labels labels;
+        ShardedCounter counter;
+
+        Series(std::string n, Labels l) : name(std::move(n)), labels(std::move(l)) {}
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<Series>> series_;
+    std::map<std::string, std::vector<const Series*>> families_;  // Series grouped by name, for exposition
+    mutable std::shared_mutex mutex_;
+
+    static std::string seriesKey(const std::string& name, const Labels& labels);
+
+public:
+    MetricsRegistry() = default;
+    ~MetricsRegistry() = default;
+
+    ShardedCounter& counter(const std::string& name, const Labels& labels = {});
+
+    // Sum of every series with the given name, across all label sets
+    int64_t total(const std::string& name) const;
+
+    std::vector<CounterSample> snapshot() const;
+
+    // Visits every series grouped by name, in name order, without copying.
+    // visit(const std::string& name, const Labels& labels, int64_t value)
+    template <typename Visit>
+    void visit(Visit&& visit) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const auto& [name, family] : families_) {
+            for (const auto* series : family) {
+                visit(name, series->labels, series->counter.value());
+            }
+        }
+    }
+
+    void reset();
+};
+
+// Series of one metric over a single label whose values are known up front.
+// The lookup table is built once, so picking a series on the hot path is a plain
+// hash lookup with no lock. Unknown label values are counted under "other".
+class CounterFamily {
+private:
+    std::unordered_map<std::string, ShardedCounter*> counters_;
+    ShardedCounter* other_;
+
+public:
+    CounterFamily(MetricsRegistry& registry, const std::string& name,
+                  const std::string& labelKey, const std::vector<std::string>& labelValues);
+
+    ShardedCounter& operator[](const std::string& labelValue) const {
+        auto it = counters_.find(labelValue);
+        return it != counters_.end() ? *it->second : *other_;
+    }
+};
+
+} // namespace trading::infrastructure::metrics
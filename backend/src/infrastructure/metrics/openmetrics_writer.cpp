@@ -0,0 +1,210 @@
+#include "openmetrics_writer.hpp"
+#include <array>
+#include <charconv>
+#include <cmath>
+
+namespace trading::infrastructure::metrics {
+
+namespace {
+
+struct LatencyBound {
+    uint64_t ns;
+    std::string_view le;
+};
+
+constexpr std::array<LatencyBound, OpenMetricsWriter::kLatencyBucketCount> kLatencyBounds = {{
+    {50'000, "0.00005"}, {100'000, "0.0001"}, {250'000, "0.00025"}, {500'000, "0.0005"},
+    {1'000'000, "0.001"}, {2'500'000, "0.0025"}, {5'000'000, "0.005"}, {10'000'000, "0.01"},
+    {25'000'000, "0.025"}, {50'000'000, "0.05"}, {100'000'000, "0.1"}, {250'000'000, "0.25"},
+    {500'000'000, "0.5"}, {1'000'000'000, "1.0"}, {2'500'000'000, "2.5"}, {5'000'000'000, "5.0"},
+    {10'000'000'000, "10.0"},
+}};
+
+// Last histogram bucket counted towards each bound
+const std::array<size_t, OpenMetricsWriter::kLatencyBucketCount>& latencyBoundBuckets() {
+    static const auto buckets = [] {
+        std::array<size_t, OpenMetricsWriter::kLatencyBucketCount> result{};
+        for (size_t i = 0; i < kLatencyBounds.size(); ++i) {
+            result[i] = LatencyHistogram::bucketIndex(kLatencyBounds[i].ns);
+        }
+        return result;
+    }();
+    return buckets;
+}
+
+constexpr double kNsPerSecond = 1'000'000'000.0;
+
+} // namespace
+
+OpenMetricsWriter::OpenMetricsWriter(std::string prefix, size_t initialCapacity) : prefix_(std::move(prefix)) {
+    buffer_.reserve(initialCapacity);
+}
+
+void OpenMetricsWriter::appendName(std::string_view name, std::string_view suffix) {
+    buffer_ += prefix_;
+    buffer_ += name;
+    buffer_ += suffix;
+}
+
+void OpenMetricsWriter::appendEscaped(std::string_view value, bool escapeQuotes) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': buffer_ += "\\\\"; break;
+            case '\n': buffer_ += "\\n"; break;
+            case '"':
+                if (escapeQuotes) {
+                    buffer_ += "\\\"";
+                } else {
+                    buffer_ += c;
+                }
+                break;
+            default: buffer_ += c; break;
+        }
+    }
+}
+
+void OpenMetricsWriter::appendNumber(double value) {
+    if (std::isnan(value)) {
+        buffer_ += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        buffer_ += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void OpenMetricsWriter::appendNumber(int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void OpenMetricsWriter::appendNumber(uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+template <typename Range>
+void OpenMetricsWriter::appendLabels(const Range& labels, std::string_view extraKey, std::string_view extraValue) {
+    if (std::empty(labels) && extraKey.empty()) {
+        return;
+    }
+    buffer_ += '{';
+    bool first = true;
+    auto appendLabel = [&](std::string_view key, std::string_view value) {
+        if (!first) {
+            buffer_ += ',';
+        }
+        first = false;
+        buffer_ += key;
+        buffer_ += "=\"";
+        appendEscaped(value, true);
+        buffer_ += '"';
+    };
+    for (const auto& [key, value] : labels) {
+        appendLabel(key, value);
+    }
+    if (!extraKey.empty()) {
+        appendLabel(extraKey, extraValue);
+    }
+    buffer_ += '}';
+}
+
+void OpenMetricsWriter::family(std::string_view name, std::string_view type, std::string_view help) {
+    buffer_ += "# TYPE ";
+    appendName(name);
+    buffer_ += ' ';
+    buffer_ += type;
+    buffer_ += '\n';
+    if (!help.empty()) {
+        buffer_ += "# HELP ";
+        appendName(name);
+        buffer_ += ' ';
+        appendEscaped(help, false);
+        buffer_ += '\n';
+    }
+}
+
+void OpenMetricsWriter::sample(std::string_view name, LabelPairs labels, double value) {
+    appendName(name);
+    appendLabels(labels);
+    buffer_ += ' ';
+    appendNumber(value);
+    buffer_ += '\n';
+}
+
+void OpenMetricsWriter::sample(std::string_view name, LabelPairs labels, int64_t value) {
+    appendName(name);
+    appendLabels(labels);
+    buffer_ += ' ';
+    appendNumber(value);
+    buffer_ += '\n';
+}
+
+void OpenMetricsWriter::sample(std::string_view name, LabelPairs labels, uint64_t value) {
+    appendName(name);
+    appendLabels(labels);
+    buffer_ += ' ';
+    appendNumber(value);
+    buffer_ += '\n';
+}
+
+void OpenMetricsWriter::sample(std::string_view name, const Labels& labels, int64_t value) {
+    appendName(name);
+    appendLabels(labels);
+    buffer_ += ' ';
+    appendNumber(value);
+    buffer_ += '\n';
+}
+
+void OpenMetricsWriter::latencyHistogram(std::string_view name, LabelPairs labels, const LatencyHistogram& histogram) {
+    const auto& boundBuckets = latencyBoundBuckets();
+
+    // Cumulative counts from one pass over the buckets; the final total also serves
+    // as +Inf and _count so the series stays consistent while writers record
+    uint64_t cumulative = 0;
+    size_t bucket = 0;
+    for (size_t i = 0; i < kLatencyBounds.size(); ++i) {
+        for (; bucket <= boundBuckets[i]; ++bucket) {
+            cumulative += histogram.bucketCount(bucket);
+        }
+        appendName(name, "_bucket");
+        appendLabels(labels, "le", kLatencyBounds[i].le);
+        buffer_ += ' ';
+        appendNumber(cumulative);
+        buffer_ += '\n';
+    }
+    for (; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+        cumulative += histogram.bucketCount(bucket);
+    }
+
+    appendName(name, "_bucket");
+    appendLabels(labels, "le", "+Inf");
+    buffer_ += ' ';
+    appendNumber(cumulative);
+    buffer_ += '\n';
+
+    appendName(name, "_count");
+    appendLabels(labels);
+    buffer_ += ' ';
+    appendNumber(cumulative);
+    buffer_ += '\n';
+
+    appendName(name, "_sum");
+    appendLabels(labels);
+    buffer_ += ' ';
+    appendNumber(static_cast<double>(histogram.sumNs()) / kNsPerSecond);
+    buffer_ += '\n';
+}
+
+std::string_view OpenMetricsWriter::finish() {
+    buffer_ += "# EOF\n";
+    return buffer_;
+}
+
+} // namespace trading::infrastructure::metrics
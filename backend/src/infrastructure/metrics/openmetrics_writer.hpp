@@ -0,0 +1,61 @@
+#pragma once
+
+#include "latency_histogram.hpp"
+#include "metrics_registry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace trading::infrastructure::metrics {
+
+using LabelPairs = std::initializer_list<std::pair<std::string_view, std::string_view>>;
+
+// Renders the OpenMetrics text format into a buffer that is reused across scrapes.
+// Once the buffer has grown to the size of a full exposition, a scrape does not
+// allocate: labels are passed as views and numbers are formatted with to_chars.
+// Every metric name is written with the namespace prefix given at construction.
+class OpenMetricsWriter {
+public:
+    static constexpr size_t kLatencyBucketCount = 17;
+
+    explicit OpenMetricsWriter(std::string prefix = "", size_t initialCapacity = 64 * 1024);
+
+    // Starts a new exposition, keeping the buffer's capacity
+    void clear() noexcept { buffer_.clear(); }
+
+    // "# TYPE" and "# HELP" lines; samples of a family must follow it contiguously
+    void family(std::string_view name, std::string_view type, std::string_view help);
+
+    void sample(std::string_view name, LabelPairs labels, double value);
+    void sample(std::string_view name, LabelPairs labels, int64_t value);
+    void sample(std::string_view name, LabelPairs labels, uint64_t value);
+    void sample(std::string_view name, const Labels& labels, int64_t value);
+
+    // Cumulative _bucket/_count/_sum samples in seconds over fixed bounds from 50us
+    // to 10s. Bounds fall inside histogram buckets, so bucket counts carry the
+    // histogram's ~6% resolution.
+    void latencyHistogram(std::string_view name, LabelPairs labels, const LatencyHistogram& histogram);
+
+    // Appends the "# EOF" terminator and returns the complete exposition
+    std::string_view finish();
+
+    std::string_view text() const noexcept { return buffer_; }
+
+private:
+    std::string prefix_;
+    std::string buffer_;
+
+    void appendName(std::string_view name, std::string_view suffix = {});
+
+    template <typename Range>
+    void appendLabels(const Range& labels, std::string_view extraKey = {}, std::string_view extraValue = {});
+    void appendEscaped(std::string_view value, bool escapeQuotes);
+    void appendNumber(double value);
+    void appendNumber(int64_t value);
+    void appendNumber(uint64_t value);
+};
+
+} // namespace trading::infrastructure::metrics
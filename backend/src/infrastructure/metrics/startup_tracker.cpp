@@ -0,0 +1,49 @@
+#include "startup_tracker.hpp"
+#include <algorithm>
+
+namespace trading::infrastructure::metrics {
+
+namespace {
+
+int64_t sinceEpochNs(StartupTracker::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+std::string_view startupMilestoneName(StartupMilestone milestone) {
+    switch (milestone) {
+        case StartupMilestone::LISTENING: return "listening";
+        case StartupMilestone::FIRST_CONNECTION: return "first_connection";
+        case StartupMilestone::SCHEMA_READY: return "schema_ready";
+        case StartupMilestone::BACKFILLED: return "backfilled";
+        case StartupMilestone::WARM: return "warm";
+    }
+    return "unknown";
+}
+
+StartupTracker::StartupTracker(Clock::time_point started) : startedNs_(sinceEpochNs(started)) {
+    for (auto& elapsed : elapsedNs_) {
+        elapsed.store(kNotReached, std::memory_order_relaxed);
+    }
+}
+
+bool StartupTracker::mark(StartupMilestone milestone, Clock::time_point now) {
+    int64_t elapsed = std::max<int64_t>(sinceEpochNs(now) - startedNs_, 0);
+    int64_t expected = kNotReached;
+    return elapsedNs_[static_cast<size_t>(milestone)].compare_exchange_strong(expected, elapsed, std::memory_order_acq_rel);
+}
+
+bool StartupTracker::reached(StartupMilestone milestone) const {
+    return elapsedNs_[static_cast<size_t>(milestone)].load(std::memory_order_acquire) != kNotReached;
+}
+
+std::optional<std::chrono::milliseconds> StartupTracker::elapsed(StartupMilestone milestone) const {
+    int64_t elapsed = elapsedNs_[static_cast<size_t>(milestone)].load(std::memory_order_acquire);
+    if (elapsed == kNotReached) {
+        return std::nullopt;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(elapsed));
+}
+
+} // namespace trading::infrastructure::metrics
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace trading::infrastructure::metrics {
+
+// Points the server passes on its way from process start to serving warm
+// reads. The WebSocket listener comes up first; schema creation, backfill and
+// cache warm-up follow in the background.
+enum class StartupMilestone {
+    LISTENING,         // WebSocket listener accepting connections
+    FIRST_CONNECTION,  // First connection accepted
+    SCHEMA_READY,      // ClickHouse tables created or checked
+    BACKFILLED,        // Mock data loaded, or found already there
+    WARM,              // History caches warmed for every symbol
+};
+
+inline constexpr size_t kStartupMilestones = 5;
+
+// "listening", "first_connection", "schema_ready", "backfilled" or "warm"
+std::string_view startupMilestoneName(StartupMilestone milestone);
+
+// Time from startup to each milestone, recorded once: the first mark wins.
+// Marks and reads are lock-free, so any thread may mark.
+class StartupTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StartupTracker(Clock::time_point started = Clock::now());
+
+    // Returns false when the milestone was already reached
+    bool mark(StartupMilestone milestone, Clock::time_point now = Clock::now());
+    bool reached(StartupMilestone milestone) const;
+    std::optional<std::chrono::milliseconds> elapsed(StartupMilestone milestone) const;
+
+    // Fully warm; the readiness check
+    bool ready() const { return reached(StartupMilestone::WARM); }
+
+private:
+    static constexpr int64_t kNotReached = -1;
+
+    int64_t startedNs_;
+    std::array<std::atomic<int64_t>, kStartupMilestones> elapsedNs_;
+};
+
+} // namespace trading::infrastructure::metrics
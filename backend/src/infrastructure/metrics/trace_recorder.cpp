@@ -0,0 +1,145 @@
+#include "trace_recorder.hpp"
+#include <algorithm>
+
+namespace trading::infrastructure::metrics {
+
+namespace {
+
+// Clears the owning ring's attachment when its thread exits so another thread can reuse it
+struct RingRelease {
+    std::atomic<bool>* attached = nullptr;
+    ~RingRelease() {
+        if (attached) {
+            attached->store(false, std::memory_order_release);
+        }
+    }
+};
+
+} // namespace
+
+TraceRecorder& TraceRecorder::instance() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder() : epochTicks_(now()), epoch_(std::chrono::steady_clock::now()) {
+}
+
+TraceRecorder::Ring* TraceRecorder::attachThread() {
+    thread_local RingRelease release;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Ring* ring = nullptr;
+    for (auto& candidate : rings_) {
+        bool expected = false;
+        if (candidate->attached.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            ring = candidate.get();
+            ring->floor.store(ring->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            ring->threadName.clear();
+            break;
+        }
+    }
+    if (!ring) {
+        rings_.push_back(std::make_unique<Ring>());
+        ring = rings_.back().get();
+        ring->threadId = static_cast<uint32_t>(rings_.size());
+    }
+
+    release.attached = &ring->attached;
+    tlsRing_ = ring;
+    return ring;
+}
+
+void TraceRecorder::nameThread(const std::string& name) {
+    Ring* ring = tlsRing_ ? tlsRing_ : attachThread();
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring->threadName = name;
+}
+
+double TraceRecorder::nsPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+    // Calibrated against steady_clock over the recorder's lifetime
+    uint64_t ticks = now() - epochTicks_;
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - epoch_).count();
+    return ticks > 0 && elapsed > 0.0 ? elapsed / static_cast<double>(ticks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+std::vector<TraceEvent> TraceRecorder::collect() const {
+    std::vector<TraceEvent> events;
+    double scale = nsPerTick();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& ring : rings_) {
+        // The slot after head may be mid-write, so one slot short of the full ring is readable
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = std::max(ring->floor.load(std::memory_order_relaxed),
+                                  head >= kRingCapacity ? head - kRingCapacity + 1 : 0);
+
+        size_t copiedFrom = events.size();
+        for (uint64_t index = first; index < head; ++index) {
+            const auto& slot = ring->slots[index & (kRingCapacity - 1)];
+            uint64_t start = slot.start.load(std::memory_order_relaxed);
+            uint64_t end = slot.end.load(std::memory_order_relaxed);
+            TraceEvent event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.threadId = ring->threadId;
+            event.startNs = start > epochTicks_ ? static_cast<uint64_t>(static_cast<double>(start - epochTicks_) * scale) : 0;
+            event.durationNs = end > start ? static_cast<uint64_t>(static_cast<double>(end - start) * scale) : 0;
+            events.push_back(event);
+        }
+
+        // Slots the writer lapped during the copy, including the one it may be
+        // writing right now, can mix two spans
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t headAfter = ring->head.load(std::memory_order_relaxed);
+        if (headAfter + 1 > first + kRingCapacity) {
+            size_t torn = std::min<uint64_t>(headAfter + 1 - kRingCapacity - first, head - first);
+            events.erase(events.begin() + static_cast<std::ptrdiff_t>(copiedFrom),
+                         events.begin() + static_cast<std::ptrdiff_t>(copiedFrom + torn));
+        }
+    }
+
+    std::sort(events.begin(), events.end(),
+              [](const TraceEvent& a, const TraceEvent& b) { return a.startNs < b.startNs; });
+    return events;
+}
+
+nlohmann::json TraceRecorder::chromeTrace() const {
+    nlohmann::json traceEvents = nlohmann::json::array();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& ring : rings_) {
+            if (!ring->threadName.empty()) {
+                traceEvents.push_back({
+                    {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", ring->threadId},
+                    {"args", {{"name", ring->threadName}}}
+                });
+            }
+        }
+    }
+
+    for (const auto& event : collect()) {
+        traceEvents.push_back({
+            {"name", event.name ? event.name : "?"},
+            {"ph", "X"},
+            {"pid", 1},
+            {"tid", event.threadId},
+            {"ts", static_cast<double>(event.startNs) / 1000.0},
+            {"dur", static_cast<double>(event.durationNs) / 1000.0}
+        });
+    }
+
+    return {{"traceEvents", traceEvents}, {"displayTimeUnit", "ns"}};
+}
+
+void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& ring : rings_) {
+        ring->floor.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+} // namespace trading::infrastructure::metrics
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Trace spans compile to nothing unless BULL_TRACING is non-zero (CMake option BULL_TRACING)
+#ifndef BULL_TRACING
+#define BULL_TRACING 1
+#endif
+
+namespace trading::infrastructure::metrics {
+
+struct TraceEvent {
+    const char* name = nullptr;
+    uint32_t threadId = 0;
+    uint64_t startNs = 0;     // Since the recorder was created
+    uint64_t durationNs = 0;
+};
+
+// Per-thread rings of completed spans. Each thread writes only its own ring with
+// relaxed stores and publishes the new head with a release store, so recording
+// takes no lock and never blocks on a reader. Readers copy a ring and then drop
+// whatever the writer may have overwritten while they were copying.
+// Timestamps are raw TSC ticks on x86 (invariant TSC assumed) and steady_clock
+// nanoseconds elsewhere; they are converted to nanoseconds only when collected.
+class TraceRecorder {
+public:
+    static constexpr size_t kRingCapacity = 4096;  // Power of two; the newest kRingCapacity - 1 spans are kept per thread
+
+    static TraceRecorder& instance();
+
+    static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    // name must outlive the recorder; trace points pass string literals
+    void record(const char* name, uint64_t startTicks, uint64_t endTicks) noexcept {
+        Ring* ring = tlsRing_ ? tlsRing_ : attachThread();
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        auto& slot = ring->slots[head & (kRingCapacity - 1)];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(startTicks, std::memory_order_relaxed);
+        slot.end.store(endTicks, std::memory_order_relaxed);
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Labels the calling thread in dumps
+    void nameThread(const std::string& name);
+
+    // Retained spans of every thread ordered by start time
+    std::vector<TraceEvent> collect() const;
+
+    // Chrome trace event format (chrome://tracing, Perfetto): one complete ("X")
+    // event per span with microsecond timestamps, plus thread name metadata
+    nlohmann::json chromeTrace() const;
+
+    // Drops retained spans; threads keep recording into their rings
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> end{0};
+    };
+
+    struct Ring {
+        std::array<Slot, kRingCapacity> slots;
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> floor{0};   // Spans below this index were cleared
+        std::atomic<bool> attached{true};
+        uint32_t threadId = 0;
+        std::string threadName;           // Guarded by mutex_
+    };
+
+    TraceRecorder();
+
+    static inline thread_local Ring* tlsRing_ = nullptr;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::atomic<bool> enabled_{true};
+    uint64_t epochTicks_;
+    std::chrono::steady_clock::time_point epoch_;
+
+    // Claims a ring released by an exited thread or creates one
+    Ring* attachThread();
+    double nsPerTick() const;
+};
+
+// Records the time from construction to destruction, or from the previous stage
+// to the next one when next() is used to trace a sequence of pipeline stages
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) noexcept
+        : name_(name), start_(TraceRecorder::instance().enabled() ? TraceRecorder::now() : 0) {}
+
+    ~TraceSpan() {
+        if (start_ != 0) {
+            TraceRecorder::instance().record(name_, start_, TraceRecorder::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void next(const char* name) noexcept {
+        if (start_ != 0) {
+            uint64_t now = TraceRecorder::now();
+            TraceRecorder::instance().record(name_, start_, now);
+            start_ = now;
+        }
+        name_ = name;
+    }
+
+private:
+    const char* name_;
+    uint64_t start_;  // 0 while tracing is disabled
+};
+
+} // namespace trading::infrastructure::metrics
+
+#define BULL_TRACE_CONCAT_INNER(a, b) a##b
+#define BULL_TRACE_CONCAT(a, b) BULL_TRACE_CONCAT_INNER(a, b)
+
+#if BULL_TRACING
+// Span covering the rest of the enclosing scope
+#define TRACE_SPAN(name) \
+    ::trading::infrastructure::metrics::TraceSpan BULL_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+// Named span whose stages are advanced with TRACE_STAGE_NEXT
+#define TRACE_STAGE(var, name) ::trading::infrastructure::metrics::TraceSpan var(name)
+#define TRACE_STAGE_NEXT(var, name) var.next(name)
+#else
+#define TRACE_SPAN(name) static_cast<void>(0)
+#define TRACE_STAGE(var, name) static_cast<void>(0)
+#define TRACE_STAGE_NEXT(var, name) static_cast<void>(0)
+#endif
@@ -0,0 +1,208 @@
+#include "windowed_metrics.hpp"
+#include "../../domain/types.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace trading::infrastructure::metrics {
+
+namespace {
+constexpr double kNsPerMs = 1'000'000.0;
+const double kEwmaAlpha = 1.0 - std::exp(-1.0 / WindowedSeries::kEwmaTauSeconds);
+}
+
+WindowedSeries::WindowedSeries(bool trackValues)
+    : trackValues_(trackValues),
+      slotCounts_(kSlotCount, 0),
+      slotSums_(kSlotCount, 0) {
+    if (trackValues_) {
+        slotBuckets_.assign(kSlotCount * LatencyHistogram::kBucketCount, 0);
+        short_.buckets.assign(LatencyHistogram::kBucketCount, 0);
+        long_.buckets.assign(LatencyHistogram::kBucketCount, 0);
+    }
+}
+
+int64_t WindowedSeries::secondOf(Clock::time_point now) {
+    return std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+}
+
+void WindowedSeries::addSlot(Aggregate& aggregate, size_t slot) {
+    aggregate.count += slotCounts_[slot];
+    aggregate.sumNs += slotSums_[slot];
+    if (trackValues_ && slotCounts_[slot] > 0) {
+        const uint32_t* buckets = &slotBuckets_[slot * LatencyHistogram::kBucketCount];
+        for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+            aggregate.buckets[i] += buckets[i];
+        }
+    }
+}
+
+void WindowedSeries::removeSlot(Aggregate& aggregate, size_t slot) {
+    aggregate.count -= slotCounts_[slot];
+    aggregate.sumNs -= slotSums_[slot];
+    if (trackValues_ && slotCounts_[slot] > 0) {
+        const uint32_t* buckets = &slotBuckets_[slot * LatencyHistogram::kBucketCount];
+        for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+            aggregate.buckets[i] -= buckets[i];
+        }
+    }
+}
+
+void WindowedSeries::clearSlot(size_t slot) {
+    if (trackValues_ && slotCounts_[slot] > 0) {
+        std::fill_n(slotBuckets_.begin() + static_cast<ptrdiff_t>(slot * LatencyHistogram::kBucketCount),
+                    LatencyHistogram::kBucketCount, 0u);
+    }
+    slotCounts_[slot] = 0;
+    slotSums_[slot] = 0;
+}
+
+void WindowedSeries::advance(int64_t second) {
+    if (!started_) {
+        started_ = true;
+        currentSecond_ = second;
+        return;
+    }
+    if (second <= currentSecond_) {
+        return;
+    }
+
+    int64_t gap = second - currentSecond_;
+    if (gap > static_cast<int64_t>(kWindowSeconds)) {
+        // Every second still inside the long window is empty: start over
+        ewma_ += kEwmaAlpha * (static_cast<double>(slotCounts_[slotOf(currentSecond_)]) - ewma_);
+        ewma_ *= std::pow(1.0 - kEwmaAlpha, static_cast<double>(gap - 1));
+        for (size_t slot = 0; slot < kSlotCount; ++slot) {
+            clearSlot(slot);
+        }
+        short_.count = long_.count = 0;
+        short_.sumNs = long_.sumNs = 0;
+        std::fill(short_.buckets.begin(), short_.buckets.end(), 0);
+        std::fill(long_.buckets.begin(), long_.buckets.end(), 0);
+        currentSecond_ = second;
+        return;
+    }
+
+    for (int64_t s = currentSecond_ + 1; s <= second; ++s) {
+        // Second s-1 completes and enters both windows
+        size_t completed = slotOf(s - 1);
+        ewma_ += kEwmaAlpha * (static_cast<double>(slotCounts_[completed]) - ewma_);
+        addSlot(short_, completed);
+        addSlot(long_, completed);
+
+        // Second s-11 leaves the short window
+        removeSlot(short_, slotOf(s - 1 - static_cast<int64_t>(kShortWindowSeconds)));
+
+        // Slot of s still holds second s-61, which leaves the long window
+        size_t next = slotOf(s);
+        removeSlot(long_, next);
+        clearSlot(next);
+    }
+    currentSecond_ = second;
+}
+
+void WindowedSeries::record(uint64_t valueNs, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    advance(secondOf(now));
+
+    size_t slot = slotOf(currentSecond_);
+    ++slotCounts_[slot];
+    if (trackValues_) {
+        slotSums_[slot] += valueNs;
+        ++slotBuckets_[slot * LatencyHistogram::kBucketCount + LatencyHistogram::bucketIndex(valueNs)];
+    }
+}
+
+void WindowedSeries::mark(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    advance(secondOf(now));
+    ++slotCounts_[slotOf(currentSecond_)];
+}
+
+double WindowedSeries::percentileMs(const Aggregate& aggregate, double percentile) const {
+    if (aggregate.count == 0) {
+        return 0.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(aggregate.count)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < aggregate.buckets.size(); ++i) {
+        seen += aggregate.buckets[i];
+        if (seen >= rank) {
+            return static_cast<double>(LatencyHistogram::bucketMidpoint(i)) / kNsPerMs;
+        }
+    }
+    return 0.0;
+}
+
+WindowStats WindowedSeries::stats(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    advance(secondOf(now));
+
+    WindowStats stats;
+    if (!started_) {
+        return stats;
+    }
+    stats.rate1s = static_cast<double>(slotCounts_[slotOf(currentSecond_ - 1)]);
+    stats.rate10s = static_cast<double>(short_.count) / static_cast<double>(kShortWindowSeconds);
+    stats.rate60s = static_cast<double>(long_.count) / static_cast<double>(kWindowSeconds);
+    stats.rateEwma = ewma_;
+    if (trackValues_) {
+        stats.mean10sMs = short_.count > 0
+            ? static_cast<double>(short_.sumNs) / static_cast<double>(short_.count) / kNsPerMs : 0.0;
+        stats.p50_10sMs = percentileMs(short_, 50.0);
+        stats.p99_10sMs = percentileMs(short_, 99.0);
+        stats.p99_60sMs = percentileMs(long_, 99.0);
+    }
+    return stats;
+}
+
+WindowedMetrics::WindowedMetrics(const std::vector<std::string>& valueSeries, const std::vector<std::string>& eventSeries) {
+    for (const auto& name : valueSeries) {
+        series_.emplace(name, std::make_unique<WindowedSeries>(true));
+    }
+    for (const auto& name : eventSeries) {
+        series_.emplace(name, std::make_unique<WindowedSeries>(false));
+    }
+}
+
+WindowedSeries* WindowedMetrics::series(const std::string& name) const {
+    auto it = series_.find(name);
+    return it != series_.end() ? it->second.get() : nullptr;
+}
+
+void WindowedMetrics::record(const std::string& name, uint64_t valueNs) {
+    if (auto* s = series(name)) {
+        s->record(valueNs);
+    }
+}
+
+void WindowedMetrics::mark(const std::string& name) {
+    if (auto* s = series(name)) {
+        s->mark();
+    }
+}
+
+std::unordered_map<std::string, double> WindowedMetrics::snapshot(WindowedSeries::Clock::time_point now) const {
+    const auto& names = trading::domain::kWindowedStats;
+    std::unordered_map<std::string, double> values;
+    values.reserve(series_.size() * names.size());
+
+    for (const auto& [name, series] : series_) {
+        auto stats = series->stats(now);
+        const double all[] = {
+            stats.rate1s, stats.rate10s, stats.rate60s, stats.rateEwma,
+            stats.mean10sMs, stats.p50_10sMs, stats.p99_10sMs, stats.p99_60sMs
+        };
+        static_assert(sizeof(all) / sizeof(all[0]) == trading::domain::kWindowedStats.size());
+
+        // Event series only report the leading rate stats
+        size_t count = series->tracksValues() ? names.size() : trading::domain::kWindowedRateStatCount;
+        for (size_t i = 0; i < count; ++i) {
+            values.emplace(name + "." + names[i], all[i]);
+        }
+    }
+    return values;
+}
+
+} // namespace trading::infrastructure::metrics
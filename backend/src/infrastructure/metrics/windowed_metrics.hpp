@@ -0,0 +1,97 @@
+#pragma once
+
+#include "latency_histogram.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::infrastructure::metrics {
+
+// Aggregates over the most recent complete seconds; the second in progress is excluded
+struct WindowStats {
+    double rate1s = 0.0;
+    double rate10s = 0.0;
+    double rate60s = 0.0;
+    double rateEwma = 0.0;
+    double mean10sMs = 0.0;
+    double p50_10sMs = 0.0;
+    double p99_10sMs = 0.0;
+    double p99_60sMs = 0.0;
+};
+
+// Ring of one-second buckets covering the last minute. 10s and 60s aggregates are
+// kept incrementally: a sample touches only the current bucket and the second
+// rollover moves one bucket in and one out of each window, so recording is O(1)
+// and reading a windowed percentile is one scan over the histogram buckets.
+class WindowedSeries {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kWindowSeconds = 60;
+    static constexpr size_t kShortWindowSeconds = 10;
+    static constexpr size_t kSlotCount = kWindowSeconds + 1;  // Plus the second in progress
+    static constexpr double kEwmaTauSeconds = 10.0;
+
+    // Event series only count occurrences; value series also keep latency histograms
+    explicit WindowedSeries(bool trackValues);
+    WindowedSeries(const WindowedSeries&) = delete;
+    WindowedSeries& operator=(const WindowedSeries&) = delete;
+
+    void record(uint64_t valueNs, Clock::time_point now = Clock::now());
+    void mark(Clock::time_point now = Clock::now());
+
+    WindowStats stats(Clock::time_point now = Clock::now());
+
+    bool tracksValues() const noexcept { return trackValues_; }
+
+private:
+    struct Aggregate {
+        uint64_t count = 0;
+        uint64_t sumNs = 0;
+        std::vector<uint64_t> buckets;
+    };
+
+    bool trackValues_;
+    std::vector<uint64_t> slotCounts_;
+    std::vector<uint64_t> slotSums_;
+    std::vector<uint32_t> slotBuckets_;  // kSlotCount x LatencyHistogram::kBucketCount
+    Aggregate short_;
+    Aggregate long_;
+    double ewma_ = 0.0;
+    int64_t currentSecond_ = 0;
+    bool started_ = false;
+    std::mutex mutex_;
+
+    static int64_t secondOf(Clock::time_point now);
+    size_t slotOf(int64_t second) const { return static_cast<size_t>(second % static_cast<int64_t>(kSlotCount)); }
+
+    // Require the lock
+    void advance(int64_t second);
+    void addSlot(Aggregate& aggregate, size_t slot);
+    void removeSlot(Aggregate& aggregate, size_t slot);
+    void clearSlot(size_t slot);
+    double percentileMs(const Aggregate& aggregate, double percentile) const;
+};
+
+// Fixed set of named windowed series, flattened into "<series>.<stat>" values for
+// alert rules (see trading::domain::kWindowedStats). Unknown series are ignored.
+class WindowedMetrics {
+private:
+    std::unordered_map<std::string, std::unique_ptr<WindowedSeries>> series_;
+
+public:
+    WindowedMetrics(const std::vector<std::string>& valueSeries, const std::vector<std::string>& eventSeries);
+
+    WindowedSeries* series(const std::string& name) const;
+
+    void record(const std::string& name, uint64_t valueNs);
+    void mark(const std::string& name);
+
+    std::unordered_map<std::string, double> snapshot(WindowedSeries::Clock::time_point now = WindowedSeries::Clock::now()) const;
+};
+
+} // namespace trading::infrastructure::metrics
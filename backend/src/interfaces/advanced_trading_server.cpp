@@ -1,7 +1,13 @@
 #include "advanced_trading_server.hpp"
 #include "../infrastructure/cache/idempotency_cache.hpp"
 #include "../application/risk_validator.hpp"
+#include "../application/alert_rule_engine.hpp"
+#include "../application/candle_downsampler.hpp"
+#include "../application/history_warmup.hpp"
 #include "../infrastructure/database/clickhouse_repository.hpp"
+#include "../infrastructure/metrics/metrics_collector.hpp"
+#include "../infrastructure/marketdata/tick_replayer.hpp"
+#include "../infrastructure/marketdata/tick_journal.hpp"
 #include <binaryrpc/core/rpc/rpc_context.hpp>
 #include <binaryrpc/transports/websocket/websocket_transport.hpp>
 #include <binaryrpc/plugins/room_plugin.hpp>
@@ -26,14 +32,200 @@
 #include <cmath>
 #include <memory>
 #include <iterator>
+#include <stdexcept>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
 
 using namespace binaryrpc;
 
 namespace trading::interfaces {
 
+namespace {
+
+// Every RPC registered in setupHandlers; the metrics collector gets one histogram set per method
+const std::vector<std::string> kRpcMethods = {
+    "hello", "logout",
+    "orders.place", "orders.cancel", "orders.status", "orders.history",
+    "market.subscribe", "market.unsubscribe", "market.list",
+    "history.query", "history.latest",
+    "metrics.get", "alerts.subscribe", "alerts.list", "alerts.register", "alerts.disable",
+    "alerts.price.register", "alerts.price.cancel", "trace.dump"
+};
+
+// Scrape port of the OpenMetrics endpoint; METRICS_PORT overrides it and 0 disables it
+constexpr int kDefaultMetricsPort = 9464;
+
+// Cadence of the alert evaluator thread
+constexpr auto kAlertEvaluationInterval = std::chrono::milliseconds(100);
+
+// Reliable transport keeps a disconnected session resumable for this long
+constexpr uint32_t kSessionTtlMs = 30000;
+
+// How often the alert evaluator releases state of sessions past their TTL
+constexpr auto kSessionExpiryInterval = std::chrono::seconds(1);
+
+// Upper bound on history.query maxPoints, whatever the client asks for
+constexpr int32_t kMaxHistoryPoints = 10000;
+
+// System alerts evaluated alongside custom rules; same thresholds alerts.list reports
+const std::vector<trading::domain::AlertRule> kBuiltinAlertRules = {
+    {"high_latency", "latencyMs", ">", 100.0, true},
+    {"error_rate", "errorRate", ">", 0.01, true},
+    {"connection_count", "connCount", ">", 1000.0, true},
+    {"high_throughput", "throughput", ">", 2.0, true}
+};
+
+// Occurrence-only windowed series; every RPC method is additionally a latency series
+const std::vector<std::string> kWindowedEventSeries = {"orders", "orders.rejected", "errors"};
+
+// Between attempts to create the ClickHouse schema at startup, polled in steps
+// so stop() is not held up
+constexpr std::chrono::milliseconds kStartupRetryInterval{2000};
+constexpr std::chrono::milliseconds kStartupRetryStep{100};
+
+// How often deliverTick drops tick journal segments past the retention
+constexpr int64_t kJournalPruneIntervalMs = 3'600'000;
+
+// How often journaled ticks are loaded into ClickHouse
+constexpr std::chrono::milliseconds kJournalLoadInterval{1000};
+
+// Longest a relay edge waits for ticks before checking whether it is stopping
+constexpr std::chrono::milliseconds kRelayPollWait{100};
+
+const std::vector<std::string> kKnownSymbols = {
+    "ETH-USD", "BTC-USD", "ADA-USD", "SOL-USD", "DOGE-USD", "AVAX-USD", "MATIC-USD", "LINK-USD"
+};
+
+const std::vector<std::string> kRejectReasons = {
+    "rate_limit", "position_limit", "notional_limit", "insufficient_balance", "risk"
+};
+
+// Maps a RiskValidator error message onto one of kRejectReasons
+std::string rejectReasonLabel(const std::string& validationError) {
+    if (validationError.rfind("Position limit", 0) == 0) return "position_limit";
+    if (validationError.rfind("Order notional", 0) == 0) return "notional_limit";
+    if (validationError.rfind("Insufficient balance", 0) == 0) return "insufficient_balance";
+    return "risk";
+}
+
+// Per-request timing marks. Middleware and handlers for one request run on the same
+// thread, so a thread_local is enough to hand the marks from one stage to the next.
+struct RequestTiming {
+    std::chrono::steady_clock::time_point received;
+    std::chrono::steady_clock::time_point dispatched;
+    std::chrono::nanoseconds serialize{0};
+    const std::string* sessionId = nullptr;
+};
+
+thread_local RequestTiming tlsRequestTiming;
+
+void markDispatched() {
+    tlsRequestTiming.dispatched = std::chrono::steady_clock::now();
+}
+
+double toMs(std::chrono::nanoseconds ns) {
+    return std::chrono::duration<double, std::milli>(ns).count();
+}
+
+int metricsPortFromEnv() {
+    const char* value = std::getenv("METRICS_PORT");
+    if (!value || !*value) {
+        return kDefaultMetricsPort;
+    }
+    try {
+        return std::stoi(value);
+    } catch (const std::exception&) {
+        std::cerr << "[Metrics HTTP] Invalid METRICS_PORT '" << value << "', using " << kDefaultMetricsPort << std::endl;
+        return kDefaultMetricsPort;
+    }
+}
+
+// BULL_TICK_REPLAY names a capture to play instead of the simulator;
+// BULL_TICK_REPLAY_SPEED is 1 (default), 10, ... or max, BULL_TICK_REPLAY_LOOP=1 repeats it
+struct ReplayConfig {
+    std::string path;
+    trading::infrastructure::marketdata::ReplayOptions options;
+};
+
+std::optional<ReplayConfig> replayConfigFromEnv() {
+    const char* path = std::getenv("BULL_TICK_REPLAY");
+    if (!path || !*path) {
+        return std::nullopt;
+    }
+    ReplayConfig config{path, {}};
+    if (const char* speed = std::getenv("BULL_TICK_REPLAY_SPEED"); speed && *speed) {
+        if (auto parsed = trading::infrastructure::marketdata::TickReplayer::parseSpeed(speed)) {
+            config.options.speed = *parsed;
+        } else {
+            std::cerr << "[Market Data] Invalid BULL_TICK_REPLAY_SPEED '" << speed << "', replaying at 1x" << std::endl;
+        }
+    }
+    const char* loop = std::getenv("BULL_TICK_REPLAY_LOOP");
+    config.options.loop = loop && std::string(loop) == "1";
+    return config;
+}
+
+// BULL_RELAY_PUBLISH and BULL_RELAY_SUBSCRIBE take shm:<ring file> or udp:<group>:<port>[@<interface address>]
+std::optional<trading::infrastructure::marketdata::RelayEndpoint> relayEndpointFromEnv(const char* name) {
+    const char* value = std::getenv(name);
+    if (!value || !*value) {
+        return std::nullopt;
+    }
+    auto endpoint = trading::infrastructure::marketdata::RelayEndpoint::parse(value);
+    if (!endpoint) {
+        std::cerr << "[Market Data] Invalid " << name << " '" << value << "', expected shm:<path> or udp:<group>:<port>" << std::endl;
+    }
+    return endpoint;
+}
+
+// Thresholds of latency metrics may carry a duration unit ("5ms", "250us", "1s"); the
+// result is in ms. Other metrics (rates, counts) only take plain numbers.
+double parseThresholdMs(const nlohmann::json& threshold, bool durationMetric) {
+    if (threshold.is_number()) {
+        return threshold.get<double>();
+    }
+    if (!threshold.is_string()) {
+        throw std::invalid_argument("threshold must be a number or a duration string");
+    }
+    if (!durationMetric) {
+        throw std::invalid_argument("threshold must be a number for a non-latency metric");
+    }
+
+    const std::string text = threshold.get<std::string>();
+    size_t consumed = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &consumed);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid threshold: " + text);
+    }
+
+    const std::string unit = text.substr(consumed);
+    if (unit.empty() || unit == "ms") return value;
+    if (unit == "us") return value / 1000.0;
+    if (unit == "ns") return value / 1'000'000.0;
+    if (unit == "s") return value * 1000.0;
+    throw std::invalid_argument("Unknown threshold unit: " + unit);
+}
+
+} // namespace
+
 AdvancedTradingServer::AdvancedTradingServer(const std::string& host, int port, const std::string& jwtSecret)
     : host_(host), port_(port), jwtSecret_(jwtSecret), running_(false),
-      totalOrdersPlaced_(0), totalOrdersCancelled_(0), totalErrors_(0), activeConnections_(0),
+      ordersPlaced_(metricsRegistry_, "orders_placed_total", "symbol", kKnownSymbols),
+      ordersCancelled_(metricsRegistry_.counter("orders_cancelled_total")),
+      ordersRejected_(metricsRegistry_, "orders_rejected_total", "reason", kRejectReasons),
+      rpcErrors_(metricsRegistry_, "rpc_errors_total", "method", kRpcMethods),
+      alertsSuppressed_(metricsRegistry_.counter("alerts_suppressed_total")),
+      relayTicksPublished_(metricsRegistry_.counter("relay_ticks_published_total")),
+      relayPublishFailures_(metricsRegistry_.counter("relay_publish_failures_total")),
+      relayTicksReceived_(metricsRegistry_.counter("relay_ticks_received_total")),
+      relayTicksLost_(metricsRegistry_.counter("relay_ticks_lost_total")),
+      journalTicksLoaded_(metricsRegistry_.counter("tick_journal_loaded_total")),
+      connectionTracker_(std::chrono::milliseconds(kSessionTtlMs)),
+      windowedMetrics_(kRpcMethods, kWindowedEventSeries),
+      priceAlertsFired_(metricsRegistry_.counter("price_alerts_fired_total")),
       startTime_(std::chrono::steady_clock::now()) {
 }
 
@@ -288,7 +480,7 @@ bool AdvancedTradingServer::initialize() {
         opts.baseRetryMs = 100;
         opts.maxRetry = 5;
         opts.maxBackoffMs = 2000;
-        opts.sessionTtlMs = 30000;  // 30 seconds session TTL for reconnection
+        opts.sessionTtlMs = kSessionTtlMs;  // 30 seconds session TTL for reconnection
         opts.backoffStrategy = std::make_shared<binaryrpc::LinearBackoff>(
             std::chrono::milliseconds(opts.baseRetryMs),
             std::chrono::milliseconds(opts.maxBackoffMs)
@@ -328,37 +520,24 @@ bool AdvancedTradingServer::initialize() {
             riskValidator_ = std::make_unique<trading::application::RiskValidator>();
         }
         
+        if (!metricsCollector_) {
+            metricsCollector_ = std::make_unique<trading::infrastructure::metrics::MetricsCollector>(kRpcMethods);
+        }
+        
+        if (!alertingService_) {
+            alertingService_ = std::make_unique<trading::application::AlertRuleEngine>(kRpcMethods, kWindowedEventSeries);
+        }
+        for (const auto& rule : kBuiltinAlertRules) {
+            alertingService_->registerRule(rule);
+        }
+        
         // Initialize HistoryRepository with ClickHouse (ALWAYS - no ifdef)
         if (!historyRepository_) {
             std::cout << "[Initialize] Creating ClickHouse HistoryRepository from environment" << std::endl;
             try {
                 historyRepository_ = trading::infrastructure::database::ClickHouseHistoryRepository::createFromEnvironment();
                 std::cout << "[Initialize] ClickHouse repository created successfully" << std::endl;
-                
-                // Initialize database - only create tables immediately, mock data in background
-                if (auto* clickhouseRepo = dynamic_cast<trading::infrastructure::database::ClickHouseHistoryRepository*>(historyRepository_.get())) {
-                    if (clickhouseRepo->connect()) {
-                        // First, just create tables quickly to avoid blocking server startup
-                        try {
-                            std::cout << "[Initialize] Creating ClickHouse tables..." << std::endl;
-                            bool tablesCreated = clickhouseRepo->createTables();
-                            std::cout << "[Initialize] Tables created: " << (tablesCreated ? "SUCCESS" : "FAILED") << std::endl;
-                        } catch (const std::exception& e) {
-                            std::cerr << "[Initialize] Table creation failed: " << e.what() << std::endl;
-                        }
-                        
-                        // Try mock data generation but don't block server startup if it fails
-                        try {
-                            std::cout << "[Initialize] Attempting mock data generation..." << std::endl;
-                            bool mockDataGenerated = clickhouseRepo->generateMockData();
-                            std::cout << "[Initialize] Mock data generation result: " << (mockDataGenerated ? "SUCCESS" : "FAILED") << std::endl;
-                        } catch (const std::exception& e) {
-                            std::cout << "[Initialize] Mock data generation failed (non-blocking): " << e.what() << std::endl;
-                            // Continue anyway - don't block server startup
-                        }
-                        std::cout << "[Initialize] ClickHouse setup completed" << std::endl;
-                    }
-                }
+                // Tables, mock data and history warm-up wait for the listener; see warmUp()
             } catch (const std::exception& e) {
                 std::cerr << "[Initialize] Failed to create ClickHouse repository: " << e.what() << std::endl;
                 std::cout << "[Initialize] Will use mock data fallback" << std::endl;
@@ -388,19 +567,56 @@ void AdvancedTradingServer::start() {
         
         // Reset metrics tracking
         startTime_ = std::chrono::steady_clock::now();
-        totalOrdersPlaced_.store(0);
-        totalOrdersCancelled_.store(0);
-        totalErrors_.store(0);
+        metricsRegistry_.reset();
         
         // Start market data simulation
         startMarketDataSimulation();
         
+        // Evaluate alert rules on a fixed cadence, off the order path
+        startAlertEvaluator();
+        
+        // BULL_TRACE_ENABLED=0 starts with span recording off
+        if (const char* tracing = std::getenv("BULL_TRACE_ENABLED"); tracing && std::string(tracing) == "0") {
+            trading::infrastructure::metrics::TraceRecorder::instance().setEnabled(false);
+        }
+        
+        // Prometheus scrapes are served outside the WebSocket transport
+        int metricsPort = metricsPortFromEnv();
+        if (metricsPort > 0) {
+            metricsHttpServer_ = std::make_unique<MetricsHttpServer>(host_, metricsPort, "bull_",
+                [this](trading::infrastructure::metrics::OpenMetricsWriter& out) { renderMetrics(out); },
+                [this] { return startup_.ready(); });
+            // Tracing is switched server-wide, so only operators on this port may do it
+            auto& recorder = trading::infrastructure::metrics::TraceRecorder::instance();
+            metricsHttpServer_->addCommand("/trace/enable", [&recorder] {
+                recorder.setEnabled(true);
+                return std::string("tracing enabled\n");
+            });
+            metricsHttpServer_->addCommand("/trace/disable", [&recorder] {
+                recorder.setEnabled(false);
+                return std::string("tracing disabled\n");
+            });
+            metricsHttpServer_->addCommand("/trace/clear", [&recorder] {
+                recorder.clear();
+                return std::string("trace cleared\n");
+            });
+            if (!metricsHttpServer_->start()) {
+                metricsHttpServer_.reset();
+            }
+        }
+        
         // Start server
         std::cout << "🚀 About to call app_->run() on port " << port_ << "..." << std::endl;
         
         try {
             app_->run(static_cast<uint16_t>(port_));
+            startup_.mark(trading::infrastructure::metrics::StartupMilestone::LISTENING);
             std::cout << "✅ app_->run() completed - server started asynchronously" << std::endl;
+            std::cout << "[Startup] Listening after "
+                      << startup_.elapsed(trading::infrastructure::metrics::StartupMilestone::LISTENING)->count() << " ms" << std::endl;
+            
+            // Schema, mock data and warm-up run behind the listener
+            startWarmup();
             
             // app_->run() returns immediately but server runs in background
             // Keep the main thread alive
@@ -425,10 +641,16 @@ void AdvancedTradingServer::start() {
 
 void AdvancedTradingServer::stop() {
     running_ = false;
-    stopMarketDataSimulation();
+    // No new requests, before the state their handlers read goes away
     if (app_) {
         app_->stop();
     }
+    if (metricsHttpServer_) {
+        metricsHttpServer_->stop();
+    }
+    stopWarmup();
+    stopMarketDataSimulation();
+    stopAlertEvaluator();
 }
 
 // setAuthInspector removed - using inline JWT verification instead
@@ -475,16 +697,32 @@ void AdvancedTradingServer::setupQoS() {
 void AdvancedTradingServer::setupMiddleware(binaryrpc::FrameworkAPI& api) {
     std::cout << "[setupMiddleware] Configuring middleware chain..." << std::endl;
     
-    // Global logging middleware with connection tracking
+    // Global logging middleware with request timing
     app_->use([this](binaryrpc::Session& session, const std::string& method, std::vector<uint8_t>& payload, binaryrpc::NextFunc next) {
         std::cout << "[Middleware] Request: " << method << " from session: " << session.id() << std::endl;
         
-        // Track active connections (simplified - in real system would track connect/disconnect events)
-        if (method == "hello") {
-            activeConnections_++;
-        }
+        auto& timing = tlsRequestTiming;
+        timing.received = std::chrono::steady_clock::now();
+        timing.dispatched = timing.received;
+        timing.serialize = std::chrono::nanoseconds{0};
+        timing.sessionId = &session.id();
         
         next();
+        
+        timing.sessionId = nullptr;
+        
+        // Requests rejected by the auth middleware never reach a handler and are not timed
+        if (timing.dispatched != timing.received) {
+            auto finished = std::chrono::steady_clock::now();
+            windowedMetrics_.record(method, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(finished - timing.received).count()));
+            if (metricsCollector_) {
+                auto service = (finished - timing.dispatched) - timing.serialize;
+                metricsCollector_->recordRequest(method, toMs(service),
+                                                 toMs(timing.dispatched - timing.received),
+                                                 toMs(timing.serialize));
+            }
+        }
         std::cout << "[Middleware] Response sent for: " << method << std::endl;
     });
     
@@ -493,7 +731,8 @@ void AdvancedTradingServer::setupMiddleware(binaryrpc::FrameworkAPI& api) {
         "orders.place", "orders.cancel", "orders.status",
         "history.query", "history.latest",
         "market.subscribe", "market.unsubscribe", "market.list",
-        "metrics.get", "alerts.subscribe", "alerts.list", "alerts.register", "alerts.disable"
+        "metrics.get", "alerts.subscribe", "alerts.list", "alerts.register", "alerts.disable",
+        "alerts.price.register", "alerts.price.cancel", "trace.dump"
     }, [this](binaryrpc::Session& session, const std::string& method, std::vector<uint8_t>& payload, binaryrpc::NextFunc next) {
         // Check if session is authenticated via SessionManager
         try {
@@ -532,77 +771,108 @@ void AdvancedTradingServer::setupHandlers(binaryrpc::FrameworkAPI& api) {
     
     // Authentication handlers - capture api by reference
     app_->registerRPC("hello", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleHello(data, context, api);
     });
     
     app_->registerRPC("logout", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleLogout(data, context, api);
     });
     
     // Order management handlers (QoS1 - AtLeastOnce)
     std::cout << "[setupHandlers] Registering orders.place handler..." << std::endl;
     app_->registerRPC("orders.place", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         std::cout << "[RPC Handler] orders.place called directly!" << std::endl;
         handleOrdersPlace(data, context, api);
     });
     
     app_->registerRPC("orders.cancel", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleOrdersCancel(data, context, api);
     });
     
     app_->registerRPC("orders.status", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleOrdersStatus(data, context, api);
     });
     
     app_->registerRPC("orders.history", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         std::cout << "[RPC Handler] orders.history called directly!" << std::endl;
         handleOrdersHistory(data, context, api);
     });
     
     // Market data handlers with room management
     app_->registerRPC("market.subscribe", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleMarketDataSubscribe(data, context, api);
     });
     
     app_->registerRPC("market.unsubscribe", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleMarketDataUnsubscribe(data, context, api);
     });
     
     app_->registerRPC("market.list", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleMarketDataList(data, context, api);
     });
     
     // History handlers
     app_->registerRPC("history.query", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         std::cout << "[RPC Handler] history.query called directly!" << std::endl;
         handleHistoryQuery(data, context, api);
     });
     
     app_->registerRPC("history.latest", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         std::cout << "[RPC Handler] history.latest called directly!" << std::endl;
         handleHistoryLatest(data, context, api);
     });
     
     // System management handlers
     app_->registerRPC("metrics.get", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleMetricsGet(data, context, api);
     });
     
     app_->registerRPC("alerts.subscribe", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleAlertsSubscribe(data, context, api);
     });
     
     app_->registerRPC("alerts.list", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleAlertsList(data, context, api);
     });
     
     app_->registerRPC("alerts.register", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleAlertsRegister(data, context, api);
     });
     
     app_->registerRPC("alerts.disable", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
         handleAlertsDisable(data, context, api);
     });
+    
+    app_->registerRPC("alerts.price.register", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
+        handleAlertsPriceRegister(data, context, api);
+    });
+    
+    app_->registerRPC("alerts.price.cancel", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
+        handleAlertsPriceCancel(data, context, api);
+    });
+    
+    app_->registerRPC("trace.dump", [this, &api](const std::vector<uint8_t>& data, binaryrpc::RpcContext& context) {
+        markDispatched();
+        handleTraceDump(data, context, api);
+    });
 }
 
 void AdvancedTradingServer::setupConnectionEventHandlers() {
@@ -612,9 +882,41 @@ void AdvancedTradingServer::setupConnectionEventHandlers() {
         
         std::cout << "[Connection Events] Setting up connection event handlers" << std::endl;
         
-        // Note: BinaryRPC framework handles connection events internally
-        // We can add custom logic here for connection tracking, metrics, etc.
-        // The actual WebSocket connection/disconnection events are managed by the transport layer
+        auto* transport = app_->getTransport();
+        if (!transport) {
+            std::cerr << "[Connection Events] Transport not available" << std::endl;
+            return;
+        }
+        
+        // Fired for every WebSocket upgrade, including reconnects that resume a session
+        transport->setSessionRegisterCallback([this](const std::string& clientId, std::shared_ptr<binaryrpc::Session> session) {
+            if (!session) {
+                return;
+            }
+            bool resumed = connectionTracker_.onConnect(session->id());
+            if (startup_.mark(trading::infrastructure::metrics::StartupMilestone::FIRST_CONNECTION)) {
+                std::cout << "[Startup] First connection accepted after "
+                          << startup_.elapsed(trading::infrastructure::metrics::StartupMilestone::FIRST_CONNECTION)->count()
+                          << " ms" << std::endl;
+            }
+            if (metricsCollector_) {
+                metricsCollector_->recordConnection();
+            }
+            std::cout << "[Connection Events] " << (resumed ? "Resumed" : "Opened") << " session: " << session->id()
+                      << " client: " << clientId << std::endl;
+        });
+        
+        // Session stays resumable for the session TTL after the socket closes
+        transport->setDisconnectCallback([this](std::shared_ptr<binaryrpc::Session> session) {
+            if (!session) {
+                return;
+            }
+            connectionTracker_.onDisconnect(session->id());
+            if (metricsCollector_) {
+                metricsCollector_->recordDisconnection();
+            }
+            std::cout << "[Connection Events] Closed session: " << session->id() << std::endl;
+        });
         
         std::cout << "[Connection Events] Connection event handlers configured successfully" << std::endl;
         
@@ -639,7 +941,7 @@ void AdvancedTradingServer::handleHello(const std::vector<uint8_t>& data, binary
             nlohmann::json error = createErrorResponse("INVALID_PARAMS", "Missing required parameters: token, clientId");
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("hello", errorData);
+            auto serializedResponse = serializeResponse("hello", errorData);
             context.reply(serializedResponse);
             return;
         }
@@ -656,7 +958,7 @@ void AdvancedTradingServer::handleHello(const std::vector<uint8_t>& data, binary
             nlohmann::json error = createErrorResponse("AUTH_FAILED", "Invalid or expired token");
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("hello", errorData);
+            auto serializedResponse = serializeResponse("hello", errorData);
             context.reply(serializedResponse);
             return;
         }
@@ -695,6 +997,9 @@ void AdvancedTradingServer::handleHello(const std::vector<uint8_t>& data, binary
         sessionManager.setField(sessionId, "roles", nlohmann::json(principal.roles).dump(), false);
         
         bool authResult = sessionManager.setField(sessionId, "authenticated", std::string("true"), false);
+        if (authResult) {
+            connectionTracker_.onAuthenticated(sessionId);
+        }
         std::cout << "[Hello] Set authenticated field result: " << (authResult ? "SUCCESS" : "FAILED") << std::endl;
         
         // Verify the field was set
@@ -752,7 +1057,7 @@ void AdvancedTradingServer::handleHello(const std::vector<uint8_t>& data, binary
         std::string jsonStr = response.dump();
         std::cout << "[Hello] Sending response: " << jsonStr << std::endl;
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("hello", responseData);
+        auto serializedResponse = serializeResponse("hello", responseData);
         std::cout << "[Hello] Response serialized, size: " << serializedResponse.size() << std::endl;
         context.reply(serializedResponse);
         std::cout << "[Hello] Response sent successfully!" << std::endl;
@@ -763,7 +1068,7 @@ void AdvancedTradingServer::handleHello(const std::vector<uint8_t>& data, binary
         std::string errorStr = error.dump();
         std::cout << "[Hello] Sending error response: " << errorStr << std::endl;
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("hello", errorData);
+        auto serializedResponse = serializeResponse("hello", errorData);
         context.reply(serializedResponse);
         std::cout << "[Hello] Error response sent" << std::endl;
     }
@@ -776,6 +1081,8 @@ void AdvancedTradingServer::handleLogout(const std::vector<uint8_t>& data, binar
         auto& sessionManager = app_->getSessionManager();
         sessionManager.setField(sessionId, "authenticated", std::string("false"), false);
         sessionManager.setField(sessionId, "userId", std::string(""), false);
+        connectionTracker_.onLoggedOut(sessionId);
+        priceAlerts_.cancelOwner(sessionId);
         
         // Leave all rooms
         roomPlugin_->leaveAll(context.session().id());
@@ -787,20 +1094,22 @@ void AdvancedTradingServer::handleLogout(const std::vector<uint8_t>& data, binar
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("logout", responseData);
+        auto serializedResponse = serializeResponse("logout", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Logout failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("logout", errorData);
+        auto serializedResponse = serializeResponse("logout", errorData);
         context.reply(serializedResponse);
     }
 }
 
 void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api) {
     try {
+        TRACE_SPAN("orders.place");
+        TRACE_STAGE(stage, "orders.place.session");
         std::cout << "[Handler] Processing order placement" << std::endl;
         std::cout << "[Handler] Received data size: " << data.size() << " bytes" << std::endl;
         
@@ -840,10 +1149,12 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
                         int64_t lastOrderTime = std::stoll(*lastOrderTimeStr);
                         if ((currentTime - lastOrderTime) < 1000) { // 1 second rate limit
                             std::cout << "[Handler] Rate limit exceeded for session: " << sessionId << std::endl;
+                            ordersRejected_["rate_limit"].increment();
+                            windowedMetrics_.mark("orders.rejected");
                             nlohmann::json error = createErrorResponse("RATE_LIMIT_EXCEEDED", "Too many requests");
                             std::string errorStr = error.dump();
                             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-                            auto serializedResponse = app_->getProtocol()->serialize("orders.place", errorData);
+                            auto serializedResponse = serializeResponse("orders.place", errorData);
                             context.reply(serializedResponse);
                             return;
                         }
@@ -916,6 +1227,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
         }
         
         // BinaryRPC provides the payload in MsgPack binary format - we need to decode it
+        TRACE_STAGE_NEXT(stage, "orders.place.parse");
         std::cout << "[Handler] Parsing MsgPack payload, data size: " << data.size() << std::endl;
         
         auto request = parseMsgPackPayload(data);
@@ -933,6 +1245,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
         std::cout << "[Handler] Extracted fields - symbol: " << symbol << ", side: " << side << ", qty: " << qty << std::endl;
         
         // Check idempotency cache (QoS1 - AtLeastOnce guarantee)
+        TRACE_STAGE_NEXT(stage, "orders.place.idempotency");
         std::cout << "[Handler] About to check idempotency cache with key: " << idempotencyKey << std::endl;
         
         // Check if idempotencyCache_ is valid before calling
@@ -947,7 +1260,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
             };
             std::string jsonStr = errorResponse.dump();
             std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("orders.place", responseData);
+            auto serializedResponse = serializeResponse("orders.place", responseData);
             context.reply(serializedResponse);
             return;
         }
@@ -982,7 +1295,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
                 };
                 std::string jsonStr = response.dump();
                 std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-                auto serializedResponse = app_->getProtocol()->serialize("orders.place", responseData);
+                auto serializedResponse = serializeResponse("orders.place", responseData);
                 context.reply(serializedResponse);
                 return;
             } catch (const std::exception& e) {
@@ -991,6 +1304,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
             }
         }
         
+        TRACE_STAGE_NEXT(stage, "orders.place.risk");
         std::cout << "[Handler] No cached result, creating new order" << std::endl;
         
         // Create order
@@ -1016,6 +1330,8 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
         if (!riskValidator_->validate(account, positions, order)) {
             trading::domain::OrderResult result(trading::domain::OrderStatus::REJECTED, orderId, idempotencyKey, riskValidator_->getValidationError());
             idempotencyCache_->put(idempotencyKey, result);
+            ordersRejected_[rejectReasonLabel(result.reason)].increment();
+            windowedMetrics_.mark("orders.rejected");
             
             nlohmann::json response = {
                 {"status", static_cast<int>(result.status)},
@@ -1035,12 +1351,13 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
             };
             std::string jsonStr = response.dump();
             std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("orders.place", responseData);
+            auto serializedResponse = serializeResponse("orders.place", responseData);
             context.reply(serializedResponse);
             return;
         }
         
         // For demo purposes, simulate order execution
+        TRACE_STAGE_NEXT(stage, "orders.place.idempotency_put");
         trading::domain::OrderStatus status = trading::domain::OrderStatus::ACK;
         if (orderType == trading::domain::OrderType::MARKET) {
             status = trading::domain::OrderStatus::FILLED;
@@ -1050,6 +1367,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
         idempotencyCache_->put(idempotencyKey, result);
         
         // Log order to ClickHouse if available with error handling
+        TRACE_STAGE_NEXT(stage, "orders.place.clickhouse");
         std::cout << "[Handler] Checking ClickHouse logging..." << std::endl;
         if (historyRepository_) {
             std::cout << "[Handler] HistoryRepository is available" << std::endl;
@@ -1060,40 +1378,25 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
                 if (clickhouseRepo) {
                     std::cout << "[Handler] ClickHouse connected: " << (clickhouseRepo->isConnected() ? "YES" : "NO") << std::endl;
                     
-                    nlohmann::json orderDetails = {
-                        {"orderId", orderId.empty() ? "unknown" : orderId},
-                        {"symbol", symbol.empty() ? "unknown" : symbol},
-                        {"side", side.empty() ? "unknown" : side},
-                        {"type", type.empty() ? "unknown" : type},
-                        {"quantity", qty},
-                        {"price", price},
-                        {"status", static_cast<int>(status)},
-                        {"sessionId", context.session().id().empty() ? "unknown" : context.session().id()},
-                        {"timestamp", std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::system_clock::now().time_since_epoch()).count()}
-                    };
+                    trading::infrastructure::database::OrderEvent event;
+                    event.orderId = orderId;
+                    event.idempKey = idempotencyKey;
+                    event.status = (status == trading::domain::OrderStatus::ACK) ? "ACK" :
+                                   (status == trading::domain::OrderStatus::FILLED) ? "FILLED" :
+                                   (status == trading::domain::OrderStatus::REJECTED) ? "REJECTED" : "UNKNOWN";
+                    event.symbol = symbol;
+                    event.side = orderSide == trading::domain::Side::BUY ? "BUY" : "SELL";
+                    event.type = orderType == trading::domain::OrderType::MARKET ? "MARKET" : "LIMIT";
+                    event.quantity = qty;
+                    event.price = price;
+                    event.accountId = account.accountId;
+                    event.sessionId = context.session().id();
                     
-                    std::string statusStr = (status == trading::domain::OrderStatus::ACK) ? "ACK" :
-                                          (status == trading::domain::OrderStatus::FILLED) ? "FILLED" :
-                                          (status == trading::domain::OrderStatus::REJECTED) ? "REJECTED" : "UNKNOWN";
-                    
-                    std::cout << "[Handler] Calling logOrder with idempKey: " << idempotencyKey << ", status: " << statusStr << ", orderId: " << orderId << std::endl;
-                    
-                    std::string jsonStr;
-                    try {
-                        jsonStr = orderDetails.dump();
-                        // Ensure JSON is valid and not too long
-                        if (jsonStr.length() > 10000) {
-                            jsonStr = "{\"error\":\"json_too_large\"}";
-                        }
-                    } catch (const std::exception& json_e) {
-                        std::cout << "[Handler] JSON dump failed: " << json_e.what() << std::endl;
-                        jsonStr = "{\"error\":\"json_dump_failed\"}";
-                    }
+                    std::cout << "[Handler] Calling logOrder with idempKey: " << idempotencyKey << ", status: " << event.status << ", orderId: " << orderId << std::endl;
                     
                     // Try ClickHouse logging - isConnected check removed
                     try {
-                        bool logResult = clickhouseRepo->logOrder(idempotencyKey, statusStr, orderId, jsonStr);
+                        bool logResult = clickhouseRepo->logOrder(event);
                         std::cout << "[Handler] logOrder result: " << (logResult ? "SUCCESS" : "FAILED") << std::endl;
 
                         // If logging failed, try to reconnect once
@@ -1101,7 +1404,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
                             std::cout << "[Handler] Attempting to reconnect ClickHouse..." << std::endl;
                             if (clickhouseRepo->reconnect()) {
                                 std::cout << "[Handler] Reconnected successfully, retrying log..." << std::endl;
-                                logResult = clickhouseRepo->logOrder(idempotencyKey, statusStr, orderId, jsonStr);
+                                logResult = clickhouseRepo->logOrder(event);
                                 std::cout << "[Handler] Retry logOrder result: " << (logResult ? "SUCCESS" : "FAILED") << std::endl;
                             }
                         }
@@ -1127,6 +1430,7 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
         }
         
         // Store order in session state using sessionManager
+        TRACE_STAGE_NEXT(stage, "orders.place.session_state");
         try {
             auto& sessionManager = app_->getSessionManager();
             sessionManager.setField(context.session().id(), "lastOrderId", orderId, false);
@@ -1135,13 +1439,12 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
             std::cout << "[Handler] Error setting session data: " << e.what() << std::endl;
         }
         
-        // Update metrics
-        totalOrdersPlaced_++;
-        
-        // Check and broadcast alerts after metrics change
-        checkAndBroadcastAlerts();
+        // Update metrics; alert rules are evaluated by the alert evaluator thread
+        ordersPlaced_[symbol].increment();
+        windowedMetrics_.mark("orders");
         
         // Create detailed response like order history
+        TRACE_STAGE_NEXT(stage, "orders.place.reply");
         nlohmann::json response = {
             {"status", static_cast<int>(result.status)},
             {"orderId", result.orderId},
@@ -1165,19 +1468,18 @@ void AdvancedTradingServer::handleOrdersPlace(const std::vector<uint8_t>& data,
         std::cout << "[Handler] Sending order response: " << jsonStr << std::endl;
         std::cout << "[Handler] Response data size: " << responseData.size() << " bytes" << std::endl;
         
-        auto serializedResponse = app_->getProtocol()->serialize("orders.place", responseData);
+        auto serializedResponse = serializeResponse("orders.place", responseData);
         context.reply(serializedResponse);
         std::cout << "[Handler] Order response sent successfully!" << std::endl;
         
     } catch (const std::exception& e) {
-        totalErrors_++;
-        // Check and broadcast alerts after error metrics change
-        checkAndBroadcastAlerts();
+        rpcErrors_["orders.place"].increment();
+        windowedMetrics_.mark("errors");
         
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Order placement failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("orders.place", errorData);
+        auto serializedResponse = serializeResponse("orders.place", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1202,50 +1504,30 @@ void AdvancedTradingServer::handleOrdersCancel(const std::vector<uint8_t>& data,
         if (historyRepository_) {
             try {
                 auto* clickhouseRepo = dynamic_cast<trading::infrastructure::database::ClickHouseHistoryRepository*>(historyRepository_.get());
-                if (clickhouseRepo && clickhouseRepo->isConnected()) {
-                    // First get the original order details to preserve order information
+                if (clickhouseRepo) {
+                    // Queued like placements, also during warm-up, when an order
+                    // placed since startup is found among the recent ones. The
+                    // cancellation carries the original order's fields and
+                    // placement time, so it replaces that order in orders_latest.
+                    // Without them it would be a second row for the order.
                     auto originalOrder = clickhouseRepo->getOrderDetails(orderId);
-                    
-                    nlohmann::json orderDetails;
-                    if (originalOrder.has_value()) {
-                        // Preserve original order details and add cancellation info
-                        orderDetails = originalOrder.value();
+                    if (!originalOrder.has_value()) {
+                        std::cout << "[Handler] Order " << orderId << " not found, cancellation not logged" << std::endl;
+                    } else {
+                        trading::infrastructure::database::OrderEvent event = *originalOrder;
+                        event.eventType = "CANCEL";
+                        event.status = "CANCELLED";
+                        event.sessionId = context.session().id();
+                        event.tsMs = 0;  // Now
                         
-                        // Extract original order info from result JSON if available
-                        if (orderDetails.contains("result") && orderDetails["result"].is_object()) {
-                            auto result = orderDetails["result"];
-                            orderDetails["symbol"] = result.value("symbol", "");
-                            orderDetails["side"] = result.value("side", "");
-                            orderDetails["price"] = result.value("price", 0.0);
-                            orderDetails["quantity"] = result.value("quantity", 0.0);
-                            orderDetails["type"] = result.value("type", "");
+                        std::string cancelIdempKey = "CANCEL_" + orderId;
+                        try {
+                            event.idempKey = cancelIdempKey;
+                            clickhouseRepo->logOrder(event);
+                            std::cout << "[Handler] Order cancellation logged successfully with original details" << std::endl;
+                        } catch (const std::exception& cancel_log_e) {
+                            std::cout << "[Handler] Cancel logOrder failed: " << cancel_log_e.what() << std::endl;
                         }
-                    } else {
-                        // Fallback if original order not found
-                        orderDetails = {
-                            {"symbol", ""},
-                            {"side", ""},
-                            {"price", 0.0},
-                            {"quantity", 0.0},
-                            {"type", ""}
-                        };
-                    }
-                    
-                    // Add cancellation-specific details
-                    orderDetails["originalOrderId"] = orderDetails.value("order_id", orderId);
-                    orderDetails["orderId"] = orderId;
-                    orderDetails["status"] = "CANCELLED";
-                    orderDetails["sessionId"] = context.session().id();
-                    orderDetails["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::system_clock::now().time_since_epoch()).count();
-                    orderDetails["cancelledAt"] = orderDetails["timestamp"];
-                    
-                    std::string cancelIdempKey = "CANCEL_" + orderId;
-                    try {
-                        clickhouseRepo->logOrder(cancelIdempKey, "CANCELLED", orderId, orderDetails.dump());
-                        std::cout << "[Handler] Order cancellation logged successfully with original details" << std::endl;
-                    } catch (const std::exception& cancel_log_e) {
-                        std::cout << "[Handler] Cancel logOrder failed: " << cancel_log_e.what() << std::endl;
                     }
                 }
             } catch (const std::exception& e) {
@@ -1253,11 +1535,8 @@ void AdvancedTradingServer::handleOrdersCancel(const std::vector<uint8_t>& data,
             }
         }
         
-        // Update metrics
-        totalOrdersCancelled_++;
-        
-        // Check and broadcast alerts after metrics change
-        checkAndBroadcastAlerts();
+        // Update metrics; alert rules are evaluated by the alert evaluator thread
+        ordersCancelled_.increment();
         
         // For demo purposes, always succeed
         nlohmann::json response = {
@@ -1269,18 +1548,17 @@ void AdvancedTradingServer::handleOrdersCancel(const std::vector<uint8_t>& data,
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("orders.cancel", responseData);
+        auto serializedResponse = serializeResponse("orders.cancel", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
-        totalErrors_++;
-        // Check and broadcast alerts after error metrics change
-        checkAndBroadcastAlerts();
+        rpcErrors_["orders.cancel"].increment();
+        windowedMetrics_.mark("errors");
         
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Order cancellation failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("orders.cancel", errorData);
+        auto serializedResponse = serializeResponse("orders.cancel", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1302,14 +1580,14 @@ void AdvancedTradingServer::handleOrdersStatus(const std::vector<uint8_t>& data,
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("orders.status", responseData);
+        auto serializedResponse = serializeResponse("orders.status", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Order status retrieval failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("orders.status", errorData);
+        auto serializedResponse = serializeResponse("orders.status", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1337,6 +1615,9 @@ void AdvancedTradingServer::handleOrdersHistory(const std::vector<uint8_t>& data
         if (!historyRepository_) {
             throw std::runtime_error("History repository not available");
         }
+        if (replyIfWarmingUp(context, "orders.history")) {
+            return;
+        }
         
         // Cast to ClickHouseHistoryRepository to access getOrderHistory method
         auto clickhouseRepo = dynamic_cast<trading::infrastructure::database::ClickHouseHistoryRepository*>(historyRepository_.get());
@@ -1360,7 +1641,7 @@ void AdvancedTradingServer::handleOrdersHistory(const std::vector<uint8_t>& data
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("orders.history", responseData);
+        auto serializedResponse = serializeResponse("orders.history", responseData);
         context.reply(serializedResponse);
         
         std::cout << "[Handler] Order history response sent - " << orderHistory.size() << " orders" << std::endl;
@@ -1369,7 +1650,7 @@ void AdvancedTradingServer::handleOrdersHistory(const std::vector<uint8_t>& data
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Order history retrieval failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("orders.history", errorData);
+        auto serializedResponse = serializeResponse("orders.history", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1513,7 +1794,7 @@ void AdvancedTradingServer::handleMarketDataSubscribe(const std::vector<uint8_t>
         std::cout << "[Subscribe] About to serialize response with MsgPack" << std::endl;
         
         // Use MsgPack protocol to serialize response (like in basic_chat.cpp)
-        auto serializedResponse = app_->getProtocol()->serialize("market.subscribe_response", responseData);
+        auto serializedResponse = serializeResponse("market.subscribe_response", responseData);
         std::cout << "[Subscribe] About to send response" << std::endl;
         context.reply(serializedResponse);
         std::cout << "[Subscribe] Response sent successfully" << std::endl;
@@ -1551,14 +1832,14 @@ void AdvancedTradingServer::handleMarketDataUnsubscribe(const std::vector<uint8_
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("market.unsubscribe", responseData);
+        auto serializedResponse = serializeResponse("market.unsubscribe", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Unsubscription failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("market.unsubscribe", errorData);
+        auto serializedResponse = serializeResponse("market.unsubscribe", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1588,14 +1869,14 @@ void AdvancedTradingServer::handleMarketDataList(const std::vector<uint8_t>& dat
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("market.list", responseData);
+        auto serializedResponse = serializeResponse("market.list", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Market data list failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("market.list", errorData);
+        auto serializedResponse = serializeResponse("market.list", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1625,6 +1906,9 @@ void AdvancedTradingServer::handleHistoryQuery(const std::vector<uint8_t>& data,
         }
         std::string interval = request.value("interval", "M1");
         int32_t limit = request.value("limit", 1000);
+        // A point budget: the whole range comes back in at most this many wider candles
+        int32_t maxPoints = std::min(request.value("maxPoints", 0), kMaxHistoryPoints);
+        int64_t bucketSeconds = 0;
         
         // Convert milliseconds to seconds for ClickHouse
         int64_t fromTs = fromTsMs / 1000;
@@ -1645,10 +1929,13 @@ void AdvancedTradingServer::handleHistoryQuery(const std::vector<uint8_t>& data,
             nlohmann::json error = createErrorResponse("SERVICE_UNAVAILABLE", "ClickHouse repository not initialized");
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("history.query", errorData);
+            auto serializedResponse = serializeResponse("history.query", errorData);
             context.reply(serializedResponse);
             return;
         }
+        if (replyIfWarmingUp(context, "history.query")) {
+            return;
+        }
         
         try {
             // Convert string interval to enum
@@ -1664,8 +1951,41 @@ void AdvancedTradingServer::handleHistoryQuery(const std::vector<uint8_t>& data,
             
             trading::domain::Symbol symbolObj(symbol);
             trading::domain::HistoryQuery queryObj(fromTs, toTs, intervalEnum, limit);
+            if (maxPoints > 0) {
+                bucketSeconds = trading::application::downsampleBucketSeconds(fromTs, toTs, intervalEnum, maxPoints);
+                queryObj.limit = maxPoints;
+                if (bucketSeconds > trading::application::intervalSeconds(intervalEnum)) {
+                    queryObj.bucketSeconds = bucketSeconds;
+                }
+            }
             
-            auto realCandles = historyRepository_->fetch(symbolObj, queryObj);
+            // Second candles of the retained days come straight from the tick
+            // journal; a range starting before its oldest tick, or a symbol it
+            // has not seen, goes to the repository
+            std::vector<trading::domain::Candle> realCandles;
+            bool secondInterval = intervalEnum == trading::domain::Interval::S1 ||
+                                  intervalEnum == trading::domain::Interval::S5 ||
+                                  intervalEnum == trading::domain::Interval::S15;
+            auto journal = std::atomic_load(&tickJournal_);
+            if (journal && secondInterval) {
+                auto ticks = journal->range(symbol, fromTs * 1000, (toTs + 1) * 1000);
+                int64_t firstBucketEndMs = (fromTs + trading::application::intervalSeconds(intervalEnum)) * 1000;
+                if (!ticks.empty() && ticks.front().front().ts < firstBucketEndMs) {
+                    realCandles = trading::application::candlesFromTicks(ticks, intervalEnum);
+                }
+            }
+            bool fromJournal = !realCandles.empty();
+            if (!fromJournal) {
+                realCandles = historyRepository_->fetch(symbolObj, queryObj);
+            }
+            if (queryObj.bucketSeconds > 0) {
+                // No-op for candles the database already aggregated; merges the rest
+                realCandles = trading::application::downsampleCandles(realCandles, queryObj.bucketSeconds);
+            }
+            if (fromJournal && realCandles.size() > static_cast<size_t>(queryObj.limit)) {
+                // Newest first, as the repository's LIMIT keeps them
+                realCandles.resize(queryObj.limit);
+            }
             
             // Convert Candle objects to JSON
             for (const auto& candle : realCandles) {
@@ -1686,7 +2006,7 @@ void AdvancedTradingServer::handleHistoryQuery(const std::vector<uint8_t>& data,
             nlohmann::json error = createErrorResponse("QUERY_FAILED", "Failed to fetch historical data: " + std::string(e.what()));
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("history.query", errorData);
+            auto serializedResponse = serializeResponse("history.query", errorData);
             context.reply(serializedResponse);
             return;
         }
@@ -1699,18 +2019,22 @@ void AdvancedTradingServer::handleHistoryQuery(const std::vector<uint8_t>& data,
             {"toTs", toTs},
             {"interval", interval}
         };
+        if (maxPoints > 0) {
+            response["maxPoints"] = maxPoints;
+            response["bucketSeconds"] = bucketSeconds;
+        }
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
         
-        auto serializedResponse = app_->getProtocol()->serialize("history.query", responseData);
+        auto serializedResponse = serializeResponse("history.query", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "History query failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("history.query", errorData);
+        auto serializedResponse = serializeResponse("history.query", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1724,23 +2048,17 @@ void AdvancedTradingServer::handleHistoryLatest(const std::vector<uint8_t>& data
             nlohmann::json error = createErrorResponse("SERVICE_UNAVAILABLE", "ClickHouse repository not initialized");
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("history.latest", errorData);
+            auto serializedResponse = serializeResponse("history.latest", errorData);
             context.reply(serializedResponse);
             return;
         }
+        if (replyIfWarmingUp(context, "history.latest")) {
+            return;
+        }
         
         try {
-            // Get latest prices for all available symbols
-            std::vector<trading::domain::Symbol> symbols = {
-                trading::domain::Symbol("BTC-USD"),
-                trading::domain::Symbol("ETH-USD"),
-                trading::domain::Symbol("ADA-USD"),
-                trading::domain::Symbol("SOL-USD"),
-                trading::domain::Symbol("DOGE-USD"),
-                trading::domain::Symbol("AVAX-USD"),
-                trading::domain::Symbol("MATIC-USD"),
-                trading::domain::Symbol("LINK-USD")
-            };
+            // Get latest prices for all available symbols, as warmUp() reads them
+            std::vector<trading::domain::Symbol> symbols(kKnownSymbols.begin(), kKnownSymbols.end());
             
             auto latestCandles = historyRepository_->latest(symbols, symbols.size());
             
@@ -1763,7 +2081,7 @@ void AdvancedTradingServer::handleHistoryLatest(const std::vector<uint8_t>& data
                 nlohmann::json error = createErrorResponse("NO_DATA", "No historical data available in ClickHouse");
                 std::string errorStr = error.dump();
                 std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-                auto serializedResponse = app_->getProtocol()->serialize("history.latest", errorData);
+                auto serializedResponse = serializeResponse("history.latest", errorData);
                 context.reply(serializedResponse);
                 return;
             }
@@ -1773,7 +2091,7 @@ void AdvancedTradingServer::handleHistoryLatest(const std::vector<uint8_t>& data
             nlohmann::json error = createErrorResponse("QUERY_FAILED", "Failed to fetch latest prices: " + std::string(e.what()));
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("history.latest", errorData);
+            auto serializedResponse = serializeResponse("history.latest", errorData);
             context.reply(serializedResponse);
             return;
         }
@@ -1788,14 +2106,14 @@ void AdvancedTradingServer::handleHistoryLatest(const std::vector<uint8_t>& data
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
         
-        auto serializedResponse = app_->getProtocol()->serialize("history.latest", responseData);
+        auto serializedResponse = serializeResponse("history.latest", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "History latest failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("history.latest", errorData);
+        auto serializedResponse = serializeResponse("history.latest", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1804,61 +2122,94 @@ void AdvancedTradingServer::handleMetricsGet(const std::vector<uint8_t>& data, b
     try {
         // Middleware already handled authentication
         
-        // Calculate real-time metrics
-        auto now = std::chrono::steady_clock::now();
-        auto uptimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime_).count();
-        auto uptimeSeconds = uptimeMs / 1000.0;
+        auto uptimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime_).count();
         
-        // Get current metrics values
-        int totalOrders = totalOrdersPlaced_.load();
-        int totalCancels = totalOrdersCancelled_.load();
-        int totalErrs = totalErrors_.load();
+        int64_t totalOrders = metricsRegistry_.total("orders_placed_total");
+        int64_t totalCancels = ordersCancelled_.value();
+        int64_t totalRejects = metricsRegistry_.total("orders_rejected_total");
+        int64_t totalErrs = metricsRegistry_.total("rpc_errors_total");
         
-        // Mock realistic throughput for HFT trading system (requirements.md: "throughput")
-        double realThroughput = (uptimeSeconds > 0) ? (totalOrders / uptimeSeconds) : 0.0;
-        double mockThroughput = realThroughput + (std::rand() % 100) / 10.0; // Add 0-10 orders/sec variation
-        double throughput = mockThroughput;
+        auto metrics = snapshotMetrics();
+        auto connectionStats = connectionTracker_.snapshot(false);
         
-        // Calculate error rate
-        int totalOperations = totalOrders + totalCancels;
-        double errorRate = (totalOperations > 0) ? (static_cast<double>(totalErrs) / totalOperations) : 0.0;
-        
-        // Mock realistic latency for trading system (requirements.md: "real-time metrics of the trading system, such as latency")
-        std::srand(std::time(nullptr));
-        double baseLatency = 0.5 + (errorRate * 25.0); // Base latency increases with error rate
-        double randomVariation = (std::rand() % 200) / 100.0; // 0-2ms random variation
-        double latencyMs = baseLatency + randomVariation;
+        // Windowed aggregates as "<series>.<stat>", the keys alert rules may reference
+        nlohmann::json windows = nlohmann::json::object();
+        for (const auto& [key, value] : metrics.windowed) {
+            windows[key] = std::round(value * 1000) / 1000.0;
+        }
         
-        // Ensure realistic HFT latency range (0.5ms - 50ms)
-        if (latencyMs < 0.5) latencyMs = 0.5;
-        if (latencyMs > 50.0) latencyMs = 50.0;
+        // Labeled counter series (orders by symbol, rejects by reason, errors by method)
+        nlohmann::json counters = nlohmann::json::array();
+        for (const auto& sample : metricsRegistry_.snapshot()) {
+            if (sample.value == 0) {
+                continue;
+            }
+            counters.push_back({
+                {"name", sample.name},
+                {"labels", sample.labels},
+                {"value", sample.value}
+            });
+        }
+        
+        auto round2 = [](double value) { return std::round(value * 100) / 100.0; };
+        auto latencyJson = [&](const trading::domain::LatencyStats& stats) {
+            return nlohmann::json{
+                {"count", stats.count},
+                {"avg", round2(stats.meanMs)},
+                {"p50", round2(stats.p50Ms)},
+                {"p95", round2(stats.p95Ms)},
+                {"p99", round2(stats.p99Ms)},
+                {"p999", round2(stats.p999Ms)},
+                {"max", round2(stats.maxMs)},
+                {"unit", "ms"}
+            };
+        };
         
-        // Mock realistic connection count for trading system
-        int realConnCount = activeConnections_.load();
-        int mockConnCount = realConnCount + (std::rand() % 500) + 50; // Add 50-549 mock connections
+        // Per-RPC latency breakdown from the metrics collector histograms
+        nlohmann::json methods = nlohmann::json::object();
+        if (metricsCollector_) {
+            for (const auto& method : metricsCollector_->collectMethods()) {
+                methods[method.method] = {
+                    {"count", method.service.count},
+                    {"throughput", round2(method.throughput)},
+                    {"service", latencyJson(method.service)},
+                    {"queue", latencyJson(method.queue)},
+                    {"serialize", latencyJson(method.serialize)}
+                };
+            }
+        }
         
-        // Calculate p95 latency (mock realistic HFT p95)
-        double p95Latency = latencyMs * (1.5 + (std::rand() % 100) / 100.0); // 1.5x to 2.5x of avg latency
+        // Connection lifecycle totals only; session ids are resume credentials and never leave the server
+        nlohmann::json connections = {
+            {"openSockets", connectionStats.openSockets},
+            {"authenticatedSessions", connectionStats.authenticatedSessions},
+            {"detachedSessions", connectionStats.detachedSessions},
+            {"connectsTotal", connectionStats.connectsTotal},
+            {"disconnectsTotal", connectionStats.disconnectsTotal},
+            {"resumesTotal", connectionStats.resumesTotal},
+            {"expiredTotal", connectionStats.expiredTotal},
+            {"detachedFrames", connectionStats.detachedFrames},
+            {"detachedBytes", connectionStats.detachedBytes},
+            {"sessionsWithDetachedSends", connectionStats.sessionsWithDetachedSends},
+            {"maxSessionDetachedFrames", connectionStats.maxSessionDetachedFrames},
+            {"maxSessionDetachedBytes", connectionStats.maxSessionDetachedBytes}
+        };
         
-        // Mock realistic system performance data
         nlohmann::json systemPerformance = {
-            {"latency", {
-                {"avg", std::round(latencyMs * 100) / 100.0},
-                {"unit", "ms"},
-                {"p95", std::round(p95Latency * 100) / 100.0}
-            }},
+            {"latency", latencyJson(metrics.latency)},
             {"throughput", {
-                {"value", std::round(throughput * 100) / 100.0},
+                {"value", round2(metrics.throughput)},
                 {"unit", "tx/s"},
-                {"period", "1m avg."}
+                {"period", "10s window"}
             }},
             {"errorRate", {
-                {"value", std::round(errorRate * 10000) / 100.0}, // Convert to percentage with 2 decimals
+                {"value", std::round(metrics.errorRate * 10000) / 100.0}, // Convert to percentage with 2 decimals
                 {"unit", "%"},
-                {"period", "Last 5 min"}
+                {"period", "lifetime"}
             }},
             {"connectionCount", {
-                {"value", mockConnCount},
+                {"value", metrics.connCount},
                 {"status", "active"}
             }},
             {"totalOrders", {
@@ -1869,43 +2220,56 @@ void AdvancedTradingServer::handleMetricsGet(const std::vector<uint8_t>& data, b
                 {"value", totalCancels},
                 {"period", "total"}
             }},
+            {"rejected", {
+                {"value", totalRejects},
+                {"period", "total"}
+            }},
             {"errors", {
                 {"value", totalErrs},
                 {"period", "total"}
             }},
             {"activeSessions", {
-                {"value", mockConnCount},
+                {"value", connectionStats.authenticatedSessions},
                 {"status", "current"}
             }}
         };
 
         nlohmann::json response = {
-            {"ts", std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count()},
+            {"ts", metrics.ts},
             {"uptimeMs", uptimeMs},
             {"systemPerformance", systemPerformance},
+            {"methods", methods},
+            {"counters", counters},
+            {"connections", connections},
+            {"alertEvaluation", latencyJson(alertEvaluation_.snapshot())},
+            {"priceAlerts", {
+                {"active", priceAlerts_.size()},
+                {"firedTotal", priceAlertsFired_.value()}
+            }},
+            {"windows", windows},
             // Keep backward compatibility
-            {"latencyMs", latencyMs},
-            {"throughput", throughput},
-            {"errorRate", errorRate},
+            {"latencyMs", metrics.latencyMs},
+            {"throughput", metrics.throughput},
+            {"errorRate", metrics.errorRate},
             {"totalOrders", totalOrders},
             {"totalCancels", totalCancels},
             {"totalErrors", totalErrs},
-            {"connCount", mockConnCount},
-            {"activeSessions", mockConnCount}
+            {"connCount", metrics.connCount},
+            {"activeSessions", connectionStats.authenticatedSessions}
         };
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("metrics.get", responseData);
+        auto serializedResponse = serializeResponse("metrics.get", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
-        totalErrors_++;
+        rpcErrors_["metrics.get"].increment();
+        windowedMetrics_.mark("errors");
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Metrics retrieval failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("metrics.get", errorData);
+        auto serializedResponse = serializeResponse("metrics.get", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1925,14 +2289,14 @@ void AdvancedTradingServer::handleAlertsSubscribe(const std::vector<uint8_t>& da
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.subscribe", responseData);
+        auto serializedResponse = serializeResponse("alerts.subscribe", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Alert subscription failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.subscribe", errorData);
+        auto serializedResponse = serializeResponse("alerts.subscribe", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -1941,30 +2305,13 @@ void AdvancedTradingServer::handleAlertsList(const std::vector<uint8_t>& data, b
     try {
         // Middleware already handled authentication
         
-        // Get real-time metrics for alert evaluation (same as handleMetricsGet)
-        auto now = std::chrono::steady_clock::now();
-        auto uptimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime_).count();
-        auto uptimeSeconds = uptimeMs / 1000.0;
-        
-        int totalOrders = totalOrdersPlaced_.load();
-        int totalCancels = totalOrdersCancelled_.load();
-        int totalErrs = totalErrors_.load();
-        
-        // Use same mock metrics as handleMetricsGet for consistency
-        double realThroughput = (uptimeSeconds > 0) ? (totalOrders / uptimeSeconds) : 0.0;
-        double throughput = realThroughput + (std::rand() % 100) / 10.0;
-        
-        int totalOperations = totalOrders + totalCancels;
-        double errorRate = (totalOperations > 0) ? (static_cast<double>(totalErrs) / totalOperations) : 0.0;
-        
-        double baseLatency = 0.5 + (errorRate * 25.0);
-        double randomVariation = (std::rand() % 200) / 100.0;
-        double latencyMs = baseLatency + randomVariation;
-        if (latencyMs < 0.5) latencyMs = 0.5;
-        if (latencyMs > 50.0) latencyMs = 50.0;
-        
-        int realConnCount = activeConnections_.load();
-        int connCount = realConnCount + (std::rand() % 500) + 50;
+        // Get real-time metrics for alert evaluation (same source as handleMetricsGet)
+        auto uptimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+        auto currentMetrics = snapshotMetrics();
+        double latencyMs = currentMetrics.latencyMs;
+        double throughput = currentMetrics.throughput;
+        double errorRate = currentMetrics.errorRate;
+        int connCount = currentMetrics.connCount;
         
         // Define alert thresholds and evaluate current status
         nlohmann::json alerts = nlohmann::json::object();
@@ -2024,20 +2371,21 @@ void AdvancedTradingServer::handleAlertsList(const std::vector<uint8_t>& data, b
                 "Throughput normal: " + std::to_string(throughput) + " orders/sec"}
         };
         
-        // Use IAlertingService if available for proper evaluation
-        std::vector<trading::domain::AlertEvent> alertEvents;
-        if (alertingService_) {
-            trading::domain::Metrics metrics(
-                std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::system_clock::now().time_since_epoch()).count(),
-                latencyMs, throughput, errorRate, connCount
-            );
-            alertEvents = alertingService_->evaluate(metrics);
+        // Custom rules triggered by the current metrics
+        nlohmann::json alertEvents = nlohmann::json::array();
+        for (const auto& event : evaluateAlertRules(currentMetrics)) {
+            alertEvents.push_back({
+                {"eventId", event.eventId},
+                {"ruleId", event.ruleId},
+                {"ts", event.ts},
+                {"value", event.value},
+                {"message", event.message}
+            });
         }
         
         nlohmann::json response = {
             {"alerts", alerts},
-            {"alertEvents", nlohmann::json::array()},  // Placeholder for AlertEvent objects
+            {"alertEvents", alertEvents},
             {"timestamp", std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::system_clock::now().time_since_epoch()).count()},
             {"message", "Real-time system alerts with current metrics"}
@@ -2045,34 +2393,14 @@ void AdvancedTradingServer::handleAlertsList(const std::vector<uint8_t>& data, b
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.list", responseData);
+        auto serializedResponse = serializeResponse("alerts.list", responseData);
         context.reply(serializedResponse);
         
-        // Broadcast alerts to subscribed clients if any alert status changed
-        bool hasAlerts = false;
-        for (auto& [key, alert] : alerts.items()) {
-            if (alert["status"] == "alert" || alert["status"] == "warning") {
-                hasAlerts = true;
-                break;
-            }
-        }
-        
-        if (hasAlerts) {
-            // Broadcast alert status change to subscribed clients
-            nlohmann::json broadcastData = {
-                {"type", "alert_status_change"},
-                {"alerts", alerts},
-                {"timestamp", response["timestamp"]},
-                {"message", "System alert status changed"}
-            };
-            broadcastAlerts(broadcastData);
-        }
-        
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Alerts list failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.list", errorData);
+        auto serializedResponse = serializeResponse("alerts.list", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -2086,27 +2414,40 @@ void AdvancedTradingServer::handleAlertsRegister(const std::vector<uint8_t>& dat
         std::string ruleId = request.value("ruleId", "");
         std::string metricKey = request.value("metricKey", "");
         std::string operator_ = request.value("operator", "");
-        double threshold = request.value("threshold", 0.0);
         bool enabled = request.value("enabled", true);
         
         if (ruleId.empty() || metricKey.empty() || operator_.empty()) {
             nlohmann::json error = createErrorResponse("INVALID_PARAMS", "Missing required parameters: ruleId, metricKey, operator");
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("alerts.register", errorData);
+            auto serializedResponse = serializeResponse("alerts.register", errorData);
             context.reply(serializedResponse);
             return;
         }
         
-        // Create AlertRule object
-        trading::domain::AlertRule rule(ruleId, metricKey, operator_, threshold, enabled);
-        
-        // Register rule in our local storage
-        registerAlertRule(rule);
-        
-        // Also use IAlertingService if available (for consistency)
-        if (alertingService_) {
-            alertingService_->registerRule(rule);
+        // Compile and index the rule; unknown metrics, operators or threshold units are rejected.
+        // Windowed metrics use "<series>.<stat>" keys, e.g. "orders.place.p99_10s" with threshold "5ms".
+        double threshold = 0.0;
+        try {
+            threshold = parseThresholdMs(request.value("threshold", nlohmann::json(0.0)),
+                                         trading::application::AlertRuleEngine::isLatencyMetricKey(metricKey));
+            
+            // Hysteresis and cooldown fall back to the engine defaults
+            trading::domain::AlertRule rule(ruleId, metricKey, operator_, threshold, enabled);
+            if (request.contains("hysteresis")) {
+                rule.hysteresis = request["hysteresis"].get<double>();
+            }
+            if (request.contains("cooldownMs")) {
+                rule.cooldownMs = request["cooldownMs"].get<int64_t>();
+            }
+            registerAlertRule(rule);
+        } catch (const std::invalid_argument& e) {
+            nlohmann::json error = createErrorResponse("INVALID_PARAMS", e.what());
+            std::string errorStr = error.dump();
+            std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+            auto serializedResponse = serializeResponse("alerts.register", errorData);
+            context.reply(serializedResponse);
+            return;
         }
         
         nlohmann::json response = {
@@ -2120,14 +2461,14 @@ void AdvancedTradingServer::handleAlertsRegister(const std::vector<uint8_t>& dat
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.register", responseData);
+        auto serializedResponse = serializeResponse("alerts.register", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Alert rule registration failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.register", errorData);
+        auto serializedResponse = serializeResponse("alerts.register", errorData);
         context.reply(serializedResponse);
     }
 }
@@ -2144,19 +2485,13 @@ void AdvancedTradingServer::handleAlertsDisable(const std::vector<uint8_t>& data
             nlohmann::json error = createErrorResponse("INVALID_PARAMS", "Missing required parameter: ruleId");
             std::string errorStr = error.dump();
             std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-            auto serializedResponse = app_->getProtocol()->serialize("alerts.disable", errorData);
+            auto serializedResponse = serializeResponse("alerts.disable", errorData);
             context.reply(serializedResponse);
             return;
         }
         
-        // Disable rule in our local storage
         disableAlertRule(ruleId);
         
-        // Also use IAlertingService if available (for consistency)
-        if (alertingService_) {
-            alertingService_->disableRule(ruleId);
-        }
-        
         nlohmann::json response = {
             {"ruleId", ruleId},
             {"message", "Alert rule disabled successfully"}
@@ -2164,23 +2499,236 @@ void AdvancedTradingServer::handleAlertsDisable(const std::vector<uint8_t>& data
         
         std::string jsonStr = response.dump();
         std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.disable", responseData);
+        auto serializedResponse = serializeResponse("alerts.disable", responseData);
         context.reply(serializedResponse);
         
     } catch (const std::exception& e) {
         nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Alert rule disable failed: " + std::string(e.what()));
         std::string errorStr = error.dump();
         std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
-        auto serializedResponse = app_->getProtocol()->serialize("alerts.disable", errorData);
+        auto serializedResponse = serializeResponse("alerts.disable", errorData);
         context.reply(serializedResponse);
     }
 }
 
+void AdvancedTradingServer::handleAlertsPriceRegister(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api) {
+    try {
+        // Middleware already handled authentication
+        
+        auto request = parseMsgPackPayload(data);
+        
+        std::string symbol = request.value("symbol", "");
+        auto kind = trading::application::PriceAlertIndex::parseKind(request.value("kind", "cross"));
+        
+        bool knownSymbol = std::find(kKnownSymbols.begin(), kKnownSymbols.end(), symbol) != kKnownSymbols.end();
+        if (!knownSymbol || !kind) {
+            nlohmann::json error = createErrorResponse("INVALID_PARAMS", "Unknown symbol or kind (above, below, cross, move_up, move_down, move)");
+            std::string errorStr = error.dump();
+            std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+            auto serializedResponse = serializeResponse("alerts.price.register", errorData);
+            context.reply(serializedResponse);
+            return;
+        }
+        
+        // Alerts belong to the registering session, fire once and expire with the session
+        std::string sessionId = context.session().id();
+        trading::domain::PriceAlert alert("price_" + std::to_string(nextPriceAlertId_++), sessionId, symbol,
+                                          *kind, request.value("level", 0.0));
+        alert.movePercent = request.value("movePercent", 0.0);
+        alert.windowMs = request.value("windowMs", int64_t{60000});
+        
+        trading::domain::PriceAlertKind storedKind;
+        try {
+            storedKind = priceAlerts_.add(alert);
+        } catch (const std::invalid_argument& e) {
+            nlohmann::json error = createErrorResponse("INVALID_PARAMS", e.what());
+            std::string errorStr = error.dump();
+            std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+            auto serializedResponse = serializeResponse("alerts.price.register", errorData);
+            context.reply(serializedResponse);
+            return;
+        } catch (const std::length_error& e) {
+            nlohmann::json error = createErrorResponse("LIMIT_EXCEEDED", e.what());
+            std::string errorStr = error.dump();
+            std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+            auto serializedResponse = serializeResponse("alerts.price.register", errorData);
+            context.reply(serializedResponse);
+            return;
+        }
+        
+        nlohmann::json response = {
+            {"alertId", alert.alertId},
+            {"symbol", symbol},
+            {"kind", trading::application::PriceAlertIndex::kindName(storedKind)},
+            {"message", "Price alert registered successfully"}
+        };
+        if (storedKind == trading::domain::PriceAlertKind::ABOVE || storedKind == trading::domain::PriceAlertKind::BELOW) {
+            response["level"] = alert.level;
+        } else {
+            response["movePercent"] = alert.movePercent;
+            response["windowMs"] = alert.windowMs;
+        }
+        
+        std::string jsonStr = response.dump();
+        std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
+        auto serializedResponse = serializeResponse("alerts.price.register", responseData);
+        context.reply(serializedResponse);
+        
+    } catch (const std::exception& e) {
+        nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Price alert registration failed: " + std::string(e.what()));
+        std::string errorStr = error.dump();
+        std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+        auto serializedResponse = serializeResponse("alerts.price.register", errorData);
+        context.reply(serializedResponse);
+    }
+}
+
+void AdvancedTradingServer::handleAlertsPriceCancel(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api) {
+    try {
+        // Middleware already handled authentication
+        
+        auto request = parseMsgPackPayload(data);
+        
+        std::string alertId = request.value("alertId", "");
+        
+        if (alertId.empty()) {
+            nlohmann::json error = createErrorResponse("INVALID_PARAMS", "Missing required parameter: alertId");
+            std::string errorStr = error.dump();
+            std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+            auto serializedResponse = serializeResponse("alerts.price.cancel", errorData);
+            context.reply(serializedResponse);
+            return;
+        }
+        
+        // Unknown, already fired or foreign alerts report cancelled: false
+        bool cancelled = priceAlerts_.cancel(alertId, context.session().id());
+        
+        nlohmann::json response = {
+            {"alertId", alertId},
+            {"cancelled", cancelled},
+            {"message", cancelled ? "Price alert cancelled" : "Price alert not found"}
+        };
+        
+        std::string jsonStr = response.dump();
+        std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
+        auto serializedResponse = serializeResponse("alerts.price.cancel", responseData);
+        context.reply(serializedResponse);
+        
+    } catch (const std::exception& e) {
+        nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Price alert cancel failed: " + std::string(e.what()));
+        std::string errorStr = error.dump();
+        std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+        auto serializedResponse = serializeResponse("alerts.price.cancel", errorData);
+        context.reply(serializedResponse);
+    }
+}
+
+void AdvancedTradingServer::handleTraceDump(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api) {
+    try {
+        // Middleware already handled authentication
+        
+        // Read-only: recording is switched and cleared on the operator metrics port only
+        auto& recorder = trading::infrastructure::metrics::TraceRecorder::instance();
+        
+        nlohmann::json response = {
+            {"compiledIn", BULL_TRACING != 0},
+            {"enabled", recorder.enabled()},
+            {"trace", recorder.chromeTrace()}
+        };
+        
+        std::string jsonStr = response.dump();
+        std::vector<uint8_t> responseData(jsonStr.begin(), jsonStr.end());
+        auto serializedResponse = serializeResponse("trace.dump", responseData);
+        context.reply(serializedResponse);
+        
+    } catch (const std::exception& e) {
+        rpcErrors_["trace.dump"].increment();
+        nlohmann::json error = createErrorResponse("INTERNAL_ERROR", "Trace dump failed: " + std::string(e.what()));
+        std::string errorStr = error.dump();
+        std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+        auto serializedResponse = serializeResponse("trace.dump", errorData);
+        context.reply(serializedResponse);
+    }
+}
+
+void AdvancedTradingServer::requestTraceDump() noexcept {
+    traceDumpRequested_.store(true);
+}
+
+void AdvancedTradingServer::writeTraceDump() {
+    const char* dir = std::getenv("TRACE_DUMP_DIR");
+    auto stamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string path = std::string(dir && *dir ? dir : ".") + "/bull-trace-" + std::to_string(stamp) + ".json";
+    
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "[Trace] Cannot write trace dump to " << path << std::endl;
+        return;
+    }
+    file << trading::infrastructure::metrics::TraceRecorder::instance().chromeTrace().dump();
+    std::cout << "[Trace] Wrote Chrome trace to " << path << std::endl;
+}
+
 void AdvancedTradingServer::startMarketDataSimulation() {
-    std::cout << "[Market Data] Starting market data simulation thread..." << std::endl;
     running_ = true;
+    
+    // Tap the live pipeline into a capture file that BULL_TICK_REPLAY can play back later
+    if (const char* capturePath = std::getenv("BULL_TICK_CAPTURE"); capturePath && *capturePath) {
+        auto writer = std::make_shared<trading::infrastructure::marketdata::TickCaptureWriter>();
+        if (writer->open(capturePath)) {
+            tickCapture_ = writer;
+            marketDataFeed_ = std::make_unique<trading::infrastructure::marketdata::RecordingMarketDataFeed>(
+                std::move(writer), std::move(marketDataFeed_));
+            std::cout << "[Market Data] Recording ticks to " << capturePath << std::endl;
+        }
+    }
+    
+    // Local hot store of recent ticks, one mmapped journal directory per symbol
+    if (const char* journalPath = std::getenv("BULL_TICK_JOURNAL"); journalPath && *journalPath) {
+        trading::infrastructure::marketdata::TickJournalOptions journalOptions;
+        if (const char* retainDays = std::getenv("BULL_TICK_JOURNAL_RETAIN_DAYS"); retainDays && *retainDays) {
+            journalOptions.retainDays = static_cast<uint32_t>(std::strtoul(retainDays, nullptr, 10));
+        }
+        auto journal = std::make_shared<trading::infrastructure::marketdata::TickJournal>(journalPath, journalOptions);
+        if (journal->open()) {
+            std::atomic_store(&tickJournal_, std::move(journal));
+            std::cout << "[Market Data] Journaling ticks under " << journalPath << std::endl;
+            startTickLoader(std::string(journalPath) + "/loader.cursor");
+        }
+    }
+    
+    if (auto target = relayEndpointFromEnv("BULL_RELAY_PUBLISH")) {
+        tickRelay_ = trading::infrastructure::marketdata::openTickRelayPublisher(*target);
+        if (tickRelay_) {
+            std::cout << "[Market Data] Relaying ticks to " << target->describe() << std::endl;
+        }
+    }
+    
+    // An edge serves the publisher's ticks instead of producing its own
+    if (auto source = relayEndpointFromEnv("BULL_RELAY_SUBSCRIBE")) {
+        std::cout << "[Market Data] Starting relay edge thread..." << std::endl;
+        marketDataThread_ = std::thread([this, source = *source]() {
+            trading::infrastructure::metrics::TraceRecorder::instance().nameThread("market-data");
+            relayMarketData(source);
+        });
+        return;
+    }
+    
+    std::optional<ReplayConfig> replay = replayConfigFromEnv();
+    if (replay) {
+        std::cout << "[Market Data] Starting market data replay thread..." << std::endl;
+        marketDataThread_ = std::thread([this, config = *replay]() {
+            trading::infrastructure::metrics::TraceRecorder::instance().nameThread("market-data");
+            replayMarketData(config.path, config.options);
+        });
+        return;
+    }
+    
+    std::cout << "[Market Data] Starting market data simulation thread..." << std::endl;
     marketDataThread_ = std::thread([this]() {
         std::cout << "[Market Data] Market data thread started!" << std::endl;
+        trading::infrastructure::metrics::TraceRecorder::instance().nameThread("market-data");
         while (running_) {
         // std::cout << "[Market Data] Generating market data..." << std::endl;
         simulateMarketData();
@@ -2196,6 +2744,168 @@ void AdvancedTradingServer::stopMarketDataSimulation() {
     if (marketDataThread_.joinable()) {
         marketDataThread_.join();
     }
+    if (tickLoaderThread_.joinable()) {
+        tickLoaderThread_.join();
+    }
+    if (tickCapture_) {
+        tickCapture_->close();
+        std::cout << "[Market Data] Captured " << tickCapture_->recordCount() << " ticks" << std::endl;
+        tickCapture_.reset();
+    }
+    if (tickJournal_) {
+        tickJournal_->flush();
+        // Unmapped once the last history.query holding it returns
+        std::atomic_store(&tickJournal_, std::shared_ptr<trading::infrastructure::marketdata::TickJournal>());
+    }
+    tickRelay_.reset();
+}
+
+void AdvancedTradingServer::startTickLoader(const std::string& cursorPath) {
+    auto* clickhouseRepo = dynamic_cast<trading::infrastructure::database::ClickHouseHistoryRepository*>(historyRepository_.get());
+    if (!clickhouseRepo) {
+        return;
+    }
+    auto loader = std::make_unique<trading::infrastructure::marketdata::TickJournalLoader>(
+        *tickJournal_, cursorPath, [clickhouseRepo](const std::string& symbol, std::span<const trading::domain::Tick> ticks) {
+            std::vector<trading::infrastructure::database::TickRow> rows;
+            rows.reserve(ticks.size());
+            for (const auto& tick : ticks) {
+                rows.push_back({symbol, tick});
+            }
+            return clickhouseRepo->insertTicks(rows);
+        });
+    if (!loader->open()) {
+        std::cerr << "[Market Data] Cannot read " << cursorPath << ", journaled ticks are not loaded" << std::endl;
+        return;
+    }
+    // The thread owns the loader; the journal outlives it, as stopMarketDataSimulation joins it first
+    tickLoaderThread_ = std::thread([this, loader = std::move(loader)]() {
+        trading::infrastructure::metrics::TraceRecorder::instance().nameThread("tick-loader");
+        while (running_) {
+            if (startup_.reached(trading::infrastructure::metrics::StartupMilestone::SCHEMA_READY)) {
+                journalTicksLoaded_.add(static_cast<int64_t>(loader->loadOnce()));
+            }
+            for (auto waited = std::chrono::milliseconds(0); running_ && waited < kJournalLoadInterval; waited += kStartupRetryStep) {
+                std::this_thread::sleep_for(kStartupRetryStep);
+            }
+        }
+    });
+}
+
+void AdvancedTradingServer::startAlertEvaluator() {
+    std::cout << "[Alert Evaluator] Starting alert evaluator thread..." << std::endl;
+    alertEvaluation_.reset();
+    alertThread_ = std::thread([this]() {
+        std::cout << "[Alert Evaluator] Alert evaluator thread started!" << std::endl;
+        trading::infrastructure::metrics::TraceRecorder::instance().nameThread("alert-evaluator");
+        auto nextExpiryCheck = std::chrono::steady_clock::now();
+        while (running_) {
+            if (traceDumpRequested_.exchange(false)) {
+                writeTraceDump();
+            }
+            auto started = std::chrono::steady_clock::now();
+            if (started >= nextExpiryCheck) {
+                // Price alerts of sessions that did not resume within the TTL go with them
+                for (const auto& sessionId : connectionTracker_.expireSessions()) {
+                    priceAlerts_.cancelOwner(sessionId);
+                }
+                nextExpiryCheck = started + kSessionExpiryInterval;
+            }
+            checkAndBroadcastAlerts();
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            alertEvaluation_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            std::this_thread::sleep_for(kAlertEvaluationInterval);
+        }
+        std::cout << "[Alert Evaluator] Alert evaluator thread stopped." << std::endl;
+    });
+}
+
+void AdvancedTradingServer::stopAlertEvaluator() {
+    running_ = false;
+    if (alertThread_.joinable()) {
+        alertThread_.join();
+    }
+}
+
+void AdvancedTradingServer::startWarmup() {
+    std::cout << "[Startup] Starting warm-up thread..." << std::endl;
+    warmupThread_ = std::thread([this]() {
+        trading::infrastructure::metrics::TraceRecorder::instance().nameThread("warm-up");
+        warmUp();
+    });
+}
+
+void AdvancedTradingServer::stopWarmup() {
+    running_ = false;
+    if (warmupThread_.joinable()) {
+        warmupThread_.join();
+    }
+}
+
+void AdvancedTradingServer::warmUp() {
+    using trading::infrastructure::metrics::StartupMilestone;
+    auto* clickhouseRepo = dynamic_cast<trading::infrastructure::database::ClickHouseHistoryRepository*>(historyRepository_.get());
+    
+    // ClickHouse may come up after the server; the schema waits for it
+    while (clickhouseRepo && running_) {
+        if (clickhouseRepo->isConnected() || clickhouseRepo->reconnect()) {
+            std::cout << "[Startup] Creating ClickHouse tables..." << std::endl;
+            if (clickhouseRepo->createTables()) {
+                break;
+            }
+        }
+        std::cout << "[Startup] ClickHouse schema not ready, retrying in " << kStartupRetryInterval.count() << " ms" << std::endl;
+        for (auto waited = std::chrono::milliseconds(0); running_ && waited < kStartupRetryInterval; waited += kStartupRetryStep) {
+            std::this_thread::sleep_for(kStartupRetryStep);
+        }
+    }
+    if (!running_) {
+        return;
+    }
+    startup_.mark(StartupMilestone::SCHEMA_READY);
+    std::cout << "[Startup] Schema ready after " << startup_.elapsed(StartupMilestone::SCHEMA_READY)->count() << " ms" << std::endl;
+    
+    if (clickhouseRepo) {
+        try {
+            std::cout << "[Startup] Attempting mock data generation..." << std::endl;
+            bool mockDataGenerated = clickhouseRepo->generateMockData();
+            std::cout << "[Startup] Mock data generation result: " << (mockDataGenerated ? "SUCCESS" : "FAILED") << std::endl;
+        } catch (const std::exception& e) {
+            // History still serves whatever is already there
+            std::cerr << "[Startup] Mock data generation failed: " << e.what() << std::endl;
+        }
+    }
+    startup_.mark(StartupMilestone::BACKFILLED);
+    if (!running_) {
+        return;
+    }
+    
+    if (historyRepository_) {
+        // One symbol per read slot, so warm-up never queues behind itself
+        size_t parallelism = clickhouseRepo ? clickhouseRepo->maxReaders() : kKnownSymbols.size();
+        int64_t nowSeconds = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto warmup = trading::application::warmHistory(*historyRepository_, kKnownSymbols, nowSeconds, parallelism);
+        std::cout << "[Startup] Warmed " << warmup.symbolsWarmed << "/" << kKnownSymbols.size() << " symbols ("
+                  << warmup.candles << " candles, " << warmup.latestCandles << " latest) in " << warmup.took.count()
+                  << " ms" << std::endl;
+    }
+    startup_.mark(StartupMilestone::WARM);
+    std::cout << "[Startup] Ready after " << startup_.elapsed(StartupMilestone::WARM)->count() << " ms (listening after "
+              << startup_.elapsed(StartupMilestone::LISTENING).value_or(std::chrono::milliseconds(0)).count() << " ms)" << std::endl;
+}
+
+bool AdvancedTradingServer::replyIfWarmingUp(binaryrpc::RpcContext& context, const std::string& method) {
+    if (startup_.reached(trading::infrastructure::metrics::StartupMilestone::SCHEMA_READY)) {
+        return false;
+    }
+    // Reads against missing tables would only fail and count against the ClickHouse breaker
+    nlohmann::json error = createErrorResponse("WARMING_UP", "History is not available yet, the server is still starting up");
+    std::string errorStr = error.dump();
+    std::vector<uint8_t> errorData(errorStr.begin(), errorStr.end());
+    auto serializedResponse = serializeResponse(method, errorData);
+    context.reply(serializedResponse);
+    return true;
 }
 
 void AdvancedTradingServer::simulateMarketData() {
@@ -2205,8 +2915,6 @@ void AdvancedTradingServer::simulateMarketData() {
         const double basePrices[] = {2500.0, 45000.0, 0.45, 95.0, 0.08, 25.0, 0.75, 12.5};
         const int numSymbols = 8;
         
-        static int32_t globalSequence = 0; // Global sequence counter for all market data
-        
         for (int i = 0; i < numSymbols; ++i) {
             try {
                 // Validate symbol string before using
@@ -2215,82 +2923,63 @@ void AdvancedTradingServer::simulateMarketData() {
                     continue;
                 }
                 
-                // Random price calculation with realistic volatility
-                static std::random_device rd;
-                static std::mt19937 gen(rd());
-                
-                // Different volatility ranges for different price ranges
-                double volatility;
-                if (i == 1) volatility = 0.002;      // BTC-USD (0.2% volatility)
-                else if (i == 0) volatility = 0.003;  // ETH-USD (0.3% volatility)
-                else if (i == 4) volatility = 0.005; // DOGE-USD (0.5% volatility - higher volatility for meme coin)
-                else if (i == 5) volatility = 0.004;  // AVAX-USD (0.4% volatility)
-                else if (i == 6) volatility = 0.005;  // MATIC-USD (0.5% volatility)
-                else if (i == 7) volatility = 0.003;   // LINK-USD (0.3% volatility)
-                else volatility = 0.004;              // ADA-USD, SOL-USD (0.4% volatility)
-                
-                // Generate random percentage change (-volatility to +volatility)
-                std::uniform_real_distribution<double> dist(-volatility, volatility);
-                double randomChange = dist(gen);
-                
-                // Apply random change to base price
-                double price = basePrices[i] * (1.0 + randomChange);
-                
-                // Ensure price is finite and reasonable
-                if (!std::isfinite(price) || price <= 0) {
-                    price = basePrices[i];
-                }
-                
-                // Calculate change percentage from base price
-                double changePercent = ((price - basePrices[i]) / basePrices[i]) * 100.0;
-                
-                // Random volume based on symbol popularity and price movement
-                int baseVolume;
-                int volumeVariation;
-                if (i == 1) { baseVolume = 50000; volumeVariation = 20000; }      // BTC-USD
-                else if (i == 0) { baseVolume = 30000; volumeVariation = 15000; }  // ETH-USD
-                else if (i == 4) { baseVolume = 80000; volumeVariation = 30000; }  // DOGE-USD (high volume)
-                else if (i == 5) { baseVolume = 15000; volumeVariation = 8000; }  // AVAX-USD
-                else if (i == 6) { baseVolume = 25000; volumeVariation = 12000; }  // MATIC-USD
-                else if (i == 7) { baseVolume = 20000; volumeVariation = 10000; }  // LINK-USD
-                else { baseVolume = 10000; volumeVariation = 5000; }              // ADA-USD, SOL-USD
-                
-                // Generate random volume variation
-                std::uniform_int_distribution<int> volumeDist(-volumeVariation, volumeVariation);
-                int volume = baseVolume + volumeDist(gen);
-                
-                // Ensure volume is positive
-                if (volume < 1000) volume = 1000;
-                
-                // Create JSON with explicit symbol validation
-                const std::string& symbol = symbols[i];
-                nlohmann::json tickData;
-                
-                try {
-                    // Increment global sequence for each tick
-                    globalSequence++;
+                double price;
+                double changePercent;
+                int volume;
+                {
+                    TRACE_SPAN("market.tick.generate");
                     
-                    tickData = nlohmann::json::object();
-                    tickData["symbol"] = symbol;
-                    tickData["price"] = price;
-                    tickData["change"] = changePercent;
-                    tickData["volume"] = volume;
-                    tickData["seq"] = globalSequence; // Sequence number for ordering
-                    tickData["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::system_clock::now().time_since_epoch()).count();
-                        
-                    // Validate JSON was created properly
-                    if (!tickData.contains("symbol") || tickData["symbol"].empty()) {
-                        std::cerr << "[Market Data] Invalid symbol in JSON for index " << i << std::endl;
-                        continue;
+                    // Random price calculation with realistic volatility
+                    static std::random_device rd;
+                    static std::mt19937 gen(rd());
+                    
+                    // Different volatility ranges for different price ranges
+                    double volatility;
+                    if (i == 1) volatility = 0.002;      // BTC-USD (0.2% volatility)
+                    else if (i == 0) volatility = 0.003;  // ETH-USD (0.3% volatility)
+                    else if (i == 4) volatility = 0.005; // DOGE-USD (0.5% volatility - higher volatility for meme coin)
+                    else if (i == 5) volatility = 0.004;  // AVAX-USD (0.4% volatility)
+                    else if (i == 6) volatility = 0.005;  // MATIC-USD (0.5% volatility)
+                    else if (i == 7) volatility = 0.003;   // LINK-USD (0.3% volatility)
+                    else volatility = 0.004;              // ADA-USD, SOL-USD (0.4% volatility)
+                    
+                    // Generate random percentage change (-volatility to +volatility)
+                    std::uniform_real_distribution<double> dist(-volatility, volatility);
+                    double randomChange = dist(gen);
+                    
+                    // Apply random change to base price
+                    price = basePrices[i] * (1.0 + randomChange);
+                    
+                    // Ensure price is finite and reasonable
+                    if (!std::isfinite(price) || price <= 0) {
+                        price = basePrices[i];
                     }
                     
-                } catch (const std::exception& jsonError) {
-                    std::cerr << "[Market Data] JSON creation error for index " << i << ": " << jsonError.what() << std::endl;
-                    continue;
+                    // Calculate change percentage from base price
+                    changePercent = ((price - basePrices[i]) / basePrices[i]) * 100.0;
+                    
+                    // Random volume based on symbol popularity and price movement
+                    int baseVolume;
+                    int volumeVariation;
+                    if (i == 1) { baseVolume = 50000; volumeVariation = 20000; }      // BTC-USD
+                    else if (i == 0) { baseVolume = 30000; volumeVariation = 15000; }  // ETH-USD
+                    else if (i == 4) { baseVolume = 80000; volumeVariation = 30000; }  // DOGE-USD (high volume)
+                    else if (i == 5) { baseVolume = 15000; volumeVariation = 8000; }  // AVAX-USD
+                    else if (i == 6) { baseVolume = 25000; volumeVariation = 12000; }  // MATIC-USD
+                    else if (i == 7) { baseVolume = 20000; volumeVariation = 10000; }  // LINK-USD
+                    else { baseVolume = 10000; volumeVariation = 5000; }              // ADA-USD, SOL-USD
+                    
+                    // Generate random volume variation
+                    std::uniform_int_distribution<int> volumeDist(-volumeVariation, volumeVariation);
+                    volume = baseVolume + volumeDist(gen);
+                    
+                    // Ensure volume is positive
+                    if (volume < 1000) volume = 1000;
                 }
                 
-                broadcastMarketData(symbol, tickData);
+                auto tickTs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                processTick(symbols[i], trading::domain::Tick(tickTs, price, price, price, static_cast<uint64_t>(volume)), changePercent);
                 
             } catch (const std::exception& e) {
                 std::cerr << "[Market Data] Error processing symbol at index " << i << ": " << e.what() << std::endl;
@@ -2301,6 +2990,125 @@ void AdvancedTradingServer::simulateMarketData() {
     }
 }
 
+void AdvancedTradingServer::replayMarketData(const std::string& path, const trading::infrastructure::marketdata::ReplayOptions& options) {
+    trading::infrastructure::marketdata::TickCaptureReader capture;
+    if (!capture.open(path)) {
+        std::cerr << "[Market Data] Cannot replay " << path << ": " << capture.error() << std::endl;
+        return;
+    }
+    std::cout << "[Market Data] Replaying " << capture.size() << " ticks (" << capture.symbols().size() << " symbols) from "
+              << path << " at " << (options.speed > 0.0 ? std::to_string(options.speed) + "x" : std::string("max speed"))
+              << (options.loop ? ", looping" : "") << std::endl;
+    
+    // Recorded ticks carry no reference price; change is measured from the first replayed price per symbol
+    std::unordered_map<std::string, double> openPrices;
+    trading::infrastructure::marketdata::TickReplayer replayer(capture, options);
+    auto stats = replayer.run([&](const std::string& symbol, const trading::domain::Tick& tick) {
+        try {
+            double open = openPrices.try_emplace(symbol, tick.last).first->second;
+            double changePercent = open > 0.0 ? (tick.last - open) / open * 100.0 : 0.0;
+            processTick(symbol, tick, changePercent);
+        } catch (const std::exception& e) {
+            std::cerr << "[Market Data] Error replaying tick for " << symbol << ": " << e.what() << std::endl;
+        }
+    }, running_);
+    
+    std::cout << "[Market Data] Replay finished: " << stats.ticks << " ticks in " << stats.passes << " pass(es), "
+              << toMs(stats.elapsed) << "ms (" << static_cast<uint64_t>(stats.ticksPerSecond()) << " ticks/s, max lag "
+              << toMs(stats.maxLag) << "ms";
+    if (stats.skipped > 0) {
+        std::cout << ", " << stats.skipped << " malformed records skipped";
+    }
+    std::cout << ")" << std::endl;
+}
+
+void AdvancedTradingServer::relayMarketData(const trading::infrastructure::marketdata::RelayEndpoint& source) {
+    // The publisher may come up after its edges
+    std::unique_ptr<trading::infrastructure::marketdata::TickRelaySubscriber> subscriber;
+    while (running_ && !(subscriber = trading::infrastructure::marketdata::openTickRelaySubscriber(source))) {
+        std::cout << "[Market Data] Relay " << source.describe() << " not available, retrying in "
+                  << kStartupRetryInterval.count() << " ms" << std::endl;
+        for (auto waited = std::chrono::milliseconds(0); running_ && waited < kStartupRetryInterval; waited += kStartupRetryStep) {
+            std::this_thread::sleep_for(kStartupRetryStep);
+        }
+    }
+    if (!subscriber) {
+        return;
+    }
+    std::cout << "[Market Data] Following relay " << source.describe() << std::endl;
+    
+    std::vector<trading::infrastructure::marketdata::RelayTick> batch;
+    uint64_t lostReported = 0;
+    while (running_) {
+        batch.clear();
+        if (subscriber->poll(batch, kRelayPollWait) == 0) {
+            continue;
+        }
+        for (const auto& relayTick : batch) {
+            try {
+                deliverTick(relayTick.symbolName(), relayTick.tick, relayTick.changePercent, relayTick.seq);
+            } catch (const std::exception& e) {
+                std::cerr << "[Market Data] Error delivering relayed tick " << relayTick.seq << ": " << e.what() << std::endl;
+            }
+        }
+        relayTicksReceived_.add(static_cast<int64_t>(batch.size()));
+        uint64_t lost = subscriber->stats().lost;
+        if (lost > lostReported) {
+            std::cerr << "[Market Data] Relay lost " << lost - lostReported << " ticks" << std::endl;
+            relayTicksLost_.add(static_cast<int64_t>(lost - lostReported));
+            lostReported = lost;
+        }
+    }
+    auto stats = subscriber->stats();
+    std::cout << "[Market Data] Relay edge stopped after " << stats.ticks << " ticks (" << stats.lost << " lost)" << std::endl;
+}
+
+void AdvancedTradingServer::processTick(const std::string& symbol, const trading::domain::Tick& tick, double changePercent) {
+    // Sequence number for ordering across all symbols
+    ++tickSequence_;
+    deliverTick(symbol, tick, changePercent, tickSequence_);
+}
+
+void AdvancedTradingServer::deliverTick(const std::string& symbol, const trading::domain::Tick& tick, double changePercent, uint64_t seq) {
+    TRACE_STAGE(stage, "market.tick.publish");
+    // Edges broadcast the same seq, so every node shows the same order
+    if (tickRelay_) {
+        if (tickRelay_->publish(trading::infrastructure::marketdata::RelayTick::make(seq, symbol, tick, changePercent))) {
+            relayTicksPublished_.increment();
+        } else {
+            relayPublishFailures_.increment();
+        }
+    }
+    if (marketDataFeed_) {
+        marketDataFeed_->publishTick(trading::domain::Symbol(symbol), tick);
+    }
+    if (tickJournal_) {
+        tickJournal_->append(symbol, tick);
+        if (tick.ts - lastJournalPruneTs_ >= kJournalPruneIntervalMs) {
+            tickJournal_->prune(tick.ts);
+            lastJournalPruneTs_ = tick.ts;
+        }
+    }
+    
+    nlohmann::json tickData = nlohmann::json::object();
+    tickData["symbol"] = symbol;
+    tickData["price"] = tick.last;
+    tickData["change"] = changePercent;
+    tickData["volume"] = tick.volume;
+    tickData["seq"] = seq;
+    tickData["timestamp"] = tick.ts;
+    
+    TRACE_STAGE_NEXT(stage, "market.tick.broadcast");
+    broadcastMarketData(symbol, tickData);
+    
+    // Price alerts are checked against every tick before the next one
+    TRACE_STAGE_NEXT(stage, "market.tick.price_alerts");
+    auto firedAlerts = priceAlerts_.onTick(symbol, tick.ts, tick.last);
+    if (!firedAlerts.empty()) {
+        deliverPriceAlerts(firedAlerts);
+    }
+}
+
 void AdvancedTradingServer::broadcastMarketData(const std::string& symbol, const nlohmann::json& data) {
     // Validate symbol string first
     if (symbol.empty()) {
@@ -2321,6 +3129,7 @@ void AdvancedTradingServer::broadcastMarketData(const std::string& symbol, const
             return;
         }
         
+        TRACE_STAGE(stage, "broadcast.encode");
         std::string jsonStr = data.dump();
         
         if (jsonStr.empty()) {
@@ -2331,7 +3140,9 @@ void AdvancedTradingServer::broadcastMarketData(const std::string& symbol, const
         std::vector<uint8_t> dataBytes(jsonStr.begin(), jsonStr.end());
         std::vector<uint8_t> serializedData = app_->getProtocol()->serialize("market_data", dataBytes);
         
+        TRACE_STAGE_NEXT(stage, "broadcast.send");
         roomPlugin_->broadcast(roomName, serializedData);
+        connectionTracker_.onSent(roomPlugin_->getRoomMembers(roomName), serializedData.size());
         
     } catch (const std::exception& e) {
         std::cerr << "[Broadcast] Error broadcasting " << symbol << ": " << e.what() << std::endl;
@@ -2359,6 +3170,7 @@ void AdvancedTradingServer::broadcastAlerts(const nlohmann::json& alertData) {
         std::vector<uint8_t> serializedData = app_->getProtocol()->serialize("alerts.push", dataBytes);
         
         roomPlugin_->broadcast(alertsRoom, serializedData);
+        connectionTracker_.onSent(roomPlugin_->getRoomMembers(alertsRoom), serializedData.size());
         std::cout << "[Alert Broadcast] Alert broadcasted to room: " << alertsRoom << std::endl;
         
     } catch (const std::exception& e) {
@@ -2368,120 +3180,226 @@ void AdvancedTradingServer::broadcastAlerts(const nlohmann::json& alertData) {
     }
 }
 
-void AdvancedTradingServer::checkAndBroadcastAlerts() {
-    try {
-        // Get current metrics for alert evaluation
-        auto now = std::chrono::steady_clock::now();
-        auto uptimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime_).count();
-        auto uptimeSeconds = uptimeMs / 1000.0;
-        
-        int totalOrders = totalOrdersPlaced_.load();
-        int totalCancels = totalOrdersCancelled_.load();
-        int totalErrs = totalErrors_.load();
-        
-        // Use same mock metrics as handleMetricsGet for consistency
-        double realThroughput = (uptimeSeconds > 0) ? (totalOrders / uptimeSeconds) : 0.0;
-        double throughput = realThroughput + (std::rand() % 100) / 10.0;
-        
-        int totalOperations = totalOrders + totalCancels;
-        double errorRate = (totalOperations > 0) ? (static_cast<double>(totalErrs) / totalOperations) : 0.0;
-        
-        double baseLatency = 0.5 + (errorRate * 25.0);
-        double randomVariation = (std::rand() % 200) / 100.0;
-        double latencyMs = baseLatency + randomVariation;
-        if (latencyMs < 0.5) latencyMs = 0.5;
-        if (latencyMs > 50.0) latencyMs = 50.0;
-        
-        int realConnCount = activeConnections_.load();
-        int connCount = realConnCount + (std::rand() % 500) + 50;
-        
-        // Check if any alerts should be triggered
-        bool hasAlerts = false;
-        nlohmann::json alerts = nlohmann::json::object();
-        
-        // High latency alert
-        if (latencyMs > 100.0) {
-            hasAlerts = true;
-            alerts["high_latency"] = {
-                {"status", "alert"},
-                {"current", latencyMs},
-                {"threshold", 100.0},
-                {"message", "High latency detected: " + std::to_string(static_cast<int>(latencyMs)) + "ms"}
-            };
-        }
-        
-        // Error rate alert
-        if (errorRate > 0.01) {
-            hasAlerts = true;
-            alerts["error_rate"] = {
-                {"status", "alert"},
-                {"current", errorRate},
-                {"threshold", 0.01},
-                {"message", "High error rate: " + std::to_string(errorRate * 100) + "%"}
+void AdvancedTradingServer::deliverPriceAlerts(const std::vector<trading::domain::PriceAlertEvent>& events) {
+    if (!app_) {
+        return;
+    }
+    
+    auto& api = app_->getFrameworkApi();
+    for (const auto& event : events) {
+        try {
+            bool isMove = event.kind == trading::domain::PriceAlertKind::MOVE_UP ||
+                          event.kind == trading::domain::PriceAlertKind::MOVE_DOWN;
+            nlohmann::json alertData = {
+                {"type", "price_alert"},
+                {"alertId", event.alertId},
+                {"symbol", event.symbol},
+                {"kind", trading::application::PriceAlertIndex::kindName(event.kind)},
+                {isMove ? "movePercent" : "level", event.trigger},
+                {"price", event.price},
+                {"ts", event.ts}
             };
+            if (isMove) {
+                alertData["observedMovePercent"] = event.movePercent;
+            }
+            
+            std::string jsonStr = alertData.dump();
+            std::vector<uint8_t> dataBytes(jsonStr.begin(), jsonStr.end());
+            std::vector<uint8_t> serializedData = app_->getProtocol()->serialize("alerts.price", dataBytes);
+            
+            priceAlertsFired_.increment();
+            if (api.sendTo(event.ownerId, serializedData)) {
+                connectionTracker_.onSent(event.ownerId, serializedData.size());
+            } else {
+                std::cout << "[Price Alert] Session " << event.ownerId << " not connected, dropped alert " << event.alertId << std::endl;
+            }
+            
+        } catch (const std::exception& e) {
+            std::cerr << "[Price Alert] Error delivering " << event.alertId << ": " << e.what() << std::endl;
         }
+    }
+}
+
+void AdvancedTradingServer::checkAndBroadcastAlerts() {
+    if (!alertingService_) {
+        return;
+    }
+    
+    try {
+        // Edge-triggered: only rules that start firing or resolve are broadcast
+        auto currentMetrics = snapshotMetrics();
+        auto transitions = alertingService_->evaluateTransitions(currentMetrics);
+        alertsSuppressed_.add(static_cast<int64_t>(transitions.suppressed));
         
-        // Connection count alert
-        if (connCount > 1000) {
-            hasAlerts = true;
-            alerts["connection_count"] = {
-                {"status", "alert"},
-                {"current", connCount},
-                {"threshold", 1000},
-                {"message", "High connection count: " + std::to_string(connCount)}
-            };
+        if (transitions.events.empty()) {
+            return;
         }
         
-        // High throughput alert
-        double highThroughputThreshold = 2.0; // 2 orders/sec threshold
-        if (throughput > highThroughputThreshold) {
-            hasAlerts = true;
-            alerts["high_throughput"] = {
-                {"status", "alert"},
-                {"current", throughput},
-                {"threshold", highThroughputThreshold},
-                {"message", "High throughput detected: " + std::to_string(throughput) + " orders/sec"}
+        nlohmann::json alerts = nlohmann::json::object();
+        for (const auto& event : transitions.events) {
+            bool firing = event.state == trading::domain::AlertState::FIRING;
+            alerts[event.ruleId] = {
+                {"status", firing ? "alert" : "resolved"},
+                {"ruleId", event.ruleId},
+                {"current", event.value},
+                {"message", event.message},
+                {"timestamp", event.ts}
             };
         }
         
-        // Check custom alert rules
-        trading::domain::Metrics currentMetrics(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count(),
-            latencyMs, throughput, errorRate, connCount
-        );
-        
-        auto customAlertEvents = evaluateAlertRules(currentMetrics);
-        if (!customAlertEvents.empty()) {
-            hasAlerts = true;
-            for (const auto& event : customAlertEvents) {
-                alerts["custom_rule_" + event.ruleId] = {
-                    {"status", "alert"},
-                    {"ruleId", event.ruleId},
-                    {"current", event.value},
-                    {"message", event.message},
-                    {"timestamp", event.ts}
-                };
-            }
-        }
-        
-        // Broadcast if any alerts are active (built-in or custom)
-        if (hasAlerts) {
-            nlohmann::json broadcastData = {
-                {"type", "metrics_alert"},
-                {"alerts", alerts},
-                {"timestamp", std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::system_clock::now().time_since_epoch()).count()},
-                {"message", "System metrics triggered alerts"}
-            };
-            broadcastAlerts(broadcastData);
-        }
+        nlohmann::json broadcastData = {
+            {"type", "metrics_alert"},
+            {"alerts", alerts},
+            {"timestamp", currentMetrics.ts},
+            {"message", "Alert state changed"}
+        };
+        broadcastAlerts(broadcastData);
         
     } catch (const std::exception& e) {
         std::cerr << "[Check Alerts] Error checking and broadcasting alerts: " << e.what() << std::endl;
     }
 }
 
+void AdvancedTradingServer::renderMetrics(trading::infrastructure::metrics::OpenMetricsWriter& out) {
+    using trading::infrastructure::metrics::Labels;
+    using trading::infrastructure::metrics::LatencyHistogram;
+    
+    out.family("uptime_seconds", "gauge", "Seconds since the server started");
+    out.sample("uptime_seconds", {},
+               std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count());
+    
+    // Registry counters are named *_total; the family name drops the suffix
+    std::string_view currentFamily;
+    metricsRegistry_.visit([&](const std::string& name, const Labels& labels, int64_t value) {
+        std::string_view family = name;
+        bool isCounter = family.size() > 6 && family.substr(family.size() - 6) == "_total";
+        if (isCounter) {
+            family.remove_suffix(6);
+        }
+        if (family != currentFamily) {
+            out.family(family, isCounter ? "counter" : "unknown", "");
+            currentFamily = family;
+        }
+        out.sample(name, labels, value);
+    });
+    
+    if (auto* collector = dynamic_cast<trading::infrastructure::metrics::MetricsCollector*>(metricsCollector_.get())) {
+        out.family("rpc_service_seconds", "histogram", "RPC handler time excluding serialization");
+        collector->visitHistograms([&](const std::string& method, const LatencyHistogram& service,
+                                       const LatencyHistogram&, const LatencyHistogram&) {
+            out.latencyHistogram("rpc_service_seconds", {{"method", method}}, service);
+        });
+        out.family("rpc_queue_seconds", "histogram", "Time from frame receipt to handler dispatch");
+        collector->visitHistograms([&](const std::string& method, const LatencyHistogram&,
+                                       const LatencyHistogram& queue, const LatencyHistogram&) {
+            out.latencyHistogram("rpc_queue_seconds", {{"method", method}}, queue);
+        });
+        out.family("rpc_serialize_seconds", "histogram", "Response serialization time");
+        collector->visitHistograms([&](const std::string& method, const LatencyHistogram&,
+                                       const LatencyHistogram&, const LatencyHistogram& serialize) {
+            out.latencyHistogram("rpc_serialize_seconds", {{"method", method}}, serialize);
+        });
+    }
+    
+    out.family("alert_evaluation_seconds", "histogram", "Duration of one alert evaluator pass");
+    out.latencyHistogram("alert_evaluation_seconds", {}, alertEvaluation_);
+    
+    auto connections = connectionTracker_.snapshot(false);
+    out.family("open_sockets", "gauge", "Connected WebSocket sockets");
+    out.sample("open_sockets", {}, connections.openSockets);
+    out.family("authenticated_sessions", "gauge", "Sessions that completed hello");
+    out.sample("authenticated_sessions", {}, connections.authenticatedSessions);
+    out.family("detached_sessions", "gauge", "Disconnected sessions still resumable");
+    out.sample("detached_sessions", {}, connections.detachedSessions);
+    out.family("connects", "counter", "");
+    out.sample("connects_total", {}, connections.connectsTotal);
+    out.family("disconnects", "counter", "");
+    out.sample("disconnects_total", {}, connections.disconnectsTotal);
+    out.family("session_resumes", "counter", "");
+    out.sample("session_resumes_total", {}, connections.resumesTotal);
+    out.family("sessions_expired", "counter", "");
+    out.sample("sessions_expired_total", {}, connections.expiredTotal);
+    out.family("detached_frames_sent", "gauge", "Frames sent to sessions since they detached");
+    out.sample("detached_frames_sent", {}, connections.detachedFrames);
+    out.family("detached_bytes_sent", "gauge", "Bytes sent to sessions since they detached");
+    out.sample("detached_bytes_sent", {}, connections.detachedBytes);
+    out.family("sessions_with_detached_sends", "gauge", "Detached sessions sent frames since they detached");
+    out.sample("sessions_with_detached_sends", {}, connections.sessionsWithDetachedSends);
+    out.family("session_max_detached_frames_sent", "gauge", "Most frames sent to a single session since it detached");
+    out.sample("session_max_detached_frames_sent", {}, connections.maxSessionDetachedFrames);
+    out.family("session_max_detached_bytes_sent", "gauge", "Most bytes sent to a single session since it detached");
+    out.sample("session_max_detached_bytes_sent", {}, connections.maxSessionDetachedBytes);
+    
+    if (roomPlugin_) {
+        out.family("room_subscribers", "gauge", "Sessions joined to a broadcast room");
+        for (const auto& symbol : kKnownSymbols) {
+            std::string room = getMarketDataRoom(symbol);
+            out.sample("room_subscribers", {{"room", room}}, static_cast<uint64_t>(roomPlugin_->getRoomMembers(room).size()));
+        }
+        std::string alertsRoom = getAlertsRoom();
+        out.sample("room_subscribers", {{"room", alertsRoom}}, static_cast<uint64_t>(roomPlugin_->getRoomMembers(alertsRoom).size()));
+    }
+    
+    out.family("price_alerts_active", "gauge", "Registered price alerts that have not fired");
+    out.sample("price_alerts_active", {}, static_cast<uint64_t>(priceAlerts_.size()));
+    
+    if (auto* cache = dynamic_cast<trading::infrastructure::cache::IdempotencyCache*>(idempotencyCache_.get())) {
+        out.family("idempotency_cache_entries", "gauge", "Cached order responses");
+        out.sample("idempotency_cache_entries", {}, static_cast<uint64_t>(cache->size()));
+        out.family("idempotency_cache_lookups", "counter", "Idempotency key lookups by outcome");
+        out.sample("idempotency_cache_lookups_total", {{"result", "hit"}}, cache->hits());
+        out.sample("idempotency_cache_lookups_total", {{"result", "miss"}}, cache->misses());
+    }
+    
+    out.family("startup_milestone_seconds", "gauge", "Time from process start to each startup milestone reached");
+    for (auto milestone : {trading::infrastructure::metrics::StartupMilestone::LISTENING,
+                           trading::infrastructure::metrics::StartupMilestone::FIRST_CONNECTION,
+                           trading::infrastructure::metrics::StartupMilestone::SCHEMA_READY,
+                           trading::infrastructure::metrics::StartupMilestone::BACKFILLED,
+                           trading::infrastructure::metrics::StartupMilestone::WARM}) {
+        if (auto elapsed = startup_.elapsed(milestone)) {
+            std::string name(trading::infrastructure::metrics::startupMilestoneName(milestone));
+            out.sample("startup_milestone_seconds", {{"milestone", name}}, std::chrono::duration<double>(*elapsed).count());
+        }
+    }
+    out.family("ready", "gauge", "1 once schema, mock data and history warm-up have finished");
+    out.sample("ready", {}, static_cast<uint64_t>(startup_.ready()));
+    
+    if (auto* clickhouse = dynamic_cast<trading::infrastructure::database::ClickHouseHistoryRepository*>(historyRepository_.get())) {
+        out.family("clickhouse_write_queue_depth", "gauge", "Order log rows waiting for the writer thread");
+        out.sample("clickhouse_write_queue_depth", {}, static_cast<uint64_t>(clickhouse->pendingWrites()));
+        out.family("clickhouse_writes", "counter", "Order log writes by outcome");
+        out.sample("clickhouse_writes_total", {{"result", "ok"}}, clickhouse->writesOk());
+        out.sample("clickhouse_writes_total", {{"result", "error"}}, clickhouse->writesFailed());
+        out.sample("clickhouse_writes_total", {{"result", "skipped"}}, clickhouse->writesSkipped());
+        out.sample("clickhouse_writes_total", {{"result", "dropped"}}, clickhouse->writesDropped());
+        out.family("clickhouse_write_retries", "counter", "Order log rows requeued after a failed insert");
+        out.sample("clickhouse_write_retries_total", {}, clickhouse->writesRetried());
+        out.family("clickhouse_http_body_bytes", "counter", "ClickHouse HTTP body bytes on the wire, after compression");
+        out.sample("clickhouse_http_body_bytes_total", {{"direction", "sent"}}, clickhouse->bytesSent());
+        out.sample("clickhouse_http_body_bytes_total", {{"direction", "received"}}, clickhouse->bytesReceived());
+        out.family("clickhouse_reads_in_flight", "gauge", "History reads holding one of the read slots");
+        out.sample("clickhouse_reads_in_flight", {}, static_cast<uint64_t>(clickhouse->readsInFlight()));
+        out.family("clickhouse_read_slots", "gauge", "Concurrent history reads allowed (CLICKHOUSE_MAX_READERS)");
+        out.sample("clickhouse_read_slots", {}, static_cast<uint64_t>(clickhouse->maxReaders()));
+        out.family("clickhouse_read_waits", "counter", "History reads that waited for a free read slot");
+        out.sample("clickhouse_read_waits_total", {}, clickhouse->readWaits());
+        using trading::infrastructure::database::CircuitBreaker;
+        out.family("clickhouse_circuit_state", "gauge", "1 for the state the ClickHouse read breaker is in");
+        for (auto state : {CircuitBreaker::State::CLOSED, CircuitBreaker::State::OPEN, CircuitBreaker::State::HALF_OPEN}) {
+            std::string name(trading::infrastructure::database::circuitStateName(state));
+            out.sample("clickhouse_circuit_state", {{"state", name}}, static_cast<uint64_t>(clickhouse->circuitState() == state));
+        }
+        out.family("clickhouse_circuit_opened", "counter", "Times the ClickHouse read breaker opened");
+        out.sample("clickhouse_circuit_opened_total", {}, clickhouse->circuitOpened());
+        out.family("clickhouse_reads_degraded", "counter", "History reads not answered by ClickHouse, by cause");
+        out.sample("clickhouse_reads_degraded_total", {{"reason", "rejected"}}, clickhouse->readsRejected());
+        out.sample("clickhouse_reads_degraded_total", {{"reason", "failed"}}, clickhouse->readsFailed());
+        out.family("clickhouse_stale_reads", "counter", "Degraded history reads answered from the last cached result");
+        out.sample("clickhouse_stale_reads_total", {}, clickhouse->staleReads());
+    }
+}
+
 // Utility methods
 bool AdvancedTradingServer::validateSession(binaryrpc::RpcContext& context, const std::string& requiredRole) {
     auto authenticated = getSessionData(context, "authenticated");
@@ -2542,6 +3460,42 @@ nlohmann::json AdvancedTradingServer::createSuccessResponse(const nlohmann::json
     };
 }
 
+std::vector<uint8_t> AdvancedTradingServer::serializeResponse(const std::string& method, const std::vector<uint8_t>& payload) {
+    auto started = std::chrono::steady_clock::now();
+    auto serialized = app_->getProtocol()->serialize(method, payload);
+    tlsRequestTiming.serialize += std::chrono::steady_clock::now() - started;
+    if (tlsRequestTiming.sessionId) {
+        connectionTracker_.onSent(*tlsRequestTiming.sessionId, serialized.size());
+    }
+    return serialized;
+}
+
+trading::domain::Metrics AdvancedTradingServer::snapshotMetrics() {
+    int64_t totalOrders = metricsRegistry_.total("orders_placed_total");
+    int64_t totalCancels = ordersCancelled_.value();
+    int64_t totalErrs = metricsRegistry_.total("rpc_errors_total");
+    
+    // Throughput over the last 10 complete seconds rather than the lifetime average
+    auto windowed = windowedMetrics_.snapshot();
+    double throughput = windowed["orders.rate_10s"];
+    int64_t totalOperations = totalOrders + totalCancels;
+    double errorRate = (totalOperations > 0) ? (static_cast<double>(totalErrs) / totalOperations) : 0.0;
+    
+    trading::domain::LatencyStats latency;
+    if (metricsCollector_) {
+        latency = metricsCollector_->collect().latency;
+    }
+    
+    trading::domain::Metrics metrics(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count(),
+        latency.meanMs, throughput, errorRate, static_cast<int32_t>(connectionTracker_.openSockets())
+    );
+    metrics.latency = latency;
+    metrics.windowed = std::move(windowed);
+    return metrics;
+}
+
 
 std::optional<std::string> AdvancedTradingServer::getSessionData(binaryrpc::RpcContext& context, const std::string& key) {
     std::cout << "[getSessionData] Starting getSessionData call for key: " << key << std::endl;
@@ -2646,73 +3600,27 @@ void AdvancedTradingServer::updateRateLimit(binaryrpc::Session& session, const s
 
 // Alert rule management
 void AdvancedTradingServer::registerAlertRule(const trading::domain::AlertRule& rule) {
-    std::lock_guard<std::mutex> lock(alertRulesMutex_);
-    alertRules_[rule.ruleId] = rule;
+    if (!alertingService_) {
+        throw std::runtime_error("Alerting service not available");
+    }
+    alertingService_->registerRule(rule);
     std::cout << "[AlertRule] Registered rule: " << rule.ruleId 
               << " for metric: " << rule.metricKey 
               << " with threshold: " << rule.threshold << std::endl;
 }
 
 void AdvancedTradingServer::disableAlertRule(const std::string& ruleId) {
-    std::lock_guard<std::mutex> lock(alertRulesMutex_);
-    auto it = alertRules_.find(ruleId);
-    if (it != alertRules_.end()) {
-        it->second.enabled = false;
+    if (alertingService_) {
+        alertingService_->disableRule(ruleId);
         std::cout << "[AlertRule] Disabled rule: " << ruleId << std::endl;
     }
 }
 
 std::vector<trading::domain::AlertEvent> AdvancedTradingServer::evaluateAlertRules(const trading::domain::Metrics& metrics) {
-    std::vector<trading::domain::AlertEvent> events;
-    std::lock_guard<std::mutex> lock(alertRulesMutex_);
-    
-    for (const auto& [ruleId, rule] : alertRules_) {
-        if (!rule.enabled) continue;
-        
-        double currentValue = 0.0;
-        std::string valueName;
-        
-        // Get current metric value
-        if (rule.metricKey == "latencyMs") {
-            currentValue = metrics.latencyMs;
-            valueName = "latency";
-        } else if (rule.metricKey == "throughput") {
-            currentValue = metrics.throughput;
-            valueName = "throughput";
-        } else if (rule.metricKey == "errorRate") {
-            currentValue = metrics.errorRate;
-            valueName = "error rate";
-        } else if (rule.metricKey == "connCount") {
-            currentValue = static_cast<double>(metrics.connCount);
-            valueName = "connection count";
-        } else {
-            continue; // Unknown metric
-        }
-        
-        // Evaluate condition
-        bool triggered = false;
-        if (rule.operator_ == ">") {
-            triggered = currentValue > rule.threshold;
-        } else if (rule.operator_ == ">=") {
-            triggered = currentValue >= rule.threshold;
-        } else if (rule.operator_ == "<") {
-            triggered = currentValue < rule.threshold;
-        } else if (rule.operator_ == "<=") {
-            triggered = currentValue <= rule.threshold;
-        } else if (rule.operator_ == "==") {
-            triggered = currentValue == rule.threshold;
-        }
-        
-        if (triggered) {
-            std::string eventId = ruleId + "_" + std::to_string(metrics.ts);
-            std::string message = valueName + " " + rule.operator_ + " " + std::to_string(rule.threshold) 
-                                + " (current: " + std::to_string(currentValue) + ")";
-            
-            events.emplace_back(eventId, ruleId, metrics.ts, currentValue, message);
-        }
+    if (!alertingService_) {
+        return {};
     }
-    
-    return events;
+    return alertingService_->evaluate(metrics);
 }
 
 
@@ -1,6 +1,19 @@
 #pragma once
 
 #include "../domain/interfaces.hpp"
+#include "../application/price_alert_index.hpp"
+#include "../infrastructure/metrics/metrics_registry.hpp"
+#include "../infrastructure/metrics/connection_tracker.hpp"
+#include "../infrastructure/metrics/latency_histogram.hpp"
+#include "../infrastructure/metrics/windowed_metrics.hpp"
+#include "../infrastructure/metrics/trace_recorder.hpp"
+#include "../infrastructure/metrics/startup_tracker.hpp"
+#include "../infrastructure/marketdata/tick_capture.hpp"
+#include "../infrastructure/marketdata/tick_replayer.hpp"
+#include "../infrastructure/marketdata/tick_journal.hpp"
+#include "../infrastructure/marketdata/tick_journal_loader.hpp"
+#include "../infrastructure/marketdata/tick_relay.hpp"
+#include "metrics_http_server.hpp"
 #include <binaryrpc/core/app.hpp>
 #include <binaryrpc/core/session/session.hpp>
 #include <binaryrpc/transports/websocket/websocket_transport.hpp>
@@ -38,21 +51,60 @@ private:
     int port_;
     std::string jwtSecret_;
     
-    // Market data simulation
+    // Market data simulation (or replay of a tick capture)
     std::thread marketDataThread_;
     std::atomic<bool> running_;
-    
-    // Metrics tracking
-    std::atomic<int> totalOrdersPlaced_;
-    std::atomic<int> totalOrdersCancelled_;
-    std::atomic<int> totalErrors_;
-    std::atomic<int> activeConnections_;
+    uint64_t tickSequence_ = 0;  // Market data thread only
+    std::shared_ptr<trading::infrastructure::marketdata::TickCaptureWriter> tickCapture_;
+    // history.query copies it with std::atomic_load and reads spans through
+    // the copy, so stop() never unmaps segments under a running query
+    std::shared_ptr<trading::infrastructure::marketdata::TickJournal> tickJournal_;
+    int64_t lastJournalPruneTs_ = 0;  // Market data thread only
+    // Batches journaled ticks into the ClickHouse ticks table
+    std::thread tickLoaderThread_;
+    // Relay tier: every tick goes on to edge servers through a shared-memory
+    // ring or a multicast group; an edge follows a relay instead of simulating
+    std::unique_ptr<trading::infrastructure::marketdata::TickRelayPublisher> tickRelay_;
+    
+    // Periodic alert evaluation, timed per pass
+    std::thread alertThread_;
+    trading::infrastructure::metrics::LatencyHistogram alertEvaluation_;
+    
+    // Metrics tracking (per-thread sharded 64-bit counters, aggregated on read)
+    trading::infrastructure::metrics::MetricsRegistry metricsRegistry_;
+    trading::infrastructure::metrics::CounterFamily ordersPlaced_;    // by symbol
+    trading::infrastructure::metrics::ShardedCounter& ordersCancelled_;
+    trading::infrastructure::metrics::CounterFamily ordersRejected_;  // by reject reason
+    trading::infrastructure::metrics::CounterFamily rpcErrors_;       // by RPC method
+    trading::infrastructure::metrics::ShardedCounter& alertsSuppressed_;
+    trading::infrastructure::metrics::ShardedCounter& relayTicksPublished_;
+    trading::infrastructure::metrics::ShardedCounter& relayPublishFailures_;
+    trading::infrastructure::metrics::ShardedCounter& relayTicksReceived_;
+    trading::infrastructure::metrics::ShardedCounter& relayTicksLost_;
+    trading::infrastructure::metrics::ShardedCounter& journalTicksLoaded_;
+    
+    // Open sockets, authenticated/resumed sessions and per-session send accounting
+    trading::infrastructure::metrics::ConnectionTracker connectionTracker_;
+    
+    // 1s/10s/60s rates, EWMA and windowed percentiles per RPC method and event series
+    trading::infrastructure::metrics::WindowedMetrics windowedMetrics_;
+    
+    // Per-session price alerts, evaluated inline on every simulated tick
+    trading::application::PriceAlertIndex priceAlerts_;
+    trading::infrastructure::metrics::ShardedCounter& priceAlertsFired_;
+    std::atomic<uint64_t> nextPriceAlertId_{1};
     std::chrono::steady_clock::time_point startTime_;
     
-    // Alert rules storage
-    std::unordered_map<std::string, trading::domain::AlertRule> alertRules_;
-    std::mutex alertRulesMutex_;
+    // Prometheus scrape endpoint on its own port, started with the server
+    std::unique_ptr<MetricsHttpServer> metricsHttpServer_;
+    
+    // Staged startup: the listener comes up first; schema creation, mock data
+    // and history warm-up follow on the warm-up thread
+    trading::infrastructure::metrics::StartupTracker startup_;
+    std::thread warmupThread_;
     
+    // Set from a signal handler; the alert evaluator thread writes the dump
+    std::atomic<bool> traceDumpRequested_{false};
     
 public:
     AdvancedTradingServer(const std::string& host = "0.0.0.0", 
@@ -66,6 +118,9 @@ public:
     void start();
     void stop();
     
+    // Async-signal-safe: asks for the recent trace spans to be written to a file
+    void requestTraceDump() noexcept;
+    
     // Dependency injection
     // setAuthInspector removed - using inline JWT verification instead
     void setIdempotencyCache(std::unique_ptr<trading::domain::IIdempotencyCache> cache);
@@ -107,14 +162,41 @@ private:
     void handleAlertsList(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api);
     void handleAlertsRegister(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api);
     void handleAlertsDisable(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api);
+    void handleAlertsPriceRegister(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api);
+    void handleAlertsPriceCancel(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api);
+    void handleTraceDump(const std::vector<uint8_t>& data, binaryrpc::RpcContext& context, binaryrpc::FrameworkAPI& api);
     
     // Market Data Simulation
     void startMarketDataSimulation();
     void stopMarketDataSimulation();
     void simulateMarketData();
+    void replayMarketData(const std::string& path, const trading::infrastructure::marketdata::ReplayOptions& options);
+    void relayMarketData(const trading::infrastructure::marketdata::RelayEndpoint& source);
+    // Numbers a locally produced tick, then delivers it
+    void processTick(const std::string& symbol, const trading::domain::Tick& tick, double changePercent);
+    void deliverTick(const std::string& symbol, const trading::domain::Tick& tick, double changePercent, uint64_t seq);
     void broadcastMarketData(const std::string& symbol, const nlohmann::json& data);
     void broadcastAlerts(const nlohmann::json& alertData);
+    void deliverPriceAlerts(const std::vector<trading::domain::PriceAlertEvent>& events);
+    
+    // Background startup once the listener is up
+    void startWarmup();
+    void stopWarmup();
+    void warmUp();
+    // Replies WARMING_UP and returns true while the ClickHouse schema is not ready
+    bool replyIfWarmingUp(binaryrpc::RpcContext& context, const std::string& method);
+    
+    // Loads the journal into ClickHouse, resuming at the cursor in cursorPath
+    void startTickLoader(const std::string& cursorPath);
+    
+    // Alert evaluation off the order path
+    void startAlertEvaluator();
+    void stopAlertEvaluator();
     void checkAndBroadcastAlerts();
+    void writeTraceDump();
+    
+    // OpenMetrics exposition for GET /metrics
+    void renderMetrics(trading::infrastructure::metrics::OpenMetricsWriter& out);
     
     // Alert rule management
     void registerAlertRule(const trading::domain::AlertRule& rule);
@@ -134,6 +216,12 @@ private:
     nlohmann::json createErrorResponse(const std::string& code, const std::string& message);
     nlohmann::json createSuccessResponse(const nlohmann::json& data = nlohmann::json::object());
     
+    // Serializes a reply and accounts the time to the current request's serialize stage
+    std::vector<uint8_t> serializeResponse(const std::string& method, const std::vector<uint8_t>& payload);
+    
+    // Order/error counters combined with latency histograms from the metrics collector
+    trading::domain::Metrics snapshotMetrics();
+    
     
     // Session state management
     std::optional<std::string> getSessionData(binaryrpc::RpcContext& context, const std::string& key);
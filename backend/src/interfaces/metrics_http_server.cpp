@@ -0,0 +1,234 @@
+#include "metrics_http_server.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace trading::interfaces {
+
+namespace {
+
+constexpr int kAcceptPollMs = 250;       // How quickly stop() is noticed
+constexpr size_t kMaxRequestBytes = 8192;
+constexpr size_t kMaxConnections = 32;
+// Whole request and response, however slowly the client trickles bytes
+constexpr auto kRequestDeadline = std::chrono::seconds(2);
+constexpr std::string_view kOpenMetricsContentType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+} // namespace
+
+MetricsHttpServer::MetricsHttpServer(std::string host, int port, std::string prefix, Renderer renderer, Readiness ready)
+    : host_(std::move(host)), port_(port), renderer_(std::move(renderer)), ready_(std::move(ready)), writer_(std::move(prefix)) {
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    stop();
+}
+
+void MetricsHttpServer::addCommand(std::string path, Command command) {
+    commands_[std::move(path)] = std::move(command);
+}
+
+bool MetricsHttpServer::start() {
+    if (running_) {
+        return true;
+    }
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        std::cerr << "[Metrics HTTP] socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (::inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) != 1) {
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd_, 16) < 0) {
+        std::cerr << "[Metrics HTTP] Cannot listen on " << host_ << ":" << port_ << ": " << std::strerror(errno) << std::endl;
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    socklen_t length = sizeof(addr);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+
+    running_ = true;
+    thread_ = std::thread(&MetricsHttpServer::serveLoop, this);
+    std::cout << "[Metrics HTTP] Serving /metrics and /ready on " << host_ << ":" << port_ << std::endl;
+    return true;
+}
+
+void MetricsHttpServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    ::close(listenFd_);
+    listenFd_ = -1;
+}
+
+void MetricsHttpServer::serveLoop() {
+    // Slot 0 is the listener; the rest are clients in connections_ order
+    std::vector<pollfd> fds;
+    while (running_) {
+        fds.clear();
+        bool accepting = connections_.size() < kMaxConnections;
+        fds.push_back(pollfd{listenFd_, static_cast<short>(accepting ? POLLIN : 0), 0});
+        for (const auto& connection : connections_) {
+            fds.push_back(pollfd{connection.fd, static_cast<short>(connection.response.empty() ? POLLIN : POLLOUT), 0});
+        }
+
+        int ready = ::poll(fds.data(), fds.size(), kAcceptPollMs);
+        auto now = std::chrono::steady_clock::now();
+
+        for (size_t i = connections_.size(); i-- > 0;) {
+            auto& connection = connections_[i];
+            short events = fds[i + 1].revents;
+            bool done = now >= connection.deadline;
+            if (!done && ready > 0 && events != 0) {
+                try {
+                    done = connection.response.empty() ? readRequest(connection) : writeResponse(connection);
+                } catch (const std::exception& e) {
+                    std::cerr << "[Metrics HTTP] Error serving scrape: " << e.what() << std::endl;
+                    done = true;
+                }
+            }
+            if (done) {
+                ::close(connection.fd);
+                connections_[i] = std::move(connections_.back());
+                connections_.pop_back();
+            }
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd >= 0) {
+                Connection connection;
+                connection.fd = fd;
+                connection.deadline = now + kRequestDeadline;
+                connections_.push_back(std::move(connection));
+            }
+        }
+    }
+
+    for (const auto& connection : connections_) {
+        ::close(connection.fd);
+    }
+    connections_.clear();
+}
+
+bool MetricsHttpServer::readRequest(Connection& connection) {
+    char buffer[2048];
+    while (connection.request.size() < kMaxRequestBytes) {
+        size_t room = std::min(sizeof(buffer), kMaxRequestBytes - connection.request.size());
+        ssize_t n = ::recv(connection.fd, buffer, room, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return false;  // Wait for more, within the request deadline
+        }
+        if (n <= 0) {
+            return true;
+        }
+        connection.request.append(buffer, static_cast<size_t>(n));
+        if (connection.request.find("\r\n\r\n") != std::string::npos) {
+            break;
+        }
+    }
+
+    // Headers complete, or the request hit the size limit; answer from what arrived
+    handleRequest(connection);
+    return writeResponse(connection);
+}
+
+bool MetricsHttpServer::writeResponse(Connection& connection) {
+    while (connection.sent < connection.response.size()) {
+        ssize_t n = ::send(connection.fd, connection.response.data() + connection.sent,
+                           connection.response.size() - connection.sent, MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return false;
+        }
+        if (n <= 0) {
+            return true;
+        }
+        connection.sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void MetricsHttpServer::handleRequest(Connection& connection) {
+    // Only the request line matters
+    std::string_view text(connection.request);
+    std::string_view line = text.substr(0, text.find("\r\n"));
+    size_t methodEnd = line.find(' ');
+    size_t pathEnd = methodEnd == std::string_view::npos ? methodEnd : line.find(' ', methodEnd + 1);
+    if (pathEnd == std::string_view::npos) {
+        setResponse(connection, "400 Bad Request", "text/plain", "Bad Request\n");
+        return;
+    }
+
+    std::string_view method = line.substr(0, methodEnd);
+    std::string_view path = line.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+    path = path.substr(0, path.find('?'));
+
+    auto command = commands_.find(std::string(path));
+    if (command != commands_.end()) {
+        if (method != "POST") {
+            setResponse(connection, "405 Method Not Allowed", "text/plain", "Method Not Allowed\n");
+        } else {
+            setResponse(connection, "200 OK", "text/plain", command->second());
+        }
+        return;
+    }
+
+    if (path != "/metrics" && path != "/ready") {
+        setResponse(connection, "404 Not Found", "text/plain", "Not Found\n");
+        return;
+    }
+    if (method != "GET") {
+        setResponse(connection, "405 Method Not Allowed", "text/plain", "Method Not Allowed\n");
+        return;
+    }
+    if (path == "/ready") {
+        if (!ready_ || ready_()) {
+            setResponse(connection, "200 OK", "text/plain", "ready\n");
+        } else {
+            setResponse(connection, "503 Service Unavailable", "text/plain", "warming up\n");
+        }
+        return;
+    }
+
+    writer_.clear();
+    renderer_(writer_);
+    setResponse(connection, "200 OK", kOpenMetricsContentType, writer_.finish());
+}
+
+void MetricsHttpServer::setResponse(Connection& connection, const char* status, std::string_view contentType,
+                                    std::string_view body) {
+    auto& response = connection.response;
+    response.reserve(128 + body.size());
+    response += "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += contentType;
+    response += "\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+}
+
+} // namespace trading::interfaces
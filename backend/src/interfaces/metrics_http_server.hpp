@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../infrastructure/metrics/openmetrics_writer.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace trading::interfaces {
+
+// Minimal HTTP/1.1 listener for Prometheus scrapes, separate from the WebSocket
+// transport. A single background thread serves GET /metrics and GET /ready and
+// closes every connection after the response; the exposition buffer is reused
+// across scrapes. Sockets are non-blocking and multiplexed with poll(), and each
+// connection gets one overall deadline, so a slow client cannot hold up others.
+class MetricsHttpServer {
+public:
+    using Renderer = std::function<void(trading::infrastructure::metrics::OpenMetricsWriter&)>;
+    using Readiness = std::function<bool()>;
+    // Operator action behind POST <path>; returns the plain-text response body
+    using Command = std::function<std::string()>;
+
+    // Port 0 binds an ephemeral port, see port(). The prefix namespaces every metric name.
+    // GET /ready answers 200 once `ready` returns true and 503 until then; always 200
+    // without a readiness check.
+    MetricsHttpServer(std::string host, int port, std::string prefix, Renderer renderer, Readiness ready = nullptr);
+    ~MetricsHttpServer();
+
+    MetricsHttpServer(const MetricsHttpServer&) = delete;
+    MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+    // Commands are only reachable on this (operator) port. Register them before start().
+    void addCommand(std::string path, Command command);
+
+    // Returns false when the listening socket cannot be set up
+    bool start();
+    void stop();
+
+    int port() const { return port_; }
+
+private:
+    std::string host_;
+    int port_;
+    Renderer renderer_;
+    Readiness ready_;
+    std::unordered_map<std::string, Command> commands_;
+    struct Connection {
+        int fd = -1;
+        std::string request;
+        std::string response;  // Empty while the request is still being read
+        size_t sent = 0;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    trading::infrastructure::metrics::OpenMetricsWriter writer_;
+    int listenFd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::vector<Connection> connections_;  // Serve thread only
+
+    void serveLoop();
+    // Return true once the connection is finished and can be closed
+    bool readRequest(Connection& connection);
+    bool writeResponse(Connection& connection);
+    void handleRequest(Connection& connection);
+    void setResponse(Connection& connection, const char* status, std::string_view contentType, std::string_view body);
+};
+
+} // namespace trading::interfaces
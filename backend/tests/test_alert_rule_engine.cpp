@@ -0,0 +1,272 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include "application/alert_rule_engine.hpp"
+#include "domain/types.hpp"
+
+using namespace trading::application;
+using namespace trading::domain;
+
+namespace {
+
+std::vector<std::string> triggeredIds(const std::vector<AlertEvent>& events) {
+    std::vector<std::string> ids;
+    for (const auto& event : events) {
+        ids.push_back(event.ruleId);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// The string-matching loop the engine replaces, kept as the reference result
+std::vector<AlertEvent> linearEvaluate(const std::unordered_map<std::string, AlertRule>& rules, const Metrics& metrics) {
+    std::vector<AlertEvent> events;
+    for (const auto& [ruleId, rule] : rules) {
+        if (!rule.enabled) continue;
+        double value = 0.0;
+        if (rule.metricKey == "latencyMs") value = metrics.latencyMs;
+        else if (rule.metricKey == "throughput") value = metrics.throughput;
+        else if (rule.metricKey == "errorRate") value = metrics.errorRate;
+        else if (rule.metricKey == "connCount") value = static_cast<double>(metrics.connCount);
+        else continue;
+
+        bool triggered = false;
+        if (rule.operator_ == ">") triggered = value > rule.threshold;
+        else if (rule.operator_ == ">=") triggered = value >= rule.threshold;
+        else if (rule.operator_ == "<") triggered = value < rule.threshold;
+        else if (rule.operator_ == "<=") triggered = value <= rule.threshold;
+        else if (rule.operator_ == "==") triggered = value == rule.threshold;
+
+        if (triggered) {
+            events.emplace_back(ruleId + "_" + std::to_string(metrics.ts), ruleId, metrics.ts, value,
+                                rule.metricKey + " " + rule.operator_ + " " + std::to_string(rule.threshold));
+        }
+    }
+    return events;
+}
+
+} // namespace
+
+TEST_CASE("AlertRuleEngine - Rule Compilation", "[alerts]") {
+    SECTION("Known metrics and operators compile") {
+        auto compiled = AlertRuleEngine().compile(AlertRule("r1", "latencyMs", ">=", 100.0, true));
+        REQUIRE(compiled.metricId == static_cast<uint32_t>(AlertMetric::LATENCY_MS));
+        REQUIRE(compiled.comparator == AlertComparator::GREATER_EQUAL);
+        REQUIRE_THAT(compiled.description, Catch::Matchers::StartsWith("latency >= 100"));
+    }
+
+    SECTION("Unknown metric or operator is rejected") {
+        AlertRuleEngine engine;
+        REQUIRE_THROWS_AS(engine.registerRule(AlertRule("r1", "cpu", ">", 1.0, true)), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine.registerRule(AlertRule("r2", "latencyMs", "!=", 1.0, true)), std::invalid_argument);
+        REQUIRE(engine.ruleCount() == 0);
+    }
+}
+
+TEST_CASE("AlertRuleEngine - Evaluation", "[alerts]") {
+    AlertRuleEngine engine;
+    engine.registerRule(AlertRule("gt", "latencyMs", ">", 100.0, true));
+    engine.registerRule(AlertRule("ge", "latencyMs", ">=", 100.0, true));
+    engine.registerRule(AlertRule("lt", "latencyMs", "<", 100.0, true));
+    engine.registerRule(AlertRule("le", "latencyMs", "<=", 100.0, true));
+    engine.registerRule(AlertRule("eq", "latencyMs", "==", 100.0, true));
+
+    SECTION("Comparators select the right side of the threshold") {
+        REQUIRE(triggeredIds(engine.evaluateMetric(AlertMetric::LATENCY_MS, 150.0, 1)) ==
+                std::vector<std::string>{"ge", "gt"});
+        REQUIRE(triggeredIds(engine.evaluateMetric(AlertMetric::LATENCY_MS, 100.0, 1)) ==
+                std::vector<std::string>{"eq", "ge", "le"});
+        REQUIRE(triggeredIds(engine.evaluateMetric(AlertMetric::LATENCY_MS, 50.0, 1)) ==
+                std::vector<std::string>{"le", "lt"});
+    }
+
+    SECTION("Rules only see their own metric") {
+        Metrics metrics(42, 10.0, 500.0, 0.0, 0);
+        REQUIRE(triggeredIds(engine.evaluate(metrics)) == std::vector<std::string>{"le", "lt"});
+        engine.registerRule(AlertRule("tp", "throughput", ">", 100.0, true));
+        auto events = engine.evaluate(metrics);
+        REQUIRE(triggeredIds(events) == std::vector<std::string>{"le", "lt", "tp"});
+        REQUIRE(events.back().eventId == "tp_42");
+        REQUIRE(events.back().value == 500.0);
+    }
+
+    SECTION("Disabled and replaced rules are reindexed") {
+        engine.disableRule("gt");
+        engine.registerRule(AlertRule("ge", "latencyMs", ">=", 200.0, true));
+        REQUIRE(triggeredIds(engine.evaluateMetric(AlertMetric::LATENCY_MS, 150.0, 1)).empty());
+        REQUIRE(engine.ruleCount() == 5);
+    }
+}
+
+TEST_CASE("AlertRuleEngine - Matches linear evaluation", "[alerts]") {
+    const std::vector<std::string> keys = {"latencyMs", "throughput", "errorRate", "connCount"};
+    const std::vector<std::string> ops = {">", ">=", "<", "<=", "=="};
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> thresholdDist(0, 50);
+    AlertRuleEngine engine;
+    std::unordered_map<std::string, AlertRule> rules;
+    for (int i = 0; i < 2000; ++i) {
+        AlertRule rule("rule-" + std::to_string(i), keys[i % keys.size()], ops[(i / keys.size()) % ops.size()],
+                       static_cast<double>(thresholdDist(rng)), i % 7 != 0);
+        engine.registerRule(rule);
+        rules[rule.ruleId] = rule;
+    }
+
+    for (int sample = 0; sample < 20; ++sample) {
+        Metrics metrics(sample, thresholdDist(rng), thresholdDist(rng), thresholdDist(rng), thresholdDist(rng));
+        REQUIRE(triggeredIds(engine.evaluate(metrics)) == triggeredIds(linearEvaluate(rules, metrics)));
+    }
+}
+
+TEST_CASE("AlertRuleEngine - Edge-Triggered Transitions", "[alerts]") {
+    AlertRuleEngine engine(0.0, std::chrono::milliseconds(0));
+
+    AlertRule latency("latency", "latencyMs", ">", 100.0, true);
+    latency.hysteresis = 10.0;
+    latency.cooldownMs = 1000;
+    engine.registerRule(latency);
+
+    auto at = [](int64_t ts, double latencyMs) { return Metrics(ts, latencyMs, 0.0, 0.0, 0); };
+
+    SECTION("Fires once and stays quiet while firing") {
+        auto fired = engine.evaluateTransitions(at(0, 150.0));
+        REQUIRE(fired.events.size() == 1);
+        REQUIRE(fired.events[0].state == AlertState::FIRING);
+        REQUIRE(fired.suppressed == 0);
+
+        // Staying triggered is not a transition, so nothing counts as suppressed
+        auto steady = engine.evaluateTransitions(at(100, 160.0));
+        REQUIRE(steady.events.empty());
+        REQUIRE(steady.suppressed == 0);
+        REQUIRE(engine.firingCount() == 1);
+    }
+
+    SECTION("Resolves only outside the hysteresis band") {
+        engine.evaluateTransitions(at(0, 150.0));
+
+        auto inBand = engine.evaluateTransitions(at(100, 95.0));
+        REQUIRE(inBand.events.empty());
+        REQUIRE(inBand.suppressed == 1);
+        REQUIRE(engine.firingCount() == 1);
+        // The same held-back resolve is counted once
+        REQUIRE(engine.evaluateTransitions(at(150, 96.0)).suppressed == 0);
+
+        auto resolved = engine.evaluateTransitions(at(200, 85.0));
+        REQUIRE(resolved.events.size() == 1);
+        REQUIRE(resolved.events[0].state == AlertState::RESOLVED);
+        REQUIRE_THAT(resolved.events[0].message, Catch::Matchers::StartsWith("resolved: "));
+        REQUIRE(engine.firingCount() == 0);
+    }
+
+    SECTION("Re-firing within the cooldown is suppressed, including its resolve") {
+        engine.evaluateTransitions(at(0, 150.0));
+        engine.evaluateTransitions(at(100, 50.0));
+
+        auto refire = engine.evaluateTransitions(at(500, 150.0));
+        REQUIRE(refire.events.empty());
+        REQUIRE(refire.suppressed == 1);
+
+        auto quietResolve = engine.evaluateTransitions(at(600, 50.0));
+        REQUIRE(quietResolve.events.empty());
+        REQUIRE(quietResolve.suppressed == 1);
+
+        auto afterCooldown = engine.evaluateTransitions(at(1500, 150.0));
+        REQUIRE(afterCooldown.events.size() == 1);
+        REQUIRE(afterCooldown.events[0].state == AlertState::FIRING);
+    }
+
+    SECTION("Disabling a firing rule resolves it once") {
+        engine.evaluateTransitions(at(0, 150.0));
+        engine.disableRule("latency");
+        REQUIRE(engine.firingCount() == 0);
+        auto resolved = engine.evaluateTransitions(at(100, 150.0));
+        REQUIRE(resolved.events.size() == 1);
+        REQUIRE(resolved.events[0].state == AlertState::RESOLVED);
+        REQUIRE(resolved.events[0].value == 150.0);
+        REQUIRE(engine.evaluateTransitions(at(200, 150.0)).events.empty());
+    }
+
+    SECTION("Default hysteresis is relative to the threshold") {
+        AlertRuleEngine defaults(0.1, std::chrono::milliseconds(0));
+        defaults.registerRule(AlertRule("tp", "throughput", "<", 50.0, true));
+
+        REQUIRE(defaults.evaluateTransitions(Metrics(0, 0.0, 40.0, 0.0, 0)).events.size() == 1);
+        REQUIRE(defaults.evaluateTransitions(Metrics(1, 0.0, 54.0, 0.0, 0)).events.empty());
+        REQUIRE(defaults.evaluateTransitions(Metrics(2, 0.0, 56.0, 0.0, 0)).events.size() == 1);
+    }
+}
+
+TEST_CASE("AlertRuleEngine - Windowed Metric Keys", "[alerts]") {
+    AlertRuleEngine engine({"orders.place", "history.query"}, {"orders", "orders.rejected"},
+                           0.0, std::chrono::milliseconds(0));
+
+    SECTION("Only known window stats are accepted") {
+        engine.registerRule(AlertRule("p99", "orders.place.p99_10s", ">", 5.0, true));
+        engine.registerRule(AlertRule("rate", "orders.rate_1s", ">=", 100.0, true));
+        REQUIRE_THROWS_AS(engine.registerRule(AlertRule("bad", "orders.place.p42_10s", ">", 1.0, true)),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(engine.registerRule(AlertRule("bad", ".p99_10s", ">", 1.0, true)), std::invalid_argument);
+        REQUIRE(engine.ruleCount() == 2);
+        REQUIRE_THAT(engine.compile(AlertRule("p99", "orders.place.p99_10s", ">", 5.0, true)).description,
+                     Catch::Matchers::StartsWith("orders.place.p99_10s > 5"));
+    }
+
+    SECTION("Only registered series are accepted") {
+        REQUIRE(engine.isWindowedMetricKey("orders.rejected.rate_10s"));
+        REQUIRE_FALSE(engine.isWindowedMetricKey("orders.typo.p99_10s"));
+        REQUIRE_FALSE(engine.isWindowedMetricKey("cpu.rate_1s"));
+        // Event series count occurrences and have no latency stats
+        REQUIRE_FALSE(engine.isWindowedMetricKey("orders.p99_10s"));
+        REQUIRE_THROWS_AS(engine.registerRule(AlertRule("typo", "orders.typo.p99_10s", ">", 1.0, true)),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(AlertRuleEngine().registerRule(AlertRule("p99", "orders.place.p99_10s", ">", 1.0, true)),
+                          std::invalid_argument);
+        REQUIRE(engine.ruleCount() == 0);
+    }
+
+    SECTION("Duration units belong to latency metrics only") {
+        REQUIRE(AlertRuleEngine::isLatencyMetricKey("latencyMs"));
+        REQUIRE(AlertRuleEngine::isLatencyMetricKey("orders.place.p99_10s"));
+        REQUIRE(AlertRuleEngine::isLatencyMetricKey("history.query.mean_10s"));
+        REQUIRE_FALSE(AlertRuleEngine::isLatencyMetricKey("throughput"));
+        REQUIRE_FALSE(AlertRuleEngine::isLatencyMetricKey("errorRate"));
+        REQUIRE_FALSE(AlertRuleEngine::isLatencyMetricKey("orders.place.rate_1s"));
+    }
+
+    SECTION("Windowed values trigger alongside built-in metrics") {
+        engine.registerRule(AlertRule("p99", "orders.place.p99_10s", ">", 5.0, true));
+        engine.registerRule(AlertRule("latency", "latencyMs", ">", 100.0, true));
+
+        Metrics metrics(0, 150.0, 0.0, 0.0, 0);
+        metrics.windowed = {{"orders.place.p99_10s", 7.5}, {"orders.place.p50_10s", 9.0}};
+        auto fired = engine.evaluateTransitions(metrics);
+        REQUIRE(triggeredIds(fired.events) == std::vector<std::string>{"latency", "p99"});
+    }
+
+    SECTION("A missing windowed value leaves the rule as it was") {
+        engine.registerRule(AlertRule("low_rate", "orders.rate_10s", "<", 1.0, true));
+
+        Metrics metrics(0, 0.0, 0.0, 0.0, 0);
+        metrics.windowed = {{"orders.rate_10s", 0.5}};
+        REQUIRE(engine.evaluateTransitions(metrics).events.size() == 1);
+
+        metrics.ts = 100;
+        metrics.windowed.clear();
+        auto missing = engine.evaluateTransitions(metrics);
+        REQUIRE(missing.events.empty());
+        REQUIRE(missing.suppressed == 0);
+        REQUIRE(engine.firingCount() == 1);
+
+        metrics.ts = 200;
+        metrics.windowed = {{"orders.rate_10s", 3.0}};
+        auto resolved = engine.evaluateTransitions(metrics);
+        REQUIRE(resolved.events.size() == 1);
+        REQUIRE(resolved.events[0].state == AlertState::RESOLVED);
+    }
+}
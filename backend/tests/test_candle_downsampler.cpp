@@ -0,0 +1,88 @@
+#include <catch2/catch_test_macros.hpp>
+#include <span>
+#include <vector>
+#include "application/candle_downsampler.hpp"
+
+using namespace trading::application;
+using trading::domain::Candle;
+using trading::domain::Interval;
+using trading::domain::Tick;
+
+namespace {
+
+constexpr int64_t kDay = 86400;
+constexpr int64_t kStart = 1'718'000'000 / kDay * kDay;
+
+Candle minuteCandle(int64_t openTime, double open, double high, double low, double close, uint64_t volume) {
+    return Candle(openTime, open, high, low, close, volume, Interval::M1);
+}
+
+} // namespace
+
+TEST_CASE("Downsampling picks the smallest bucket that fits the point budget", "[downsample]") {
+    // Six months of M1 candles into 1000 points: 6h buckets, as 1080 4h buckets would not fit
+    REQUIRE(downsampleBucketSeconds(kStart - 180 * kDay, kStart - 1, Interval::M1, 1000) == 6 * 3600);
+    REQUIRE(downsampleBucketSeconds(kStart - 180 * kDay, kStart - 1, Interval::M1, 1080) == 4 * 3600);
+    REQUIRE(downsampleBucketSeconds(kStart - 180 * kDay, kStart - 1, Interval::M1, 4320) == 3600);
+
+    // Already within budget, or no budget: the interval's own width
+    REQUIRE(downsampleBucketSeconds(kStart, kStart + 3599, Interval::M1, 60) == 60);
+    REQUIRE(downsampleBucketSeconds(kStart - 180 * kDay, kStart, Interval::M1, 0) == 60);
+
+    // Buckets stay multiples of the interval; long ranges go to whole weeks
+    REQUIRE(downsampleBucketSeconds(kStart, kStart + 2 * kDay - 1, Interval::M15, 100) == 1800);
+    REQUIRE(downsampleBucketSeconds(kStart, kStart + 5 * kDay - 1, Interval::D1, 2) == 7 * kDay);
+    int64_t wide = downsampleBucketSeconds(kStart - 3650 * kDay, kStart, Interval::D1, 50);
+    REQUIRE(wide % (7 * kDay) == 0);
+    REQUIRE((kStart / wide) - ((kStart - 3650 * kDay) / wide) + 1 <= 50);
+}
+
+TEST_CASE("Downsampling merges candles into OHLCV buckets, newest first", "[downsample]") {
+    std::vector<Candle> candles = {
+        minuteCandle(kStart + 300, 103, 104, 102, 103.5, 4),
+        minuteCandle(kStart, 100, 101, 99, 100.5, 1),
+        minuteCandle(kStart + 60, 100.5, 110, 100, 101, 2),  // Spike survives in the high
+        minuteCandle(kStart + 240, 102, 103, 90, 102.5, 3),  // And the dip in the low
+        minuteCandle(kStart + 600, 104, 105, 103, 104.5, 5),
+    };
+
+    auto merged = downsampleCandles(candles, 300);
+    REQUIRE(merged.size() == 3);
+    REQUIRE(merged[0].openTime == kStart + 600);
+    REQUIRE(merged[1].openTime == kStart + 300);
+    REQUIRE(merged[2].openTime == kStart);
+    REQUIRE(merged[2].open == 100);
+    REQUIRE(merged[2].close == 102.5);
+    REQUIRE(merged[2].high == 110);
+    REQUIRE(merged[2].low == 90);
+    REQUIRE(merged[2].volume == 6);
+
+    // Aligned candles pass through unchanged
+    auto again = downsampleCandles(merged, 300);
+    REQUIRE(again.size() == 3);
+    REQUIRE(again[2].close == 102.5);
+    REQUIRE(again[2].volume == 6);
+    REQUIRE(downsampleCandles(candles, 0).size() == candles.size());
+}
+
+TEST_CASE("Ticks build second candles, newest first", "[downsample]") {
+    int64_t ms = kStart * 1000;
+    std::vector<Tick> first = {Tick(ms, 0, 0, 100, 1), Tick(ms + 400, 0, 0, 103, 2), Tick(ms + 4999, 0, 0, 99, 3)};
+    std::vector<Tick> second = {Tick(ms + 5000, 0, 0, 101, 4), Tick(ms + 14000, 0, 0, 102, 5)};
+    std::vector<std::span<const Tick>> spans = {first, second};
+
+    auto candles = candlesFromTicks(spans, Interval::S5);
+    REQUIRE(candles.size() == 3);
+    REQUIRE(candles[0].openTime == kStart + 10);
+    REQUIRE(candles[1].openTime == kStart + 5);
+    REQUIRE(candles[2].openTime == kStart);
+    REQUIRE(candles[2].open == 100);
+    REQUIRE(candles[2].high == 103);
+    REQUIRE(candles[2].low == 99);
+    REQUIRE(candles[2].close == 99);
+    REQUIRE(candles[2].volume == 6);
+    REQUIRE(candles[2].interval == Interval::S5);
+
+    REQUIRE(candlesFromTicks(spans, Interval::S1).size() == 4);
+    REQUIRE(candlesFromTicks({}, Interval::S1).empty());
+}
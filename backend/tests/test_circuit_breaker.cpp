@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include "infrastructure/database/circuit_breaker.hpp"
+
+using trading::infrastructure::database::CircuitBreaker;
+using trading::infrastructure::database::CircuitBreakerConfig;
+using trading::infrastructure::database::circuitStateName;
+using namespace std::chrono_literals;
+
+namespace {
+
+const CircuitBreaker::Clock::time_point kStart{};
+
+} // namespace
+
+TEST_CASE("Circuit breaker opens after consecutive failures", "[clickhouse][breaker]") {
+    CircuitBreaker breaker(CircuitBreakerConfig{3, 1000ms});
+
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(breaker.allow(kStart));
+        breaker.recordFailure(kStart);
+    }
+    // A success in between resets the count
+    REQUIRE(breaker.allow(kStart));
+    breaker.recordSuccess();
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(breaker.allow(kStart));
+        breaker.recordFailure(kStart);
+    }
+    REQUIRE(breaker.state() == CircuitBreaker::State::CLOSED);
+
+    REQUIRE(breaker.allow(kStart));
+    breaker.recordFailure(kStart);
+    REQUIRE(breaker.state() == CircuitBreaker::State::OPEN);
+    REQUIRE(breaker.opened() == 1);
+
+    REQUIRE_FALSE(breaker.allow(kStart + 999ms));
+    REQUIRE_FALSE(breaker.allow(kStart + 999ms));
+    REQUIRE(breaker.rejected() == 2);
+    REQUIRE(circuitStateName(breaker.state()) == "open");
+}
+
+TEST_CASE("Circuit breaker lets one trial through after the open wait", "[clickhouse][breaker]") {
+    CircuitBreaker breaker(CircuitBreakerConfig{1, 1000ms});
+    REQUIRE(breaker.allow(kStart));
+    breaker.recordFailure(kStart);
+
+    SECTION("A successful trial closes it") {
+        REQUIRE(breaker.allow(kStart + 1s));
+        REQUIRE(breaker.state() == CircuitBreaker::State::HALF_OPEN);
+        REQUIRE_FALSE(breaker.allow(kStart + 1s));  // Only the one trial
+        breaker.recordSuccess();
+        REQUIRE(breaker.state() == CircuitBreaker::State::CLOSED);
+        REQUIRE(breaker.allow(kStart + 1s));
+    }
+
+    SECTION("A failed trial opens it for another wait") {
+        REQUIRE(breaker.allow(kStart + 1s));
+        breaker.recordFailure(kStart + 1s);
+        REQUIRE(breaker.state() == CircuitBreaker::State::OPEN);
+        REQUIRE(breaker.opened() == 2);
+        REQUIRE_FALSE(breaker.allow(kStart + 1999ms));
+        REQUIRE(breaker.allow(kStart + 2s));
+    }
+}
+
+TEST_CASE("Circuit breaker ignores outcomes that say nothing about health", "[clickhouse][breaker]") {
+    CircuitBreaker breaker(CircuitBreakerConfig{3, 1000ms});
+
+    // Rejected queries neither open it nor reset the failures before them
+    REQUIRE(breaker.allow(kStart));
+    breaker.recordFailure(kStart);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(breaker.allow(kStart));
+        breaker.recordIgnored();
+    }
+    REQUIRE(breaker.state() == CircuitBreaker::State::CLOSED);
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(breaker.allow(kStart));
+        breaker.recordFailure(kStart);
+    }
+    REQUIRE(breaker.state() == CircuitBreaker::State::OPEN);
+
+    // An ignored trial keeps it half open and lets the next trial through
+    REQUIRE(breaker.allow(kStart + 1s));
+    breaker.recordIgnored();
+    REQUIRE(breaker.state() == CircuitBreaker::State::HALF_OPEN);
+    REQUIRE(breaker.allow(kStart + 1s));
+    breaker.recordSuccess();
+    REQUIRE(breaker.state() == CircuitBreaker::State::CLOSED);
+}
+
+TEST_CASE("Circuit breaker follows the health prober", "[clickhouse][breaker]") {
+    CircuitBreaker breaker(CircuitBreakerConfig{5, 60s});
+
+    breaker.trip(kStart);
+    REQUIRE(breaker.state() == CircuitBreaker::State::OPEN);
+    breaker.trip(kStart + 1s);  // Already open: the wait is not extended
+    REQUIRE(breaker.opened() == 1);
+    REQUIRE_FALSE(breaker.allow(kStart + 2s));
+
+    // A probe that gets an answer ends the wait early
+    breaker.probeSucceeded();
+    REQUIRE(breaker.state() == CircuitBreaker::State::HALF_OPEN);
+    REQUIRE(breaker.allow(kStart + 2s));
+    breaker.recordSuccess();
+    REQUIRE(breaker.state() == CircuitBreaker::State::CLOSED);
+    REQUIRE(circuitStateName(breaker.state()) == "closed");
+}
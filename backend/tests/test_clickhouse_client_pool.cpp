@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "infrastructure/database/clickhouse_client_pool.hpp"
+
+using trading::infrastructure::database::ClickHouseClientPool;
+
+namespace {
+
+struct FakeClient {
+    int id;
+};
+
+} // namespace
+
+TEST_CASE("Client pool reuses returned clients", "[clickhouse][pool]") {
+    int created = 0;
+    ClickHouseClientPool<FakeClient> pool(4, [&] { return std::make_unique<FakeClient>(FakeClient{++created}); });
+
+    {
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        REQUIRE(first->id != second->id);
+        REQUIRE(pool.inUse() == 2);
+    }
+    REQUIRE(pool.inUse() == 0);
+    REQUIRE(pool.idle() == 2);
+
+    {
+        auto again = pool.acquire();
+        REQUIRE(created == 2);
+        again.discard();  // A broken connection is not handed out again
+    }
+    REQUIRE(pool.idle() == 1);
+
+    pool.clear();
+    REQUIRE(pool.idle() == 0);
+    pool.acquire();
+    REQUIRE(created == 3);
+    REQUIRE(pool.waits() == 0);
+}
+
+TEST_CASE("Client pool bounds concurrent leases", "[clickhouse][pool]") {
+    constexpr size_t kCapacity = 3;
+    ClickHouseClientPool<FakeClient> pool(kCapacity, [] { return std::make_unique<FakeClient>(); });
+    std::atomic<size_t> active{0};
+    std::atomic<size_t> peak{0};
+
+    std::vector<std::thread> callers;
+    for (int caller = 0; caller < 12; ++caller) {
+        callers.emplace_back([&] {
+            for (int i = 0; i < 5; ++i) {
+                auto client = pool.acquire();
+                size_t now = active.fetch_add(1) + 1;
+                size_t seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                active.fetch_sub(1);
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    REQUIRE(peak.load() <= kCapacity);
+    REQUIRE(pool.inUse() == 0);
+    REQUIRE(pool.idle() <= kCapacity);
+    REQUIRE(pool.waits() > 0);
+}
+
+TEST_CASE("Client pool gives the slot back when the factory throws", "[clickhouse][pool]") {
+    bool fail = true;
+    ClickHouseClientPool<FakeClient> pool(1, [&]() -> std::unique_ptr<FakeClient> {
+        if (fail) {
+            throw std::runtime_error("connection refused");
+        }
+        return std::make_unique<FakeClient>();
+    });
+
+    REQUIRE_THROWS_AS(pool.acquire(), std::runtime_error);
+    REQUIRE(pool.inUse() == 0);
+
+    fail = false;
+    auto client = pool.acquire();  // Would block forever had the slot leaked
+    REQUIRE(pool.inUse() == 1);
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+#include "infrastructure/metrics/connection_tracker.hpp"
+
+using namespace trading::infrastructure::metrics;
+
+TEST_CASE("ConnectionTracker - Lifecycle", "[metrics][connections]") {
+    ConnectionTracker tracker(std::chrono::minutes(1));
+
+    SECTION("Connect and disconnect move the open socket gauge both ways") {
+        REQUIRE_FALSE(tracker.onConnect("s1"));
+        REQUIRE_FALSE(tracker.onConnect("s2"));
+        REQUIRE(tracker.openSockets() == 2);
+
+        tracker.onDisconnect("s1");
+        auto stats = tracker.snapshot();
+        REQUIRE(stats.openSockets == 1);
+        REQUIRE(stats.detachedSessions == 1);
+        REQUIRE(stats.connectsTotal == 2);
+        REQUIRE(stats.disconnectsTotal == 1);
+    }
+
+    SECTION("Duplicate events are not double counted") {
+        tracker.onConnect("s1");
+        tracker.onConnect("s1");
+        tracker.onDisconnect("s1");
+        tracker.onDisconnect("s1");
+        tracker.onDisconnect("unknown");
+
+        auto stats = tracker.snapshot();
+        REQUIRE(stats.openSockets == 0);
+        REQUIRE(stats.connectsTotal == 1);
+        REQUIRE(stats.disconnectsTotal == 1);
+    }
+
+    SECTION("Reconnecting within the TTL resumes the session") {
+        tracker.onConnect("s1");
+        tracker.onAuthenticated("s1");
+        tracker.onDisconnect("s1");
+        REQUIRE(tracker.snapshot().authenticatedSessions == 0);
+
+        REQUIRE(tracker.onConnect("s1"));
+        auto stats = tracker.snapshot();
+        REQUIRE(stats.openSockets == 1);
+        REQUIRE(stats.authenticatedSessions == 1);
+        REQUIRE(stats.resumesTotal == 1);
+        REQUIRE(stats.sessions.size() == 1);
+        REQUIRE(stats.sessions[0].resumes == 1);
+    }
+
+    SECTION("Logout clears authentication but keeps the socket") {
+        tracker.onConnect("s1");
+        tracker.onAuthenticated("s1");
+        tracker.onAuthenticated("s1");
+        REQUIRE(tracker.snapshot().authenticatedSessions == 1);
+
+        tracker.onLoggedOut("s1");
+        auto stats = tracker.snapshot();
+        REQUIRE(stats.authenticatedSessions == 0);
+        REQUIRE(stats.openSockets == 1);
+    }
+
+    SECTION("Authentication without a connect event counts the socket") {
+        tracker.onAuthenticated("s1");
+        tracker.onConnect("s1");
+
+        auto stats = tracker.snapshot();
+        REQUIRE(stats.openSockets == 1);
+        REQUIRE(stats.authenticatedSessions == 1);
+        REQUIRE(stats.connectsTotal == 1);
+    }
+}
+
+TEST_CASE("ConnectionTracker - Session Expiry", "[metrics][connections]") {
+    ConnectionTracker tracker(std::chrono::milliseconds(0));
+
+    tracker.onConnect("s1");
+    tracker.onDisconnect("s1");
+
+    // Left in place until expireSessions() prunes it, but no longer counted
+    auto stats = tracker.snapshot();
+    REQUIRE(stats.detachedSessions == 0);
+    REQUIRE(stats.expiredTotal == 0);
+
+    // Expired sessions come back as new sessions, not resumes
+    REQUIRE_FALSE(tracker.onConnect("s1"));
+    stats = tracker.snapshot();
+    REQUIRE(stats.resumesTotal == 0);
+    REQUIRE(stats.expiredTotal == 1);
+
+    // Every expired id is handed out once, whether a reconnect or the prune found it
+    tracker.onConnect("s2");
+    tracker.onDisconnect("s2");
+    REQUIRE(tracker.expireSessions() == std::vector<std::string>{"s1", "s2"});
+    REQUIRE(tracker.expireSessions().empty());
+    REQUIRE(tracker.snapshot().expiredTotal == 2);
+}
+
+TEST_CASE("ConnectionTracker - Send Accounting", "[metrics][connections]") {
+    ConnectionTracker tracker(std::chrono::minutes(1));
+    tracker.onConnect("s1");
+    tracker.onConnect("s2");
+
+    SECTION("Frames and bytes are attributed per session") {
+        tracker.onSent("s1", 100);
+        tracker.onSent(std::vector<std::string>{"s1", "s2", "unknown"}, 50);
+
+        auto stats = tracker.snapshot();
+        REQUIRE(stats.sessions.size() == 2);
+        REQUIRE(stats.sessions[0].sessionId == "s1");
+        REQUIRE(stats.sessions[0].framesSent == 2);
+        REQUIRE(stats.sessions[0].bytesSent == 150);
+        REQUIRE(stats.sessions[1].framesSent == 1);
+        REQUIRE(stats.detachedFrames == 0);
+    }
+
+    SECTION("Frames sent while detached are counted until resume") {
+        tracker.onDisconnect("s1");
+        tracker.onSent("s1", 40);
+        tracker.onSent("s1", 60);
+
+        auto stats = tracker.snapshot();
+        REQUIRE(stats.detachedFrames == 2);
+        REQUIRE(stats.detachedBytes == 100);
+
+        // Totals-only snapshots still carry the detached aggregates, without session ids
+        auto totals = tracker.snapshot(false);
+        REQUIRE(totals.sessions.empty());
+        REQUIRE(totals.sessionsWithDetachedSends == 1);
+        REQUIRE(totals.maxSessionDetachedFrames == 2);
+        REQUIRE(totals.maxSessionDetachedBytes == 100);
+
+        tracker.onConnect("s1");
+        stats = tracker.snapshot();
+        REQUIRE(stats.detachedFrames == 0);
+        REQUIRE(stats.detachedBytes == 0);
+        REQUIRE(stats.sessions[0].bytesSent == 100);
+    }
+
+    SECTION("Concurrent sends are not lost") {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&tracker] {
+                for (int i = 0; i < 10000; ++i) {
+                    tracker.onSent("s2", 10);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(tracker.snapshot().sessions[1].bytesSent == 800000);
+    }
+}
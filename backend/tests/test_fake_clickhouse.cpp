@@ -0,0 +1,465 @@
+#include <catch2/catch_test_macros.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <nlohmann/json.hpp>
+#include <string>
+#include "fake_clickhouse/fake_clickhouse_server.hpp"
+#include "infrastructure/database/http_compression.hpp"
+
+using namespace trading::fake_clickhouse;
+using trading::infrastructure::database::HttpCompression;
+
+namespace {
+
+// Schema as the repository creates it
+const char* kCandlesTable = R"(
+    CREATE TABLE IF NOT EXISTS trading_db.candles_1m (
+        symbol String,
+        open_time DateTime,
+        open Float64,
+        high Float64,
+        low Float64,
+        close Float64,
+        volume UInt64
+    ) ENGINE = MergeTree()
+    ORDER BY (symbol, open_time)
+    PARTITION BY toYYYYMMDD(open_time)
+    TTL open_time + INTERVAL 180 DAY
+)";
+
+const char* kTicksTable = R"(
+    CREATE TABLE IF NOT EXISTS trading_db.ticks (
+        symbol String,
+        ts DateTime64(6),
+        bid Float64,
+        ask Float64,
+        last Float64,
+        volume UInt64
+    ) ENGINE = MergeTree()
+    ORDER BY (symbol, ts)
+)";
+
+const char* kOrdersLogTable = R"(
+    CREATE TABLE IF NOT EXISTS trading_db.orders_log (
+        idemp_key String,
+        ts DateTime,
+        status String,
+        order_id String,
+        result String
+    ) ENGINE = MergeTree()
+    ORDER BY (idemp_key, ts)
+)";
+
+void createSchema(FakeClickHouseStore& store) {
+    store.execute("CREATE DATABASE IF NOT EXISTS trading_db");
+    store.execute(kCandlesTable);
+    store.execute(kTicksTable);
+    store.execute(kOrdersLogTable);
+}
+
+void appendLE(std::string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out += static_cast<char>(value >> (i * 8));
+    }
+}
+
+void appendDouble(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendLE(out, bits, 8);
+}
+
+struct HttpReply {
+    int status = 0;
+    std::string headers;
+    std::string body;
+};
+
+// One request on a fresh connection; status 0 when the server closed without answering
+HttpReply httpRequest(int port, const std::string& method, const std::string& target, const std::string& body = {},
+                      const std::string& headers = {}) {
+    HttpReply reply;
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{5, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return reply;
+    }
+
+    std::string request = method + " " + target + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n"
+                        "Content-Length: " + std::to_string(body.size()) + "\r\n" + headers + "\r\n" + body;
+    ::send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+
+    size_t headerEnd = response.find("\r\n\r\n");
+    if (response.rfind("HTTP/1.1 ", 0) != 0 || headerEnd == std::string::npos) {
+        return reply;
+    }
+    reply.status = std::stoi(response.substr(9, 3));
+    reply.headers = response.substr(0, headerEnd);
+    reply.body = response.substr(headerEnd + 4);
+    return reply;
+}
+
+} // namespace
+
+TEST_CASE("Fake ClickHouse answers the candle query in FORMAT JSON", "[fake_clickhouse]") {
+    FakeClickHouseStore store;
+    createSchema(store);
+    auto insert = store.execute(
+        "INSERT INTO trading_db.candles_1m VALUES "
+        "('ETH-USD', '2024-01-01 00:00:00', 3400.5, 3401, 3399, 3400.75, 120), "
+        "('ETH-USD', '2024-01-01 00:01:00', 3400.75, 3402, 3400, 3401.25, 80), "
+        "('BTC-USD', '2024-01-01 00:01:00', 42000, 42010, 41990, 42005, 3)");
+    REQUIRE(insert.writtenRows == 3);
+    REQUIRE(store.rowCount("trading_db.candles_1m") == 3);
+
+    auto result = store.execute(
+        "SELECT open_time, open, high, low, close, volume FROM trading_db.candles_1m "
+        "WHERE symbol = 'ETH-USD' AND open_time >= '2024-01-01 00:00:00' AND open_time <= '2024-01-01 00:00:59' "
+        "ORDER BY open_time DESC LIMIT 10 FORMAT JSON");
+    REQUIRE(result.format == "JSON");
+    REQUIRE(result.resultRows == 1);
+    REQUIRE(result.readRows == 3);
+
+    auto json = nlohmann::json::parse(result.body);
+    REQUIRE(json["meta"][0]["name"] == "open_time");
+    REQUIRE(json["meta"][0]["type"] == "DateTime");
+    REQUIRE(json["meta"][5]["type"] == "UInt64");
+    REQUIRE(json["rows"] == 1);
+    REQUIRE(json["rows_before_limit_at_least"] == 1);
+    const auto& row = json["data"][0];
+    REQUIRE(row["open_time"] == "2024-01-01 00:00:00");
+    REQUIRE(row["open"] == 3400.5);
+    REQUIRE(row["volume"] == "120");    // 64-bit integers are quoted
+
+    auto latest = nlohmann::json::parse(store.execute(
+        "SELECT symbol, open_time, close FROM trading_db.candles_1m WHERE symbol IN ('ETH-USD','BTC-USD') "
+        "ORDER BY open_time DESC, symbol LIMIT 2 FORMAT JSON").body);
+    REQUIRE(latest["data"].size() == 2);
+    REQUIRE(latest["data"][0]["symbol"] == "BTC-USD");
+    REQUIRE(latest["data"][1]["symbol"] == "ETH-USD");
+    REQUIRE(latest["rows_before_limit_at_least"] == 3);
+
+    // No FORMAT clause: TabSeparated, as the mock-data row count check expects
+    REQUIRE(store.execute("SELECT COUNT(*) FROM trading_db.candles_1m").body == "3\n");
+    REQUIRE(store.execute("SELECT symbol, count() AS n, max(high) FROM trading_db.candles_1m GROUP BY symbol ORDER BY n DESC").body ==
+            "ETH-USD\t2\t3402\nBTC-USD\t1\t42010\n");
+}
+
+TEST_CASE("Fake ClickHouse binds {name:Type} query parameters", "[fake_clickhouse]") {
+    FakeClickHouseStore store;
+    createSchema(store);
+    store.execute(
+        "INSERT INTO trading_db.candles_1m VALUES "
+        "('ETH-USD', '2024-01-01 00:00:00', 3400.5, 3401, 3399, 3400.75, 120), "
+        "('ETH-USD', '2024-01-01 00:01:00', 3400.75, 3402, 3400, 3401.25, 80), "
+        "('BTC-USD', '2024-01-01 00:01:00', 42000, 42010, 41990, 42005, 3), "
+        "('O\\'D', '2024-01-01 00:01:00', 1, 1, 1, 1, 1)");
+
+    // DateTime binds from epoch seconds, and LIMIT takes a parameter too
+    auto candles = nlohmann::json::parse(store.execute(
+        "SELECT open_time FROM trading_db.candles_1m "
+        "WHERE symbol = {symbol:String} AND open_time >= {from:DateTime} AND open_time <= {to:DateTime} "
+        "ORDER BY open_time DESC LIMIT {limit:UInt32} FORMAT JSON",
+        {}, "default", {{"symbol", "ETH-USD"}, {"from", "1704067200"}, {"to", "1704067260"}, {"limit", "1"}}).body);
+    REQUIRE(candles["data"].size() == 1);
+    REQUIRE(candles["data"][0]["open_time"] == "2024-01-01 00:01:00");
+    REQUIRE(candles["rows_before_limit_at_least"] == 2);
+
+    // Values arrive in the escaped text format and are never parsed as SQL
+    auto quoted = store.execute("SELECT count() FROM trading_db.candles_1m WHERE symbol = {symbol:String}",
+                                {}, "default", {{"symbol", "O'D"}});
+    REQUIRE(quoted.body == "1\n");
+    auto injected = store.execute("SELECT count() FROM trading_db.candles_1m WHERE symbol = {symbol:String}",
+                                  {}, "default", {{"symbol", "x' OR '1'='1"}});
+    REQUIRE(injected.body == "0\n");
+
+    auto latest = nlohmann::json::parse(store.execute(
+        "SELECT symbol FROM trading_db.candles_1m WHERE symbol IN {symbols:Array(String)} "
+        "ORDER BY open_time DESC, symbol FORMAT JSON",
+        {}, "default", {{"symbols", "['BTC-USD','O\\'D']"}}).body);
+    REQUIRE(latest["data"].size() == 2);
+    REQUIRE(latest["data"][0]["symbol"] == "BTC-USD");
+    REQUIRE(latest["data"][1]["symbol"] == "O'D");
+
+    // DateTime bounds compare as times against DateTime64 columns
+    store.execute("INSERT INTO trading_db.ticks VALUES ('ETH-USD', '2024-01-01 00:00:00.250000', 1, 2, 1.5, 10)");
+    QueryParameters bounds{{"from", "1704067200"}, {"to", "1704067200"}};
+    REQUIRE(store.execute("SELECT count() FROM trading_db.ticks WHERE ts >= {from:DateTime}", {}, "default", bounds).body == "1\n");
+    REQUIRE(store.execute("SELECT count() FROM trading_db.ticks WHERE ts <= {to:DateTime}", {}, "default", bounds).body == "0\n");
+
+    try {
+        store.execute("SELECT count() FROM trading_db.candles_1m WHERE symbol = {symbol:String}");
+        FAIL("missing parameter accepted");
+    } catch (const ClickHouseError& e) {
+        REQUIRE(e.code() == 456);
+        REQUIRE(e.httpStatus() == 400);
+    }
+}
+
+TEST_CASE("Fake ClickHouse round-trips RowBinary", "[fake_clickhouse]") {
+    FakeClickHouseStore store;
+    createSchema(store);
+
+    std::string rows;
+    for (int i = 0; i < 3; ++i) {
+        std::string symbol = i == 2 ? "BTC-USD" : "ETH-USD";
+        appendLE(rows, symbol.size(), 1);
+        rows += symbol;
+        appendLE(rows, 1718000000000000ULL + static_cast<uint64_t>(i) * 250000, 8);  // DateTime64(6) ticks
+        appendDouble(rows, 3400.0 + i);
+        appendDouble(rows, 3400.5 + i);
+        appendDouble(rows, 3400.25 + i);
+        appendLE(rows, 100 + static_cast<uint64_t>(i), 8);
+    }
+    auto insert = store.execute("INSERT INTO trading_db.ticks FORMAT RowBinary", rows);
+    REQUIRE(insert.writtenRows == 3);
+
+    auto select = store.execute("SELECT * FROM trading_db.ticks ORDER BY ts FORMAT RowBinary");
+    REQUIRE(select.format == "RowBinary");
+    REQUIRE(select.body == rows);
+
+    auto text = store.execute("SELECT ts, volume FROM trading_db.ticks WHERE symbol = 'BTC-USD'");
+    REQUIRE(text.body == "2024-06-10 06:13:20.500000\t102\n");
+
+    // A truncated row is rejected and nothing is written
+    REQUIRE_THROWS_AS(store.execute("INSERT INTO trading_db.ticks FORMAT RowBinary", rows.substr(0, rows.size() - 3)), ClickHouseError);
+    REQUIRE(store.rowCount("trading_db.ticks") == 3);
+}
+
+TEST_CASE("Fake ClickHouse resolves the latest status per order with a join", "[fake_clickhouse]") {
+    FakeClickHouseStore store;
+    createSchema(store);
+    // The writer thread inserts ts as epoch seconds
+    store.execute("INSERT INTO trading_db.orders_log VALUES ('k1', 1704067200, 'accepted', 'ORD_1', '{\"qty\":1}')");
+    store.execute("INSERT INTO trading_db.orders_log VALUES ('k1', 1704067260, 'cancelled', 'ORD_1', '{\"qty\":1}')");
+    store.execute("INSERT INTO trading_db.orders_log VALUES ('k2', '2024-01-01 00:00:30', 'accepted', 'ORD_2', '{}')");
+
+    auto result = store.execute(
+        "SELECT   ol1.order_id,   ol1.idemp_key,   ol1.ts,   ol1.status,   ol1.result "
+        "FROM trading_db.orders_log ol1 INNER JOIN (   SELECT order_id, MAX(ts) as max_ts   FROM trading_db.orders_log "
+        "  WHERE ts >= '2024-01-01 00:00:00' AND ts <= '2024-01-02 00:00:00'   GROUP BY order_id ) ol2 "
+        "ON ol1.order_id = ol2.order_id AND ol1.ts = ol2.max_ts ORDER BY ol1.ts DESC LIMIT 100 FORMAT JSON");
+    auto json = nlohmann::json::parse(result.body);
+    REQUIRE(json["data"].size() == 2);
+    REQUIRE(json["data"][0]["order_id"] == "ORD_1");
+    REQUIRE(json["data"][0]["status"] == "cancelled");
+    REQUIRE(json["data"][0]["ts"] == "2024-01-01 00:01:00");
+    REQUIRE(json["data"][0]["result"] == "{\"qty\":1}");
+    REQUIRE(json["data"][1]["order_id"] == "ORD_2");
+}
+
+TEST_CASE("Fake ClickHouse collapses ReplacingMergeTree versions under FINAL", "[fake_clickhouse]") {
+    FakeClickHouseStore store;
+    createSchema(store);
+    store.execute(
+        "CREATE TABLE trading_db.orders_latest (order_id String, placed_at DateTime64(3), updated_at DateTime64(3), "
+        "status Enum8('ACK' = 1, 'CANCELLED' = 4), side Enum8('UNKNOWN' = 0, 'BUY' = 1, 'SELL' = 2), quantity Float64) "
+        "ENGINE = ReplacingMergeTree(updated_at) ORDER BY (placed_at, order_id) PARTITION BY toYYYYMM(placed_at)");
+    store.execute("INSERT INTO trading_db.orders_latest VALUES "
+                  "('ORD_1', '2024-01-01 00:00:00.000', '2024-01-01 00:01:00.000', 'CANCELLED', 'BUY', 1), "
+                  "('ORD_1', '2024-01-01 00:00:00.000', '2024-01-01 00:00:00.000', 'ACK', 'BUY', 1), "
+                  "('ORD_2', '2024-01-01 00:00:30.000', '2024-01-01 00:00:30.000', 'ACK', 'SELL', 2)");
+
+    auto all = store.execute("SELECT order_id FROM trading_db.orders_latest FORMAT JSON");
+    REQUIRE(all.resultRows == 3);  // Unmerged parts keep every version
+
+    auto result = store.execute("SELECT order_id, status, side FROM trading_db.orders_latest FINAL "
+                                "ORDER BY placed_at DESC, order_id DESC FORMAT JSON");
+    auto json = nlohmann::json::parse(result.body);
+    REQUIRE(json["data"].size() == 2);
+    REQUIRE(json["data"][0]["order_id"] == "ORD_2");
+    REQUIRE(json["data"][1]["status"] == "CANCELLED");  // The higher updated_at wins over insertion order
+
+    // The typed-order backfill reads the legacy JSON column
+    store.execute("INSERT INTO trading_db.orders_log VALUES ('k1', 1704067200, 'accepted', 'ORD_1', '{\"side\":\"sell\",\"price\":2500.5}')");
+    auto legacy = nlohmann::json::parse(store.execute(
+        "SELECT upper(JSONExtractString(result, 'side')) AS side, JSONExtractFloat(result, 'price') AS price, "
+        "JSONExtractString(result, 'missing') AS missing FROM trading_db.orders_log FORMAT JSON").body);
+    REQUIRE(legacy["data"][0]["side"] == "SELL");
+    REQUIRE(legacy["data"][0]["price"] == 2500.5);
+    REQUIRE(legacy["data"][0]["missing"] == "");
+}
+
+TEST_CASE("Fake ClickHouse feeds materialized views with aggregate states", "[fake_clickhouse]") {
+    FakeClickHouseStore store;
+    createSchema(store);
+    store.execute(
+        "CREATE TABLE trading_db.candles_1h (symbol String, open_time DateTime, "
+        "open AggregateFunction(argMin, Float64, DateTime), high SimpleAggregateFunction(max, Float64), "
+        "close AggregateFunction(argMax, Float64, DateTime), volume SimpleAggregateFunction(sum, UInt64)) "
+        "ENGINE = AggregatingMergeTree() ORDER BY (symbol, open_time)");
+    store.execute(
+        "CREATE MATERIALIZED VIEW trading_db.candles_1h_mv TO trading_db.candles_1h AS "
+        "SELECT src.symbol AS symbol, toStartOfHour(src.open_time) AS open_time, "
+        "argMinState(src.open, src.open_time) AS open, max(src.high) AS high, "
+        "argMaxState(src.close, src.open_time) AS close, sum(src.volume) AS volume "
+        "FROM trading_db.candles_1m AS src GROUP BY src.symbol, toStartOfHour(src.open_time)");
+    REQUIRE(store.execute("EXISTS TABLE trading_db.candles_1h_mv").body == "1\n");
+    REQUIRE(store.execute("EXISTS trading_db.candles_5m").body == "0\n");
+
+    // Each insert is aggregated on its own, so one hour ends up in two rows
+    store.execute("INSERT INTO trading_db.candles_1m VALUES "
+                  "('ETH-USD', '2024-01-01 00:59:00', 3410, 3412, 3409, 3411, 5), "
+                  "('ETH-USD', '2024-01-01 00:10:00', 3400, 3405, 3399, 3404, 10), "
+                  "('ETH-USD', '2024-01-01 01:00:00', 3411, 3420, 3410, 3418, 7)");
+    store.execute("INSERT INTO trading_db.candles_1m VALUES ('ETH-USD', '2024-01-01 00:30:00', 3404, 3430, 3401, 3407, 20)");
+    REQUIRE(store.rowCount("trading_db.candles_1h") == 3);
+
+    auto result = store.execute(
+        "SELECT r.open_time AS open_time, argMinMerge(r.open) AS open, max(r.high) AS high, "
+        "argMaxMerge(r.close) AS close, sum(r.volume) AS volume FROM trading_db.candles_1h AS r "
+        "WHERE r.symbol = 'ETH-USD' GROUP BY r.open_time ORDER BY open_time");
+    REQUIRE(result.body ==
+            "2024-01-01 00:00:00\t3400\t3430\t3411\t35\n"
+            "2024-01-01 01:00:00\t3411\t3420\t3418\t7\n");
+
+    // A merge of the wrong state kind is a type error
+    REQUIRE_THROWS_AS(store.execute("SELECT argMaxMerge(open) FROM trading_db.candles_1h"), ClickHouseError);
+
+    store.execute("DROP VIEW trading_db.candles_1h_mv");
+    store.execute("INSERT INTO trading_db.candles_1m VALUES ('ETH-USD', '2024-01-01 02:00:00', 1, 1, 1, 1, 1)");
+    REQUIRE(store.rowCount("trading_db.candles_1h") == 3);
+}
+
+TEST_CASE("Fake ClickHouse fails with ClickHouse error codes", "[fake_clickhouse]") {
+    FakeClickHouseStore store;
+    createSchema(store);
+
+    auto codeOf = [&store](const std::string& sql) {
+        try {
+            store.execute(sql);
+        } catch (const ClickHouseError& e) {
+            return e.code();
+        }
+        return 0;
+    };
+    REQUIRE(codeOf("SELECT * FROM trading_db.missing") == 60);
+    REQUIRE(codeOf("SELECT nope FROM trading_db.ticks") == 47);
+    REQUIRE(codeOf("SELEC 1") == 62);
+    REQUIRE(codeOf("CREATE TABLE nowhere.t (a UInt8) ENGINE = Memory") == 81);
+    REQUIRE(codeOf("INSERT INTO trading_db.candles_1m VALUES ('ETH-USD', 'yesterday', 1, 1, 1, 1, 1)") == 6);
+
+    try {
+        store.execute("SELECT * FROM trading_db.missing");
+    } catch (const ClickHouseError& e) {
+        REQUIRE(e.httpStatus() == 404);
+        REQUIRE(e.render().rfind("Code: 60. DB::Exception: ", 0) == 0);
+        REQUIRE(e.render().find("(UNKNOWN_TABLE)") != std::string::npos);
+    }
+}
+
+TEST_CASE("Fake ClickHouse server speaks HTTP with latency and failure injection", "[fake_clickhouse]") {
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    REQUIRE(server.port() > 0);
+
+    auto ping = httpRequest(server.port(), "GET", "/");
+    REQUIRE(ping.status == 200);
+    REQUIRE(ping.body == "Ok.\n");
+
+    REQUIRE(httpRequest(server.port(), "POST", "/", "CREATE DATABASE trading_db").status == 200);
+    REQUIRE(httpRequest(server.port(), "POST", "/", kCandlesTable).status == 200);
+    // Query in the URL, data in the body
+    auto insert = httpRequest(server.port(), "POST", "/?query=INSERT%20INTO%20trading_db.candles_1m%20FORMAT%20TabSeparated",
+                              "ETH-USD\t2024-01-01 00:00:00\t1\t2\t0.5\t1.5\t10\n");
+    REQUIRE(insert.status == 200);
+    REQUIRE(insert.headers.find("\"written_rows\":\"1\"") != std::string::npos);
+
+    auto select = httpRequest(server.port(), "POST", "/", "SELECT volume FROM trading_db.candles_1m FORMAT JSON");
+    REQUIRE(select.status == 200);
+    REQUIRE(select.headers.find("X-ClickHouse-Format: JSON") != std::string::npos);
+    REQUIRE(nlohmann::json::parse(select.body)["data"][0]["volume"] == "10");
+
+    auto missing = httpRequest(server.port(), "POST", "/", "SELECT * FROM trading_db.nope");
+    REQUIRE(missing.status == 404);
+    REQUIRE(missing.headers.find("X-ClickHouse-Exception-Code: 60") != std::string::npos);
+
+    SECTION("Injected failures leave the store untouched") {
+        server.failNext(1);
+        auto failed = httpRequest(server.port(), "POST", "/", "INSERT INTO trading_db.candles_1m VALUES ('A', 0, 1, 1, 1, 1, 1)");
+        REQUIRE(failed.status == 500);
+        REQUIRE(failed.headers.find("X-ClickHouse-Exception-Code") != std::string::npos);
+        REQUIRE(server.store().rowCount("trading_db.candles_1m") == 1);
+
+        server.dropNext(1);
+        REQUIRE(httpRequest(server.port(), "GET", "/ping").status == 0);
+        REQUIRE(httpRequest(server.port(), "GET", "/ping").status == 200);
+
+        auto stats = server.stats();
+        REQUIRE(stats.injectedFailures == 1);
+        REQUIRE(stats.droppedConnections == 1);
+        REQUIRE(stats.errors == 1);
+    }
+
+    SECTION("Latency is added to every response") {
+        server.setLatency(std::chrono::milliseconds(30));
+        auto started = std::chrono::steady_clock::now();
+        REQUIRE(httpRequest(server.port(), "GET", "/ping").status == 200);
+        REQUIRE(std::chrono::steady_clock::now() - started >= std::chrono::milliseconds(30));
+    }
+
+    SECTION("Every statement is logged") {
+        auto log = server.queryLog();
+        REQUIRE(log.size() == 5);
+        REQUIRE(log.front() == "CREATE DATABASE trading_db");
+    }
+
+    server.stop();
+}
+
+TEST_CASE("Fake ClickHouse server decodes and encodes compressed bodies", "[fake_clickhouse]") {
+    using trading::infrastructure::database::compressHttpBody;
+    using trading::infrastructure::database::decompressHttpBody;
+    FakeClickHouseServer server;
+    REQUIRE(server.start());
+    REQUIRE(httpRequest(server.port(), "POST", "/", "CREATE DATABASE trading_db").status == 200);
+    REQUIRE(httpRequest(server.port(), "POST", "/", kCandlesTable).status == 200);
+
+    std::string rows;
+    for (int i = 0; i < 100; ++i) {
+        rows += "ETH-USD\t" + std::to_string(1704067200 + i * 60) + "\t1\t2\t0.5\t1.5\t10\n";
+    }
+    auto insert = httpRequest(server.port(), "POST", "/?query=INSERT%20INTO%20trading_db.candles_1m%20FORMAT%20TabSeparated",
+                              compressHttpBody(rows, HttpCompression::ZSTD), "Content-Encoding: zstd\r\n");
+    REQUIRE(insert.status == 200);
+    REQUIRE(server.store().rowCount("trading_db.candles_1m") == 100);
+
+    std::string select = "SELECT symbol, open_time FROM trading_db.candles_1m FORMAT JSON";
+    auto compressed = httpRequest(server.port(), "POST", "/?enable_http_compression=1",
+                                  compressHttpBody(select, HttpCompression::LZ4),
+                                  "Content-Encoding: lz4\r\nAccept-Encoding: gzip, lz4\r\n");
+    REQUIRE(compressed.status == 200);
+    REQUIRE(compressed.headers.find("Content-Encoding: lz4") != std::string::npos);
+    REQUIRE(nlohmann::json::parse(decompressHttpBody(compressed.body, HttpCompression::LZ4))["rows"] == 100);
+
+    // Without the setting, or without a codec it knows, the response stays plain
+    auto plain = httpRequest(server.port(), "POST", "/", select, "Accept-Encoding: zstd\r\n");
+    REQUIRE(plain.headers.find("Content-Encoding") == std::string::npos);
+    REQUIRE(plain.body.size() > compressed.body.size() * 4);
+    REQUIRE(httpRequest(server.port(), "POST", "/?enable_http_compression=1", select, "Accept-Encoding: br\r\n")
+                .headers.find("Content-Encoding") == std::string::npos);
+
+    REQUIRE(httpRequest(server.port(), "POST", "/", "not zstd", "Content-Encoding: zstd\r\n").status == 400);
+    auto unknown = httpRequest(server.port(), "POST", "/", select, "Content-Encoding: snappy\r\n");
+    REQUIRE(unknown.headers.find("X-ClickHouse-Exception-Code: 89") != std::string::npos);
+    server.stop();
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "application/history_warmup.hpp"
+#include "infrastructure/database/history_cache_key.hpp"
+
+using namespace trading::application;
+using trading::domain::Candle;
+using trading::domain::HistoryQuery;
+using trading::domain::Interval;
+using trading::domain::Symbol;
+
+namespace {
+
+// Answers every page with one candle after a short delay and remembers what
+// was asked; "BAD-USD" throws
+class RecordingRepository : public trading::domain::IHistoryRepository {
+public:
+    std::vector<Candle> fetch(const Symbol& symbol, const HistoryQuery& query) override {
+        size_t now = active.fetch_add(1) + 1;
+        size_t seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        active.fetch_sub(1);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fetched.push_back(symbol.code);
+            queries.push_back(query);
+        }
+        if (symbol.code == "BAD-USD") {
+            throw std::runtime_error("unreachable");
+        }
+        return {Candle(query.toTs, 1.0, 1.0, 1.0, 1.0, 1, query.interval)};
+    }
+
+    std::vector<Candle> latest(const std::vector<Symbol>& symbols, int32_t limit) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        latestSymbols = symbols.size();
+        latestLimit = limit;
+        return std::vector<Candle>(symbols.size());
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> fetched;
+    std::vector<HistoryQuery> queries;
+    size_t latestSymbols = 0;
+    int32_t latestLimit = 0;
+    std::atomic<size_t> active{0};
+    std::atomic<size_t> peak{0};
+};
+
+const std::vector<std::string> kSymbols = {"ETH-USD", "BTC-USD", "ADA-USD", "SOL-USD", "DOGE-USD", "AVAX-USD"};
+
+} // namespace
+
+TEST_CASE("warmHistory reads every symbol's latest page, then the latest candles", "[warmup]") {
+    RecordingRepository repository;
+    constexpr int64_t kNow = 1'718'000'000;
+
+    auto result = warmHistory(repository, kSymbols, kNow, 3);
+
+    REQUIRE(result.symbolsWarmed == kSymbols.size());
+    REQUIRE(result.candles == kSymbols.size());
+    REQUIRE(result.latestCandles == kSymbols.size());
+    REQUIRE(repository.latestSymbols == kSymbols.size());
+    REQUIRE(repository.latestLimit == static_cast<int32_t>(kSymbols.size()));
+
+    auto fetched = repository.fetched;
+    std::sort(fetched.begin(), fetched.end());
+    auto expected = kSymbols;
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(fetched == expected);
+    for (const auto& query : repository.queries) {
+        REQUIRE(query.toTs == kNow);
+        REQUIRE(query.fromTs == kNow - kWarmupWindowSeconds);
+        REQUIRE(query.interval == Interval::M1);
+        REQUIRE(query.limit == kWarmupCandles);
+    }
+
+    // Symbols overlap, but never more than asked for
+    REQUIRE(repository.peak.load() > 1);
+    REQUIRE(repository.peak.load() <= 3);
+}
+
+TEST_CASE("warmHistory skips a symbol whose read fails", "[warmup]") {
+    RecordingRepository repository;
+
+    auto result = warmHistory(repository, {"ETH-USD", "BAD-USD", "BTC-USD"}, 1'718'000'000, 8);
+
+    REQUIRE(repository.fetched.size() == 3);
+    REQUIRE(result.symbolsWarmed == 2);
+    REQUIRE(result.candles == 2);
+    REQUIRE(result.latestCandles == 3);
+    REQUIRE(repository.peak.load() <= 3);
+}
+
+TEST_CASE("A client's past-day query shares the warmed page's cache key", "[warmup]") {
+    using trading::infrastructure::database::historyCacheKey;
+    constexpr int64_t kWarmedAt = 1'718'000'000;
+    HistoryQuery warmed(kWarmedAt - kWarmupWindowSeconds, kWarmedAt, Interval::M1, kWarmupCandles);
+    auto key = historyCacheKey(Symbol("BTC-USD"), warmed, kWarmedAt);
+
+    // The home page's read minutes later; its bounds come from milliseconds
+    int64_t askedAt = kWarmedAt + 300;
+    HistoryQuery asked(askedAt - 86'399, askedAt, Interval::M1, 1440);
+    REQUIRE(historyCacheKey(Symbol("BTC-USD"), asked, askedAt + 1) == key);
+
+    // Anything else asked is keyed apart
+    REQUIRE(historyCacheKey(Symbol("ETH-USD"), asked, askedAt) != key);
+    HistoryQuery hourly(askedAt - 86'400, askedAt, Interval::H1, 1440);
+    REQUIRE(historyCacheKey(Symbol("BTC-USD"), hourly, askedAt) != key);
+    HistoryQuery older(kWarmedAt - 2 * 86'400, kWarmedAt - 86'400, Interval::M1, 1440);
+    REQUIRE(historyCacheKey(Symbol("BTC-USD"), older, askedAt) != key);
+    REQUIRE(historyCacheKey(Symbol("BTC-USD"), older, askedAt) == historyCacheKey(Symbol("BTC-USD"), older, askedAt + 600));
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include "infrastructure/database/http_compression.hpp"
+
+using namespace trading::infrastructure::database;
+
+namespace {
+
+// A FORMAT JSON-like body: repetitive, as ClickHouse results are
+std::string jsonRows(int rows) {
+    std::string body = "{\"data\":[";
+    for (int i = 0; i < rows; ++i) {
+        body += (i ? "," : "") + std::string("{\"open_time\":\"2024-01-01 00:") + std::to_string(i % 60) +
+                ":00\",\"open\":" + std::to_string(3400.25 + i % 97) + ",\"volume\":\"" + std::to_string(1000 + i) + "\"}";
+    }
+    return body + "]}";
+}
+
+} // namespace
+
+TEST_CASE("HTTP compression codecs round-trip", "[clickhouse][compression]") {
+    for (HttpCompression codec : {HttpCompression::LZ4, HttpCompression::ZSTD}) {
+        INFO(std::string(httpCompressionName(codec)));
+        for (int rows : {0, 1, 1000, 50000}) {
+            std::string body = jsonRows(rows);
+            std::string compressed = compressHttpBody(body, codec);
+            REQUIRE(isCompressedHttpBody(compressed, codec));
+            REQUIRE_FALSE(isCompressedHttpBody(body, codec));
+            REQUIRE(decompressHttpBody(compressed, codec) == body);
+            if (rows >= 1000) {
+                REQUIRE(compressed.size() * 4 < body.size());
+            }
+        }
+
+        // A streamed response may arrive as several frames back to back
+        std::string first = jsonRows(10);
+        std::string second = jsonRows(20);
+        REQUIRE(decompressHttpBody(compressHttpBody(first, codec) + compressHttpBody(second, codec), codec) == first + second);
+
+        std::string truncated = compressHttpBody(jsonRows(1000), codec);
+        truncated.resize(truncated.size() / 2);
+        REQUIRE_THROWS_AS(decompressHttpBody(truncated, codec), std::runtime_error);
+        REQUIRE_THROWS_AS(decompressHttpBody("{\"data\":[]}", codec), std::runtime_error);
+    }
+
+    REQUIRE(compressHttpBody("plain", HttpCompression::NONE) == "plain");
+    REQUIRE_FALSE(isCompressedHttpBody(compressHttpBody("x", HttpCompression::LZ4), HttpCompression::ZSTD));
+}
+
+TEST_CASE("HTTP compression names parse case-insensitively", "[clickhouse][compression]") {
+    REQUIRE(parseHttpCompression("LZ4") == HttpCompression::LZ4);
+    REQUIRE(parseHttpCompression("zstd") == HttpCompression::ZSTD);
+    REQUIRE(parseHttpCompression("None") == HttpCompression::NONE);
+    REQUIRE_FALSE(parseHttpCompression("gzip").has_value());
+    REQUIRE(httpCompressionName(HttpCompression::ZSTD) == "zstd");
+}
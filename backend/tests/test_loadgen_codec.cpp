@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "loadgen/rpc_codec.hpp"
+#include "loadgen/websocket_frame.hpp"
+#include "utils/parser.hpp"
+
+using namespace trading::loadgen;
+
+namespace {
+
+std::vector<uint8_t> serverFrame(WsOpcode opcode, const std::string& payload, bool fin = true) {
+    std::vector<uint8_t> frame;
+    frame.push_back(static_cast<uint8_t>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode)));
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<uint8_t>(payload.size()));
+    } else {
+        frame.push_back(126);
+        frame.push_back(static_cast<uint8_t>(payload.size() >> 8));
+        frame.push_back(static_cast<uint8_t>(payload.size()));
+    }
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    return frame;
+}
+
+std::vector<uint8_t> packEnvelope(const std::string& method, const std::string& jsonPayload, bool asBin) {
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack_map(2);
+    packer.pack_str(6);
+    packer.pack_str_body("method", 6);
+    packer.pack_str(static_cast<uint32_t>(method.size()));
+    packer.pack_str_body(method.data(), static_cast<uint32_t>(method.size()));
+    packer.pack_str(7);
+    packer.pack_str_body("payload", 7);
+    if (asBin) {
+        packer.pack_bin(static_cast<uint32_t>(jsonPayload.size()));
+        packer.pack_bin_body(jsonPayload.data(), static_cast<uint32_t>(jsonPayload.size()));
+    } else {
+        packer.pack_str(static_cast<uint32_t>(jsonPayload.size()));
+        packer.pack_str_body(jsonPayload.data(), static_cast<uint32_t>(jsonPayload.size()));
+    }
+    return std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size());
+}
+
+std::vector<uint8_t> qosFrame(FrameType type, uint64_t messageId, const std::vector<uint8_t>& body = {}) {
+    std::vector<uint8_t> frame{static_cast<uint8_t>(type)};
+    for (int byte = 0; byte < 8; ++byte) {
+        frame.push_back(static_cast<uint8_t>(messageId >> (byte * 8)));
+    }
+    frame.insert(frame.end(), body.begin(), body.end());
+    return frame;
+}
+
+} // namespace
+
+TEST_CASE("WebSocket upgrade request and response", "[loadgen]") {
+    auto key = makeWebSocketKey(42);
+    REQUIRE(key.size() == 24);
+    REQUIRE(key.substr(22) == "==");
+    REQUIRE(makeWebSocketKey(42) == key);
+
+    auto request = buildUpgradeRequest("127.0.0.1", 8082, "/?clientId=a&token=t", key);
+    REQUIRE(request.rfind("GET /?clientId=a&token=t HTTP/1.1\r\n", 0) == 0);
+    REQUIRE(request.find("Host: 127.0.0.1:8082\r\n") != std::string::npos);
+    REQUIRE(request.find("Sec-WebSocket-Key: " + key + "\r\n") != std::string::npos);
+    REQUIRE(request.size() >= 4);
+    REQUIRE(request.substr(request.size() - 4) == "\r\n\r\n");
+
+    std::string response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n\r\n";
+    REQUIRE_FALSE(upgradeResponseLength(response.substr(0, 20)).has_value());
+    REQUIRE(upgradeResponseLength(response + "\x82\x00") == response.size());
+    REQUIRE(isUpgradeAccepted(response));
+    REQUIRE_FALSE(isUpgradeAccepted("HTTP/1.1 400 Bad Request\r\n\r\n"));
+}
+
+TEST_CASE("Client frames are masked with the right length encoding", "[loadgen]") {
+    for (size_t size : {size_t{0}, size_t{125}, size_t{126}, size_t{65535}, size_t{65536}}) {
+        std::vector<uint8_t> payload(size);
+        for (size_t i = 0; i < size; ++i) {
+            payload[i] = static_cast<uint8_t>(i * 7);
+        }
+        std::vector<uint8_t> frame;
+        appendClientFrame(frame, WsOpcode::BINARY, payload.data(), payload.size(), 0xA1B2C3D4);
+
+        REQUIRE(frame[0] == 0x82);
+        REQUIRE((frame[1] & 0x80) != 0);
+        size_t header = size < 126 ? 2 : size <= 0xFFFF ? 4 : 10;
+        REQUIRE(frame.size() == header + 4 + size);
+        const uint8_t* mask = frame.data() + header;
+        REQUIRE(mask[0] == 0xA1);
+        REQUIRE(mask[3] == 0xD4);
+        for (size_t i = 0; i < size; ++i) {
+            REQUIRE((frame[header + 4 + i] ^ mask[i & 3]) == payload[i]);
+        }
+
+        // The same bytes arriving from a server are a protocol violation
+        WsFrame decoded;
+        REQUIRE_FALSE(decodeServerFrame(frame.data(), frame.size(), decoded, 1 << 20).has_value());
+    }
+}
+
+TEST_CASE("Server frames decode incrementally", "[loadgen]") {
+    std::string large(300, 'x');
+    auto small = serverFrame(WsOpcode::BINARY, "hello");
+    auto extended = serverFrame(WsOpcode::BINARY, large);
+    std::vector<uint8_t> stream = small;
+    stream.insert(stream.end(), extended.begin(), extended.end());
+
+    WsFrame frame;
+    REQUIRE(decodeServerFrame(stream.data(), 1, frame, 1 << 20) == size_t{0});
+    REQUIRE(decodeServerFrame(stream.data(), small.size() - 1, frame, 1 << 20) == size_t{0});
+
+    auto used = decodeServerFrame(stream.data(), stream.size(), frame, 1 << 20);
+    REQUIRE(used == small.size());
+    REQUIRE(frame.opcode == WsOpcode::BINARY);
+    REQUIRE(std::string(reinterpret_cast<const char*>(frame.payload), frame.payloadSize) == "hello");
+
+    used = decodeServerFrame(stream.data() + small.size(), stream.size() - small.size(), frame, 1 << 20);
+    REQUIRE(used == extended.size());
+    REQUIRE(frame.payloadSize == large.size());
+
+    REQUIRE_FALSE(decodeServerFrame(extended.data(), extended.size(), frame, 100).has_value());
+    auto fragmentedPing = serverFrame(WsOpcode::PING, "p", false);
+    REQUIRE_FALSE(decodeServerFrame(fragmentedPing.data(), fragmentedPing.size(), frame, 1 << 20).has_value());
+}
+
+TEST_CASE("RPC requests are QoS data frames with a MsgPack envelope", "[loadgen]") {
+    nlohmann::json params = {{"symbol", "ETH-USD"}, {"qty", 1.5}, {"limit", 500}, {"symbols", {"A", "B"}}, {"flag", true}};
+    auto frame = encodeRequest(0x0102030405060708ULL, "orders.place", params);
+
+    REQUIRE(frame.size() > kQosHeaderSize);
+    REQUIRE(frame[0] == static_cast<uint8_t>(FrameType::DATA));
+    REQUIRE(frame[1] == 0x08);
+    REQUIRE(frame[8] == 0x01);
+
+    auto envelope = parseMsgPackPayload(std::vector<uint8_t>(frame.begin() + kQosHeaderSize, frame.end()));
+    REQUIRE(envelope["method"] == "orders.place");
+    REQUIRE(envelope["id"] == 0x0102030405060708LL);
+    REQUIRE(envelope["payload"]["symbol"] == "ETH-USD");
+    REQUIRE(envelope["payload"]["qty"] == 1.5);
+    REQUIRE(envelope["payload"]["limit"] == 500);
+    REQUIRE(envelope["payload"]["symbols"] == nlohmann::json::array({"A", "B"}));
+    REQUIRE(envelope["payload"]["flag"] == true);
+
+    std::vector<uint8_t> ack;
+    appendAck(ack, 7);
+    REQUIRE(ack == qosFrame(FrameType::ACK, 7));
+}
+
+TEST_CASE("Server messages decode from QoS frames and bare envelopes", "[loadgen]") {
+    SECTION("ACK frame") {
+        auto bytes = qosFrame(FrameType::ACK, 99);
+        auto message = decodeServerMessage(bytes.data(), bytes.size());
+        REQUIRE(message);
+        REQUIRE(message->kind == ServerMessage::Kind::ACK);
+        REQUIRE(message->messageId == 99);
+    }
+
+    SECTION("DATA frame with a JSON payload in a bin field") {
+        auto bytes = qosFrame(FrameType::DATA, 5, packEnvelope("market_data", R"({"symbol":"ETH-USD","timestamp":1718000000000})", true));
+        auto message = decodeServerMessage(bytes.data(), bytes.size());
+        REQUIRE(message);
+        REQUIRE(message->kind == ServerMessage::Kind::DATA);
+        REQUIRE(message->messageId == 5);
+        REQUIRE(message->method == "market_data");
+        REQUIRE(message->payload["timestamp"] == 1718000000000LL);
+    }
+
+    SECTION("Bare envelope with a JSON string payload") {
+        auto bytes = packEnvelope("orders.place", R"({"orderId":"ORD_1","qos":"AtLeastOnce - cached result"})", false);
+        auto message = decodeServerMessage(bytes.data(), bytes.size());
+        REQUIRE(message);
+        REQUIRE(message->kind == ServerMessage::Kind::PLAIN);
+        REQUIRE(message->method == "orders.place");
+        REQUIRE(message->payload["orderId"] == "ORD_1");
+    }
+
+    SECTION("DATA frame carrying bare JSON") {
+        std::string json = R"({"error":{"code":"INVALID_PARAMS","message":"Missing orderId"}})";
+        auto bytes = qosFrame(FrameType::DATA, 6, std::vector<uint8_t>(json.begin(), json.end()));
+        auto message = decodeServerMessage(bytes.data(), bytes.size());
+        REQUIRE(message);
+        REQUIRE(message->method.empty());
+        REQUIRE(message->payload["error"]["code"] == "INVALID_PARAMS");
+    }
+
+    SECTION("Garbage") {
+        std::vector<uint8_t> bytes{0xC1, 0x02};
+        REQUIRE_FALSE(decodeServerMessage(bytes.data(), bytes.size()).has_value());
+    }
+}
@@ -0,0 +1,35 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+#include "infrastructure/cache/lru_cache.hpp"
+
+using trading::infrastructure::cache::LruCache;
+
+TEST_CASE("LruCache evicts the least recently used entry", "[cache][lru]") {
+    LruCache<std::vector<int>> cache(2);
+    cache.put("a", {1});
+    cache.put("b", {2});
+
+    REQUIRE(cache.get("a") == std::vector<int>{1});  // "b" is now the oldest
+    cache.put("c", {3});
+
+    REQUIRE(cache.size() == 2);
+    REQUIRE_FALSE(cache.get("b").has_value());
+    REQUIRE(cache.get("a") == std::vector<int>{1});
+    REQUIRE(cache.get("c") == std::vector<int>{3});
+    REQUIRE(cache.hits() == 3);
+    REQUIRE(cache.misses() == 1);
+}
+
+TEST_CASE("LruCache replaces the value of a stored key", "[cache][lru]") {
+    LruCache<std::string> cache(2);
+    cache.put("a", "old");
+    cache.put("b", "kept");
+    cache.put("a", "new");  // Refreshes "a" without growing
+    cache.put("c", "added");
+
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.get("a") == "new");
+    REQUIRE_FALSE(cache.get("b").has_value());
+    REQUIRE(LruCache<int>(0).capacity() == 1);
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <thread>
+#include <vector>
+#include "infrastructure/metrics/latency_histogram.hpp"
+#include "infrastructure/metrics/metrics_collector.hpp"
+
+using namespace trading::infrastructure::metrics;
+using namespace trading::domain;
+
+TEST_CASE("LatencyHistogram - Bucket Math", "[metrics]") {
+    SECTION("Small values map to exact buckets") {
+        for (uint64_t v = 0; v < LatencyHistogram::kSubBucketCount; ++v) {
+            REQUIRE(LatencyHistogram::bucketIndex(v) == v);
+            REQUIRE(LatencyHistogram::bucketLowerBound(v) == v);
+        }
+    }
+
+    SECTION("Bucket indices are monotonic and contain their value") {
+        size_t lastIndex = 0;
+        for (uint64_t v = 1; v < (1ULL << 30); v = v * 3 / 2 + 1) {
+            size_t index = LatencyHistogram::bucketIndex(v);
+            REQUIRE(index >= lastIndex);
+            REQUIRE(LatencyHistogram::bucketLowerBound(index) <= v);
+            lastIndex = index;
+        }
+    }
+
+    SECTION("Huge values are clamped to the last bucket") {
+        REQUIRE(LatencyHistogram::bucketIndex(UINT64_MAX) == LatencyHistogram::kBucketCount - 1);
+    }
+}
+
+TEST_CASE("LatencyHistogram - Percentiles", "[metrics]") {
+    LatencyHistogram histogram;
+
+    SECTION("Empty histogram reports zero") {
+        REQUIRE(histogram.count() == 0);
+        REQUIRE(histogram.valueAtPercentile(99.0) == 0);
+    }
+
+    SECTION("Uniform distribution percentiles are within bucket error") {
+        // 1..10000 microseconds
+        for (uint64_t us = 1; us <= 10000; ++us) {
+            histogram.record(us * 1000);
+        }
+
+        REQUIRE(histogram.count() == 10000);
+        auto p50 = static_cast<double>(histogram.valueAtPercentile(50.0));
+        auto p99 = static_cast<double>(histogram.valueAtPercentile(99.0));
+        REQUIRE(p50 > 5'000'000 * 0.93);
+        REQUIRE(p50 < 5'000'000 * 1.07);
+        REQUIRE(p99 > 9'900'000 * 0.93);
+        REQUIRE(p99 < 9'900'000 * 1.07);
+        REQUIRE(histogram.maxNs() == 10'000'000);
+    }
+
+    SECTION("Snapshot converts to milliseconds") {
+        histogram.record(2'000'000);
+        auto stats = histogram.snapshot();
+        REQUIRE(stats.count == 1);
+        REQUIRE(stats.meanMs == 2.0);
+        REQUIRE(stats.maxMs == 2.0);
+        REQUIRE(stats.p999Ms <= 2.0);
+        REQUIRE(stats.p50Ms > 1.9);
+    }
+
+    SECTION("Concurrent recording loses no samples") {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&histogram] {
+                for (int i = 0; i < 10000; ++i) {
+                    histogram.record(1000 + i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(histogram.count() == 80000);
+    }
+}
+
+TEST_CASE("MetricsCollector - Per-Method Stats", "[metrics]") {
+    MetricsCollector collector({"orders.place", "history.query"});
+
+    SECTION("Requests are attributed to their method") {
+        collector.recordRequest("orders.place", 1.0, 0.1, 0.05);
+        collector.recordRequest("orders.place", 3.0, 0.1, 0.05);
+        collector.recordRequest("history.query", 20.0, 0.2, 0.5);
+
+        auto methods = collector.collectMethods();
+        REQUIRE(methods.size() == 2);
+        REQUIRE(methods[0].method == "history.query");
+        REQUIRE(methods[0].service.count == 1);
+        REQUIRE(methods[1].method == "orders.place");
+        REQUIRE(methods[1].service.count == 2);
+        REQUIRE(methods[1].service.maxMs == 3.0);
+        REQUIRE(methods[1].throughput > 0.0);
+    }
+
+    SECTION("Unknown methods are grouped under other") {
+        collector.recordRequest("debug.ping", 1.0, 0.0, 0.0);
+
+        auto methods = collector.collectMethods();
+        REQUIRE(methods.size() == 1);
+        REQUIRE(methods[0].method == "other");
+    }
+
+    SECTION("Collect reports overall latency and error rate") {
+        collector.recordRequest("orders.place", 1.0, 0.5, 0.5);
+        collector.recordRequest("orders.place", 1.0, 0.5, 0.5);
+        collector.recordError();
+
+        auto metrics = collector.collect();
+        REQUIRE(metrics.latency.count == 2);
+        REQUIRE(metrics.latencyMs == 2.0);
+        REQUIRE(metrics.errorRate == 0.5);
+    }
+
+    SECTION("Connection gauge follows connect/disconnect") {
+        collector.recordConnection();
+        collector.recordConnection();
+        collector.recordDisconnection();
+        REQUIRE(collector.collect().connCount == 1);
+    }
+}
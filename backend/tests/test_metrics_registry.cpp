@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <thread>
+#include <vector>
+#include "infrastructure/metrics/metrics_registry.hpp"
+
+using namespace trading::infrastructure::metrics;
+
+namespace {
+
+constexpr int kContentionThreads = 16;
+
+} // namespace
+
+TEST_CASE("ShardedCounter - Aggregation", "[metrics]") {
+    ShardedCounter counter;
+
+    SECTION("Starts at zero and aggregates increments") {
+        REQUIRE(counter.value() == 0);
+        counter.increment();
+        counter.add(41);
+        REQUIRE(counter.value() == 42);
+    }
+
+    SECTION("Works as an up/down gauge") {
+        counter.increment();
+        counter.increment();
+        counter.decrement();
+        REQUIRE(counter.value() == 1);
+    }
+
+    SECTION("Holds values beyond 32 bits") {
+        counter.add(int64_t{1} << 40);
+        counter.add(int64_t{1} << 40);
+        REQUIRE(counter.value() == (int64_t{1} << 41));
+    }
+
+    SECTION("Concurrent increments from many threads are not lost") {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kContentionThreads; ++t) {
+            threads.emplace_back([&counter] {
+                for (int i = 0; i < 10000; ++i) {
+                    counter.increment();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(counter.value() == kContentionThreads * 10000);
+    }
+
+    SECTION("Reset clears every cell") {
+        counter.add(5);
+        counter.reset();
+        REQUIRE(counter.value() == 0);
+    }
+}
+
+TEST_CASE("MetricsRegistry - Labeled Series", "[metrics]") {
+    MetricsRegistry registry;
+
+    SECTION("Same name and labels resolve to the same series") {
+        auto& a = registry.counter("orders_placed_total", {{"symbol", "BTC-USD"}});
+        auto& b = registry.counter("orders_placed_total", {{"symbol", "BTC-USD"}});
+        REQUIRE(&a == &b);
+    }
+
+    SECTION("Total sums across label sets") {
+        registry.counter("orders_placed_total", {{"symbol", "BTC-USD"}}).add(3);
+        registry.counter("orders_placed_total", {{"symbol", "ETH-USD"}}).add(2);
+        registry.counter("orders_cancelled_total").add(7);
+
+        REQUIRE(registry.total("orders_placed_total") == 5);
+        REQUIRE(registry.total("orders_cancelled_total") == 7);
+        REQUIRE(registry.total("missing") == 0);
+    }
+
+    SECTION("Snapshot is sorted by name then labels") {
+        registry.counter("b_total").increment();
+        registry.counter("a_total", {{"k", "2"}}).increment();
+        registry.counter("a_total", {{"k", "1"}}).increment();
+
+        auto samples = registry.snapshot();
+        REQUIRE(samples.size() == 3);
+        REQUIRE(samples[0].name == "a_total");
+        REQUIRE(samples[0].labels.at("k") == "1");
+        REQUIRE(samples[1].labels.at("k") == "2");
+        REQUIRE(samples[2].name == "b_total");
+    }
+
+    SECTION("Counter family falls back to other") {
+        CounterFamily family(registry, "rpc_errors_total", "method", {"orders.place"});
+        family["orders.place"].increment();
+        family["unknown.method"].increment();
+        family["another.method"].increment();
+
+        REQUIRE(registry.counter("rpc_errors_total", {{"method", "orders.place"}}).value() == 1);
+        REQUIRE(registry.counter("rpc_errors_total", {{"method", "other"}}).value() == 2);
+        REQUIRE(registry.total("rpc_errors_total") == 3);
+    }
+}
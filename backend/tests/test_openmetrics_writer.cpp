@@ -0,0 +1,260 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "infrastructure/metrics/openmetrics_writer.hpp"
+#include "interfaces/metrics_http_server.hpp"
+
+using namespace trading::infrastructure::metrics;
+using Catch::Matchers::ContainsSubstring;
+using Catch::Matchers::EndsWith;
+using Catch::Matchers::StartsWith;
+
+namespace {
+
+std::vector<std::string> lines(std::string_view text) {
+    std::vector<std::string> result;
+    std::istringstream stream{std::string(text)};
+    std::string line;
+    while (std::getline(stream, line)) {
+        result.push_back(line);
+    }
+    return result;
+}
+
+// Value of the first sample line starting with the given name and labels
+std::string sampleValue(std::string_view text, const std::string& series) {
+    for (const auto& line : lines(text)) {
+        if (line.rfind(series + " ", 0) == 0) {
+            return line.substr(series.size() + 1);
+        }
+    }
+    return "";
+}
+
+int connectTo(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+std::string scrape(int port, const std::string& request) {
+    int fd = connectTo(port);
+    if (fd < 0) {
+        return "";
+    }
+    ::send(fd, request.data(), request.size(), 0);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return response;
+}
+
+} // namespace
+
+TEST_CASE("OpenMetricsWriter formats families and samples", "[openmetrics]") {
+    OpenMetricsWriter out("bull_");
+    out.family("orders_placed", "counter", "Orders accepted");
+    out.sample("orders_placed_total", {{"symbol", "ETH-USD"}}, int64_t{42});
+    out.family("uptime_seconds", "gauge", "");
+    out.sample("uptime_seconds", {}, 1.5);
+    auto text = out.finish();
+
+    auto all = lines(text);
+    REQUIRE(all.size() == 6);
+    REQUIRE(all[0] == "# TYPE bull_orders_placed counter");
+    REQUIRE(all[1] == "# HELP bull_orders_placed Orders accepted");
+    REQUIRE(all[2] == "bull_orders_placed_total{symbol=\"ETH-USD\"} 42");
+    REQUIRE(all[3] == "# TYPE bull_uptime_seconds gauge");
+    REQUIRE(all[4] == "bull_uptime_seconds 1.5");
+    REQUIRE(all[5] == "# EOF");
+}
+
+TEST_CASE("OpenMetricsWriter escapes label values and formats special numbers", "[openmetrics]") {
+    OpenMetricsWriter out;
+    out.sample("m", {{"path", "a\\b\"c\nd"}}, 1.0);
+    out.sample("nan", {}, std::nan(""));
+    out.sample("inf", {}, 1.0 / 0.0);
+    out.sample("big", {}, uint64_t{18446744073709551615ull});
+    auto all = lines(out.finish());
+
+    REQUIRE(all[0] == "m{path=\"a\\\\b\\\"c\\nd\"} 1");
+    REQUIRE(all[1] == "nan NaN");
+    REQUIRE(all[2] == "inf +Inf");
+    REQUIRE(all[3] == "big 18446744073709551615");
+}
+
+TEST_CASE("OpenMetricsWriter accepts registry labels", "[openmetrics]") {
+    MetricsRegistry registry;
+    registry.counter("orders_rejected_total", {{"reason", "risk"}}).add(3);
+    registry.counter("orders_rejected_total", {{"reason", "rate_limit"}}).add(1);
+    registry.counter("alerts_suppressed_total").add(2);
+
+    OpenMetricsWriter out;
+    std::vector<std::string> names;
+    registry.visit([&](const std::string& name, const Labels& labels, int64_t value) {
+        names.push_back(name);
+        out.sample(name, labels, value);
+    });
+
+    // Grouped by name in name order, so each family's samples are contiguous
+    REQUIRE(names == std::vector<std::string>{"alerts_suppressed_total", "orders_rejected_total", "orders_rejected_total"});
+    auto text = out.finish();
+    REQUIRE(sampleValue(text, "orders_rejected_total{reason=\"risk\"}") == "3");
+    REQUIRE(sampleValue(text, "orders_rejected_total{reason=\"rate_limit\"}") == "1");
+    REQUIRE(sampleValue(text, "alerts_suppressed_total") == "2");
+}
+
+TEST_CASE("OpenMetricsWriter renders cumulative latency histograms", "[openmetrics]") {
+    LatencyHistogram histogram;
+    histogram.record(20'000);          // 20us, below every bound
+    histogram.record(700'000);         // 0.7ms
+    histogram.record(3'000'000);       // 3ms
+    histogram.record(30'000'000'000);  // 30s, only in +Inf
+
+    OpenMetricsWriter out;
+    out.family("rpc_service_seconds", "histogram", "");
+    out.latencyHistogram("rpc_service_seconds", {{"method", "orders.place"}}, histogram);
+    auto text = out.finish();
+
+    auto bucket = [&](const std::string& le) {
+        return sampleValue(text, "rpc_service_seconds_bucket{method=\"orders.place\",le=\"" + le + "\"}");
+    };
+    REQUIRE(bucket("0.00005") == "1");
+    REQUIRE(bucket("0.0005") == "1");
+    REQUIRE(bucket("0.001") == "2");
+    REQUIRE(bucket("0.005") == "3");
+    REQUIRE(bucket("10.0") == "3");
+    REQUIRE(bucket("+Inf") == "4");
+    REQUIRE(sampleValue(text, "rpc_service_seconds_count{method=\"orders.place\"}") == "4");
+    REQUIRE_THAT(sampleValue(text, "rpc_service_seconds_sum{method=\"orders.place\"}"), StartsWith("30.00"));
+
+    // Bucket counts never decrease
+    uint64_t previous = 0;
+    size_t buckets = 0;
+    for (const auto& line : lines(text)) {
+        if (line.rfind("rpc_service_seconds_bucket", 0) == 0) {
+            uint64_t count = std::stoull(line.substr(line.rfind(' ') + 1));
+            REQUIRE(count >= previous);
+            previous = count;
+            ++buckets;
+        }
+    }
+    REQUIRE(buckets == OpenMetricsWriter::kLatencyBucketCount + 1);
+}
+
+TEST_CASE("OpenMetricsWriter reuses its buffer across scrapes", "[openmetrics]") {
+    OpenMetricsWriter out;
+    out.sample("a", {}, int64_t{1});
+    std::string first(out.finish());
+
+    out.clear();
+    out.sample("a", {}, int64_t{1});
+    REQUIRE(out.finish() == first);
+    REQUIRE_THAT(std::string(out.text()), EndsWith("# EOF\n"));
+}
+
+TEST_CASE("MetricsHttpServer serves GET /metrics", "[openmetrics]") {
+    int scrapes = 0;
+    trading::interfaces::MetricsHttpServer server("127.0.0.1", 0, "bull_", [&](OpenMetricsWriter& out) {
+        ++scrapes;
+        out.family("scrapes", "counter", "");
+        out.sample("scrapes_total", {}, int64_t{scrapes});
+    });
+    REQUIRE(server.start());
+    REQUIRE(server.port() > 0);
+
+    auto response = scrape(server.port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    REQUIRE_THAT(response, StartsWith("HTTP/1.1 200 OK"));
+    REQUIRE_THAT(response, ContainsSubstring("Content-Type: application/openmetrics-text"));
+    REQUIRE_THAT(response, ContainsSubstring("bull_scrapes_total 1\n"));
+    REQUIRE_THAT(response, EndsWith("# EOF\n"));
+
+    REQUIRE_THAT(scrape(server.port(), "GET /other HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 404"));
+    REQUIRE_THAT(scrape(server.port(), "POST /metrics HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 405"));
+    REQUIRE_THAT(scrape(server.port(), "garbage\r\n\r\n"), StartsWith("HTTP/1.1 400"));
+
+    server.stop();
+    REQUIRE(scrapes == 1);
+}
+
+TEST_CASE("MetricsHttpServer answers GET /ready from the readiness check", "[openmetrics]") {
+    std::atomic<bool> warm{false};
+    trading::interfaces::MetricsHttpServer server("127.0.0.1", 0, "bull_", [](OpenMetricsWriter&) {}, [&] { return warm.load(); });
+    REQUIRE(server.start());
+
+    auto response = scrape(server.port(), "GET /ready HTTP/1.1\r\n\r\n");
+    REQUIRE_THAT(response, StartsWith("HTTP/1.1 503"));
+    REQUIRE_THAT(response, EndsWith("warming up\n"));
+
+    warm = true;
+    REQUIRE_THAT(scrape(server.port(), "GET /ready HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 200 OK"));
+    REQUIRE_THAT(scrape(server.port(), "POST /ready HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 405"));
+    server.stop();
+
+    // Without a readiness check the server is ready as soon as it listens
+    trading::interfaces::MetricsHttpServer unchecked("127.0.0.1", 0, "bull_", [](OpenMetricsWriter&) {});
+    REQUIRE(unchecked.start());
+    REQUIRE_THAT(scrape(unchecked.port(), "GET /ready HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 200 OK"));
+}
+
+TEST_CASE("MetricsHttpServer keeps serving while a client stalls", "[openmetrics]") {
+    trading::interfaces::MetricsHttpServer server("127.0.0.1", 0, "bull_", [](OpenMetricsWriter&) {});
+    REQUIRE(server.start());
+
+    // A client trickling a partial request does not hold up other scrapes
+    int slow = connectTo(server.port());
+    REQUIRE(slow >= 0);
+    ::send(slow, "GET /met", 8, 0);
+    auto started = std::chrono::steady_clock::now();
+    REQUIRE_THAT(scrape(server.port(), "GET /ready HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 200 OK"));
+    REQUIRE(std::chrono::steady_clock::now() - started < std::chrono::seconds(1));
+
+    // ...and is dropped at the request deadline however it keeps sending
+    ::send(slow, "r", 1, 0);
+    timeval timeout{5, 0};
+    ::setsockopt(slow, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char byte;
+    REQUIRE(::recv(slow, &byte, 1, 0) == 0);
+    REQUIRE(std::chrono::steady_clock::now() - started < std::chrono::seconds(4));
+    ::close(slow);
+}
+
+TEST_CASE("MetricsHttpServer runs operator commands on POST", "[openmetrics]") {
+    int runs = 0;
+    trading::interfaces::MetricsHttpServer server("127.0.0.1", 0, "bull_", [](OpenMetricsWriter&) {});
+    server.addCommand("/trace/clear", [&] {
+        ++runs;
+        return std::string("cleared\n");
+    });
+    REQUIRE(server.start());
+
+    auto response = scrape(server.port(), "POST /trace/clear HTTP/1.1\r\n\r\n");
+    REQUIRE_THAT(response, StartsWith("HTTP/1.1 200 OK"));
+    REQUIRE_THAT(response, EndsWith("cleared\n"));
+    REQUIRE_THAT(scrape(server.port(), "GET /trace/clear HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 405"));
+    REQUIRE_THAT(scrape(server.port(), "POST /trace/other HTTP/1.1\r\n\r\n"), StartsWith("HTTP/1.1 404"));
+    server.stop();
+    REQUIRE(runs == 1);
+}
@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "infrastructure/database/order_event_queue.hpp"
+
+using trading::infrastructure::database::OrderEvent;
+using trading::infrastructure::database::OrderEventQueue;
+using trading::infrastructure::database::kRecentOrders;
+using namespace std::chrono_literals;
+
+namespace {
+
+OrderEvent placed(const std::string& orderId, int64_t placedAtMs) {
+    OrderEvent event;
+    event.orderId = orderId;
+    event.status = "ACK";
+    event.symbol = "BTC-USD";
+    event.side = "BUY";
+    event.type = "LIMIT";
+    event.quantity = 2.0;
+    event.price = 45000.0;
+    event.placedAtMs = placedAtMs;
+    event.tsMs = placedAtMs;
+    return event;
+}
+
+std::vector<std::string> orderIds(const std::vector<OrderEvent>& batch) {
+    std::vector<std::string> ids;
+    for (const auto& event : batch) {
+        ids.push_back(event.orderId);
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST_CASE("A cancellation before the writer flushes finds the placement", "[clickhouse][order_queue]") {
+    OrderEventQueue queue;
+    queue.push(placed("ORD_1", 1'718'000'000'123));
+    REQUIRE(queue.size() == 1);
+
+    // Still queued: order_events has no row for it yet
+    auto original = queue.recent("ORD_1");
+    REQUIRE(original.has_value());
+    REQUIRE(original->placedAtMs == 1'718'000'000'123);
+    REQUIRE(original->symbol == "BTC-USD");
+    REQUIRE_FALSE(queue.recent("ORD_2").has_value());
+
+    OrderEvent cancel = *original;
+    cancel.eventType = "CANCEL";
+    cancel.status = "CANCELLED";
+    cancel.tsMs = 1'718'000'000'500;
+    queue.push(cancel);
+
+    // The writer takes both; the latest event stays visible afterwards
+    std::vector<OrderEvent> batch;
+    REQUIRE(queue.waitBatch(batch, 10));
+    REQUIRE(batch.size() == 2);
+    REQUIRE(batch[1].placedAtMs == batch[0].placedAtMs);
+    REQUIRE(queue.size() == 0);
+    REQUIRE(queue.recent("ORD_1")->status == "CANCELLED");
+    REQUIRE(queue.recent("ORD_1")->placedAtMs == 1'718'000'000'123);
+}
+
+TEST_CASE("Recent orders are bounded", "[clickhouse][order_queue]") {
+    OrderEventQueue queue(2);
+    queue.push(placed("ORD_1", 1));
+    queue.push(placed("ORD_2", 2));
+    queue.push(placed("ORD_3", 3));
+    REQUIRE_FALSE(queue.recent("ORD_1").has_value());
+    REQUIRE(queue.recent("ORD_3").has_value());
+    // Queued events are not bounded by it
+    REQUIRE(queue.size() == 3);
+}
+
+TEST_CASE("A failed batch is retried ahead of newer events after its delay", "[clickhouse][order_queue]") {
+    OrderEventQueue queue;
+    for (int i = 1; i <= 3; ++i) {
+        queue.push(placed("ORD_" + std::to_string(i), i));
+    }
+    std::vector<OrderEvent> batch;
+    REQUIRE(queue.waitBatch(batch, 2));
+    REQUIRE(orderIds(batch) == std::vector<std::string>{"ORD_1", "ORD_2"});
+
+    auto retryAt = OrderEventQueue::Clock::now() + 50ms;
+    queue.requeue(std::move(batch), retryAt);
+    queue.push(placed("ORD_4", 4));
+
+    batch.clear();
+    REQUIRE(queue.waitBatch(batch, 10));
+    REQUIRE(OrderEventQueue::Clock::now() >= retryAt);
+    REQUIRE(orderIds(batch) == std::vector<std::string>{"ORD_1", "ORD_2", "ORD_3", "ORD_4"});
+}
+
+TEST_CASE("Closing drains the queue without waiting for a retry", "[clickhouse][order_queue]") {
+    OrderEventQueue queue;
+    queue.requeue({placed("ORD_1", 1)}, OrderEventQueue::Clock::now() + 1h);
+
+    std::vector<OrderEvent> batch;
+    std::thread writer([&] {
+        while (queue.waitBatch(batch, 10)) {
+        }
+    });
+    std::this_thread::sleep_for(20ms);
+    queue.close();
+    writer.join();
+    REQUIRE(orderIds(batch) == std::vector<std::string>{"ORD_1"});
+    REQUIRE_FALSE(queue.waitBatch(batch, 10));
+}
+
+TEST_CASE("A held queue keeps events until it is released", "[clickhouse][order_queue]") {
+    OrderEventQueue queue(kRecentOrders, true);
+    queue.push(placed("ORD_1", 1));
+
+    std::vector<OrderEvent> batch;
+    std::thread writer([&] { queue.waitBatch(batch, 10); });
+    std::this_thread::sleep_for(20ms);
+    // Queued, and found by a cancellation, but not handed to the writer
+    REQUIRE(queue.size() == 1);
+    REQUIRE(queue.recent("ORD_1").has_value());
+    REQUIRE(queue.held());
+
+    queue.release();
+    writer.join();
+    REQUIRE(orderIds(batch) == std::vector<std::string>{"ORD_1"});
+    REQUIRE_FALSE(queue.held());
+}
+
+TEST_CASE("A held queue drops its oldest events past the cap", "[clickhouse][order_queue]") {
+    OrderEventQueue queue(kRecentOrders, true, 2);
+    for (int i = 1; i <= 5; ++i) {
+        queue.push(placed("ORD_" + std::to_string(i), i));
+    }
+    REQUIRE(queue.size() == 2);
+    REQUIRE(queue.dropped() == 3);
+    // Dropped from the writer's backlog, still known to a cancellation
+    REQUIRE(queue.recent("ORD_1").has_value());
+
+    queue.release();
+    std::vector<OrderEvent> batch;
+    REQUIRE(queue.waitBatch(batch, 10));
+    REQUIRE(orderIds(batch) == std::vector<std::string>{"ORD_4", "ORD_5"});
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "application/price_alert_index.hpp"
+
+using namespace trading::application;
+using namespace trading::domain;
+
+namespace {
+
+PriceAlert moveAlert(const std::string& id, PriceAlertKind kind, double percent, int64_t windowMs) {
+    PriceAlert alert(id, "session-1", "ETH-USD", kind, 0.0);
+    alert.movePercent = percent;
+    alert.windowMs = windowMs;
+    return alert;
+}
+
+std::vector<std::string> firedIds(const std::vector<PriceAlertEvent>& events) {
+    std::vector<std::string> ids;
+    for (const auto& event : events) {
+        ids.push_back(event.alertId);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // namespace
+
+TEST_CASE("PriceAlertIndex - Level Alerts", "[alerts][price]") {
+    PriceAlertIndex index;
+    index.add(PriceAlert("up-50k", "session-1", "BTC-USD", PriceAlertKind::ABOVE, 50000.0));
+    index.add(PriceAlert("up-52k", "session-2", "BTC-USD", PriceAlertKind::ABOVE, 52000.0));
+    index.add(PriceAlert("down-40k", "session-1", "BTC-USD", PriceAlertKind::BELOW, 40000.0));
+    index.add(PriceAlert("eth-up", "session-1", "ETH-USD", PriceAlertKind::ABOVE, 1000.0));
+
+    SECTION("Ticks between the nearest levels fire nothing") {
+        REQUIRE(index.onTick("BTC-USD", 1, 45000.0).empty());
+        REQUIRE(index.size() == 4);
+    }
+
+    SECTION("Crossing fires every level passed, once") {
+        auto events = index.onTick("BTC-USD", 1, 53000.0);
+        REQUIRE(firedIds(events) == std::vector<std::string>{"up-50k", "up-52k"});
+        REQUIRE(events[0].kind == PriceAlertKind::ABOVE);
+        REQUIRE(events[0].price == 53000.0);
+        REQUIRE(index.onTick("BTC-USD", 2, 54000.0).empty());
+
+        auto down = index.onTick("BTC-USD", 3, 40000.0);
+        REQUIRE(firedIds(down) == std::vector<std::string>{"down-40k"});
+        REQUIRE(down[0].ownerId == "session-1");
+        REQUIRE(down[0].trigger == 40000.0);
+        REQUIRE(index.size() == 1);
+    }
+
+    SECTION("Symbols are independent") {
+        REQUIRE(index.onTick("SOL-USD", 1, 100000.0).empty());
+        REQUIRE(firedIds(index.onTick("ETH-USD", 1, 1000.0)) == std::vector<std::string>{"eth-up"});
+    }
+
+    SECTION("Cancelled alerts never fire") {
+        REQUIRE_FALSE(index.cancel("up-50k", "session-2"));
+        REQUIRE(index.cancel("up-50k", "session-1"));
+        REQUIRE_FALSE(index.cancel("up-50k", "session-1"));
+        REQUIRE(index.cancelOwner("session-1") == 2);
+        REQUIRE(firedIds(index.onTick("BTC-USD", 1, 60000.0)) == std::vector<std::string>{"up-52k"});
+        REQUIRE(index.size() == 0);
+    }
+
+    SECTION("Freed slots are reused by new alerts") {
+        index.onTick("BTC-USD", 1, 53000.0);
+        index.add(PriceAlert("up-55k", "session-3", "BTC-USD", PriceAlertKind::ABOVE, 55000.0));
+        REQUIRE(index.alertsFor("session-3").size() == 1);
+        REQUIRE(firedIds(index.onTick("BTC-USD", 2, 55000.0)) == std::vector<std::string>{"up-55k"});
+    }
+}
+
+TEST_CASE("PriceAlertIndex - Registration", "[alerts][price]") {
+    PriceAlertIndex index;
+
+    SECTION("Cross resolves against the last price") {
+        REQUIRE_THROWS_AS(index.add(PriceAlert("x", "s", "BTC-USD", PriceAlertKind::CROSS, 50000.0)),
+                          std::invalid_argument);
+        index.onTick("BTC-USD", 1, 45000.0);
+        REQUIRE(index.add(PriceAlert("x", "s", "BTC-USD", PriceAlertKind::CROSS, 50000.0)) == PriceAlertKind::ABOVE);
+        REQUIRE(index.add(PriceAlert("y", "s", "BTC-USD", PriceAlertKind::CROSS, 44000.0)) == PriceAlertKind::BELOW);
+        REQUIRE(index.alertsFor("s").size() == 2);
+    }
+
+    SECTION("Invalid alerts are rejected") {
+        REQUIRE_THROWS_AS(index.add(PriceAlert("a", "s", "BTC-USD", PriceAlertKind::ABOVE, -1.0)), std::invalid_argument);
+        REQUIRE_THROWS_AS(index.add(moveAlert("b", PriceAlertKind::MOVE, 2.0, 0)), std::invalid_argument);
+        REQUIRE_THROWS_AS(index.add(moveAlert("b", PriceAlertKind::MOVE, 2.0, 61000)), std::invalid_argument);
+        index.add(PriceAlert("c", "s", "BTC-USD", PriceAlertKind::ABOVE, 1.0));
+        REQUIRE_THROWS_AS(index.add(PriceAlert("c", "s", "BTC-USD", PriceAlertKind::BELOW, 1.0)), std::invalid_argument);
+        REQUIRE(index.size() == 1);
+    }
+
+    SECTION("Each owner holds a bounded number of alerts") {
+        PriceAlertIndex capped(2);
+        capped.add(PriceAlert("a", "s", "BTC-USD", PriceAlertKind::ABOVE, 50000.0));
+        capped.add(PriceAlert("b", "s", "BTC-USD", PriceAlertKind::BELOW, 40000.0));
+        REQUIRE_THROWS_AS(capped.add(PriceAlert("c", "s", "BTC-USD", PriceAlertKind::BELOW, 1.0)), std::length_error);
+        capped.add(PriceAlert("c", "other", "BTC-USD", PriceAlertKind::BELOW, 1.0));
+
+        // Fired and cancelled alerts free their owner's room
+        capped.onTick("BTC-USD", 1, 51000.0);
+        capped.add(PriceAlert("d", "s", "BTC-USD", PriceAlertKind::BELOW, 1.0));
+        REQUIRE(capped.cancelOwner("s") == 2);
+        REQUIRE(capped.size() == 1);
+    }
+
+    SECTION("Kind names round-trip") {
+        for (auto kind : {PriceAlertKind::ABOVE, PriceAlertKind::CROSS, PriceAlertKind::MOVE_DOWN}) {
+            REQUIRE(PriceAlertIndex::parseKind(PriceAlertIndex::kindName(kind)) == kind);
+        }
+        REQUIRE_FALSE(PriceAlertIndex::parseKind("sideways"));
+    }
+}
+
+TEST_CASE("PriceAlertIndex - Move Alerts", "[alerts][price]") {
+    PriceAlertIndex index;
+    index.add(moveAlert("up-2", PriceAlertKind::MOVE_UP, 2.0, 60000));
+    index.add(moveAlert("down-2", PriceAlertKind::MOVE_DOWN, 2.0, 60000));
+
+    SECTION("Rise from the window low fires the up alert") {
+        REQUIRE(index.onTick("ETH-USD", 0, 100.0).empty());
+        REQUIRE(index.onTick("ETH-USD", 10000, 99.0).empty());
+        auto events = index.onTick("ETH-USD", 20000, 101.0);
+        REQUIRE(firedIds(events) == std::vector<std::string>{"up-2"});
+        REQUIRE(events[0].kind == PriceAlertKind::MOVE_UP);
+        REQUIRE_THAT(events[0].movePercent, Catch::Matchers::WithinRel(2.0202, 1e-3));
+    }
+
+    SECTION("Moves spread over more than the window do not fire") {
+        index.onTick("ETH-USD", 0, 100.0);
+        index.onTick("ETH-USD", 50000, 101.0);
+        REQUIRE(index.onTick("ETH-USD", 100000, 101.9).empty());
+        REQUIRE(firedIds(index.onTick("ETH-USD", 105000, 99.5)) == std::vector<std::string>{"down-2"});
+    }
+
+    SECTION("Either-direction alerts fire once") {
+        index.add(moveAlert("any-1", PriceAlertKind::MOVE, 1.0, 60000));
+        index.onTick("ETH-USD", 0, 100.0);
+        REQUIRE(firedIds(index.onTick("ETH-USD", 1000, 98.9)) == std::vector<std::string>{"any-1"});
+        REQUIRE(index.onTick("ETH-USD", 2000, 100.0).empty());
+        REQUIRE(index.size() == 2);
+    }
+}
@@ -0,0 +1,38 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include "infrastructure/metrics/startup_tracker.hpp"
+
+using namespace trading::infrastructure::metrics;
+using namespace std::chrono_literals;
+
+TEST_CASE("StartupTracker records the time to each milestone once", "[startup]") {
+    StartupTracker::Clock::time_point started{};
+    StartupTracker tracker(started);
+
+    REQUIRE_FALSE(tracker.reached(StartupMilestone::LISTENING));
+    REQUIRE_FALSE(tracker.elapsed(StartupMilestone::LISTENING).has_value());
+
+    REQUIRE(tracker.mark(StartupMilestone::LISTENING, started + 12ms));
+    REQUIRE(tracker.mark(StartupMilestone::FIRST_CONNECTION, started + 40ms));
+    // Later connections do not move the first one
+    REQUIRE_FALSE(tracker.mark(StartupMilestone::FIRST_CONNECTION, started + 90ms));
+
+    REQUIRE(tracker.elapsed(StartupMilestone::LISTENING) == 12ms);
+    REQUIRE(tracker.elapsed(StartupMilestone::FIRST_CONNECTION) == 40ms);
+    REQUIRE_FALSE(tracker.reached(StartupMilestone::SCHEMA_READY));
+    REQUIRE(startupMilestoneName(StartupMilestone::FIRST_CONNECTION) == "first_connection");
+}
+
+TEST_CASE("StartupTracker is ready once warm", "[startup]") {
+    StartupTracker::Clock::time_point started{};
+    StartupTracker tracker(started);
+
+    tracker.mark(StartupMilestone::LISTENING, started + 5ms);
+    tracker.mark(StartupMilestone::SCHEMA_READY, started + 300ms);
+    tracker.mark(StartupMilestone::BACKFILLED, started + 2s);
+    REQUIRE_FALSE(tracker.ready());
+
+    tracker.mark(StartupMilestone::WARM, started + 2500ms);
+    REQUIRE(tracker.ready());
+    REQUIRE(tracker.elapsed(StartupMilestone::WARM) == 2500ms);
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "infrastructure/marketdata/tick_capture.hpp"
+#include "infrastructure/marketdata/tick_replayer.hpp"
+
+using namespace trading::infrastructure::marketdata;
+using trading::domain::Symbol;
+using trading::domain::Tick;
+
+namespace {
+
+std::string capturePath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() /
+            ("bull_" + name + "_" + std::to_string(::getpid()) + ".ticks")).string();
+}
+
+// Ticks 100 ms apart alternating between two symbols
+void writeCapture(const std::string& path, int ticks) {
+    TickCaptureWriter writer;
+    REQUIRE(writer.open(path));
+    for (int i = 0; i < ticks; ++i) {
+        double price = 100.0 + i;
+        REQUIRE(writer.append(i % 2 == 0 ? "ETH-USD" : "BTC-USD", Tick(1'000'000 + i * 100, price - 0.5, price + 0.5, price, 10 + i)));
+    }
+    writer.close();
+}
+
+struct Replayed {
+    std::string symbol;
+    Tick tick;
+};
+
+} // namespace
+
+TEST_CASE("Tick capture round trips through the mmap reader", "[marketdata]") {
+    auto path = capturePath("roundtrip");
+    writeCapture(path, 3000);  // Spans several write blocks
+
+    TickCaptureReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.size() == 3000);
+    REQUIRE(reader.symbols() == std::vector<std::string>{"ETH-USD", "BTC-USD"});
+    REQUIRE(std::filesystem::file_size(path) == kTickCaptureHeaderSize + 3000 * sizeof(TickRecord));
+
+    const TickRecord& record = reader[1501];
+    REQUIRE(reader.symbol(record) == "BTC-USD");
+    REQUIRE(record.ts == 1'000'000 + 1501 * 100);
+    REQUIRE(record.bid == 1600.5);
+    REQUIRE(record.ask == 1601.5);
+    REQUIRE(record.last == 1601.0);
+    REQUIRE(record.volume == 1511);
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Tick capture reader rejects foreign files and ignores a torn tail", "[marketdata]") {
+    auto path = capturePath("torn");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(kTickCaptureHeaderSize, 'x');
+    }
+    TickCaptureReader reader;
+    REQUIRE_FALSE(reader.open(path));
+    REQUIRE(reader.error().find("not a tick capture") != std::string::npos);
+    REQUIRE_FALSE(reader.open(path + ".missing"));
+
+    writeCapture(path, 10);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << std::string(sizeof(TickRecord) / 2, '\0');
+    }
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.size() == 10);
+    REQUIRE(reader[9].last == 109.0);
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Recording feed captures published ticks and forwards them", "[marketdata]") {
+    struct CountingFeed : trading::domain::IMarketDataFeed {
+        int* ticks;
+        explicit CountingFeed(int* counter) : ticks(counter) {}
+        void subscribe(const std::vector<Symbol>&) override {}
+        void unsubscribe(const std::vector<Symbol>&) override {}
+        void publishTick(const Symbol&, const Tick&) override { ++*ticks; }
+        void publishTickDelta(const Symbol&, const trading::domain::TickDelta&) override {}
+    };
+
+    auto path = capturePath("feed");
+    auto writer = std::make_shared<TickCaptureWriter>();
+    REQUIRE(writer->open(path));
+    int forwarded = 0;
+    RecordingMarketDataFeed feed(writer, std::make_unique<CountingFeed>(&forwarded));
+    feed.publishTick(Symbol("SOL-USD"), Tick(5, 94.9, 95.1, 95.0, 7));
+    feed.publishTick(Symbol("SOL-USD"), Tick(6, 95.0, 95.2, 95.1, 3));
+    REQUIRE(forwarded == 2);
+
+    // Flushed records are visible to a reader while the writer is still open
+    REQUIRE(writer->flush());
+    TickCaptureReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.size() == 2);
+    REQUIRE(reader.symbol(reader[1]) == "SOL-USD");
+    REQUIRE(reader[1].volume == 3);
+
+    writer->close();
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Replayer delivers ticks in recorded order at max speed", "[marketdata]") {
+    auto path = capturePath("replay");
+    writeCapture(path, 50);
+    TickCaptureReader reader;
+    REQUIRE(reader.open(path));
+
+    std::vector<Replayed> seen;
+    std::atomic<bool> running{true};
+    ReplayOptions options;
+    options.speed = 0.0;
+    auto stats = TickReplayer(reader, options).run([&](const std::string& symbol, const Tick& tick) {
+        seen.push_back({symbol, tick});
+    }, running);
+
+    REQUIRE(stats.ticks == 50);
+    REQUIRE(stats.passes == 1);
+    REQUIRE(seen.size() == 50);
+    REQUIRE(seen[0].symbol == "ETH-USD");
+    REQUIRE(seen[49].symbol == "BTC-USD");
+    REQUIRE(seen[49].tick.ts == 1'000'000 + 49 * 100);
+    REQUIRE(seen[49].tick.last == 149.0);
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Replayer paces by recorded time and loops with shifted timestamps", "[marketdata]") {
+    auto path = capturePath("paced");
+    writeCapture(path, 4);  // 300 ms of recorded time
+    TickCaptureReader reader;
+    REQUIRE(reader.open(path));
+
+    std::atomic<bool> running{true};
+    ReplayOptions tenX;
+    tenX.speed = 10.0;
+    auto started = std::chrono::steady_clock::now();
+    auto stats = TickReplayer(reader, tenX).run([](const std::string&, const Tick&) {}, running);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    REQUIRE(stats.ticks == 4);
+    REQUIRE(elapsed >= std::chrono::milliseconds(29));
+    REQUIRE(elapsed < std::chrono::milliseconds(300));
+
+    ReplayOptions looping;
+    looping.speed = 0.0;
+    looping.loop = true;
+    std::vector<int64_t> timestamps;
+    TickReplayer(reader, looping).run([&](const std::string&, const Tick& tick) {
+        timestamps.push_back(tick.ts);
+        if (timestamps.size() == 10) {
+            running = false;
+        }
+    }, running);
+    REQUIRE(timestamps.size() == 10);
+    REQUIRE(timestamps[4] == timestamps[0] + 301);
+    for (size_t i = 1; i < timestamps.size(); ++i) {
+        REQUIRE(timestamps[i] > timestamps[i - 1]);
+    }
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Replay speed parsing", "[marketdata]") {
+    REQUIRE(TickReplayer::parseSpeed("max") == 0.0);
+    REQUIRE(TickReplayer::parseSpeed("10x") == 10.0);
+    REQUIRE(TickReplayer::parseSpeed("1") == 1.0);
+    REQUIRE(TickReplayer::parseSpeed("0.5") == 0.5);
+    REQUIRE_FALSE(TickReplayer::parseSpeed("fast").has_value());
+    REQUIRE_FALSE(TickReplayer::parseSpeed("-2").has_value());
+}
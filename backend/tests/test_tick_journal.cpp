@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "infrastructure/marketdata/tick_journal.hpp"
+
+using trading::domain::Tick;
+using trading::infrastructure::marketdata::TickJournal;
+using trading::infrastructure::marketdata::TickJournalOptions;
+
+namespace {
+
+constexpr int64_t kDay = 86'400'000;
+constexpr int64_t kStart = 1'718'000'000'000 / kDay * kDay;
+
+class JournalDirectory {
+public:
+    explicit JournalDirectory(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() / ("bull_journal_" + name + "_" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(path_);
+    }
+    ~JournalDirectory() { std::filesystem::remove_all(path_); }
+    std::string path() const { return path_.string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+Tick tickAt(int64_t ts, double price) {
+    return Tick(ts, price - 0.5, price + 0.5, price, 100);
+}
+
+std::vector<int64_t> timestamps(const std::vector<std::span<const Tick>>& spans) {
+    std::vector<int64_t> out;
+    for (auto span : spans) {
+        for (const Tick& tick : span) {
+            out.push_back(tick.ts);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("Tick journal range reads span segments", "[marketdata][journal]") {
+    JournalDirectory dir("range");
+    TickJournalOptions options;
+    options.segmentCapacity = 100;
+    options.indexStride = 8;
+    TickJournal journal(dir.path(), options);
+    REQUIRE(journal.open());
+
+    for (int i = 0; i < 250; ++i) {
+        REQUIRE(journal.append("ETH-USD", tickAt(kStart + i * 10, 2500.0 + i)));
+    }
+    REQUIRE(journal.size("ETH-USD") == 250);
+    REQUIRE(journal.size("BTC-USD") == 0);
+
+    auto spans = journal.range("ETH-USD", kStart + 955, kStart + 1505);
+    REQUIRE(spans.size() == 2);  // Positions 96..150 straddle the first segment boundary
+    auto ts = timestamps(spans);
+    REQUIRE(ts.size() == 55);
+    REQUIRE(ts.front() == kStart + 960);
+    REQUIRE(ts.back() == kStart + 1500);
+    REQUIRE(spans[0].back().last == 2599.0);
+
+    REQUIRE(timestamps(journal.range("ETH-USD", kStart - 100, kStart + 1)) == std::vector<int64_t>{kStart});
+    REQUIRE(journal.range("ETH-USD", kStart + 5000, kStart + 6000).empty());
+
+    auto latest = timestamps(journal.recent("ETH-USD", 3));
+    REQUIRE(latest == std::vector<int64_t>{kStart + 2470, kStart + 2480, kStart + 2490});
+}
+
+TEST_CASE("Tick journal rejects out-of-order ticks and rolls over each day", "[marketdata][journal]") {
+    JournalDirectory dir("order");
+    TickJournal journal(dir.path());
+    REQUIRE(journal.open());
+
+    REQUIRE(journal.append("SOL-USD", tickAt(kStart + 1000, 95.0)));
+    REQUIRE(journal.append("SOL-USD", tickAt(kStart + 1000, 95.1)));  // Equal ts is fine
+    REQUIRE_FALSE(journal.append("SOL-USD", tickAt(kStart + 999, 95.2)));
+    REQUIRE(journal.append("SOL-USD", tickAt(kStart + kDay + 5, 96.0)));
+
+    REQUIRE(journal.range("SOL-USD", kStart, kStart + 2 * kDay).size() == 2);
+    size_t segments = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::path(dir.path()) / "SOL-USD")) {
+        segments += entry.path().extension() == ".seg" ? 1 : 0;
+    }
+    REQUIRE(segments == 2);
+}
+
+TEST_CASE("Tick journal survives reopen and serves a loader cursor", "[marketdata][journal]") {
+    JournalDirectory dir("reopen");
+    TickJournalOptions options;
+    options.segmentCapacity = 64;
+    {
+        TickJournal journal(dir.path(), options);
+        REQUIRE(journal.open());
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(journal.append("BTC-USD", tickAt(kStart + i, 45000.0 + i)));
+        }
+        REQUIRE(journal.append("ETH-USD", tickAt(kStart, 2500.0)));
+    }
+
+    TickJournal journal(dir.path(), options);
+    REQUIRE(journal.open());
+    REQUIRE(journal.symbols() == std::vector<std::string>{"BTC-USD", "ETH-USD"});
+    REQUIRE(journal.size("BTC-USD") == 100);
+    REQUIRE_FALSE(journal.append("BTC-USD", tickAt(kStart + 50, 1.0)));
+    REQUIRE(journal.append("BTC-USD", tickAt(kStart + 100, 45100.0)));
+
+    // A loader that shipped the first 90 ticks picks up from its cursor
+    auto pending = timestamps(journal.since("BTC-USD", 90));
+    REQUIRE(pending.size() == 11);
+    REQUIRE(pending.front() == kStart + 90);
+    REQUIRE(pending.back() == kStart + 100);
+    REQUIRE(timestamps(journal.range("BTC-USD", kStart + 60, kStart + 70)).size() == 10);
+}
+
+TEST_CASE("Tick journal readers see only committed ticks while appending", "[marketdata][journal]") {
+    JournalDirectory dir("concurrent");
+    TickJournalOptions options;
+    options.segmentCapacity = 1000;
+    TickJournal journal(dir.path(), options);
+    REQUIRE(journal.open());
+    REQUIRE(journal.append("ETH-USD", tickAt(kStart, 1.0)));
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 1; i < 20000; ++i) {
+            journal.append("ETH-USD", tickAt(kStart + i, 1.0 + i));
+        }
+        done = true;
+    });
+
+    bool consistent = true;
+    while (!done) {
+        auto ts = timestamps(journal.recent("ETH-USD", 500));
+        for (size_t i = 1; i < ts.size(); ++i) {
+            consistent = consistent && ts[i] == ts[i - 1] + 1;
+        }
+    }
+    writer.join();
+    REQUIRE(consistent);
+    REQUIRE(journal.size("ETH-USD") == 20000);
+}
+
+TEST_CASE("Tick journal prunes whole days past the retention", "[marketdata][journal]") {
+    JournalDirectory dir("prune");
+    TickJournalOptions options;
+    options.segmentCapacity = 4;
+    options.retainDays = 2;
+    auto segmentFiles = [&] {
+        size_t files = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::path(dir.path()) / "ETH-USD")) {
+            files += entry.path().extension() == ".seg" ? 1 : 0;
+        }
+        return files;
+    };
+    {
+        TickJournal journal(dir.path(), options);
+        REQUIRE(journal.open());
+        // Three days of 6 ticks: two segments a day
+        for (int day = 0; day < 3; ++day) {
+            for (int i = 0; i < 6; ++i) {
+                REQUIRE(journal.append("ETH-USD", tickAt(kStart + day * kDay + i, 2500.0 + day)));
+            }
+        }
+        REQUIRE(segmentFiles() == 6);
+        auto firstDay = journal.range("ETH-USD", kStart, kStart + kDay);
+        REQUIRE(timestamps(firstDay).size() == 6);
+
+        // Keeps the last two days; the first day's spans stay readable until the next prune
+        REQUIRE(journal.prune(kStart + 2 * kDay + 10) == 2);
+        REQUIRE(segmentFiles() == 4);
+        REQUIRE(timestamps(firstDay).front() == kStart);
+        REQUIRE(journal.range("ETH-USD", kStart, kStart + kDay).empty());
+        REQUIRE(timestamps(journal.range("ETH-USD", kStart, kStart + 3 * kDay)).size() == 12);
+        REQUIRE(journal.size("ETH-USD") == 18);
+        REQUIRE(timestamps(journal.since("ETH-USD", 12)).size() == 6);
+        // A cursor into a pruned day resumes at the oldest tick left
+        uint64_t start = 0;
+        REQUIRE(timestamps(journal.since("ETH-USD", 3, &start)).size() == 12);
+        REQUIRE(start == 6);
+
+        // A quiet symbol keeps the segment it appends to, however old
+        REQUIRE(journal.prune(kStart + 30 * kDay) == 3);
+        REQUIRE(segmentFiles() == 1);
+        REQUIRE(timestamps(journal.recent("ETH-USD", 10)).size() == 2);
+        REQUIRE(journal.prune(kStart + 30 * kDay) == 0);
+    }
+
+    // Positions still count from the journal's creation after a reopen
+    TickJournal journal(dir.path(), options);
+    REQUIRE(journal.open());
+    REQUIRE(journal.size("ETH-USD") == 18);
+    REQUIRE(timestamps(journal.since("ETH-USD", 17)) == std::vector<int64_t>{kStart + 2 * kDay + 5});
+}
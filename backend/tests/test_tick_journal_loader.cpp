@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "infrastructure/marketdata/tick_journal_loader.hpp"
+
+using trading::domain::Tick;
+using trading::infrastructure::marketdata::TickJournal;
+using trading::infrastructure::marketdata::TickJournalLoader;
+using trading::infrastructure::marketdata::TickJournalOptions;
+
+namespace {
+
+constexpr int64_t kDay = 86'400'000;
+constexpr int64_t kStart = 1'718'000'000'000 / kDay * kDay;
+
+class LoaderDirectory {
+public:
+    LoaderDirectory() : path_(std::filesystem::temp_directory_path() / ("bull_loader_" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(path_);
+    }
+    ~LoaderDirectory() { std::filesystem::remove_all(path_); }
+    std::string journal() const { return (path_ / "journal").string(); }
+    std::string cursors() const { return (path_ / "journal" / "loader.cursor").string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+// Stores what it is handed; fails while failing is set
+struct RecordingSink {
+    std::vector<std::pair<std::string, int64_t>> stored;
+    std::vector<size_t> batches;
+    bool failing = false;
+
+    TickJournalLoader::Sink sink() {
+        return [this](const std::string& symbol, std::span<const Tick> ticks) {
+            if (failing) {
+                return false;
+            }
+            batches.push_back(ticks.size());
+            for (const Tick& tick : ticks) {
+                stored.emplace_back(symbol, tick.ts);
+            }
+            return true;
+        };
+    }
+};
+
+Tick tickAt(int64_t ts) {
+    return Tick(ts, 99.5, 100.5, 100.0, 10);
+}
+
+} // namespace
+
+TEST_CASE("Journal loader hands new ticks to the sink in batches and resumes from its cursor", "[marketdata][journal]") {
+    LoaderDirectory dir;
+    TickJournalOptions options;
+    options.segmentCapacity = 8;
+    TickJournal journal(dir.journal(), options);
+    REQUIRE(journal.open());
+    for (int i = 0; i < 20; ++i) {
+        REQUIRE(journal.append(i % 2 ? "BTC-USD" : "ETH-USD", tickAt(kStart + i)));
+    }
+
+    RecordingSink store;
+    {
+        TickJournalLoader loader(journal, dir.cursors(), store.sink(), 4);
+        REQUIRE(loader.open());
+        REQUIRE(loader.loadOnce() == 20);
+        REQUIRE(store.stored.size() == 20);
+        // Segments of 8 cut into batches of 4
+        REQUIRE(store.batches == std::vector<size_t>{4, 4, 2, 4, 4, 2});
+        REQUIRE(loader.cursor("ETH-USD") == 10);
+        REQUIRE(loader.loadOnce() == 0);
+
+        // A failed batch stays pending
+        REQUIRE(journal.append("ETH-USD", tickAt(kStart + 100)));
+        store.failing = true;
+        REQUIRE(loader.loadOnce() == 0);
+        REQUIRE(loader.cursor("ETH-USD") == 10);
+    }
+
+    // A new loader picks up the saved cursors
+    store.failing = false;
+    store.stored.clear();
+    TickJournalLoader loader(journal, dir.cursors(), store.sink(), 4);
+    REQUIRE(loader.open());
+    REQUIRE(loader.cursor("BTC-USD") == 10);
+    REQUIRE(loader.loadOnce() == 1);
+    REQUIRE(store.stored == std::vector<std::pair<std::string, int64_t>>{{"ETH-USD", kStart + 100}});
+}
+
+TEST_CASE("Journal loader skips ticks pruned before they were loaded", "[marketdata][journal]") {
+    LoaderDirectory dir;
+    TickJournalOptions options;
+    options.retainDays = 1;
+    TickJournal journal(dir.journal(), options);
+    REQUIRE(journal.open());
+    for (int day = 0; day < 2; ++day) {
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(journal.append("ETH-USD", tickAt(kStart + day * kDay + i)));
+        }
+    }
+    REQUIRE(journal.prune(kStart + kDay) == 1);
+
+    RecordingSink store;
+    TickJournalLoader loader(journal, dir.cursors(), store.sink());
+    REQUIRE(loader.open());
+    REQUIRE(loader.loadOnce() == 3);
+    REQUIRE(store.stored.front().second == kStart + kDay);
+    REQUIRE(loader.cursor("ETH-USD") == 6);
+}
@@ -0,0 +1,295 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "infrastructure/marketdata/tick_multicast.hpp"
+#include "infrastructure/marketdata/tick_relay.hpp"
+#include "infrastructure/marketdata/tick_ring.hpp"
+
+using trading::domain::Tick;
+using namespace trading::infrastructure::marketdata;
+using namespace std::chrono_literals;
+
+namespace {
+
+const char* const kSymbols[] = {"ETH-USD", "BTC-USD", "SOL-USD"};
+
+std::string ringPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("bull_ring_" + name + "_" + std::to_string(::getpid()))).string();
+}
+
+RelayTick relayTick(uint64_t seq) {
+    double price = 100.0 + static_cast<double>(seq);
+    return RelayTick::make(seq, kSymbols[seq % 3], Tick(1'718'000'000'000 + static_cast<int64_t>(seq), price - 0.5, price + 0.5, price, seq),
+                           static_cast<double>(seq) / 100.0);
+}
+
+// Polls until count ticks have arrived or a second passes
+std::vector<RelayTick> receive(TickRelaySubscriber& subscriber, size_t count) {
+    std::vector<RelayTick> ticks;
+    auto deadline = std::chrono::steady_clock::now() + 1s;
+    while (ticks.size() < count && std::chrono::steady_clock::now() < deadline) {
+        subscriber.poll(ticks, 10ms);
+    }
+    return ticks;
+}
+
+std::vector<uint64_t> sequence(const std::vector<RelayTick>& ticks) {
+    std::vector<uint64_t> seqs;
+    for (const auto& tick : ticks) {
+        seqs.push_back(tick.seq);
+    }
+    return seqs;
+}
+
+// FNV-1a over (seq, symbol, price) in delivery order
+uint64_t orderDigest(const std::vector<RelayTick>& ticks) {
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&](const void* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<const uint8_t*>(data)[i]) * 1099511628211ull;
+        }
+    };
+    for (const auto& tick : ticks) {
+        mix(&tick.seq, sizeof(tick.seq));
+        mix(tick.symbol, sizeof(tick.symbol));
+        mix(&tick.tick.last, sizeof(tick.tick.last));
+    }
+    return hash;
+}
+
+} // namespace
+
+TEST_CASE("Relay endpoints parse shared memory and multicast forms", "[marketdata][relay]") {
+    auto ring = RelayEndpoint::parse("shm:/dev/shm/bull-ticks");
+    REQUIRE(ring);
+    REQUIRE(ring->kind == RelayEndpoint::Kind::SHARED_MEMORY);
+    REQUIRE(ring->path == "/dev/shm/bull-ticks");
+
+    auto group = RelayEndpoint::parse("udp:239.192.0.1:30001@10.0.0.5");
+    REQUIRE(group);
+    REQUIRE(group->kind == RelayEndpoint::Kind::MULTICAST);
+    REQUIRE(group->group == "239.192.0.1");
+    REQUIRE(group->port == 30001);
+    REQUIRE(group->interfaceAddress == "10.0.0.5");
+    REQUIRE(group->describe() == "udp:239.192.0.1:30001@10.0.0.5");
+
+    REQUIRE_FALSE(RelayEndpoint::parse("shm:"));
+    REQUIRE_FALSE(RelayEndpoint::parse("udp:10.0.0.1:30001"));  // Not a multicast group
+    REQUIRE_FALSE(RelayEndpoint::parse("udp:239.192.0.1:70000"));
+    REQUIRE_FALSE(RelayEndpoint::parse("udp:239.192.0.1:30001x"));
+    REQUIRE_FALSE(RelayEndpoint::parse("tcp:239.192.0.1:30001"));
+}
+
+TEST_CASE("Tick ring delivers published ticks in order", "[marketdata][relay]") {
+    std::string path = ringPath("order");
+    TickRingWriter writer(64);
+    REQUIRE(writer.open(path));
+    REQUIRE(writer.capacity() == 64);
+
+    TickRingReader reader;
+    REQUIRE(reader.open(path));
+    for (uint64_t seq = 1; seq <= 50; ++seq) {
+        REQUIRE(writer.publish(relayTick(seq)));
+    }
+
+    auto ticks = receive(reader, 50);
+    REQUIRE(ticks.size() == 50);
+    for (uint64_t seq = 1; seq <= 50; ++seq) {
+        const RelayTick& tick = ticks[seq - 1];
+        REQUIRE(tick.seq == seq);
+        REQUIRE(tick.symbolName() == kSymbols[seq % 3]);
+        REQUIRE(tick.tick.last == 100.0 + static_cast<double>(seq));
+        REQUIRE(tick.changePercent == static_cast<double>(seq) / 100.0);
+    }
+    REQUIRE(reader.stats().ticks == 50);
+    REQUIRE(reader.stats().lost == 0);
+
+    // A reader that joins late starts at the head
+    TickRingReader lateReader;
+    REQUIRE(lateReader.open(path));
+    REQUIRE(writer.publish(relayTick(51)));
+    REQUIRE(sequence(receive(lateReader, 1)) == std::vector<uint64_t>{51});
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Tick ring counts ticks lost by a lapped reader", "[marketdata][relay]") {
+    std::string path = ringPath("lapped");
+    TickRingWriter writer(16);
+    REQUIRE(writer.open(path));
+    TickRingReader reader;
+    REQUIRE(reader.open(path));
+
+    for (uint64_t seq = 1; seq <= 100; ++seq) {
+        writer.publish(relayTick(seq));
+    }
+    auto ticks = receive(reader, 8);
+
+    // Resumes halfway behind the head, still in order
+    REQUIRE(sequence(ticks) == std::vector<uint64_t>{93, 94, 95, 96, 97, 98, 99, 100});
+    REQUIRE(reader.stats().lost == 92);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Tick ring reader follows a restarted publisher", "[marketdata][relay]") {
+    std::string path = ringPath("restart");
+    TickRingReader reader;
+    {
+        TickRingWriter writer(16);
+        REQUIRE(writer.open(path));
+        REQUIRE(reader.open(path));
+        writer.publish(relayTick(1));
+        REQUIRE(receive(reader, 1).size() == 1);
+    }
+
+    TickRingWriter restarted(16);
+    REQUIRE(restarted.open(path));
+    restarted.publish(relayTick(1));
+    restarted.publish(relayTick(2));
+
+    // The reader looks for a replaced ring once a second while idle
+    std::vector<RelayTick> ticks;
+    auto deadline = std::chrono::steady_clock::now() + 3s;
+    while (ticks.size() < 2 && std::chrono::steady_clock::now() < deadline) {
+        reader.poll(ticks, 100ms);
+    }
+    REQUIRE(sequence(ticks) == std::vector<uint64_t>{1, 2});
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Edge processes on one ring see the same tick order", "[marketdata][relay]") {
+    constexpr int kEdges = 3;
+    constexpr uint64_t kTicks = 20000;
+    std::string path = ringPath("edges");
+    TickRingWriter writer(1 << 16);
+    REQUIRE(writer.open(path));
+
+    // Each edge reports how many ticks it saw and a digest of their order
+    int results[2];
+    REQUIRE(::pipe(results) == 0);
+    std::vector<pid_t> edges;
+    for (int edge = 0; edge < kEdges; ++edge) {
+        pid_t pid = ::fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0) {
+            ::close(results[0]);
+            TickRingReader reader;
+            uint64_t report[2] = {0, 0};
+            if (reader.open(path)) {
+                std::vector<RelayTick> ticks;
+                auto deadline = std::chrono::steady_clock::now() + 10s;
+                while ((ticks.empty() || ticks.back().seq < kTicks) && std::chrono::steady_clock::now() < deadline) {
+                    reader.poll(ticks, 10ms);
+                }
+                report[0] = ticks.size();
+                report[1] = orderDigest(ticks);
+            }
+            ssize_t written = ::write(results[1], report, sizeof(report));
+            ::_exit(written == sizeof(report) ? 0 : 1);
+        }
+        edges.push_back(pid);
+    }
+    ::close(results[1]);
+
+    // Readers start at the head, so give them time to map the ring first
+    std::this_thread::sleep_for(200ms);
+    std::vector<RelayTick> published;
+    for (uint64_t seq = 1; seq <= kTicks; ++seq) {
+        published.push_back(relayTick(seq));
+        writer.publish(published.back());
+    }
+
+    for (int edge = 0; edge < kEdges; ++edge) {
+        uint64_t report[2] = {0, 0};
+        REQUIRE(::read(results[0], report, sizeof(report)) == sizeof(report));
+        REQUIRE(report[0] == kTicks);
+        REQUIRE(report[1] == orderDigest(published));
+    }
+    ::close(results[0]);
+    for (pid_t pid : edges) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Multicast receivers share a group and drop late datagrams", "[marketdata][relay]") {
+    const std::string group = "239.255.77.1";
+    const uint16_t port = static_cast<uint16_t>(30000 + ::getpid() % 20000);
+
+    // Loopback keeps the test off the network
+    MulticastTickReceiver first;
+    MulticastTickReceiver second;
+    REQUIRE(first.open(group, port, "127.0.0.1"));
+    REQUIRE(second.open(group, port, "127.0.0.1"));
+    MulticastTickSender sender;
+    REQUIRE(sender.open(group, port, "127.0.0.1"));
+
+    for (uint64_t seq = 1; seq <= 20; ++seq) {
+        REQUIRE(sender.publish(relayTick(seq)));
+    }
+    auto firstTicks = receive(first, 20);
+    auto secondTicks = receive(second, 20);
+    REQUIRE(firstTicks.size() == 20);
+    REQUIRE(orderDigest(firstTicks) == orderDigest(secondTicks));
+    REQUIRE(firstTicks.back().symbolName() == kSymbols[20 % 3]);
+
+    // A gap counts as lost; a datagram arriving behind it is dropped
+    sender.publish(relayTick(23));
+    sender.publish(relayTick(22));
+    sender.publish(relayTick(24));
+    REQUIRE(sequence(receive(first, 2)) == std::vector<uint64_t>{23, 24});
+    REQUIRE(first.stats().lost == 2);
+
+    // A restarted sender starts a new sequence
+    MulticastTickSender restarted;
+    REQUIRE(restarted.open(group, port, "127.0.0.1"));
+    restarted.publish(relayTick(1));
+    REQUIRE(sequence(receive(first, 1)) == std::vector<uint64_t>{1});
+    REQUIRE(first.stats().lost == 2);
+
+    // A late datagram from the replaced sender does not switch back to it
+    sender.publish(relayTick(25));
+    restarted.publish(relayTick(2));
+    REQUIRE(sequence(receive(first, 2)) == std::vector<uint64_t>{2});
+    REQUIRE(first.stats().lost == 2);
+}
+
+TEST_CASE("Multicast datagrams use network byte order", "[marketdata][relay]") {
+    RelayTick tick = relayTick(0x0102030405060708);
+    uint8_t datagram[kRelayDatagramBytes];
+    encodeRelayDatagram(0x1112131415161718, tick, datagram);
+
+    REQUIRE(std::memcmp(datagram, "BTRL", 4) == 0);
+    REQUIRE(std::vector<uint8_t>(datagram + 4, datagram + 8) == std::vector<uint8_t>{0, 0, 0, 2});
+    REQUIRE(std::vector<uint8_t>(datagram + 8, datagram + 16) == std::vector<uint8_t>{0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18});
+    REQUIRE(std::vector<uint8_t>(datagram + 16, datagram + 24) == std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7, 8});
+
+    uint64_t epoch = 0;
+    RelayTick decoded;
+    REQUIRE(decodeRelayDatagram(datagram, sizeof(datagram), epoch, decoded));
+    REQUIRE(epoch == 0x1112131415161718);
+    REQUIRE(decoded.seq == tick.seq);
+    REQUIRE(decoded.tick.ts == tick.tick.ts);
+    REQUIRE(decoded.tick.bid == tick.tick.bid);
+    REQUIRE(decoded.tick.last == tick.tick.last);
+    REQUIRE(decoded.tick.volume == tick.tick.volume);
+    REQUIRE(decoded.changePercent == tick.changePercent);
+    REQUIRE(decoded.symbolName() == tick.symbolName());
+
+    // Other versions, including a version 1 sender's host-order struct, and short datagrams are dropped
+    REQUIRE_FALSE(decodeRelayDatagram(datagram, sizeof(datagram) - 1, epoch, decoded));
+    datagram[7] = 1;
+    REQUIRE_FALSE(decodeRelayDatagram(datagram, sizeof(datagram), epoch, decoded));
+}
@@ -0,0 +1,179 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+#include "infrastructure/metrics/trace_recorder.hpp"
+
+using namespace trading::infrastructure::metrics;
+
+namespace {
+
+std::vector<TraceEvent> eventsNamed(const char* prefix) {
+    std::vector<TraceEvent> matching;
+    for (const auto& event : TraceRecorder::instance().collect()) {
+        if (event.name && std::strncmp(event.name, prefix, std::strlen(prefix)) == 0) {
+            matching.push_back(event);
+        }
+    }
+    return matching;
+}
+
+} // namespace
+
+TEST_CASE("TraceSpan records a completed span", "[tracing]") {
+    auto& recorder = TraceRecorder::instance();
+    recorder.setEnabled(true);
+    recorder.clear();
+
+    {
+        TraceSpan span("test.span");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    auto events = eventsNamed("test.span");
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].durationNs >= 1'500'000);
+    REQUIRE(events[0].durationNs < 1'000'000'000);
+}
+
+TEST_CASE("TraceSpan::next records consecutive stages", "[tracing]") {
+    auto& recorder = TraceRecorder::instance();
+    recorder.setEnabled(true);
+    recorder.clear();
+
+    {
+        TraceSpan stage("test.stage.a");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        stage.next("test.stage.b");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto events = eventsNamed("test.stage.");
+    REQUIRE(events.size() == 2);
+    REQUIRE(std::strcmp(events[0].name, "test.stage.a") == 0);
+    REQUIRE(std::strcmp(events[1].name, "test.stage.b") == 0);
+    // The second stage starts where the first ended (within rounding)
+    uint64_t firstEnd = events[0].startNs + events[0].durationNs;
+    REQUIRE(events[1].startNs + 1000 >= firstEnd);
+    REQUIRE(events[1].startNs <= firstEnd + 1000);
+}
+
+TEST_CASE("Disabled tracing records nothing", "[tracing]") {
+    auto& recorder = TraceRecorder::instance();
+    recorder.clear();
+    recorder.setEnabled(false);
+    {
+        TraceSpan span("test.disabled");
+        span.next("test.disabled.next");
+    }
+    recorder.setEnabled(true);
+
+    REQUIRE(eventsNamed("test.disabled").empty());
+}
+
+TEST_CASE("Trace ring keeps the newest spans per thread", "[tracing]") {
+    auto& recorder = TraceRecorder::instance();
+    recorder.setEnabled(true);
+    recorder.clear();
+
+    for (size_t i = 0; i < TraceRecorder::kRingCapacity + 100; ++i) {
+        TraceSpan span("test.ring");
+    }
+    REQUIRE(eventsNamed("test.ring").size() == TraceRecorder::kRingCapacity - 1);
+
+    recorder.clear();
+    REQUIRE(eventsNamed("test.ring").empty());
+}
+
+TEST_CASE("Trace spans are kept per thread", "[tracing]") {
+    auto& recorder = TraceRecorder::instance();
+    recorder.setEnabled(true);
+    recorder.clear();
+
+    constexpr int kThreads = 4;
+    constexpr int kSpans = 1000;
+    std::atomic<int> attached{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            // All threads hold a ring at once; an exited thread's ring could be reused
+            TraceRecorder::instance().nameThread("worker");
+            attached.fetch_add(1);
+            while (attached.load() < kThreads) {
+            }
+            for (int i = 0; i < kSpans; ++i) {
+                TraceSpan span("test.thread");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::map<uint32_t, int> perThread;
+    for (const auto& event : eventsNamed("test.thread")) {
+        ++perThread[event.threadId];
+    }
+    REQUIRE(perThread.size() == kThreads);
+    for (const auto& [threadId, count] : perThread) {
+        REQUIRE(count == kSpans);
+    }
+}
+
+TEST_CASE("Collecting while threads record never returns torn spans", "[tracing]") {
+    auto& recorder = TraceRecorder::instance();
+    recorder.setEnabled(true);
+    recorder.clear();
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            TraceSpan span("test.race.a");
+            span.next("test.race.b");
+        }
+    });
+
+    for (int i = 0; i < 50; ++i) {
+        for (const auto& event : recorder.collect()) {
+            REQUIRE(event.name != nullptr);
+            REQUIRE(event.durationNs < 1'000'000'000);
+        }
+    }
+    stop = true;
+    writer.join();
+}
+
+TEST_CASE("Chrome trace export has complete events and thread names", "[tracing]") {
+    auto& recorder = TraceRecorder::instance();
+    recorder.setEnabled(true);
+    recorder.clear();
+
+    std::thread([] {
+        TraceRecorder::instance().nameThread("exporter");
+        TraceSpan span("test.chrome");
+    }).join();
+
+    auto trace = recorder.chromeTrace();
+    REQUIRE(trace["displayTimeUnit"] == "ns");
+    REQUIRE(trace["traceEvents"].is_array());
+
+    bool foundSpan = false;
+    std::set<std::string> threadNames;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "M") {
+            threadNames.insert(event["args"]["name"].get<std::string>());
+        } else if (event["name"] == "test.chrome") {
+            foundSpan = true;
+            REQUIRE(event["ph"] == "X");
+            REQUIRE(event["ts"].is_number());
+            REQUIRE(event["dur"].is_number());
+            REQUIRE(event["pid"] == 1);
+        }
+    }
+    REQUIRE(foundSpan);
+    REQUIRE(threadNames.count("exporter") == 1);
+}
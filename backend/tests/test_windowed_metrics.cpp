@@ -0,0 +1,133 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <chrono>
+#include <cmath>
+#include "infrastructure/metrics/windowed_metrics.hpp"
+
+using namespace trading::infrastructure::metrics;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+
+const WindowedSeries::Clock::time_point kEpoch = WindowedSeries::Clock::time_point{} + std::chrono::hours(1);
+
+WindowedSeries::Clock::time_point at(double seconds) {
+    return kEpoch + std::chrono::duration_cast<WindowedSeries::Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+constexpr uint64_t kMs = 1'000'000;
+
+} // namespace
+
+TEST_CASE("WindowedSeries - Rates", "[metrics][windowed]") {
+    WindowedSeries series(false);
+
+    SECTION("The second in progress is not reported") {
+        for (int i = 0; i < 5; ++i) {
+            series.mark(at(0.5));
+        }
+        REQUIRE(series.stats(at(0.9)).rate1s == 0.0);
+
+        auto stats = series.stats(at(1.1));
+        REQUIRE(stats.rate1s == 5.0);
+        REQUIRE(stats.rate10s == 0.5);
+        REQUIRE_THAT(stats.rate60s, WithinAbs(5.0 / 60.0, 1e-9));
+    }
+
+    SECTION("Windows roll off old seconds") {
+        // 2 events per second for 20 seconds
+        for (int second = 0; second < 20; ++second) {
+            series.mark(at(second + 0.1));
+            series.mark(at(second + 0.2));
+        }
+        auto stats = series.stats(at(20.0));
+        REQUIRE(stats.rate1s == 2.0);
+        REQUIRE(stats.rate10s == 2.0);
+        REQUIRE_THAT(stats.rate60s, WithinAbs(40.0 / 60.0, 1e-9));
+
+        // Five idle seconds leave half of the short window populated
+        stats = series.stats(at(25.0));
+        REQUIRE(stats.rate1s == 0.0);
+        REQUIRE(stats.rate10s == 1.0);
+
+        // Past the long window everything has expired
+        stats = series.stats(at(81.0));
+        REQUIRE(stats.rate10s == 0.0);
+        REQUIRE(stats.rate60s == 0.0);
+    }
+
+    SECTION("EWMA converges towards a steady rate and decays when idle") {
+        for (int second = 0; second < 100; ++second) {
+            for (int i = 0; i < 10; ++i) {
+                series.mark(at(second + 0.5));
+            }
+        }
+        auto busy = series.stats(at(100.0)).rateEwma;
+        REQUIRE_THAT(busy, WithinRel(10.0, 0.01));
+
+        // One time constant of silence: about 1/e of the rate remains
+        auto idle = series.stats(at(110.0)).rateEwma;
+        REQUIRE_THAT(idle, WithinRel(busy * std::exp(-1.0), 0.02));
+
+        // Gaps longer than the window decay the same way
+        auto longIdle = series.stats(at(200.0)).rateEwma;
+        REQUIRE(longIdle < 0.01);
+    }
+}
+
+TEST_CASE("WindowedSeries - Percentiles", "[metrics][windowed]") {
+    WindowedSeries series(true);
+
+    SECTION("p99 over 10s only sees recent samples") {
+        // A slow burst at t=0, then fast requests afterwards
+        for (int i = 0; i < 100; ++i) {
+            series.record(50 * kMs, at(0.5));
+        }
+        for (int second = 1; second < 20; ++second) {
+            for (int i = 0; i < 100; ++i) {
+                series.record(1 * kMs, at(second + 0.5));
+            }
+        }
+
+        auto stats = series.stats(at(20.0));
+        REQUIRE_THAT(stats.p99_10sMs, WithinRel(1.0, 0.05));
+        REQUIRE_THAT(stats.p50_10sMs, WithinRel(1.0, 0.05));
+        REQUIRE_THAT(stats.mean10sMs, WithinRel(1.0, 1e-9));
+        // 100 of 2000 samples in the last minute are slow, so they set the 99th percentile
+        REQUIRE_THAT(stats.p99_60sMs, WithinRel(50.0, 0.05));
+    }
+
+    SECTION("Tail of a mixed distribution") {
+        for (int i = 0; i < 1000; ++i) {
+            series.record((i < 985 ? 2 : 20) * kMs, at(3.5));
+        }
+        auto stats = series.stats(at(4.0));
+        REQUIRE_THAT(stats.p50_10sMs, WithinRel(2.0, 0.05));
+        REQUIRE_THAT(stats.p99_10sMs, WithinRel(20.0, 0.05));
+        REQUIRE(stats.rate1s == 1000.0);
+    }
+
+    SECTION("Samples from the past count towards the current second") {
+        series.record(5 * kMs, at(10.5));
+        series.record(5 * kMs, at(9.5));
+        REQUIRE(series.stats(at(11.0)).rate1s == 2.0);
+    }
+}
+
+TEST_CASE("WindowedMetrics - Snapshot keys", "[metrics][windowed]") {
+    WindowedMetrics metrics({"orders.place"}, {"orders"});
+
+    metrics.series("orders.place")->record(3 * kMs, at(0.5));
+    metrics.series("orders")->mark(at(0.5));
+    metrics.record("unknown", 1 * kMs);
+    metrics.mark("unknown");
+    REQUIRE(metrics.series("unknown") == nullptr);
+
+    auto values = metrics.snapshot(at(1.5));
+    REQUIRE(values.size() == 8 + 4);
+    REQUIRE(values.at("orders.place.rate_1s") == 1.0);
+    REQUIRE_THAT(values.at("orders.place.p99_10s"), WithinRel(3.0, 0.05));
+    REQUIRE(values.at("orders.rate_1s") == 1.0);
+    REQUIRE(values.count("orders.p99_10s") == 0);
+}
@@ -0,0 +1,816 @@
+#include "clickhouse_types.hpp"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <optional>
+
+namespace trading::fake_clickhouse {
+
+namespace {
+
+constexpr int kSyntaxError = 62;
+constexpr int kUnknownTable = 60;
+constexpr int kUnknownDatabase = 81;
+constexpr int kUnknownIdentifier = 47;
+constexpr int kUnknownType = 50;
+constexpr int kCannotParseText = 6;
+constexpr int kCannotReadAllData = 33;
+constexpr int kNotImplemented = 48;
+constexpr int kUnknownQueryParameter = 456;
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Strips "Name(" ... ")" and returns the argument list
+std::optional<std::string_view> wrapped(std::string_view text, std::string_view name) {
+    if (text.size() < name.size() + 2 || text.substr(0, name.size()) != name || text[name.size()] != '(' || text.back() != ')') {
+        return std::nullopt;
+    }
+    return trim(text.substr(name.size() + 1, text.size() - name.size() - 2));
+}
+
+// Splits a type argument list at top-level commas
+std::vector<std::string_view> splitArguments(std::string_view args) {
+    std::vector<std::string_view> parts;
+    int depth = 0;
+    size_t start = 0;
+    for (size_t i = 0; i <= args.size(); ++i) {
+        if (i == args.size() || (args[i] == ',' && depth == 0)) {
+            parts.push_back(trim(args.substr(start, i - start)));
+            start = i + 1;
+        } else if (args[i] == '(') {
+            ++depth;
+        } else if (args[i] == ')') {
+            --depth;
+        }
+    }
+    return parts;
+}
+
+int64_t pow10(int exponent) {
+    int64_t result = 1;
+    for (int i = 0; i < exponent; ++i) {
+        result *= 10;
+    }
+    return result;
+}
+
+template <typename T>
+std::optional<T> parseNumber(std::string_view text) {
+    text = trim(text);
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    T value{};
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size() || text.empty()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+bool allDigits(std::string_view text) {
+    if (text.empty()) {
+        return false;
+    }
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 'YYYY-MM-DD[ HH:MM:SS[.fff]]' (or 'T' separator, optional 'Z') as ticks of 10^-scale seconds
+std::optional<int64_t> parseDateTimeTicks(std::string_view text, int scale) {
+    text = trim(text);
+    if (!text.empty() && text.back() == 'Z') {
+        text.remove_suffix(1);
+    }
+    if (text.size() < 10 || text[4] != '-' || text[7] != '-') {
+        return std::nullopt;
+    }
+    auto year = parseNumber<int64_t>(text.substr(0, 4));
+    auto month = parseNumber<unsigned>(text.substr(5, 2));
+    auto day = parseNumber<unsigned>(text.substr(8, 2));
+    if (!year || !month || !day || *month < 1 || *month > 12 || *day < 1 || *day > 31) {
+        return std::nullopt;
+    }
+    int64_t seconds = daysFromCivil(*year, *month, *day) * 86400;
+    text.remove_prefix(10);
+    int64_t fraction = 0;
+    if (!text.empty()) {
+        if ((text[0] != ' ' && text[0] != 'T') || text.size() < 9 || text[3] != ':' || text[6] != ':') {
+            return std::nullopt;
+        }
+        auto hour = parseNumber<unsigned>(text.substr(1, 2));
+        auto minute = parseNumber<unsigned>(text.substr(4, 2));
+        auto second = parseNumber<unsigned>(text.substr(7, 2));
+        if (!hour || !minute || !second || *hour > 23 || *minute > 59 || *second > 60) {
+            return std::nullopt;
+        }
+        seconds += *hour * 3600 + *minute * 60 + *second;
+        text.remove_prefix(9);
+        if (!text.empty()) {
+            if (text[0] != '.' || !allDigits(text.substr(1))) {
+                return std::nullopt;
+            }
+            std::string_view digits = text.substr(1, static_cast<size_t>(scale));
+            fraction = *parseNumber<int64_t>(digits.empty() ? "0" : digits) * pow10(scale - static_cast<int>(digits.size()));
+        }
+    }
+    return seconds * pow10(scale) + fraction;
+}
+
+void appendCivil(std::string& out, int64_t days) {
+    // Inverse of daysFromCivil (Howard Hinnant's algorithm)
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    auto dayOfEra = static_cast<unsigned>(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t year = static_cast<int64_t>(yearOfEra) + era * 400;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned mp = (5 * dayOfYear + 2) / 153;
+    unsigned day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    year += month <= 2;
+
+    char buffer[48];
+    std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u", static_cast<long long>(year), month, day);
+    out += buffer;
+}
+
+void appendClock(std::string& out, int64_t secondsOfDay) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), " %02d:%02d:%02d", static_cast<int>(secondsOfDay / 3600),
+                  static_cast<int>(secondsOfDay / 60 % 60), static_cast<int>(secondsOfDay % 60));
+    out += buffer;
+}
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+void appendTemporal(std::string& out, const Value& value, const ColumnType& type) {
+    if (type.kind == TypeKind::DATE) {
+        appendCivil(out, static_cast<int64_t>(std::get<uint64_t>(value)));
+        return;
+    }
+    int64_t ticks = type.kind == TypeKind::DATETIME ? static_cast<int64_t>(std::get<uint64_t>(value)) : std::get<int64_t>(value);
+    int64_t perSecond = type.kind == TypeKind::DATETIME ? 1 : pow10(type.scale);
+    int64_t seconds = floorDiv(ticks, perSecond);
+    int64_t days = floorDiv(seconds, 86400);
+    appendCivil(out, days);
+    appendClock(out, seconds - days * 86400);
+    if (type.kind == TypeKind::DATETIME64 && type.scale > 0) {
+        std::string fraction = std::to_string(ticks - seconds * perSecond);
+        out += '.';
+        out.append(static_cast<size_t>(type.scale) - fraction.size(), '0');
+        out += fraction;
+    }
+}
+
+void appendDouble(std::string& out, double value) {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, ec == std::errc() ? static_cast<size_t>(end - buffer) : 0);
+}
+
+void appendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+template <typename T>
+void appendLittleEndian(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));  // Supported hosts are little-endian, like ClickHouse itself
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T readLittleEndian(const uint8_t*& data, const uint8_t* end) {
+    if (end - data < static_cast<std::ptrdiff_t>(sizeof(T))) {
+        throw ClickHouseError(kCannotReadAllData, "CANNOT_READ_ALL_DATA", "Cannot read all data in RowBinary format");
+    }
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return value;
+}
+
+int enumCode(const ColumnType& type, const std::string& name) {
+    for (const auto& [label, code] : type.enumValues) {
+        if (label == name) {
+            return code;
+        }
+    }
+    throw error::cannotParse("Unknown element '" + name + "' for enum " + typeName(type));
+}
+
+const std::string& enumName(const ColumnType& type, int64_t code) {
+    for (const auto& [label, value] : type.enumValues) {
+        if (value == code) {
+            return label;
+        }
+    }
+    throw error::cannotParse("Unexpected value " + std::to_string(code) + " in enum " + typeName(type));
+}
+
+Value defaultValue(const ColumnType& type) {
+    switch (type.kind) {
+        case TypeKind::STRING:
+        case TypeKind::AGGREGATE_STATE: return std::string();
+        case TypeKind::ENUM8:
+        case TypeKind::ENUM16: return type.enumValues.empty() ? std::string() : type.enumValues.front().first;
+        case TypeKind::FLOAT32:
+        case TypeKind::FLOAT64: return 0.0;
+        case TypeKind::NOTHING: return std::monostate{};
+        default: return type.isSigned() || type.kind == TypeKind::DATETIME64 ? Value(int64_t{0}) : Value(uint64_t{0});
+    }
+}
+
+} // namespace
+
+int ClickHouseError::httpStatus() const {
+    switch (code_) {
+        case kSyntaxError:
+        case kUnknownIdentifier:
+        case kUnknownType:
+        case kCannotParseText:
+        case kCannotReadAllData:
+        case kUnknownQueryParameter:
+            return 400;
+        case kUnknownTable:
+        case kUnknownDatabase:
+            return 404;
+        case kNotImplemented:
+            return 501;
+        default:
+            return 500;
+    }
+}
+
+std::string ClickHouseError::render() const {
+    return "Code: " + std::to_string(code_) + ". DB::Exception: " + what() + ". (" + name_ + ") (version fake)\n";
+}
+
+namespace error {
+ClickHouseError syntax(const std::string& message) { return {kSyntaxError, "SYNTAX_ERROR", "Syntax error: " + message}; }
+ClickHouseError unknownTable(const std::string& table) { return {kUnknownTable, "UNKNOWN_TABLE", "Table " + table + " does not exist"}; }
+ClickHouseError unknownIdentifier(const std::string& name) { return {kUnknownIdentifier, "UNKNOWN_IDENTIFIER", "Missing columns: '" + name + "'"}; }
+ClickHouseError cannotParse(const std::string& message) { return {kCannotParseText, "CANNOT_PARSE_TEXT", message}; }
+ClickHouseError unknownQueryParameter(const std::string& name) { return {kUnknownQueryParameter, "UNKNOWN_QUERY_PARAMETER", "Substitution `" + name + "` is not set"}; }
+ClickHouseError notImplemented(const std::string& message) { return {kNotImplemented, "NOT_IMPLEMENTED", message + " is not supported by the fake server"}; }
+} // namespace error
+
+bool ColumnType::isSigned() const {
+    return kind == TypeKind::INT8 || kind == TypeKind::INT16 || kind == TypeKind::INT32 || kind == TypeKind::INT64;
+}
+
+bool ColumnType::isUnsigned() const {
+    return kind == TypeKind::UINT8 || kind == TypeKind::UINT16 || kind == TypeKind::UINT32 || kind == TypeKind::UINT64 || kind == TypeKind::BOOL;
+}
+
+ColumnType parseType(std::string_view text) {
+    text = trim(text);
+    if (auto inner = wrapped(text, "Nullable")) {
+        ColumnType type = parseType(*inner);
+        type.nullable = true;
+        return type;
+    }
+    if (auto inner = wrapped(text, "LowCardinality")) {
+        ColumnType type = parseType(*inner);
+        type.lowCardinality = true;
+        return type;
+    }
+
+    // SimpleAggregateFunction(f, T) stores plain T values
+    if (auto args = wrapped(text, "SimpleAggregateFunction")) {
+        auto parts = splitArguments(*args);
+        if (parts.size() != 2) {
+            throw ClickHouseError(kUnknownType, "UNKNOWN_TYPE", "Invalid type " + std::string(text));
+        }
+        return parseType(parts[1]);
+    }
+
+    ColumnType type;
+    if (auto args = wrapped(text, "AggregateFunction")) {
+        auto parts = splitArguments(*args);
+        if (parts.size() < 2) {
+            throw ClickHouseError(kUnknownType, "UNKNOWN_TYPE", "Invalid type " + std::string(text));
+        }
+        type.kind = TypeKind::AGGREGATE_STATE;
+        type.aggregateFunction = std::string(parts[0]);
+        for (size_t i = 1; i < parts.size(); ++i) {
+            type.aggregateArgs.push_back(parseType(parts[i]));
+        }
+        return type;
+    }
+    if (auto args = wrapped(text, "DateTime64")) {
+        type.kind = TypeKind::DATETIME64;
+        auto scale = parseNumber<int>(args->substr(0, args->find(',')));
+        if (!scale || *scale < 0 || *scale > 9) {
+            throw ClickHouseError(kUnknownType, "UNKNOWN_TYPE", "Invalid DateTime64 precision in " + std::string(text));
+        }
+        type.scale = *scale;
+        return type;
+    }
+    if (text == "DateTime" || wrapped(text, "DateTime")) {
+        type.kind = TypeKind::DATETIME;
+        return type;
+    }
+    for (auto [name, kind] : {std::pair{"Enum8", TypeKind::ENUM8}, std::pair{"Enum16", TypeKind::ENUM16}}) {
+        auto args = wrapped(text, name);
+        if (!args) {
+            continue;
+        }
+        type.kind = kind;
+        // 'label' = code, ...
+        std::string_view rest = *args;
+        while (!rest.empty()) {
+            rest = trim(rest);
+            size_t close = rest.size() > 1 && rest[0] == '\'' ? rest.find('\'', 1) : std::string_view::npos;
+            size_t equals = close == std::string_view::npos ? close : rest.find('=', close);
+            if (equals == std::string_view::npos) {
+                throw ClickHouseError(kUnknownType, "UNKNOWN_TYPE", "Invalid enum definition " + std::string(text));
+            }
+            size_t comma = rest.find(',', equals);
+            auto code = parseNumber<int>(rest.substr(equals + 1, comma == std::string_view::npos ? comma : comma - equals - 1));
+            if (!code) {
+                throw ClickHouseError(kUnknownType, "UNKNOWN_TYPE", "Invalid enum value in " + std::string(text));
+            }
+            type.enumValues.emplace_back(std::string(rest.substr(1, close - 1)), *code);
+            rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+        }
+        return type;
+    }
+
+    static const std::pair<std::string_view, TypeKind> kSimple[] = {
+        {"String", TypeKind::STRING}, {"Int8", TypeKind::INT8}, {"Int16", TypeKind::INT16},
+        {"Int32", TypeKind::INT32}, {"Int64", TypeKind::INT64}, {"UInt8", TypeKind::UINT8},
+        {"UInt16", TypeKind::UINT16}, {"UInt32", TypeKind::UINT32}, {"UInt64", TypeKind::UINT64},
+        {"Float32", TypeKind::FLOAT32}, {"Float64", TypeKind::FLOAT64}, {"Bool", TypeKind::BOOL},
+        {"Date", TypeKind::DATE}, {"Nothing", TypeKind::NOTHING}};
+    for (auto [name, kind] : kSimple) {
+        if (text == name) {
+            type.kind = kind;
+            return type;
+        }
+    }
+    throw ClickHouseError(kUnknownType, "UNKNOWN_TYPE", "Unknown data type family: " + std::string(text));
+}
+
+std::string typeName(const ColumnType& type) {
+    std::string name;
+    switch (type.kind) {
+        case TypeKind::STRING: name = "String"; break;
+        case TypeKind::INT8: name = "Int8"; break;
+        case TypeKind::INT16: name = "Int16"; break;
+        case TypeKind::INT32: name = "Int32"; break;
+        case TypeKind::INT64: name = "Int64"; break;
+        case TypeKind::UINT8: name = "UInt8"; break;
+        case TypeKind::UINT16: name = "UInt16"; break;
+        case TypeKind::UINT32: name = "UInt32"; break;
+        case TypeKind::UINT64: name = "UInt64"; break;
+        case TypeKind::FLOAT32: name = "Float32"; break;
+        case TypeKind::FLOAT64: name = "Float64"; break;
+        case TypeKind::BOOL: name = "Bool"; break;
+        case TypeKind::DATE: name = "Date"; break;
+        case TypeKind::DATETIME: name = "DateTime"; break;
+        case TypeKind::DATETIME64: name = "DateTime64(" + std::to_string(type.scale) + ")"; break;
+        case TypeKind::NOTHING: name = "Nothing"; break;
+        case TypeKind::AGGREGATE_STATE:
+            name = "AggregateFunction(" + type.aggregateFunction;
+            for (const auto& arg : type.aggregateArgs) {
+                name += ", " + typeName(arg);
+            }
+            name += ')';
+            break;
+        case TypeKind::ENUM8:
+        case TypeKind::ENUM16: {
+            name = type.kind == TypeKind::ENUM8 ? "Enum8(" : "Enum16(";
+            for (size_t i = 0; i < type.enumValues.size(); ++i) {
+                name += (i ? ", '" : "'") + type.enumValues[i].first + "' = " + std::to_string(type.enumValues[i].second);
+            }
+            name += ')';
+            break;
+        }
+    }
+    if (type.lowCardinality) {
+        name = "LowCardinality(" + name + ")";
+    }
+    return type.nullable ? "Nullable(" + name + ")" : name;
+}
+
+Value coerce(const Value& value, const ColumnType& type) {
+    if (isNull(value)) {
+        // input_format_null_as_default: NULL into a non-Nullable column stores the default
+        return type.nullable ? Value(std::monostate{}) : defaultValue(type);
+    }
+
+    const auto* text = std::get_if<std::string>(&value);
+    switch (type.kind) {
+        case TypeKind::NOTHING:
+            return std::monostate{};
+
+        case TypeKind::AGGREGATE_STATE:
+            if (!text) {
+                throw error::cannotParse("Cannot convert a plain value to " + typeName(type));
+            }
+            return *text;
+
+        case TypeKind::STRING:
+            if (text) {
+                return *text;
+            }
+            if (const auto* number = std::get_if<double>(&value)) {
+                std::string out;
+                appendDouble(out, *number);
+                return out;
+            }
+            return std::holds_alternative<int64_t>(value) ? std::to_string(std::get<int64_t>(value))
+                                                          : std::to_string(std::get<uint64_t>(value));
+
+        case TypeKind::ENUM8:
+        case TypeKind::ENUM16:
+            if (text) {
+                enumCode(type, *text);
+                return *text;
+            }
+            return enumName(type, static_cast<int64_t>(toDouble(value)));
+
+        case TypeKind::FLOAT32:
+        case TypeKind::FLOAT64: {
+            if (!text) {
+                return toDouble(value);
+            }
+            std::string_view trimmed = trim(*text);
+            if (trimmed == "nan" || trimmed == "inf" || trimmed == "-inf") {
+                return trimmed == "nan" ? std::numeric_limits<double>::quiet_NaN()
+                                        : (trimmed[0] == '-' ? -1.0 : 1.0) * std::numeric_limits<double>::infinity();
+            }
+            auto parsed = parseNumber<double>(trimmed);
+            if (!parsed) {
+                throw error::cannotParse("Cannot parse input: expected Float64, got '" + *text + "'");
+            }
+            return *parsed;
+        }
+
+        case TypeKind::DATE:
+        case TypeKind::DATETIME:
+        case TypeKind::DATETIME64: {
+            int scale = type.kind == TypeKind::DATETIME64 ? type.scale : 0;
+            if (text) {
+                std::string_view trimmed = trim(*text);
+                std::optional<int64_t> ticks = allDigits(trimmed) ? parseNumber<int64_t>(trimmed) : parseDateTimeTicks(trimmed, scale);
+                if (!ticks) {
+                    throw error::cannotParse("Cannot parse DateTime from '" + *text + "'");
+                }
+                if (type.kind == TypeKind::DATE) {
+                    return static_cast<uint64_t>(allDigits(trimmed) ? *ticks : *ticks / 86400);
+                }
+                return type.kind == TypeKind::DATETIME ? Value(static_cast<uint64_t>(*ticks)) : Value(*ticks);
+            }
+            if (const auto* number = std::get_if<double>(&value)) {
+                // Fractional numbers are seconds
+                auto ticks = static_cast<int64_t>(std::llround(*number * static_cast<double>(pow10(scale))));
+                return type.kind == TypeKind::DATETIME64 ? Value(ticks) : Value(static_cast<uint64_t>(ticks));
+            }
+            // Integers are already in the column's unit (days, seconds or ticks)
+            int64_t integer = std::holds_alternative<int64_t>(value) ? std::get<int64_t>(value) : static_cast<int64_t>(std::get<uint64_t>(value));
+            return type.kind == TypeKind::DATETIME64 ? Value(integer) : Value(static_cast<uint64_t>(integer));
+        }
+
+        case TypeKind::BOOL:
+            if (text) {
+                std::string_view trimmed = trim(*text);
+                if (trimmed == "true" || trimmed == "1") return uint64_t{1};
+                if (trimmed == "false" || trimmed == "0") return uint64_t{0};
+                throw error::cannotParse("Cannot parse Bool from '" + *text + "'");
+            }
+            return uint64_t{toDouble(value) != 0.0};
+
+        default:
+            break;
+    }
+
+    // Integers
+    if (text) {
+        if (type.isSigned()) {
+            if (auto parsed = parseNumber<int64_t>(*text)) {
+                return *parsed;
+            }
+        } else if (auto parsed = parseNumber<uint64_t>(*text)) {
+            return *parsed;
+        }
+        throw error::cannotParse("Cannot parse " + typeName(type) + " from '" + *text + "'");
+    }
+    if (type.isSigned()) {
+        if (const auto* number = std::get_if<double>(&value)) return static_cast<int64_t>(*number);
+        if (const auto* number = std::get_if<uint64_t>(&value)) return static_cast<int64_t>(*number);
+        return value;
+    }
+    if (const auto* number = std::get_if<double>(&value)) return static_cast<uint64_t>(*number);
+    if (const auto* number = std::get_if<int64_t>(&value)) return static_cast<uint64_t>(*number);
+    return value;
+}
+
+bool isNull(const Value& value) {
+    return std::holds_alternative<std::monostate>(value);
+}
+
+double toDouble(const Value& value) {
+    if (const auto* number = std::get_if<double>(&value)) return *number;
+    if (const auto* number = std::get_if<int64_t>(&value)) return static_cast<double>(*number);
+    if (const auto* number = std::get_if<uint64_t>(&value)) return static_cast<double>(*number);
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        return parseNumber<double>(*text).value_or(0.0);
+    }
+    return 0.0;
+}
+
+int compareValues(const Value& lhs, const Value& rhs) {
+    if (isNull(lhs) || isNull(rhs)) {
+        return static_cast<int>(!isNull(lhs)) - static_cast<int>(!isNull(rhs));
+    }
+    const auto* leftText = std::get_if<std::string>(&lhs);
+    const auto* rightText = std::get_if<std::string>(&rhs);
+    if (leftText && rightText) {
+        int result = leftText->compare(*rightText);
+        return (result > 0) - (result < 0);
+    }
+    if (leftText || rightText) {
+        throw ClickHouseError(386, "NO_COMMON_TYPE", "There is no supertype for String and a number");
+    }
+    if (lhs.index() == rhs.index() && !std::holds_alternative<double>(lhs)) {
+        return lhs < rhs ? -1 : rhs < lhs ? 1 : 0;
+    }
+    const auto* leftSigned = std::get_if<int64_t>(&lhs);
+    const auto* rightSigned = std::get_if<int64_t>(&rhs);
+    if (leftSigned && std::holds_alternative<uint64_t>(rhs)) {
+        return *leftSigned < 0 ? -1 : compareValues(Value(static_cast<uint64_t>(*leftSigned)), rhs);
+    }
+    if (rightSigned && std::holds_alternative<uint64_t>(lhs)) {
+        return -compareValues(rhs, lhs);
+    }
+    double left = toDouble(lhs);
+    double right = toDouble(rhs);
+    return left < right ? -1 : right < left ? 1 : 0;
+}
+
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    auto yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+std::string formatDateTime(int64_t seconds) {
+    std::string out;
+    ColumnType type;
+    type.kind = TypeKind::DATETIME;
+    appendTemporal(out, Value(static_cast<uint64_t>(seconds)), type);
+    return out;
+}
+
+void appendJson(std::string& out, const Value& value, const ColumnType& type) {
+    if (isNull(value)) {
+        out += "null";
+        return;
+    }
+    switch (type.kind) {
+        case TypeKind::STRING:
+        case TypeKind::AGGREGATE_STATE:
+        case TypeKind::ENUM8:
+        case TypeKind::ENUM16:
+            appendJsonString(out, std::get<std::string>(value));
+            return;
+        case TypeKind::INT64:
+            // output_format_json_quote_64bit_integers is on by default
+            out += '"' + std::to_string(std::get<int64_t>(value)) + '"';
+            return;
+        case TypeKind::UINT64:
+            out += '"' + std::to_string(std::get<uint64_t>(value)) + '"';
+            return;
+        case TypeKind::BOOL:
+            out += std::get<uint64_t>(value) ? "true" : "false";
+            return;
+        case TypeKind::FLOAT32:
+        case TypeKind::FLOAT64: {
+            double number = std::get<double>(value);
+            if (std::isfinite(number)) {
+                appendDouble(out, number);
+            } else {
+                out += "null";
+            }
+            return;
+        }
+        case TypeKind::DATE:
+        case TypeKind::DATETIME:
+        case TypeKind::DATETIME64:
+            out += '"';
+            appendTemporal(out, value, type);
+            out += '"';
+            return;
+        default:
+            out += std::holds_alternative<int64_t>(value) ? std::to_string(std::get<int64_t>(value)) : std::to_string(std::get<uint64_t>(value));
+    }
+}
+
+void appendText(std::string& out, const Value& value, const ColumnType& type) {
+    if (isNull(value)) {
+        out += "\\N";
+        return;
+    }
+    switch (type.kind) {
+        case TypeKind::STRING:
+        case TypeKind::AGGREGATE_STATE:
+        case TypeKind::ENUM8:
+        case TypeKind::ENUM16:
+            for (char c : std::get<std::string>(value)) {
+                switch (c) {
+                    case '\\': out += "\\\\"; break;
+                    case '\t': out += "\\t"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\r': out += "\\r"; break;
+                    case '\0': out += "\\0"; break;
+                    default: out += c;
+                }
+            }
+            return;
+        case TypeKind::BOOL:
+            out += std::get<uint64_t>(value) ? "true" : "false";
+            return;
+        case TypeKind::FLOAT32:
+        case TypeKind::FLOAT64: {
+            double number = std::get<double>(value);
+            if (std::isnan(number)) {
+                out += "nan";
+            } else if (std::isinf(number)) {
+                out += number < 0 ? "-inf" : "inf";
+            } else {
+                appendDouble(out, number);
+            }
+            return;
+        }
+        case TypeKind::DATE:
+        case TypeKind::DATETIME:
+        case TypeKind::DATETIME64:
+            appendTemporal(out, value, type);
+            return;
+        default:
+            out += std::holds_alternative<int64_t>(value) ? std::to_string(std::get<int64_t>(value)) : std::to_string(std::get<uint64_t>(value));
+    }
+}
+
+void appendRowBinary(std::string& out, const Value& value, const ColumnType& type) {
+    if (type.nullable) {
+        out += static_cast<char>(isNull(value) ? 1 : 0);
+        if (isNull(value)) {
+            return;
+        }
+    }
+    switch (type.kind) {
+        case TypeKind::STRING:
+        case TypeKind::AGGREGATE_STATE: {
+            const auto& text = std::get<std::string>(value);
+            for (uint64_t length = text.size();; length >>= 7) {
+                if (length < 0x80) {
+                    out += static_cast<char>(length);
+                    break;
+                }
+                out += static_cast<char>((length & 0x7F) | 0x80);
+            }
+            out += text;
+            return;
+        }
+        case TypeKind::ENUM8: appendLittleEndian(out, static_cast<int8_t>(enumCode(type, std::get<std::string>(value)))); return;
+        case TypeKind::ENUM16: appendLittleEndian(out, static_cast<int16_t>(enumCode(type, std::get<std::string>(value)))); return;
+        case TypeKind::INT8: appendLittleEndian(out, static_cast<int8_t>(std::get<int64_t>(value))); return;
+        case TypeKind::INT16: appendLittleEndian(out, static_cast<int16_t>(std::get<int64_t>(value))); return;
+        case TypeKind::INT32: appendLittleEndian(out, static_cast<int32_t>(std::get<int64_t>(value))); return;
+        case TypeKind::INT64:
+        case TypeKind::DATETIME64: appendLittleEndian(out, std::get<int64_t>(value)); return;
+        case TypeKind::UINT8:
+        case TypeKind::BOOL: appendLittleEndian(out, static_cast<uint8_t>(std::get<uint64_t>(value))); return;
+        case TypeKind::UINT16:
+        case TypeKind::DATE: appendLittleEndian(out, static_cast<uint16_t>(std::get<uint64_t>(value))); return;
+        case TypeKind::UINT32:
+        case TypeKind::DATETIME: appendLittleEndian(out, static_cast<uint32_t>(std::get<uint64_t>(value))); return;
+        case TypeKind::UINT64: appendLittleEndian(out, std::get<uint64_t>(value)); return;
+        case TypeKind::FLOAT32: appendLittleEndian(out, static_cast<float>(std::get<double>(value))); return;
+        case TypeKind::FLOAT64: appendLittleEndian(out, std::get<double>(value)); return;
+        case TypeKind::NOTHING: return;
+    }
+}
+
+Value parseText(std::string_view field, const ColumnType& type) {
+    if (field == "\\N") {
+        return coerce(std::monostate{}, type);
+    }
+    std::string text;
+    text.reserve(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        if (field[i] != '\\' || i + 1 == field.size()) {
+            text += field[i];
+            continue;
+        }
+        switch (field[++i]) {
+            case 't': text += '\t'; break;
+            case 'n': text += '\n'; break;
+            case 'r': text += '\r'; break;
+            case '0': text += '\0'; break;
+            default: text += field[i];
+        }
+    }
+    return coerce(text, type);
+}
+
+Value fromJson(const nlohmann::json& value, const ColumnType& type) {
+    switch (value.type()) {
+        case nlohmann::json::value_t::null: return coerce(std::monostate{}, type);
+        case nlohmann::json::value_t::string: return coerce(value.get<std::string>(), type);
+        case nlohmann::json::value_t::boolean: return coerce(uint64_t{value.get<bool>()}, type);
+        case nlohmann::json::value_t::number_unsigned: return coerce(value.get<uint64_t>(), type);
+        case nlohmann::json::value_t::number_integer: return coerce(value.get<int64_t>(), type);
+        case nlohmann::json::value_t::number_float: return coerce(value.get<double>(), type);
+        default:
+            throw error::cannotParse("Cannot parse " + typeName(type) + " from JSON " + value.dump());
+    }
+}
+
+Value readRowBinary(const uint8_t*& data, const uint8_t* end, const ColumnType& type) {
+    if (type.nullable && readLittleEndian<uint8_t>(data, end) != 0) {
+        return std::monostate{};
+    }
+    switch (type.kind) {
+        case TypeKind::STRING:
+        case TypeKind::AGGREGATE_STATE: {
+            uint64_t length = 0;
+            for (int shift = 0;; shift += 7) {
+                auto byte = readLittleEndian<uint8_t>(data, end);
+                length |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80) || shift > 56) {
+                    break;
+                }
+            }
+            if (static_cast<uint64_t>(end - data) < length) {
+                throw ClickHouseError(kCannotReadAllData, "CANNOT_READ_ALL_DATA", "Cannot read all data in RowBinary format");
+            }
+            std::string text(reinterpret_cast<const char*>(data), length);
+            data += length;
+            return text;
+        }
+        case TypeKind::ENUM8: return enumName(type, readLittleEndian<int8_t>(data, end));
+        case TypeKind::ENUM16: return enumName(type, readLittleEndian<int16_t>(data, end));
+        case TypeKind::INT8: return int64_t{readLittleEndian<int8_t>(data, end)};
+        case TypeKind::INT16: return int64_t{readLittleEndian<int16_t>(data, end)};
+        case TypeKind::INT32: return int64_t{readLittleEndian<int32_t>(data, end)};
+        case TypeKind::INT64:
+        case TypeKind::DATETIME64: return readLittleEndian<int64_t>(data, end);
+        case TypeKind::UINT8:
+        case TypeKind::BOOL: return uint64_t{readLittleEndian<uint8_t>(data, end)};
+        case TypeKind::UINT16:
+        case TypeKind::DATE: return uint64_t{readLittleEndian<uint16_t>(data, end)};
+        case TypeKind::UINT32:
+        case TypeKind::DATETIME: return uint64_t{readLittleEndian<uint32_t>(data, end)};
+        case TypeKind::UINT64: return readLittleEndian<uint64_t>(data, end);
+        case TypeKind::FLOAT32: return static_cast<double>(readLittleEndian<float>(data, end));
+        case TypeKind::FLOAT64: return readLittleEndian<double>(data, end);
+        case TypeKind::NOTHING: return std::monostate{};
+    }
+    return std::monostate{};
+}
+
+} // namespace trading::fake_clickhouse
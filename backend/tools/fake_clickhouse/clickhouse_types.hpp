@@ -0,0 +1,104 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace trading::fake_clickhouse {
+
+// Exception carrying a ClickHouse error code, rendered like the real server:
+//   Code: 60. DB::Exception: Table default.x does not exist. (UNKNOWN_TABLE)
+class ClickHouseError : public std::runtime_error {
+public:
+    ClickHouseError(int code, std::string name, const std::string& message)
+        : std::runtime_error(message), code_(code), name_(std::move(name)) {}
+
+    int code() const { return code_; }
+    const std::string& name() const { return name_; }
+
+    // HTTP status the real server answers with for this code
+    int httpStatus() const;
+    std::string render() const;
+
+private:
+    int code_;
+    std::string name_;
+};
+
+namespace error {
+ClickHouseError syntax(const std::string& message);
+ClickHouseError unknownTable(const std::string& table);
+ClickHouseError unknownIdentifier(const std::string& name);
+ClickHouseError cannotParse(const std::string& message);
+ClickHouseError unknownQueryParameter(const std::string& name);
+ClickHouseError notImplemented(const std::string& message);
+} // namespace error
+
+enum class TypeKind {
+    STRING,
+    INT8, INT16, INT32, INT64,
+    UINT8, UINT16, UINT32, UINT64,
+    FLOAT32, FLOAT64,
+    BOOL,
+    DATE,           // Days since epoch
+    DATETIME,       // Seconds since epoch, UTC
+    DATETIME64,     // Ticks of 10^-scale seconds since epoch, UTC
+    ENUM8, ENUM16,
+    AGGREGATE_STATE, // AggregateFunction(f, args...): an opaque serialized state
+    NOTHING         // Type of NULL literals
+};
+
+struct ColumnType {
+    TypeKind kind = TypeKind::STRING;
+    int scale = 0;                                      // DateTime64 precision
+    bool nullable = false;
+    bool lowCardinality = false;                        // Serialized exactly like the inner type
+    std::vector<std::pair<std::string, int>> enumValues;
+    std::string aggregateFunction;                      // AggregateFunction name as written, e.g. argMin
+    std::vector<ColumnType> aggregateArgs;              // Argument types of the aggregate function
+
+    bool isSigned() const;
+    bool isUnsigned() const;
+    bool isFloat() const { return kind == TypeKind::FLOAT32 || kind == TypeKind::FLOAT64; }
+    bool isTemporal() const { return kind == TypeKind::DATE || kind == TypeKind::DATETIME || kind == TypeKind::DATETIME64; }
+    bool isEnum() const { return kind == TypeKind::ENUM8 || kind == TypeKind::ENUM16; }
+};
+
+// Storage per kind: STRING/ENUM as the string (enum name), AGGREGATE_STATE as
+// the state bytes, signed ints and
+// DateTime64 ticks as int64_t, unsigned ints, BOOL, DATE and DATETIME as
+// uint64_t, floats as double; monostate is NULL.
+using Value = std::variant<std::monostate, int64_t, uint64_t, double, std::string>;
+
+ColumnType parseType(std::string_view text);
+std::string typeName(const ColumnType& type);
+
+// Converts a literal or a value of another type into the storage of `type`
+Value coerce(const Value& value, const ColumnType& type);
+
+// Three-way comparison with numeric promotion; NULL sorts first
+int compareValues(const Value& lhs, const Value& rhs);
+bool isNull(const Value& value);
+double toDouble(const Value& value);
+
+// Civil time helpers (UTC)
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day);
+std::string formatDateTime(int64_t seconds);
+
+// Output formats
+void appendJson(std::string& out, const Value& value, const ColumnType& type);
+void appendText(std::string& out, const Value& value, const ColumnType& type);   // TabSeparated, escaped
+void appendRowBinary(std::string& out, const Value& value, const ColumnType& type);
+
+// Input formats; text input is one escaped TabSeparated field
+Value parseText(std::string_view text, const ColumnType& type);
+Value fromJson(const nlohmann::json& value, const ColumnType& type);
+// Advances `data`; throws CANNOT_READ_ALL_DATA on truncation
+Value readRowBinary(const uint8_t*& data, const uint8_t* end, const ColumnType& type);
+
+} // namespace trading::fake_clickhouse
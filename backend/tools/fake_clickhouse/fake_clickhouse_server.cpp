@@ -0,0 +1,580 @@
+#include "fake_clickhouse_server.hpp"
+#include "infrastructure/database/http_compression.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <optional>
+
+namespace trading::fake_clickhouse {
+
+namespace {
+
+constexpr int kAcceptPollMs = 100;       // How quickly stop() is noticed
+constexpr size_t kMaxHeaderBytes = 64 * 1024;
+constexpr size_t kMaxBodyBytes = 256 * 1024 * 1024;
+constexpr int kUnknownCompressionMethod = 89;
+
+namespace database = trading::infrastructure::database;
+
+bool sendAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+// Reads more bytes into `buffer`; false on EOF, error or shutdown
+bool receiveMore(int fd, std::string& buffer, const std::atomic<bool>& running) {
+    char chunk[16 * 1024];
+    while (running) {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            buffer.append(chunk, static_cast<size_t>(n));
+            return true;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            continue;  // Receive timeout; re-check running
+        }
+        return false;
+    }
+    return false;
+}
+
+std::string urlDecode(std::string_view text) {
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '+') {
+            decoded += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size() &&
+                   std::isxdigit(static_cast<unsigned char>(text[i + 1])) && std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            decoded += static_cast<char>(std::stoi(std::string(text.substr(i + 1, 2)), nullptr, 16));
+            i += 2;
+        } else {
+            decoded += text[i];
+        }
+    }
+    return decoded;
+}
+
+std::optional<std::string> queryParameter(std::string_view queryString, std::string_view name) {
+    while (!queryString.empty()) {
+        size_t end = queryString.find('&');
+        std::string_view pair = queryString.substr(0, end);
+        size_t equals = pair.find('=');
+        if (urlDecode(pair.substr(0, equals)) == name) {
+            return equals == std::string_view::npos ? std::string() : urlDecode(pair.substr(equals + 1));
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        queryString.remove_prefix(end + 1);
+    }
+    return std::nullopt;
+}
+
+// Every param_<name> of the URL, keyed by name
+QueryParameters queryParameters(std::string_view queryString) {
+    QueryParameters parameters;
+    while (!queryString.empty()) {
+        size_t end = queryString.find('&');
+        std::string_view pair = queryString.substr(0, end);
+        size_t equals = pair.find('=');
+        std::string name = urlDecode(pair.substr(0, equals));
+        if (name.rfind("param_", 0) == 0) {
+            parameters[name.substr(6)] = equals == std::string_view::npos ? std::string() : urlDecode(pair.substr(equals + 1));
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        queryString.remove_prefix(end + 1);
+    }
+    return parameters;
+}
+
+std::string lowerCase(std::string_view text) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+// A request body in the codec its Content-Encoding names
+std::string decodeBody(std::string_view body, const std::string& encoding) {
+    auto codec = database::parseHttpCompression(encoding);
+    if (!codec || *codec == database::HttpCompression::NONE) {
+        throw ClickHouseError(kUnknownCompressionMethod, "UNKNOWN_COMPRESSION_METHOD", "Unknown HTTP compression method: " + encoding);
+    }
+    try {
+        return database::decompressHttpBody(body, *codec);
+    } catch (const std::runtime_error& e) {
+        throw error::cannotParse(e.what());
+    }
+}
+
+// The first lz4 or zstd listed in Accept-Encoding; other codecs are answered uncompressed
+std::optional<database::HttpCompression> acceptedCodec(std::string_view acceptEncoding) {
+    while (!acceptEncoding.empty()) {
+        size_t comma = acceptEncoding.find(',');
+        std::string_view token = trim(acceptEncoding.substr(0, comma));
+        token = token.substr(0, token.find(';'));
+        auto codec = database::parseHttpCompression(trim(token));
+        if (codec && *codec != database::HttpCompression::NONE) {
+            return codec;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        acceptEncoding.remove_prefix(comma + 1);
+    }
+    return std::nullopt;
+}
+
+const char* reason(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default: return "Error";
+    }
+}
+
+std::string contentTypeFor(const std::string& format) {
+    if (format == "JSON") return "application/json; charset=UTF-8";
+    if (format == "JSONEachRow") return "application/x-ndjson; charset=UTF-8";
+    if (format.rfind("TabSeparated", 0) == 0) return "text/tab-separated-values; charset=UTF-8";
+    if (format.rfind("RowBinary", 0) == 0) return "application/octet-stream";
+    return "text/plain; charset=UTF-8";
+}
+
+// Decodes a chunked body starting at `offset`; returns the bytes consumed, or 0 if incomplete
+size_t decodeChunked(const std::string& buffer, size_t offset, std::string& body) {
+    size_t pos = offset;
+    body.clear();
+    while (true) {
+        size_t lineEnd = buffer.find("\r\n", pos);
+        if (lineEnd == std::string::npos) {
+            return 0;
+        }
+        size_t size = std::stoul(buffer.substr(pos, lineEnd - pos), nullptr, 16);
+        pos = lineEnd + 2;
+        if (size == 0) {
+            // Skip trailers up to the blank line
+            size_t end = buffer.find("\r\n", pos);
+            while (end != std::string::npos && end != pos) {
+                pos = end + 2;
+                end = buffer.find("\r\n", pos);
+            }
+            return end == std::string::npos ? 0 : end + 2 - offset;
+        }
+        if (buffer.size() < pos + size + 2) {
+            return 0;
+        }
+        body.append(buffer, pos, size);
+        pos += size + 2;
+    }
+}
+
+} // namespace
+
+FakeClickHouseServer::FakeClickHouseServer(FakeClickHouseConfig config)
+    : config_(std::move(config)), port_(config_.port), random_(config_.seed) {}
+
+FakeClickHouseServer::~FakeClickHouseServer() {
+    stop();
+}
+
+bool FakeClickHouseServer::start() {
+    if (running_) {
+        return true;
+    }
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        std::cerr << "[Fake ClickHouse] socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (::inet_pton(AF_INET, config_.host.c_str(), &addr.sin_addr) != 1) {
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd_, 128) < 0) {
+        std::cerr << "[Fake ClickHouse] Cannot listen on " << config_.host << ":" << port_ << ": " << std::strerror(errno) << std::endl;
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    socklen_t length = sizeof(addr);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+
+    running_ = true;
+    acceptThread_ = std::thread(&FakeClickHouseServer::acceptLoop, this);
+    return true;
+}
+
+void FakeClickHouseServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (acceptThread_.joinable()) {
+        acceptThread_.join();
+    }
+    ::close(listenFd_);
+    listenFd_ = -1;
+    reapConnections(true);
+}
+
+void FakeClickHouseServer::setLatency(std::chrono::microseconds latency, std::chrono::microseconds jitter) {
+    std::lock_guard<std::mutex> lock(injectionMutex_);
+    config_.latency = latency;
+    config_.jitter = jitter;
+}
+
+void FakeClickHouseServer::setFailureRate(double rate) {
+    std::lock_guard<std::mutex> lock(injectionMutex_);
+    config_.failureRate = rate;
+}
+
+FakeClickHouseStats FakeClickHouseServer::stats() const {
+    FakeClickHouseStats stats;
+    stats.requests = requests_.load();
+    stats.queries = queries_.load();
+    stats.errors = errors_.load();
+    stats.injectedFailures = injectedFailures_.load();
+    stats.droppedConnections = droppedConnections_.load();
+    stats.bytesIn = bytesIn_.load();
+    stats.bytesOut = bytesOut_.load();
+    return stats;
+}
+
+std::vector<std::string> FakeClickHouseServer::queryLog() const {
+    std::lock_guard<std::mutex> lock(logMutex_);
+    return {queryLog_.begin(), queryLog_.end()};
+}
+
+void FakeClickHouseServer::clearQueryLog() {
+    std::lock_guard<std::mutex> lock(logMutex_);
+    queryLog_.clear();
+}
+
+void FakeClickHouseServer::record(const std::string& query) {
+    std::lock_guard<std::mutex> lock(logMutex_);
+    queryLog_.push_back(query);
+    while (queryLog_.size() > config_.queryLogSize) {
+        queryLog_.pop_front();
+    }
+}
+
+bool FakeClickHouseServer::consume(std::atomic<uint32_t>& counter) {
+    uint32_t current = counter.load();
+    while (current > 0) {
+        if (counter.compare_exchange_weak(current, current - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FakeClickHouseServer::acceptLoop() {
+    pollfd listener{listenFd_, POLLIN, 0};
+    while (running_) {
+        reapConnections(false);
+        int ready = ::poll(&listener, 1, kAcceptPollMs);
+        if (ready <= 0) {
+            continue;
+        }
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+
+        // The timeout only bounds how long a blocked recv() takes to notice stop()
+        timeval timeout{0, kAcceptPollMs * 1000};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        Connection& ref = *connection;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            connections_.push_back(std::move(connection));
+        }
+        ref.thread = std::thread([this, &ref] {
+            serveConnection(ref);
+            ref.done = true;
+        });
+    }
+}
+
+void FakeClickHouseServer::reapConnections(bool all) {
+    std::vector<std::unique_ptr<Connection>> finished;
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        auto split = std::stable_partition(connections_.begin(), connections_.end(),
+                                           [all](const auto& connection) { return !all && !connection->done; });
+        std::move(split, connections_.end(), std::back_inserter(finished));
+        connections_.erase(split, connections_.end());
+    }
+    for (auto& connection : finished) {
+        if (connection->thread.joinable()) {
+            connection->thread.join();
+        }
+    }
+}
+
+void FakeClickHouseServer::serveConnection(Connection& connection) {
+    int fd = connection.fd;
+    std::string buffer;
+    std::string header;
+
+    while (running_) {
+        // Headers
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (buffer.size() > kMaxHeaderBytes || !receiveMore(fd, buffer, running_)) {
+                ::close(fd);
+                return;
+            }
+        }
+
+        Request request;
+        std::string_view head(buffer.data(), headerEnd);
+        std::string_view line = head.substr(0, head.find("\r\n"));
+        size_t methodEnd = line.find(' ');
+        size_t targetEnd = methodEnd == std::string_view::npos ? methodEnd : line.find(' ', methodEnd + 1);
+        if (targetEnd == std::string_view::npos) {
+            sendAll(fd, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            ::close(fd);
+            return;
+        }
+        request.method = std::string(line.substr(0, methodEnd));
+        std::string_view target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+        size_t question = target.find('?');
+        request.path = std::string(target.substr(0, question));
+        if (question != std::string_view::npos) {
+            request.query = std::string(target.substr(question + 1));
+        }
+        request.keepAlive = line.substr(targetEnd + 1) != "HTTP/1.0";
+
+        size_t contentLength = 0;
+        bool chunked = false;
+        size_t pos = line.size() + 2;
+        while (pos < head.size()) {
+            size_t end = head.find("\r\n", pos);
+            std::string_view field = head.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+            pos = end == std::string_view::npos ? head.size() : end + 2;
+            size_t colon = field.find(':');
+            if (colon == std::string_view::npos) {
+                continue;
+            }
+            std::string name = lowerCase(trim(field.substr(0, colon)));
+            std::string_view value = trim(field.substr(colon + 1));
+            if (name == "content-length") {
+                contentLength = std::stoull(std::string(value));
+            } else if (name == "transfer-encoding") {
+                chunked = lowerCase(value).find("chunked") != std::string::npos;
+            } else if (name == "connection") {
+                std::string lower = lowerCase(value);
+                request.keepAlive = lower.find("close") == std::string::npos &&
+                                    (request.keepAlive || lower.find("keep-alive") != std::string::npos);
+            } else if (name == "x-clickhouse-database") {
+                request.database = std::string(value);
+            } else if (name == "content-encoding") {
+                request.contentEncoding = lowerCase(value);
+            } else if (name == "accept-encoding") {
+                request.acceptEncoding = lowerCase(value);
+            }
+        }
+        if (contentLength > kMaxBodyBytes) {
+            sendAll(fd, "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            ::close(fd);
+            return;
+        }
+
+        // Body
+        size_t bodyStart = headerEnd + 4;
+        size_t consumed;
+        if (chunked) {
+            while ((consumed = decodeChunked(buffer, bodyStart, request.body)) == 0) {
+                if (buffer.size() - bodyStart > kMaxBodyBytes || !receiveMore(fd, buffer, running_)) {
+                    ::close(fd);
+                    return;
+                }
+            }
+        } else {
+            while (buffer.size() - bodyStart < contentLength) {
+                if (!receiveMore(fd, buffer, running_)) {
+                    ::close(fd);
+                    return;
+                }
+            }
+            request.body = buffer.substr(bodyStart, contentLength);
+            consumed = contentLength;
+        }
+        bytesIn_ += bodyStart + consumed;
+        buffer.erase(0, bodyStart + consumed);
+        ++requests_;
+
+        Response response;
+        if (!handle(request, response)) {
+            ++droppedConnections_;
+            ::close(fd);
+            return;
+        }
+
+        header.clear();
+        header += "HTTP/1.1 " + std::to_string(response.status) + " " + reason(response.status);
+        header += "\r\nContent-Type: " + response.contentType;
+        header += "\r\nContent-Length: " + std::to_string(response.body.size());
+        for (const auto& [name, value] : response.headers) {
+            header += "\r\n" + name + ": " + value;
+        }
+        header += request.keepAlive ? "\r\nConnection: Keep-Alive\r\nKeep-Alive: timeout=10" : "\r\nConnection: close";
+        header += "\r\n\r\n";
+        bytesOut_ += header.size() + response.body.size();
+        if (!sendAll(fd, header) || !sendAll(fd, response.body) || !request.keepAlive) {
+            break;
+        }
+    }
+    ::close(fd);
+}
+
+bool FakeClickHouseServer::handle(const Request& request, Response& response) {
+    if (consume(dropNext_)) {
+        return false;
+    }
+
+    std::chrono::microseconds delay;
+    bool fail;
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex_);
+        delay = config_.latency;
+        if (config_.jitter.count() > 0) {
+            delay += std::chrono::microseconds(std::uniform_int_distribution<int64_t>(0, config_.jitter.count())(random_));
+        }
+        fail = config_.failureRate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(random_) < config_.failureRate;
+    }
+    fail = consume(failNext_) || fail;
+    if (delay.count() > 0) {
+        std::this_thread::sleep_for(delay);
+    }
+    if (fail) {
+        ++injectedFailures_;
+        response.status = config_.failureStatus;
+        ClickHouseError injected(1002, "UNKNOWN_EXCEPTION", "Injected failure");
+        response.headers.emplace_back("X-ClickHouse-Exception-Code", std::to_string(injected.code()));
+        response.body = injected.render();
+        return true;
+    }
+
+    bool hasQuery = queryParameter(request.query, "query").has_value();
+    if ((request.path == "/" || request.path == "/ping") && request.method == "GET" && !hasQuery) {
+        response.body = "Ok.\n";
+        return true;
+    }
+    if (request.path != "/") {
+        response.status = 404;
+        response.body = "There is no handle " + request.path + "\n";
+        return true;
+    }
+    if (request.method != "POST" && request.method != "GET") {
+        response.status = 405;
+        response.body = "Method not allowed\n";
+        return true;
+    }
+    response = runQuery(request);
+    return true;
+}
+
+FakeClickHouseServer::Response FakeClickHouseServer::runQuery(const Request& request) {
+    Response response;
+    auto urlQuery = queryParameter(request.query, "query");
+    std::string database = queryParameter(request.query, "database").value_or(request.database);
+    if (database.empty()) {
+        database = "default";
+    }
+    std::string queryId = queryParameter(request.query, "query_id").value_or("fake-" + std::to_string(++queryIds_));
+    response.headers.emplace_back("X-ClickHouse-Query-Id", queryId);
+
+    ++queries_;
+    try {
+        std::string body = request.contentEncoding.empty() ? std::string() : decodeBody(request.body, request.contentEncoding);
+        std::string_view content = request.contentEncoding.empty() ? std::string_view(request.body) : std::string_view(body);
+        // With a `query` parameter the body is INSERT data; otherwise the body is the query
+        std::string_view query = urlQuery ? std::string_view(*urlQuery) : content;
+        std::string_view data = urlQuery ? content : std::string_view();
+        // Statements carrying inline data are truncated in the log
+        record(std::string(query.substr(0, std::min<size_t>(query.size(), 4096))));
+
+        QueryResult result = store_.execute(query, data, database, queryParameters(request.query));
+        response.contentType = contentTypeFor(result.format);
+        if (!result.format.empty()) {
+            response.headers.emplace_back("X-ClickHouse-Format", result.format);
+        }
+        response.headers.emplace_back("X-ClickHouse-Summary",
+            "{\"read_rows\":\"" + std::to_string(result.readRows) +
+            "\",\"read_bytes\":\"" + std::to_string(result.readBytes) +
+            "\",\"written_rows\":\"" + std::to_string(result.writtenRows) +
+            "\",\"written_bytes\":\"" + std::to_string(result.writtenRows ? data.size() + query.size() : 0) +
+            "\",\"total_rows_to_read\":\"" + std::to_string(result.readRows) +
+            "\",\"result_rows\":\"" + std::to_string(result.resultRows) +
+            "\",\"result_bytes\":\"" + std::to_string(result.body.size()) + "\"}");
+        response.body = std::move(result.body);
+    } catch (const ClickHouseError& e) {
+        ++errors_;
+        response.status = e.httpStatus();
+        response.headers.emplace_back("X-ClickHouse-Exception-Code", std::to_string(e.code()));
+        response.body = e.render();
+    } catch (const std::exception& e) {
+        ++errors_;
+        ClickHouseError wrapped(1001, "STD_EXCEPTION", e.what());
+        response.status = wrapped.httpStatus();
+        response.headers.emplace_back("X-ClickHouse-Exception-Code", std::to_string(wrapped.code()));
+        response.body = wrapped.render();
+    }
+
+    if (queryParameter(request.query, "enable_http_compression").value_or("0") == "1") {
+        if (auto codec = acceptedCodec(request.acceptEncoding)) {
+            response.body = database::compressHttpBody(response.body, *codec);
+            response.headers.emplace_back("Content-Encoding", std::string(database::httpCompressionName(*codec)));
+        }
+    }
+    return response;
+}
+
+} // namespace trading::fake_clickhouse
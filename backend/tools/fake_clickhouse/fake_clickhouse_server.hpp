@@ -0,0 +1,134 @@
+#pragma once
+
+#include "fake_clickhouse_store.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trading::fake_clickhouse {
+
+struct FakeClickHouseConfig {
+    std::string host = "127.0.0.1";
+    int port = 0;                                  // 0 binds an ephemeral port, see port()
+    std::chrono::microseconds latency{0};          // Added before every response
+    std::chrono::microseconds jitter{0};           // Uniform extra delay in [0, jitter]
+    double failureRate = 0.0;                      // Probability a request fails with failureStatus
+    int failureStatus = 500;
+    uint64_t seed = 42;                            // Jitter and failures are reproducible per seed
+    size_t queryLogSize = 256;
+};
+
+struct FakeClickHouseStats {
+    uint64_t requests = 0;
+    uint64_t queries = 0;
+    uint64_t errors = 0;                           // Queries rejected by the store
+    uint64_t injectedFailures = 0;
+    uint64_t droppedConnections = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+};
+
+// Stand-in for the ClickHouse HTTP interface (port 8123) so the repository can be
+// tested and benchmarked without a server. Speaks HTTP/1.1 with keep-alive, one
+// thread per connection; queries come from the POST body or the `query` URL
+// parameter with the body as INSERT data. Bodies may be lz4 or zstd encoded both
+// ways, as with enable_http_compression=1. Latency and failures are injected per
+// request, before the query runs, so injected failures never change the store.
+class FakeClickHouseServer {
+public:
+    explicit FakeClickHouseServer(FakeClickHouseConfig config = {});
+    ~FakeClickHouseServer();
+
+    FakeClickHouseServer(const FakeClickHouseServer&) = delete;
+    FakeClickHouseServer& operator=(const FakeClickHouseServer&) = delete;
+
+    // Returns false when the listening socket cannot be set up
+    bool start();
+    void stop();
+
+    int port() const { return port_; }
+    const std::string& host() const { return config_.host; }
+    FakeClickHouseStore& store() { return store_; }
+
+    void setLatency(std::chrono::microseconds latency, std::chrono::microseconds jitter = std::chrono::microseconds{0});
+    void setFailureRate(double rate);
+    // The next `count` requests fail with the configured status
+    void failNext(uint32_t count) { failNext_ = count; }
+    // The next `count` requests are closed without a response, like a crashed server
+    void dropNext(uint32_t count) { dropNext_ = count; }
+
+    FakeClickHouseStats stats() const;
+    // The last queryLogSize statements in arrival order
+    std::vector<std::string> queryLog() const;
+    void clearQueryLog();
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::thread thread;
+        std::atomic<bool> done{false};
+    };
+
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string query;            // URL query string, undecoded
+        std::string body;
+        std::string database;         // X-ClickHouse-Database header
+        std::string contentEncoding;  // Codec of body, empty when plain
+        std::string acceptEncoding;
+        bool keepAlive = true;
+    };
+
+    struct Response {
+        int status = 200;
+        std::string contentType = "text/plain; charset=UTF-8";
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string body;
+    };
+
+    FakeClickHouseConfig config_;
+    FakeClickHouseStore store_;
+    int port_;
+    int listenFd_ = -1;
+    std::thread acceptThread_;
+    std::atomic<bool> running_{false};
+
+    std::mutex connectionsMutex_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    mutable std::mutex injectionMutex_;
+    std::mt19937_64 random_;
+    std::atomic<uint32_t> failNext_{0};
+    std::atomic<uint32_t> dropNext_{0};
+
+    mutable std::mutex logMutex_;
+    std::deque<std::string> queryLog_;
+    std::atomic<uint64_t> queryIds_{0};
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> queries_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> injectedFailures_{0};
+    std::atomic<uint64_t> droppedConnections_{0};
+    std::atomic<uint64_t> bytesIn_{0};
+    std::atomic<uint64_t> bytesOut_{0};
+
+    void acceptLoop();
+    void reapConnections(bool all);
+    void serveConnection(Connection& connection);
+    // Returns false when the connection should be dropped without a response
+    bool handle(const Request& request, Response& response);
+    Response runQuery(const Request& request);
+    bool consume(std::atomic<uint32_t>& counter);
+    void record(const std::string& query);
+};
+
+} // namespace trading::fake_clickhouse
@@ -0,0 +1,2418 @@
+#include "fake_clickhouse_store.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace trading::fake_clickhouse {
+
+using Row = std::vector<Value>;
+using ExprPtr = std::shared_ptr<const Expr>;
+
+struct Expr {
+    enum class Kind { LITERAL, COLUMN, STAR, FUNCTION, BINARY, NOT, NEGATE, IN, IS_NULL, BETWEEN };
+
+    Kind kind = Kind::LITERAL;
+    Value literal;
+    ColumnType literalType;
+    std::string qualifier;
+    std::string name;        // Column name, lower-case function name or operator
+    std::vector<ExprPtr> args;
+    bool negated = false;    // NOT IN, IS NOT NULL, NOT BETWEEN
+    std::string text;        // Source text; names result columns without an alias
+};
+
+namespace {
+
+constexpr int kUnknownDatabase = 81;
+constexpr int kTableAlreadyExists = 57;
+constexpr int kUnknownFunction = 46;
+constexpr int kUnknownFormat = 73;
+constexpr int kIllegalAggregation = 184;
+constexpr int kIllegalTypeOfArgument = 43;
+
+// ---------------------------------------------------------------------------
+// Lexer
+
+struct Token {
+    enum class Kind { IDENT, QUOTED_IDENT, NUMBER, STRING, SYMBOL, END };
+
+    Kind kind = Kind::END;
+    std::string text;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// Tokens are produced on demand so that INSERT data after FORMAT is never lexed
+class Lexer {
+public:
+    explicit Lexer(std::string_view source) : source_(source) {}
+
+    const Token& peek() {
+        if (!peeked_) {
+            token_ = scan();
+            peeked_ = true;
+        }
+        return token_;
+    }
+
+    Token next() {
+        peek();
+        peeked_ = false;
+        consumed_ = token_.end;
+        return token_;
+    }
+
+    size_t consumed() const { return consumed_; }
+    std::string_view source() const { return source_; }
+
+private:
+    std::string_view source_;
+    size_t pos_ = 0;
+    size_t consumed_ = 0;
+    Token token_;
+    bool peeked_ = false;
+
+    void skipSpaceAndComments() {
+        while (pos_ < source_.size()) {
+            char c = source_[pos_];
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                ++pos_;
+            } else if (source_.compare(pos_, 2, "--") == 0) {
+                size_t newline = source_.find('\n', pos_);
+                pos_ = newline == std::string_view::npos ? source_.size() : newline + 1;
+            } else if (source_.compare(pos_, 2, "/*") == 0) {
+                size_t close = source_.find("*/", pos_ + 2);
+                pos_ = close == std::string_view::npos ? source_.size() : close + 2;
+            } else {
+                return;
+            }
+        }
+    }
+
+    std::string quoted(char quote) {
+        std::string text;
+        ++pos_;
+        while (pos_ < source_.size()) {
+            char c = source_[pos_++];
+            if (c == '\\' && pos_ < source_.size()) {
+                char escaped = source_[pos_++];
+                switch (escaped) {
+                    case 'n': text += '\n'; break;
+                    case 't': text += '\t'; break;
+                    case 'r': text += '\r'; break;
+                    case '0': text += '\0'; break;
+                    default: text += escaped;
+                }
+            } else if (c == quote) {
+                if (pos_ < source_.size() && source_[pos_] == quote) {
+                    text += quote;
+                    ++pos_;
+                } else {
+                    return text;
+                }
+            } else {
+                text += c;
+            }
+        }
+        throw error::syntax("unterminated quoted literal");
+    }
+
+    Token scan() {
+        skipSpaceAndComments();
+        Token token;
+        token.begin = pos_;
+        if (pos_ >= source_.size()) {
+            token.end = pos_;
+            return token;
+        }
+
+        char c = source_[pos_];
+        auto isWord = [](char ch) { return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_'; };
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = pos_;
+            while (pos_ < source_.size() && isWord(source_[pos_])) {
+                ++pos_;
+            }
+            token.kind = Token::Kind::IDENT;
+            token.text = std::string(source_.substr(start, pos_ - start));
+        } else if (c == '`' || c == '"') {
+            token.kind = Token::Kind::QUOTED_IDENT;
+            token.text = quoted(c);
+        } else if (c == '\'') {
+            token.kind = Token::Kind::STRING;
+            token.text = quoted(c);
+        } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                   (c == '.' && pos_ + 1 < source_.size() && std::isdigit(static_cast<unsigned char>(source_[pos_ + 1])))) {
+            size_t start = pos_;
+            while (pos_ < source_.size() && (std::isdigit(static_cast<unsigned char>(source_[pos_])) || source_[pos_] == '.')) {
+                ++pos_;
+            }
+            if (pos_ < source_.size() && (source_[pos_] == 'e' || source_[pos_] == 'E')) {
+                ++pos_;
+                if (pos_ < source_.size() && (source_[pos_] == '+' || source_[pos_] == '-')) {
+                    ++pos_;
+                }
+                while (pos_ < source_.size() && std::isdigit(static_cast<unsigned char>(source_[pos_]))) {
+                    ++pos_;
+                }
+            }
+            token.kind = Token::Kind::NUMBER;
+            token.text = std::string(source_.substr(start, pos_ - start));
+        } else {
+            static const char* kTwoChar[] = {"<=", ">=", "!=", "<>", "==", "||"};
+            token.kind = Token::Kind::SYMBOL;
+            token.text = std::string(1, c);
+            for (const char* symbol : kTwoChar) {
+                if (source_.compare(pos_, 2, symbol) == 0) {
+                    token.text = symbol;
+                    break;
+                }
+            }
+            pos_ += token.text.size();
+        }
+        token.end = pos_;
+        return token;
+    }
+};
+
+bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+// ---------------------------------------------------------------------------
+// AST
+
+struct SelectQuery;
+
+struct TableRef {
+    std::string table;                          // Qualified name, empty for subqueries
+    std::shared_ptr<SelectQuery> subquery;
+    std::string alias;
+    bool final = false;                         // FROM t FINAL
+};
+
+struct JoinClause {
+    TableRef right;
+    ExprPtr on;
+    bool left = false;
+};
+
+struct SelectItem {
+    ExprPtr expr;
+    std::string alias;
+};
+
+struct OrderItem {
+    ExprPtr expr;
+    bool descending = false;
+};
+
+struct SelectQuery {
+    bool distinct = false;
+    std::vector<SelectItem> items;
+    std::optional<TableRef> from;
+    std::vector<JoinClause> joins;
+    ExprPtr where;
+    std::vector<ExprPtr> groupBy;
+    ExprPtr having;
+    std::vector<OrderItem> orderBy;
+    std::optional<uint64_t> limit;
+    uint64_t offset = 0;
+    std::string format;
+};
+
+ColumnType literalTypeOf(const Value& value) {
+    ColumnType type;
+    if (isNull(value)) {
+        type.kind = TypeKind::NOTHING;
+        type.nullable = true;
+    } else if (const auto* number = std::get_if<uint64_t>(&value)) {
+        type.kind = *number <= 0xFF ? TypeKind::UINT8 : *number <= 0xFFFF ? TypeKind::UINT16
+                  : *number <= 0xFFFFFFFFULL ? TypeKind::UINT32 : TypeKind::UINT64;
+    } else if (const auto* number = std::get_if<int64_t>(&value)) {
+        type.kind = *number >= -128 ? TypeKind::INT8 : *number >= -32768 ? TypeKind::INT16
+                  : *number >= std::numeric_limits<int32_t>::min() ? TypeKind::INT32 : TypeKind::INT64;
+    } else if (std::holds_alternative<double>(value)) {
+        type.kind = TypeKind::FLOAT64;
+    }
+    return type;
+}
+
+std::shared_ptr<Expr> literalExpr(Value value, std::string text) {
+    auto expr = std::make_shared<Expr>();
+    expr->kind = Expr::Kind::LITERAL;
+    expr->literalType = literalTypeOf(value);
+    expr->literal = std::move(value);
+    expr->text = std::move(text);
+    return expr;
+}
+
+// ---------------------------------------------------------------------------
+// Parser
+
+bool isReserved(std::string_view word) {
+    static const char* kReserved[] = {
+        "FROM", "WHERE", "GROUP", "ORDER", "LIMIT", "OFFSET", "FORMAT", "SETTINGS", "HAVING", "INNER",
+        "LEFT", "RIGHT", "FULL", "CROSS", "JOIN", "ON", "USING", "AS", "UNION", "ALL", "ANY", "FINAL",
+        "PREWHERE", "SAMPLE", "AND", "OR", "NOT", "IN", "IS", "BETWEEN", "LIKE", "ASC", "DESC", "VALUES",
+        "SELECT", "NULLS", "OUTER"};
+    for (const char* reserved : kReserved) {
+        if (equalsIgnoreCase(word, reserved)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+class Parser {
+public:
+    explicit Parser(std::string_view text, const QueryParameters* parameters = nullptr)
+        : lexer_(text), parameters_(parameters) {}
+
+    Lexer& lexer() { return lexer_; }
+
+    bool peekKeyword(std::string_view keyword) {
+        const Token& token = lexer_.peek();
+        return token.kind == Token::Kind::IDENT && equalsIgnoreCase(token.text, keyword);
+    }
+
+    bool acceptKeyword(std::string_view keyword) {
+        if (!peekKeyword(keyword)) {
+            return false;
+        }
+        lexer_.next();
+        return true;
+    }
+
+    void expectKeyword(std::string_view keyword) {
+        if (!acceptKeyword(keyword)) {
+            throw unexpected(std::string(keyword));
+        }
+    }
+
+    bool peekSymbol(std::string_view symbol) {
+        const Token& token = lexer_.peek();
+        return token.kind == Token::Kind::SYMBOL && token.text == symbol;
+    }
+
+    bool acceptSymbol(std::string_view symbol) {
+        if (!peekSymbol(symbol)) {
+            return false;
+        }
+        lexer_.next();
+        return true;
+    }
+
+    void expectSymbol(std::string_view symbol) {
+        if (!acceptSymbol(symbol)) {
+            throw unexpected("'" + std::string(symbol) + "'");
+        }
+    }
+
+    bool atEnd() {
+        acceptSymbol(";");
+        return lexer_.peek().kind == Token::Kind::END;
+    }
+
+    void expectEnd() {
+        if (!atEnd()) {
+            throw unexpected("end of query");
+        }
+    }
+
+    std::string identifier() {
+        const Token& token = lexer_.peek();
+        if (token.kind != Token::Kind::IDENT && token.kind != Token::Kind::QUOTED_IDENT) {
+            throw unexpected("identifier");
+        }
+        return lexer_.next().text;
+    }
+
+    std::string qualifiedName() {
+        std::string name = identifier();
+        if (acceptSymbol(".")) {
+            name += "." + identifier();
+        }
+        return name;
+    }
+
+    // Implicit alias: an identifier that does not start the next clause
+    std::optional<std::string> alias() {
+        if (acceptKeyword("AS")) {
+            return identifier();
+        }
+        const Token& token = lexer_.peek();
+        if (token.kind == Token::Kind::QUOTED_IDENT || (token.kind == Token::Kind::IDENT && !isReserved(token.text))) {
+            return lexer_.next().text;
+        }
+        return std::nullopt;
+    }
+
+    ClickHouseError unexpected(const std::string& expected) {
+        const Token& token = lexer_.peek();
+        std::string found = token.kind == Token::Kind::END ? "end of query" : "'" + token.text + "'";
+        return error::syntax("failed at position " + std::to_string(token.begin + 1) + " (" + found + "): expected " + expected);
+    }
+
+    ExprPtr expression() { return parseOr(); }
+
+    std::vector<ExprPtr> expressionList() {
+        std::vector<ExprPtr> list;
+        do {
+            list.push_back(expression());
+        } while (acceptSymbol(","));
+        return list;
+    }
+
+    std::shared_ptr<SelectQuery> select() {
+        expectKeyword("SELECT");
+        auto query = std::make_shared<SelectQuery>();
+        query->distinct = acceptKeyword("DISTINCT");
+        do {
+            SelectItem item;
+            item.expr = expression();
+            item.alias = alias().value_or("");
+            query->items.push_back(std::move(item));
+        } while (acceptSymbol(","));
+
+        if (acceptKeyword("FROM")) {
+            query->from = tableRef();
+            while (true) {
+                JoinClause join;
+                if (acceptKeyword("LEFT")) {
+                    acceptKeyword("OUTER");
+                    join.left = true;
+                } else if (acceptKeyword("ANY") || peekKeyword("RIGHT") || peekKeyword("FULL") || peekKeyword("CROSS")) {
+                    throw error::notImplemented("This JOIN kind");
+                } else {
+                    acceptKeyword("ALL");
+                    acceptKeyword("INNER");
+                }
+                if (!acceptKeyword("JOIN")) {
+                    break;
+                }
+                join.right = tableRef();
+                expectKeyword("ON");
+                join.on = expression();
+                query->joins.push_back(std::move(join));
+            }
+        }
+        if (acceptKeyword("WHERE")) {
+            query->where = expression();
+        }
+        if (acceptKeyword("GROUP")) {
+            expectKeyword("BY");
+            query->groupBy = expressionList();
+        }
+        if (acceptKeyword("HAVING")) {
+            query->having = expression();
+        }
+        if (acceptKeyword("ORDER")) {
+            expectKeyword("BY");
+            do {
+                OrderItem item;
+                item.expr = expression();
+                item.descending = acceptKeyword("DESC");
+                if (!item.descending) {
+                    acceptKeyword("ASC");
+                }
+                if (acceptKeyword("NULLS")) {
+                    if (!acceptKeyword("FIRST")) {
+                        expectKeyword("LAST");
+                    }
+                }
+                query->orderBy.push_back(std::move(item));
+            } while (acceptSymbol(","));
+        }
+        if (acceptKeyword("LIMIT")) {
+            uint64_t first = unsignedLiteral();
+            if (acceptSymbol(",")) {
+                query->offset = first;
+                query->limit = unsignedLiteral();
+            } else {
+                query->limit = first;
+                if (acceptKeyword("OFFSET")) {
+                    query->offset = unsignedLiteral();
+                }
+            }
+        }
+        skipSettings();
+        if (acceptKeyword("FORMAT")) {
+            query->format = identifier();
+        }
+        return query;
+    }
+
+    void skipSettings() {
+        if (!acceptKeyword("SETTINGS")) {
+            return;
+        }
+        do {
+            identifier();
+            expectSymbol("=");
+            lexer_.next();
+        } while (acceptSymbol(","));
+    }
+
+    uint64_t unsignedLiteral() {
+        if (peekSymbol("{")) {
+            auto [type, value] = parameter();
+            return std::get<uint64_t>(parseText(value, parseType("UInt64")));
+        }
+        const Token& token = lexer_.peek();
+        if (token.kind != Token::Kind::NUMBER) {
+            throw unexpected("number");
+        }
+        return std::stoull(lexer_.next().text);
+    }
+
+    // {name:Type}: the declared type and the param_<name> value, still in
+    // the escaped text format ClickHouse reads parameters in
+    std::pair<std::string, std::string> parameter() {
+        expectSymbol("{");
+        std::string name = identifier();
+        expectSymbol(":");
+        size_t typeBegin = lexer_.peek().begin;
+        while (!peekSymbol("}")) {
+            if (lexer_.peek().kind == Token::Kind::END) {
+                throw unexpected("'}'");
+            }
+            lexer_.next();
+        }
+        std::string type(lexer_.source().substr(typeBegin, lexer_.peek().begin - typeBegin));
+        lexer_.next();
+        while (!type.empty() && std::isspace(static_cast<unsigned char>(type.back()))) {
+            type.pop_back();
+        }
+        auto value = parameters_ ? parameters_->find(name) : QueryParameters::const_iterator();
+        if (!parameters_ || value == parameters_->end()) {
+            throw error::unknownQueryParameter(name);
+        }
+        return {type, value->second};
+    }
+
+    ExprPtr scalarParameter() {
+        size_t begin = lexer_.peek().begin;
+        auto [typeName, value] = parameter();
+        if (typeName.rfind("Array(", 0) == 0) {
+            throw error::notImplemented("Array parameters outside IN");
+        }
+        ColumnType type = parseType(typeName);
+        auto expr = literalExpr(parseText(value, type), textFrom(begin));
+        expr->literalType = type;
+        return expr;
+    }
+
+    // `x IN {name:Array(T)}`: one literal per element of the ['a', 'b'] value
+    std::vector<ExprPtr> arrayParameter() {
+        size_t begin = lexer_.peek().begin;
+        auto [typeName, value] = parameter();
+        if (typeName.rfind("Array(", 0) != 0 || typeName.back() != ')') {
+            throw error::notImplemented("IN with a non-Array parameter");
+        }
+        ColumnType type = parseType(std::string_view(typeName).substr(6, typeName.size() - 7));
+        std::string text = textFrom(begin);
+        std::vector<ExprPtr> elements;
+        size_t pos = value.find_first_not_of(' ');
+        if (pos == std::string::npos || value[pos] != '[') {
+            throw error::cannotParse("Array parameter must start with '['");
+        }
+        ++pos;
+        while (true) {
+            pos = value.find_first_not_of(' ', pos);
+            if (pos == std::string::npos) {
+                throw error::cannotParse("Array parameter must end with ']'");
+            }
+            if (value[pos] == ']' && elements.empty()) {
+                break;
+            }
+            std::string element;
+            if (value[pos] == '\'') {
+                for (++pos; pos < value.size() && value[pos] != '\''; ++pos) {
+                    element += value[pos] == '\\' && pos + 1 < value.size() ? value[++pos] : value[pos];
+                }
+                ++pos;
+            } else {
+                size_t end = value.find_first_of(",]", pos);
+                element = value.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+                pos = end == std::string::npos ? value.size() : end;
+            }
+            auto literal = literalExpr(coerce(Value(std::move(element)), type), text);
+            literal->literalType = type;
+            elements.push_back(std::move(literal));
+            pos = value.find_first_not_of(' ', pos);
+            if (pos != std::string::npos && value[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (pos == std::string::npos || value[pos] != ']') {
+                throw error::cannotParse("Array parameter must end with ']'");
+            }
+            break;
+        }
+        return elements;
+    }
+
+private:
+    Lexer lexer_;
+    const QueryParameters* parameters_;
+
+    std::string textFrom(size_t begin) {
+        auto text = lexer_.source().substr(begin, lexer_.consumed() - begin);
+        return std::string(text);
+    }
+
+    std::shared_ptr<Expr> node(Expr::Kind kind, std::string name, std::vector<ExprPtr> args, size_t begin) {
+        auto expr = std::make_shared<Expr>();
+        expr->kind = kind;
+        expr->name = std::move(name);
+        expr->args = std::move(args);
+        expr->text = textFrom(begin);
+        return expr;
+    }
+
+    TableRef tableRef() {
+        TableRef ref;
+        if (acceptSymbol("(")) {
+            ref.subquery = select();
+            expectSymbol(")");
+        } else {
+            ref.table = qualifiedName();
+        }
+        ref.final = acceptKeyword("FINAL");
+        ref.alias = alias().value_or("");
+        ref.final = acceptKeyword("FINAL") || ref.final;
+        if (ref.final && ref.subquery) {
+            throw error::notImplemented("FINAL on a subquery");
+        }
+        return ref;
+    }
+
+    ExprPtr parseOr() {
+        size_t begin = lexer_.peek().begin;
+        ExprPtr lhs = parseAnd();
+        while (acceptKeyword("OR")) {
+            lhs = node(Expr::Kind::BINARY, "OR", {lhs, parseAnd()}, begin);
+        }
+        return lhs;
+    }
+
+    ExprPtr parseAnd() {
+        size_t begin = lexer_.peek().begin;
+        ExprPtr lhs = parseNot();
+        while (acceptKeyword("AND")) {
+            lhs = node(Expr::Kind::BINARY, "AND", {lhs, parseNot()}, begin);
+        }
+        return lhs;
+    }
+
+    ExprPtr parseNot() {
+        size_t begin = lexer_.peek().begin;
+        if (acceptKeyword("NOT")) {
+            return node(Expr::Kind::NOT, "NOT", {parseNot()}, begin);
+        }
+        return parseComparison();
+    }
+
+    ExprPtr parseComparison() {
+        size_t begin = lexer_.peek().begin;
+        ExprPtr lhs = parseAdditive();
+
+        static const char* kComparisons[] = {"=", "==", "!=", "<>", "<", "<=", ">", ">="};
+        for (const char* op : kComparisons) {
+            if (acceptSymbol(op)) {
+                std::string name = op;
+                name = name == "==" ? "=" : name == "<>" ? "!=" : name;
+                return node(Expr::Kind::BINARY, name, {lhs, parseAdditive()}, begin);
+            }
+        }
+
+        if (acceptKeyword("IS")) {
+            bool negated = acceptKeyword("NOT");
+            expectKeyword("NULL");
+            auto expr = node(Expr::Kind::IS_NULL, "IS NULL", {lhs}, begin);
+            expr->negated = negated;
+            return expr;
+        }
+
+        bool negated = acceptKeyword("NOT");
+        if (acceptKeyword("IN")) {
+            if (peekSymbol("{")) {
+                std::vector<ExprPtr> args{lhs};
+                for (auto& element : arrayParameter()) {
+                    args.push_back(std::move(element));
+                }
+                auto expr = node(Expr::Kind::IN, "IN", std::move(args), begin);
+                expr->negated = negated;
+                return expr;
+            }
+            expectSymbol("(");
+            if (peekKeyword("SELECT")) {
+                throw error::notImplemented("IN (subquery)");
+            }
+            std::vector<ExprPtr> args{lhs};
+            if (!peekSymbol(")")) {
+                for (auto& item : expressionList()) {
+                    args.push_back(std::move(item));
+                }
+            }
+            expectSymbol(")");
+            auto expr = node(Expr::Kind::IN, "IN", std::move(args), begin);
+            expr->negated = negated;
+            return expr;
+        }
+        if (acceptKeyword("BETWEEN")) {
+            ExprPtr low = parseAdditive();
+            expectKeyword("AND");
+            auto expr = node(Expr::Kind::BETWEEN, "BETWEEN", {lhs, low, parseAdditive()}, begin);
+            expr->negated = negated;
+            return expr;
+        }
+        if (negated) {
+            throw unexpected("IN or BETWEEN after NOT");
+        }
+        return lhs;
+    }
+
+    ExprPtr parseAdditive() {
+        size_t begin = lexer_.peek().begin;
+        ExprPtr lhs = parseMultiplicative();
+        while (peekSymbol("+") || peekSymbol("-")) {
+            std::string op = lexer_.next().text;
+            lhs = node(Expr::Kind::BINARY, op, {lhs, parseMultiplicative()}, begin);
+        }
+        return lhs;
+    }
+
+    ExprPtr parseMultiplicative() {
+        size_t begin = lexer_.peek().begin;
+        ExprPtr lhs = parseUnary();
+        while (peekSymbol("*") || peekSymbol("/") || peekSymbol("%")) {
+            std::string op = lexer_.next().text;
+            lhs = node(Expr::Kind::BINARY, op, {lhs, parseUnary()}, begin);
+        }
+        return lhs;
+    }
+
+    ExprPtr parseUnary() {
+        size_t begin = lexer_.peek().begin;
+        if (acceptSymbol("-")) {
+            ExprPtr operand = parseUnary();
+            if (operand->kind == Expr::Kind::LITERAL) {
+                // Fold negative literals so they keep a literal's type
+                const Value& value = operand->literal;
+                if (const auto* number = std::get_if<uint64_t>(&value)) {
+                    return literalExpr(Value(-static_cast<int64_t>(*number)), textFrom(begin));
+                }
+                if (const auto* number = std::get_if<double>(&value)) {
+                    return literalExpr(Value(-*number), textFrom(begin));
+                }
+            }
+            return node(Expr::Kind::NEGATE, "-", {operand}, begin);
+        }
+        return parsePrimary();
+    }
+
+    ExprPtr parsePrimary() {
+        const Token& token = lexer_.peek();
+        size_t begin = token.begin;
+
+        switch (token.kind) {
+            case Token::Kind::NUMBER: {
+                std::string text = lexer_.next().text;
+                if (text.find_first_of(".eE") == std::string::npos) {
+                    try {
+                        return literalExpr(Value(static_cast<uint64_t>(std::stoull(text))), text);
+                    } catch (const std::out_of_range&) {
+                        // Falls through to Float64 like ClickHouse does for huge literals
+                    }
+                }
+                return literalExpr(Value(std::stod(text)), text);
+            }
+            case Token::Kind::STRING: {
+                std::string text = lexer_.next().text;
+                return literalExpr(Value(text), textFrom(begin));
+            }
+            case Token::Kind::SYMBOL:
+                if (acceptSymbol("(")) {
+                    if (peekKeyword("SELECT")) {
+                        throw error::notImplemented("Scalar subquery");
+                    }
+                    ExprPtr inner = expression();
+                    expectSymbol(")");
+                    return inner;
+                }
+                if (acceptSymbol("*")) {
+                    return node(Expr::Kind::STAR, "*", {}, begin);
+                }
+                if (peekSymbol("{")) {
+                    return scalarParameter();
+                }
+                throw unexpected("expression");
+            case Token::Kind::END:
+                throw unexpected("expression");
+            default:
+                break;
+        }
+
+        bool quoted = token.kind == Token::Kind::QUOTED_IDENT;
+        if (!quoted) {
+            if (acceptKeyword("NULL")) return literalExpr(std::monostate{}, "NULL");
+            if (acceptKeyword("TRUE")) return literalExpr(Value(uint64_t{1}), "true");
+            if (acceptKeyword("FALSE")) return literalExpr(Value(uint64_t{0}), "false");
+        }
+
+        std::string name = lexer_.next().text;
+        if (!quoted && acceptSymbol("(")) {
+            std::vector<ExprPtr> args;
+            if (acceptSymbol("*")) {
+                args.push_back(node(Expr::Kind::STAR, "*", {}, lexer_.consumed() - 1));
+            } else if (!peekSymbol(")")) {
+                args = expressionList();
+            }
+            expectSymbol(")");
+            return node(Expr::Kind::FUNCTION, toLower(name), std::move(args), begin);
+        }
+
+        auto column = std::make_shared<Expr>();
+        column->kind = Expr::Kind::COLUMN;
+        column->name = std::move(name);
+        if (acceptSymbol(".")) {
+            column->qualifier = std::move(column->name);
+            column->name = identifier();
+        }
+        column->text = textFrom(begin);
+        return column;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Evaluation
+
+struct Datum {
+    Value value;
+    ColumnType type;
+};
+
+struct RelColumn {
+    std::string qualifier;
+    std::string name;
+    ColumnType type;
+};
+
+struct Relation {
+    std::vector<RelColumn> columns;
+    std::vector<const Row*> rows;
+    std::deque<Row> owned;           // Rows built by joins and subqueries; deque keeps pointers stable
+    uint64_t readRows = 0;
+    uint64_t readBytes = 0;
+};
+
+struct ResultSet {
+    std::vector<RelColumn> columns;
+    std::vector<Row> rows;
+    uint64_t readRows = 0;
+    uint64_t readBytes = 0;
+    uint64_t rowsBeforeLimit = 0;
+    bool limited = false;
+};
+
+bool isAggregate(const std::string& name) {
+    static const char* kAggregates[] = {"count", "sum", "min", "max", "avg", "any", "argmax", "argmin", "uniq", "uniqexact",
+                                         "argmaxstate", "argminstate", "argmaxmerge", "argminmerge"};
+    for (const char* aggregate : kAggregates) {
+        if (name == aggregate) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hasAggregate(const Expr& expr) {
+    if (expr.kind == Expr::Kind::FUNCTION && isAggregate(expr.name)) {
+        return true;
+    }
+    return std::any_of(expr.args.begin(), expr.args.end(), [](const ExprPtr& arg) { return hasAggregate(*arg); });
+}
+
+ColumnType plainType(ColumnType type) {
+    type.nullable = false;
+    type.lowCardinality = false;
+    return type;
+}
+
+ColumnType simpleType(TypeKind kind) {
+    ColumnType type;
+    type.kind = kind;
+    return type;
+}
+
+uint64_t valueBytes(const Value& value) {
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        return text->size() + 1;
+    }
+    return isNull(value) ? 1 : 8;
+}
+
+void appendKey(std::string& key, const Value& value) {
+    key += static_cast<char>('0' + value.index());
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        key += *text;
+    } else if (!isNull(value)) {
+        char bytes[8];
+        std::visit([&](const auto& number) {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(number)>, std::monostate> &&
+                          !std::is_same_v<std::decay_t<decltype(number)>, std::string>) {
+                std::memcpy(bytes, &number, sizeof(bytes));
+            }
+        }, value);
+        key.append(bytes, sizeof(bytes));
+    }
+    key += '\x1f';
+}
+
+bool truthy(const Value& value) {
+    if (isNull(value)) {
+        return false;
+    }
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        return !text->empty();
+    }
+    return toDouble(value) != 0.0;
+}
+
+Datum boolean(bool value) {
+    return {Value(uint64_t{value}), simpleType(TypeKind::UINT8)};
+}
+
+int64_t perSecond(const ColumnType& type) {
+    int64_t scale = 1;
+    for (int i = 0; i < type.scale && type.kind == TypeKind::DATETIME64; ++i) {
+        scale *= 10;
+    }
+    return scale;
+}
+
+// Seconds since epoch of a temporal value
+int64_t epochSeconds(const Datum& datum) {
+    switch (datum.type.kind) {
+        case TypeKind::DATE: return static_cast<int64_t>(std::get<uint64_t>(datum.value)) * 86400;
+        case TypeKind::DATETIME: return static_cast<int64_t>(std::get<uint64_t>(datum.value));
+        case TypeKind::DATETIME64: {
+            int64_t ticks = std::get<int64_t>(datum.value);
+            int64_t scale = perSecond(datum.type);
+            return ticks >= 0 ? ticks / scale : -((-ticks + scale - 1) / scale);
+        }
+        default: {
+            ColumnType dateTime = simpleType(TypeKind::DATETIME);
+            return static_cast<int64_t>(std::get<uint64_t>(coerce(datum.value, dateTime)));
+        }
+    }
+}
+
+// Evaluates expressions against one relation. Column lookups are resolved once per
+// expression node and cached, so per-row evaluation is an index into the row.
+class Evaluator {
+public:
+    explicit Evaluator(const Relation& relation) : relation_(relation) {}
+
+    // Aliases of the select list, consulted first for ORDER BY and HAVING
+    void setAliases(const std::unordered_map<std::string, const Expr*>* aliases) { aliases_ = aliases; }
+
+    // `group` holds the rows an aggregate runs over; `row` is its first row, or null when empty
+    Datum eval(const Expr& expr, const Row* row, const std::vector<const Row*>* group, bool useAliases = false) const {
+        switch (expr.kind) {
+            case Expr::Kind::LITERAL:
+                return {expr.literal, expr.literalType};
+
+            case Expr::Kind::COLUMN: {
+                if (useAliases && aliases_ && expr.qualifier.empty()) {
+                    auto alias = aliases_->find(expr.name);
+                    if (alias != aliases_->end() && alias->second != &expr) {
+                        return eval(*alias->second, row, group, false);
+                    }
+                }
+                size_t index = resolve(expr);
+                const ColumnType& type = relation_.columns[index].type;
+                return {row ? (*row)[index] : coerce(std::monostate{}, type), type};
+            }
+
+            case Expr::Kind::STAR:
+                throw error::syntax("'*' is only allowed in the select list and count(*)");
+
+            case Expr::Kind::FUNCTION:
+                return isAggregate(expr.name) ? aggregate(expr, group ? *group : singleRow(row)) : scalar(expr, row, group, useAliases);
+
+            case Expr::Kind::NOT:
+                return boolean(!truthy(eval(*expr.args[0], row, group, useAliases).value));
+
+            case Expr::Kind::NEGATE: {
+                Datum operand = eval(*expr.args[0], row, group, useAliases);
+                if (operand.type.isFloat()) {
+                    return {Value(-toDouble(operand.value)), simpleType(TypeKind::FLOAT64)};
+                }
+                return {Value(-static_cast<int64_t>(toDouble(operand.value))), simpleType(TypeKind::INT64)};
+            }
+
+            case Expr::Kind::IS_NULL: {
+                bool null = isNull(eval(*expr.args[0], row, group, useAliases).value);
+                return boolean(null != expr.negated);
+            }
+
+            case Expr::Kind::IN: {
+                Datum lhs = eval(*expr.args[0], row, group, useAliases);
+                bool found = false;
+                for (size_t i = 1; i < expr.args.size() && !found; ++i) {
+                    Datum candidate = eval(*expr.args[i], row, group, useAliases);
+                    found = !isNull(lhs.value) && compare(lhs, candidate) == 0;
+                }
+                return boolean(found != expr.negated);
+            }
+
+            case Expr::Kind::BETWEEN: {
+                Datum value = eval(*expr.args[0], row, group, useAliases);
+                bool inside = compare(value, eval(*expr.args[1], row, group, useAliases)) >= 0 &&
+                              compare(value, eval(*expr.args[2], row, group, useAliases)) <= 0;
+                return boolean(inside != expr.negated);
+            }
+
+            case Expr::Kind::BINARY:
+                return binary(expr, row, group, useAliases);
+        }
+        return {};
+    }
+
+    // Compares after converting a String literal to the other side's type, as
+    // ClickHouse does for `open_time >= '2024-01-01 00:00:00'`
+    static int compare(Datum lhs, Datum rhs) {
+        bool leftText = lhs.type.kind == TypeKind::STRING && !isNull(lhs.value);
+        bool rightText = rhs.type.kind == TypeKind::STRING && !isNull(rhs.value);
+        if (leftText && !rightText && rhs.type.kind != TypeKind::NOTHING) {
+            lhs.value = coerce(lhs.value, plainType(rhs.type));
+        } else if (rightText && !leftText && lhs.type.kind != TypeKind::NOTHING) {
+            rhs.value = coerce(rhs.value, plainType(lhs.type));
+        }
+        // DateTime against DateTime64(n), or two precisions: compare as times
+        int leftScale = timeScale(lhs.type);
+        int rightScale = timeScale(rhs.type);
+        if (leftScale >= 0 && rightScale >= 0 && leftScale != rightScale && !isNull(lhs.value) && !isNull(rhs.value)) {
+            auto& coarser = leftScale < rightScale ? lhs : rhs;
+            int64_t ticks = std::holds_alternative<uint64_t>(coarser.value) ? static_cast<int64_t>(std::get<uint64_t>(coarser.value))
+                                                                            : std::get<int64_t>(coarser.value);
+            for (int i = std::min(leftScale, rightScale); i < std::max(leftScale, rightScale); ++i) {
+                ticks *= 10;
+            }
+            coarser.value = ticks;
+        }
+        return compareValues(lhs.value, rhs.value);
+    }
+
+    // Decimal digits of a DateTime or DateTime64 value's ticks, -1 for other types
+    static int timeScale(const ColumnType& type) {
+        if (type.kind == TypeKind::DATETIME) {
+            return 0;
+        }
+        return type.kind == TypeKind::DATETIME64 ? type.scale : -1;
+    }
+
+    size_t resolve(const Expr& expr) const {
+        auto cached = resolved_.find(&expr);
+        if (cached != resolved_.end()) {
+            return cached->second;
+        }
+        auto index = tryResolve(expr.qualifier, expr.name);
+        if (!index) {
+            throw error::unknownIdentifier(expr.text);
+        }
+        resolved_.emplace(&expr, *index);
+        return *index;
+    }
+
+    std::optional<size_t> tryResolve(const std::string& qualifier, const std::string& name) const {
+        for (size_t i = 0; i < relation_.columns.size(); ++i) {
+            const auto& column = relation_.columns[i];
+            if (column.name == name && (qualifier.empty() || column.qualifier == qualifier)) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    const Relation& relation_;
+    const std::unordered_map<std::string, const Expr*>* aliases_ = nullptr;
+    mutable std::unordered_map<const Expr*, size_t> resolved_;
+    mutable std::vector<const Row*> single_;
+
+    const std::vector<const Row*>& singleRow(const Row* row) const {
+        single_.assign(row ? 1 : 0, row);
+        return single_;
+    }
+
+    Datum binary(const Expr& expr, const Row* row, const std::vector<const Row*>* group, bool useAliases) const {
+        const std::string& op = expr.name;
+        if (op == "AND") {
+            return boolean(truthy(eval(*expr.args[0], row, group, useAliases).value) &&
+                           truthy(eval(*expr.args[1], row, group, useAliases).value));
+        }
+        if (op == "OR") {
+            return boolean(truthy(eval(*expr.args[0], row, group, useAliases).value) ||
+                           truthy(eval(*expr.args[1], row, group, useAliases).value));
+        }
+
+        Datum lhs = eval(*expr.args[0], row, group, useAliases);
+        Datum rhs = eval(*expr.args[1], row, group, useAliases);
+        if (op == "=" || op == "!=" || op == "<" || op == "<=" || op == ">" || op == ">=") {
+            if (isNull(lhs.value) || isNull(rhs.value)) {
+                return {std::monostate{}, literalTypeOf(std::monostate{})};
+            }
+            int result = compare(lhs, rhs);
+            if (op == "=") return boolean(result == 0);
+            if (op == "!=") return boolean(result != 0);
+            if (op == "<") return boolean(result < 0);
+            if (op == "<=") return boolean(result <= 0);
+            if (op == ">") return boolean(result > 0);
+            return boolean(result >= 0);
+        }
+
+        if (isNull(lhs.value) || isNull(rhs.value)) {
+            return {std::monostate{}, literalTypeOf(std::monostate{})};
+        }
+        if (lhs.type.kind == TypeKind::STRING || rhs.type.kind == TypeKind::STRING) {
+            throw ClickHouseError(43, "ILLEGAL_TYPE_OF_ARGUMENT", "Illegal type String of argument of operator " + op);
+        }
+
+        // DateTime +/- seconds stays a DateTime
+        if (lhs.type.isTemporal() && !rhs.type.isTemporal() && (op == "+" || op == "-")) {
+            auto delta = static_cast<int64_t>(toDouble(rhs.value)) * (op == "+" ? 1 : -1);
+            ColumnType type = plainType(lhs.type);
+            if (type.kind == TypeKind::DATETIME64) {
+                return {Value(std::get<int64_t>(lhs.value) + delta * perSecond(type)), type};
+            }
+            return {Value(static_cast<uint64_t>(static_cast<int64_t>(std::get<uint64_t>(lhs.value)) + delta)), type};
+        }
+        if (lhs.type.isTemporal() && rhs.type.isTemporal() && op == "-") {
+            return {Value(epochSeconds(lhs) - epochSeconds(rhs)), simpleType(TypeKind::INT64)};
+        }
+
+        if (op == "/" || lhs.type.isFloat() || rhs.type.isFloat()) {
+            double left = toDouble(lhs.value);
+            double right = toDouble(rhs.value);
+            double result = op == "+" ? left + right : op == "-" ? left - right : op == "*" ? left * right
+                          : op == "/" ? left / right : std::fmod(left, right);
+            return {Value(result), simpleType(TypeKind::FLOAT64)};
+        }
+        if (op == "%" && toDouble(rhs.value) == 0.0) {
+            throw ClickHouseError(153, "ILLEGAL_DIVISION", "Division by zero");
+        }
+        if (lhs.type.isUnsigned() && rhs.type.isUnsigned() && op != "-") {
+            uint64_t left = std::get<uint64_t>(lhs.value);
+            uint64_t right = std::get<uint64_t>(rhs.value);
+            return {Value(op == "+" ? left + right : op == "*" ? left * right : left % right), simpleType(TypeKind::UINT64)};
+        }
+        auto left = static_cast<int64_t>(toDouble(lhs.value));
+        auto right = static_cast<int64_t>(toDouble(rhs.value));
+        if (const auto* exact = std::get_if<int64_t>(&lhs.value)) left = *exact;
+        if (const auto* exact = std::get_if<uint64_t>(&lhs.value)) left = static_cast<int64_t>(*exact);
+        if (const auto* exact = std::get_if<int64_t>(&rhs.value)) right = *exact;
+        if (const auto* exact = std::get_if<uint64_t>(&rhs.value)) right = static_cast<int64_t>(*exact);
+        int64_t result = op == "+" ? left + right : op == "-" ? left - right : op == "*" ? left * right : left % right;
+        return {Value(result), simpleType(TypeKind::INT64)};
+    }
+
+    Datum scalar(const Expr& expr, const Row* row, const std::vector<const Row*>* group, bool useAliases) const {
+        const std::string& name = expr.name;
+        auto arg = [&](size_t index) {
+            if (index >= expr.args.size()) {
+                throw ClickHouseError(42, "NUMBER_OF_ARGUMENTS_DOESNT_MATCH", "Too few arguments for function " + name);
+            }
+            return eval(*expr.args[index], row, group, useAliases);
+        };
+        auto convert = [&](TypeKind kind) {
+            Datum value = arg(0);
+            ColumnType type = simpleType(kind);
+            if (value.type.isTemporal() && !type.isTemporal() && kind != TypeKind::STRING) {
+                return Datum{coerce(Value(epochSeconds(value)), type), type};
+            }
+            if (kind == TypeKind::STRING && !isNull(value.value) && value.type.kind != TypeKind::STRING) {
+                std::string text;
+                appendText(text, value.value, value.type);
+                return Datum{Value(text), type};
+            }
+            return Datum{coerce(value.value, type), type};
+        };
+        auto startOf = [&](int64_t seconds) {
+            int64_t epoch = epochSeconds(arg(0));
+            int64_t floored = epoch - ((epoch % seconds) + seconds) % seconds;
+            return Datum{Value(static_cast<uint64_t>(floored)), simpleType(TypeKind::DATETIME)};
+        };
+
+        if (name == "now") {
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            return {Value(static_cast<uint64_t>(seconds)), simpleType(TypeKind::DATETIME)};
+        }
+        if (name == "todatetime") {
+            Datum value = arg(0);
+            ColumnType type = simpleType(TypeKind::DATETIME);
+            return {value.type.isTemporal() ? Value(static_cast<uint64_t>(epochSeconds(value))) : coerce(value.value, type), type};
+        }
+        if (name == "todatetime64") {
+            Datum value = arg(0);
+            ColumnType type = simpleType(TypeKind::DATETIME64);
+            type.scale = static_cast<int>(toDouble(arg(1).value));
+            if (value.type.isTemporal()) {
+                return {Value(epochSeconds(value) * perSecond(type)), type};
+            }
+            // Numbers are seconds here, unlike an integer inserted into the column
+            Value seconds = std::holds_alternative<std::string>(value.value) ? value.value : Value(toDouble(value.value));
+            return {coerce(seconds, type), type};
+        }
+        if (name == "todate") {
+            Datum value = arg(0);
+            ColumnType type = simpleType(TypeKind::DATE);
+            return {value.type.isTemporal() ? Value(static_cast<uint64_t>(epochSeconds(value) / 86400)) : coerce(value.value, type), type};
+        }
+        if (name == "tounixtimestamp") {
+            return {Value(static_cast<uint64_t>(epochSeconds(arg(0)))), simpleType(TypeKind::UINT32)};
+        }
+        if (name == "tostartofminute") return startOf(60);
+        if (name == "tostartoffiveminutes" || name == "tostartoffiveminute") return startOf(300);
+        if (name == "tostartoffifteenminutes") return startOf(900);
+        if (name == "tostartofhour") return startOf(3600);
+        if (name == "tostartofday") return startOf(86400);
+        if (name == "upper" || name == "lower") {
+            Datum value = arg(0);
+            if (isNull(value.value)) {
+                return value;
+            }
+            std::string text = std::get<std::string>(coerce(value.value, simpleType(TypeKind::STRING)));
+            std::transform(text.begin(), text.end(), text.begin(), [&](unsigned char c) {
+                return static_cast<char>(name == "upper" ? std::toupper(c) : std::tolower(c));
+            });
+            return {Value(std::move(text)), simpleType(TypeKind::STRING)};
+        }
+        if (name == "jsonextractstring" || name == "jsonextractfloat") {
+            // Top-level keys only; a missing key or malformed JSON gives the default
+            bool isString = name == "jsonextractstring";
+            ColumnType type = simpleType(isString ? TypeKind::STRING : TypeKind::FLOAT64);
+            Datum document = arg(0);
+            std::string key = std::get<std::string>(coerce(arg(1).value, simpleType(TypeKind::STRING)));
+            const auto* text = std::get_if<std::string>(&document.value);
+            auto json = text ? nlohmann::json::parse(*text, nullptr, false) : nlohmann::json();
+            auto field = json.is_object() ? json.find(key) : json.end();
+            if (isString) {
+                return {Value(json.is_object() && field != json.end() && field->is_string() ? field->get<std::string>() : std::string()), type};
+            }
+            return {Value(json.is_object() && field != json.end() && field->is_number() ? field->get<double>() : 0.0), type};
+        }
+        if (name == "tostring") return convert(TypeKind::STRING);
+        if (name == "tofloat64") return convert(TypeKind::FLOAT64);
+        if (name == "toint64") return convert(TypeKind::INT64);
+        if (name == "touint64") return convert(TypeKind::UINT64);
+        if (name == "if") {
+            return truthy(arg(0).value) ? arg(1) : arg(2);
+        }
+        throw ClickHouseError(kUnknownFunction, "UNKNOWN_FUNCTION", "Unknown function " + name);
+    }
+
+    Datum aggregate(const Expr& expr, const std::vector<const Row*>& rows) const {
+        const std::string& name = expr.name;
+        for (const auto& arg : expr.args) {
+            if (hasAggregate(*arg)) {
+                throw ClickHouseError(kIllegalAggregation, "ILLEGAL_AGGREGATION", "Aggregate function " + expr.text + " is found inside another aggregate function");
+            }
+        }
+        auto argAt = [&](size_t index, const Row* row) {
+            if (index >= expr.args.size()) {
+                throw ClickHouseError(42, "NUMBER_OF_ARGUMENTS_DOESNT_MATCH", "Too few arguments for aggregate function " + name);
+            }
+            return eval(*expr.args[index], row, nullptr);
+        };
+
+        if (name == "count") {
+            uint64_t count = 0;
+            if (expr.args.empty() || expr.args[0]->kind == Expr::Kind::STAR) {
+                count = rows.size();
+            } else {
+                for (const Row* row : rows) {
+                    count += !isNull(argAt(0, row).value);
+                }
+            }
+            return {Value(count), simpleType(TypeKind::UINT64)};
+        }
+        if (name == "uniq" || name == "uniqexact") {
+            std::unordered_set<std::string> seen;
+            for (const Row* row : rows) {
+                std::string key;
+                for (size_t i = 0; i < expr.args.size(); ++i) {
+                    appendKey(key, argAt(i, row).value);
+                }
+                seen.insert(std::move(key));
+            }
+            return {Value(static_cast<uint64_t>(seen.size())), simpleType(TypeKind::UINT64)};
+        }
+
+        // The argument type comes from evaluating it without a row
+        ColumnType argType = plainType(argAt(0, nullptr).type);
+        if (name == "sum" || name == "avg") {
+            double floating = 0.0;
+            int64_t integer = 0;
+            uint64_t count = 0;
+            for (const Row* row : rows) {
+                Value value = argAt(0, row).value;
+                if (isNull(value)) {
+                    continue;
+                }
+                ++count;
+                floating += toDouble(value);
+                integer += std::holds_alternative<int64_t>(value) ? std::get<int64_t>(value)
+                         : std::holds_alternative<uint64_t>(value) ? static_cast<int64_t>(std::get<uint64_t>(value)) : 0;
+            }
+            if (name == "avg") {
+                double average = count ? floating / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+                return {Value(average), simpleType(TypeKind::FLOAT64)};
+            }
+            if (argType.isFloat()) return {Value(floating), simpleType(TypeKind::FLOAT64)};
+            if (argType.isSigned()) return {Value(integer), simpleType(TypeKind::INT64)};
+            return {Value(static_cast<uint64_t>(integer)), simpleType(TypeKind::UINT64)};
+        }
+
+        bool isMax = name == "max" || name == "argmax" || name == "argmaxstate" || name == "argmaxmerge";
+        bool isArg = name == "argmax" || name == "argmin" || name == "argmaxstate" || name == "argminstate";
+        bool isState = name == "argmaxstate" || name == "argminstate";
+        bool isMerge = name == "argmaxmerge" || name == "argminmerge";
+        if (name == "any" || name == "min" || name == "max" || isArg || isMerge) {
+            // A merge reads the (value, key) pairs its state column was built from
+            if (isMerge && (argType.kind != TypeKind::AGGREGATE_STATE || argType.aggregateArgs.size() != 2 ||
+                            toLower(argType.aggregateFunction) != name.substr(0, 6))) {
+                throw ClickHouseError(kIllegalTypeOfArgument, "ILLEGAL_TYPE_OF_ARGUMENT",
+                                      "Illegal type " + typeName(argType) + " of argument for aggregate function " + name);
+            }
+            ColumnType keyType = isArg ? plainType(argAt(1, nullptr).type) : argType;
+            ColumnType valueType = isMerge ? argType.aggregateArgs[0] : argType;
+            if (isMerge) {
+                keyType = argType.aggregateArgs[1];
+            }
+            std::optional<Datum> best;
+            std::optional<Datum> bestKey;
+            for (const Row* row : rows) {
+                Datum value = argAt(0, row);
+                if (name == "any") {
+                    return {value.value, argType};
+                }
+                Datum key = isArg ? argAt(1, row) : value;
+                if (isMerge) {
+                    const auto& state = std::get<std::string>(value.value);
+                    if (state.empty()) {
+                        continue;
+                    }
+                    const auto* data = reinterpret_cast<const uint8_t*>(state.data());
+                    const auto* end = data + state.size();
+                    value = {readRowBinary(data, end, valueType), valueType};
+                    key = {readRowBinary(data, end, keyType), keyType};
+                }
+                if (isNull(key.value)) {
+                    continue;
+                }
+                if (!bestKey || (isMax ? compare(key, *bestKey) > 0 : compare(key, *bestKey) < 0)) {
+                    best = std::move(value);
+                    bestKey = std::move(key);
+                }
+            }
+            if (isState) {
+                // The state of an empty group is empty; otherwise RowBinary value then key
+                ColumnType stateType;
+                stateType.kind = TypeKind::AGGREGATE_STATE;
+                stateType.aggregateFunction = isMax ? "argMax" : "argMin";
+                stateType.aggregateArgs = {argType, keyType};
+                std::string state;
+                if (best) {
+                    appendRowBinary(state, coerce(best->value, argType), argType);
+                    appendRowBinary(state, coerce(bestKey->value, keyType), keyType);
+                }
+                return {Value(std::move(state)), stateType};
+            }
+            return {best ? best->value : coerce(std::monostate{}, valueType), valueType};
+        }
+        throw ClickHouseError(kUnknownFunction, "UNKNOWN_FUNCTION", "Unknown aggregate function " + name);
+    }
+};
+
+std::string outputName(const SelectItem& item) {
+    if (!item.alias.empty()) {
+        return item.alias;
+    }
+    return item.expr->kind == Expr::Kind::COLUMN ? item.expr->name : item.expr->text;
+}
+
+// ---------------------------------------------------------------------------
+// Output formats
+
+std::string normalizeFormat(const std::string& format) {
+    if (format.empty() || format == "TSV" || format == "TabSeparated") return "TabSeparated";
+    if (format == "TSVWithNames" || format == "TabSeparatedWithNames") return "TabSeparatedWithNames";
+    static const char* kFormats[] = {"JSON", "JSONEachRow", "RowBinary", "RowBinaryWithNamesAndTypes", "Null", "Values"};
+    for (const char* known : kFormats) {
+        if (format == known) {
+            return format;
+        }
+    }
+    throw ClickHouseError(kUnknownFormat, "UNKNOWN_FORMAT", "Unknown format " + format);
+}
+
+// LEB128, as RowBinary encodes string lengths and the column count
+void appendVarUInt(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void appendVarString(std::string& out, const std::string& text) {
+    appendVarUInt(out, text.size());
+    out += text;
+}
+
+std::string renderResult(const ResultSet& result, const std::string& format, double elapsedSec) {
+    std::string out;
+    const auto& columns = result.columns;
+    if (format == "JSON") {
+        out += "{\n\t\"meta\":\n\t[";
+        for (size_t c = 0; c < columns.size(); ++c) {
+            out += c ? ",\n\t\t{\n\t\t\t\"name\": " : "\n\t\t{\n\t\t\t\"name\": ";
+            appendJson(out, Value(columns[c].name), ColumnType{});
+            out += ",\n\t\t\t\"type\": ";
+            appendJson(out, Value(typeName(columns[c].type)), ColumnType{});
+            out += "\n\t\t}";
+        }
+        out += "\n\t],\n\n\t\"data\":\n\t[";
+        for (size_t r = 0; r < result.rows.size(); ++r) {
+            out += r ? ",\n\t\t{" : "\n\t\t{";
+            for (size_t c = 0; c < columns.size(); ++c) {
+                out += c ? ",\n\t\t\t" : "\n\t\t\t";
+                appendJson(out, Value(columns[c].name), ColumnType{});
+                out += ": ";
+                appendJson(out, result.rows[r][c], columns[c].type);
+            }
+            out += "\n\t\t}";
+        }
+        out += "\n\t],\n\n\t\"rows\": " + std::to_string(result.rows.size()) + ",\n\n";
+        if (result.limited) {
+            out += "\t\"rows_before_limit_at_least\": " + std::to_string(result.rowsBeforeLimit) + ",\n\n";
+        }
+        char elapsed[32];
+        std::snprintf(elapsed, sizeof(elapsed), "%.6f", elapsedSec);
+        out += "\t\"statistics\":\n\t{\n\t\t\"elapsed\": ";
+        out += elapsed;
+        out += ",\n\t\t\"rows_read\": " + std::to_string(result.readRows) +
+               ",\n\t\t\"bytes_read\": " + std::to_string(result.readBytes) + "\n\t}\n}\n";
+    } else if (format == "JSONEachRow") {
+        for (const auto& row : result.rows) {
+            out += '{';
+            for (size_t c = 0; c < columns.size(); ++c) {
+                if (c) out += ',';
+                appendJson(out, Value(columns[c].name), ColumnType{});
+                out += ':';
+                appendJson(out, row[c], columns[c].type);
+            }
+            out += "}\n";
+        }
+    } else if (format == "TabSeparated" || format == "TabSeparatedWithNames") {
+        if (format == "TabSeparatedWithNames") {
+            for (size_t c = 0; c < columns.size(); ++c) {
+                if (c) out += '\t';
+                appendText(out, Value(columns[c].name), ColumnType{});
+            }
+            out += '\n';
+        }
+        for (const auto& row : result.rows) {
+            for (size_t c = 0; c < columns.size(); ++c) {
+                if (c) out += '\t';
+                appendText(out, row[c], columns[c].type);
+            }
+            out += '\n';
+        }
+    } else if (format == "RowBinary" || format == "RowBinaryWithNamesAndTypes") {
+        if (format == "RowBinaryWithNamesAndTypes") {
+            appendVarUInt(out, columns.size());
+            for (const auto& column : columns) appendVarString(out, column.name);
+            for (const auto& column : columns) appendVarString(out, typeName(column.type));
+        }
+        for (const auto& row : result.rows) {
+            for (size_t c = 0; c < columns.size(); ++c) {
+                appendRowBinary(out, row[c], columns[c].type);
+            }
+        }
+    } else if (format == "Values") {
+        for (size_t r = 0; r < result.rows.size(); ++r) {
+            out += r ? ",(" : "(";
+            for (size_t c = 0; c < columns.size(); ++c) {
+                if (c) out += ',';
+                bool quote = std::holds_alternative<std::string>(result.rows[r][c]) || columns[c].type.isTemporal();
+                if (quote) out += '\'';
+                appendText(out, result.rows[r][c], columns[c].type);
+                if (quote) out += '\'';
+            }
+            out += ')';
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Statements
+
+class StatementRunner {
+public:
+    StatementRunner(FakeClickHouseStore& store, std::string database)
+        : store_(store), database_(std::move(database)) {}
+
+    QueryResult run(std::string_view query, std::string_view data, const QueryParameters& parameters) {
+        auto started = std::chrono::steady_clock::now();
+        std::string text(query);
+        if (!data.empty()) {
+            text += '\n';
+            text.append(data);
+        }
+        Parser parser(text, &parameters);
+
+        if (parser.peekKeyword("SELECT")) {
+            std::shared_lock lock(store_.mutex_);
+            auto select = parser.select();
+            parser.expectEnd();
+            ResultSet result = runSelect(*select);
+            QueryResult output;
+            output.format = normalizeFormat(select->format);
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            output.body = renderResult(result, output.format, elapsed);
+            output.readRows = result.readRows;
+            output.readBytes = result.readBytes;
+            output.resultRows = result.rows.size();
+            return output;
+        }
+
+        if (parser.acceptKeyword("EXISTS")) {
+            std::shared_lock lock(store_.mutex_);
+            return exists(parser);
+        }
+
+        std::unique_lock lock(store_.mutex_);
+        if (parser.acceptKeyword("INSERT")) {
+            return insert(parser, text);
+        }
+        if (parser.acceptKeyword("CREATE")) {
+            create(parser);
+        } else if (parser.acceptKeyword("DROP")) {
+            drop(parser);
+        } else if (parser.acceptKeyword("TRUNCATE")) {
+            parser.acceptKeyword("TABLE");
+            bool ifExists = acceptIfExists(parser);
+            std::string name = fullName(parser.qualifiedName());
+            parser.expectEnd();
+            auto table = store_.tables_.find(name);
+            if (table != store_.tables_.end()) {
+                table->second.rows.clear();
+            } else if (!ifExists) {
+                throw error::unknownTable(name);
+            }
+        } else {
+            throw parser.unexpected("one of: SELECT, INSERT, CREATE, DROP, TRUNCATE, EXISTS");
+        }
+        return {};
+    }
+
+private:
+    // Rows of one insert; a view's FROM on that table sees only these
+    struct InsertedBlock {
+        std::string table;
+        size_t firstRow = 0;
+    };
+
+    FakeClickHouseStore& store_;
+    std::string database_;
+    std::optional<InsertedBlock> block_;
+
+    std::string fullName(const std::string& name) const {
+        return name.find('.') == std::string::npos ? database_ + "." + name : name;
+    }
+
+    static bool acceptIfExists(Parser& parser) {
+        if (!parser.acceptKeyword("IF")) {
+            return false;
+        }
+        parser.expectKeyword("EXISTS");
+        return true;
+    }
+
+    FakeClickHouseStore::Table& table(const std::string& name) {
+        auto it = store_.tables_.find(name);
+        if (it == store_.tables_.end()) {
+            throw error::unknownTable(name);
+        }
+        return it->second;
+    }
+
+    void requireDatabase(const std::string& database) const {
+        if (!store_.databases_.count(database)) {
+            throw ClickHouseError(kUnknownDatabase, "UNKNOWN_DATABASE", "Database " + database + " does not exist");
+        }
+    }
+
+    // Skips tokens up to a ',' or ')' at the current nesting level
+    static void skipDefinition(Parser& parser) {
+        int depth = 0;
+        while (true) {
+            const Token& token = parser.lexer().peek();
+            if (token.kind == Token::Kind::END) {
+                throw parser.unexpected("')'");
+            }
+            if (token.kind == Token::Kind::SYMBOL) {
+                if (depth == 0 && (token.text == "," || token.text == ")")) {
+                    return;
+                }
+                depth += token.text == "(" ? 1 : token.text == ")" ? -1 : 0;
+            }
+            parser.lexer().next();
+        }
+    }
+
+    QueryResult exists(Parser& parser) {
+        parser.acceptKeyword("TABLE");
+        std::string name = fullName(parser.qualifiedName());
+        std::string format;
+        if (parser.acceptKeyword("FORMAT")) {
+            format = parser.identifier();
+        }
+        parser.expectEnd();
+        ResultSet result;
+        result.columns.push_back({"", "result", simpleType(TypeKind::UINT8)});
+        result.rows.push_back({Value(static_cast<uint64_t>(store_.tables_.count(name) || store_.views_.count(name)))});
+        QueryResult output;
+        output.format = normalizeFormat(format);
+        output.body = renderResult(result, output.format, 0.0);
+        output.resultRows = 1;
+        return output;
+    }
+
+    void create(Parser& parser) {
+        parser.acceptKeyword("OR");  // CREATE OR REPLACE is treated as CREATE
+        parser.acceptKeyword("REPLACE");
+        if (parser.acceptKeyword("MATERIALIZED")) {
+            createView(parser);
+            return;
+        }
+        if (parser.acceptKeyword("DATABASE")) {
+            bool ifNotExists = acceptIfNotExists(parser);
+            std::string name = parser.identifier();
+            if (!store_.databases_.insert(name).second && !ifNotExists) {
+                throw ClickHouseError(82, "DATABASE_ALREADY_EXISTS", "Database " + name + " already exists");
+            }
+            return;  // ENGINE and the rest are ignored
+        }
+        if (!parser.acceptKeyword("TABLE")) {
+            throw error::notImplemented("CREATE of anything but DATABASE and TABLE");
+        }
+        bool ifNotExists = acceptIfNotExists(parser);
+        std::string name = fullName(parser.qualifiedName());
+        requireDatabase(name.substr(0, name.find('.')));
+
+        FakeClickHouseStore::Table definition;
+        parser.expectSymbol("(");
+        do {
+            if (parser.peekKeyword("INDEX") || parser.peekKeyword("CONSTRAINT") ||
+                parser.peekKeyword("PROJECTION") || parser.peekKeyword("PRIMARY")) {
+                skipDefinition(parser);
+                continue;
+            }
+            definition.columns.push_back(columnDefinition(parser));
+        } while (parser.acceptSymbol(","));
+        parser.expectSymbol(")");
+        tableSettings(parser, definition);
+
+        if (store_.tables_.count(name)) {
+            if (!ifNotExists) {
+                throw ClickHouseError(kTableAlreadyExists, "TABLE_ALREADY_EXISTS", "Table " + name + " already exists");
+            }
+            return;
+        }
+        store_.tables_.emplace(name, std::move(definition));
+    }
+
+    // CREATE MATERIALIZED VIEW [IF NOT EXISTS] name TO target AS SELECT ... FROM source ...
+    void createView(Parser& parser) {
+        parser.expectKeyword("VIEW");
+        bool ifNotExists = acceptIfNotExists(parser);
+        std::string name = fullName(parser.qualifiedName());
+        requireDatabase(name.substr(0, name.find('.')));
+        if (!parser.acceptKeyword("TO")) {
+            throw error::notImplemented("Materialized views without TO (implicit inner tables)");
+        }
+        FakeClickHouseStore::View view;
+        view.target = fullName(parser.qualifiedName());
+        view.database = database_;
+        table(view.target);
+        if (parser.acceptKeyword("POPULATE")) {
+            throw error::notImplemented("POPULATE");
+        }
+        parser.expectKeyword("AS");
+        size_t selectBegin = parser.lexer().peek().begin;
+        auto select = parser.select();
+        parser.expectEnd();
+        if (!select->from || select->from->table.empty()) {
+            throw error::notImplemented("Materialized views over subqueries or without FROM");
+        }
+        view.source = fullName(select->from->table);
+        table(view.source);
+        view.select = std::string(parser.lexer().source().substr(selectBegin));
+
+        if (store_.views_.count(name) || store_.tables_.count(name)) {
+            if (!ifNotExists) {
+                throw ClickHouseError(kTableAlreadyExists, "TABLE_ALREADY_EXISTS", "Table " + name + " already exists");
+            }
+            return;
+        }
+        store_.views_.emplace(name, std::move(view));
+    }
+
+    // The engine and ORDER BY matter only for ReplacingMergeTree, whose FINAL
+    // reads keep one row per sorting key. PARTITION BY, TTL and SETTINGS are ignored.
+    static void tableSettings(Parser& parser, FakeClickHouseStore::Table& definition) {
+        std::string engine;
+        while (!parser.atEnd()) {
+            if (parser.acceptKeyword("ENGINE")) {
+                parser.acceptSymbol("=");
+                engine = parser.identifier();
+                if (parser.acceptSymbol("(")) {
+                    if (engine == "ReplacingMergeTree" && !parser.peekSymbol(")")) {
+                        definition.versionColumn = parser.identifier();
+                    }
+                    while (!parser.acceptSymbol(")")) {
+                        skipDefinition(parser);
+                        parser.acceptSymbol(",");
+                    }
+                }
+            } else if (parser.acceptKeyword("ORDER")) {
+                parser.expectKeyword("BY");
+                bool parenthesized = parser.acceptSymbol("(");
+                std::vector<ExprPtr> keys;
+                if (parenthesized) {
+                    keys = parser.expressionList();
+                    parser.expectSymbol(")");
+                } else {
+                    keys.push_back(parser.expression());
+                }
+                for (const auto& key : keys) {
+                    definition.sortingKey.push_back(key->kind == Expr::Kind::COLUMN ? key->name : std::string());
+                }
+            } else {
+                parser.lexer().next();
+            }
+        }
+        definition.replacing = engine == "ReplacingMergeTree";
+        if (!definition.replacing) {
+            return;
+        }
+        auto known = [&](const std::string& column) {
+            return std::any_of(definition.columns.begin(), definition.columns.end(), [&](const ColumnDef& def) { return def.name == column; });
+        };
+        if (definition.sortingKey.empty() || !std::all_of(definition.sortingKey.begin(), definition.sortingKey.end(), known) ||
+            (!definition.versionColumn.empty() && !known(definition.versionColumn))) {
+            throw error::notImplemented("ReplacingMergeTree keys other than plain columns");
+        }
+    }
+
+    static bool acceptIfNotExists(Parser& parser) {
+        if (!parser.acceptKeyword("IF")) {
+            return false;
+        }
+        parser.expectKeyword("NOT");
+        parser.expectKeyword("EXISTS");
+        return true;
+    }
+
+    static ColumnDef columnDefinition(Parser& parser) {
+        ColumnDef column;
+        column.name = parser.identifier();
+
+        // The type runs until a top-level ',' or ')' or a column clause keyword
+        static const char* kClauses[] = {"DEFAULT", "MATERIALIZED", "ALIAS", "EPHEMERAL", "CODEC", "COMMENT", "TTL"};
+        size_t typeBegin = parser.lexer().peek().begin;
+        int depth = 0;
+        while (true) {
+            const Token& token = parser.lexer().peek();
+            if (token.kind == Token::Kind::END) {
+                throw parser.unexpected("')'");
+            }
+            if (depth == 0) {
+                if (token.kind == Token::Kind::SYMBOL && (token.text == "," || token.text == ")")) {
+                    break;
+                }
+                bool clause = token.kind == Token::Kind::IDENT &&
+                    std::any_of(std::begin(kClauses), std::end(kClauses), [&](const char* keyword) { return equalsIgnoreCase(token.text, keyword); });
+                if (clause) {
+                    break;
+                }
+            }
+            if (token.kind == Token::Kind::SYMBOL) {
+                depth += token.text == "(" ? 1 : token.text == ")" ? -1 : 0;
+            }
+            parser.lexer().next();
+        }
+        column.type = parseType(parser.lexer().source().substr(typeBegin, parser.lexer().consumed() - typeBegin));
+
+        while (!parser.peekSymbol(",") && !parser.peekSymbol(")")) {
+            if (parser.acceptKeyword("DEFAULT") || parser.acceptKeyword("MATERIALIZED")) {
+                column.defaultExpr = parser.expression();
+            } else if (parser.acceptKeyword("ALIAS") || parser.acceptKeyword("EPHEMERAL")) {
+                throw error::notImplemented("ALIAS and EPHEMERAL columns");
+            } else if (parser.acceptKeyword("COMMENT")) {
+                parser.lexer().next();
+            } else if (parser.acceptKeyword("CODEC")) {
+                parser.expectSymbol("(");
+                skipDefinition(parser);
+                while (parser.acceptSymbol(",")) {
+                    skipDefinition(parser);
+                }
+                parser.expectSymbol(")");
+            } else if (parser.acceptKeyword("TTL")) {
+                parser.expression();
+            } else {
+                throw parser.unexpected("column clause");
+            }
+        }
+        return column;
+    }
+
+    void drop(Parser& parser) {
+        if (parser.acceptKeyword("DATABASE")) {
+            bool ifExists = acceptIfExists(parser);
+            std::string name = parser.identifier();
+            parser.expectEnd();
+            if (!store_.databases_.erase(name)) {
+                if (!ifExists) {
+                    throw ClickHouseError(kUnknownDatabase, "UNKNOWN_DATABASE", "Database " + name + " does not exist");
+                }
+                return;
+            }
+            std::string prefix = name + ".";
+            for (auto it = store_.tables_.begin(); it != store_.tables_.end();) {
+                it = it->first.compare(0, prefix.size(), prefix) == 0 ? store_.tables_.erase(it) : std::next(it);
+            }
+            for (auto it = store_.views_.begin(); it != store_.views_.end();) {
+                it = it->first.compare(0, prefix.size(), prefix) == 0 ? store_.views_.erase(it) : std::next(it);
+            }
+            return;
+        }
+        bool view = parser.acceptKeyword("VIEW");
+        if (!view) {
+            parser.expectKeyword("TABLE");
+        }
+        bool ifExists = acceptIfExists(parser);
+        std::string name = fullName(parser.qualifiedName());
+        parser.expectEnd();
+        // DROP TABLE also drops views, as in ClickHouse
+        bool dropped = store_.views_.erase(name) > 0 || (!view && store_.tables_.erase(name) > 0);
+        if (!dropped && !ifExists) {
+            throw error::unknownTable(name);
+        }
+    }
+
+    QueryResult insert(Parser& parser, const std::string& text) {
+        parser.expectKeyword("INTO");
+        parser.acceptKeyword("TABLE");
+        std::string name = fullName(parser.qualifiedName());
+        auto& target = table(name);
+
+        // Target positions in the table for each input column
+        std::vector<size_t> positions;
+        if (parser.acceptSymbol("(")) {
+            do {
+                std::string column = parser.identifier();
+                auto it = std::find_if(target.columns.begin(), target.columns.end(), [&](const ColumnDef& def) { return def.name == column; });
+                if (it == target.columns.end()) {
+                    throw ClickHouseError(16, "NO_SUCH_COLUMN_IN_TABLE", "No such column " + column + " in table " + name);
+                }
+                positions.push_back(static_cast<size_t>(it - target.columns.begin()));
+            } while (parser.acceptSymbol(","));
+            parser.expectSymbol(")");
+        } else {
+            for (size_t i = 0; i < target.columns.size(); ++i) {
+                positions.push_back(i);
+            }
+        }
+        parser.skipSettings();
+
+        std::vector<Row> rows;
+        if (parser.peekKeyword("SELECT")) {
+            auto select = parser.select();
+            parser.expectEnd();
+            ResultSet result = runSelect(*select);
+            if (result.columns.size() != positions.size()) {
+                throw ClickHouseError(20, "NUMBER_OF_COLUMNS_DOESNT_MATCH", "Number of columns doesn't match");
+            }
+            for (auto& source : result.rows) {
+                rows.push_back(completeRow(target, positions, [&](size_t i) { return source[i]; }));
+            }
+        } else if (parser.acceptKeyword("VALUES")) {
+            insertValues(parser, target, positions, rows);
+        } else {
+            parser.expectKeyword("FORMAT");
+            std::string format = parser.identifier();
+            // Data starts after the whitespace that ends the query line
+            size_t offset = parser.lexer().consumed();
+            while (offset < text.size() && (text[offset] == ' ' || text[offset] == '\t' || text[offset] == '\r')) {
+                ++offset;
+            }
+            if (offset < text.size() && text[offset] == '\n') {
+                ++offset;
+            }
+            std::string_view payload = std::string_view(text).substr(offset);
+            if (format == "Values") {
+                Parser values(payload);
+                insertValues(values, target, positions, rows);
+            } else {
+                insertFormatted(normalizeFormat(format), payload, target, positions, rows);
+            }
+        }
+
+        QueryResult result;
+        result.writtenRows = rows.size();
+        append(name, target, std::move(rows));
+        return result;
+    }
+
+    void append(const std::string& name, FakeClickHouseStore::Table& target, std::vector<Row> rows) {
+        size_t firstRow = target.rows.size();
+        target.rows.reserve(target.rows.size() + rows.size());
+        for (auto& row : rows) {
+            target.rows.push_back(std::move(row));
+        }
+        if (!rows.empty()) {
+            feedViews(name, firstRow);
+        }
+    }
+
+    // Runs every view on `table` over the rows from firstRow and inserts the
+    // results into the view targets, which may feed further views
+    void feedViews(const std::string& name, size_t firstRow) {
+        for (const auto& [viewName, view] : store_.views_) {
+            if (view.source != name) {
+                continue;
+            }
+            StatementRunner runner(store_, view.database);
+            runner.block_ = InsertedBlock{name, firstRow};
+            Parser parser(view.select);
+            auto select = parser.select();
+            ResultSet result = runner.runSelect(*select);
+
+            auto& target = table(view.target);
+            std::vector<size_t> positions;
+            for (const auto& column : result.columns) {
+                auto it = std::find_if(target.columns.begin(), target.columns.end(), [&](const ColumnDef& def) { return def.name == column.name; });
+                if (it == target.columns.end()) {
+                    throw ClickHouseError(16, "NO_SUCH_COLUMN_IN_TABLE", "No such column " + column.name + " in table " + view.target);
+                }
+                positions.push_back(static_cast<size_t>(it - target.columns.begin()));
+            }
+            std::vector<Row> rows;
+            for (auto& source : result.rows) {
+                rows.push_back(completeRow(target, positions, [&](size_t i) { return source[i]; }));
+            }
+            append(view.target, target, std::move(rows));
+        }
+    }
+
+    template <typename Source>
+    Row completeRow(const FakeClickHouseStore::Table& target, const std::vector<size_t>& positions, Source source) {
+        Row row(target.columns.size());
+        std::vector<bool> filled(target.columns.size(), false);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            row[positions[i]] = coerce(source(i), target.columns[positions[i]].type);
+            filled[positions[i]] = true;
+        }
+        for (size_t c = 0; c < target.columns.size(); ++c) {
+            if (filled[c]) {
+                continue;
+            }
+            const auto& column = target.columns[c];
+            if (column.defaultExpr) {
+                static const Relation kEmpty;
+                Evaluator evaluator(kEmpty);
+                row[c] = coerce(evaluator.eval(*column.defaultExpr, nullptr, nullptr).value, column.type);
+            } else {
+                row[c] = coerce(std::monostate{}, column.type);
+            }
+        }
+        return row;
+    }
+
+    void insertValues(Parser& parser, const FakeClickHouseStore::Table& target, const std::vector<size_t>& positions, std::vector<Row>& rows) {
+        static const Relation kEmpty;
+        Evaluator evaluator(kEmpty);
+        do {
+            parser.expectSymbol("(");
+            std::vector<Value> values;
+            if (!parser.peekSymbol(")")) {
+                for (const auto& expr : parser.expressionList()) {
+                    values.push_back(evaluator.eval(*expr, nullptr, nullptr).value);
+                }
+            }
+            parser.expectSymbol(")");
+            if (values.size() != positions.size()) {
+                throw ClickHouseError(20, "NUMBER_OF_COLUMNS_DOESNT_MATCH",
+                    "Expected " + std::to_string(positions.size()) + " values, got " + std::to_string(values.size()));
+            }
+            rows.push_back(completeRow(target, positions, [&](size_t i) { return values[i]; }));
+            parser.acceptSymbol(",");
+        } while (parser.peekSymbol("("));
+        parser.expectEnd();
+    }
+
+    void insertFormatted(const std::string& format, std::string_view payload, const FakeClickHouseStore::Table& target,
+                         const std::vector<size_t>& positions, std::vector<Row>& rows) {
+        if (format == "RowBinary") {
+            const auto* data = reinterpret_cast<const uint8_t*>(payload.data());
+            const uint8_t* end = data + payload.size();
+            std::vector<Value> values(positions.size());
+            while (data < end) {
+                for (size_t i = 0; i < positions.size(); ++i) {
+                    values[i] = readRowBinary(data, end, target.columns[positions[i]].type);
+                }
+                rows.push_back(completeRow(target, positions, [&](size_t i) { return values[i]; }));
+            }
+            return;
+        }
+
+        bool skipHeader = format == "TabSeparatedWithNames";
+        size_t lineStart = 0;
+        while (lineStart < payload.size()) {
+            size_t lineEnd = payload.find('\n', lineStart);
+            if (lineEnd == std::string_view::npos) {
+                lineEnd = payload.size();
+            }
+            std::string_view line = payload.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (line.find_first_not_of(" \t") == std::string_view::npos) {
+                continue;
+            }
+
+            if (format == "JSONEachRow") {
+                auto object = nlohmann::json::parse(line.begin(), line.end(), nullptr, false);
+                if (!object.is_object()) {
+                    throw ClickHouseError(117, "INCORRECT_DATA", "Cannot parse JSON object here: " + std::string(line.substr(0, 64)));
+                }
+                std::vector<size_t> present;
+                std::vector<Value> values;
+                for (size_t position : positions) {
+                    const auto& column = target.columns[position];
+                    auto field = object.find(column.name);
+                    if (field != object.end()) {
+                        present.push_back(position);
+                        values.push_back(fromJson(*field, column.type));
+                    }
+                }
+                rows.push_back(completeRow(target, present, [&](size_t i) { return values[i]; }));
+            } else if (format == "TabSeparated" || format == "TabSeparatedWithNames") {
+                if (skipHeader) {
+                    skipHeader = false;
+                    continue;
+                }
+                std::vector<Value> values;
+                size_t fieldStart = 0;
+                for (size_t i = 0; i < positions.size(); ++i) {
+                    size_t fieldEnd = line.find('\t', fieldStart);
+                    if ((fieldEnd == std::string_view::npos) != (i + 1 == positions.size())) {
+                        throw ClickHouseError(27, "CANNOT_PARSE_INPUT_ASSERTION_FAILED", "Wrong number of fields in TSV row: " + std::string(line.substr(0, 64)));
+                    }
+                    values.push_back(parseText(line.substr(fieldStart, fieldEnd - fieldStart), target.columns[positions[i]].type));
+                    fieldStart = fieldEnd + 1;
+                }
+                rows.push_back(completeRow(target, positions, [&](size_t i) { return values[i]; }));
+            } else {
+                throw error::notImplemented("Input format " + format);
+            }
+        }
+    }
+
+    Relation source(const TableRef& ref) {
+        Relation relation;
+        if (ref.subquery) {
+            ResultSet result = runSelect(*ref.subquery);
+            for (auto& column : result.columns) {
+                relation.columns.push_back({ref.alias, column.name, column.type});
+            }
+            for (auto& row : result.rows) {
+                relation.owned.push_back(std::move(row));
+                relation.rows.push_back(&relation.owned.back());
+            }
+            relation.readRows = result.readRows;
+            relation.readBytes = result.readBytes;
+            return relation;
+        }
+
+        std::string name = fullName(ref.table);
+        const auto& stored = table(name);
+        std::string qualifier = ref.alias.empty() ? name.substr(name.find('.') + 1) : ref.alias;
+        for (const auto& column : stored.columns) {
+            relation.columns.push_back({qualifier, column.name, column.type});
+        }
+        size_t firstRow = block_ && block_->table == name ? block_->firstRow : 0;
+        relation.rows.reserve(stored.rows.size() - firstRow);
+        for (size_t r = firstRow; r < stored.rows.size(); ++r) {
+            relation.rows.push_back(&stored.rows[r]);
+            for (const auto& value : stored.rows[r]) {
+                relation.readBytes += valueBytes(value);
+            }
+        }
+        relation.readRows = relation.rows.size();
+        if (ref.final && stored.replacing) {
+            relation.rows = replaced(stored, relation.rows);
+        }
+        return relation;
+    }
+
+    // What a fully merged ReplacingMergeTree holds: per sorting key, the row with
+    // the highest version, or the last inserted one without a version column
+    static std::vector<const Row*> replaced(const FakeClickHouseStore::Table& table, const std::vector<const Row*>& rows) {
+        auto position = [&](const std::string& column) {
+            auto it = std::find_if(table.columns.begin(), table.columns.end(), [&](const ColumnDef& def) { return def.name == column; });
+            return static_cast<size_t>(it - table.columns.begin());
+        };
+        std::vector<size_t> keyColumns;
+        for (const auto& column : table.sortingKey) {
+            keyColumns.push_back(position(column));
+        }
+        std::optional<size_t> versionColumn;
+        if (!table.versionColumn.empty()) {
+            versionColumn = position(table.versionColumn);
+        }
+
+        std::unordered_map<std::string, size_t> winners;  // Key -> index into `kept`
+        std::vector<const Row*> kept;
+        for (const Row* row : rows) {
+            std::string key;
+            for (size_t column : keyColumns) {
+                appendKey(key, (*row)[column]);
+            }
+            auto [it, inserted] = winners.try_emplace(std::move(key), kept.size());
+            if (inserted) {
+                kept.push_back(row);
+                continue;
+            }
+            const Row*& current = kept[it->second];
+            if (!versionColumn || Evaluator::compare({(*row)[*versionColumn], table.columns[*versionColumn].type},
+                                                     {(*current)[*versionColumn], table.columns[*versionColumn].type}) >= 0) {
+                current = row;
+            }
+        }
+        return kept;
+    }
+
+    // Hash join on the `a.x = b.y` conjuncts of ON; other conjuncts filter the matches
+    Relation join(Relation left, Relation right, const Expr& on, bool leftJoin) {
+        Relation combined;
+        combined.columns = left.columns;
+        combined.columns.insert(combined.columns.end(), right.columns.begin(), right.columns.end());
+        combined.readRows = left.readRows + right.readRows;
+        combined.readBytes = left.readBytes + right.readBytes;
+
+        std::vector<const Expr*> conjuncts;
+        std::vector<const Expr*> pending{&on};
+        while (!pending.empty()) {
+            const Expr* expr = pending.back();
+            pending.pop_back();
+            if (expr->kind == Expr::Kind::BINARY && expr->name == "AND") {
+                pending.push_back(expr->args[1].get());
+                pending.push_back(expr->args[0].get());
+            } else {
+                conjuncts.push_back(expr);
+            }
+        }
+
+        Evaluator leftEval(left);
+        Evaluator rightEval(right);
+        Evaluator combinedEval(combined);
+        std::vector<std::pair<const Expr*, const Expr*>> keys;  // (left side, right side)
+        std::vector<const Expr*> residual;
+        for (const Expr* conjunct : conjuncts) {
+            bool equality = conjunct->kind == Expr::Kind::BINARY && conjunct->name == "=" &&
+                            conjunct->args[0]->kind == Expr::Kind::COLUMN && conjunct->args[1]->kind == Expr::Kind::COLUMN;
+            if (equality) {
+                const Expr* a = conjunct->args[0].get();
+                const Expr* b = conjunct->args[1].get();
+                if (leftEval.tryResolve(a->qualifier, a->name) && rightEval.tryResolve(b->qualifier, b->name)) {
+                    keys.emplace_back(a, b);
+                    continue;
+                }
+                if (leftEval.tryResolve(b->qualifier, b->name) && rightEval.tryResolve(a->qualifier, a->name)) {
+                    keys.emplace_back(b, a);
+                    continue;
+                }
+            }
+            residual.push_back(conjunct);
+        }
+
+        auto keyOf = [](const Evaluator& evaluator, const std::vector<std::pair<const Expr*, const Expr*>>& pairs, bool leftSide, const Row* row) {
+            std::string key;
+            for (const auto& pair : pairs) {
+                const Expr* column = leftSide ? pair.first : pair.second;
+                appendKey(key, (*row)[evaluator.resolve(*column)]);
+            }
+            return key;
+        };
+
+        std::unordered_multimap<std::string, const Row*> index;
+        index.reserve(right.rows.size());
+        for (const Row* row : right.rows) {
+            index.emplace(keyOf(rightEval, keys, false, row), row);
+        }
+
+        Row defaults;
+        for (const auto& column : right.columns) {
+            defaults.push_back(coerce(std::monostate{}, column.type));
+        }
+        auto emit = [&](const Row& leftRow, const Row& rightRow) {
+            Row row = leftRow;
+            row.insert(row.end(), rightRow.begin(), rightRow.end());
+            for (const Expr* condition : residual) {
+                if (!truthy(combinedEval.eval(*condition, &row, nullptr).value)) {
+                    return false;
+                }
+            }
+            combined.owned.push_back(std::move(row));
+            combined.rows.push_back(&combined.owned.back());
+            return true;
+        };
+
+        for (const Row* leftRow : left.rows) {
+            bool matched = false;
+            if (keys.empty()) {
+                for (const Row* rightRow : right.rows) {
+                    matched |= emit(*leftRow, *rightRow);
+                }
+            } else {
+                auto [begin, end] = index.equal_range(keyOf(leftEval, keys, true, leftRow));
+                for (auto it = begin; it != end; ++it) {
+                    matched |= emit(*leftRow, *it->second);
+                }
+            }
+            if (!matched && leftJoin) {
+                emit(*leftRow, defaults);
+            }
+        }
+        return combined;
+    }
+
+    ResultSet runSelect(const SelectQuery& query) {
+        Relation relation;
+        if (query.from) {
+            relation = source(*query.from);
+            for (const auto& clause : query.joins) {
+                relation = join(std::move(relation), source(clause.right), *clause.on, clause.left);
+            }
+        } else {
+            relation.owned.emplace_back();
+            relation.rows.push_back(&relation.owned.back());
+        }
+        Evaluator evaluator(relation);
+
+        // Expand '*'
+        std::vector<SelectItem> items;
+        std::vector<std::shared_ptr<Expr>> expanded;
+        for (const auto& item : query.items) {
+            if (item.expr->kind != Expr::Kind::STAR) {
+                items.push_back(item);
+                continue;
+            }
+            for (const auto& column : relation.columns) {
+                auto expr = std::make_shared<Expr>();
+                expr->kind = Expr::Kind::COLUMN;
+                expr->qualifier = column.qualifier;
+                expr->name = column.name;
+                expr->text = column.name;
+                items.push_back({expr, ""});
+            }
+        }
+
+        std::unordered_map<std::string, const Expr*> aliases;
+        for (const auto& item : items) {
+            if (!item.alias.empty()) {
+                aliases.emplace(item.alias, item.expr.get());
+            }
+        }
+        evaluator.setAliases(&aliases);
+
+        std::vector<const Row*> filtered;
+        filtered.reserve(relation.rows.size());
+        for (const Row* row : relation.rows) {
+            if (!query.where || truthy(evaluator.eval(*query.where, row, nullptr).value)) {
+                filtered.push_back(row);
+            }
+        }
+
+        bool aggregated = !query.groupBy.empty() || query.having ||
+            std::any_of(items.begin(), items.end(), [](const SelectItem& item) { return hasAggregate(*item.expr); });
+
+        struct Output {
+            Row values;
+            std::vector<Datum> keys;
+        };
+        std::vector<Output> outputs;
+        std::vector<ColumnType> types(items.size());
+        bool typed = false;
+
+        auto produce = [&](const Row* first, const std::vector<const Row*>* group) {
+            if (query.having && !truthy(evaluator.eval(*query.having, first, group, true).value)) {
+                return;
+            }
+            Output output;
+            output.values.reserve(items.size());
+            for (size_t i = 0; i < items.size(); ++i) {
+                Datum datum = evaluator.eval(*items[i].expr, first, group);
+                if (!typed) {
+                    types[i] = datum.type;
+                }
+                output.values.push_back(std::move(datum.value));
+            }
+            typed = true;
+            for (const auto& order : query.orderBy) {
+                output.keys.push_back(evaluator.eval(*order.expr, first, group, true));
+            }
+            outputs.push_back(std::move(output));
+        };
+
+        if (aggregated) {
+            std::vector<std::vector<const Row*>> groups;
+            if (query.groupBy.empty()) {
+                groups.push_back(std::move(filtered));
+            } else {
+                std::unordered_map<std::string, size_t> groupIndex;
+                for (const Row* row : filtered) {
+                    std::string key;
+                    for (const auto& expr : query.groupBy) {
+                        appendKey(key, evaluator.eval(*expr, row, nullptr, true).value);
+                    }
+                    auto [it, inserted] = groupIndex.emplace(std::move(key), groups.size());
+                    if (inserted) {
+                        groups.emplace_back();
+                    }
+                    groups[it->second].push_back(row);
+                }
+            }
+            for (const auto& group : groups) {
+                produce(group.empty() ? nullptr : group.front(), &group);
+            }
+        } else {
+            for (const Row* row : filtered) {
+                produce(row, nullptr);
+            }
+        }
+
+        if (!typed) {
+            // No rows: derive result types by evaluating against a missing row
+            static const std::vector<const Row*> kNoRows;
+            for (size_t i = 0; i < items.size(); ++i) {
+                try {
+                    types[i] = evaluator.eval(*items[i].expr, nullptr, &kNoRows).type;
+                } catch (const ClickHouseError& e) {
+                    if (e.code() == 47) {
+                        throw;  // Unknown columns fail even on empty tables
+                    }
+                    types[i] = ColumnType{};
+                }
+            }
+        }
+
+        if (query.distinct) {
+            std::unordered_set<std::string> seen;
+            std::vector<Output> unique;
+            for (auto& output : outputs) {
+                std::string key;
+                for (const auto& value : output.values) {
+                    appendKey(key, value);
+                }
+                if (seen.insert(std::move(key)).second) {
+                    unique.push_back(std::move(output));
+                }
+            }
+            outputs = std::move(unique);
+        }
+
+        if (!query.orderBy.empty()) {
+            std::stable_sort(outputs.begin(), outputs.end(), [&](const Output& lhs, const Output& rhs) {
+                for (size_t k = 0; k < query.orderBy.size(); ++k) {
+                    int result = Evaluator::compare(lhs.keys[k], rhs.keys[k]);
+                    if (result != 0) {
+                        return query.orderBy[k].descending ? result > 0 : result < 0;
+                    }
+                }
+                return false;
+            });
+        }
+
+        ResultSet result;
+        result.readRows = relation.readRows;
+        result.readBytes = relation.readBytes;
+        result.rowsBeforeLimit = outputs.size();
+        result.limited = query.limit.has_value();
+        size_t begin = std::min<size_t>(query.offset, outputs.size());
+        size_t end = query.limit ? std::min<size_t>(outputs.size(), begin + *query.limit) : outputs.size();
+        for (size_t i = 0; i < items.size(); ++i) {
+            result.columns.push_back({"", outputName(items[i]), types[i]});
+        }
+        result.rows.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            result.rows.push_back(std::move(outputs[i].values));
+        }
+        return result;
+    }
+};
+
+FakeClickHouseStore::FakeClickHouseStore() {
+    databases_ = {"default", "system"};
+}
+
+QueryResult FakeClickHouseStore::execute(std::string_view query, std::string_view data, const std::string& database,
+                                         const QueryParameters& parameters) {
+    return StatementRunner(*this, database).run(query, data, parameters);
+}
+
+bool FakeClickHouseStore::hasTable(const std::string& table, const std::string& database) const {
+    std::shared_lock lock(mutex_);
+    return tables_.count(table.find('.') == std::string::npos ? database + "." + table : table) > 0;
+}
+
+size_t FakeClickHouseStore::rowCount(const std::string& table, const std::string& database) const {
+    std::shared_lock lock(mutex_);
+    auto it = tables_.find(table.find('.') == std::string::npos ? database + "." + table : table);
+    return it == tables_.end() ? 0 : it->second.rows.size();
+}
+
+void FakeClickHouseStore::clear() {
+    std::unique_lock lock(mutex_);
+    tables_.clear();
+    views_.clear();
+    databases_ = {"default", "system"};
+}
+
+} // namespace trading::fake_clickhouse
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "clickhouse_types.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trading::fake_clickhouse {
+
+struct QueryResult {
+    std::string body;
+    std::string format;          // Output format, empty for statements without a result set
+    uint64_t readRows = 0;
+    uint64_t readBytes = 0;
+    uint64_t writtenRows = 0;
+    uint64_t resultRows = 0;
+};
+
+// param_<name> values of the HTTP request, substituted for {name:Type}
+using QueryParameters = std::map<std::string, std::string>;
+
+struct Expr;
+
+struct ColumnDef {
+    std::string name;
+    ColumnType type;
+    std::shared_ptr<const Expr> defaultExpr;  // DEFAULT clause; null uses the type default
+};
+
+// In-memory tables behind the fake server. Understands the SQL the repository
+// emits rather than ClickHouse SQL at large:
+//   CREATE/DROP DATABASE, CREATE/DROP/TRUNCATE TABLE (ENGINE and the rest of the
+//   definition are accepted and ignored, except that SELECT ... FROM t FINAL on a
+//   ReplacingMergeTree returns the rows a full merge would keep), EXISTS TABLE,
+//   CREATE/DROP MATERIALIZED VIEW ... TO target AS SELECT (run over each
+//   inserted block, like the real thing),
+//   INSERT INTO t [(cols)] VALUES ... | SELECT ... | FORMAT RowBinary|JSONEachRow|TabSeparated <data>,
+//   SELECT with WHERE, INNER JOIN on subqueries, GROUP BY, HAVING, ORDER BY,
+//   LIMIT [OFFSET] and FORMAT JSON|JSONEachRow|TabSeparated[WithNames]|
+//   RowBinary[WithNamesAndTypes]; aggregates count/sum/min/max/avg/any/argMax/argMin/uniq
+//   and the argMin/argMax -State and -Merge combinators; JSONExtractString/Float;
+//   {name:Type} query parameters in expressions, LIMIT and (for Array types) IN.
+// Anything else fails with the ClickHouse error the real server would return.
+// Thread-safe: SELECTs share a read lock, everything else takes the write lock.
+class FakeClickHouseStore {
+public:
+    FakeClickHouseStore();
+
+    // `data` follows the query text, as an HTTP body after a `query` URL parameter
+    QueryResult execute(std::string_view query, std::string_view data = {}, const std::string& database = "default",
+                        const QueryParameters& parameters = {});
+
+    bool hasTable(const std::string& table, const std::string& database = "default") const;
+    size_t rowCount(const std::string& table, const std::string& database = "default") const;
+    void clear();
+
+private:
+    struct Table {
+        std::vector<ColumnDef> columns;
+        std::vector<std::vector<Value>> rows;
+        std::vector<std::string> sortingKey;   // ORDER BY columns; empty names for expressions
+        std::string versionColumn;             // ReplacingMergeTree(ver)
+        bool replacing = false;                // FINAL keeps one row per sorting key
+    };
+
+    // A materialized view: its SELECT runs over each block inserted into `source`
+    // and the result is inserted into `target`
+    struct View {
+        std::string source;      // "database.table"
+        std::string target;      // "database.table"
+        std::string select;
+        std::string database;    // Resolves unqualified names in the SELECT
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::set<std::string> databases_;
+    std::map<std::string, Table> tables_;   // Keyed by "database.table"
+    std::map<std::string, View> views_;     // Keyed by "database.view"
+
+    friend class StatementRunner;
+};
+
+} // namespace trading::fake_clickhouse
@@ -0,0 +1,98 @@
+#include "fake_clickhouse_server.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using trading::fake_clickhouse::FakeClickHouseConfig;
+using trading::fake_clickhouse::FakeClickHouseServer;
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int) {
+    g_running = false;
+}
+
+void printUsage() {
+    std::cout << "Usage: bull-fake-clickhouse [options]\n"
+              << "  --host <ip>                 Listen address (default 127.0.0.1)\n"
+              << "  --port <port>               Listen port (default 8123)\n"
+              << "  --latency-ms <ms>           Delay added to every response (default 0)\n"
+              << "  --jitter-ms <ms>            Uniform extra delay up to this value (default 0)\n"
+              << "  --failure-rate <0..1>       Share of requests answered with an error (default 0)\n"
+              << "  --failure-status <code>     HTTP status of injected failures (default 500)\n"
+              << "  --seed <n>                  Seed for jitter and failures (default 42)\n";
+}
+
+std::chrono::microseconds millis(const std::string& value) {
+    return std::chrono::microseconds(static_cast<int64_t>(std::stod(value) * 1000.0));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    FakeClickHouseConfig config;
+    config.port = 8123;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--host") config.host = value;
+            else if (arg == "--port") config.port = std::stoi(value);
+            else if (arg == "--latency-ms") config.latency = millis(value);
+            else if (arg == "--jitter-ms") config.jitter = millis(value);
+            else if (arg == "--failure-rate") config.failureRate = std::stod(value);
+            else if (arg == "--failure-status") config.failureStatus = std::stoi(value);
+            else if (arg == "--seed") config.seed = std::stoull(value);
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.failureRate < 0.0 || config.failureRate > 1.0) {
+        std::cerr << "--failure-rate must be within [0, 1]" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    FakeClickHouseServer server(config);
+    if (!server.start()) {
+        return 1;
+    }
+    std::cout << "[Fake ClickHouse] Listening on " << config.host << ":" << server.port()
+              << " (latency " << config.latency.count() / 1000.0 << "ms, jitter " << config.jitter.count() / 1000.0
+              << "ms, failure rate " << config.failureRate << ")" << std::endl;
+
+    while (g_running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    server.stop();
+
+    auto stats = server.stats();
+    std::cout << "[Fake ClickHouse] Stopped after " << stats.requests << " requests (" << stats.queries << " queries, "
+              << stats.errors << " errors, " << stats.injectedFailures << " injected failures)" << std::endl;
+    return 0;
+}
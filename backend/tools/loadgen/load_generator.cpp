@@ -0,0 +1,782 @@
+#include "load_generator.hpp"
+#include "rpc_codec.hpp"
+#include "websocket_frame.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string_view>
+
+#ifndef IP_BIND_ADDRESS_NO_PORT
+#define IP_BIND_ADDRESS_NO_PORT 24
+#endif
+
+namespace trading::loadgen {
+
+namespace {
+
+constexpr size_t kMaxFramePayload = 16 * 1024 * 1024;
+constexpr size_t kReadChunk = 64 * 1024;
+constexpr size_t kRetainedBufferBytes = 4096;  // Larger idle buffers are freed; 50k connections add up
+constexpr size_t kMaxUpgradeResponse = 16 * 1024;
+constexpr int kEpollBatch = 512;
+constexpr int kLoopTimeoutMs = 1;
+constexpr int64_t kTimeoutScanNs = 100'000'000;
+constexpr size_t kOpenOrdersKept = 16;
+constexpr int64_t kHistoryWindowMs = 3'600'000;
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t wallMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+constexpr size_t methodIndex(LoadMethod method) {
+    return static_cast<size_t>(method);
+}
+
+// Reply method names as sent by the server
+std::optional<LoadMethod> replyMethod(std::string_view method) {
+    if (method == "hello") return LoadMethod::HELLO;
+    if (method == "market.subscribe_response" || method == "market.subscribe") return LoadMethod::SUBSCRIBE;
+    if (method == "orders.place") return LoadMethod::PLACE;
+    if (method == "orders.cancel") return LoadMethod::CANCEL;
+    if (method == "history.query") return LoadMethod::HISTORY;
+    return std::nullopt;
+}
+
+std::string percentEncode(std::string_view value) {
+    static constexpr char kHex[] = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += kHex[c >> 4];
+            out += kHex[c & 0x0F];
+        }
+    }
+    return out;
+}
+
+nlohmann::json latencyJson(const trading::infrastructure::metrics::LatencyHistogram& histogram) {
+    auto stats = histogram.snapshot();
+    return {
+        {"count", stats.count},
+        {"meanMs", stats.meanMs},
+        {"p50Ms", stats.p50Ms},
+        {"p95Ms", stats.p95Ms},
+        {"p99Ms", stats.p99Ms},
+        {"p999Ms", stats.p999Ms},
+        {"maxMs", stats.maxMs}
+    };
+}
+
+struct Connection {
+    enum class State { IDLE, CONNECTING, UPGRADING, HELLO, SUBSCRIBING, READY, CLOSED };
+
+    int fd = -1;
+    State state = State::IDLE;
+    uint32_t id = 0;
+    const std::vector<std::string>* symbols = nullptr;
+    const std::string* sourceIp = nullptr;
+    std::vector<uint8_t> in;
+    std::vector<uint8_t> out;
+    size_t outOffset = 0;
+    bool wantWrite = false;
+    std::vector<uint8_t> fragments;
+    uint64_t nextMessageId = 1;
+    std::array<std::vector<int64_t>, kLoadMethodCount> pending;  // Scheduled send times, oldest first
+    std::string lastIdempotencyKey;
+    std::vector<std::string> openOrders;
+    uint64_t orders = 0;
+};
+
+} // namespace
+
+class LoadGenerator::Worker {
+public:
+    Worker(const LoadConfig& config, LoadStats& stats, const std::atomic<bool>& running, size_t index, size_t workerCount)
+        : config_(config), stats_(stats), running_(running), random_(0x9E3779B97F4A7C15ULL * (index + 1)) {
+        for (size_t id = index; id < static_cast<size_t>(config.connections); id += workerCount) {
+            Connection connection;
+            connection.id = static_cast<uint32_t>(id);
+            if (!config.symbolSets.empty()) {
+                connection.symbols = &config.symbolSets[id % config.symbolSets.size()];
+            }
+            if (!config.sourceIps.empty()) {
+                connection.sourceIp = &config.sourceIps[id % config.sourceIps.size()];
+            }
+            connections_.push_back(std::move(connection));
+        }
+
+        double share = 1.0 / static_cast<double>(workerCount);
+        connectRate_ = std::max(1.0, config.connectRate * share);
+        rates_[methodIndex(LoadMethod::PLACE)] = config.placeRate * share;
+        rates_[methodIndex(LoadMethod::CANCEL)] = config.cancelRate * share;
+        rates_[methodIndex(LoadMethod::HISTORY)] = config.historyRate * share;
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    }
+
+    ~Worker() {
+        for (auto& connection : connections_) {
+            if (connection.fd >= 0) {
+                ::close(connection.fd);
+            }
+        }
+        if (epollFd_ >= 0) {
+            ::close(epollFd_);
+        }
+    }
+
+    void run(int64_t startNs, int64_t endNs) {
+        if (epollFd_ < 0) {
+            std::cerr << "[LoadGen] epoll_create1 failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        epoll_event events[kEpollBatch];
+        int64_t now = steadyNs();
+        while (running_.load(std::memory_order_relaxed) && now < endNs) {
+            openConnections(now - startNs);
+            issueRequests(now);
+            if (now - lastTimeoutScanNs_ >= kTimeoutScanNs) {
+                expireRequests(now);
+                lastTimeoutScanNs_ = now;
+            }
+
+            int ready = ::epoll_wait(epollFd_, events, kEpollBatch, kLoopTimeoutMs);
+            for (int i = 0; i < ready; ++i) {
+                auto& connection = connections_[events[i].data.u64];
+                if (connection.state == Connection::State::CLOSED) {
+                    continue;
+                }
+                if (connection.state == Connection::State::CONNECTING) {
+                    onConnected(connection);
+                    continue;
+                }
+                if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                    onReadable(connection);
+                }
+                if (connection.state != Connection::State::CLOSED && (events[i].events & EPOLLOUT)) {
+                    flush(connection);
+                }
+            }
+            now = steadyNs();
+        }
+    }
+
+private:
+    const LoadConfig& config_;
+    LoadStats& stats_;
+    const std::atomic<bool>& running_;
+    std::mt19937_64 random_;
+    std::vector<uint8_t> readBuffer_ = std::vector<uint8_t>(kReadChunk);  // Shared by the worker's connections
+    int epollFd_ = -1;
+    std::vector<Connection> connections_;
+    size_t nextToOpen_ = 0;
+    size_t roundRobin_ = 0;
+    double connectRate_ = 0.0;
+    std::array<double, kLoadMethodCount> rates_{};
+    std::array<uint64_t, kLoadMethodCount> scheduled_{};
+    int64_t scheduleStartNs_ = 0;  // Set once the first connection is ready
+    int64_t lastTimeoutScanNs_ = 0;
+    size_t readyCount_ = 0;
+
+    void openConnections(int64_t elapsedNs) {
+        auto allowed = static_cast<size_t>(connectRate_ * static_cast<double>(elapsedNs) / 1e9) + 1;
+        allowed = std::min(allowed, connections_.size());
+        while (nextToOpen_ < allowed) {
+            openConnection(nextToOpen_++);
+        }
+    }
+
+    void openConnection(size_t slot) {
+        auto& connection = connections_[slot];
+        stats_.connectAttempts.fetch_add(1, std::memory_order_relaxed);
+
+        connection.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (connection.fd < 0) {
+            close(connection);
+            return;
+        }
+        int one = 1;
+        ::setsockopt(connection.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (connection.sourceIp) {
+            // Ports are then picked per destination at connect(), not reserved at bind()
+            ::setsockopt(connection.fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &one, sizeof(one));
+            sockaddr_in local{};
+            local.sin_family = AF_INET;
+            if (::inet_pton(AF_INET, connection.sourceIp->c_str(), &local.sin_addr) != 1 ||
+                ::bind(connection.fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+                close(connection);
+                return;
+            }
+        }
+
+        sockaddr_in remote{};
+        remote.sin_family = AF_INET;
+        remote.sin_port = htons(static_cast<uint16_t>(config_.port));
+        if (::inet_pton(AF_INET, config_.host.c_str(), &remote.sin_addr) != 1 ||
+            (::connect(connection.fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0 && errno != EINPROGRESS)) {
+            close(connection);
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT;
+        event.data.u64 = slot;
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, connection.fd, &event) != 0) {
+            close(connection);
+            return;
+        }
+        connection.wantWrite = true;
+        connection.state = Connection::State::CONNECTING;
+    }
+
+    void onConnected(Connection& connection) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (::getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+            close(connection);
+            return;
+        }
+
+        std::string target = "/?clientId=" + percentEncode("loadgen-" + std::to_string(connection.id)) +
+                             "&deviceId=" + percentEncode("loadgen-device-" + std::to_string(connection.id)) +
+                             "&token=" + percentEncode(config_.token);
+        auto request = buildUpgradeRequest(config_.host, config_.port, target, makeWebSocketKey(random_()));
+        connection.out.assign(request.begin(), request.end());
+        connection.state = Connection::State::UPGRADING;
+        flush(connection);
+    }
+
+    void onReadable(Connection& connection) {
+        while (true) {
+            ssize_t received = ::recv(connection.fd, readBuffer_.data(), readBuffer_.size(), 0);
+            if (received > 0) {
+                stats_.bytesReceived.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+                connection.in.insert(connection.in.end(), readBuffer_.data(), readBuffer_.data() + received);
+                continue;
+            }
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            // Peer closed or the socket failed; replies already received still count
+            processInput(connection);
+            close(connection);
+            return;
+        }
+        if (processInput(connection)) {
+            if (connection.in.empty() && connection.in.capacity() > kRetainedBufferBytes) {
+                connection.in = {};
+            }
+            flush(connection);
+        }
+    }
+
+    // False when the connection was closed
+    bool processInput(Connection& connection) {
+        size_t offset = 0;
+        if (connection.state == Connection::State::UPGRADING) {
+            std::string_view received(reinterpret_cast<const char*>(connection.in.data()), connection.in.size());
+            auto headLength = upgradeResponseLength(received);
+            if (!headLength) {
+                if (received.size() > kMaxUpgradeResponse) {
+                    close(connection);
+                    return false;
+                }
+                return true;
+            }
+            if (!isUpgradeAccepted(received.substr(0, *headLength))) {
+                close(connection);
+                return false;
+            }
+            offset = *headLength;
+            stats_.open.fetch_add(1, std::memory_order_relaxed);
+            connection.state = Connection::State::HELLO;
+            sendRpc(connection, LoadMethod::HELLO, {
+                {"token", config_.token},
+                {"clientId", "loadgen-" + std::to_string(connection.id)},
+                {"deviceId", "loadgen-device-" + std::to_string(connection.id)}
+            }, steadyNs());
+        }
+
+        while (connection.state != Connection::State::CLOSED && offset < connection.in.size()) {
+            WsFrame frame;
+            auto used = decodeServerFrame(connection.in.data() + offset, connection.in.size() - offset, frame, kMaxFramePayload);
+            if (!used) {
+                stats_.protocolErrors.fetch_add(1, std::memory_order_relaxed);
+                close(connection);
+                return false;
+            }
+            if (*used == 0) {
+                break;
+            }
+            offset += *used;
+
+            switch (frame.opcode) {
+                case WsOpcode::PING:
+                    queueFrame(connection, WsOpcode::PONG, frame.payload, frame.payloadSize);
+                    break;
+                case WsOpcode::CLOSE:
+                    close(connection);
+                    return false;
+                case WsOpcode::TEXT:
+                case WsOpcode::BINARY:
+                    if (frame.fin) {
+                        onMessage(connection, frame.payload, frame.payloadSize);
+                    } else {
+                        connection.fragments.assign(frame.payload, frame.payload + frame.payloadSize);
+                    }
+                    break;
+                case WsOpcode::CONTINUATION:
+                    connection.fragments.insert(connection.fragments.end(), frame.payload, frame.payload + frame.payloadSize);
+                    if (frame.fin) {
+                        onMessage(connection, connection.fragments.data(), connection.fragments.size());
+                        connection.fragments.clear();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (connection.state == Connection::State::CLOSED) {
+            return false;
+        }
+        connection.in.erase(connection.in.begin(), connection.in.begin() + static_cast<std::ptrdiff_t>(offset));
+        return true;
+    }
+
+    void onMessage(Connection& connection, const uint8_t* data, size_t size) {
+        auto message = decodeServerMessage(data, size);
+        if (!message) {
+            stats_.protocolErrors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (message->kind == ServerMessage::Kind::ACK) {
+            stats_.acksReceived.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (message->kind == ServerMessage::Kind::DATA) {
+            std::vector<uint8_t> ack;
+            appendAck(ack, message->messageId);
+            queueFrame(connection, WsOpcode::BINARY, ack.data(), ack.size());
+        }
+
+        if (message->method == "market_data") {
+            stats_.ticks.fetch_add(1, std::memory_order_relaxed);
+            if (message->payload.is_object() && message->payload.contains("timestamp") &&
+                message->payload["timestamp"].is_number()) {
+                int64_t lagMs = wallMs() - message->payload["timestamp"].get<int64_t>();
+                stats_.tickLag.record(static_cast<uint64_t>(std::max<int64_t>(lagMs, 0)) * 1'000'000);
+            }
+            return;
+        }
+
+        auto method = replyMethod(message->method);
+        if (!method) {
+            stats_.unmatchedReplies.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        onReply(connection, *method, message->payload);
+    }
+
+    void onReply(Connection& connection, LoadMethod method, const nlohmann::json& payload) {
+        auto& pending = connection.pending[methodIndex(method)];
+        if (pending.empty()) {
+            stats_.unmatchedReplies.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        int64_t scheduledNs = pending.front();
+        pending.erase(pending.begin());
+
+        auto& methodStats = stats_.methods[methodIndex(method)];
+        methodStats.responses.fetch_add(1, std::memory_order_relaxed);
+        methodStats.latency.record(static_cast<uint64_t>(std::max<int64_t>(steadyNs() - scheduledNs, 0)));
+        bool error = payload.is_object() && payload.contains("error");
+        if (error) {
+            methodStats.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        switch (method) {
+            case LoadMethod::HELLO:
+                if (error) {
+                    close(connection);
+                } else if (connection.symbols && !connection.symbols->empty()) {
+                    connection.state = Connection::State::SUBSCRIBING;
+                    sendRpc(connection, LoadMethod::SUBSCRIBE, {{"symbols", *connection.symbols}}, steadyNs());
+                } else {
+                    markReady(connection);
+                }
+                break;
+            case LoadMethod::SUBSCRIBE:
+                if (connection.state == Connection::State::SUBSCRIBING) {
+                    markReady(connection);
+                }
+                break;
+            case LoadMethod::PLACE:
+                if (!error) {
+                    if (payload.value("qos", "").find("cached") != std::string::npos) {
+                        stats_.cachedReplies.fetch_add(1, std::memory_order_relaxed);
+                    } else if (auto orderId = payload.value("orderId", ""); !orderId.empty()) {
+                        if (connection.openOrders.size() >= kOpenOrdersKept) {
+                            connection.openOrders.erase(connection.openOrders.begin());
+                        }
+                        connection.openOrders.push_back(std::move(orderId));
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void markReady(Connection& connection) {
+        connection.state = Connection::State::READY;
+        stats_.ready.fetch_add(1, std::memory_order_relaxed);
+        if (readyCount_++ == 0 && scheduleStartNs_ == 0) {
+            scheduleStartNs_ = steadyNs();
+        }
+    }
+
+    Connection* nextReady() {
+        if (readyCount_ == 0) {
+            return nullptr;
+        }
+        for (size_t scanned = 0; scanned < connections_.size(); ++scanned) {
+            auto& connection = connections_[roundRobin_++ % connections_.size()];
+            if (connection.state == Connection::State::READY) {
+                return &connection;
+            }
+        }
+        return nullptr;
+    }
+
+    // Open loop: request k of a method is due at scheduleStart + k / rate
+    void issueRequests(int64_t nowNs) {
+        if (scheduleStartNs_ == 0) {
+            return;
+        }
+        for (LoadMethod method : {LoadMethod::PLACE, LoadMethod::CANCEL, LoadMethod::HISTORY}) {
+            double rate = rates_[methodIndex(method)];
+            if (rate <= 0.0) {
+                continue;
+            }
+            auto& scheduled = scheduled_[methodIndex(method)];
+            auto due = static_cast<uint64_t>(rate * static_cast<double>(nowNs - scheduleStartNs_) / 1e9) + 1;
+            for (; scheduled < due; ++scheduled) {
+                int64_t scheduledNs = scheduleStartNs_ + static_cast<int64_t>(static_cast<double>(scheduled) / rate * 1e9);
+                Connection* connection = nextReady();
+                if (!connection || !sendScheduled(*connection, method, scheduledNs)) {
+                    stats_.methods[methodIndex(method)].unsent.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    bool sendScheduled(Connection& connection, LoadMethod method, int64_t scheduledNs) {
+        const auto& symbols = connection.symbols && !connection.symbols->empty() ? *connection.symbols : kDefaultSymbols;
+        const std::string& symbol = symbols[random_() % symbols.size()];
+
+        switch (method) {
+            case LoadMethod::PLACE: {
+                bool retry = !connection.lastIdempotencyKey.empty() &&
+                             std::uniform_real_distribution<double>(0.0, 1.0)(random_) < config_.retryRatio;
+                if (retry) {
+                    stats_.retriesSent.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    connection.lastIdempotencyKey = "lg-" + std::to_string(connection.id) + "-" + std::to_string(++connection.orders);
+                }
+                sendRpc(connection, method, {
+                    {"idempotencyKey", connection.lastIdempotencyKey},
+                    {"symbol", symbol},
+                    {"side", random_() & 1 ? "BUY" : "SELL"},
+                    {"type", "LIMIT"},
+                    {"qty", 1.0},
+                    {"price", 100.0 + static_cast<double>(random_() % 1000) / 100.0}
+                }, scheduledNs);
+                return true;
+            }
+            case LoadMethod::CANCEL: {
+                if (connection.openOrders.empty()) {
+                    return false;
+                }
+                std::string orderId = std::move(connection.openOrders.back());
+                connection.openOrders.pop_back();
+                sendRpc(connection, method, {{"orderId", orderId}}, scheduledNs);
+                return true;
+            }
+            case LoadMethod::HISTORY: {
+                int64_t toTs = wallMs();
+                sendRpc(connection, method, {
+                    {"symbol", symbol},
+                    {"fromTs", toTs - kHistoryWindowMs},
+                    {"toTs", toTs},
+                    {"interval", "M1"},
+                    {"limit", 500}
+                }, scheduledNs);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    void sendRpc(Connection& connection, LoadMethod method, const nlohmann::json& params, int64_t scheduledNs) {
+        auto frame = encodeRequest(connection.nextMessageId++, methodName(method), params);
+        queueFrame(connection, WsOpcode::BINARY, frame.data(), frame.size());
+        connection.pending[methodIndex(method)].push_back(scheduledNs);
+        stats_.methods[methodIndex(method)].sent.fetch_add(1, std::memory_order_relaxed);
+        flush(connection);
+    }
+
+    void queueFrame(Connection& connection, WsOpcode opcode, const uint8_t* payload, size_t size) {
+        appendClientFrame(connection.out, opcode, payload, size, static_cast<uint32_t>(random_()));
+    }
+
+    void flush(Connection& connection) {
+        while (connection.outOffset < connection.out.size()) {
+            ssize_t sent = ::send(connection.fd, connection.out.data() + connection.outOffset,
+                                  connection.out.size() - connection.outOffset, MSG_NOSIGNAL);
+            if (sent > 0) {
+                connection.outOffset += static_cast<size_t>(sent);
+                stats_.bytesSent.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                close(connection);
+                return;
+            }
+        }
+        if (connection.outOffset == connection.out.size()) {
+            connection.out.clear();
+            connection.outOffset = 0;
+            if (connection.out.capacity() > kRetainedBufferBytes) {
+                connection.out = {};
+            }
+        }
+
+        bool wantWrite = !connection.out.empty();
+        if (wantWrite != connection.wantWrite) {
+            epoll_event event{};
+            event.events = EPOLLIN | (wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+            event.data.u64 = static_cast<uint64_t>(&connection - connections_.data());
+            ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &event);
+            connection.wantWrite = wantWrite;
+        }
+    }
+
+    void expireRequests(int64_t nowNs) {
+        int64_t deadline = nowNs - static_cast<int64_t>(config_.responseTimeoutMs) * 1'000'000;
+        for (auto& connection : connections_) {
+            if (connection.state == Connection::State::CLOSED || connection.state == Connection::State::IDLE) {
+                continue;
+            }
+            for (size_t method = 0; method < kLoadMethodCount; ++method) {
+                auto& pending = connection.pending[method];
+                auto expired = std::find_if(pending.begin(), pending.end(), [deadline](int64_t sentNs) { return sentNs >= deadline; });
+                if (expired == pending.begin()) {
+                    continue;
+                }
+                stats_.methods[method].timeouts.fetch_add(static_cast<uint64_t>(expired - pending.begin()), std::memory_order_relaxed);
+                pending.erase(pending.begin(), expired);
+                // A session that never finished its handshake is useless for the rest of the run
+                if (method == methodIndex(LoadMethod::HELLO) || method == methodIndex(LoadMethod::SUBSCRIBE)) {
+                    close(connection);
+                    break;
+                }
+            }
+        }
+    }
+
+    void close(Connection& connection) {
+        if (connection.state == Connection::State::CLOSED) {
+            return;
+        }
+        if (connection.fd >= 0) {
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+            ::close(connection.fd);
+            connection.fd = -1;
+        }
+
+        bool upgraded = connection.state == Connection::State::HELLO || connection.state == Connection::State::SUBSCRIBING ||
+                        connection.state == Connection::State::READY;
+        if (connection.state == Connection::State::READY) {
+            stats_.ready.fetch_sub(1, std::memory_order_relaxed);
+            --readyCount_;
+        }
+        if (upgraded) {
+            stats_.open.fetch_sub(1, std::memory_order_relaxed);
+            stats_.disconnects.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!upgraded) {
+            stats_.connectFailures.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Requests still in flight will never be answered
+        for (size_t method = 0; method < kLoadMethodCount; ++method) {
+            stats_.methods[method].timeouts.fetch_add(connection.pending[method].size(), std::memory_order_relaxed);
+            connection.pending[method].clear();
+        }
+        connection.state = Connection::State::CLOSED;
+        connection.in = {};
+        connection.out = {};
+        connection.outOffset = 0;
+        connection.fragments = {};
+        connection.openOrders.clear();
+    }
+
+    inline static const std::vector<std::string> kDefaultSymbols = {"BTC-USD"};
+};
+
+LoadGenerator::LoadGenerator(LoadConfig config) : config_(std::move(config)) {
+}
+
+LoadGenerator::~LoadGenerator() {
+    stop();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+const char* LoadGenerator::methodName(LoadMethod method) {
+    switch (method) {
+        case LoadMethod::HELLO: return "hello";
+        case LoadMethod::SUBSCRIBE: return "market.subscribe";
+        case LoadMethod::PLACE: return "orders.place";
+        case LoadMethod::CANCEL: return "orders.cancel";
+        case LoadMethod::HISTORY: return "history.query";
+        default: return "unknown";
+    }
+}
+
+void LoadGenerator::run() {
+    size_t workerCount = config_.threads > 0 ? static_cast<size_t>(config_.threads)
+                                             : std::max(1u, std::thread::hardware_concurrency());
+    workerCount = std::max<size_t>(1, std::min(workerCount, static_cast<size_t>(std::max(config_.connections, 1))));
+
+    running_ = true;
+    int64_t startNs = steadyNs();
+    int64_t endNs = startNs + static_cast<int64_t>(config_.durationSec) * 1'000'000'000;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers_.push_back(std::make_unique<Worker>(config_, stats_, running_, i, workerCount));
+    }
+    for (auto& worker : workers_) {
+        threads_.emplace_back([&worker, startNs, endNs] { worker->run(startNs, endNs); });
+    }
+
+    auto interval = std::chrono::seconds(std::max(config_.reportIntervalSec, 1));
+    auto nextReport = std::chrono::steady_clock::now() + interval;
+    while (running_.load(std::memory_order_relaxed) && steadyNs() < endNs) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (std::chrono::steady_clock::now() >= nextReport) {
+            printProgress(static_cast<double>(steadyNs() - startNs) / 1e9);
+            nextReport += interval;
+        }
+    }
+
+    running_ = false;
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    elapsedSec_ = static_cast<double>(steadyNs() - startNs) / 1e9;
+    workers_.clear();
+}
+
+void LoadGenerator::printProgress(double elapsedSec) const {
+    auto p99 = [](const trading::infrastructure::metrics::LatencyHistogram& histogram) {
+        return static_cast<double>(histogram.valueAtPercentile(99.0)) / 1e6;
+    };
+    const auto& place = stats_.methods[methodIndex(LoadMethod::PLACE)];
+    std::cout << "[LoadGen] t=" << std::fixed << std::setprecision(0) << elapsedSec << "s"
+              << " open=" << stats_.open.load() << " ready=" << stats_.ready.load()
+              << " failed=" << stats_.connectFailures.load()
+              << " place=" << place.responses.load() << "/" << place.sent.load()
+              << " place_p99=" << std::setprecision(2) << p99(place.latency) << "ms"
+              << " ticks=" << stats_.ticks.load()
+              << " tick_lag_p99=" << p99(stats_.tickLag) << "ms"
+              << std::defaultfloat << std::endl;
+}
+
+nlohmann::json LoadGenerator::report() const {
+    nlohmann::json methods = nlohmann::json::object();
+    for (size_t i = 0; i < kLoadMethodCount; ++i) {
+        const auto& method = stats_.methods[i];
+        methods[methodName(static_cast<LoadMethod>(i))] = {
+            {"sent", method.sent.load()},
+            {"responses", method.responses.load()},
+            {"errors", method.errors.load()},
+            {"timeouts", method.timeouts.load()},
+            {"unsent", method.unsent.load()},
+            {"ratePerSec", elapsedSec_ > 0.0 ? static_cast<double>(method.responses.load()) / elapsedSec_ : 0.0},
+            {"latency", latencyJson(method.latency)}
+        };
+    }
+
+    return {
+        {"config", {
+            {"host", config_.host},
+            {"port", config_.port},
+            {"connections", config_.connections},
+            {"connectRate", config_.connectRate},
+            {"placeRate", config_.placeRate},
+            {"cancelRate", config_.cancelRate},
+            {"historyRate", config_.historyRate},
+            {"retryRatio", config_.retryRatio},
+            {"symbolSets", config_.symbolSets},
+            {"durationSec", config_.durationSec}
+        }},
+        {"elapsedSec", elapsedSec_},
+        {"connections", {
+            {"attempts", stats_.connectAttempts.load()},
+            {"failures", stats_.connectFailures.load()},
+            {"open", stats_.open.load()},
+            {"ready", stats_.ready.load()},
+            {"disconnects", stats_.disconnects.load()}
+        }},
+        {"methods", methods},
+        {"idempotency", {
+            {"retriesSent", stats_.retriesSent.load()},
+            {"cachedReplies", stats_.cachedReplies.load()}
+        }},
+        {"ticks", {
+            {"received", stats_.ticks.load()},
+            {"lag", latencyJson(stats_.tickLag)}
+        }},
+        {"bytesSent", stats_.bytesSent.load()},
+        {"bytesReceived", stats_.bytesReceived.load()},
+        {"acksReceived", stats_.acksReceived.load()},
+        {"unmatchedReplies", stats_.unmatchedReplies.load()},
+        {"protocolErrors", stats_.protocolErrors.load()}
+    };
+}
+
+} // namespace trading::loadgen
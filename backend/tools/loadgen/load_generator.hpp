@@ -0,0 +1,113 @@
+#pragma once
+
+#include "infrastructure/metrics/latency_histogram.hpp"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trading::loadgen {
+
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    int port = 8082;
+    std::string token = "trader-token";
+    int connections = 100;
+    int connectRate = 2000;                 // New connections per second across all threads
+    int threads = 0;                        // 0 uses every core
+    // Local addresses to bind round-robin; each one adds ~28k ephemeral ports
+    // towards the server, so 50k connections need at least two (e.g. 127.0.0.2,127.0.0.3)
+    std::vector<std::string> sourceIps;
+    // Assigned to connections round-robin; an empty set skips market.subscribe
+    std::vector<std::vector<std::string>> symbolSets = {{"ETH-USD", "BTC-USD"}};
+    double placeRate = 0.0;                 // orders.place per second across all connections
+    double cancelRate = 0.0;                // orders.cancel per second
+    double historyRate = 0.0;               // history.query per second
+    double retryRatio = 0.0;                // Share of orders.place that reuse an earlier idempotency key
+    int durationSec = 60;
+    int reportIntervalSec = 5;
+    int responseTimeoutMs = 10000;
+};
+
+enum class LoadMethod : size_t {
+    HELLO,
+    SUBSCRIBE,
+    PLACE,
+    CANCEL,
+    HISTORY,
+    COUNT
+};
+
+constexpr size_t kLoadMethodCount = static_cast<size_t>(LoadMethod::COUNT);
+
+// Counters shared by all worker threads
+struct LoadStats {
+    struct MethodStats {
+        std::atomic<uint64_t> sent{0};
+        std::atomic<uint64_t> responses{0};
+        std::atomic<uint64_t> errors{0};       // Replies carrying an "error" object
+        std::atomic<uint64_t> timeouts{0};
+        std::atomic<uint64_t> unsent{0};       // Scheduled while no connection was ready
+        trading::infrastructure::metrics::LatencyHistogram latency;
+    };
+
+    std::atomic<uint64_t> connectAttempts{0};
+    std::atomic<uint64_t> connectFailures{0};
+    std::atomic<uint64_t> open{0};             // Upgraded WebSocket connections
+    std::atomic<uint64_t> ready{0};            // Authenticated and subscribed
+    std::atomic<uint64_t> disconnects{0};
+    std::atomic<uint64_t> protocolErrors{0};
+    std::atomic<uint64_t> bytesSent{0};
+    std::atomic<uint64_t> bytesReceived{0};
+    std::atomic<uint64_t> acksReceived{0};
+    std::atomic<uint64_t> unmatchedReplies{0};
+    std::atomic<uint64_t> retriesSent{0};      // orders.place with a reused idempotency key
+    std::atomic<uint64_t> cachedReplies{0};    // orders.place answered from the idempotency cache
+    std::atomic<uint64_t> ticks{0};
+    std::array<MethodStats, kLoadMethodCount> methods;
+    // now - tick timestamp; assumes client and server clocks agree (same host or NTP)
+    trading::infrastructure::metrics::LatencyHistogram tickLag;
+};
+
+// Opens config.connections WebSocket sessions speaking the MsgPack protocol,
+// authenticates each with hello, subscribes it to a symbol set, then drives
+// orders.place / orders.cancel / history.query at fixed aggregate rates.
+// Each worker thread owns a slice of the connections and one epoll loop, so the
+// connection count is bounded by file descriptors and ports rather than threads.
+// Requests are open-loop: latency is measured from the scheduled send time, so a
+// stalled server shows up as latency instead of a lower request rate.
+class LoadGenerator {
+public:
+    explicit LoadGenerator(LoadConfig config);
+    ~LoadGenerator();
+
+    LoadGenerator(const LoadGenerator&) = delete;
+    LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+    // Blocks for the configured duration or until stop(), printing progress lines
+    void run();
+    void stop() noexcept { running_.store(false, std::memory_order_relaxed); }
+
+    const LoadStats& stats() const { return stats_; }
+    nlohmann::json report() const;
+
+    static const char* methodName(LoadMethod method);
+
+private:
+    class Worker;
+
+    LoadConfig config_;
+    LoadStats stats_;
+    std::atomic<bool> running_{false};
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    double elapsedSec_ = 0.0;
+
+    void printProgress(double elapsedSec) const;
+};
+
+} // namespace trading::loadgen
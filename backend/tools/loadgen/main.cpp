@@ -0,0 +1,175 @@
+#include "load_generator.hpp"
+#include <sys/resource.h>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using trading::loadgen::LoadConfig;
+using trading::loadgen::LoadGenerator;
+
+namespace {
+
+LoadGenerator* g_generator = nullptr;
+
+void signalHandler(int) {
+    if (g_generator) {
+        g_generator->stop();
+    }
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::istringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+void printUsage() {
+    std::cout << "Usage: bull-trading-loadgen [options]\n"
+              << "  --host <ip>                 Server address (default 127.0.0.1)\n"
+              << "  --port <port>               Server port (default 8082)\n"
+              << "  --connections <n>           WebSocket sessions to open (default 100)\n"
+              << "  --connect-rate <n>          New connections per second (default 2000)\n"
+              << "  --threads <n>               Event loop threads (default: all cores)\n"
+              << "  --source-ips <a,b,...>      Local addresses to spread connections over\n"
+              << "  --symbols <A,B;C,...>       Symbol sets, ';'-separated, assigned round-robin\n"
+              << "                              (default ETH-USD,BTC-USD; empty string: no subscription)\n"
+              << "  --place-rate <per sec>      orders.place rate across all connections\n"
+              << "  --cancel-rate <per sec>     orders.cancel rate (cancels earlier orders)\n"
+              << "  --history-rate <per sec>    history.query rate\n"
+              << "  --retry-ratio <0..1>        Share of orders.place resent with a used idempotency key\n"
+              << "  --token <token>             Auth token for the handshake and hello (default trader-token)\n"
+              << "  --duration <sec>            Run time (default 60)\n"
+              << "  --report-interval <sec>     Progress line interval (default 5)\n"
+              << "  --timeout-ms <ms>           Reply timeout (default 10000)\n"
+              << "  --json-out <file>           Write the final report as JSON\n";
+}
+
+// Every connection holds a descriptor; the soft limit is usually far below 50k
+void raiseFileLimit(int connections) {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return;
+    }
+    limit.rlim_cur = limit.rlim_max;
+    ::setrlimit(RLIMIT_NOFILE, &limit);
+    ::getrlimit(RLIMIT_NOFILE, &limit);
+    if (limit.rlim_cur < static_cast<rlim_t>(connections) + 64) {
+        std::cerr << "[LoadGen] Warning: open file limit " << limit.rlim_cur << " is below " << connections
+                  << " connections; raise it with ulimit -n" << std::endl;
+    }
+}
+
+void printSummary(const nlohmann::json& report) {
+    std::cout << "\n=== Load generator summary (" << report["elapsedSec"].get<double>() << "s) ===" << std::endl;
+    const auto& connections = report["connections"];
+    std::cout << "Connections: attempts=" << connections["attempts"] << " ready=" << connections["ready"]
+              << " failures=" << connections["failures"] << " disconnects=" << connections["disconnects"] << std::endl;
+    for (const auto& [name, method] : report["methods"].items()) {
+        if (method["sent"].get<uint64_t>() == 0 && method["unsent"].get<uint64_t>() == 0) {
+            continue;
+        }
+        const auto& latency = method["latency"];
+        std::cout << name << ": sent=" << method["sent"] << " ok=" << method["responses"]
+                  << " errors=" << method["errors"] << " timeouts=" << method["timeouts"]
+                  << " unsent=" << method["unsent"]
+                  << " | p50=" << latency["p50Ms"] << "ms p99=" << latency["p99Ms"] << "ms p999=" << latency["p999Ms"]
+                  << "ms max=" << latency["maxMs"] << "ms" << std::endl;
+    }
+    const auto& ticks = report["ticks"];
+    std::cout << "Ticks: received=" << ticks["received"] << " lag p50=" << ticks["lag"]["p50Ms"]
+              << "ms p99=" << ticks["lag"]["p99Ms"] << "ms max=" << ticks["lag"]["maxMs"] << "ms" << std::endl;
+    std::cout << "Idempotency: retries=" << report["idempotency"]["retriesSent"]
+              << " cached replies=" << report["idempotency"]["cachedReplies"] << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    std::string jsonOut;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--host") config.host = value;
+            else if (arg == "--port") config.port = std::stoi(value);
+            else if (arg == "--connections") config.connections = std::stoi(value);
+            else if (arg == "--connect-rate") config.connectRate = std::stoi(value);
+            else if (arg == "--threads") config.threads = std::stoi(value);
+            else if (arg == "--source-ips") config.sourceIps = split(value, ',');
+            else if (arg == "--place-rate") config.placeRate = std::stod(value);
+            else if (arg == "--cancel-rate") config.cancelRate = std::stod(value);
+            else if (arg == "--history-rate") config.historyRate = std::stod(value);
+            else if (arg == "--retry-ratio") config.retryRatio = std::stod(value);
+            else if (arg == "--token") config.token = value;
+            else if (arg == "--duration") config.durationSec = std::stoi(value);
+            else if (arg == "--report-interval") config.reportIntervalSec = std::stoi(value);
+            else if (arg == "--timeout-ms") config.responseTimeoutMs = std::stoi(value);
+            else if (arg == "--json-out") jsonOut = value;
+            else if (arg == "--symbols") {
+                config.symbolSets.clear();
+                for (const auto& set : split(value, ';')) {
+                    config.symbolSets.push_back(split(set, ','));
+                }
+            } else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.connections <= 0 || config.retryRatio < 0.0 || config.retryRatio > 1.0) {
+        std::cerr << "--connections must be positive and --retry-ratio within [0, 1]" << std::endl;
+        return 1;
+    }
+
+    raiseFileLimit(config.connections);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "[LoadGen] " << config.connections << " connections to " << config.host << ":" << config.port
+              << " for " << config.durationSec << "s, place=" << config.placeRate << "/s cancel=" << config.cancelRate
+              << "/s history=" << config.historyRate << "/s retry=" << config.retryRatio << std::endl;
+
+    LoadGenerator generator(config);
+    g_generator = &generator;
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    generator.run();
+    g_generator = nullptr;
+
+    auto report = generator.report();
+    printSummary(report);
+    if (!jsonOut.empty()) {
+        std::ofstream file(jsonOut);
+        if (!file) {
+            std::cerr << "[LoadGen] Cannot write " << jsonOut << std::endl;
+            return 1;
+        }
+        file << report.dump(2) << '\n';
+        std::cout << "[LoadGen] Report written to " << jsonOut << std::endl;
+    }
+    return 0;
+}
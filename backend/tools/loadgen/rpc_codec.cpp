@@ -0,0 +1,162 @@
+#include "rpc_codec.hpp"
+#include "utils/parser.hpp"
+
+namespace trading::loadgen {
+
+namespace {
+
+void packString(msgpack::packer<msgpack::sbuffer>& packer, std::string_view value) {
+    packer.pack_str(static_cast<uint32_t>(value.size()));
+    packer.pack_str_body(value.data(), static_cast<uint32_t>(value.size()));
+}
+
+void appendHeader(std::vector<uint8_t>& out, FrameType type, uint64_t messageId) {
+    out.push_back(static_cast<uint8_t>(type));
+    for (int byte = 0; byte < 8; ++byte) {
+        out.push_back(static_cast<uint8_t>(messageId >> (byte * 8)));
+    }
+}
+
+uint64_t readMessageId(const uint8_t* data) {
+    uint64_t messageId = 0;
+    for (int byte = 7; byte >= 0; --byte) {
+        messageId = (messageId << 8) | data[1 + byte];
+    }
+    return messageId;
+}
+
+nlohmann::json payloadToJson(const msgpack::object& payload) {
+    switch (payload.type) {
+        case msgpack::type::BIN:
+            return nlohmann::json::parse(payload.via.bin.ptr, payload.via.bin.ptr + payload.via.bin.size, nullptr, false);
+        case msgpack::type::STR:
+            return nlohmann::json::parse(payload.via.str.ptr, payload.via.str.ptr + payload.via.str.size, nullptr, false);
+        case msgpack::type::MAP:
+        case msgpack::type::ARRAY:
+            return convertMsgPackToJson(payload);
+        default:
+            return nullptr;
+    }
+}
+
+// {method, payload} map; false when the bytes are not such a map
+bool decodeEnvelope(const uint8_t* data, size_t size, ServerMessage& message) {
+    try {
+        msgpack::object_handle handle = msgpack::unpack(reinterpret_cast<const char*>(data), size);
+        const msgpack::object& envelope = handle.get();
+        if (envelope.type != msgpack::type::MAP) {
+            return false;
+        }
+        for (uint32_t i = 0; i < envelope.via.map.size; ++i) {
+            const auto& entry = envelope.via.map.ptr[i];
+            if (entry.key.type != msgpack::type::STR) {
+                continue;
+            }
+            std::string_view key(entry.key.via.str.ptr, entry.key.via.str.size);
+            if (key == "method" && entry.val.type == msgpack::type::STR) {
+                message.method.assign(entry.val.via.str.ptr, entry.val.via.str.size);
+            } else if (key == "payload") {
+                message.payload = payloadToJson(entry.val);
+                if (message.payload.is_discarded()) {
+                    message.payload = nullptr;
+                }
+            }
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace
+
+void packJson(msgpack::packer<msgpack::sbuffer>& packer, const nlohmann::json& value) {
+    switch (value.type()) {
+        case nlohmann::json::value_t::object:
+            packer.pack_map(static_cast<uint32_t>(value.size()));
+            for (const auto& [key, item] : value.items()) {
+                packString(packer, key);
+                packJson(packer, item);
+            }
+            break;
+        case nlohmann::json::value_t::array:
+            packer.pack_array(static_cast<uint32_t>(value.size()));
+            for (const auto& item : value) {
+                packJson(packer, item);
+            }
+            break;
+        case nlohmann::json::value_t::string:
+            packString(packer, value.get_ref<const std::string&>());
+            break;
+        case nlohmann::json::value_t::boolean:
+            if (value.get<bool>()) {
+                packer.pack_true();
+            } else {
+                packer.pack_false();
+            }
+            break;
+        case nlohmann::json::value_t::number_integer:
+            packer.pack_int64(value.get<int64_t>());
+            break;
+        case nlohmann::json::value_t::number_unsigned:
+            packer.pack_uint64(value.get<uint64_t>());
+            break;
+        case nlohmann::json::value_t::number_float:
+            packer.pack_double(value.get<double>());
+            break;
+        default:
+            packer.pack_nil();
+            break;
+    }
+}
+
+std::vector<uint8_t> encodeRequest(uint64_t messageId, std::string_view method, const nlohmann::json& params) {
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack_map(3);
+    packString(packer, "method");
+    packString(packer, method);
+    packString(packer, "payload");
+    packJson(packer, params);
+    packString(packer, "id");
+    packer.pack_uint64(messageId);
+
+    std::vector<uint8_t> frame;
+    frame.reserve(kQosHeaderSize + buffer.size());
+    appendHeader(frame, FrameType::DATA, messageId);
+    frame.insert(frame.end(), buffer.data(), buffer.data() + buffer.size());
+    return frame;
+}
+
+void appendAck(std::vector<uint8_t>& out, uint64_t messageId) {
+    appendHeader(out, FrameType::ACK, messageId);
+}
+
+std::optional<ServerMessage> decodeServerMessage(const uint8_t* data, size_t size) {
+    ServerMessage message;
+    if (size >= kQosHeaderSize && (data[0] == static_cast<uint8_t>(FrameType::DATA) ||
+                                   data[0] == static_cast<uint8_t>(FrameType::ACK))) {
+        message.messageId = readMessageId(data);
+        if (data[0] == static_cast<uint8_t>(FrameType::ACK)) {
+            message.kind = ServerMessage::Kind::ACK;
+            return message;
+        }
+        message.kind = ServerMessage::Kind::DATA;
+        // Some error paths reply with bare JSON and no method; an undecodable body is
+        // still acknowledged by the caller
+        if (!decodeEnvelope(data + kQosHeaderSize, size - kQosHeaderSize, message)) {
+            message.payload = nlohmann::json::parse(data + kQosHeaderSize, data + size, nullptr, false);
+            if (message.payload.is_discarded()) {
+                message.payload = nullptr;
+            }
+        }
+        return message;
+    }
+
+    if (!decodeEnvelope(data, size, message)) {
+        return std::nullopt;
+    }
+    return message;
+}
+
+} // namespace trading::loadgen
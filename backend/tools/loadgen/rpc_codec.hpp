@@ -0,0 +1,46 @@
+#pragma once
+
+#include <msgpack.hpp>
+#include <nlohmann/json.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trading::loadgen {
+
+// BinaryRPC framing with QoS1 (AtLeastOnce), as spoken by the web client:
+//   DATA [0x00][message id, 8 bytes little-endian][MsgPack {method, payload, id}]
+//   ACK  [0x01][message id, 8 bytes little-endian]
+// Every DATA frame from the server must be acknowledged or it is retried.
+enum class FrameType : uint8_t {
+    DATA = 0x00,
+    ACK = 0x01
+};
+
+constexpr size_t kQosHeaderSize = 9;
+
+struct ServerMessage {
+    enum class Kind { DATA, ACK, PLAIN };
+
+    Kind kind = Kind::PLAIN;
+    uint64_t messageId = 0;    // DATA and ACK frames only
+    std::string method;        // Empty for bare JSON replies
+    nlohmann::json payload;    // Null when the payload is missing or not JSON/MsgPack
+};
+
+// Packs JSON as the equivalent MsgPack value
+void packJson(msgpack::packer<msgpack::sbuffer>& packer, const nlohmann::json& value);
+
+// DATA frame carrying an RPC call with its params as a MsgPack map
+std::vector<uint8_t> encodeRequest(uint64_t messageId, std::string_view method, const nlohmann::json& params);
+
+void appendAck(std::vector<uint8_t>& out, uint64_t messageId);
+
+// Decodes a QoS frame or a bare MsgPack envelope; nullopt when neither parses.
+// Server payloads are JSON text in a bin/str field, or a MsgPack map.
+std::optional<ServerMessage> decodeServerMessage(const uint8_t* data, size_t size);
+
+} // namespace trading::loadgen
@@ -0,0 +1,152 @@
+#include "websocket_frame.hpp"
+#include <array>
+#include <random>
+
+namespace trading::loadgen {
+
+namespace {
+
+constexpr size_t kMaxControlPayload = 125;
+
+std::string base64Encode(const uint8_t* data, size_t size) {
+    static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((size + 2) / 3 * 4);
+    for (size_t i = 0; i < size; i += 3) {
+        uint32_t chunk = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < size) chunk |= static_cast<uint32_t>(data[i + 1]) << 8;
+        if (i + 2 < size) chunk |= data[i + 2];
+        out += kAlphabet[(chunk >> 18) & 0x3F];
+        out += kAlphabet[(chunk >> 12) & 0x3F];
+        out += i + 1 < size ? kAlphabet[(chunk >> 6) & 0x3F] : '=';
+        out += i + 2 < size ? kAlphabet[chunk & 0x3F] : '=';
+    }
+    return out;
+}
+
+bool startsWithIgnoreCase(std::string_view text, std::string_view prefix) {
+    if (text.size() < prefix.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        char a = text[i];
+        char b = prefix[i];
+        if (a >= 'A' && a <= 'Z') a = static_cast<char>(a - 'A' + 'a');
+        if (b >= 'A' && b <= 'Z') b = static_cast<char>(b - 'A' + 'a');
+        if (a != b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string buildUpgradeRequest(std::string_view host, int port, std::string_view target, std::string_view key) {
+    std::string request;
+    request.reserve(256 + target.size());
+    request += "GET ";
+    request += target.empty() ? "/" : target;
+    request += " HTTP/1.1\r\nHost: ";
+    request += host;
+    request += ':';
+    request += std::to_string(port);
+    request += "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: ";
+    request += key;
+    request += "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    return request;
+}
+
+std::string makeWebSocketKey(uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::array<uint8_t, 16> nonce{};
+    for (auto& byte : nonce) {
+        byte = static_cast<uint8_t>(random());
+    }
+    return base64Encode(nonce.data(), nonce.size());
+}
+
+std::optional<size_t> upgradeResponseLength(std::string_view received) {
+    auto end = received.find("\r\n\r\n");
+    if (end == std::string_view::npos) {
+        return std::nullopt;
+    }
+    return end + 4;
+}
+
+bool isUpgradeAccepted(std::string_view responseHead) {
+    // Sec-WebSocket-Accept is not verified; the server under test is trusted
+    return startsWithIgnoreCase(responseHead, "HTTP/1.1 101");
+}
+
+void appendClientFrame(std::vector<uint8_t>& out, WsOpcode opcode, const uint8_t* payload, size_t size, uint32_t mask) {
+    out.push_back(static_cast<uint8_t>(0x80 | static_cast<uint8_t>(opcode)));
+    if (size < 126) {
+        out.push_back(static_cast<uint8_t>(0x80 | size));
+    } else if (size <= 0xFFFF) {
+        out.push_back(0x80 | 126);
+        out.push_back(static_cast<uint8_t>(size >> 8));
+        out.push_back(static_cast<uint8_t>(size));
+    } else {
+        out.push_back(0x80 | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(size) >> shift));
+        }
+    }
+
+    uint8_t key[4] = {
+        static_cast<uint8_t>(mask >> 24), static_cast<uint8_t>(mask >> 16),
+        static_cast<uint8_t>(mask >> 8), static_cast<uint8_t>(mask)
+    };
+    out.insert(out.end(), key, key + 4);
+    size_t offset = out.size();
+    out.resize(offset + size);
+    for (size_t i = 0; i < size; ++i) {
+        out[offset + i] = payload[i] ^ key[i & 3];
+    }
+}
+
+std::optional<size_t> decodeServerFrame(const uint8_t* data, size_t size, WsFrame& frame, size_t maxPayload) {
+    if (size < 2) {
+        return 0;
+    }
+    bool masked = (data[1] & 0x80) != 0;
+    if (masked) {
+        return std::nullopt;
+    }
+
+    uint64_t length = data[1] & 0x7F;
+    size_t header = 2;
+    if (length == 126) {
+        if (size < 4) {
+            return 0;
+        }
+        length = (static_cast<uint64_t>(data[2]) << 8) | data[3];
+        header = 4;
+    } else if (length == 127) {
+        if (size < 10) {
+            return 0;
+        }
+        length = 0;
+        for (size_t i = 2; i < 10; ++i) {
+            length = (length << 8) | data[i];
+        }
+        header = 10;
+    }
+
+    frame.fin = (data[0] & 0x80) != 0;
+    frame.opcode = static_cast<WsOpcode>(data[0] & 0x0F);
+    bool control = (data[0] & 0x08) != 0;
+    if (length > maxPayload || (control && (length > kMaxControlPayload || !frame.fin))) {
+        return std::nullopt;
+    }
+    if (size - header < length) {
+        return 0;
+    }
+
+    frame.payload = data + header;
+    frame.payloadSize = static_cast<size_t>(length);
+    return header + static_cast<size_t>(length);
+}
+
+} // namespace trading::loadgen
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trading::loadgen {
+
+// Just enough of RFC 6455 for a load-generating client: the upgrade request,
+// masked client frames and incremental decoding of unmasked server frames.
+enum class WsOpcode : uint8_t {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+};
+
+struct WsFrame {
+    WsOpcode opcode = WsOpcode::BINARY;
+    bool fin = true;
+    const uint8_t* payload = nullptr;  // Points into the decoder's input
+    size_t payloadSize = 0;
+};
+
+// GET request upgrading to a WebSocket; key is the base64 Sec-WebSocket-Key
+std::string buildUpgradeRequest(std::string_view host, int port, std::string_view target, std::string_view key);
+
+// Random 16-byte Sec-WebSocket-Key from the given seed
+std::string makeWebSocketKey(uint64_t seed);
+
+// Size of the response head ending in an empty line, or nullopt while incomplete
+std::optional<size_t> upgradeResponseLength(std::string_view received);
+
+// True when the response head switches protocols (101)
+bool isUpgradeAccepted(std::string_view responseHead);
+
+// Appends one final client frame; clients must mask every payload
+void appendClientFrame(std::vector<uint8_t>& out, WsOpcode opcode, const uint8_t* payload, size_t size, uint32_t mask);
+
+// Decodes one frame from the front of data. Returns the bytes consumed, 0 while the
+// frame is incomplete, or nullopt on a protocol violation (masked server frame,
+// oversized control frame, payload beyond maxPayload).
+std::optional<size_t> decodeServerFrame(const uint8_t* data, size_t size, WsFrame& frame, size_t maxPayload);
+
+} // namespace trading::loadgen
@@ -76,7 +76,7 @@ export default function OrderHistoryPanel({
           price: resolvedPrice,
           displayPrice: resolvedPrice,
           status: histOrder.status,
-          createdAt: histOrder.timestamp,
+          createdAt: histOrder.placed_at || histOrder.timestamp,
           idemp_key: histOrder.idemp_key,
           result: parsedResult
         };
@@ -559,9 +559,9 @@ export function WebSocketProvider({ children }) {
     }
   }, []);
 
-  const queryHistory = useCallback((symbol, fromTs, toTs, interval, limit) => {
+  const queryHistory = useCallback((symbol, fromTs, toTs, interval, limit, maxPoints) => {
     if (wsClientRef.current) {
-      wsClientRef.current.queryHistory(symbol, fromTs, toTs, interval, limit);
+      wsClientRef.current.queryHistory(symbol, fromTs, toTs, interval, limit, maxPoints);
     }
   }, []);
 
@@ -633,6 +633,18 @@ class TradingWebSocketClient {
         this.emit('alertDisabled', safeResult || safeError);
         break;
         
+      case 'alerts.price.register':
+        this.emit('priceAlertRegistered', safeResult || safeError);
+        break;
+        
+      case 'alerts.price.cancel':
+        this.emit('priceAlertCancelled', safeResult || safeError);
+        break;
+        
+      case 'trace.dump':
+        this.emit('traceDump', safeResult || safeError);
+        break;
+        
       default:
         // No logging needed
     }
@@ -655,6 +667,10 @@ class TradingWebSocketClient {
       case 'alerts.push':
         this.emit('alertPush', message.data);
         break;
+        
+      case 'alerts.price':
+        this.emit('priceAlert', message.data);
+        break;
     }
   }
 
@@ -821,13 +837,15 @@ class TradingWebSocketClient {
   }
 
   // Historical Data Methods
-  queryHistory(symbol, fromTs, toTs, interval = 'M1', limit = 1000) {
+  // maxPoints asks the server to merge the whole range into at most that many candles
+  queryHistory(symbol, fromTs, toTs, interval = 'M1', limit = 1000, maxPoints) {
     this.sendRpc('history.query', {
       symbol,
       fromTs,
       toTs,
       interval,
-      limit
+      limit,
+      ...(maxPoints ? { maxPoints } : {})
     });
   }
 
@@ -863,6 +881,27 @@ class TradingWebSocketClient {
     this.sendRpc('alerts.disable', { ruleId });
   }
 
+  // kind: above | below | cross (level), move_up | move_down | move (movePercent within windowMs)
+  registerPriceAlert(symbol, kind, { level, movePercent, windowMs } = {}) {
+    const payload = { symbol, kind };
+    if (level !== undefined) payload.level = level;
+    if (movePercent !== undefined) payload.movePercent = movePercent;
+    if (windowMs !== undefined) payload.windowMs = windowMs;
+    this.sendRpc('alerts.price.register', payload);
+  }
+
+  cancelPriceAlert(alertId) {
+    this.sendRpc('alerts.price.cancel', { alertId });
+  }
+
+  // Recent server trace spans in Chrome trace format (chrome://tracing, Perfetto)
+  dumpTrace({ enabled, clear } = {}) {
+    const params = {};
+    if (enabled !== undefined) params.enabled = enabled;
+    if (clear !== undefined) params.clear = clear;
+    this.sendRpc('trace.dump', params);
+  }
+
   // Utility Methods
   resubscribeToRooms() {
     if (this.subscribedRooms.size > 0) {